@@ -0,0 +1,140 @@
+#! /bin/sh
+# Compares resident memory and wakeups of the standalone dock-apps against
+# the same applets running within one wlmapplets process.
+#
+# Runs a headless wlmaker in a private XDG_RUNTIME_DIR, so it works without a
+# display (eg. over SSH or in CI). Wakeups are counted as context switches of
+# the app processes while idle, over the measurement window.
+#
+# Usage: apps/benchmark-applets.sh [BUILD_DIR] [SECONDS]
+#
+# Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# https://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+set -o errexit
+set -o nounset
+
+BUILD_DIR="$(readlink -f "${1:-build}")"
+SECONDS_MEASURED="${2:-30}"
+SECONDS_WARMUP=${SECONDS_WARMUP:-3}
+APPLETS="battery clock cpugraph memgraph netgraph"
+
+runtime_dir="$(mktemp -d)"
+wlmaker_pid=""
+app_pids=""
+
+cleanup() {
+    # shellcheck disable=SC2086
+    [ -n "${app_pids}" ] && kill ${app_pids} 2>/dev/null || true
+    [ -n "${wlmaker_pid}" ] && kill "${wlmaker_pid}" 2>/dev/null || true
+    wait 2>/dev/null || true
+    rm -rf "${runtime_dir}"
+}
+trap cleanup EXIT INT TERM
+
+# Prints the value of field $2 (in kB, or a count) from /proc/$1/$3.
+proc_field() {
+    awk -v key="${2}:" '$1 == key { print $2; exit }' "/proc/${1}/${3}"
+}
+
+# Prints the sum of context switches over all given PIDs.
+ctxt_switches() {
+    sum=0
+    for pid in "$@" ; do
+        v="$(proc_field "${pid}" voluntary_ctxt_switches status)"
+        n="$(proc_field "${pid}" nonvoluntary_ctxt_switches status)"
+        sum=$((sum + v + n))
+    done
+    echo "${sum}"
+}
+
+# Prints the sum of field $1 from /proc/PID/$2, over all further PIDs.
+memory_sum() {
+    field="${1}" ; file="${2}" ; shift 2
+    sum=0
+    for pid in "$@" ; do
+        sum=$((sum + $(proc_field "${pid}" "${field}" "${file}")))
+    done
+    echo "${sum}"
+}
+
+# Measures the processes in ${app_pids}, and prints one row of results.
+measure() {
+    label="${1}"
+    sleep "${SECONDS_WARMUP}"
+    # shellcheck disable=SC2086
+    before="$(ctxt_switches ${app_pids})"
+    sleep "${SECONDS_MEASURED}"
+    # shellcheck disable=SC2086
+    after="$(ctxt_switches ${app_pids})"
+    # shellcheck disable=SC2086
+    rss="$(memory_sum VmRSS status ${app_pids})"
+    # shellcheck disable=SC2086
+    pss="$(memory_sum Pss smaps_rollup ${app_pids})"
+    # shellcheck disable=SC2086
+    set -- ${app_pids}
+    procs=$#
+    wakeups=$((after - before))
+    printf "%-12s %6d %10d %10d %10d %10s\n" \
+           "${label}" "${procs}" "${rss}" "${pss}" "${wakeups}" \
+           "$(awk -v w="${wakeups}" -v s="${SECONDS_MEASURED}" \
+                 'BEGIN { printf "%.2f", w / s }')"
+
+    # shellcheck disable=SC2086
+    kill ${app_pids}
+    # shellcheck disable=SC2086
+    for pid in ${app_pids} ; do
+        while kill -0 "${pid}" 2>/dev/null ; do sleep 0.1 ; done
+    done
+    app_pids=""
+}
+
+# Starts wlmaker on a headless backend, and waits for its socket.
+export XDG_RUNTIME_DIR="${runtime_dir}"
+WLR_BACKENDS=headless WLR_HEADLESS_OUTPUTS=1 WLR_RENDERER=pixman \
+    WLR_LIBINPUT_NO_DEVICES=1 \
+    "${BUILD_DIR}/src/wlmaker" --log_level=WARNING >"${runtime_dir}/log" 2>&1 &
+wlmaker_pid=$!
+for _ in $(seq 50) ; do
+    socket="$(find "${runtime_dir}" -maxdepth 1 -type s -name 'wayland-*' \
+                  | head -n 1)"
+    [ -n "${socket}" ] && break
+    sleep 0.1
+done
+if [ -z "${socket}" ] ; then
+    echo "wlmaker did not create a socket. Log:" >&2
+    cat "${runtime_dir}/log" >&2
+    exit 1
+fi
+export WAYLAND_DISPLAY="$(basename "${socket}")"
+
+printf "%-12s %6s %10s %10s %10s %10s\n" \
+       "mode" "procs" "RSS/kB" "PSS/kB" "wakeups" "wakeups/s"
+
+for applet in ${APPLETS} ; do
+    "${BUILD_DIR}/apps/wlm${applet}" >/dev/null 2>&1 &
+    app_pids="${app_pids} $!"
+done
+measure "standalone"
+
+host_args=""
+for applet in ${APPLETS} ; do
+    host_args="${host_args:+${host_args} -- }${applet}"
+done
+# shellcheck disable=SC2086
+"${BUILD_DIR}/apps/wlmapplets" ${host_args} >/dev/null 2>&1 &
+app_pids="$!"
+measure "wlmapplets"
+
+exit 0
@@ -24,11 +24,23 @@
 #include <libbase/libbase.h>
 
 #include <cairo.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* == Declarations ========================================================= */
 
+/** Pre-rendered digits: Ten cells, side by side, in one image surface. */
+struct _wlm_cairo_7segment_atlas_t {
+    /** The image surface, holding digits 0 to 9 from left to right. */
+    cairo_surface_t           *surface_ptr;
+    /** Width of a digit's cell, in pixels. */
+    unsigned                  cell_width;
+    /** Height of a digit's cell, in pixels. */
+    unsigned                  cell_height;
+};
+
 static void draw_segment(
     cairo_t *cairo_ptr,
     const bs_vector_2f_t origin,
@@ -166,6 +178,88 @@ void wlm_cairo_7segment_display_digit(
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+wlm_cairo_7segment_atlas_t *wlm_cairo_7segment_atlas_create(
+    const wlm_cairo_7segment_param_t *param_ptr,
+    uint32_t color_on,
+    uint32_t color_off,
+    uint32_t color_background)
+{
+    wlm_cairo_7segment_atlas_t *atlas_ptr = logged_calloc(
+        1, sizeof(wlm_cairo_7segment_atlas_t));
+    if (NULL == atlas_ptr) return NULL;
+
+    // Segments span from the lower left corner by (width + hlength) to the
+    // right, and by (2 * vlength + width) upwards.
+    atlas_ptr->cell_width = ceil(param_ptr->width + param_ptr->hlength);
+    atlas_ptr->cell_height = ceil(2 * param_ptr->vlength + param_ptr->width);
+
+    atlas_ptr->surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, 10 * atlas_ptr->cell_width,
+        atlas_ptr->cell_height);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(atlas_ptr->surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(%u, %u)",
+               10 * atlas_ptr->cell_width, atlas_ptr->cell_height);
+        wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+        return NULL;
+    }
+
+    cairo_t *cairo_ptr = cairo_create(atlas_ptr->surface_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color_background);
+    cairo_paint(cairo_ptr);
+    for (uint8_t digit = 0; digit < 10; ++digit) {
+        wlm_cairo_7segment_display_digit(
+            cairo_ptr, param_ptr,
+            digit * atlas_ptr->cell_width, atlas_ptr->cell_height,
+            color_on, color_off, digit);
+    }
+    cairo_destroy(cairo_ptr);
+    cairo_surface_flush(atlas_ptr->surface_ptr);
+    return atlas_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_destroy(wlm_cairo_7segment_atlas_t *atlas_ptr)
+{
+    if (NULL != atlas_ptr->surface_ptr) {
+        cairo_surface_destroy(atlas_ptr->surface_ptr);
+        atlas_ptr->surface_ptr = NULL;
+    }
+    free(atlas_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_cell_size(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    unsigned *width_ptr,
+    unsigned *height_ptr)
+{
+    *width_ptr = atlas_ptr->cell_width;
+    *height_ptr = atlas_ptr->cell_height;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_cairo_7segment_atlas_blit(
+    cairo_t *cairo_ptr,
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    uint32_t x,
+    uint32_t y,
+    uint8_t digit)
+{
+    BS_ASSERT(digit < UINT8_C(10));
+    double top = (double)y - atlas_ptr->cell_height;
+
+    cairo_save(cairo_ptr);
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(
+        cairo_ptr, atlas_ptr->surface_ptr,
+        (double)x - (double)digit * atlas_ptr->cell_width, top);
+    cairo_rectangle(
+        cairo_ptr, x, top, atlas_ptr->cell_width, atlas_ptr->cell_height);
+    cairo_fill(cairo_ptr);
+    cairo_restore(cairo_ptr);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -237,12 +331,14 @@ void draw_segment(
 static void test_6x8(bs_test_t *test_ptr);
 static void test_7x10(bs_test_t *test_ptr);
 static void test_16x24(bs_test_t *test_ptr);
+static void test_atlas(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlm_cairo_segment_display_test_cases[] = {
     { 1, "6x8", test_6x8 },
     { 1, "7x10", test_7x10 },
     { 1, "16x24", test_16x24 },
+    { 1, "atlas", test_atlas },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -330,4 +426,75 @@ void test_16x24(bs_test_t *test_ptr)
     bs_gfxbuf_destroy(gfxbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** @return Whether both buffers hold the same pixels. */
+static bool gfxbuf_equals(bs_gfxbuf_t *g1_ptr, bs_gfxbuf_t *g2_ptr)
+{
+    if (g1_ptr->width != g2_ptr->width ||
+        g1_ptr->height != g2_ptr->height) return false;
+    for (unsigned y = 0; y < g1_ptr->height; ++y) {
+        if (0 != memcmp(
+                g1_ptr->data_ptr + y * g1_ptr->pixels_per_line,
+                g2_ptr->data_ptr + y * g2_ptr->pixels_per_line,
+                g1_ptr->width * sizeof(uint32_t))) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies that digits blitted from the atlas match the stroked digits
+ * pixel-for-pixel, for each of the sizes.
+ */
+void test_atlas(bs_test_t *test_ptr)
+{
+    const wlm_cairo_7segment_param_t *params[] = {
+        &wlm_cairo_7segment_param_6x8,
+        &wlm_cairo_7segment_param_7x10,
+        &wlm_cairo_7segment_param_8x12,
+        &wlm_cairo_7segment_param_16x24
+    };
+    const uint32_t color_background = 0xff111111;
+
+    for (size_t p = 0; p < sizeof(params) / sizeof(params[0]); ++p) {
+        wlm_cairo_7segment_atlas_t *atlas_ptr =
+            wlm_cairo_7segment_atlas_create(
+                params[p], 0xffc0c0ff, 0xff202040, color_background);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, atlas_ptr);
+        unsigned w, h;
+        wlm_cairo_7segment_atlas_cell_size(atlas_ptr, &w, &h);
+
+        // Leaves a pixel of background between the digits, and around them.
+        bs_gfxbuf_t *stroked_ptr = bs_gfxbuf_create(10 * (w + 1) + 1, h + 2);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, stroked_ptr);
+        bs_gfxbuf_t *blitted_ptr = bs_gfxbuf_create(10 * (w + 1) + 1, h + 2);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, blitted_ptr);
+        bs_gfxbuf_clear(stroked_ptr, color_background);
+        bs_gfxbuf_clear(blitted_ptr, color_background);
+
+        cairo_t *stroked_cairo_ptr = cairo_create_from_bs_gfxbuf(stroked_ptr);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, stroked_cairo_ptr);
+        cairo_t *blitted_cairo_ptr = cairo_create_from_bs_gfxbuf(blitted_ptr);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, blitted_cairo_ptr);
+        for (uint8_t i = 0; i < 10; i++) {
+            wlm_cairo_7segment_display_digit(
+                stroked_cairo_ptr, params[p], 1 + i * (w + 1), h + 1,
+                0xffc0c0ff, 0xff202040, i);
+            // Blitting replaces a previous digit in the cell.
+            wlm_cairo_7segment_atlas_blit(
+                blitted_cairo_ptr, atlas_ptr, 1 + i * (w + 1), h + 1, 8);
+            wlm_cairo_7segment_atlas_blit(
+                blitted_cairo_ptr, atlas_ptr, 1 + i * (w + 1), h + 1, i);
+        }
+        cairo_destroy(blitted_cairo_ptr);
+        cairo_destroy(stroked_cairo_ptr);
+
+        BS_TEST_VERIFY_TRUE(test_ptr, gfxbuf_equals(stroked_ptr, blitted_ptr));
+
+        bs_gfxbuf_destroy(blitted_ptr);
+        bs_gfxbuf_destroy(stroked_ptr);
+        wlm_cairo_7segment_atlas_destroy(atlas_ptr);
+    }
+}
+
 /* == End of segment_display.c ============================================= */
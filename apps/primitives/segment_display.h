@@ -42,6 +42,9 @@ typedef struct {
     double vlength;
 } wlm_cairo_7segment_param_t;
 
+/** Forward declaration: Pre-rendered digits of a 7-segment display. */
+typedef struct _wlm_cairo_7segment_atlas_t wlm_cairo_7segment_atlas_t;
+
 /** Parameters for a 6x8-pixel-sized 7-segment digit display. */
 extern const wlm_cairo_7segment_param_t wlm_cairo_7segment_param_6x8;
 /** Parameters for a 7x10-pixel-sized 7-segment digit display. */
@@ -71,6 +74,59 @@ void wlm_cairo_7segment_display_digit(
     uint32_t color_off,
     uint8_t digit);
 
+/**
+ * Creates an atlas of the ten digits, pre-rendered onto `color_background`.
+ *
+ * Blitting a digit from the atlas onto an area filled with `color_background`
+ * gives the same pixels as drawing it with
+ * @ref wlm_cairo_7segment_display_digit.
+ *
+ * @param param_ptr           Visualization parameters for the segments.
+ * @param color_on            An ARGB32 value for an illuminated segment.
+ * @param color_off           An ARGB32 value for a non-illuminated segment.
+ * @param color_background    An ARGB32 value for the digit's background.
+ *
+ * @return The atlas, or NULL on error. Must be destroyed by calling
+ *     @ref wlm_cairo_7segment_atlas_destroy.
+ */
+wlm_cairo_7segment_atlas_t *wlm_cairo_7segment_atlas_create(
+    const wlm_cairo_7segment_param_t *param_ptr,
+    uint32_t color_on,
+    uint32_t color_off,
+    uint32_t color_background);
+
+/** Destroys the atlas. */
+void wlm_cairo_7segment_atlas_destroy(wlm_cairo_7segment_atlas_t *atlas_ptr);
+
+/**
+ * Returns the dimensions of a digit's cell in the atlas. A digit drawn at
+ * (x, y) covers the cell from (x, y - height) to (x + width, y).
+ *
+ * @param atlas_ptr
+ * @param width_ptr
+ * @param height_ptr
+ */
+void wlm_cairo_7segment_atlas_cell_size(
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    unsigned *width_ptr,
+    unsigned *height_ptr);
+
+/**
+ * Copies a digit from the atlas, replacing the cell's pixels.
+ *
+ * @param cairo_ptr           The `cairo_t` target to copy the digit to.
+ * @param atlas_ptr
+ * @param x                   X coordinate of lower left corner.
+ * @param y                   Y coordinate of lower left corner.
+ * @param digit               Digit to copy. Must be 0 <= digit < 10.
+ */
+void wlm_cairo_7segment_atlas_blit(
+    cairo_t *cairo_ptr,
+    wlm_cairo_7segment_atlas_t *atlas_ptr,
+    uint32_t x,
+    uint32_t y,
+    uint8_t digit);
+
 /** Unit test cases. */
 extern const bs_test_set_t wlm_cairo_segment_display_test_set;
 
@@ -0,0 +1,47 @@
+/* ========================================================================= */
+/**
+ * @file wlm_applets.h
+ *
+ * Dock-apps, as applets that can share a host process. See wlmapplets.c.
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WLM_APPLETS_H
+#define WLM_APPLETS_H
+
+#include <wlclient/applet.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Battery status, from wlmbattery.c. */
+extern const wlmcl_applet_t wlm_battery_applet;
+/** Clock, from wlmclock.c. */
+extern const wlmcl_applet_t wlm_clock_applet;
+/** CPU usage graph, from wlmcpugraph.c. */
+extern const wlmcl_applet_t wlm_cpugraph_applet;
+/** Memory usage graph, from wlmmemgraph.c. */
+extern const wlmcl_applet_t wlm_memgraph_applet;
+/** Network activity graph, from wlmnetgraph.c. */
+extern const wlmcl_applet_t wlm_netgraph_applet;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* WLM_APPLETS_H */
+/* == End of wlm_applets.h ================================================= */
@@ -0,0 +1,557 @@
+/* ========================================================================= */
+/**
+ * @file wlm_eyes.c
+ *
+ * Renders the eyes of `wlmeyes`, repainting only what the pupils touch.
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wlm_eyes.h"
+
+#include <cairo.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbase/libbase.h>
+
+/* == Definitions ========================================================== */
+
+/** Number of eyes. */
+#define WLM_EYES_NUM 2
+/** Frames of pupil rectangles to keep, for buffers of age up to this. */
+#define WLM_EYES_HISTORY 4
+
+/** Placement of an eye, relative to the surface's dimensions. */
+typedef struct {
+    /** Center, horizontally. */
+    double                    x;
+    /** Center, vertically. */
+    double                    y;
+    /** Horizontal radius of the ellipse the pupil moves within. */
+    double                    w;
+    /** Vertical radius of the ellipse the pupil moves within. */
+    double                    h;
+} wlm_eyes_placement_t;
+
+/** State of the renderer. */
+struct _wlm_eyes_t {
+    /** Width of the buffers, in pixels. */
+    unsigned                  width;
+    /** Height of the buffers, in pixels. */
+    unsigned                  height;
+    /** Eye whites and outlines, at @ref width x @ref height. Or NULL. */
+    cairo_surface_t           *static_surface_ptr;
+
+    /** Most recent pointer position, horizontally. */
+    double                    pointer_x;
+    /** Most recent pointer position, vertically. */
+    double                    pointer_y;
+    /** Pupil positions, in whole pixels. */
+    int                       pupil_x[WLM_EYES_NUM];
+    /** Pupil positions, in whole pixels. */
+    int                       pupil_y[WLM_EYES_NUM];
+    /** Whether the pupils or the size changed since the last frame. */
+    bool                      dirty;
+
+    /** Pupil rectangles of the most recent frames. */
+    wlm_eyes_rect_t           history[WLM_EYES_HISTORY][WLM_EYES_NUM];
+    /** Frames drawn at the current size. */
+    uint64_t                  frames;
+};
+
+static bool _wlm_eyes_update_pupils(wlm_eyes_t *eyes_ptr);
+static cairo_surface_t *_wlm_eyes_create_static(
+    unsigned width,
+    unsigned height);
+static void _wlm_eyes_draw_around(
+    cairo_t *cairo_ptr,
+    double x,
+    double y,
+    int width,
+    int height);
+static void _wlm_eyes_draw_pupil(
+    cairo_t *cairo_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
+static wlm_eyes_rect_t _wlm_eyes_pupil_rect(
+    wlm_eyes_t *eyes_ptr,
+    int x,
+    int y);
+static void _wlm_eyes_report(
+    const wlm_eyes_rect_t *rect_ptr,
+    wlm_eyes_damage_t damage,
+    void *damage_ud_ptr);
+static bool _wlm_eyes_rect_equals(
+    const wlm_eyes_rect_t *r1_ptr,
+    const wlm_eyes_rect_t *r2_ptr);
+
+/* == Data ================================================================= */
+
+/** Where the eyes are. */
+static const wlm_eyes_placement_t _wlm_eyes_placements[WLM_EYES_NUM] = {
+    { 0.25, 0.5, 0.13, 0.3 },
+    { 0.75, 0.5, 0.13, 0.3 }
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_eyes_t *wlm_eyes_create(void)
+{
+    wlm_eyes_t *eyes_ptr = logged_calloc(1, sizeof(wlm_eyes_t));
+    if (NULL == eyes_ptr) return NULL;
+    eyes_ptr->dirty = true;
+    return eyes_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_eyes_destroy(wlm_eyes_t *eyes_ptr)
+{
+    if (NULL != eyes_ptr->static_surface_ptr) {
+        cairo_surface_destroy(eyes_ptr->static_surface_ptr);
+        eyes_ptr->static_surface_ptr = NULL;
+    }
+    free(eyes_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_eyes_set_size(wlm_eyes_t *eyes_ptr, unsigned width, unsigned height)
+{
+    if (width == eyes_ptr->width && height == eyes_ptr->height) {
+        return eyes_ptr->dirty;
+    }
+
+    eyes_ptr->width = width;
+    eyes_ptr->height = height;
+    if (NULL != eyes_ptr->static_surface_ptr) {
+        cairo_surface_destroy(eyes_ptr->static_surface_ptr);
+        eyes_ptr->static_surface_ptr = NULL;
+    }
+    eyes_ptr->frames = 0;
+    _wlm_eyes_update_pupils(eyes_ptr);
+    eyes_ptr->dirty = true;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_eyes_set_pointer(wlm_eyes_t *eyes_ptr, double x, double y)
+{
+    eyes_ptr->pointer_x = x;
+    eyes_ptr->pointer_y = y;
+    if (_wlm_eyes_update_pupils(eyes_ptr)) eyes_ptr->dirty = true;
+    return eyes_ptr->dirty;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_eyes_draw(
+    wlm_eyes_t *eyes_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned age,
+    wlm_eyes_damage_t damage,
+    void *damage_ud_ptr)
+{
+    wlm_eyes_set_size(eyes_ptr, gfxbuf_ptr->width, gfxbuf_ptr->height);
+    if (NULL == eyes_ptr->static_surface_ptr) {
+        eyes_ptr->static_surface_ptr = _wlm_eyes_create_static(
+            eyes_ptr->width, eyes_ptr->height);
+        if (NULL == eyes_ptr->static_surface_ptr) return false;
+    }
+
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    if (NULL == cairo_ptr) {
+        bs_log(BS_ERROR, "Failed cairo_create_from_bs_gfxbuf(%p)", gfxbuf_ptr);
+        return false;
+    }
+
+    wlm_eyes_rect_t rects[WLM_EYES_NUM];
+    for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+        rects[i] = _wlm_eyes_pupil_rect(
+            eyes_ptr, eyes_ptr->pupil_x[i], eyes_ptr->pupil_y[i]);
+    }
+
+    // A buffer holding a recent frame at this size differs from the new frame
+    // only where the pupils were, and where they are now.
+    if (0 < age && age <= eyes_ptr->frames && age <= WLM_EYES_HISTORY) {
+        const wlm_eyes_rect_t *old_rects = eyes_ptr->history[
+            (eyes_ptr->frames - age) % WLM_EYES_HISTORY];
+        cairo_new_path(cairo_ptr);
+        for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+            if (_wlm_eyes_rect_equals(&old_rects[i], &rects[i])) continue;
+            cairo_rectangle(cairo_ptr,
+                            old_rects[i].x, old_rects[i].y,
+                            old_rects[i].width, old_rects[i].height);
+            cairo_rectangle(cairo_ptr,
+                            rects[i].x, rects[i].y,
+                            rects[i].width, rects[i].height);
+        }
+        cairo_clip(cairo_ptr);
+    }
+
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cairo_ptr, eyes_ptr->static_surface_ptr, 0, 0);
+    cairo_paint(cairo_ptr);
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_OVER);
+    for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+        _wlm_eyes_draw_pupil(
+            cairo_ptr, eyes_ptr->pupil_x[i], eyes_ptr->pupil_y[i],
+            eyes_ptr->width, eyes_ptr->height);
+    }
+    cairo_destroy(cairo_ptr);
+
+    if (0 == eyes_ptr->frames) {
+        wlm_eyes_rect_t r = {
+            .width = eyes_ptr->width, .height = eyes_ptr->height };
+        _wlm_eyes_report(&r, damage, damage_ud_ptr);
+    } else {
+        const wlm_eyes_rect_t *prev_rects = eyes_ptr->history[
+            (eyes_ptr->frames - 1) % WLM_EYES_HISTORY];
+        for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+            if (_wlm_eyes_rect_equals(&prev_rects[i], &rects[i])) continue;
+            _wlm_eyes_report(&prev_rects[i], damage, damage_ud_ptr);
+            _wlm_eyes_report(&rects[i], damage, damage_ud_ptr);
+        }
+    }
+
+    memcpy(eyes_ptr->history[eyes_ptr->frames % WLM_EYES_HISTORY],
+           rects, sizeof(rects));
+    eyes_ptr->frames++;
+    eyes_ptr->dirty = false;
+    return true;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** @return x * x. */
+static inline double sqr(double x)
+{
+    return x * x;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the pupils' positions in whole pixels, from the pointer position.
+ *
+ * @param eyes_ptr
+ *
+ * @return true if any pupil moved to a different pixel.
+ */
+bool _wlm_eyes_update_pupils(wlm_eyes_t *eyes_ptr)
+{
+    bool moved = false;
+    for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+        const wlm_eyes_placement_t *p_ptr = &_wlm_eyes_placements[i];
+        double rel_x = eyes_ptr->pointer_x - p_ptr->x;
+        double rel_y = eyes_ptr->pointer_y - p_ptr->y;
+
+        // Scale the position back to the ellipsis.
+        double ratio = sqr(rel_x / p_ptr->w) + sqr(rel_y / p_ptr->h);
+        if (ratio > 1.0) {
+            rel_x = rel_x / sqrt(ratio);
+            rel_y = rel_y / sqrt(ratio);
+        }
+
+        int x = (int)eyes_ptr->width * (rel_x + p_ptr->x);
+        int y = (int)eyes_ptr->height * (rel_y + p_ptr->y);
+        if (x != eyes_ptr->pupil_x[i] || y != eyes_ptr->pupil_y[i]) {
+            eyes_ptr->pupil_x[i] = x;
+            eyes_ptr->pupil_y[i] = y;
+            moved = true;
+        }
+    }
+    return moved;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Draws background, eye whites and outlines into a new image surface. */
+cairo_surface_t *_wlm_eyes_create_static(unsigned width, unsigned height)
+{
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, width, height);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(%u, %u)",
+               width, height);
+        cairo_surface_destroy(surface_ptr);
+        return NULL;
+    }
+
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
+    for (size_t i = 0; i < WLM_EYES_NUM; ++i) {
+        _wlm_eyes_draw_around(
+            cairo_ptr,
+            _wlm_eyes_placements[i].x, _wlm_eyes_placements[i].y,
+            width, height);
+    }
+    cairo_destroy(cairo_ptr);
+    cairo_surface_flush(surface_ptr);
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Draws the white + border of the eye. */
+void _wlm_eyes_draw_around(cairo_t *cairo_ptr,
+                           double x,
+                           double y,
+                           int width,
+                           int height)
+{
+    double diag = sqrt(width * width + height * height);
+
+    cairo_save(cairo_ptr);
+
+    cairo_translate(cairo_ptr, x * width, y * height);
+    cairo_scale(cairo_ptr, 0.2 * width / diag, 0.4 * height / diag);
+
+    cairo_set_line_width(cairo_ptr, 0);
+    cairo_set_source_rgb(cairo_ptr, 1.0, 1.0, 1.0);
+    cairo_arc(cairo_ptr,
+              0.0, 0.0,
+              diag,
+              0, 2 * M_PI);
+    cairo_fill(cairo_ptr);
+
+    cairo_set_line_width(cairo_ptr, sqrt(width * width + height * height) / 10);
+    cairo_set_source_rgb(cairo_ptr, 0.0, 0.0, 0.0);
+    cairo_arc(cairo_ptr,
+              0.0, 0.0,
+              diag,
+              0, 2 * M_PI);
+    cairo_stroke(cairo_ptr);
+
+    cairo_restore(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Draws the eye's pupil at (x, y). */
+void _wlm_eyes_draw_pupil(cairo_t *cairo_ptr,
+                          int x,
+                          int y,
+                          int width,
+                          int height)
+{
+    cairo_save(cairo_ptr);
+
+    cairo_set_source_rgb(cairo_ptr, 0.0, 0.0, 0.0);
+    cairo_set_line_width(cairo_ptr, sqrt(width * width + height * height) / 15);
+    cairo_set_line_cap(cairo_ptr, CAIRO_LINE_CAP_ROUND);
+    cairo_move_to(cairo_ptr, x, y);
+    cairo_line_to(cairo_ptr, x, y);
+    cairo_stroke(cairo_ptr);
+
+    cairo_restore(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the rectangle covered by a pupil at (x, y), including a pixel of
+ * antialiasing, and clipped to the buffer.
+ */
+wlm_eyes_rect_t _wlm_eyes_pupil_rect(wlm_eyes_t *eyes_ptr, int x, int y)
+{
+    double line_width = sqrt(sqr(eyes_ptr->width) + sqr(eyes_ptr->height)) / 15;
+    int r = (int)ceil(line_width / 2) + 1;
+
+    int x0 = BS_MAX(0, x - r);
+    int y0 = BS_MAX(0, y - r);
+    int x1 = BS_MIN((int)eyes_ptr->width, x + r);
+    int y1 = BS_MIN((int)eyes_ptr->height, y + r);
+    wlm_eyes_rect_t rect = {
+        .x = x0, .y = y0,
+        .width = BS_MAX(0, x1 - x0), .height = BS_MAX(0, y1 - y0) };
+    return rect;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Calls `damage` with `rect_ptr`, unless it is empty or `damage` is NULL. */
+void _wlm_eyes_report(
+    const wlm_eyes_rect_t *rect_ptr,
+    wlm_eyes_damage_t damage,
+    void *damage_ud_ptr)
+{
+    if (NULL == damage || 0 >= rect_ptr->width || 0 >= rect_ptr->height) {
+        return;
+    }
+    damage(rect_ptr, damage_ud_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether both rectangles are the same. */
+bool _wlm_eyes_rect_equals(
+    const wlm_eyes_rect_t *r1_ptr,
+    const wlm_eyes_rect_t *r2_ptr)
+{
+    return (r1_ptr->x == r2_ptr->x && r1_ptr->y == r2_ptr->y &&
+            r1_ptr->width == r2_ptr->width &&
+            r1_ptr->height == r2_ptr->height);
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_eyes_test_replay(bs_test_t *test_ptr);
+static void _wlm_eyes_test_size(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlm_eyes_test_cases[] = {
+    { true, "replay", _wlm_eyes_test_replay },
+    { true, "size", _wlm_eyes_test_size },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_eyes_test_set = BS_TEST_SET(
+    true, "eyes", _wlm_eyes_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/** Damage callback for tests: Adds the area to the `uint64_t` at `ud_ptr`. */
+static void _wlm_eyes_test_damage(const wlm_eyes_rect_t *rect_ptr,
+                                  void *ud_ptr)
+{
+    uint64_t *pixels_ptr = ud_ptr;
+    *pixels_ptr += (uint64_t)rect_ptr->width * rect_ptr->height;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether both buffers hold the same pixels. */
+static bool _wlm_eyes_test_gfxbuf_equals(bs_gfxbuf_t *g1_ptr,
+                                         bs_gfxbuf_t *g2_ptr)
+{
+    if (g1_ptr->width != g2_ptr->width ||
+        g1_ptr->height != g2_ptr->height) return false;
+    for (unsigned y = 0; y < g1_ptr->height; ++y) {
+        if (0 != memcmp(
+                g1_ptr->data_ptr + y * g1_ptr->pixels_per_line,
+                g2_ptr->data_ptr + y * g2_ptr->pixels_per_line,
+                g1_ptr->width * sizeof(uint32_t))) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Replays a recorded pointer path over a double-buffered 64x64 icon. Counts
+ * redraws and damaged pixels, and verifies the incrementally drawn buffers
+ * match a full redraw.
+ */
+void _wlm_eyes_test_replay(bs_test_t *test_ptr)
+{
+    FILE *file_ptr = fopen(
+        bs_test_data_path(test_ptr, "wlmeyes/cursor_path.txt"), "r");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    wlm_eyes_t *eyes_ptr = wlm_eyes_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, eyes_ptr);
+    bs_gfxbuf_t *gfxbufs[2] = {
+        bs_gfxbuf_create(64, 64), bs_gfxbuf_create(64, 64) };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbufs[0]);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbufs[1]);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_eyes_set_size(eyes_ptr, 64, 64));
+
+    char line[64];
+    unsigned samples = 0, redraws = 0;
+    uint64_t damaged_pixels = 0;
+    while (NULL != fgets(line, sizeof(line), file_ptr)) {
+        int x, y;
+        if ('#' == line[0] || 2 != sscanf(line, "%d %d", &x, &y)) continue;
+        ++samples;
+        if (!wlm_eyes_set_pointer(eyes_ptr, x / 256.0, y / 256.0)) continue;
+
+        // Double-buffered: Each buffer holds the frame before the previous.
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlm_eyes_draw(eyes_ptr, gfxbufs[redraws % 2], 2 <= redraws ? 2 : 0,
+                          _wlm_eyes_test_damage, &damaged_pixels));
+        ++redraws;
+    }
+    fclose(file_ptr);
+
+    // Most pointer motion keeps the pupils on the same pixel. Each moved pupil
+    // damages two 10x10 rectangles, and only the first frame is damaged fully.
+    BS_TEST_VERIFY_EQ(test_ptr, 600, samples);
+    BS_TEST_VERIFY_EQ(test_ptr, 106, redraws);
+    BS_TEST_VERIFY_EQ(test_ptr, 29296, damaged_pixels);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlm_eyes_set_pointer(
+            eyes_ptr, eyes_ptr->pointer_x, eyes_ptr->pointer_y));
+
+    wlm_eyes_t *full_ptr = wlm_eyes_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, full_ptr);
+    bs_gfxbuf_t *full_gfxbuf_ptr = bs_gfxbuf_create(64, 64);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, full_gfxbuf_ptr);
+    wlm_eyes_set_size(full_ptr, 64, 64);
+    wlm_eyes_set_pointer(full_ptr, eyes_ptr->pointer_x, eyes_ptr->pointer_y);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlm_eyes_draw(full_ptr, full_gfxbuf_ptr, 0, NULL, NULL));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        _wlm_eyes_test_gfxbuf_equals(full_gfxbuf_ptr,
+                                     gfxbufs[(redraws - 1) % 2]));
+
+    bs_gfxbuf_destroy(full_gfxbuf_ptr);
+    wlm_eyes_destroy(full_ptr);
+    bs_gfxbuf_destroy(gfxbufs[1]);
+    bs_gfxbuf_destroy(gfxbufs[0]);
+    wlm_eyes_destroy(eyes_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies a resize requires a full redraw, and resets the history. */
+void _wlm_eyes_test_size(bs_test_t *test_ptr)
+{
+    wlm_eyes_t *eyes_ptr = wlm_eyes_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, eyes_ptr);
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(32, 32);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+
+    uint64_t damaged_pixels = 0;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_eyes_set_size(eyes_ptr, 32, 32));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlm_eyes_draw(eyes_ptr, gfxbuf_ptr, 1, _wlm_eyes_test_damage,
+                      &damaged_pixels));
+    BS_TEST_VERIFY_EQ(test_ptr, 32 * 32, damaged_pixels);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlm_eyes_set_size(eyes_ptr, 32, 32));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlm_eyes_set_pointer(eyes_ptr, 0, 0));
+
+    // Unchanged pupils: Nothing damaged.
+    damaged_pixels = 0;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlm_eyes_draw(eyes_ptr, gfxbuf_ptr, 1, _wlm_eyes_test_damage,
+                      &damaged_pixels));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, damaged_pixels);
+
+    // Drawing into a larger buffer adopts its size, and damages all of it.
+    bs_gfxbuf_t *large_gfxbuf_ptr = bs_gfxbuf_create(48, 40);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, large_gfxbuf_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlm_eyes_draw(eyes_ptr, large_gfxbuf_ptr, 1, _wlm_eyes_test_damage,
+                      &damaged_pixels));
+    BS_TEST_VERIFY_EQ(test_ptr, 48 * 40, damaged_pixels);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, eyes_ptr->frames);
+
+    bs_gfxbuf_destroy(large_gfxbuf_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+    wlm_eyes_destroy(eyes_ptr);
+}
+
+/* == End of wlm_eyes.c ==================================================== */
@@ -0,0 +1,120 @@
+/* ========================================================================= */
+/**
+ * @file wlm_eyes.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WLM_EYES_H
+#define WLM_EYES_H
+
+#include <stdbool.h>
+
+#include <libbase/libbase.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: Renderer for a pair of eyes. */
+typedef struct _wlm_eyes_t wlm_eyes_t;
+
+/** A rectangle, in buffer pixels. */
+typedef struct {
+    /** Left edge. */
+    int                       x;
+    /** Top edge. */
+    int                       y;
+    /** Width. */
+    int                       width;
+    /** Height. */
+    int                       height;
+} wlm_eyes_rect_t;
+
+/**
+ * Reports an area of the buffer that changed relative to the previous frame.
+ *
+ * @param rect_ptr
+ * @param ud_ptr
+ */
+typedef void (*wlm_eyes_damage_t)(const wlm_eyes_rect_t *rect_ptr,
+                                  void *ud_ptr);
+
+/**
+ * Creates the renderer.
+ *
+ * The eye whites are drawn once per size into a cached surface. Pupils are
+ * placed at whole pixels, and frames only repaint the pupils' rectangles.
+ *
+ * @return The renderer, or NULL on error. Must be destroyed by calling
+ *     @ref wlm_eyes_destroy.
+ */
+wlm_eyes_t *wlm_eyes_create(void);
+
+/** Destroys the renderer. */
+void wlm_eyes_destroy(wlm_eyes_t *eyes_ptr);
+
+/**
+ * Sets the size of the buffers to draw into.
+ *
+ * @param eyes_ptr
+ * @param width
+ * @param height
+ *
+ * @return true if a redraw is needed.
+ */
+bool wlm_eyes_set_size(wlm_eyes_t *eyes_ptr, unsigned width, unsigned height);
+
+/**
+ * Sets the pointer position, relative to the surface.
+ *
+ * @param eyes_ptr
+ * @param x
+ * @param y
+ *
+ * @return true if a pupil moved to a different pixel, ie. a redraw is needed.
+ */
+bool wlm_eyes_set_pointer(wlm_eyes_t *eyes_ptr, double x, double y);
+
+/**
+ * Draws the eyes into `gfxbuf_ptr`.
+ *
+ * @param eyes_ptr
+ * @param gfxbuf_ptr
+ * @param age                 Age of the buffer's contents: 0 if undefined,
+ *                            1 if it holds the previously drawn frame, 2 for
+ *                            the frame before, etc.
+ * @param damage              Called with each area that changed relative to
+ *                            the previous frame.
+ * @param damage_ud_ptr       Argument to `damage`.
+ *
+ * @return true on success.
+ */
+bool wlm_eyes_draw(
+    wlm_eyes_t *eyes_ptr,
+    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned age,
+    wlm_eyes_damage_t damage,
+    void *damage_ud_ptr);
+
+/** Unit test cases. */
+extern const bs_test_set_t wlm_eyes_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* WLM_EYES_H */
+/* == End of wlm_eyes.h ==================================================== */
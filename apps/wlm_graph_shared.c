@@ -33,6 +33,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "wlclient/applet.h"
 #include "wlclient/icon.h"
 #include "wlclient/dblbuf.h"
 
@@ -62,7 +63,7 @@ typedef struct wlm_graph_sample_t {
     uint8_t value_peak;
 } wlm_graph_sample_t;
 
-/** Common graph state (managed internally by wlm_graph_app_run). */
+/** Common graph state (managed internally by wlm_graph_create). */
 typedef struct {
     // -- Sample management --
     /** Allocated sample buffer (graph_size[0] entries). */
@@ -174,6 +175,20 @@ typedef struct {
     wlmcl_dblbuf_t *dblbuf_ptr;
 } wlm_graph_handle_t;
 
+/** State of a graph applet. */
+struct _wlm_graph_t {
+    /** Handle for callbacks. Points into this struct. */
+    wlm_graph_handle_t handle;
+    /** User preferences, as parsed from the applet's arguments. */
+    wlm_graph_prefs_t prefs;
+    /** Copy of the application configuration. */
+    wlm_graph_app_config_t config;
+    /** Host of the applet. */
+    wlmcl_applet_host_t *host_ptr;
+    /** Periodic tick for sampling. */
+    wlmcl_tick_t *tick_ptr;
+};
+
 /* == Forward declarations ================================================= */
 
 static void _wlm_graph_sample_values_free(wlm_graph_sample_t *samples, const uint32_t count);
@@ -217,10 +232,9 @@ static void _wlm_graph_update_with_sample(
     wlm_graph_state_t *graph_state,
     wlm_graph_sample_t *new_sample,
     const wlm_graph_mode_t accumulate_mode);
-static uint64_t _wlm_graph_time_next_update(const uint64_t interval_usec);
 static bool _wlm_graph_icon_render_callback(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr);
 static void _wlm_graph_sample_update(wlm_graph_handle_t *handle);
-static void _wlm_graph_timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr);
+static void _wlm_graph_tick_callback(uint64_t now_usec, void *ud_ptr);
 
 /* == Utility functions ==================================================== */
 
@@ -1070,19 +1084,6 @@ static void _wlm_graph_samples_init(wlm_graph_sample_t *samples, const uint32_t
     }
 }
 
-/* ------------------------------------------------------------------------- */
-/**
- * Calculates the timestamp for the next update.
- *
- * @param interval_usec     Update interval in microseconds.
- *
- * @return Timestamp in microseconds for the next update.
- */
-static uint64_t _wlm_graph_time_next_update(const uint64_t interval_usec)
-{
-    return bs_usec() + interval_usec;
-}
-
 /* ------------------------------------------------------------------------- */
 /**
  * Updates the graph with a new sample, scrolling and rendering.
@@ -1362,18 +1363,22 @@ static void _wlm_graph_sample_update(wlm_graph_handle_t *handle)
 static void _handle_icon_configure(void *ud_ptr, uint32_t width, uint32_t height)
 {
     wlm_graph_handle_t *handle = ud_ptr;
-    if (NULL != handle->dblbuf_ptr) {
+    if (NULL != handle->dblbuf_ptr &&
+        !wlmcl_dblbuf_resize(handle->dblbuf_ptr, width, height)) {
         wlmcl_dblbuf_destroy(handle->dblbuf_ptr);
+        handle->dblbuf_ptr = NULL;
     }
-    handle->dblbuf_ptr = wlmcl_dblbuf_create(
-        wlmcl_client_attributes(handle->wlclient_ptr)->app_id_ptr,
-        wlmcl_icon_wl_surface(handle->icon_ptr),
-        wlmcl_client_attributes(handle->wlclient_ptr)->wl_shm_ptr,
-        width,
-        height);
     if (NULL == handle->dblbuf_ptr) {
-        bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
-        return;
+        handle->dblbuf_ptr = wlmcl_dblbuf_create(
+            wlmcl_client_attributes(handle->wlclient_ptr)->app_id_ptr,
+            wlmcl_icon_wl_surface(handle->icon_ptr),
+            wlmcl_client_attributes(handle->wlclient_ptr)->wl_shm_ptr,
+            width,
+            height);
+        if (NULL == handle->dblbuf_ptr) {
+            bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
+            return;
+        }
     }
     wlmcl_dblbuf_register_ready_callback(
         handle->dblbuf_ptr, _wlm_graph_icon_render_callback, handle);
@@ -1381,12 +1386,14 @@ static void _handle_icon_configure(void *ud_ptr, uint32_t width, uint32_t height
 
 /* ------------------------------------------------------------------------- */
 /**
- * Timer callback for periodic graph updates.
+ * Tick callback for periodic graph updates.
  *
- * @param client_ptr        Wayland client instance.
+ * @param now_usec          Time of the tick, in microseconds.
  * @param ud_ptr            User data pointer (wlm_graph_handle_t).
  */
-static void _wlm_graph_timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr)
+static void _wlm_graph_tick_callback(
+    __UNUSED__ uint64_t now_usec,
+    void *ud_ptr)
 {
     wlm_graph_handle_t * const handle = ud_ptr;
 
@@ -1396,9 +1403,6 @@ static void _wlm_graph_timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr)
         wlmcl_dblbuf_register_ready_callback(
             handle->dblbuf_ptr, _wlm_graph_icon_render_callback, handle);
     }
-    wlmcl_client_register_timer(
-        client_ptr, _wlm_graph_time_next_update(handle->prefs->interval_usec),
-        _wlm_graph_timer_callback, handle);
 }
 
 /* == Internal state management ============================================ */
@@ -1423,104 +1427,122 @@ static void _wlm_graph_state_free(wlm_graph_state_t *graph_state)
 /* == Public API =========================================================== */
 
 /* ------------------------------------------------------------------------- */
-int wlm_graph_app_run(
+wlm_graph_t *wlm_graph_create(
+    wlmcl_applet_host_t *host_ptr,
     int argc,
     const char **argv,
     const wlm_graph_app_config_t *config)
 {
-    bs_log_severity = BS_INFO;
+    wlm_graph_t *graph_ptr = logged_calloc(1, sizeof(wlm_graph_t));
+    if (NULL == graph_ptr) return NULL;
+    graph_ptr->config = *config;
+    graph_ptr->host_ptr = host_ptr;
+    wlm_graph_handle_t * const handle = &graph_ptr->handle;
+    handle->prefs = &graph_ptr->prefs;
+    handle->config = &graph_ptr->config;
+    handle->wlclient_ptr = wlmcl_applet_host_client(host_ptr);
 
     // Parse command line arguments and initialize preferences.
-    wlm_graph_prefs_t prefs;
     const bool has_custom_lut = (NULL != config->pixel_lut);
     const bool has_label = (NULL != config->label_fn);
-    const int parse_result = _wlm_graph_args_parse(
-        argc, argv, config->app_name, config->app_help,
-        has_custom_lut, has_label, &prefs);
-    if (0 != parse_result) {
-        return (1 == parse_result) ? EXIT_SUCCESS : EXIT_FAILURE;
+    if (0 != _wlm_graph_args_parse(
+            argc, argv, config->app_name, config->app_help,
+            has_custom_lut, has_label, &graph_ptr->prefs)) {
+        free(graph_ptr);
+        return NULL;
     }
 
     // Allocate graph state.
     wlm_graph_state_t *graph_state = calloc(1, sizeof(wlm_graph_state_t));
     if (NULL == graph_state) {
         bs_log(BS_ERROR, "%s: Failed to allocate graph state", config->app_name);
-        return EXIT_FAILURE;
+        free(graph_ptr);
+        return NULL;
     }
+    handle->graph_state = graph_state;
 
     // Initialize pixel lookup table.
     if (NULL != config->pixel_lut) {
         memcpy(graph_state->pixel_lut, config->pixel_lut, sizeof(graph_state->pixel_lut));
         graph_state->pixel_line = WLM_GRAPH_PIXEL_LINE_DEFAULT;
     } else {
-        _wlm_graph_pixel_lut_init(graph_state->pixel_lut, &graph_state->pixel_line, prefs.color_mode);
+        _wlm_graph_pixel_lut_init(graph_state->pixel_lut, &graph_state->pixel_line,
+                                  graph_ptr->prefs.color_mode);
     }
 
     // Initialize graph buffers with default icon size.
     const uint32_t size_default[2] = {WLM_GRAPH_BASE_ICON_SIZE, WLM_GRAPH_BASE_ICON_SIZE};
-    if (!_wlm_graph_buffers_resize(graph_state, size_default, prefs.margin_logical_px)) {
+    if (!_wlm_graph_buffers_resize(graph_state, size_default,
+                                   graph_ptr->prefs.margin_logical_px)) {
         bs_log(BS_ERROR, "Icon dimensions too small for graph");
         _wlm_graph_state_free(graph_state);
-        return EXIT_FAILURE;
+        free(graph_ptr);
+        return NULL;
     }
     // Initialize graph pixels (malloc leaves garbage, need opaque black).
     _wlm_graph_rebuild_from_samples(graph_state, config->accumulate_mode);
 
-    // Build wlclient app ID: "wlmaker.<app_name>".
-    char wlclient_app_id[64];
-    snprintf(wlclient_app_id, sizeof(wlclient_app_id), "wlmaker.%s", config->app_name);
-
-    wlmcl_client_t * const wlclient_ptr = wlmcl_client_create(wlclient_app_id);
-    if (NULL == wlclient_ptr) {
+    handle->icon_ptr = wlmcl_icon_create(handle->wlclient_ptr);
+    if (NULL == handle->icon_ptr) {
+        bs_log(BS_ERROR, "Failed to create icon.");
         _wlm_graph_state_free(graph_state);
-        config->state_free_fn(config->app_state);
-        return EXIT_FAILURE;
+        free(graph_ptr);
+        return NULL;
     }
+    wlmcl_icon_register_configure_callback(
+        handle->icon_ptr, _handle_icon_configure, handle);
 
-    if (!wlmcl_icon_supported(wlclient_ptr)) {
-        bs_log(BS_ERROR, "Icon protocol is not supported.");
+    graph_ptr->tick_ptr = wlmcl_applet_host_add_tick(
+        host_ptr, graph_ptr->prefs.interval_usec,
+        _wlm_graph_tick_callback, handle);
+    if (NULL == graph_ptr->tick_ptr) {
+        wlmcl_icon_destroy(handle->icon_ptr);
         _wlm_graph_state_free(graph_state);
-        config->state_free_fn(config->app_state);
-        wlmcl_client_destroy(wlclient_ptr);
-        return EXIT_FAILURE;
+        free(graph_ptr);
+        return NULL;
     }
+    return graph_ptr;
+}
 
-    wlmcl_icon_t * const icon_ptr = wlmcl_icon_create(wlclient_ptr);
-    if (NULL == icon_ptr) {
-        bs_log(BS_ERROR, "Failed to create icon.");
-        _wlm_graph_state_free(graph_state);
-        config->state_free_fn(config->app_state);
-        wlmcl_client_destroy(wlclient_ptr);
-        return EXIT_FAILURE;
+/* ------------------------------------------------------------------------- */
+void wlm_graph_destroy(wlm_graph_t *graph_ptr)
+{
+    wlm_graph_handle_t * const handle = &graph_ptr->handle;
+
+    wlmcl_applet_host_remove_tick(graph_ptr->host_ptr, graph_ptr->tick_ptr);
+    wlmcl_icon_destroy(handle->icon_ptr);
+    if (NULL != handle->dblbuf_ptr) {
+        wlmcl_dblbuf_destroy(handle->dblbuf_ptr);
+        handle->dblbuf_ptr = NULL;
     }
 
-    // Create handle for callbacks.
-    wlm_graph_handle_t handle = {
-        .graph_state = graph_state,
-        .prefs = &prefs,
-        .icon_ptr = icon_ptr,
-        .config = config,
-        .wlclient_ptr = wlclient_ptr,
-        .dblbuf_ptr = NULL,
-    };
+    _wlm_graph_state_free(handle->graph_state);
+    graph_ptr->config.state_free_fn(graph_ptr->config.app_state);
+    free(graph_ptr);
+}
 
-    wlmcl_icon_register_configure_callback(
-        icon_ptr, _handle_icon_configure, &handle);
-    wlmcl_client_register_timer(
-        wlclient_ptr, _wlm_graph_time_next_update(prefs.interval_usec),
-        _wlm_graph_timer_callback, &handle);
-
-    wlmcl_client_run(wlclient_ptr);
-    wlmcl_icon_destroy(icon_ptr);
-    if (NULL != handle.dblbuf_ptr) {
-        wlmcl_dblbuf_destroy(handle.dblbuf_ptr);
-        handle.dblbuf_ptr = NULL;
+/* ------------------------------------------------------------------------- */
+int wlm_graph_app_run(
+    int argc,
+    const char **argv,
+    const wlm_graph_app_config_t *config,
+    const wlmcl_applet_t *applet_ptr)
+{
+    bs_log_severity = BS_INFO;
+
+    // Handles --help and malformed arguments before connecting.
+    wlm_graph_prefs_t prefs;
+    const int parse_result = _wlm_graph_args_parse(
+        argc, argv, config->app_name, config->app_help,
+        NULL != config->pixel_lut, NULL != config->label_fn, &prefs);
+    if (0 != parse_result) {
+        return (1 == parse_result) ? EXIT_SUCCESS : EXIT_FAILURE;
     }
 
-    _wlm_graph_state_free(graph_state);
-    config->state_free_fn(config->app_state);
-    wlmcl_client_destroy(wlclient_ptr);
-    return EXIT_SUCCESS;
+    // Build wlclient app ID: "wlmaker.<app_name>".
+    char wlclient_app_id[64];
+    snprintf(wlclient_app_id, sizeof(wlclient_app_id), "wlmaker.%s", config->app_name);
+    return wlmcl_applet_main(wlclient_app_id, applet_ptr, argc, argv);
 }
 
 /* == End of wlm_graph_shared.c ============================================ */
@@ -25,6 +25,8 @@
 
 #include <stdint.h>
 
+#include <wlclient/applet.h>
+
 /* == Definitions ========================================================== */
 
 /**
@@ -80,7 +82,7 @@ typedef enum {
 /**
  * Configuration for a graph application.
  *
- * Pass to wlm_graph_app_run() to configure the graph behavior.
+ * Pass to wlm_graph_create() to configure the graph behavior.
  */
 typedef struct {
     /** Application name (e.g., "wlmcpugraph"). Used for error messages. */
@@ -154,26 +156,59 @@ typedef struct {
     const char *(*label_fn)(void *app_state);
 } wlm_graph_app_config_t;
 
+/** Forward declaration: A graph applet. */
+typedef struct _wlm_graph_t wlm_graph_t;
+
 /* == Public API =========================================================== */
 
 /**
- * Runs a graph application.
+ * Creates a graph applet on the host.
+ *
+ * Handles argument parsing, icon creation and callback registration. Apps
+ * just need to initialize their state and provide a configuration. Samples
+ * are taken on the host's ticker, together with all other applets of the
+ * same interval.
+ *
+ * Graph state is managed internally.
+ *
+ * @param host_ptr  The applet host.
+ * @param argc      Argument count.
+ * @param argv      Argument vector.
+ * @param config    Application configuration. Will be copied.
+ *
+ * @return The graph, or NULL on error (or if --help was shown). On error,
+ *     config->state_free_fn is not called. Must be destroyed by calling
+ *     wlm_graph_destroy().
+ */
+wlm_graph_t *wlm_graph_create(
+    wlmcl_applet_host_t *host_ptr,
+    int argc,
+    const char **argv,
+    const wlm_graph_app_config_t *config);
+
+/**
+ * Destroys the graph applet, and calls config->state_free_fn.
  *
- * Handles argument parsing, wlclient setup, icon creation, callback
- * registration, main loop, and cleanup. Apps just need to initialize their
- * state and provide a configuration.
+ * @param graph_ptr
+ */
+void wlm_graph_destroy(wlm_graph_t *graph_ptr);
+
+/**
+ * Runs a graph application as a standalone binary.
  *
- * Graph state is managed internally by this function.
+ * Handles --help, then runs the applet in a host of its own.
  *
  * @param argc      Argument count.
  * @param argv      Argument vector.
- * @param config    Application configuration.
+ * @param config    Application configuration, for --help.
+ * @param applet_ptr The applet.
  *
  * @return EXIT_SUCCESS or EXIT_FAILURE.
  */
 int wlm_graph_app_run(
     int argc,
     const char **argv,
-    const wlm_graph_app_config_t *config);
+    const wlm_graph_app_config_t *config,
+    const wlmcl_applet_t *applet_ptr);
 
 #endif /* WLM_GRAPH_SHARED_H */
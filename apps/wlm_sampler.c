@@ -0,0 +1,646 @@
+/* ========================================================================= */
+/**
+ * @file wlm_sampler.c
+ *
+ * Single-pass samplers for `/proc` and sysfs files. The read buffer is kept
+ * across samples, and only grows when a file outgrows it.
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "wlm_sampler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <libbase/libbase.h>
+
+/* == Definitions ========================================================== */
+
+/** Initial size of the read buffer. Fits `/proc/stat` of most systems. */
+#define WLM_SAMPLER_INITIAL_SIZE 4096
+
+/**
+ * Reads of a shared sampler within this many microseconds of the previous
+ * read return the previous contents. Applets ticking together thus cause a
+ * single read.
+ */
+#define WLM_SAMPLER_SHARED_USEC 50000
+
+/** State of a sampler. */
+struct _wlm_sampler_t {
+    /** File descriptor of the sampled file. */
+    int                       fd;
+    /** Path of the sampled file. For logging. */
+    char                      *path_ptr;
+    /** Read buffer. */
+    char                      *data_ptr;
+    /** Size of the read buffer, in bytes. */
+    size_t                    size;
+
+    /** Element of @ref _wlm_sampler_shared, if acquired. */
+    bs_dllist_node_t          dlnode;
+    /** References held through @ref wlm_sampler_acquire. */
+    unsigned                  refs;
+    /** Time of the last successful read, in microseconds. */
+    uint64_t                  read_usec;
+    /** Number of bytes from the last successful read. */
+    size_t                    len;
+};
+
+/** Samplers acquired through @ref wlm_sampler_acquire. */
+static bs_dllist_t _wlm_sampler_shared;
+
+static wlm_sampler_t *_wlm_sampler_create_with_size(
+    const char *path_ptr,
+    size_t size);
+static const char *_wlm_sampler_next_line(
+    const char *pos_ptr,
+    const char *end_ptr);
+static bool _wlm_sampler_scan_u64(
+    const char **pos_ptr,
+    const char *end_ptr,
+    uint64_t *value_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_sampler_t *wlm_sampler_create(const char *path_ptr)
+{
+    return _wlm_sampler_create_with_size(path_ptr, WLM_SAMPLER_INITIAL_SIZE);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_sampler_destroy(wlm_sampler_t *sampler_ptr)
+{
+    if (0 <= sampler_ptr->fd) {
+        close(sampler_ptr->fd);
+        sampler_ptr->fd = -1;
+    }
+    if (NULL != sampler_ptr->data_ptr) {
+        free(sampler_ptr->data_ptr);
+        sampler_ptr->data_ptr = NULL;
+    }
+    if (NULL != sampler_ptr->path_ptr) {
+        free(sampler_ptr->path_ptr);
+        sampler_ptr->path_ptr = NULL;
+    }
+    free(sampler_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlm_sampler_t *wlm_sampler_acquire(const char *path_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = _wlm_sampler_shared.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlm_sampler_t *sampler_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlm_sampler_t, dlnode);
+        if (0 != strcmp(sampler_ptr->path_ptr, path_ptr)) continue;
+        ++sampler_ptr->refs;
+        return sampler_ptr;
+    }
+
+    wlm_sampler_t *sampler_ptr = wlm_sampler_create(path_ptr);
+    if (NULL == sampler_ptr) return NULL;
+    sampler_ptr->refs = 1;
+    bs_dllist_push_back(&_wlm_sampler_shared, &sampler_ptr->dlnode);
+    return sampler_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_sampler_release(wlm_sampler_t *sampler_ptr)
+{
+    BS_ASSERT(0 < sampler_ptr->refs);
+    if (0 < --sampler_ptr->refs) return;
+    bs_dllist_remove(&_wlm_sampler_shared, &sampler_ptr->dlnode);
+    wlm_sampler_destroy(sampler_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+const char *wlm_sampler_read(wlm_sampler_t *sampler_ptr, size_t *len_ptr)
+{
+    uint64_t now_usec = bs_usec();
+    if (1 < sampler_ptr->refs &&
+        0 < sampler_ptr->read_usec &&
+        now_usec < sampler_ptr->read_usec + WLM_SAMPLER_SHARED_USEC) {
+        *len_ptr = sampler_ptr->len;
+        return sampler_ptr->data_ptr;
+    }
+
+    size_t len = 0;
+    while (true) {
+        // Keeps one byte for the NUL terminator.
+        ssize_t rv = pread(
+            sampler_ptr->fd,
+            sampler_ptr->data_ptr + len,
+            sampler_ptr->size - 1 - len,
+            (off_t)len);
+        if (0 > rv) {
+            if (EINTR == errno) continue;
+            bs_log(BS_WARNING | BS_ERRNO, "Failed pread(%d, %p, %zu, %zu) "
+                   "for \"%s\"", sampler_ptr->fd, sampler_ptr->data_ptr + len,
+                   sampler_ptr->size - 1 - len, len, sampler_ptr->path_ptr);
+            return NULL;
+        }
+        len += (size_t)rv;
+
+        // A short read means we got it all. This is the common case.
+        if (len < sampler_ptr->size - 1) break;
+
+        // Buffer was filled up entirely: Grow it and continue reading.
+        char *data_ptr = realloc(sampler_ptr->data_ptr, 2 * sampler_ptr->size);
+        if (NULL == data_ptr) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   sampler_ptr->data_ptr, 2 * sampler_ptr->size);
+            return NULL;
+        }
+        sampler_ptr->data_ptr = data_ptr;
+        sampler_ptr->size = 2 * sampler_ptr->size;
+    }
+
+    sampler_ptr->data_ptr[len] = '\0';
+    sampler_ptr->read_usec = now_usec;
+    sampler_ptr->len = len;
+    *len_ptr = len;
+    return sampler_ptr->data_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlm_sampler_parse_stat(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_cpu_times_t *cpus_ptr,
+    size_t cpus_max)
+{
+    const char *end_ptr = data_ptr + len;
+    size_t cpus = 0;
+
+    for (const char *line_ptr = data_ptr;
+         line_ptr < end_ptr;
+         line_ptr = _wlm_sampler_next_line(line_ptr, end_ptr)) {
+        if (4 > end_ptr - line_ptr ||
+            0 != memcmp(line_ptr, "cpu", 3)) {
+            // The per-CPU lines are adjacent, and on top of `/proc/stat`.
+            // Once past them, skip the (lengthy) remainder.
+            if (0 < cpus) break;
+            continue;
+        }
+        // Skips the aggregate "cpu" line, look for "cpu0", "cpu1", etc.
+        if ('0' > line_ptr[3] || '9' < line_ptr[3]) continue;
+
+        const char *pos_ptr = line_ptr + 4;
+        while (pos_ptr < end_ptr && '0' <= *pos_ptr && '9' >= *pos_ptr) {
+            ++pos_ptr;
+        }
+
+        // user, nice, system, idle, iowait, irq, softirq.
+        uint64_t v[7];
+        size_t fields = 0;
+        while (fields < 7 && _wlm_sampler_scan_u64(&pos_ptr, end_ptr,
+                                                   &v[fields])) ++fields;
+        if (7 != fields) continue;
+
+        if (cpus < cpus_max) {
+            cpus_ptr[cpus].total = v[0] + v[1] + v[2] + v[3] + v[4] + v[5] + v[6];
+            cpus_ptr[cpus].idle = v[3] + v[4];
+        }
+        ++cpus;
+    }
+    return cpus;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_sampler_parse_meminfo(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_meminfo_t *meminfo_ptr)
+{
+    /** Associates a label with the field it is stored in. */
+    const struct {
+        const char *label_ptr;
+        size_t label_len;
+        uint64_t *value_ptr;
+    } fields[] = {
+        { "MemTotal", 8, &meminfo_ptr->total },
+        { "MemFree", 7, &meminfo_ptr->free },
+        { "Buffers", 7, &meminfo_ptr->buffers },
+        { "Cached", 6, &meminfo_ptr->cached },
+        { "SReclaimable", 12, &meminfo_ptr->sreclaimable },
+    };
+    const size_t fields_num = sizeof(fields) / sizeof(fields[0]);
+
+    *meminfo_ptr = (wlm_sampler_meminfo_t){};
+    const char *end_ptr = data_ptr + len;
+    size_t fields_found = 0;
+    for (const char *line_ptr = data_ptr;
+         line_ptr < end_ptr && fields_found < fields_num;
+         line_ptr = _wlm_sampler_next_line(line_ptr, end_ptr)) {
+        const char *eol_ptr = memchr(line_ptr, '\n', end_ptr - line_ptr);
+        if (NULL == eol_ptr) eol_ptr = end_ptr;
+        const char *colon_ptr = memchr(line_ptr, ':', eol_ptr - line_ptr);
+        if (NULL == colon_ptr) continue;
+
+        const size_t label_len = colon_ptr - line_ptr;
+        for (size_t i = 0; i < fields_num; ++i) {
+            if (label_len != fields[i].label_len ||
+                0 != memcmp(line_ptr, fields[i].label_ptr, label_len)) {
+                continue;
+            }
+            const char *pos_ptr = colon_ptr + 1;
+            if (_wlm_sampler_scan_u64(&pos_ptr, eol_ptr, fields[i].value_ptr)) {
+                ++fields_found;
+            }
+            break;
+        }
+    }
+    return 0 != meminfo_ptr->total;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_sampler_parse_net_dev(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_net_dev_t *net_dev_ptr)
+{
+    *net_dev_ptr = (wlm_sampler_net_dev_t){};
+    const char *end_ptr = data_ptr + len;
+
+    // Skips the two header lines. Each must be terminated.
+    const char *line_ptr = data_ptr;
+    for (int i = 0; i < 2; ++i) {
+        const char *eol_ptr = memchr(line_ptr, '\n', end_ptr - line_ptr);
+        if (NULL == eol_ptr) return false;
+        line_ptr = eol_ptr + 1;
+    }
+
+    for (; line_ptr < end_ptr;
+         line_ptr = _wlm_sampler_next_line(line_ptr, end_ptr)) {
+        const char *eol_ptr = memchr(line_ptr, '\n', end_ptr - line_ptr);
+        if (NULL == eol_ptr) eol_ptr = end_ptr;
+        const char *colon_ptr = memchr(line_ptr, ':', eol_ptr - line_ptr);
+        if (NULL == colon_ptr) continue;
+
+        const char *name_ptr = line_ptr;
+        while (name_ptr < colon_ptr && ' ' == *name_ptr) ++name_ptr;
+        if (2 == colon_ptr - name_ptr && 0 == memcmp(name_ptr, "lo", 2)) {
+            continue;
+        }
+
+        // Format: rx_bytes rx_packets rx_errs rx_drop rx_fifo rx_frame
+        //         rx_compressed rx_multicast tx_bytes tx_packets ...
+        const char *pos_ptr = colon_ptr + 1;
+        uint64_t v[9];
+        size_t fields = 0;
+        while (fields < 9 && _wlm_sampler_scan_u64(&pos_ptr, eol_ptr,
+                                                   &v[fields])) ++fields;
+        if (9 != fields) continue;
+
+        net_dev_ptr->rx_bytes += v[0];
+        net_dev_ptr->tx_bytes += v[8];
+        ++net_dev_ptr->interfaces;
+    }
+    return true;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the sampler, with a read buffer of the specified initial size.
+ *
+ * @param path_ptr
+ * @param size                Must be at least 2.
+ *
+ * @return Pointer to the sampler, or NULL on error.
+ */
+wlm_sampler_t *_wlm_sampler_create_with_size(
+    const char *path_ptr,
+    size_t size)
+{
+    BS_ASSERT(2 <= size);
+    wlm_sampler_t *sampler_ptr = logged_calloc(1, sizeof(wlm_sampler_t));
+    if (NULL == sampler_ptr) return NULL;
+    sampler_ptr->fd = -1;
+
+    sampler_ptr->path_ptr = logged_strdup(path_ptr);
+    if (NULL == sampler_ptr->path_ptr) goto error;
+
+    sampler_ptr->size = size;
+    sampler_ptr->data_ptr = logged_malloc(sampler_ptr->size);
+    if (NULL == sampler_ptr->data_ptr) goto error;
+
+    sampler_ptr->fd = open(path_ptr, O_RDONLY | O_CLOEXEC);
+    if (0 > sampler_ptr->fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed open(\"%s\", O_RDONLY)", path_ptr);
+        goto error;
+    }
+    return sampler_ptr;
+
+error:
+    wlm_sampler_destroy(sampler_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns a pointer to the start of the next line, or `end_ptr`. */
+const char *_wlm_sampler_next_line(const char *pos_ptr, const char *end_ptr)
+{
+    const char *eol_ptr = memchr(pos_ptr, '\n', end_ptr - pos_ptr);
+    return NULL == eol_ptr ? end_ptr : eol_ptr + 1;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Scans an unsigned decimal integer, skipping leading blanks.
+ *
+ * Does not cross line boundaries, and never reads at or beyond `end_ptr`.
+ *
+ * @param pos_ptr             Points to the current position. Will be moved
+ *                            beyond the integer, on success.
+ * @param end_ptr
+ * @param value_ptr
+ *
+ * @return true if an integer was found.
+ */
+bool _wlm_sampler_scan_u64(
+    const char **pos_ptr,
+    const char *end_ptr,
+    uint64_t *value_ptr)
+{
+    const char *p = *pos_ptr;
+    while (p < end_ptr && (' ' == *p || '\t' == *p)) ++p;
+    if (p >= end_ptr || '0' > *p || '9' < *p) return false;
+
+    uint64_t value = 0;
+    for (; p < end_ptr && '0' <= *p && '9' >= *p; ++p) {
+        value = value * 10 + (uint64_t)(*p - '0');
+    }
+    *value_ptr = value;
+    *pos_ptr = p;
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_sampler_test_stat(bs_test_t *test_ptr);
+static void _wlm_sampler_test_meminfo(bs_test_t *test_ptr);
+static void _wlm_sampler_test_net_dev(bs_test_t *test_ptr);
+static void _wlm_sampler_test_read(bs_test_t *test_ptr);
+static void _wlm_sampler_test_shared(bs_test_t *test_ptr);
+static void _wlm_sampler_test_fuzz(bs_test_t *test_ptr);
+static void _wlm_sampler_test_benchmark(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlm_sampler_test_cases[] = {
+    { true, "stat", _wlm_sampler_test_stat },
+    { true, "meminfo", _wlm_sampler_test_meminfo },
+    { true, "net_dev", _wlm_sampler_test_net_dev },
+    { true, "read", _wlm_sampler_test_read },
+    { true, "shared", _wlm_sampler_test_shared },
+    { true, "fuzz", _wlm_sampler_test_fuzz },
+    { true, "benchmark", _wlm_sampler_test_benchmark },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_sampler_test_set = BS_TEST_SET(
+    true, "sampler", _wlm_sampler_test_cases);
+
+/** Names of the recorded fixture files, in `tests/data/sampler`. */
+static const char *_wlm_sampler_test_fixtures[] = {
+    "sampler/proc_stat", "sampler/proc_meminfo", "sampler/proc_net_dev"
+};
+
+/* ------------------------------------------------------------------------- */
+/** Parses the recorded `/proc/stat`. */
+void _wlm_sampler_test_stat(bs_test_t *test_ptr)
+{
+    wlm_sampler_t *s = wlm_sampler_create(
+        bs_test_data_path(test_ptr, "sampler/proc_stat"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+    size_t len;
+    const char *d = wlm_sampler_read(s, &len);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+
+    // Counts without storing.
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlm_sampler_parse_stat(d, len, NULL, 0));
+
+    // Stores up to the limit, but counts all.
+    wlm_sampler_cpu_times_t cpus[4] = {};
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlm_sampler_parse_stat(d, len, cpus, 2));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, cpus[2].total);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlm_sampler_parse_stat(d, len, cpus, 4));
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        268719 + 548 + 83361 + 6448172 + 7811 + 0 + 5240,
+        cpus[0].total);
+    BS_TEST_VERIFY_EQ(test_ptr, 6448172 + 7811, cpus[0].idle);
+    BS_TEST_VERIFY_EQ(test_ptr, 6458148 + 7605, cpus[3].idle);
+
+    wlm_sampler_destroy(s);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Parses the recorded `/proc/meminfo`. */
+void _wlm_sampler_test_meminfo(bs_test_t *test_ptr)
+{
+    wlm_sampler_t *s = wlm_sampler_create(
+        bs_test_data_path(test_ptr, "sampler/proc_meminfo"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+    size_t len;
+    const char *d = wlm_sampler_read(s, &len);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+
+    wlm_sampler_meminfo_t m;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_sampler_parse_meminfo(d, len, &m));
+    BS_TEST_VERIFY_EQ(test_ptr, 16303420, m.total);
+    BS_TEST_VERIFY_EQ(test_ptr, 6851732, m.free);
+    BS_TEST_VERIFY_EQ(test_ptr, 412688, m.buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 4436040, m.cached);
+    BS_TEST_VERIFY_EQ(test_ptr, 249924, m.sreclaimable);
+
+    BS_TEST_VERIFY_FALSE(test_ptr, wlm_sampler_parse_meminfo("", 0, &m));
+    wlm_sampler_destroy(s);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Parses the recorded `/proc/net/dev`. */
+void _wlm_sampler_test_net_dev(bs_test_t *test_ptr)
+{
+    wlm_sampler_t *s = wlm_sampler_create(
+        bs_test_data_path(test_ptr, "sampler/proc_net_dev"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+    size_t len;
+    const char *d = wlm_sampler_read(s, &len);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+
+    wlm_sampler_net_dev_t n;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_sampler_parse_net_dev(d, len, &n));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, n.interfaces);
+    BS_TEST_VERIFY_EQ(test_ptr, 8825471330ULL + 2043812ULL, n.rx_bytes);
+    BS_TEST_VERIFY_EQ(test_ptr, 612530213ULL + 918273ULL, n.tx_bytes);
+
+    BS_TEST_VERIFY_FALSE(test_ptr, wlm_sampler_parse_net_dev("a\n", 2, &n));
+    wlm_sampler_destroy(s);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies reading, with a buffer that needs to grow. */
+void _wlm_sampler_test_read(bs_test_t *test_ptr)
+{
+    const char *p = bs_test_data_path(test_ptr, "sampler/proc_stat");
+    wlm_sampler_t *s = _wlm_sampler_create_with_size(p, 16);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+
+    size_t len;
+    const char *d = wlm_sampler_read(s, &len);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+    BS_TEST_VERIFY_EQ(test_ptr, 521, len);
+    BS_TEST_VERIFY_EQ(test_ptr, 1024, s->size);
+    BS_TEST_VERIFY_EQ(test_ptr, '\0', d[len]);
+
+    // A second read re-uses the buffer.
+    BS_TEST_VERIFY_EQ(test_ptr, d, wlm_sampler_read(s, &len));
+    BS_TEST_VERIFY_EQ(test_ptr, 521, len);
+    wlm_sampler_destroy(s);
+
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlm_sampler_create("/does/not/exist"));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies sharing of acquired samplers, and coalescing of their reads. */
+void _wlm_sampler_test_shared(bs_test_t *test_ptr)
+{
+    const char *p = bs_test_data_path(test_ptr, "sampler/proc_stat");
+    wlm_sampler_t *s1 = wlm_sampler_acquire(p);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s1);
+    wlm_sampler_t *s2 = wlm_sampler_acquire(p);
+    BS_TEST_VERIFY_EQ(test_ptr, s1, s2);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, s1->refs);
+    wlm_sampler_t *s3 = wlm_sampler_acquire(
+        bs_test_data_path(test_ptr, "sampler/proc_meminfo"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s3);
+    BS_TEST_VERIFY_NEQ(test_ptr, s1, s3);
+
+    size_t len;
+    const char *d = wlm_sampler_read(s1, &len);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+    BS_TEST_VERIFY_EQ(test_ptr, 'c', d[0]);
+
+    // A read right after returns the same contents, without reading.
+    s1->data_ptr[0] = 'X';
+    len = 0;
+    BS_TEST_VERIFY_EQ(test_ptr, 'X', wlm_sampler_read(s1, &len)[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 521, len);
+
+    // With a single reference left, every read reads.
+    wlm_sampler_release(s2);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s1->refs);
+    BS_TEST_VERIFY_EQ(test_ptr, 'c', wlm_sampler_read(s1, &len)[0]);
+
+    wlm_sampler_release(s1);
+    wlm_sampler_release(s3);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&_wlm_sampler_shared));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Feeds truncated and mutated fixtures to all parsers.
+ *
+ * Each input is copied into an exactly-sized, non-terminated allocation, so
+ * that a sanitizer or valgrind will flag any out-of-bounds read.
+ */
+void _wlm_sampler_test_fuzz(bs_test_t *test_ptr)
+{
+    uint32_t seed = 0x5eed;
+    for (size_t f = 0; f < 3; ++f) {
+        wlm_sampler_t *s = wlm_sampler_create(
+            bs_test_data_path(test_ptr, _wlm_sampler_test_fixtures[f]));
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+        size_t len;
+        const char *d = wlm_sampler_read(s, &len);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+
+        wlm_sampler_cpu_times_t cpus[8];
+        wlm_sampler_meminfo_t m;
+        wlm_sampler_net_dev_t n;
+        for (size_t i = 0; i <= 2 * len; ++i) {
+            // First round: All prefixes. Second round: Mutations.
+            const size_t l = BS_MIN(i, len);
+            char *b = logged_malloc(BS_MAX(l, 1u));
+            BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b);
+            memcpy(b, d, l);
+            if (i > len) {
+                for (int j = 0; j < 4; ++j) {
+                    seed = seed * 1103515245 + 12345;
+                    b[(seed >> 8) % l] = (char)(seed >> 24);
+                }
+            }
+            BS_TEST_VERIFY_TRUE(
+                test_ptr, 8 >= wlm_sampler_parse_stat(b, l, cpus, 8));
+            wlm_sampler_parse_meminfo(b, l, &m);
+            wlm_sampler_parse_net_dev(b, l, &n);
+            free(b);
+        }
+        wlm_sampler_destroy(s);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Measures read and parse throughput on the recorded fixtures. */
+void _wlm_sampler_test_benchmark(bs_test_t *test_ptr)
+{
+    const int iterations = 10000;
+    for (size_t f = 0; f < 3; ++f) {
+        wlm_sampler_t *s = wlm_sampler_create(
+            bs_test_data_path(test_ptr, _wlm_sampler_test_fixtures[f]));
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s);
+
+        uint64_t read_usec = 0, parse_usec = 0, sink = 0;
+        for (int i = 0; i < iterations; ++i) {
+            size_t len;
+            uint64_t t0 = bs_usec();
+            const char *d = wlm_sampler_read(s, &len);
+            uint64_t t1 = bs_usec();
+            BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+
+            wlm_sampler_cpu_times_t cpus[4];
+            wlm_sampler_meminfo_t m;
+            wlm_sampler_net_dev_t n;
+            switch (f) {
+            case 0: sink += wlm_sampler_parse_stat(d, len, cpus, 4); break;
+            case 1: sink += wlm_sampler_parse_meminfo(d, len, &m); break;
+            default: sink += wlm_sampler_parse_net_dev(d, len, &n); break;
+            }
+            parse_usec += bs_usec() - t1;
+            read_usec += t1 - t0;
+        }
+        BS_TEST_VERIFY_NEQ(test_ptr, 0, sink);
+        bs_log(BS_INFO, "Sampler %s: %.1f ns/read, %.1f ns/parse",
+               _wlm_sampler_test_fixtures[f],
+               1e3 * read_usec / iterations,
+               1e3 * parse_usec / iterations);
+        wlm_sampler_destroy(s);
+    }
+}
+
+/* == End of wlm_sampler.c ================================================= */
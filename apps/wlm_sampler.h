@@ -0,0 +1,188 @@
+/* ========================================================================= */
+/**
+ * @file wlm_sampler.h
+ *
+ * Single-pass samplers for `/proc` and sysfs files. The read buffer is kept
+ * across samples, and only grows when a file outgrows it.
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef WLM_SAMPLER_H
+#define WLM_SAMPLER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libbase/libbase.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/** Forward declaration: A sampler for one `/proc` or sysfs file. */
+typedef struct _wlm_sampler_t wlm_sampler_t;
+
+/** Absolute CPU time values of one CPU, from `/proc/stat`. */
+typedef struct {
+    /** Sum of user, nice, system, idle, iowait, irq and softirq. */
+    uint64_t total;
+    /** Idle time (idle + iowait). */
+    uint64_t idle;
+} wlm_sampler_cpu_times_t;
+
+/** Values of interest from `/proc/meminfo`, all in kB. */
+typedef struct {
+    /** MemTotal. */
+    uint64_t total;
+    /** MemFree. */
+    uint64_t free;
+    /** Buffers. */
+    uint64_t buffers;
+    /** Cached. */
+    uint64_t cached;
+    /** SReclaimable. */
+    uint64_t sreclaimable;
+} wlm_sampler_meminfo_t;
+
+/** Byte counters summed over all non-loopback interfaces of `/proc/net/dev`. */
+typedef struct {
+    /** Sum of received bytes. */
+    uint64_t rx_bytes;
+    /** Sum of transmitted bytes. */
+    uint64_t tx_bytes;
+    /** Number of interfaces included in the sums. */
+    uint32_t interfaces;
+} wlm_sampler_net_dev_t;
+
+/**
+ * Creates a sampler for the file at `path_ptr`.
+ *
+ * Opens the file once, and allocates the read buffer. Subsequent calls to
+ * @ref wlm_sampler_read re-use both, and do not allocate -- unless the file
+ * grew beyond the buffer's size.
+ *
+ * @param path_ptr
+ *
+ * @return A pointer to the sampler, or NULL on error. Must be destroyed by
+ *     calling @ref wlm_sampler_destroy.
+ */
+wlm_sampler_t *wlm_sampler_create(const char *path_ptr);
+
+/**
+ * Destroys the sampler.
+ *
+ * @param sampler_ptr
+ */
+void wlm_sampler_destroy(wlm_sampler_t *sampler_ptr);
+
+/**
+ * Acquires a sampler for the file at `path_ptr`, shared within the process.
+ *
+ * All callers acquiring the same path share one sampler, ie. one file
+ * descriptor and one buffer. While shared, reads in quick succession return
+ * the contents of the first read: Applets of one host that tick together
+ * thus read each file only once.
+ *
+ * @param path_ptr
+ *
+ * @return A pointer to the sampler, or NULL on error. Must be released by
+ *     calling @ref wlm_sampler_release.
+ */
+wlm_sampler_t *wlm_sampler_acquire(const char *path_ptr);
+
+/**
+ * Releases a sampler acquired by @ref wlm_sampler_acquire. Destroys it when
+ * the last reference is released.
+ *
+ * @param sampler_ptr
+ */
+void wlm_sampler_release(wlm_sampler_t *sampler_ptr);
+
+/**
+ * Reads the current contents of the sampled file.
+ *
+ * Uses `pread` at offset 0 into the sampler's buffer. A single syscall is
+ * issued when the buffer holds the full contents. The buffer is grown (and
+ * reading continued) only if it was filled up entirely.
+ *
+ * @param sampler_ptr
+ * @param len_ptr             Set to the number of bytes read.
+ *
+ * @return Pointer to the contents, or NULL on error. The contents remain
+ *     valid until the next call to @ref wlm_sampler_read or
+ *     @ref wlm_sampler_destroy. They are NUL-terminated.
+ */
+const char *wlm_sampler_read(wlm_sampler_t *sampler_ptr, size_t *len_ptr);
+
+/**
+ * Parses the per-CPU lines (`cpu0`, `cpu1`, ...) of `/proc/stat` contents.
+ *
+ * Stores at most `cpus_max` entries into `cpus_ptr`, but continues counting
+ * beyond that. If the returned count exceeds `cpus_max`, the caller should
+ * grow the array and parse the same contents again.
+ *
+ * @param data_ptr
+ * @param len
+ * @param cpus_ptr            Array of at least `cpus_max` elements. May be
+ *                            NULL if `cpus_max` is 0.
+ * @param cpus_max
+ *
+ * @return Number of per-CPU lines found.
+ */
+size_t wlm_sampler_parse_stat(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_cpu_times_t *cpus_ptr,
+    size_t cpus_max);
+
+/**
+ * Parses `/proc/meminfo` contents.
+ *
+ * @param data_ptr
+ * @param len
+ * @param meminfo_ptr
+ *
+ * @return true if `MemTotal` was found, and is non-zero.
+ */
+bool wlm_sampler_parse_meminfo(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_meminfo_t *meminfo_ptr);
+
+/**
+ * Parses `/proc/net/dev` contents, summing up all interfaces except `lo`.
+ *
+ * @param data_ptr
+ * @param len
+ * @param net_dev_ptr
+ *
+ * @return true if the two header lines were found.
+ */
+bool wlm_sampler_parse_net_dev(
+    const char *data_ptr,
+    size_t len,
+    wlm_sampler_net_dev_t *net_dev_ptr);
+
+/** Unit test cases. */
+extern const bs_test_set_t wlm_sampler_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* WLM_SAMPLER_H */
+/* == End of wlm_sampler.h ================================================= */
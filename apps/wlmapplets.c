@@ -0,0 +1,116 @@
+/* ========================================================================= */
+/**
+ * @file wlmapplets.c
+ *
+ * Hosts several dock-apps in one process, over a single Wayland connection.
+ *
+ * Each applet keeps its own icon surface. The applets share the client, its
+ * event loop and shm pools, one ticker (applets of the same interval wake up
+ * together), and the samplers for `/proc` files.
+ *
+ * Usage: wlmapplets APPLET [ARGS...] [-- APPLET [ARGS...]]...
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <libbase/libbase.h>
+#include <wlclient/applet.h>
+
+#include "wlm_applets.h"
+
+/** Applets known to the host. */
+static const wlmcl_applet_t *_applets[] = {
+    &wlm_battery_applet,
+    &wlm_clock_applet,
+    &wlm_cpugraph_applet,
+    &wlm_memgraph_applet,
+    &wlm_netgraph_applet,
+    NULL
+};
+
+/* ------------------------------------------------------------------------- */
+/** Prints usage, and the names of all known applets. */
+static void _usage(const char *name_ptr)
+{
+    printf("Usage: %s APPLET [ARGS...] [-- APPLET [ARGS...]]...\n\n",
+           name_ptr);
+    printf("Runs all given applets in one process. Applets:");
+    for (const wlmcl_applet_t **a_ptr = _applets; NULL != *a_ptr; ++a_ptr) {
+        printf(" %s", (*a_ptr)->name_ptr);
+    }
+    printf("\n");
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return The applet called `name_ptr`, or NULL. */
+static const wlmcl_applet_t *_find(const char *name_ptr)
+{
+    for (const wlmcl_applet_t **a_ptr = _applets; NULL != *a_ptr; ++a_ptr) {
+        if (0 == strcmp((*a_ptr)->name_ptr, name_ptr)) return *a_ptr;
+    }
+    return NULL;
+}
+
+/* == Main program ========================================================= */
+/** Main program. */
+int main(int argc, const char **argv)
+{
+    bs_log_severity = BS_INFO;
+
+    if (2 > argc ||
+        0 == strcmp(argv[1], "--help") || 0 == strcmp(argv[1], "-h")) {
+        _usage(argv[0]);
+        return 2 > argc ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+    // Check all names before connecting.
+    for (int i = 1; i < argc; ++i) {
+        if (1 < i && 0 != strcmp(argv[i - 1], "--")) continue;
+        if (NULL == _find(argv[i])) {
+            bs_log(BS_ERROR, "Unknown applet \"%s\"", argv[i]);
+            _usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    wlmcl_applet_host_t *host_ptr = wlmcl_applet_host_create(
+        "wlmaker.wlmapplets");
+    if (NULL == host_ptr) return EXIT_FAILURE;
+
+    // Each applet gets the arguments up to the next "--", with its name as
+    // argv[0]. The terminating "--" is replaced by NULL, as in any argv.
+    bool rv = true;
+    for (int first = 1; first < argc && rv;) {
+        int last = first + 1;
+        while (last < argc && 0 != strcmp(argv[last], "--")) ++last;
+        if (last < argc) argv[last] = NULL;
+
+        rv = wlmcl_applet_host_load(
+            host_ptr, _find(argv[first]), last - first, &argv[first]);
+        first = last + 1;
+    }
+
+    if (rv) wlmcl_applet_host_run(host_ptr);
+    wlmcl_applet_host_destroy(host_ptr);
+    return rv ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* == End of wlmapplets.c ================================================== */
@@ -4,6 +4,10 @@
  *
  * Displays battery capacity from /sys/class/power_supply in a DockApp.
  *
+ * Updates when the kernel reports a change of a power supply through a
+ * uevent, and falls back to polling once a minute -- or once per second, if
+ * uevents are not available.
+ *
  * TODO(kaeser@gubbe.ch):
  * - Only update when the numbers have actually changed.
  * - Support more than one battery (eg. by clicking through?)
@@ -30,11 +34,15 @@
 #include <cairo.h>
 #include <dirent.h>
 #include <inttypes.h>
+#include <linux/netlink.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 #include <primitives/primitives.h>
 #include <wlclient/wlclient.h>
 #include <wlclient/icon.h>
@@ -42,10 +50,7 @@
 
 #include <libbase/libbase.h>
 
-/** Wayland client state. */
-static wlmcl_client_t *wlclient_ptr;
-/** Double buffer pointer. */
-static wlmcl_dblbuf_t *dblbuf_ptr;
+#include "wlm_applets.h"
 
 /* == Declarations ========================================================= */
 
@@ -53,6 +58,12 @@ static wlmcl_dblbuf_t *dblbuf_ptr;
 #define SYSFS_BATTERY_PATH_MAX_LEN 256
 /** Small buffer for reading single values (like capacity). */
 #define VAL_BUF_LEN 64
+/** Buffer for receiving one uevent message. */
+#define UEVENT_BUF_LEN 4096
+/** Polling interval, when notified about changes through uevents. */
+#define POLL_INTERVAL_UEVENT_USEC 60000000
+/** Polling interval, if uevents are not available. */
+#define POLL_INTERVAL_USEC 1000000
 
 /** Internal battery status enum. */
 enum battery_status {
@@ -143,6 +154,9 @@ static bool wlm_read_uint64(
     uint64_t *u64_ptr, const char *fmt_ptr, ...);
 static enum battery_status parse_battery_status(const char *status_str);
 
+static int wlm_uevent_open(void);
+static bool wlm_uevent_is_power_supply(const char *buf, size_t len);
+
 
 /* == Local (static) methods =============================================== */
 
@@ -550,12 +564,73 @@ static enum battery_status parse_battery_status(const char *status_str)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Argument to @ref icon_callback and @ref timer_callback. */
+/**
+ * Opens a netlink socket to receive kernel uevents.
+ *
+ * @return The non-blocking socket file descriptor, or -1 on error.
+ */
+int wlm_uevent_open(void)
+{
+    int fd = socket(AF_NETLINK, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                    NETLINK_KOBJECT_UEVENT);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed socket(AF_NETLINK, ..., "
+               "NETLINK_KOBJECT_UEVENT)");
+        return -1;
+    }
+
+    // Group 1 is the kernel's uevent multicast group.
+    struct sockaddr_nl addr = { .nl_family = AF_NETLINK, .nl_groups = 1 };
+    if (0 != bind(fd, (struct sockaddr*)&addr, sizeof(addr))) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed bind(%d, %p, %zu)",
+               fd, &addr, sizeof(addr));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Checks whether a uevent message is about a power supply.
+ *
+ * A kernel uevent message consists of a "ACTION@DEVPATH" header, followed by
+ * NUL-terminated "KEY=VALUE" pairs.
+ *
+ * @param buf
+ * @param len
+ *
+ * @return true if the message has "SUBSYSTEM=power_supply".
+ */
+bool wlm_uevent_is_power_supply(const char *buf, size_t len)
+{
+    static const char key[] = "SUBSYSTEM=power_supply";
+    for (size_t pos = 0; pos < len; pos += strnlen(buf + pos, len - pos) + 1) {
+        if (len - pos >= sizeof(key) &&
+            0 == memcmp(buf + pos, key, sizeof(key))) return true;
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Argument to @ref icon_callback and @ref tick_callback: The applet. */
 struct callback_arg {
+    /** Host of the applet. */
+    wlmcl_applet_host_t    *host_ptr;
     /** The icon handle */
     wlmcl_icon_t           *icon_ptr;
+    /** Double buffer pointer. */
+    wlmcl_dblbuf_t         *dblbuf_ptr;
     /** Power supply handle */
     struct wlm_power_supply   *ps;
+    /** Polling interval, in usec. */
+    uint64_t               poll_interval_usec;
+    /** Polls the power supply, every `poll_interval_usec`. */
+    wlmcl_tick_t           *tick_ptr;
+    /** Netlink socket for uevents, or -1. */
+    int                    uevent_fd;
+    /** Watch on `uevent_fd`. */
+    wlmcl_fd_watch_t       *uevent_watch_ptr;
 };
 
 /* ------------------------------------------------------------------------- */
@@ -565,7 +640,7 @@ struct callback_arg {
  * @param gfxbuf_ptr
  * @param ud_ptr
  */
-bool icon_callback(
+static bool icon_callback(
     bs_gfxbuf_t *gfxbuf_ptr,
     void *ud_ptr)
 {
@@ -657,18 +732,34 @@ bool icon_callback(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Called once per second. */
-void timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr)
+/** Called once per polling interval. */
+static void tick_callback(__UNUSED__ uint64_t now_usec, void *ud_ptr)
+{
+    struct callback_arg *arg_ptr = ud_ptr;
+
+    if (NULL != arg_ptr->dblbuf_ptr) {
+        wlmcl_dblbuf_register_ready_callback(
+            arg_ptr->dblbuf_ptr, icon_callback, arg_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Called when the uevent socket is readable. Redraws on power supply events. */
+static void uevent_callback(int fd, __UNUSED__ uint32_t events, void *ud_ptr)
 {
     struct callback_arg *arg_ptr = ud_ptr;
+    char buf[UEVENT_BUF_LEN];
+    bool changed = false;
+
+    ssize_t len;
+    while (0 < (len = recv(fd, buf, sizeof(buf), 0))) {
+        if (wlm_uevent_is_power_supply(buf, len)) changed = true;
+    }
 
-    if (NULL != dblbuf_ptr) {
+    if (changed && NULL != arg_ptr->dblbuf_ptr) {
         wlmcl_dblbuf_register_ready_callback(
-            dblbuf_ptr, icon_callback, arg_ptr);
+            arg_ptr->dblbuf_ptr, icon_callback, arg_ptr);
     }
-    wlmcl_client_register_timer(
-        client_ptr, bs_usec() + 1000000, timer_callback,
-        arg_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -676,62 +767,130 @@ void timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr)
 static void _handle_configure(void *ud_ptr, uint32_t width, uint32_t height)
 {
     struct callback_arg *arg_ptr = ud_ptr;
-    if (NULL != dblbuf_ptr) {
-        wlmcl_dblbuf_destroy(dblbuf_ptr);
-    }
-    dblbuf_ptr = wlmcl_dblbuf_create(
-        wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
-        wlmcl_icon_wl_surface(arg_ptr->icon_ptr),
-        wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
-        width,
-        height);
-    if (NULL == dblbuf_ptr) {
-        bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
-        return;
-    }
-    wlmcl_dblbuf_register_ready_callback(dblbuf_ptr, icon_callback, arg_ptr);
+    if (NULL != arg_ptr->dblbuf_ptr &&
+        !wlmcl_dblbuf_resize(arg_ptr->dblbuf_ptr, width, height)) {
+        wlmcl_dblbuf_destroy(arg_ptr->dblbuf_ptr);
+        arg_ptr->dblbuf_ptr = NULL;
+    }
+    if (NULL == arg_ptr->dblbuf_ptr) {
+        wlmcl_client_t *wlclient_ptr = wlmcl_applet_host_client(
+            arg_ptr->host_ptr);
+        arg_ptr->dblbuf_ptr = wlmcl_dblbuf_create(
+            wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
+            wlmcl_icon_wl_surface(arg_ptr->icon_ptr),
+            wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
+            width,
+            height);
+        if (NULL == arg_ptr->dblbuf_ptr) {
+            bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
+            return;
+        }
+    }
+    wlmcl_dblbuf_register_ready_callback(
+        arg_ptr->dblbuf_ptr, icon_callback, arg_ptr);
 }
 
-/* == Main program ========================================================= */
-/** @return `EXIT_SUCCESS` on success. */
-int main(void)
+/* == Applet =============================================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the applet. See @ref wlmcl_applet_t::destroy. */
+static void _applet_destroy(void *state_ptr)
 {
-    struct wlm_power_supply *ps = wlm_power_supply_create();
-    if (!ps) {
-        return EXIT_FAILURE;
+    struct callback_arg *arg_ptr = state_ptr;
+
+    if (NULL != arg_ptr->tick_ptr) {
+        wlmcl_applet_host_remove_tick(arg_ptr->host_ptr, arg_ptr->tick_ptr);
+        arg_ptr->tick_ptr = NULL;
     }
+    if (NULL != arg_ptr->uevent_watch_ptr) {
+        wlmcl_client_unregister_fd(
+            wlmcl_applet_host_client(arg_ptr->host_ptr),
+            arg_ptr->uevent_watch_ptr);
+        arg_ptr->uevent_watch_ptr = NULL;
+    }
+    if (0 <= arg_ptr->uevent_fd) {
+        close(arg_ptr->uevent_fd);
+        arg_ptr->uevent_fd = -1;
+    }
+    if (NULL != arg_ptr->icon_ptr) {
+        wlmcl_icon_destroy(arg_ptr->icon_ptr);
+        arg_ptr->icon_ptr = NULL;
+    }
+    if (NULL != arg_ptr->dblbuf_ptr) {
+        wlmcl_dblbuf_destroy(arg_ptr->dblbuf_ptr);
+        arg_ptr->dblbuf_ptr = NULL;
+    }
+    if (NULL != arg_ptr->ps) {
+        wlm_power_supply_destroy(arg_ptr->ps);
+        arg_ptr->ps = NULL;
+    }
+    free(arg_ptr);
+}
 
-    wlclient_ptr = wlmcl_client_create("wlmaker.wlmbattery");
-    if (NULL == wlclient_ptr) {
-        wlm_power_supply_destroy(ps);
-        return EXIT_FAILURE;
+/* ------------------------------------------------------------------------- */
+/** Creates the applet. See @ref wlmcl_applet_t::create. */
+static void *_applet_create(
+    wlmcl_applet_host_t *host_ptr,
+    __UNUSED__ int argc,
+    __UNUSED__ const char **argv)
+{
+    struct callback_arg *arg_ptr = logged_calloc(
+        1, sizeof(struct callback_arg));
+    if (NULL == arg_ptr) return NULL;
+    arg_ptr->host_ptr = host_ptr;
+    arg_ptr->uevent_fd = -1;
+    arg_ptr->poll_interval_usec = POLL_INTERVAL_USEC;
+
+    wlmcl_client_t *wlclient_ptr = wlmcl_applet_host_client(host_ptr);
+    arg_ptr->ps = wlm_power_supply_create();
+    if (NULL == arg_ptr->ps) {
+        _applet_destroy(arg_ptr);
+        return NULL;
     }
 
-    if (wlmcl_icon_supported(wlclient_ptr)) {
-        wlmcl_icon_t *icon_ptr = wlmcl_icon_create(wlclient_ptr);
-        struct callback_arg arg = { .ps = ps, .icon_ptr = icon_ptr };
-        if (NULL == icon_ptr) {
-            bs_log(BS_ERROR, "Failed wlmcl_icon_create(%p)", wlclient_ptr);
-        } else {
-            wlmcl_icon_register_configure_callback(
-                icon_ptr, _handle_configure, &arg);
-            wlmcl_client_register_timer(
-                wlclient_ptr, bs_usec() + 1000000, timer_callback, &arg);
-
-            wlmcl_client_run(wlclient_ptr);
-            wlmcl_icon_destroy(icon_ptr);
-            if (NULL != dblbuf_ptr) {
-                wlmcl_dblbuf_destroy(dblbuf_ptr);
-                dblbuf_ptr = NULL;
-            }
+    arg_ptr->icon_ptr = wlmcl_icon_create(wlclient_ptr);
+    if (NULL == arg_ptr->icon_ptr) {
+        bs_log(BS_ERROR, "Failed wlmcl_icon_create(%p)", wlclient_ptr);
+        _applet_destroy(arg_ptr);
+        return NULL;
+    }
+    wlmcl_icon_register_configure_callback(
+        arg_ptr->icon_ptr, _handle_configure, arg_ptr);
+
+    arg_ptr->uevent_fd = wlm_uevent_open();
+    if (0 <= arg_ptr->uevent_fd) {
+        arg_ptr->uevent_watch_ptr = wlmcl_client_register_fd(
+            wlclient_ptr, arg_ptr->uevent_fd, EPOLLIN, uevent_callback,
+            arg_ptr);
+        if (NULL != arg_ptr->uevent_watch_ptr) {
+            arg_ptr->poll_interval_usec = POLL_INTERVAL_UEVENT_USEC;
         }
-    } else {
-        bs_log(BS_ERROR, "icon protocol is not supported.");
     }
 
-    wlmcl_client_destroy(wlclient_ptr);
+    arg_ptr->tick_ptr = wlmcl_applet_host_add_tick(
+        host_ptr, arg_ptr->poll_interval_usec, tick_callback, arg_ptr);
+    if (NULL == arg_ptr->tick_ptr) {
+        _applet_destroy(arg_ptr);
+        return NULL;
+    }
+    return arg_ptr;
+}
+
+const wlmcl_applet_t wlm_battery_applet = {
+    .name_ptr = "battery",
+    .create = _applet_create,
+    .destroy = _applet_destroy,
+};
+
+/* == Main program ========================================================= */
 
-    wlm_power_supply_destroy(ps);
-    return EXIT_SUCCESS;
+#if !defined(WLM_APPLETS_HOST)
+/** @return `EXIT_SUCCESS` on success. */
+int main(int argc, const char **argv)
+{
+    return wlmcl_applet_main(
+        "wlmaker.wlmbattery", &wlm_battery_applet, argc, argv);
 }
+#endif  // !defined(WLM_APPLETS_HOST)
+
 /* == End of wlmbattery.c ================================================== */
@@ -37,11 +37,7 @@
 
 #include "wlclient/icon.h"
 #include "wlclient/dblbuf.h"
-
-/** State of the client. */
-static wlmcl_client_t *wlclient_ptr;
-/** Double buffer. */
-static wlmcl_dblbuf_t *dblbuf_ptr;
+#include "wlm_applets.h"
 
 /** Foreground color of a LED in the VFD-style display. */
 static const uint32_t color_led = 0xff55ffff;
@@ -50,72 +46,73 @@ static const uint32_t color_off = 0xff114444;
 /** Background color in the VFD-style display. */
 static const uint32_t color_background = 0xff111111;
 
+/** Frames of digits to remember, for buffers of age up to this. */
+#define DIGITS_HISTORY 4
+
+/** State of a clock. */
+typedef struct {
+    /** Host of the applet. */
+    wlmcl_applet_host_t       *host_ptr;
+    /** The icon. */
+    wlmcl_icon_t              *icon_ptr;
+    /** Double buffer. */
+    wlmcl_dblbuf_t            *dblbuf_ptr;
+    /** Redraws the clock, at every full second. */
+    wlmcl_tick_t              *tick_ptr;
+    /** Static parts of the icon, at `static_layer_width`. */
+    cairo_surface_t           *static_layer_ptr;
+    /** Width (and height) of `static_layer_ptr`. */
+    unsigned                  static_layer_width;
+    /** Pre-rendered digits. */
+    wlm_cairo_7segment_atlas_t *atlas_ptr;
+    /** Digits ("HHMMSS") of the most recent frames. */
+    char                      digits_history[DIGITS_HISTORY][6];
+    /** Frames drawn at `static_layer_width`. */
+    uint64_t                  frames;
+} wlmclock_t;
+
+/* ------------------------------------------------------------------------- */
+/** Returns the X coordinate of the lower left corner of digit `i`. */
+static int digit_x(unsigned width, int i)
+{
+    return width / 2 - 26 + i * 8 + (i / 2) * 2;
+}
+
 /* ------------------------------------------------------------------------- */
-/** Returns the next full second for when to draw the clock. */
-uint64_t next_draw_time(void)
+/** Returns the height of the clock face, including its bezel. */
+static int face_height(unsigned width)
 {
-    return (bs_usec() / 1000000 + 1) * 1000000;
+    return ceil(40.0 * width / 56.0);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Draws contents into the icon buffer.
+ * Draws everything that does not change by the second into a new surface:
+ * The digits' bar with its bezel and dots, and the face with its ticks.
  *
- * @param gfxbuf_ptr
- * @param ud_ptr
+ * @param width
+ *
+ * @return The image surface, or NULL on error.
  */
-bool icon_callback(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    __UNUSED__ void *ud_ptr)
+static cairo_surface_t *create_static_layer(unsigned width)
 {
-    bs_gfxbuf_clear(gfxbuf_ptr, 0);
-
-    if (gfxbuf_ptr->width != gfxbuf_ptr->height) {
-        bs_log(BS_ERROR, "Requiring a square buffer, width %u != height %u",
-               gfxbuf_ptr->width, gfxbuf_ptr->height);
-        return false;
-    }
-
-    unsigned width = gfxbuf_ptr->width;
-
-    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_log(BS_ERROR, "Failed cairo_create_from_bs_gfxbuf(%p)", gfxbuf_ptr);
-        return false;
+    cairo_surface_t *surface_ptr = cairo_image_surface_create(
+        CAIRO_FORMAT_ARGB32, width, width);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(surface_ptr)) {
+        bs_log(BS_ERROR, "Failed cairo_image_surface_create(%u, %u)",
+               width, width);
+        cairo_surface_destroy(surface_ptr);
+        return NULL;
     }
+    cairo_t *cairo_ptr = cairo_create(surface_ptr);
 
-    float r, g, b, alpha;
-    bs_gfxbuf_argb8888_to_floats(color_background, &r, &g, &b, &alpha);
-    cairo_pattern_t *pattern_ptr = cairo_pattern_create_rgba(r, g, b, alpha);
-    BS_ASSERT(NULL != pattern_ptr);
-    cairo_set_source(cairo_ptr, pattern_ptr);
-    cairo_pattern_destroy(pattern_ptr);
+    cairo_set_source_argb8888(cairo_ptr, color_background);
     cairo_rectangle(
         cairo_ptr, 1, width - 14, width - 2, 14);
     cairo_fill(cairo_ptr);
     wlm_primitives_draw_bezel_at(
         cairo_ptr, 0, width - 15, width, 15, 1.0, false);
 
-    struct timeval tv;
-    if (0 != gettimeofday(&tv, NULL)) {
-        memset(&tv, 0, sizeof(tv));
-    }
-    struct tm *tm_ptr = localtime(&tv.tv_sec);
-    char time_buf[7];
-    snprintf(time_buf, sizeof(time_buf), "%02d%02d%02d",
-             tm_ptr->tm_hour, tm_ptr->tm_min, tm_ptr->tm_sec);
-
-    for (int i = 0; i < 6; ++i) {
-        wlm_cairo_7segment_display_digit(
-            cairo_ptr,
-            &wlm_cairo_7segment_param_8x12,
-            width / 2 - 26 + i * 8 + (i / 2) * 2,
-            width - 2,
-            color_led,
-            color_off,
-            time_buf[i] - '0');
-    }
-
     // The dots between "HH:MM:SS"
     cairo_set_source_argb8888(cairo_ptr, color_led);
     cairo_rectangle(cairo_ptr, width / 2 - 10, width - 10, 1, 1.25);
@@ -156,6 +153,21 @@ bool icon_callback(
         cairo_stroke(cairo_ptr);
     }
 
+    cairo_destroy(cairo_ptr);
+    cairo_surface_flush(surface_ptr);
+    return surface_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Draws the hours, minutes and seconds pointers onto the face. */
+static void draw_pointers(cairo_t *cairo_ptr, unsigned width, struct tm *tm_ptr)
+{
+    double center_x = 27.5 * width / 56.0;
+    double center_y = 19.5 * width / 56.0;
+    double radius = 18 * width / 56.0;
+
+    cairo_set_source_argb8888(cairo_ptr, color_led);
+
     // Seconds pointer.
     double angle = tm_ptr->tm_sec * 2*M_PI / 60.0;
     cairo_set_line_width(cairo_ptr, 0.5);
@@ -184,78 +196,232 @@ bool icon_callback(
                   center_x + 0.5 * radius * sin(angle),
                   center_y - 0.5 * radius * cos(angle));
     cairo_stroke(cairo_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws contents into the icon buffer.
+ *
+ * The static parts come from @ref wlmclock_t::static_layer_ptr, and the
+ * digits from @ref wlmclock_t::atlas_ptr. If the buffer holds a recent frame,
+ * only the face and the digits that differ are repainted, and only what
+ * changed since the previous frame is damaged.
+ *
+ * @param gfxbuf_ptr
+ * @param ud_ptr              The @ref wlmclock_t.
+ */
+static bool icon_callback(bs_gfxbuf_t *gfxbuf_ptr, void *ud_ptr)
+{
+    wlmclock_t *clock_ptr = ud_ptr;
+    if (gfxbuf_ptr->width != gfxbuf_ptr->height) {
+        bs_log(BS_ERROR, "Requiring a square buffer, width %u != height %u",
+               gfxbuf_ptr->width, gfxbuf_ptr->height);
+        return false;
+    }
+
+    unsigned width = gfxbuf_ptr->width;
+
+    if (NULL != clock_ptr->static_layer_ptr &&
+        clock_ptr->static_layer_width != width) {
+        cairo_surface_destroy(clock_ptr->static_layer_ptr);
+        clock_ptr->static_layer_ptr = NULL;
+    }
+    if (NULL == clock_ptr->static_layer_ptr) {
+        clock_ptr->static_layer_ptr = create_static_layer(width);
+        if (NULL == clock_ptr->static_layer_ptr) return false;
+        clock_ptr->static_layer_width = width;
+        clock_ptr->frames = 0;
+    }
+    if (NULL == clock_ptr->atlas_ptr) {
+        clock_ptr->atlas_ptr = wlm_cairo_7segment_atlas_create(
+            &wlm_cairo_7segment_param_8x12,
+            color_led, color_off, color_background);
+        if (NULL == clock_ptr->atlas_ptr) return false;
+    }
+
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    if (NULL == cairo_ptr) {
+        bs_log(BS_ERROR, "Failed cairo_create_from_bs_gfxbuf(%p)", gfxbuf_ptr);
+        return false;
+    }
+
+    struct timeval tv;
+    if (0 != gettimeofday(&tv, NULL)) {
+        memset(&tv, 0, sizeof(tv));
+    }
+    struct tm *tm_ptr = localtime(&tv.tv_sec);
+    char time_buf[7];
+    snprintf(time_buf, sizeof(time_buf), "%02d%02d%02d",
+             tm_ptr->tm_hour, tm_ptr->tm_min, tm_ptr->tm_sec);
+
+    // Digits the buffer holds, or NULL if its contents are unknown.
+    const char *held_ptr = NULL;
+    uint64_t frames = clock_ptr->frames;
+    unsigned age = wlmcl_dblbuf_age(clock_ptr->dblbuf_ptr);
+    if (0 < age && age <= frames && age <= DIGITS_HISTORY) {
+        held_ptr = clock_ptr->digits_history[(frames - age) % DIGITS_HISTORY];
+    }
+
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source_surface(cairo_ptr, clock_ptr->static_layer_ptr, 0, 0);
+    if (NULL != held_ptr) {
+        cairo_rectangle(cairo_ptr, 0, 0, width, face_height(width));
+        cairo_fill(cairo_ptr);
+    } else {
+        cairo_paint(cairo_ptr);
+    }
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_OVER);
+
+    for (int i = 0; i < 6; ++i) {
+        if (NULL != held_ptr && held_ptr[i] == time_buf[i]) continue;
+        wlm_cairo_7segment_atlas_blit(
+            cairo_ptr, clock_ptr->atlas_ptr, digit_x(width, i), width - 2,
+            time_buf[i] - '0');
+    }
 
+    draw_pointers(cairo_ptr, width, tm_ptr);
     cairo_destroy(cairo_ptr);
 
+    // Without any damage reported, the double buffer damages everything.
+    if (0 < frames) {
+        const char *prev_ptr =
+            clock_ptr->digits_history[(frames - 1) % DIGITS_HISTORY];
+        unsigned cell_width, cell_height;
+        wlm_cairo_7segment_atlas_cell_size(
+            clock_ptr->atlas_ptr, &cell_width, &cell_height);
+        wlmcl_dblbuf_damage(
+            clock_ptr->dblbuf_ptr, 0, 0, width, face_height(width));
+        for (int i = 0; i < 6; ++i) {
+            if (prev_ptr[i] == time_buf[i]) continue;
+            wlmcl_dblbuf_damage(
+                clock_ptr->dblbuf_ptr, digit_x(width, i),
+                width - 2 - cell_height, cell_width, cell_height);
+        }
+    }
+    memcpy(clock_ptr->digits_history[frames % DIGITS_HISTORY], time_buf, 6);
+    ++clock_ptr->frames;
+
     return true;
 }
 
 /* ------------------------------------------------------------------------- */
 /** Called once per second. */
-void timer_callback(wlmcl_client_t *client_ptr, void *ud_ptr)
+static void tick_callback(__UNUSED__ uint64_t now_usec, void *ud_ptr)
 {
-    wlmcl_icon_t *icon_ptr = ud_ptr;
+    wlmclock_t *clock_ptr = ud_ptr;
 
-    if (NULL != dblbuf_ptr) {
-        wlmcl_dblbuf_register_ready_callback(dblbuf_ptr, icon_callback, NULL);
+    if (NULL != clock_ptr->dblbuf_ptr) {
+        wlmcl_dblbuf_register_ready_callback(
+            clock_ptr->dblbuf_ptr, icon_callback, clock_ptr);
     }
-    wlmcl_client_register_timer(
-        client_ptr, next_draw_time(), timer_callback, icon_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 /** Handles configure events. */
 static void _handle_configure(void *ud_ptr, uint32_t width, uint32_t height)
 {
-    wlmcl_icon_t *icon_ptr = ud_ptr;
-    if (NULL != dblbuf_ptr) {
-        wlmcl_dblbuf_destroy(dblbuf_ptr);
+    wlmclock_t *clock_ptr = ud_ptr;
+    if (NULL != clock_ptr->dblbuf_ptr &&
+        !wlmcl_dblbuf_resize(clock_ptr->dblbuf_ptr, width, height)) {
+        wlmcl_dblbuf_destroy(clock_ptr->dblbuf_ptr);
+        clock_ptr->dblbuf_ptr = NULL;
     }
-    dblbuf_ptr = wlmcl_dblbuf_create(
-        wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
-        wlmcl_icon_wl_surface(icon_ptr),
-        wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
-        width,
-        height);
-    if (NULL == dblbuf_ptr) {
-        bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
-        return;
+    if (NULL == clock_ptr->dblbuf_ptr) {
+        wlmcl_client_t *wlclient_ptr = wlmcl_applet_host_client(
+            clock_ptr->host_ptr);
+        clock_ptr->dblbuf_ptr = wlmcl_dblbuf_create(
+            wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
+            wlmcl_icon_wl_surface(clock_ptr->icon_ptr),
+            wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
+            width,
+            height);
+        if (NULL == clock_ptr->dblbuf_ptr) {
+            bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create.");
+            return;
+        }
     }
-    wlmcl_dblbuf_register_ready_callback(dblbuf_ptr, icon_callback, NULL);
+    wlmcl_dblbuf_register_ready_callback(
+        clock_ptr->dblbuf_ptr, icon_callback, clock_ptr);
 }
 
-/* == Main program ========================================================= */
-/** Main program. */
-int main(__UNUSED__ int argc, __UNUSED__ char **argv)
+/* == Applet =============================================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the clock. See @ref wlmcl_applet_t::destroy. */
+static void _applet_destroy(void *state_ptr)
 {
-    bs_log_severity = BS_DEBUG;
+    wlmclock_t *clock_ptr = state_ptr;
 
-    wlclient_ptr = wlmcl_client_create("wlmaker.wlmeyes");
-    if (NULL == wlclient_ptr) return EXIT_FAILURE;
+    if (NULL != clock_ptr->tick_ptr) {
+        wlmcl_applet_host_remove_tick(clock_ptr->host_ptr, clock_ptr->tick_ptr);
+        clock_ptr->tick_ptr = NULL;
+    }
+    if (NULL != clock_ptr->icon_ptr) {
+        wlmcl_icon_destroy(clock_ptr->icon_ptr);
+        clock_ptr->icon_ptr = NULL;
+    }
+    if (NULL != clock_ptr->dblbuf_ptr) {
+        wlmcl_dblbuf_destroy(clock_ptr->dblbuf_ptr);
+        clock_ptr->dblbuf_ptr = NULL;
+    }
+    if (NULL != clock_ptr->atlas_ptr) {
+        wlm_cairo_7segment_atlas_destroy(clock_ptr->atlas_ptr);
+        clock_ptr->atlas_ptr = NULL;
+    }
+    if (NULL != clock_ptr->static_layer_ptr) {
+        cairo_surface_destroy(clock_ptr->static_layer_ptr);
+        clock_ptr->static_layer_ptr = NULL;
+    }
+    free(clock_ptr);
+}
 
-    if (wlmcl_icon_supported(wlclient_ptr)) {
-        wlmcl_icon_t *icon_ptr = wlmcl_icon_create(wlclient_ptr);
-        if (NULL == icon_ptr) {
-            bs_log(BS_ERROR, "Failed wlmcl_icon_create(%p)", wlclient_ptr);
-        } else {
-            wlmcl_icon_register_configure_callback(
-                icon_ptr, _handle_configure, icon_ptr);
-
-            wlmcl_client_register_timer(
-                wlclient_ptr, next_draw_time(), timer_callback, icon_ptr);
-
-            wlmcl_client_run(wlclient_ptr);
-            wlmcl_icon_destroy(icon_ptr);
-            if (NULL != dblbuf_ptr) {
-                wlmcl_dblbuf_destroy(dblbuf_ptr);
-                dblbuf_ptr = NULL;
-            }
-        }
-    } else {
-        bs_log(BS_ERROR, "icon protocol is not supported.");
+/* ------------------------------------------------------------------------- */
+/** Creates a clock. See @ref wlmcl_applet_t::create. */
+static void *_applet_create(
+    wlmcl_applet_host_t *host_ptr,
+    __UNUSED__ int argc,
+    __UNUSED__ const char **argv)
+{
+    wlmclock_t *clock_ptr = logged_calloc(1, sizeof(wlmclock_t));
+    if (NULL == clock_ptr) return NULL;
+    clock_ptr->host_ptr = host_ptr;
+
+    clock_ptr->icon_ptr = wlmcl_icon_create(
+        wlmcl_applet_host_client(host_ptr));
+    if (NULL == clock_ptr->icon_ptr) {
+        bs_log(BS_ERROR, "Failed wlmcl_icon_create(%p)",
+               wlmcl_applet_host_client(host_ptr));
+        _applet_destroy(clock_ptr);
+        return NULL;
     }
+    wlmcl_icon_register_configure_callback(
+        clock_ptr->icon_ptr, _handle_configure, clock_ptr);
 
-    wlmcl_client_destroy(wlclient_ptr);
-    return EXIT_SUCCESS;
+    clock_ptr->tick_ptr = wlmcl_applet_host_add_tick(
+        host_ptr, 1000000, tick_callback, clock_ptr);
+    if (NULL == clock_ptr->tick_ptr) {
+        _applet_destroy(clock_ptr);
+        return NULL;
+    }
+    return clock_ptr;
 }
+
+const wlmcl_applet_t wlm_clock_applet = {
+    .name_ptr = "clock",
+    .create = _applet_create,
+    .destroy = _applet_destroy,
+};
+
+/* == Main program ========================================================= */
+
+#if !defined(WLM_APPLETS_HOST)
+/** Main program. */
+int main(int argc, const char **argv)
+{
+    bs_log_severity = BS_DEBUG;
+    return wlmcl_applet_main(
+        "wlmaker.wlmeyes", &wlm_clock_applet, argc, argv);
+}
+#endif  // !defined(WLM_APPLETS_HOST)
+
 /* == End of wlmclock.c ==================================================== */
@@ -21,12 +21,12 @@
  * limitations under the License.
  */
 
+#include "wlm_applets.h"
 #include "wlm_graph_shared.h"
+#include "wlm_sampler.h"
 
-#include <ctype.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -47,31 +47,17 @@ static const char _app_help[] =
     "  - 3/4 cores active (yellow)\n"
     "  - All cores active (red)";
 
-/** Line buffer size for /proc/stat parsing. */
-#define LINE_BUFFER_SIZE 256
-
 /* == Definitions ========================================================== */
 
-/**
- * Absolute CPU time values from `/proc/stat`.
- *
- * Uses unsigned long to match `/proc/stat` format and avoid overflow
- * on systems with high uptime.
- */
-typedef struct {
-    /** Sum of all CPU time fields. */
-    unsigned long total;
-    /** Idle time (idle + iowait). */
-    unsigned long idle;
-} cpu_times_t;
-
 /** State for the CPU graph (mutable runtime data). */
 typedef struct {
-    /** Open file handle to /proc/stat. */
-    FILE *proc_fp;
+    /** Sampler for /proc/stat. */
+    wlm_sampler_t *sampler_ptr;
     /** Previous absolute CPU values for computing usage (dynamically allocated). */
-    cpu_times_t *cpu_times_prev;
-    /** Number of elements in cpu_times_prev. */
+    wlm_sampler_cpu_times_t *cpu_times_prev;
+    /** Current absolute CPU values, as parsed (dynamically allocated). */
+    wlm_sampler_cpu_times_t *cpu_times_curr;
+    /** Number of elements in cpu_times_prev and cpu_times_curr. */
     uint32_t cpu_usage_num;
 } cpugraph_state_t;
 
@@ -91,10 +77,13 @@ static bool _cpu_state_arrays_alloc(cpugraph_state_t *state, const uint32_t cpu_
     // Free old allocation.
     free(state->cpu_times_prev);
     state->cpu_times_prev = NULL;
+    free(state->cpu_times_curr);
+    state->cpu_times_curr = NULL;
     state->cpu_usage_num = 0;
 
-    state->cpu_times_prev = calloc(cpu_usage_num, sizeof(cpu_times_t));
-    if (NULL == state->cpu_times_prev) {
+    state->cpu_times_prev = calloc(cpu_usage_num, sizeof(wlm_sampler_cpu_times_t));
+    state->cpu_times_curr = calloc(cpu_usage_num, sizeof(wlm_sampler_cpu_times_t));
+    if (NULL == state->cpu_times_prev || NULL == state->cpu_times_curr) {
         return false;
     }
 
@@ -108,13 +97,15 @@ static void _state_free(void *app_state)
 {
     cpugraph_state_t *state = app_state;
 
-    if (NULL != state->proc_fp) {
-        fclose(state->proc_fp);
-        state->proc_fp = NULL;
+    if (NULL != state->sampler_ptr) {
+        wlm_sampler_release(state->sampler_ptr);
+        state->sampler_ptr = NULL;
     }
 
     free(state->cpu_times_prev);
     state->cpu_times_prev = NULL;
+    free(state->cpu_times_curr);
+    state->cpu_times_curr = NULL;
     state->cpu_usage_num = 0;
 }
 
@@ -124,8 +115,9 @@ static void _state_free(void *app_state)
 /**
  * Reads CPU statistics from /proc/stat.
  *
- * Uses the pre-opened file handle, counts CPUs, reallocates the buffer if
- * needed, and fills it with per-CPU usage values.
+ * Reads /proc/stat through the sampler, and parses it in a single pass. If
+ * the number of CPUs changed, the state arrays are reallocated and the same
+ * contents are parsed once more.
  *
  * @param app_state     App state (cpugraph_state_t pointer).
  * @param values        Buffer to fill (may reallocate data/num).
@@ -135,29 +127,33 @@ static void _state_free(void *app_state)
 static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_t *values)
 {
     cpugraph_state_t * const state = app_state;
-    FILE * const fp = state->proc_fp;
 
-    if (NULL == fp) {
+    if (NULL == state->sampler_ptr) {
         return WLM_GRAPH_READ_ERROR;
     }
 
-    rewind(fp);
-
-    char line[LINE_BUFFER_SIZE];
-    uint32_t cpu_count = 0;
-
-    // First pass: count CPUs.
-    while (NULL != fgets(line, sizeof(line), fp)) {
-        if (0 != strncmp(line, "cpu", 3)) continue;
-        if (isdigit(line[3])) {
-            cpu_count++;
-        }
+    size_t len;
+    const char *data = wlm_sampler_read(state->sampler_ptr, &len);
+    if (NULL == data) {
+        return WLM_GRAPH_READ_ERROR;
     }
 
-    if (0 == cpu_count) {
+    size_t cpu_count = wlm_sampler_parse_stat(
+        data, len, state->cpu_times_curr, state->cpu_usage_num);
+    if (0 == cpu_count || UINT32_MAX < cpu_count) {
         return WLM_GRAPH_READ_ERROR;
     }
 
+    // Reallocate internal state arrays if CPU count changed, and re-parse
+    // the contents we already have. Happens only on CPU hotplug.
+    if (cpu_count != state->cpu_usage_num) {
+        if (!_cpu_state_arrays_alloc(state, (uint32_t)cpu_count)) {
+            return WLM_GRAPH_READ_ERROR;
+        }
+        wlm_sampler_parse_stat(
+            data, len, state->cpu_times_curr, state->cpu_usage_num);
+    }
+
     // Reallocate buffer if size doesn't match.
     if (cpu_count != values->num) {
         uint8_t *new_buf = realloc(values->data, cpu_count);
@@ -165,87 +161,112 @@ static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_
             return WLM_GRAPH_READ_ERROR;
         }
         values->data = new_buf;
-        values->num = cpu_count;
+        values->num = (uint32_t)cpu_count;
     }
 
-    // Reallocate internal state arrays if CPU count changed.
-    if (cpu_count != state->cpu_usage_num) {
-        if (!_cpu_state_arrays_alloc(state, cpu_count)) {
-            return WLM_GRAPH_READ_ERROR;
+    // Compute usage from previous absolute values.
+    for (uint32_t i = 0; i < cpu_count; i++) {
+        const wlm_sampler_cpu_times_t * const curr = &state->cpu_times_curr[i];
+        const wlm_sampler_cpu_times_t * const prev = &state->cpu_times_prev[i];
+        uint8_t usage = 0;
+
+        // Compute usage percentage, handling wraparound as zero.
+        // Skip if prev is uninitialized (zero) after CPU hotplug realloc.
+        if (0 != prev->total &&
+            curr->total > prev->total && curr->idle >= prev->idle) {
+            const uint64_t total_diff = curr->total - prev->total;
+            const uint64_t idle_diff = BS_MIN(curr->idle - prev->idle, total_diff);
+            usage = (uint8_t)(((total_diff - idle_diff) * 255) / total_diff);
         }
+        values->data[i] = usage;
     }
 
-    // Rewind and read stats, computing usage from previous absolute values.
-    rewind(fp);
-    uint32_t read_count = 0;
-    while (NULL != fgets(line, sizeof(line), fp) && read_count < cpu_count) {
-        // Skip the aggregate "cpu" line, look for "cpu0", "cpu1", etc.
-        if (0 != strncmp(line, "cpu", 3)) continue;
-        if (!isdigit(line[3])) continue;
-
-        unsigned long user, nice, system, idle, iowait, irq, softirq;
-        const int fields_parsed = sscanf(
-            line, "%*s %lu %lu %lu %lu %lu %lu %lu",
-            &user, &nice, &system, &idle, &iowait, &irq, &softirq);
-        if (7 == fields_parsed) {
-            const unsigned long abs_total = user + nice + system + idle + iowait + irq + softirq;
-            const unsigned long abs_idle = idle + iowait;
-
-            cpu_times_t * const prev = &state->cpu_times_prev[read_count];
-            uint8_t usage = 0;
-
-            // Compute usage percentage, handling wraparound as zero.
-            // Skip if prev is uninitialized (zero) after CPU hotplug realloc.
-            if (0 != prev->total &&
-                abs_total > prev->total && abs_idle >= prev->idle) {
-                const unsigned long total_diff = abs_total - prev->total;
-                const unsigned long idle_diff = BS_MIN(abs_idle - prev->idle, total_diff);
-                usage = (uint8_t)(((total_diff - idle_diff) * 255) / total_diff);
-            }
-
-            values->data[read_count] = usage;
-
-            // Update previous absolute values for next iteration.
-            prev->total = abs_total;
-            prev->idle = abs_idle;
-
-            read_count++;
-        }
-    }
+    // Current absolute values become the previous ones for next iteration.
+    wlm_sampler_cpu_times_t *tmp = state->cpu_times_prev;
+    state->cpu_times_prev = state->cpu_times_curr;
+    state->cpu_times_curr = tmp;
 
-    return (read_count == cpu_count) ? WLM_GRAPH_READ_OK : WLM_GRAPH_READ_ERROR;
+    return WLM_GRAPH_READ_OK;
 }
 
-/* == Main program ========================================================= */
+/* == Applet =============================================================== */
 
-/** Main program. */
-int main(const int argc, const char **argv)
-{
-    cpugraph_state_t state = {};
+/** Configuration, without the state. */
+static const wlm_graph_app_config_t _config = {
+    .app_name = _app_name,
+    .app_help = _app_help,
+    .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_INDEPENDENT,
+    .stats_read_fn = _stats_read_fn,
+    .state_free_fn = _state_free,
+};
+
+/** The applet: The graph, and the state it samples. */
+typedef struct {
+    /** The graph. */
+    wlm_graph_t *graph_ptr;
+    /** State for sampling. */
+    cpugraph_state_t state;
+} cpugraph_applet_t;
 
-    state.proc_fp = fopen("/proc/stat", "r");
-    if (NULL == state.proc_fp) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed to open /proc/stat");
-        return EXIT_FAILURE;
+/* ------------------------------------------------------------------------- */
+/** Creates the applet. See @ref wlmcl_applet_t::create. */
+static void *_applet_create(
+    wlmcl_applet_host_t *host_ptr,
+    int argc,
+    const char **argv)
+{
+    cpugraph_applet_t *applet_ptr = logged_calloc(1, sizeof(cpugraph_applet_t));
+    if (NULL == applet_ptr) return NULL;
+    cpugraph_state_t *state = &applet_ptr->state;
+
+    state->sampler_ptr = wlm_sampler_acquire("/proc/stat");
+    if (NULL == state->sampler_ptr) {
+        bs_log(BS_ERROR, "Failed to open /proc/stat");
+        free(applet_ptr);
+        return NULL;
     }
 
     // Prime prev values so first real sample computes proper delta.
     {
         wlm_graph_values_t values = {};
-        _stats_read_fn(&state, &values);
+        _stats_read_fn(state, &values);
         free(values.data);
     }
 
-    const wlm_graph_app_config_t config = {
-        .app_name = _app_name,
-        .app_help = _app_help,
-        .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_INDEPENDENT,
-        .stats_read_fn = _stats_read_fn,
-        .app_state = &state,
-        .state_free_fn = _state_free,
-    };
+    wlm_graph_app_config_t config = _config;
+    config.app_state = state;
+    applet_ptr->graph_ptr = wlm_graph_create(host_ptr, argc, argv, &config);
+    if (NULL == applet_ptr->graph_ptr) {
+        _state_free(state);
+        free(applet_ptr);
+        return NULL;
+    }
+    return applet_ptr;
+}
 
-    return wlm_graph_app_run(argc, argv, &config);
+/* ------------------------------------------------------------------------- */
+/** Destroys the applet. See @ref wlmcl_applet_t::destroy. */
+static void _applet_destroy(void *state_ptr)
+{
+    cpugraph_applet_t *applet_ptr = state_ptr;
+    wlm_graph_destroy(applet_ptr->graph_ptr);
+    free(applet_ptr);
+}
+
+const wlmcl_applet_t wlm_cpugraph_applet = {
+    .name_ptr = "cpugraph",
+    .create = _applet_create,
+    .destroy = _applet_destroy,
+};
+
+/* == Main program ========================================================= */
+
+#if !defined(WLM_APPLETS_HOST)
+/** Main program. */
+int main(const int argc, const char **argv)
+{
+    return wlm_graph_app_run(argc, argv, &_config, &wlm_cpugraph_applet);
 }
+#endif  // !defined(WLM_APPLETS_HOST)
 
 /* == End of wlmcpugraph.c ================================================= */
@@ -19,9 +19,7 @@
  * limitations under the License.
  */
 
-#include <cairo.h>
 #include <libbase/libbase.h>
-#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -35,6 +33,7 @@
 #include "wlclient/wlclient.h"
 #include "wlclient/icon.h"
 #include "wlclient/dblbuf.h"
+#include "wlm_eyes.h"
 
 /* == Data ================================================================= */
 
@@ -46,14 +45,10 @@ static wlmcl_dblbuf_t             *toplevel_dblbuf_ptr;
 static wlmcl_dblbuf_t             *icon_dblbuf_ptr;
 /** Listener for key events. */
 static struct wl_listener     _key_listener;
-/** Most recent X position of the pointer. */
-double                        pointer_x;
-/** Most recent Y position of the pointer. */
-double                        pointer_y;
-/** Most recent X position of the pointer relative to the ivon. */
-double                        icon_pointer_x;
-/** Most recent Y position of the pointer relative to the ivon. */
-double                        icon_pointer_y;
+/** Renders the eyes of the toplevel. */
+static wlm_eyes_t             *toplevel_eyes_ptr;
+/** Renders the eyes of the icon. */
+static wlm_eyes_t             *icon_eyes_ptr;
 
 /** Desired width of the toplevel, in pixels. */
 uint32_t                      toplevel_width;
@@ -102,115 +97,29 @@ static void _handle_key(__UNUSED__ struct wl_listener *listener_ptr,
 }
 
 /* ------------------------------------------------------------------------- */
-/** @return x * x. */
-static inline double sqr(double x)
+/** Forwards damage reported by the eyes to the double buffer at `ud_ptr`. */
+static void _damage(const wlm_eyes_rect_t *rect_ptr, void *ud_ptr)
 {
-    return x * x;
+    wlmcl_dblbuf_damage(ud_ptr, rect_ptr->x, rect_ptr->y,
+                        rect_ptr->width, rect_ptr->height);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Draws the white + border of the eye. */
-void _draw_around(cairo_t *cairo_ptr,
-                  double x,
-                  double y,
-                  int width,
-                  int height)
-{
-    double diag = sqrt(width * width + height * height);
-
-    cairo_save(cairo_ptr);
-
-    cairo_translate(cairo_ptr, x * width, y * height);
-    cairo_scale(cairo_ptr, 0.2 * width / diag, 0.4 * height / diag);
-
-    cairo_set_line_width(cairo_ptr, 0);
-    cairo_set_source_rgb(cairo_ptr, 1.0, 1.0, 1.0);
-    cairo_arc(cairo_ptr,
-              0.0, 0.0,
-              diag,
-              0, 2 * M_PI);
-    cairo_fill(cairo_ptr);
-
-    cairo_set_line_width(cairo_ptr, sqrt(width * width + height * height) / 10);
-    cairo_set_source_rgb(cairo_ptr, 0.0, 0.0, 0.0);
-    cairo_arc(cairo_ptr,
-              0.0, 0.0,
-              diag,
-              0, 2 * M_PI);
-    cairo_stroke(cairo_ptr);
-
-    cairo_restore(cairo_ptr);
-}
-
-/* ------------------------------------------------------------------------- */
-/** Draws the eyes' pupil, in relative coordinates. */
-void _draw_pupil(cairo_t *cairo_ptr,
-                 double pointer_x,
-                 double pointer_y,
-                 double px,
-                 double py,
-                 double w,
-                 double h,
-                 int width,
-                 int height)
-{
-    double rel_x = pointer_x - px;
-    double rel_y = pointer_y - py;
-
-    // Scale the position back to the ellipsis.
-    double ratio = sqr(rel_x / w) + sqr(rel_y / h);
-    if (ratio > 1.0) {
-        rel_x = rel_x / sqrt(ratio);
-        rel_y = rel_y / sqrt(ratio);
-    }
-
-    int x = width * (rel_x + px);
-    int y = height * (rel_y + py);
-
-    cairo_save(cairo_ptr);
-
-    cairo_set_source_rgb(cairo_ptr, 0.0, 0.0, 0.0);
-    cairo_set_line_width(cairo_ptr, sqrt(width * width + height * height) / 15);
-    cairo_set_line_cap(cairo_ptr, CAIRO_LINE_CAP_ROUND);
-    cairo_move_to(cairo_ptr, x, y);
-    cairo_line_to(cairo_ptr, x, y);
-    cairo_stroke(cairo_ptr);
-
-    cairo_restore(cairo_ptr);
-}
-
-/* ------------------------------------------------------------------------- */
-/** Draws something into the buffer. */
+/** Draws the toplevel's eyes into the buffer. */
 static bool _callback(bs_gfxbuf_t *gfxbuf_ptr, __UNUSED__ void *ud_ptr)
 {
-    bs_gfxbuf_clear(gfxbuf_ptr, 0);
-
-    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) return false;
-
-    _draw_around(cairo_ptr, 0.25, 0.5,
-                 gfxbuf_ptr->width, gfxbuf_ptr->height);
-    _draw_around(cairo_ptr, 0.75, 0.5,
-                 gfxbuf_ptr->width, gfxbuf_ptr->height);
-
-    _draw_pupil(cairo_ptr,
-                pointer_x, pointer_y,
-                0.25, 0.5, 0.13, 0.3,
-                gfxbuf_ptr->width, gfxbuf_ptr->height);
-    _draw_pupil(cairo_ptr,
-                pointer_x, pointer_y,
-                0.75, 0.5, 0.13, 0.3,
-                gfxbuf_ptr->width, gfxbuf_ptr->height);
-    return true;
+    return wlm_eyes_draw(
+        toplevel_eyes_ptr, gfxbuf_ptr,
+        wlmcl_dblbuf_age(toplevel_dblbuf_ptr),
+        _damage, toplevel_dblbuf_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates pointer position. */
+/** Updates pointer position. Redraws only if a pupil moved. */
 static void _position_callback(double x, double y, __UNUSED__ void *ud_ptr)
 {
-    pointer_x = x;
-    pointer_y = y;
-    if (NULL != toplevel_dblbuf_ptr) {
+    if (wlm_eyes_set_pointer(toplevel_eyes_ptr, x, y) &&
+        NULL != toplevel_dblbuf_ptr) {
         wlmcl_dblbuf_register_ready_callback(
             toplevel_dblbuf_ptr, _callback, NULL);
     }
@@ -220,34 +129,18 @@ static void _position_callback(double x, double y, __UNUSED__ void *ud_ptr)
 /** Called when the icon is ready to refresh. */
 static bool _icon_callback(bs_gfxbuf_t *gfxbuf_ptr, __UNUSED__ void *ud_ptr)
 {
-    bs_gfxbuf_clear(gfxbuf_ptr, 0);
-
-    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) return false;
-
-    _draw_around(cairo_ptr, 0.25, 0.5,
-                 gfxbuf_ptr->width, gfxbuf_ptr->height);
-    _draw_around(cairo_ptr, 0.75, 0.5,
-                 gfxbuf_ptr->width, gfxbuf_ptr->height);
-
-    _draw_pupil(cairo_ptr,
-                icon_pointer_x, icon_pointer_y,
-                0.25, 0.5, 0.13, 0.3,
-                gfxbuf_ptr->width, gfxbuf_ptr->height);
-    _draw_pupil(cairo_ptr,
-                icon_pointer_x, icon_pointer_y,
-                0.75, 0.5, 0.13, 0.3,
-                gfxbuf_ptr->width, gfxbuf_ptr->height);
-    return true;
+    return wlm_eyes_draw(
+        icon_eyes_ptr, gfxbuf_ptr,
+        wlmcl_dblbuf_age(icon_dblbuf_ptr),
+        _damage, icon_dblbuf_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates pointer position for the icon. */
+/** Updates pointer position for the icon. Redraws only if a pupil moved. */
 static void _icon_position_callback(double x, double y, __UNUSED__ void *ud_ptr)
 {
-    icon_pointer_x = x;
-    icon_pointer_y = y;
-    if (NULL != icon_dblbuf_ptr) {
+    if (wlm_eyes_set_pointer(icon_eyes_ptr, x, y) &&
+        NULL != icon_dblbuf_ptr) {
         wlmcl_dblbuf_register_ready_callback(
             icon_dblbuf_ptr, _icon_callback, NULL);
     }
@@ -258,19 +151,24 @@ static void _icon_position_callback(double x, double y, __UNUSED__ void *ud_ptr)
 static void _handle_toplevel_configure(void *ud_ptr, uint32_t width, uint32_t height)
 {
     wlmcl_xdg_toplevel_t *toplevel_ptr = ud_ptr;
-    if (NULL != toplevel_dblbuf_ptr) {
+    if (NULL != toplevel_dblbuf_ptr &&
+        !wlmcl_dblbuf_resize(toplevel_dblbuf_ptr, width, height)) {
         wlmcl_dblbuf_destroy(toplevel_dblbuf_ptr);
+        toplevel_dblbuf_ptr = NULL;
     }
-    toplevel_dblbuf_ptr = wlmcl_dblbuf_create(
-        wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
-        wlmcl_xdg_toplevel_wl_surface(toplevel_ptr),
-        wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
-        width,
-        height);
     if (NULL == toplevel_dblbuf_ptr) {
-        bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create for toplevel.");
-        return;
+        toplevel_dblbuf_ptr = wlmcl_dblbuf_create(
+            wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
+            wlmcl_xdg_toplevel_wl_surface(toplevel_ptr),
+            wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
+            width,
+            height);
+        if (NULL == toplevel_dblbuf_ptr) {
+            bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create for toplevel.");
+            return;
+        }
     }
+    wlm_eyes_set_size(toplevel_eyes_ptr, width, height);
     wlmcl_dblbuf_register_ready_callback(
         toplevel_dblbuf_ptr, _callback, NULL);
 }
@@ -280,19 +178,24 @@ static void _handle_toplevel_configure(void *ud_ptr, uint32_t width, uint32_t he
 static void _handle_icon_configure(void *ud_ptr, uint32_t width, uint32_t height)
 {
     wlmcl_icon_t *icon_ptr = ud_ptr;
-    if (NULL != icon_dblbuf_ptr) {
+    if (NULL != icon_dblbuf_ptr &&
+        !wlmcl_dblbuf_resize(icon_dblbuf_ptr, width, height)) {
         wlmcl_dblbuf_destroy(icon_dblbuf_ptr);
+        icon_dblbuf_ptr = NULL;
     }
-    icon_dblbuf_ptr = wlmcl_dblbuf_create(
-        wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
-        wlmcl_icon_wl_surface(icon_ptr),
-        wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
-        width,
-        height);
     if (NULL == icon_dblbuf_ptr) {
-        bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create for icon.");
-        return;
+        icon_dblbuf_ptr = wlmcl_dblbuf_create(
+            wlmcl_client_attributes(wlclient_ptr)->app_id_ptr,
+            wlmcl_icon_wl_surface(icon_ptr),
+            wlmcl_client_attributes(wlclient_ptr)->wl_shm_ptr,
+            width,
+            height);
+        if (NULL == icon_dblbuf_ptr) {
+            bs_log(BS_FATAL, "Failed wlmcl_dblbuf_create for icon.");
+            return;
+        }
     }
+    wlm_eyes_set_size(icon_eyes_ptr, width, height);
     wlmcl_dblbuf_register_ready_callback(
         icon_dblbuf_ptr, _icon_callback, NULL);
 }
@@ -308,8 +211,20 @@ int main(int argc, const char **argv)
         return EXIT_FAILURE;
     }
 
+    toplevel_eyes_ptr = wlm_eyes_create();
+    icon_eyes_ptr = wlm_eyes_create();
+    if (NULL == toplevel_eyes_ptr || NULL == icon_eyes_ptr) {
+        if (NULL != toplevel_eyes_ptr) wlm_eyes_destroy(toplevel_eyes_ptr);
+        if (NULL != icon_eyes_ptr) wlm_eyes_destroy(icon_eyes_ptr);
+        return EXIT_FAILURE;
+    }
+
     wlclient_ptr = wlmcl_client_create("wlmaker.wlmeyes");
-    if (NULL == wlclient_ptr) return EXIT_FAILURE;
+    if (NULL == wlclient_ptr) {
+        wlm_eyes_destroy(icon_eyes_ptr);
+        wlm_eyes_destroy(toplevel_eyes_ptr);
+        return EXIT_FAILURE;
+    }
 
     _key_listener.notify = _handle_key;
     wl_signal_add(&wlmcl_client_events(wlclient_ptr)->key, &_key_listener);
@@ -359,6 +274,8 @@ int main(int argc, const char **argv)
 
     wl_list_remove(&_key_listener.link);
     wlmcl_client_destroy(wlclient_ptr);
+    wlm_eyes_destroy(icon_eyes_ptr);
+    wlm_eyes_destroy(toplevel_eyes_ptr);
     return EXIT_SUCCESS;
 }
 
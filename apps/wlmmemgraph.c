@@ -21,13 +21,14 @@
  * limitations under the License.
  */
 
+#include "wlm_applets.h"
 #include "wlm_graph_shared.h"
+#include "wlm_sampler.h"
 
 #include <libbase/libbase.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <string.h>
 
 /** Application name. */
 static const char _app_name[] = "wlmmemgraph";
@@ -42,12 +43,6 @@ static const char _app_help[] =
     "\n"
     "The label displays total memory usage.";
 
-/** Line buffer size for /proc/meminfo parsing. */
-#define LINE_BUFFER_SIZE 256
-
-/** Number of fields to parse from /proc/meminfo. */
-#define MEMINFO_FIELD_COUNT 5
-
 /* == Definitions ========================================================== */
 
 /** Number of memory categories tracked. */
@@ -100,8 +95,8 @@ static void _memgraph_lut_init(uint32_t lut[256])
 
 /** State for the memory graph (mutable runtime data). */
 typedef struct {
-    /** Open file handle to /proc/meminfo. */
-    FILE *proc_fp;
+    /** Sampler for /proc/meminfo. */
+    wlm_sampler_t *sampler_ptr;
     /** Total memory in kB (from /proc/meminfo). */
     unsigned long mem_total_kb;
     /** Used memory in kB (non-reclaimable). */
@@ -118,9 +113,9 @@ static void _state_free(void *app_state)
 {
     memgraph_state_t *state = app_state;
 
-    if (NULL != state->proc_fp) {
-        fclose(state->proc_fp);
-        state->proc_fp = NULL;
+    if (NULL != state->sampler_ptr) {
+        wlm_sampler_release(state->sampler_ptr);
+        state->sampler_ptr = NULL;
     }
 }
 
@@ -171,17 +166,6 @@ static const char *_label_fn(void *app_state)
 
 /* == Memory statistics ==================================================== */
 
-/**
- * Matches line label against a string literal.
- *
- * Compares `label_len` bytes of `line` against the literal. Used for parsing
- * /proc/meminfo where each line has format "Label: value kB".
- *
- * @param literal       String literal to match against.
- */
-#define LABEL_MATCH(literal) \
-        (sizeof(literal) - 1 == label_len && 0 == memcmp(line, literal, sizeof(literal) - 1))
-
 /* ------------------------------------------------------------------------- */
 /**
  * Reads memory statistics from /proc/meminfo.
@@ -197,9 +181,8 @@ static const char *_label_fn(void *app_state)
 static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_t *values)
 {
     memgraph_state_t * const state = app_state;
-    FILE * const fp = state->proc_fp;
 
-    if (NULL == fp) {
+    if (NULL == state->sampler_ptr) {
         return WLM_GRAPH_READ_ERROR;
     }
 
@@ -213,50 +196,20 @@ static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_
         values->num = MEM_CATEGORY_COUNT;
     }
 
-    rewind(fp);
-
-    unsigned long mem_total = 0;
-    unsigned long mem_free = 0;
-    unsigned long buffers = 0;
-    unsigned long cached = 0;
-    unsigned long sreclaimable = 0;
-
-    char line[LINE_BUFFER_SIZE];
-    size_t label_len = 0;
-    int fields_found = 0;
-    while (NULL != fgets(line, sizeof(line), fp) &&
-           fields_found < MEMINFO_FIELD_COUNT) {
-        // Find the colon to extract the value efficiently.
-        char * const colon = strchr(line, ':');
-        if (NULL == colon) {
-            continue;
-        }
-
-        unsigned long value;
-        if (1 != sscanf(colon + 1, "%lu", &value)) {
-            continue;
-        }
-
-        // Match label by prefix length (colon position).
-        label_len = colon - line;
-        if (LABEL_MATCH("MemTotal")) {
-            mem_total = value;
-            fields_found++;
-        } else if (LABEL_MATCH("MemFree")) {
-            mem_free = value;
-            fields_found++;
-        } else if (LABEL_MATCH("Buffers")) {
-            buffers = value;
-            fields_found++;
-        } else if (LABEL_MATCH("Cached")) {
-            cached = value;
-            fields_found++;
-        } else if (LABEL_MATCH("SReclaimable")) {
-            sreclaimable = value;
-            fields_found++;
-        }
+    size_t len;
+    const char *data = wlm_sampler_read(state->sampler_ptr, &len);
+    if (NULL == data) {
+        return WLM_GRAPH_READ_ERROR;
     }
 
+    wlm_sampler_meminfo_t meminfo;
+    wlm_sampler_parse_meminfo(data, len, &meminfo);
+    const unsigned long mem_total = meminfo.total;
+    const unsigned long mem_free = meminfo.free;
+    const unsigned long buffers = meminfo.buffers;
+    const unsigned long cached = meminfo.cached;
+    const unsigned long sreclaimable = meminfo.sreclaimable;
+
     if (0 == mem_total) {
         return WLM_GRAPH_READ_ERROR;
     }
@@ -281,37 +234,92 @@ static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_
 
     return WLM_GRAPH_READ_OK;
 }
-#undef LABEL_MATCH
 
-/* == Main program ========================================================= */
+/* == Applet =============================================================== */
 
-/** Main program. */
-int main(const int argc, const char **argv)
+/** Custom LUT (blue-to-green gradient). Initialized by @ref _pixel_lut_init. */
+static uint32_t _pixel_lut[256];
+
+/** Configuration, without the state. */
+static const wlm_graph_app_config_t _config = {
+    .app_name = _app_name,
+    .app_help = _app_help,
+    .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_STACKED,
+    .stats_read_fn = _stats_read_fn,
+    .state_free_fn = _state_free,
+    .pixel_lut = _pixel_lut,
+    .label_fn = _label_fn,
+};
+
+/** The applet: The graph, and the state it samples. */
+typedef struct {
+    /** The graph. */
+    wlm_graph_t *graph_ptr;
+    /** State for sampling. */
+    memgraph_state_t state;
+} memgraph_applet_t;
+
+/* ------------------------------------------------------------------------- */
+/** Initializes @ref _pixel_lut, if not done yet. */
+static void _pixel_lut_init(void)
+{
+    if (0 != _pixel_lut[255]) return;
+    _memgraph_lut_init(_pixel_lut);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates the applet. See @ref wlmcl_applet_t::create. */
+static void *_applet_create(
+    wlmcl_applet_host_t *host_ptr,
+    int argc,
+    const char **argv)
 {
-    memgraph_state_t state = {};
+    memgraph_applet_t *applet_ptr = logged_calloc(1, sizeof(memgraph_applet_t));
+    if (NULL == applet_ptr) return NULL;
+    memgraph_state_t *state = &applet_ptr->state;
+
+    state->sampler_ptr = wlm_sampler_acquire("/proc/meminfo");
+    if (NULL == state->sampler_ptr) {
+        bs_log(BS_ERROR, "Failed to open /proc/meminfo");
+        free(applet_ptr);
+        return NULL;
+    }
 
-    state.proc_fp = fopen("/proc/meminfo", "r");
-    if (NULL == state.proc_fp) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed to open /proc/meminfo");
-        return EXIT_FAILURE;
+    _pixel_lut_init();
+    wlm_graph_app_config_t config = _config;
+    config.app_state = state;
+    applet_ptr->graph_ptr = wlm_graph_create(host_ptr, argc, argv, &config);
+    if (NULL == applet_ptr->graph_ptr) {
+        _state_free(state);
+        free(applet_ptr);
+        return NULL;
     }
+    return applet_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the applet. See @ref wlmcl_applet_t::destroy. */
+static void _applet_destroy(void *state_ptr)
+{
+    memgraph_applet_t *applet_ptr = state_ptr;
+    wlm_graph_destroy(applet_ptr->graph_ptr);
+    free(applet_ptr);
+}
+
+const wlmcl_applet_t wlm_memgraph_applet = {
+    .name_ptr = "memgraph",
+    .create = _applet_create,
+    .destroy = _applet_destroy,
+};
 
-    // Initialize custom LUT (blue-to-green gradient).
-    uint32_t pixel_lut[256];
-    _memgraph_lut_init(pixel_lut);
-
-    const wlm_graph_app_config_t config = {
-        .app_name = _app_name,
-        .app_help = _app_help,
-        .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_STACKED,
-        .stats_read_fn = _stats_read_fn,
-        .app_state = &state,
-        .state_free_fn = _state_free,
-        .pixel_lut = pixel_lut,
-        .label_fn = _label_fn,
-    };
-
-    return wlm_graph_app_run(argc, argv, &config);
+/* == Main program ========================================================= */
+
+#if !defined(WLM_APPLETS_HOST)
+/** Main program. */
+int main(const int argc, const char **argv)
+{
+    return wlm_graph_app_run(argc, argv, &_config, &wlm_memgraph_applet);
 }
+#endif  // !defined(WLM_APPLETS_HOST)
 
 /* == End of wlmmemgraph.c ================================================= */
@@ -21,10 +21,11 @@
  * limitations under the License.
  */
 
+#include "wlm_applets.h"
 #include "wlm_graph_shared.h"
+#include "wlm_sampler.h"
 
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -57,12 +58,6 @@ static const char _app_help[] =
 /** Threshold below which peak rate doesn't decay. */
 #define PEAK_DECAY_THRESHOLD 1024
 
-/** Line buffer size for /proc/net/dev parsing. */
-#define LINE_BUFFER_SIZE 512
-
-/** Number of header lines to skip in /proc/net/dev. */
-#define HEADER_LINE_COUNT 2
-
 /** Maximum length of the label string. */
 #define LABEL_BUFFER_SIZE 16
 
@@ -119,8 +114,8 @@ typedef struct {
 
 /** State for the network graph (mutable runtime data). */
 typedef struct {
-    /** Open file handle to /proc/net/dev. */
-    FILE *proc_fp;
+    /** Sampler for /proc/net/dev. */
+    wlm_sampler_t *sampler_ptr;
     /** Previous absolute RX byte count for computing rate. */
     unsigned long long prev_rx_bytes;
     /** Previous absolute TX byte count for computing rate. */
@@ -173,9 +168,9 @@ static void _state_free(void *app_state)
 {
     netgraph_state_t *state = app_state;
 
-    if (NULL != state->proc_fp) {
-        fclose(state->proc_fp);
-        state->proc_fp = NULL;
+    if (NULL != state->sampler_ptr) {
+        wlm_sampler_release(state->sampler_ptr);
+        state->sampler_ptr = NULL;
     }
 }
 
@@ -196,9 +191,8 @@ static void _state_free(void *app_state)
 static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_t *values)
 {
     netgraph_state_t * const state = app_state;
-    FILE * const fp = state->proc_fp;
 
-    if (NULL == fp) {
+    if (NULL == state->sampler_ptr) {
         return WLM_GRAPH_READ_ERROR;
     }
 
@@ -212,47 +206,19 @@ static wlm_graph_read_result_t _stats_read_fn(void *app_state, wlm_graph_values_
         values->num = NET_CATEGORY_COUNT;
     }
 
-    rewind(fp);
-
-    unsigned long long total_rx_bytes = 0;
-    unsigned long long total_tx_bytes = 0;
-
-    // Skip header lines in /proc/net/dev.
-    char line[LINE_BUFFER_SIZE];
-    for (int i = 0; i < HEADER_LINE_COUNT; i++) {
-        if (NULL == fgets(line, sizeof(line), fp)) {
-            return WLM_GRAPH_READ_ERROR;
-        }
+    size_t len;
+    const char *data = wlm_sampler_read(state->sampler_ptr, &len);
+    if (NULL == data) {
+        return WLM_GRAPH_READ_ERROR;
     }
 
-    while (NULL != fgets(line, sizeof(line), fp)) {
-        // Find interface name (ends with ':').
-        char * const colon = strchr(line, ':');
-        if (NULL == colon) {
-            continue;
-        }
-
-        // Extract interface name and skip loopback.
-        *colon = '\0';
-        char *iface = line;
-        while (' ' == *iface) iface++;  // Trim leading spaces.
-        if (0 == strcmp(iface, "lo")) {
-            continue;
-        }
-
-        // Parse stats after colon.
-        // Format: rx_bytes rx_packets rx_errs rx_drop rx_fifo rx_frame
-        //         rx_compressed rx_multicast tx_bytes tx_packets ...
-        unsigned long long rx_bytes, tx_bytes, skip;
-        const int parsed = sscanf(colon + 1,
-            "%llu %llu %llu %llu %llu %llu %llu %llu %llu",
-            &rx_bytes, &skip, &skip, &skip, &skip, &skip, &skip, &skip,
-            &tx_bytes);
-        if (9 == parsed) {
-            total_rx_bytes += rx_bytes;
-            total_tx_bytes += tx_bytes;
-        }
+    // Sums up bytes of all interfaces, excluding loopback.
+    wlm_sampler_net_dev_t net_dev;
+    if (!wlm_sampler_parse_net_dev(data, len, &net_dev)) {
+        return WLM_GRAPH_READ_ERROR;
     }
+    const unsigned long long total_rx_bytes = net_dev.rx_bytes;
+    const unsigned long long total_tx_bytes = net_dev.tx_bytes;
 
     // Compute rate (bytes since last read).
     unsigned long long rx_rate = 0;
@@ -360,42 +326,90 @@ static void _regenerate_fn(void *app_state, wlm_graph_values_t *samples, const u
     }
 }
 
-/* == Main program ========================================================= */
+/* == Applet =============================================================== */
+
+/** Configuration, without the state. */
+static const wlm_graph_app_config_t _config = {
+    .app_name = _app_name,
+    .app_help = _app_help,
+    .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_INDEPENDENT,
+    .stats_read_fn = _stats_read_fn,
+    .regenerate_fn = _regenerate_fn,
+    .state_free_fn = _state_free,
+    .label_fn = _label_fn,
+};
 
-/** Main program. */
-int main(const int argc, const char **argv)
-{
-    netgraph_state_t state = {};
+/** The applet: The graph, and the state it samples. */
+typedef struct {
+    /** The graph. */
+    wlm_graph_t *graph_ptr;
+    /** State for sampling. */
+    netgraph_state_t state;
+} netgraph_applet_t;
 
-    state.proc_fp = fopen("/proc/net/dev", "r");
-    if (NULL == state.proc_fp) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed to open /proc/net/dev");
-        return EXIT_FAILURE;
+/* ------------------------------------------------------------------------- */
+/** Creates the applet. See @ref wlmcl_applet_t::create. */
+static void *_applet_create(
+    wlmcl_applet_host_t *host_ptr,
+    int argc,
+    const char **argv)
+{
+    netgraph_applet_t *applet_ptr = logged_calloc(1, sizeof(netgraph_applet_t));
+    if (NULL == applet_ptr) return NULL;
+    netgraph_state_t *state = &applet_ptr->state;
+
+    state->sampler_ptr = wlm_sampler_acquire("/proc/net/dev");
+    if (NULL == state->sampler_ptr) {
+        bs_log(BS_ERROR, "Failed to open /proc/net/dev");
+        free(applet_ptr);
+        return NULL;
     }
 
     // Prime prev values so first real sample computes proper delta.
     // Reset peak and history after priming (first read sets peak to total bytes).
     {
         wlm_graph_values_t values = {};
-        _stats_read_fn(&state, &values);
+        _stats_read_fn(state, &values);
         free(values.data);
-        state.peak_rate = 0;
-        state.history_index = 0;
-        state.history_num = 0;
+        state->peak_rate = 0;
+        state->history_index = 0;
+        state->history_num = 0;
     }
 
-    const wlm_graph_app_config_t config = {
-        .app_name = _app_name,
-        .app_help = _app_help,
-        .accumulate_mode = WLM_GRAPH_ACCUMULATE_MODE_INDEPENDENT,
-        .stats_read_fn = _stats_read_fn,
-        .regenerate_fn = _regenerate_fn,
-        .app_state = &state,
-        .state_free_fn = _state_free,
-        .label_fn = _label_fn,
-    };
-
-    return wlm_graph_app_run(argc, argv, &config);
+    wlm_graph_app_config_t config = _config;
+    config.app_state = state;
+    applet_ptr->graph_ptr = wlm_graph_create(host_ptr, argc, argv, &config);
+    if (NULL == applet_ptr->graph_ptr) {
+        _state_free(state);
+        free(applet_ptr);
+        return NULL;
+    }
+    return applet_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the applet. See @ref wlmcl_applet_t::destroy. */
+static void _applet_destroy(void *state_ptr)
+{
+    netgraph_applet_t *applet_ptr = state_ptr;
+    wlm_graph_destroy(applet_ptr->graph_ptr);
+    free(applet_ptr);
+}
+
+const wlmcl_applet_t wlm_netgraph_applet = {
+    .name_ptr = "netgraph",
+    .create = _applet_create,
+    .destroy = _applet_destroy,
+};
+
+/* == Main program ========================================================= */
+
+#if !defined(WLM_APPLETS_HOST)
+/** Main program. */
+int main(const int argc, const char **argv)
+{
+    return wlm_graph_app_run(argc, argv, &_config, &wlm_netgraph_applet);
 }
+#endif  // !defined(WLM_APPLETS_HOST)
 
 /* == End of wlmnetgraph.c ================================================= */
@@ -106,7 +106,26 @@ void wlmbe_backend_magnify(wlmbe_backend_t *backend_ptr);
 /** Reduces all backend outputs by @ref _wlmbke_backend_magnification. */
 void wlmbe_backend_reduce(wlmbe_backend_t *backend_ptr);
 
-/** Saves the output's ephemeral state into the state file. */
+/**
+ * Powers all outputs on or off. See @ref wlmbe_output_set_power.
+ *
+ * @param backend_ptr
+ * @param on
+ *
+ * @return true if all outputs succeeded.
+ */
+bool wlmbe_backend_set_power(wlmbe_backend_t *backend_ptr, bool on);
+
+/**
+ * Requests saving the output's ephemeral state into the state file.
+ *
+ * Returns right away: Repeated requests are coalesced, and the file is
+ * written atomically on a writer thread. The outcome is logged.
+ *
+ * @param backend_ptr
+ *
+ * @return false if the save could not be scheduled.
+ */
 bool wlmbe_backend_save_ephemeral_output_configs(wlmbe_backend_t *backend_ptr);
 
 /** Unit test cases. */
@@ -23,12 +23,31 @@
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "output_config.h"
 
 /** Handle for an output device. */
 typedef struct _wlmbe_output_t wlmbe_output_t;
 
+/**
+ * Frame scheduling statistics of an output.
+ *
+ * With a 'MaxRenderTime' configured, rendering is postponed from the frame
+ * event until just before the predicted vblank. Client content arriving
+ * during that time is shown one refresh cycle earlier than otherwise.
+ */
+typedef struct {
+    /** Number of frames rendered. */
+    uint64_t                  frames;
+    /** Number of frames with rendering postponed. */
+    uint64_t                  delayed_frames;
+    /** Number of postponed frames that completed after the vblank. */
+    uint64_t                  missed_frames;
+    /** Total postponement of frames that met the vblank, in nanoseconds. */
+    uint64_t                  saved_nsec;
+} wlmbe_output_frame_stats_t;
+
 struct wlr_output;
 struct wlr_allocator;
 struct wlr_renderer;
@@ -91,12 +110,36 @@ void wlmbe_output_update_attributes(
     int y,
     bool has_position);
 
+/**
+ * Powers the output on or off, by enabling or disabling it. While off, the
+ * output neither renders nor sends frame-done to clients. Powering on
+ * restores the mode, and schedules a frame.
+ *
+ * Outputs disabled through configuration are not powered on or off.
+ *
+ * @param output_ptr
+ * @param on
+ *
+ * @return true on success.
+ */
+bool wlmbe_output_set_power(wlmbe_output_t *output_ptr, bool on);
+
+/** @return Whether the output was powered off. */
+bool wlmbe_output_powered_off(wlmbe_output_t *output_ptr);
+
+/** Returns the frame scheduling statistics of this output. */
+const wlmbe_output_frame_stats_t *wlmbe_output_frame_stats(
+    wlmbe_output_t *output_ptr);
+
 /** Returns a pointer to @ref wlmbe_output_t::dlnode. */
 bs_dllist_node_t *wlmbe_dlnode_from_output(wlmbe_output_t *output_ptr);
 
 /** Returns the @ref wlmbe_output_t for @ref wlmbe_output_t::dlnode. */
 wlmbe_output_t *wlmbe_output_from_dlnode(bs_dllist_node_t *dlnode_ptr);
 
+/** Unit test cases. */
+extern const bs_test_set_t wlmbe_output_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -95,6 +95,13 @@ typedef struct {
     wlmbe_output_config_mode_t mode;
     /** Whether the 'Mode' field was present. */
     bool                      has_mode;
+
+    /**
+     * Render budget, in milliseconds. If non-zero, rendering is postponed
+     * until that long before the next vblank, to pick up late client content.
+     * 0 renders right away at the output's frame event.
+     */
+    uint64_t                  max_render_time;
 } wlmbe_output_config_attributes_t;
 
 /** Returns the base pointer from the  @ref wlmbe_output_config_t::dlnode. */
@@ -21,6 +21,8 @@
 #ifndef __WLMBE_OUTPUT_MANAGER_H__
 #define __WLMBE_OUTPUT_MANAGER_H__
 
+#include <libbase/libbase.h>
+
 struct wl_display;
 struct wlr_backend;
 struct wlr_output_layout;
@@ -71,6 +73,9 @@ void wlmbe_output_manager_scale(
     wlmbe_output_manager_t *output_manager_ptr,
     double scale);
 
+/** Unit test cases. */
+extern const bs_test_set_t wlmbe_output_manager_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -46,6 +46,10 @@ struct _wlmtk_buffer_t {
 
     /** WLR buffer holding the contents. */
     struct wlr_buffer        *wlr_buffer_ptr;
+    /** Width in layout coordinates. 0 to use the buffer's width. */
+    int                       width;
+    /** Height in layout coordinates. 0 to use the buffer's height. */
+    int                       height;
     /** Scene graph API node. Only set after calling `create_scene_node`. */
     struct wlr_scene_buffer  *wlr_scene_buffer_ptr;
 
@@ -83,6 +87,20 @@ void wlmtk_buffer_set(
     wlmtk_buffer_t *buffer_ptr,
     struct wlr_buffer *wlr_buffer_ptr);
 
+/**
+ * Sets the dimensions of the buffer, in layout coordinates. The contents will
+ * be scaled to these dimensions. Permits to show a buffer rendered at the
+ * output's scale, without upscaling it.
+ *
+ * @param buffer_ptr
+ * @param width               Width, or 0 to use the wlr_buffer's width.
+ * @param height              Height, or 0 to use the wlr_buffer's height.
+ */
+void wlmtk_buffer_set_dimensions(
+    wlmtk_buffer_t *buffer_ptr,
+    int width,
+    int height);
+
 /** @return the superclass' @ref wlmtk_element_t of `buffer_ptr`. */
 wlmtk_element_t *wlmtk_buffer_element(wlmtk_buffer_t *buffer_ptr);
 
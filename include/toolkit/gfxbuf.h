@@ -47,6 +47,16 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     unsigned width,
     unsigned height);
 
+/**
+ * Wraps an existing libbase graphics buffer as wlroots buffer.
+ *
+ * @param bs_gfxbuf_ptr
+ *
+ * @return A struct wlr_buffer, owning `bs_gfxbuf_ptr`. Must be released using
+ *     wlr_buffer_drop(). NULL on error: The caller then keeps ownership.
+ */
+struct wlr_buffer *bs_gfxbuf_wrap_wlr_buffer(bs_gfxbuf_t *bs_gfxbuf_ptr);
+
 /**
  * Drops a WLR buffer, and sets the pointer to NULL.
  *
@@ -66,6 +66,19 @@ void wlmtk_image_destroy(wlmtk_image_t *image_ptr);
 /** @return the parent @ref wlmtk_element_t of `image_ptr`. */
 wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr);
 
+/**
+ * Decodes the PNG image at `path_ptr` ahead of time: The next creation of an
+ * image from `path_ptr` uses the decoded image. May run on any thread.
+ *
+ * @param path_ptr
+ *
+ * @return true on success.
+ */
+bool wlmtk_image_prefetch(const char *path_ptr);
+
+/** Releases all prefetched images that were not used. */
+void wlmtk_image_prefetch_flush(void);
+
 /** Unit test cases. */
 extern const bs_test_set_t wlmtk_image_test_set;
 
@@ -199,6 +199,14 @@ size_t wlmtk_menu_items_size(wlmtk_menu_t *menu_ptr);
  */
 wlmtk_menu_item_t *wlmtk_menu_item_at(wlmtk_menu_t *menu_ptr, size_t i);
 
+/**
+ * @param menu_ptr
+ *
+ * @return Number of state buffers held by the menu's items. Does not include
+ *     the buffers held by submenus. See @ref wlmtk_menu_item_buffers.
+ */
+size_t wlmtk_menu_buffers(wlmtk_menu_t *menu_ptr);
+
 /** Creates a holder for the menu style, with initialized reference.
  *
  * @return Pointer to @ref wlmtk_menu_style. To destroy, call
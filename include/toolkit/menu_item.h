@@ -24,6 +24,7 @@
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <wayland-server-core.h>
 
@@ -204,6 +205,13 @@ bool wlmtk_menu_item_set_highlighted(
  */
 void wlmtk_menu_item_trigger(wlmtk_menu_item_t *menu_item_ptr);
 
+/**
+ * @param menu_item_ptr
+ *
+ * @return Number of state buffers currently held by the item, 0 to 3.
+ */
+size_t wlmtk_menu_item_buffers(wlmtk_menu_item_t *menu_item_ptr);
+
 /** Returns pointer to @ref wlmtk_menu_item_t::dlnode. */
 bs_dllist_node_t *wlmtk_dlnode_from_menu_item(
     wlmtk_menu_item_t *menu_item_ptr);
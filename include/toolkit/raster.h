@@ -0,0 +1,184 @@
+/* ========================================================================= */
+/**
+ * @file raster.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_RASTER_H__
+#define __WLMTK_RASTER_H__
+
+#include <cairo.h>
+#include <libbase/libbase.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <wayland-server-core.h>
+
+struct wlr_buffer;
+
+/** Forward declaration: A pool of rasterization workers. */
+typedef struct _wlmtk_raster_pool_t wlmtk_raster_pool_t;
+/** Forward declaration: A rasterization job. */
+typedef struct _wlmtk_raster_job_t wlmtk_raster_job_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Draws the job's contents. Runs on a worker thread.
+ *
+ * Must only access `args_ptr`, and must not call into wlroots.
+ *
+ * @param cairo_ptr           Cairo, targetting the job's image buffer. It
+ *                            is wrapped as `struct wlr_buffer` only when
+ *                            handed back, on the event loop's thread.
+ * @param args_ptr            The job's copy of the arguments.
+ *
+ * @return true on success.
+ */
+typedef bool (*wlmtk_raster_draw_t)(cairo_t *cairo_ptr, void *args_ptr);
+
+/**
+ * Releases resources referenced from the job's arguments. Runs on the event
+ * loop's thread, once the job is completed or cancelled. Not called if the
+ * submission failed: The submitter then still owns these resources.
+ *
+ * @param args_ptr
+ */
+typedef void (*wlmtk_raster_args_fini_t)(void *args_ptr);
+
+/**
+ * Hands the drawn buffer back. Runs on the event loop's thread.
+ *
+ * @param wlr_buffer_ptr      The drawn buffer, or NULL if drawing failed.
+ *                            The callee takes ownership, and must release
+ *                            it using `wlr_buffer_drop`.
+ * @param ud_ptr
+ */
+typedef void (*wlmtk_raster_done_t)(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+
+/**
+ * Creates a pool of rasterization workers.
+ *
+ * @param wl_event_loop_ptr   Event loop to hand back the results. If NULL,
+ *                            the pool is synchronous.
+ * @param threads             Number of worker threads. If 0, the pool is
+ *                            synchronous: Jobs are drawn, and handed back,
+ *                            from within @ref wlmtk_raster_pool_submit.
+ *
+ * @return The pool, or NULL on error. Must be destroyed by calling
+ *     @ref wlmtk_raster_pool_destroy.
+ */
+wlmtk_raster_pool_t *wlmtk_raster_pool_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    unsigned threads);
+
+/**
+ * Destroys the pool. Completes all queued jobs, and hands them back.
+ *
+ * @param pool_ptr
+ */
+void wlmtk_raster_pool_destroy(wlmtk_raster_pool_t *pool_ptr);
+
+/**
+ * Sets the pool for @ref wlmtk_raster_submit to use.
+ *
+ * @param pool_ptr            The pool, or NULL to draw synchronously. Must
+ *                            outlive all elements that submit jobs.
+ */
+void wlmtk_raster_set_pool(wlmtk_raster_pool_t *pool_ptr);
+
+/**
+ * Submits a job, to draw a buffer of `width` x `height`, on the pool set by
+ * @ref wlmtk_raster_set_pool. See @ref wlmtk_raster_pool_submit.
+ */
+bool wlmtk_raster_submit(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr,
+    wlmtk_raster_job_t **job_ptr_ptr);
+
+/**
+ * Submits a job, to draw a buffer of `width` x `height`.
+ *
+ * Elements should keep showing their previous buffer until `done` is called.
+ *
+ * @param pool_ptr            The pool. If NULL, the job is drawn, and handed
+ *                            back, synchronously.
+ * @param width
+ * @param height
+ * @param draw                Draws the buffer. See @ref wlmtk_raster_draw_t.
+ * @param args_ptr            Arguments for `draw`. Will be copied.
+ * @param args_size           Size of the arguments, in bytes.
+ * @param args_fini           Releases resources referenced from the copy of
+ *                            the arguments. Only called if the submission
+ *                            succeeded. May be NULL.
+ * @param done                Called with the drawn buffer.
+ * @param done_ud_ptr         Argument to `done`.
+ * @param job_ptr_ptr         Set to the job, if it is pending. Set to NULL, if
+ *                            the job was completed synchronously. The job
+ *                            remains valid until `done` is called, or until
+ *                            it is cancelled.
+ *
+ * @return true on success. On error, neither `done` nor `args_fini` will
+ *     be called, and the caller keeps ownership of resources referenced from
+ *     `args_ptr`.
+ */
+bool wlmtk_raster_pool_submit(
+    wlmtk_raster_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr,
+    wlmtk_raster_job_t **job_ptr_ptr);
+
+/**
+ * Returns the number of jobs submitted to the pool, ie. the number of buffers
+ * drawn or queued for drawing.
+ *
+ * @param pool_ptr
+ *
+ * @return Number of jobs submitted since the pool was created.
+ */
+size_t wlmtk_raster_pool_submitted_jobs(wlmtk_raster_pool_t *pool_ptr);
+
+/**
+ * Cancels a pending job. `done` will not be called for it.
+ *
+ * @param job_ptr
+ */
+void wlmtk_raster_job_cancel(wlmtk_raster_job_t *job_ptr);
+
+/** Unit test cases. */
+extern const bs_test_set_t wlmtk_raster_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_RASTER_H__ */
+/* == End of raster.h ====================================================== */
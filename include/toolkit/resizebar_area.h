@@ -58,10 +58,12 @@ void wlmtk_resizebar_area_destroy(
     wlmtk_resizebar_area_t *resizebar_area_ptr);
 
 /**
- * Redraws the element, with updated position and width.
+ * Redraws the element, with updated position and width. The buffers are
+ * drawn on the rasterization pool, see @ref wlmtk_raster_submit.
  *
  * @param resizebar_area_ptr
- * @param gfxbuf_ptr
+ * @param resizebar_width     Width of the resizebar. The area draws the
+ *                            resizebar's background at `position`.
  * @param position
  * @param width
  * @param style_ptr
@@ -70,7 +72,7 @@ void wlmtk_resizebar_area_destroy(
  */
 bool wlmtk_resizebar_area_redraw(
     wlmtk_resizebar_area_t *resizebar_area_ptr,
-    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned resizebar_width,
     unsigned position,
     unsigned width,
     const struct wlmtk_resizebar_style *style_ptr);
@@ -111,6 +111,16 @@ void wlmtk_surface_set_activated(
 /** @return Whether the surface is activated. */
 bool wlmtk_surface_is_activated(wlmtk_surface_t *surface_ptr);
 
+/**
+ * Returns whether the surface is fully opaque: Its committed opaque region
+ * covers the entire surface. Subsurfaces are not considered.
+ *
+ * @param surface_ptr
+ *
+ * @return true if opaque.
+ */
+bool wlmtk_surface_is_opaque(wlmtk_surface_t *surface_ptr);
+
 /** Connects a listener and handler to the `map` signal of `wlr_surface`. */
 void wlmtk_surface_connect_map_listener_signal(
     wlmtk_surface_t *surface_ptr,
@@ -26,6 +26,10 @@
 
 /** Forward declaration. */
 struct wlr_output;
+/** Forward declaration. */
+struct wlr_buffer;
+/** Forward declaration. */
+struct wl_event_loop;
 
 #ifdef __cplusplus
 extern "C" {
@@ -49,6 +53,19 @@ extern "C" {
 /** Initializes a struct wlr_output sufficient for testing. */
 void wlmtk_test_wlr_output_init(struct wlr_output *wlr_output_ptr);
 
+/**
+ * Dispatches the event loop until `*wlr_buffer_ptr_ptr` is set, eg. when the
+ * rasterization pool handed back a buffer. Gives up after about a second.
+ *
+ * @param wl_event_loop_ptr
+ * @param wlr_buffer_ptr_ptr
+ *
+ * @return Whether `*wlr_buffer_ptr_ptr` is set.
+ */
+bool wlmtk_test_wait_for_buffer(
+    struct wl_event_loop *wl_event_loop_ptr,
+    struct wlr_buffer **wlr_buffer_ptr_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -25,11 +25,14 @@
 typedef struct _wlmtk_tile_t wlmtk_tile_t;
 /** Forward declaration: Tile virtual method table. */
 typedef struct _wlmtk_tile_vmt_t wlmtk_tile_vmt_t;
+/** Forward declaration: A tile background, shared between tiles. */
+typedef struct _wlmtk_tile_background_t wlmtk_tile_background_t;
 
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <wayland-server-core.h>
 
 #include "buffer.h"
 #include "container.h"
@@ -75,6 +78,13 @@ struct _wlmtk_tile_t {
 
     /** Holds the tile's background, used in @ref wlmtk_tile_t::buffer. */
     struct wlr_buffer         *background_wlr_buffer_ptr;
+    /**
+     * Reference to the background drawn for @ref wlmtk_tile_t::style. Shared
+     * with all other tiles of equal fill, size and bezel width.
+     */
+    wlmtk_tile_background_t   *background_ptr;
+    /** Listens to when @ref wlmtk_tile_t::background_ptr is drawn. */
+    struct wl_listener        background_drawn_listener;
 
     /** References the content element from @ref wlmtk_tile_set_content. */
     wlmtk_element_t           *content_element_ptr;
@@ -116,6 +126,9 @@ void wlmtk_tile_fini(wlmtk_tile_t *tile_ptr);
 /**
  * Updates the style for the tile.
  *
+ * Tiles of equal fill, size and bezel width share the same background buffer.
+ * It is drawn only when the first of these tiles is updated.
+ *
  * @param tile_ptr
  * @param style_ptr
  *
@@ -74,11 +74,12 @@ void wlmtk_titlebar_button_set_activated(
     bool activated);
 
 /**
- * Redraws the titlebar button for given textures, position and style.
+ * Redraws the titlebar button for given position and style. The buffers are
+ * drawn on the rasterization pool, see @ref wlmtk_raster_submit.
  *
  * @param titlebar_button_ptr
- * @param focussed_gfxbuf_ptr
- * @param blurred_gfxbuf_ptr
+ * @param titlebar_width      Width of the titlebar. The button draws the
+ *                            titlebar's background at `position`.
  * @param position
  * @param style_ptr
  *
@@ -86,8 +87,7 @@ void wlmtk_titlebar_button_set_activated(
  */
 bool wlmtk_titlebar_button_redraw(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    unsigned titlebar_width,
     int position,
     const struct wlmtk_titlebar_style *style_ptr);
 
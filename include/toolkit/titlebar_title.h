@@ -54,11 +54,14 @@ void wlmtk_titlebar_title_destroy(
     wlmtk_titlebar_title_t *titlebar_title_ptr);
 
 /**
- * Redraws the title section of the title bar.
+ * Redraws the title section of the title bar, for a change in geometry or
+ * style. Submits the buffer for the current activation state for drawing
+ * right away, the other state is drawn on demand. Drawing happens on the
+ * rasterization pool, see @ref wlmtk_raster_submit.
  *
  * @param titlebar_title_ptr
- * @param focussed_gfxbuf_ptr Titlebar background when focussed.
- * @param blurred_gfxbuf_ptr  Titlebar background when blurred.
+ * @param titlebar_width      Width of the titlebar. The title draws the
+ *                            titlebar's background at `position`.
  * @param position            Position of title telative to titlebar.
  * @param width               Width of title.
  * @param activated           Whether the title bar should start focussed.
@@ -69,14 +72,27 @@ void wlmtk_titlebar_title_destroy(
  */
 bool wlmtk_titlebar_title_redraw(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    unsigned titlebar_width,
     int position,
     int width,
     bool activated,
     const char *title_ptr,
     const struct wlmtk_titlebar_style *style_ptr);
 
+/**
+ * Sets the title text. The redraw is deferred to the next frame of an output
+ * that shows the title, so that frequent changes are coalesced.
+ *
+ * @param titlebar_title_ptr
+ * @param title_ptr           Title, or NULL. Must outlive the element, or
+ *                            until the next call to @ref
+ *                            wlmtk_titlebar_title_set_title or @ref
+ *                            wlmtk_titlebar_title_redraw.
+ */
+void wlmtk_titlebar_title_set_title(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    const char *title_ptr);
+
 /**
  * Sets activation status of the titlebar's title.
  *
@@ -44,6 +44,7 @@
 #include "panel.h"
 #include "popup.h"
 #include "primitives.h"
+#include "raster.h"
 #include "rectangle.h"
 #include "resizebar.h"
 #include "resizebar_area.h"
@@ -93,6 +93,14 @@ typedef struct {
      * Takes a `bool` as argument, specifying whether to enable maximized.
      */
     struct wl_signal          request_maximized;
+
+    /**
+     * Signals that the window's effective visibility changed. Retrieve
+     * through @ref wlmtk_window_is_visible.
+     *
+     * data_ptr points to the window state (@ref wlmtk_window_t).
+     */
+    struct wl_signal          visibility_changed;
 } wlmtk_window_events_t;
 
 /** Style options for the window. */
@@ -406,6 +414,40 @@ void wlmtk_window_request_shaded(wlmtk_window_t *window_ptr, bool shaded);
 /** @return whether the window currently is shaded. */
 bool wlmtk_window_is_shaded(wlmtk_window_t *window_ptr);
 
+/**
+ * Sets whether the window's content is fully opaque. An opaque window hides
+ * the windows it covers, permitting their clients to be suspended.
+ *
+ * @param window_ptr
+ * @param opaque
+ */
+void wlmtk_window_set_opaque(wlmtk_window_t *window_ptr, bool opaque);
+
+/** @return whether the window's content is fully opaque. */
+bool wlmtk_window_is_opaque(wlmtk_window_t *window_ptr);
+
+/**
+ * Sets the window's effective visibility, and signals a change through
+ * @ref wlmtk_window_events_t::visibility_changed. The first visibility set
+ * after mapping is always signalled.
+ *
+ * Protected method, to be called only from @ref wlmtk_workspace_t.
+ *
+ * @param window_ptr
+ * @param visible
+ */
+void wlmtk_window_set_visibility(wlmtk_window_t *window_ptr, bool visible);
+
+/**
+ * Returns whether the window can be seen: It is mapped to an enabled
+ * workspace, is not shaded, and is not fully covered by an opaque window.
+ *
+ * @param window_ptr
+ *
+ * @return true if visible.
+ */
+bool wlmtk_window_is_visible(wlmtk_window_t *window_ptr);
+
 /**
  * En-/Disables the window menu.
  *
@@ -287,6 +287,20 @@ void wlmtk_workspace_raise_window(
     wlmtk_workspace_t *workspace_ptr,
     wlmtk_window_t *window_ptr);
 
+/**
+ * Updates the effective visibility of all mapped windows. See
+ * @ref wlmtk_window_is_visible.
+ *
+ * Called by the workspace when enabled, or when windows are mapped, moved or
+ * restacked; and by windows when their size, shading or opacity changed.
+ *
+ * The update is deferred to an idle callback on the output layout's event
+ * loop, so that a burst of changes is computed only once.
+ *
+ * @param workspace_ptr
+ */
+void wlmtk_workspace_update_visibility(wlmtk_workspace_t *workspace_ptr);
+
 /** @return Pointer to wlmtk_workspace_t::super_container::super_element. */
 wlmtk_element_t *wlmtk_workspace_element(wlmtk_workspace_t *workspace_ptr);
 
@@ -44,6 +44,7 @@
 #include "input/manager.h"
 #include "root_menu.h"
 #include "server.h"
+#include "util/launch_tracker.h"
 #include "util/subprocess_monitor.h"
 #include "toolkit/toolkit.h"
 
@@ -92,6 +93,10 @@ static bool _wlmaker_action_theme_load_from_file(
     wlmaker_server_t *server_ptr,
     const char *fname_ptr);
 
+static void _wlmaker_action_launch(
+    wlmaker_server_t *server_ptr,
+    const char *cmdline_ptr);
+
 /* == Data ================================================================= */
 
 /** Key to lookup the dict from the config dictionary. */
@@ -209,14 +214,13 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
 {
     wlmtk_workspace_t *workspace_ptr, *next_workspace_ptr;
     wlmtk_window_t *window_ptr;
-    const char **argv;
 
     switch (action) {
     case WLMAKER_ACTION_NONE:
         break;
 
     case WLMAKER_ACTION_QUIT:
-        wl_display_terminate(server_ptr->wl_display_ptr);
+        wlmaker_server_terminate(server_ptr);
         break;
 
     case WLMAKER_ACTION_LOCK_SCREEN:
@@ -234,23 +238,16 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
         break;
 
     case WLMAKER_ACTION_LAUNCH_TERMINAL:
-        argv = (const char*[]){ "/bin/sh", "-c", "/usr/bin/foot", NULL };
-        wlm_util_subprocess_monitor_run(
-            server_ptr->monitor_ptr,
-            bs_subprocess_create(argv[0], argv, NULL));
+        _wlmaker_action_launch(server_ptr, "/usr/bin/foot");
         break;
 
     case WLMAKER_ACTION_SHELL_EXECUTE:
-        argv = (const char*[]){ "/bin/sh", "-c", arg_ptr, NULL };
-        wlm_util_subprocess_monitor_run(
-            server_ptr->monitor_ptr,
-            bs_subprocess_create(argv[0], argv, NULL));
+        // Uses the shell only if `arg_ptr` needs it.
+        _wlmaker_action_launch(server_ptr, arg_ptr);
         break;
 
     case WLMAKER_ACTION_EXECUTE:
-        wlm_util_subprocess_monitor_run(
-            server_ptr->monitor_ptr,
-            bs_subprocess_create_cmdline(arg_ptr));
+        _wlmaker_action_launch(server_ptr, arg_ptr);
         break;
 
     case WLMAKER_ACTION_WORKSPACE_TO_PREVIOUS:
@@ -270,7 +267,9 @@ void wlmaker_action_execute(wlmaker_server_t *server_ptr,
             bs_dllist_node_t *bg_ptr = wlmaker_background_create(
                 workspace_ptr,
                 server_ptr->wlr_output_layout_ptr,
-                server_ptr->style_ptr->background_color);
+                server_ptr->style_ptr->background_color,
+                NULL,
+                WLMAKER_BACKGROUND_IMAGE_FILL);
             if (NULL != bg_ptr) {
                 bs_dllist_push_back(&server_ptr->backgrounds, bg_ptr);
                 wlmtk_desktop_add_workspace(server_ptr->desktop_ptr, workspace_ptr);
@@ -701,6 +700,30 @@ bool _wlmaker_action_theme_load_from_file(
     return rv;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Launches `cmdline_ptr`, cedes it to the subprocess monitor and records the
+ * launch for tracking the latency until its first window.
+ */
+void _wlmaker_action_launch(
+    wlmaker_server_t *server_ptr,
+    const char *cmdline_ptr)
+{
+    struct wlm_util_subprocess *subprocess_handle_ptr =
+        wlm_util_subprocess_monitor_spawn(
+            server_ptr->monitor_ptr, cmdline_ptr, NULL, NULL, NULL);
+    if (NULL == subprocess_handle_ptr) {
+        bs_log(BS_WARNING, "Failed to launch \"%s\".", cmdline_ptr);
+        return;
+    }
+    wlm_util_launch_tracker_launched(
+        server_ptr->launch_tracker_ptr,
+        wlm_util_subprocess_pid(subprocess_handle_ptr),
+        cmdline_ptr);
+    wlm_util_subprocess_monitor_cede(
+        server_ptr->monitor_ptr, subprocess_handle_ptr);
+}
+
 /* == Unit tests =========================================================== */
 
 static void test_keybindings_parse(bs_test_t *test_ptr);
@@ -28,7 +28,6 @@
 #include <stdlib.h>
 #include <sys/stat.h>
 #include <toolkit/toolkit.h>
-#include <unistd.h>
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
@@ -40,6 +39,7 @@
 #include <wlr/types/wlr_compositor.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_output_power_management_v1.h>
 #include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_screencopy_v1.h>
 #include <wlr/types/wlr_subcompositor.h>
@@ -48,6 +48,8 @@
 #include "output.h"
 #include "output_config.h"
 #include "output_manager.h"
+#include "util/persist.h"
+#include "wlr-output-power-management-unstable-v1-protocol.h"
 
 /* == Declarations ========================================================= */
 
@@ -74,9 +76,13 @@ struct _wlmbe_backend_t {
     struct wlr_screencopy_manager_v1 *wlr_screencopy_manager_v1_ptr;
     /** The output manager(s). */
     wlmbe_output_manager_t    *output_manager_ptr;
+    /** Output power management, for idle daemons. */
+    struct wlr_output_power_manager_v1 *wlr_output_power_manager_v1_ptr;
 
     /** Listener for wlr_backend::events::new_output. */
     struct wl_listener        new_output_listener;
+    /** Listener for wlr_output_power_manager_v1::events::set_mode. */
+    struct wl_listener        output_power_set_mode_listener;
 
     /** Desired output width, for windowed mode. 0 for no preference. */
     uint32_t                  width;
@@ -118,11 +124,16 @@ struct _wlmbe_backend_t {
 
     /** Name of the file for storing the output's state. */
     char                      *state_fname_ptr;
+    /** Writes the output's state into the file, off the event loop. */
+    wlm_util_persist_t        *state_persist_ptr;
 };
 
 static void _wlmbe_backend_handle_new_output(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmbe_backend_handle_output_power_set_mode(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 static bool _wlmbe_backend_decode_item(
     bspl_object_t *obj_ptr,
@@ -135,6 +146,10 @@ static void _wlmbe_backend_decode_fini(void *dest_ptr);
 static void _wlmbe_backend_config_dlnode_destroy(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static bool _wlmbe_backend_serialize_state(
+    bs_dynbuf_t *dynbuf_ptr,
+    void *ud_ptr);
+static void _wlmbe_backend_handle_state_saved(bool success, void *ud_ptr);
 
 /* == Data ================================================================= */
 
@@ -221,6 +236,17 @@ wlmbe_backend_t *wlmbe_backend_create(
         }
         bs_log(BS_INFO, "Loaded output state from \"%s\"", state_fname_ptr);
     }
+    backend_ptr->state_persist_ptr = wlm_util_persist_create(
+        wl_display_get_event_loop(wl_display_ptr),
+        backend_ptr->state_fname_ptr,
+        S_IRUSR | S_IWUSR,
+        _wlmbe_backend_serialize_state,
+        _wlmbe_backend_handle_state_saved,
+        backend_ptr);
+    if (NULL == backend_ptr->state_persist_ptr) {
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
 
     // Auto-create the wlroots backend. Can be X11 or direct.
     backend_ptr->wlr_backend_ptr = wlr_backend_autocreate(
@@ -299,6 +325,19 @@ wlmbe_backend_t *wlmbe_backend_create(
         return NULL;
     }
 
+    backend_ptr->wlr_output_power_manager_v1_ptr =
+        wlr_output_power_manager_v1_create(wl_display_ptr);
+    if (NULL == backend_ptr->wlr_output_power_manager_v1_ptr) {
+        bs_log(BS_ERROR, "Failed wlr_output_power_manager_v1_create(%p)",
+               wl_display_ptr);
+        wlmbe_backend_destroy(backend_ptr);
+        return NULL;
+    }
+    wlmtk_util_connect_listener_signal(
+        &backend_ptr->wlr_output_power_manager_v1_ptr->events.set_mode,
+        &backend_ptr->output_power_set_mode_listener,
+        _wlmbe_backend_handle_output_power_set_mode);
+
     wlmtk_util_connect_listener_signal(
         &backend_ptr->wlr_backend_ptr->events.new_output,
         &backend_ptr->new_output_listener,
@@ -311,6 +350,15 @@ wlmbe_backend_t *wlmbe_backend_create(
 void wlmbe_backend_destroy(wlmbe_backend_t *backend_ptr)
 {
     wlmtk_util_disconnect_listener(&backend_ptr->new_output_listener);
+    // The power manager itself is destroyed with the wl_display.
+    wlmtk_util_disconnect_listener(
+        &backend_ptr->output_power_set_mode_listener);
+
+    // Writes a pending save. Needs the ephemeral output configs.
+    if (NULL != backend_ptr->state_persist_ptr) {
+        wlm_util_persist_destroy(backend_ptr->state_persist_ptr);
+        backend_ptr->state_persist_ptr = NULL;
+    }
 
     if (NULL != backend_ptr->output_manager_ptr) {
         wlmbe_output_manager_destroy(backend_ptr->output_manager_ptr);
@@ -403,28 +451,22 @@ void wlmbe_backend_reduce(wlmbe_backend_t *backend_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-bool wlmbe_backend_save_ephemeral_output_configs(wlmbe_backend_t *backend_ptr)
+bool wlmbe_backend_set_power(wlmbe_backend_t *backend_ptr, bool on)
 {
-    bspl_dict_t *dict_ptr = bspl_encode_dict(
-        _wlmbe_outputs_state_desc,
-        backend_ptr);
-    if (NULL != dict_ptr) {
-        bs_dynbuf_t dynbuf = {};
-        if (bs_dynbuf_init(&dynbuf, getpagesize(), SIZE_MAX)) {
-            if (bspl_object_write(
-                    bspl_object_from_dict(dict_ptr),
-                    &dynbuf) &&
-                bs_dynbuf_write_file(
-                    &dynbuf,
-                    backend_ptr->state_fname_ptr,
-                    S_IRUSR | S_IWUSR)) {
-                return true;
-            }
-            bs_dynbuf_fini(&dynbuf);
-        }
-        bspl_dict_unref(dict_ptr);
+    bool rv = true;
+    for (bs_dllist_node_t *dlnode_ptr = backend_ptr->outputs.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        rv = wlmbe_output_set_power(
+            wlmbe_output_from_dlnode(dlnode_ptr), on) && rv;
     }
-    return false;
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_backend_save_ephemeral_output_configs(wlmbe_backend_t *backend_ptr)
+{
+    return wlm_util_persist_save(backend_ptr->state_persist_ptr);
 }
 
 /* == Local (static) methods =============================================== */
@@ -555,6 +597,28 @@ void _wlmbe_backend_handle_new_output(
     wlr_output_destroy(wlr_output_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `set_mode` of the output power manager: A client, eg. an idle
+ * daemon, powers an output on or off.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a
+ *                            `struct wlr_output_power_v1_set_mode_event`.
+ */
+void _wlmbe_backend_handle_output_power_set_mode(
+    __UNUSED__ struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    const struct wlr_output_power_v1_set_mode_event *event_ptr = data_ptr;
+    wlmbe_output_t *output_ptr = event_ptr->output->data;
+    if (NULL == output_ptr) return;
+
+    wlmbe_output_set_power(
+        output_ptr,
+        ZWLR_OUTPUT_POWER_V1_MODE_ON == event_ptr->mode);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Decodes an item of `Outputs`. */
 bool _wlmbe_backend_decode_item(
@@ -645,6 +709,42 @@ void _wlmbe_backend_config_dlnode_destroy(
     wlmbe_output_config_destroy(wlmbe_output_config_from_dlnode(dlnode_ptr));
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Serializes the ephemeral output configs into `dynbuf_ptr`, as plist. Called
+ * by @ref wlmbe_backend_t::state_persist_ptr, on the event loop's thread.
+ *
+ * @param dynbuf_ptr
+ * @param ud_ptr              The @ref wlmbe_backend_t.
+ *
+ * @return true on success.
+ */
+bool _wlmbe_backend_serialize_state(bs_dynbuf_t *dynbuf_ptr, void *ud_ptr)
+{
+    wlmbe_backend_t *backend_ptr = ud_ptr;
+    bspl_dict_t *dict_ptr = bspl_encode_dict(
+        _wlmbe_outputs_state_desc,
+        backend_ptr);
+    if (NULL == dict_ptr) return false;
+    bool rv = bspl_object_write(bspl_object_from_dict(dict_ptr), dynbuf_ptr);
+    bspl_dict_unref(dict_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Logs the outcome of writing the state file. */
+void _wlmbe_backend_handle_state_saved(bool success, void *ud_ptr)
+{
+    wlmbe_backend_t *backend_ptr = ud_ptr;
+    if (success) {
+        bs_log(BS_INFO, "Saved output state to \"%s\"",
+               backend_ptr->state_fname_ptr);
+    } else {
+        bs_log(BS_WARNING, "Failed to save output state to \"%s\"",
+               backend_ptr->state_fname_ptr);
+    }
+}
+
 /* == Unit tests =========================================================== */
 
 static void _wlmbe_backend_test_find(bs_test_t *test_ptr);
@@ -31,15 +31,32 @@
 #include <wayland-server-core.h>
 #include <wayland-util.h>
 #define WLR_USE_UNSTABLE
+#include <wlr/backend/headless.h>
 #include <wlr/backend/wayland.h>
 #include <wlr/backend/x11.h>
 #include <wlr/render/allocator.h>
+#include <wlr/render/pixman.h>
+#include <wlr/render/wlr_renderer.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_scene.h>
 #undef WLR_USE_UNSTABLE
 
 /* == Declarations ========================================================= */
 
+/** State for scheduling the output's rendering close to the vblank. */
+typedef struct {
+    /** Learned render time, in nanoseconds. Decays slowly towards samples. */
+    uint64_t                  render_nsec;
+    /** Refresh period, in nanoseconds. 0 if unknown. */
+    uint64_t                  period_nsec;
+    /** Time of the most recent presentation, in nanoseconds. 0 if unknown. */
+    uint64_t                  vblank_nsec;
+    /** Number of frames left to render immediately, after a missed frame. */
+    unsigned                  fallback_frames;
+    /** Statistics. */
+    wlmbe_output_frame_stats_t stats;
+} wlmbe_frame_timing_t;
+
 /** Handle for a compositor output device. */
 struct _wlmbe_output_t {
     /** List node for insertion in @ref wlmbe_backend_t::outputs. */
@@ -51,6 +68,39 @@ struct _wlmbe_output_t {
     struct wl_listener        output_frame_listener;
     /** Listener for `request_state` signals raised by `wlr_output`. */
     struct wl_listener        output_request_state_listener;
+    /** Listener for `present` signals raised by `wlr_output`. */
+    struct wl_listener        output_present_listener;
+    /** Listener for `commit` signals raised by `wlr_output`. */
+    struct wl_listener        output_commit_listener;
+
+    /** Timer for postponed rendering. See @ref wlmbe_output_frame_stats_t. */
+    struct wl_event_source    *render_timer_ptr;
+    /** Whether a postponed render is pending on @ref render_timer_ptr. */
+    bool                      render_pending;
+    /** Delay of the pending render, in nanoseconds. */
+    uint64_t                  render_delay_nsec;
+    /** By when the pending render must have completed, in nanoseconds. */
+    uint64_t                  render_deadline_nsec;
+    /** Frame scheduling state. */
+    wlmbe_frame_timing_t      timing;
+    /** Clock for frame scheduling. Overridden in tests. */
+    uint64_t                  (*now_nsec)(void);
+
+    /** Whether the output is powered off. No rendering happens then. */
+    bool                      powered_off;
+    /** Whether @ref wlmbe_output_set_power is committing the output state. */
+    bool                      power_committing;
+    /** Mode to restore when powering on. NULL if it had a custom mode. */
+    struct wlr_output_mode    *power_mode_ptr;
+    /** Custom mode to restore when powering on, if width > 0. */
+    struct {
+        /** Width, in pixels. */
+        int32_t               width;
+        /** Height, in pixels. */
+        int32_t               height;
+        /** Refresh rate, in mHz. */
+        int32_t               refresh;
+    } power_custom_mode;
 
     /** Descriptive name, showing manufacturer, model and serial. */
     char                      *description_ptr;
@@ -73,9 +123,37 @@ static void _wlmbe_output_handle_frame(
 static void _wlmbe_output_handle_request_state(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmbe_output_handle_present(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmbe_output_handle_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static int _wlmbe_output_handle_render_timer(void *data_ptr);
+static void _wlmbe_output_render(wlmbe_output_t *output_ptr);
+static uint64_t _wlmbe_output_monotonic_nsec(void);
+
+static uint64_t _wlmbe_frame_timing_delay(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t budget_nsec,
+    uint64_t now_nsec,
+    uint64_t *deadline_nsec_ptr);
+static void _wlmbe_frame_timing_rendered(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t start_nsec,
+    uint64_t end_nsec,
+    uint64_t delay_nsec,
+    uint64_t deadline_nsec);
+static void _wlmbe_frame_timing_presented(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t when_nsec,
+    uint64_t period_nsec);
 
 /* == Data ================================================================= */
 
+/** Number of frames to render immediately, after a missed deadline. */
+static const unsigned _wlmbe_output_fallback_frames = 60;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -94,6 +172,7 @@ wlmbe_output_t *wlmbe_output_create(
     output_ptr->wlr_scene_ptr = wlr_scene_ptr;
     output_ptr->output_config_ptr = config_ptr;
     output_ptr->wlr_output_ptr->data = output_ptr;
+    output_ptr->now_nsec = _wlmbe_output_monotonic_nsec;
 
     output_ptr->description_ptr = bs_strdupf(
         "\"%s\": Manufacturer: \"%s\", Model \"%s\", Serial \"%s\"",
@@ -118,6 +197,27 @@ wlmbe_output_t *wlmbe_output_create(
         &output_ptr->wlr_output_ptr->events.request_state,
         &output_ptr->output_request_state_listener,
         _wlmbe_output_handle_request_state);
+    wlmtk_util_connect_listener_signal(
+        &output_ptr->wlr_output_ptr->events.present,
+        &output_ptr->output_present_listener,
+        _wlmbe_output_handle_present);
+    wlmtk_util_connect_listener_signal(
+        &output_ptr->wlr_output_ptr->events.commit,
+        &output_ptr->output_commit_listener,
+        _wlmbe_output_handle_commit);
+
+    output_ptr->render_timer_ptr = wl_event_loop_add_timer(
+        wlr_output_ptr->event_loop,
+        _wlmbe_output_handle_render_timer,
+        output_ptr);
+    if (NULL == output_ptr->render_timer_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               wlr_output_ptr->event_loop,
+               _wlmbe_output_handle_render_timer,
+               output_ptr);
+        wlmbe_output_destroy(output_ptr);
+        return NULL;
+    }
 
     // From tinwywl: Configures the output created by the backend to use our
     // allocator and our renderer. Must be done once, before commiting the
@@ -197,6 +297,10 @@ wlmbe_output_t *wlmbe_output_create(
         return NULL;
     }
 
+    if (0 < wlr_output_ptr->refresh) {
+        output_ptr->timing.period_nsec =
+            UINT64_C(1000000000000) / (uint64_t)wlr_output_ptr->refresh;
+    }
     return output_ptr;
 }
 
@@ -248,6 +352,67 @@ void wlmbe_output_update_attributes(
         x, y, has_position);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmbe_output_set_power(wlmbe_output_t *output_ptr, bool on)
+{
+    struct wlr_output *wlr_output_ptr = output_ptr->wlr_output_ptr;
+    if (output_ptr->powered_off != on) return true;
+    // Outputs disabled by configuration are left alone.
+    if (!output_ptr->powered_off && !wlr_output_ptr->enabled) return true;
+
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_enabled(&state, on);
+    if (!on) {
+        output_ptr->power_mode_ptr = wlr_output_ptr->current_mode;
+        output_ptr->power_custom_mode.width = wlr_output_ptr->width;
+        output_ptr->power_custom_mode.height = wlr_output_ptr->height;
+        output_ptr->power_custom_mode.refresh = wlr_output_ptr->refresh;
+    } else if (NULL != output_ptr->power_mode_ptr) {
+        wlr_output_state_set_mode(&state, output_ptr->power_mode_ptr);
+    } else if (0 < output_ptr->power_custom_mode.width) {
+        wlr_output_state_set_custom_mode(
+            &state,
+            output_ptr->power_custom_mode.width,
+            output_ptr->power_custom_mode.height,
+            output_ptr->power_custom_mode.refresh);
+    }
+    output_ptr->power_committing = true;
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    output_ptr->power_committing = false;
+    wlr_output_state_finish(&state);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed to power %s output %s",
+               on ? "on" : "off", wlr_output_ptr->name);
+        return false;
+    }
+
+    output_ptr->powered_off = !on;
+    if (output_ptr->powered_off) {
+        // Drops a postponed render. Clients get no frame-done meanwhile.
+        output_ptr->render_pending = false;
+        wl_event_source_timer_update(output_ptr->render_timer_ptr, 0);
+    } else {
+        wlr_output_schedule_frame(wlr_output_ptr);
+    }
+    bs_log(BS_INFO, "Powered %s output %s", on ? "on" : "off",
+           wlr_output_ptr->name);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmbe_output_powered_off(wlmbe_output_t *output_ptr)
+{
+    return output_ptr->powered_off;
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmbe_output_frame_stats_t *wlmbe_output_frame_stats(
+    wlmbe_output_t *output_ptr)
+{
+    return &output_ptr->timing.stats;
+}
+
 /* ------------------------------------------------------------------------- */
 bs_dllist_node_t *wlmbe_dlnode_from_output(wlmbe_output_t *output_ptr)
 {
@@ -277,6 +442,14 @@ void _wlmbe_output_handle_destroy(
     wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmbe_output_t, output_destroy_listener);
 
+    if (NULL != output_ptr->render_timer_ptr) {
+        wl_event_source_remove(output_ptr->render_timer_ptr);
+        output_ptr->render_timer_ptr = NULL;
+    }
+    output_ptr->render_pending = false;
+
+    wlmtk_util_disconnect_listener(&output_ptr->output_commit_listener);
+    wlmtk_util_disconnect_listener(&output_ptr->output_present_listener);
     wlmtk_util_disconnect_listener(&output_ptr->output_request_state_listener);
     wlmtk_util_disconnect_listener(&output_ptr->output_frame_listener);
     wlmtk_util_disconnect_listener(&output_ptr->output_destroy_listener);
@@ -287,6 +460,10 @@ void _wlmbe_output_handle_destroy(
 /**
  * Event handler for the `frame` signal raised by `wlr_output`.
  *
+ * Renders right away, unless the output has a 'MaxRenderTime' configured: Then
+ * rendering is postponed until just before the predicted vblank, so that
+ * client content arriving meanwhile still makes it into this frame.
+ *
  * @param listener_ptr
  * @param data_ptr
  */
@@ -296,17 +473,194 @@ void _wlmbe_output_handle_frame(
 {
     wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmbe_output_t, output_frame_listener);
+    if (output_ptr->render_pending || output_ptr->powered_off) return;
+
+    const wlmbe_output_config_attributes_t *attr_ptr =
+        wlmbe_output_config_attributes(output_ptr->output_config_ptr);
+    uint64_t deadline_nsec = 0;
+    uint64_t delay_nsec = _wlmbe_frame_timing_delay(
+        &output_ptr->timing,
+        attr_ptr->max_render_time * 1000000,
+        output_ptr->now_nsec(),
+        &deadline_nsec);
+
+    // The timer is millisecond-granular, and a 0 timeout would disarm it.
+    int delay_msec = delay_nsec / 1000000;
+    if (0 < delay_msec) {
+        output_ptr->render_pending = true;
+        output_ptr->render_delay_nsec = (uint64_t)delay_msec * 1000000;
+        output_ptr->render_deadline_nsec = deadline_nsec;
+        wl_event_source_timer_update(output_ptr->render_timer_ptr, delay_msec);
+        return;
+    }
+
+    output_ptr->render_delay_nsec = 0;
+    output_ptr->render_deadline_nsec = deadline_nsec;
+    _wlmbe_output_render(output_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `present` signal raised by `wlr_output`. Tracks the
+ * vblank timestamp and refresh period, for predicting the next vblank.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_event_present`.
+ */
+void _wlmbe_output_handle_present(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_output_t, output_present_listener);
+    const struct wlr_output_event_present *event_ptr = data_ptr;
+    if (!event_ptr->presented) return;
+
+    _wlmbe_frame_timing_presented(
+        &output_ptr->timing,
+        (uint64_t)event_ptr->when.tv_sec * 1000000000 +
+        (uint64_t)event_ptr->when.tv_nsec,
+        0 < event_ptr->refresh ? (uint64_t)event_ptr->refresh : 0);
+}
 
+/* ------------------------------------------------------------------------- */
+/** Timer callback: Renders the postponed frame. */
+int _wlmbe_output_handle_render_timer(void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = data_ptr;
+    if (!output_ptr->render_pending) return 0;
+    output_ptr->render_pending = false;
+    _wlmbe_output_render(output_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Commits the scene to the output, and sends frame-done to all clients. */
+void _wlmbe_output_render(wlmbe_output_t *output_ptr)
+{
+    if (output_ptr->powered_off) return;
     struct wlr_scene_output *wlr_scene_output_ptr = wlr_scene_get_scene_output(
         output_ptr->wlr_scene_ptr,
         output_ptr->wlr_output_ptr);
+    if (NULL == wlr_scene_output_ptr) return;
+
+    uint64_t start_nsec = output_ptr->now_nsec();
     wlr_scene_output_commit(wlr_scene_output_ptr, NULL);
+    _wlmbe_frame_timing_rendered(
+        &output_ptr->timing,
+        start_nsec,
+        output_ptr->now_nsec(),
+        output_ptr->render_delay_nsec,
+        output_ptr->render_deadline_nsec);
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
     wlr_scene_output_send_frame_done(wlr_scene_output_ptr, &now);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Returns CLOCK_MONOTONIC, in nanoseconds. */
+uint64_t _wlmbe_output_monotonic_nsec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes by how long to postpone rendering, so that it completes just
+ * before the predicted next vblank.
+ *
+ * The time reserved for rendering is the larger of the configured budget and
+ * 1.5x the learned render time.
+ *
+ * @param timing_ptr
+ * @param budget_nsec         Configured render budget. 0 disables postponing.
+ * @param now_nsec
+ * @param deadline_nsec_ptr   Set to the predicted next vblank, or to 0 if no
+ *                            deadline applies.
+ *
+ * @return The delay, in nanoseconds. 0 to render right away.
+ */
+uint64_t _wlmbe_frame_timing_delay(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t budget_nsec,
+    uint64_t now_nsec,
+    uint64_t *deadline_nsec_ptr)
+{
+    *deadline_nsec_ptr = 0;
+    if (0 == budget_nsec ||
+        0 == timing_ptr->period_nsec ||
+        0 == timing_ptr->vblank_nsec) return 0;
+
+    uint64_t next_nsec = timing_ptr->vblank_nsec;
+    if (next_nsec <= now_nsec) {
+        next_nsec += timing_ptr->period_nsec *
+            ((now_nsec - next_nsec) / timing_ptr->period_nsec + 1);
+    }
+    *deadline_nsec_ptr = next_nsec;
+    if (0 < timing_ptr->fallback_frames) return 0;
+
+    uint64_t needed_nsec = BS_MAX(
+        budget_nsec,
+        timing_ptr->render_nsec + timing_ptr->render_nsec / 2);
+    if (now_nsec + needed_nsec >= next_nsec) return 0;
+    return next_nsec - needed_nsec - now_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Accounts for a rendered frame: Updates the learned render time and the
+ * statistics, and falls back to immediate rendering on a missed deadline.
+ *
+ * @param timing_ptr
+ * @param start_nsec
+ * @param end_nsec
+ * @param delay_nsec          By how long rendering had been postponed.
+ * @param deadline_nsec       Predicted vblank, or 0 if unknown.
+ */
+void _wlmbe_frame_timing_rendered(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t start_nsec,
+    uint64_t end_nsec,
+    uint64_t delay_nsec,
+    uint64_t deadline_nsec)
+{
+    uint64_t render_nsec = end_nsec > start_nsec ? end_nsec - start_nsec : 0;
+    if (render_nsec >= timing_ptr->render_nsec) {
+        timing_ptr->render_nsec = render_nsec;
+    } else {
+        timing_ptr->render_nsec -= (timing_ptr->render_nsec - render_nsec) / 16;
+    }
+
+    timing_ptr->stats.frames++;
+    if (0 == delay_nsec) {
+        if (0 < timing_ptr->fallback_frames) timing_ptr->fallback_frames--;
+        return;
+    }
+
+    timing_ptr->stats.delayed_frames++;
+    if (0 < deadline_nsec && end_nsec > deadline_nsec) {
+        // Postponed too far: The frame slips by a full refresh cycle.
+        timing_ptr->stats.missed_frames++;
+        timing_ptr->fallback_frames = _wlmbe_output_fallback_frames;
+        return;
+    }
+    timing_ptr->stats.saved_nsec += delay_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records the vblank time and, if known, the refresh period. */
+void _wlmbe_frame_timing_presented(
+    wlmbe_frame_timing_t *timing_ptr,
+    uint64_t when_nsec,
+    uint64_t period_nsec)
+{
+    timing_ptr->vblank_nsec = when_nsec;
+    if (0 < period_nsec) timing_ptr->period_nsec = period_nsec;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Event handler for the `request_state` signal raised by `wlr_output`.
@@ -331,4 +685,305 @@ void _wlmbe_output_handle_request_state(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Event handler for the `commit` signal raised by `wlr_output`.
+ *
+ * Enabling or disabling the output from elsewhere than
+ * @ref wlmbe_output_set_power (eg. through output management or a backend's
+ * `request_state`) supersedes the power state: The output is no longer
+ * considered as powered off, and renders again if it got enabled.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to a `struct wlr_output_event_commit`.
+ */
+void _wlmbe_output_handle_commit(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmbe_output_t *output_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmbe_output_t, output_commit_listener);
+    const struct wlr_output_event_commit *event_ptr = data_ptr;
+
+    if (output_ptr->power_committing ||
+        !output_ptr->powered_off ||
+        !(event_ptr->state->committed & WLR_OUTPUT_STATE_ENABLED)) return;
+
+    output_ptr->powered_off = false;
+    if (output_ptr->wlr_output_ptr->enabled) {
+        wlr_output_schedule_frame(output_ptr->wlr_output_ptr);
+    }
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmbe_output_test_frame_timing(bs_test_t *test_ptr);
+static void _wlmbe_output_test_late_latch(bs_test_t *test_ptr);
+static void _wlmbe_output_test_power(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlmbe_output_test_cases[] = {
+    { 1, "frame_timing", _wlmbe_output_test_frame_timing },
+    { 1, "late_latch", _wlmbe_output_test_late_latch },
+    { 1, "power", _wlmbe_output_test_power },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmbe_output_test_set = BS_TEST_SET(
+    true, "output", _wlmbe_output_test_cases);
+
+/** Fake clock for the tests, in nanoseconds. */
+static uint64_t _wlmbe_output_test_nsec;
+
+/* ------------------------------------------------------------------------- */
+/** Returns @ref _wlmbe_output_test_nsec. */
+static uint64_t _wlmbe_output_test_now_nsec(void)
+{
+    return _wlmbe_output_test_nsec;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the scheduling computations, at 60Hz with a 4ms budget. */
+void _wlmbe_output_test_frame_timing(bs_test_t *test_ptr)
+{
+    wlmbe_frame_timing_t t = {};
+    uint64_t deadline = 0;
+    const uint64_t ms = 1000000;
+
+    // Without a known vblank or budget: Render right away.
+    BS_TEST_VERIFY_EQ(test_ptr, 0,
+                      _wlmbe_frame_timing_delay(&t, 4 * ms, 1000 * ms,
+                                                &deadline));
+    _wlmbe_frame_timing_presented(&t, 1000 * ms, 16666667);
+    BS_TEST_VERIFY_EQ(test_ptr, 0,
+                      _wlmbe_frame_timing_delay(&t, 0, 1000 * ms, &deadline));
+
+    // Frame event 1ms after vblank: Postpone by ~11.67ms.
+    uint64_t d = _wlmbe_frame_timing_delay(&t, 4 * ms, 1001 * ms, &deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 1000 * ms + 16666667, deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 16666667 - 5 * ms, d);
+    _wlmbe_frame_timing_rendered(
+        &t, 1001 * ms + d, 1003 * ms + d, d, deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.stats.delayed_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t.stats.missed_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, d, t.stats.saved_nsec);
+    BS_TEST_VERIFY_EQ(test_ptr, 2 * ms, t.render_nsec);
+
+    // A slow render raises the estimate beyond the budget: Less delay.
+    _wlmbe_frame_timing_rendered(&t, 0, 6 * ms, 0, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 6 * ms, t.render_nsec);
+    d = _wlmbe_frame_timing_delay(&t, 4 * ms, 1001 * ms, &deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 16666667 - 10 * ms, d);
+
+    // Several periods later: The deadline follows the vblank grid.
+    _wlmbe_frame_timing_delay(&t, 4 * ms, 1051 * ms, &deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 1000 * ms + 4 * 16666667, deadline);
+
+    // Missing the deadline falls back to immediate rendering.
+    d = _wlmbe_frame_timing_delay(&t, 4 * ms, 1001 * ms, &deadline);
+    _wlmbe_frame_timing_rendered(
+        &t, 1001 * ms + d, deadline + 1, d, deadline);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.stats.missed_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, _wlmbe_output_fallback_frames,
+                      t.fallback_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 0,
+                      _wlmbe_frame_timing_delay(&t, 4 * ms, 1001 * ms,
+                                                &deadline));
+    for (unsigned i = 0; i < _wlmbe_output_fallback_frames; ++i) {
+        _wlmbe_frame_timing_rendered(&t, 0, 0, 0, deadline);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t.fallback_frames);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0,
+                       _wlmbe_frame_timing_delay(&t, 4 * ms, 1001 * ms,
+                                                 &deadline));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies that a headless output with 'MaxRenderTime' postpones the commit
+ * to the timer, and accounts for the time saved. Uses a fake clock.
+ */
+void _wlmbe_output_test_late_latch(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_backend *backend_ptr = wlr_headless_backend_create(
+        wl_display_get_event_loop(display_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, backend_ptr);
+    struct wlr_renderer *renderer_ptr = wlr_pixman_renderer_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, renderer_ptr);
+    struct wlr_allocator *allocator_ptr = wlr_allocator_autocreate(
+        backend_ptr, renderer_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, allocator_ptr);
+    struct wlr_scene *scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, scene_ptr);
+
+    struct wlr_output *wlr_output_ptr = wlr_headless_add_output(
+        backend_ptr, 640, 480);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_ptr);
+    wlmbe_output_config_t *config_ptr = wlmbe_output_config_create_from_wlr(
+        wlr_output_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, config_ptr);
+    const wlmbe_output_config_attributes_t attr = {
+        .transformation = WL_OUTPUT_TRANSFORM_NORMAL,
+        .scale = 1.0,
+        .enabled = true,
+        .max_render_time = 4
+    };
+    wlmbe_output_config_apply_attributes(config_ptr, &attr);
+    wlmbe_output_t *output_ptr = wlmbe_output_create(
+        wlr_output_ptr, allocator_ptr, renderer_ptr, scene_ptr,
+        config_ptr, 0, 0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, output_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(
+        test_ptr, NULL, wlr_scene_output_create(scene_ptr, wlr_output_ptr));
+
+    wlmtk_util_test_listener_t commit;
+    wlmtk_util_connect_test_listener(&wlr_output_ptr->events.commit, &commit);
+
+    // A vblank at 1s, 60Hz. The frame event arrives 1ms later.
+    output_ptr->now_nsec = _wlmbe_output_test_now_nsec;
+    _wlmbe_frame_timing_presented(&output_ptr->timing, 1000000000, 16666667);
+    _wlmbe_output_test_nsec = 1001000000;
+    wl_signal_emit(&wlr_output_ptr->events.frame, wlr_output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, commit.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, output_ptr->render_pending);
+
+    // A second frame event while pending is ignored.
+    wl_signal_emit(&wlr_output_ptr->events.frame, wlr_output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, commit.calls);
+
+    // Timer fires 11ms later (millisecond-granular): Renders, within budget.
+    _wlmbe_output_test_nsec += 11000000;
+    _wlmbe_output_handle_render_timer(output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, commit.calls);
+    BS_TEST_VERIFY_FALSE(test_ptr, output_ptr->render_pending);
+
+    const wlmbe_output_frame_stats_t *stats_ptr = wlmbe_output_frame_stats(
+        output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->delayed_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats_ptr->missed_frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 11000000, stats_ptr->saved_nsec);
+
+    wlmtk_util_disconnect_test_listener(&commit);
+    wlmbe_output_destroy(output_ptr);
+    wlmbe_output_config_destroy(config_ptr);
+    wlr_scene_node_destroy(&scene_ptr->tree.node);
+    wlr_allocator_destroy(allocator_ptr);
+    wlr_renderer_destroy(renderer_ptr);
+    wlr_backend_destroy(backend_ptr);
+    wl_display_destroy(display_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies that a powered-off headless output does not commit any frame, and
+ * that enabling it from elsewhere clears the power state.
+ */
+void _wlmbe_output_test_power(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_backend *backend_ptr = wlr_headless_backend_create(
+        wl_display_get_event_loop(display_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, backend_ptr);
+    struct wlr_renderer *renderer_ptr = wlr_pixman_renderer_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, renderer_ptr);
+    struct wlr_allocator *allocator_ptr = wlr_allocator_autocreate(
+        backend_ptr, renderer_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, allocator_ptr);
+    struct wlr_scene *scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, scene_ptr);
+
+    struct wlr_output *wlr_output_ptr = wlr_headless_add_output(
+        backend_ptr, 640, 480);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_output_ptr);
+    wlmbe_output_config_t *config_ptr = wlmbe_output_config_create_from_wlr(
+        wlr_output_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, config_ptr);
+    const wlmbe_output_config_attributes_t attr = {
+        .transformation = WL_OUTPUT_TRANSFORM_NORMAL,
+        .scale = 1.0,
+        .enabled = true
+    };
+    wlmbe_output_config_apply_attributes(config_ptr, &attr);
+    wlmbe_output_t *output_ptr = wlmbe_output_create(
+        wlr_output_ptr, allocator_ptr, renderer_ptr, scene_ptr,
+        config_ptr, 0, 0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, output_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(
+        test_ptr, NULL, wlr_scene_output_create(scene_ptr, wlr_output_ptr));
+
+    wlmtk_util_test_listener_t commit;
+    wlmtk_util_connect_test_listener(&wlr_output_ptr->events.commit, &commit);
+
+    // Powering off commits once. Again: A no-op.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, false));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, false));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, commit.calls);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlr_output_ptr->enabled);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_powered_off(output_ptr));
+
+    // While off: Frame events and the render timer do not commit.
+    wlmtk_util_clear_test_listener(&commit);
+    for (int i = 0; i < 3; ++i) {
+        wl_signal_emit(&wlr_output_ptr->events.frame, wlr_output_ptr);
+        _wlmbe_output_handle_render_timer(output_ptr);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, commit.calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wlmbe_output_frame_stats(output_ptr)->frames);
+
+    // Powering on restores the output, and frames commit again.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, true));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, commit.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlr_output_ptr->enabled);
+    BS_TEST_VERIFY_EQ(test_ptr, 640, wlr_output_ptr->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 480, wlr_output_ptr->height);
+    wl_signal_emit(&wlr_output_ptr->events.frame, wlr_output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, commit.calls);
+
+    // Powered off, then enabled through `request_state`: No longer off.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, false));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_powered_off(output_ptr));
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_enabled(&state, true);
+    wlr_output_state_set_custom_mode(&state, 640, 480, 0);
+    struct wlr_output_event_request_state event = {
+        .output = wlr_output_ptr, .state = &state };
+    wl_signal_emit(&wlr_output_ptr->events.request_state, &event);
+    wlr_output_state_finish(&state);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlr_output_ptr->enabled);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_output_powered_off(output_ptr));
+
+    // Powering on is then a no-op, and frames commit.
+    wlmtk_util_clear_test_listener(&commit);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, true));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, commit.calls);
+    wl_signal_emit(&wlr_output_ptr->events.frame, wlr_output_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, commit.calls);
+
+    // Powered off, then disabled elsewhere: Powering on leaves it disabled.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, false));
+    wlr_output_state_init(&state);
+    wlr_output_state_set_enabled(&state, false);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlr_output_commit_state(wlr_output_ptr, &state));
+    wlr_output_state_finish(&state);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmbe_output_powered_off(output_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmbe_output_set_power(output_ptr, true));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlr_output_ptr->enabled);
+
+    wlmtk_util_disconnect_test_listener(&commit);
+    wlmbe_output_destroy(output_ptr);
+    wlmbe_output_config_destroy(config_ptr);
+    wlr_scene_node_destroy(&scene_ptr->tree.node);
+    wlr_allocator_destroy(allocator_ptr);
+    wlr_renderer_destroy(renderer_ptr);
+    wlr_backend_destroy(backend_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* == End of output.c ====================================================== */
@@ -115,6 +115,9 @@ static const bspl_desc_t    _wlmbe_output_config_desc[] = {
         _wlmbe_output_mode_encode,
         _wlmbe_output_mode_decode_init,
         NULL),
+    BSPL_DESC_UINT64(
+        "MaxRenderTime", false, wlmbe_output_config_t,
+        attributes.max_render_time, attributes.max_render_time, 0),
     BSPL_DESC_SENTINEL()
 };
 
@@ -174,6 +177,7 @@ void wlmbe_output_config_apply_attributes(
     config_ptr->attributes.transformation = attributes_ptr->transformation;
     config_ptr->attributes.scale = BS_MAX(1.0, attributes_ptr->scale);
     config_ptr->attributes.enabled = attributes_ptr->enabled;
+    config_ptr->attributes.max_render_time = attributes_ptr->max_render_time;
 
     if (attributes_ptr->has_position) {
         config_ptr->attributes.position = attributes_ptr->position;
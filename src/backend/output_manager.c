@@ -28,14 +28,19 @@
 #include <wayland-server-core.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/backend.h>
+#include <wlr/backend/headless.h>
 #include <wlr/render/allocator.h>
+#include <wlr/render/pixman.h>
+#include <wlr/render/wlr_renderer.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/types/wlr_output_management_v1.h>
+#include <wlr/types/wlr_scene.h>
 #include <wlr/types/wlr_xdg_output_v1.h>
 #undef WLR_USE_UNSTABLE
 
 #include "output.h"
+#include "output_config.h"
 
 struct wl_list;
 
@@ -72,21 +77,13 @@ struct _wlmbe_output_manager_t {
     struct wlr_backend        *wlr_backend_ptr;
 };
 
-/** Argument to @ref _wlmaker_output_manager_config_head_apply. */
-typedef struct {
-    /** Points to struct wlr_output_layout. */
-    struct wlr_output_layout *wlr_output_layout_ptr;
-    /** Whether to test only, or to apply "really". */
-    bool really;
-} _wlmaker_output_manager_config_head_apply_arg_t;
-
 static bool _wlmbe_output_manager_update_output_configuration(
     struct wl_list *link_ptr,
     void *ud_ptr);
 static bool _wlmaker_output_manager_config_head_scale(
     struct wl_list *link_ptr,
     void *ud_ptr);
-static bool _wlmaker_output_manager_config_head_apply(
+static bool _wlmaker_output_manager_config_head_update_layout(
     struct wl_list *link_ptr,
     void *ud_ptr);
 static bool _wlmbe_output_manager_apply(
@@ -296,42 +293,26 @@ bool _wlmaker_output_manager_config_head_scale(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Applies the heads's output configuration.
+ * Updates the output layout and the output's attributes from the head's
+ * output configuration. To be called once the configuration was committed.
  *
  * Callback for @ref wlmtk_util_wl_list_for_each.
  *
  * @param link_ptr
- * @param ud_ptr
+ * @param ud_ptr              Points to struct wlr_output_layout.
  *
- * @return true if the tests & apply methods succeeded.
+ * @return true on success.
  */
-static bool _wlmaker_output_manager_config_head_apply(
+static bool _wlmaker_output_manager_config_head_update_layout(
     struct wl_list *link_ptr,
     void *ud_ptr)
 {
     struct wlr_output_configuration_head_v1 *head_v1_ptr  = BS_CONTAINER_OF(
         link_ptr, struct wlr_output_configuration_head_v1, link);
-    struct wlr_output_state state = {};
-    _wlmaker_output_manager_config_head_apply_arg_t *arg_ptr = ud_ptr;
-
-    // Convenience pointers. Guard against accidental misses.
+    struct wlr_output_layout *wlr_output_layout_ptr = ud_ptr;
     struct wlr_output *wlr_output_ptr = head_v1_ptr->state.output;
-    if (NULL == wlr_output_ptr) {
-        bs_log(BS_ERROR, "Unexpected NULL output in head %p", head_v1_ptr);
-        return false;
-    }
-
-    wlr_output_head_v1_state_apply(&head_v1_ptr->state, &state);
-    state.scale = BS_MAX(1.0, state.scale);
-
-    if (!wlr_output_test_state(wlr_output_ptr, &state)) return false;
-    if (!arg_ptr->really) return true;
-
-    if (!wlr_output_commit_state(wlr_output_ptr, &state)) return false;
 
     int x = head_v1_ptr->state.x, y = head_v1_ptr->state.y;
-    struct wlr_output_layout *wlr_output_layout_ptr =
-        arg_ptr->wlr_output_layout_ptr;
     if (head_v1_ptr->state.enabled &&
         !wlr_output_layout_add(wlr_output_layout_ptr, wlr_output_ptr, x, y)) {
         bs_log(BS_ERROR, "Failed wlr_output_layout_add(%p, %p, %d, %d)",
@@ -343,9 +324,7 @@ static bool _wlmaker_output_manager_config_head_apply(
 
     bool has_position = false;
     struct wlr_output_layout_output *wlr_output_layout_output_ptr =
-        wlr_output_layout_get(
-            arg_ptr->wlr_output_layout_ptr,
-            wlr_output_ptr);
+        wlr_output_layout_get(wlr_output_layout_ptr, wlr_output_ptr);
     if (NULL != wlr_output_layout_output_ptr) {
         has_position = !wlr_output_layout_output_ptr->auto_configured;
     }
@@ -368,6 +347,10 @@ static bool _wlmaker_output_manager_config_head_apply(
 /**
  * Tests and applies an output configuration.
  *
+ * The configuration of all heads is tested once, and -- if `really` -- then
+ * committed once, as a single backend transaction. If either fails, none of
+ * the outputs is changed. The output layout is updated only after success.
+ *
  * @param output_manager_ptr
  * @param wlr_output_configuration_v1_ptr
  * @param really              Whether to not just test, but also apply it.
@@ -379,17 +362,6 @@ bool _wlmbe_output_manager_apply(
     struct wlr_output_configuration_v1 *wlr_output_configuration_v1_ptr,
     bool really)
 {
-    _wlmaker_output_manager_config_head_apply_arg_t arg = {
-        .wlr_output_layout_ptr = output_manager_ptr->wlr_output_layout_ptr,
-        .really = really
-    };
-    if (!wlmtk_util_wl_list_for_each(
-            &wlr_output_configuration_v1_ptr->heads,
-            _wlmaker_output_manager_config_head_apply,
-            &arg)) {
-        return false;
-    }
-
     size_t states_len;
     struct wlr_backend_output_state *wlr_backend_output_state_ptr =
         wlr_output_configuration_v1_build_state(
@@ -401,6 +373,15 @@ bool _wlmbe_output_manager_apply(
         return false;
     }
 
+    for (size_t i = 0; i < states_len; ++i) {
+        struct wlr_output_state *state_ptr =
+            &wlr_backend_output_state_ptr[i].base;
+        if (state_ptr->committed & WLR_OUTPUT_STATE_SCALE) {
+            wlr_output_state_set_scale(
+                state_ptr, BS_MAX(1.0, state_ptr->scale));
+        }
+    }
+
     bool rv = wlr_backend_test(
         output_manager_ptr->wlr_backend_ptr,
         wlr_backend_output_state_ptr,
@@ -410,9 +391,24 @@ bool _wlmbe_output_manager_apply(
             output_manager_ptr->wlr_backend_ptr,
             wlr_backend_output_state_ptr,
             states_len);
+        if (!rv) {
+            bs_log(BS_WARNING, "Failed wlr_backend_commit(%p, %p, %zu)",
+                   output_manager_ptr->wlr_backend_ptr,
+                   wlr_backend_output_state_ptr, states_len);
+        }
+    }
+
+    for (size_t i = 0; i < states_len; ++i) {
+        wlr_output_state_finish(&wlr_backend_output_state_ptr[i].base);
     }
     free(wlr_backend_output_state_ptr);
 
+    if (rv && really) {
+        rv = wlmtk_util_wl_list_for_each(
+            &wlr_output_configuration_v1_ptr->heads,
+            _wlmaker_output_manager_config_head_update_layout,
+            output_manager_ptr->wlr_output_layout_ptr);
+    }
     return rv;
 }
 
@@ -539,4 +535,120 @@ void _wlmbe_output_manager_handle_output_layout_change(
     wlr_output_configuration_v1_destroy(wlr_output_configuration_v1_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void _wlmbe_output_manager_test_commit(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlmbe_output_manager_test_cases[] = {
+    { 1, "commit", _wlmbe_output_manager_test_commit },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmbe_output_manager_test_set = BS_TEST_SET(
+    true, "output_manager", _wlmbe_output_manager_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies that an applied configuration commits each output exactly once,
+ * and that a test-only configuration does not commit at all.
+ */
+void _wlmbe_output_manager_test_commit(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_backend *backend_ptr = wlr_headless_backend_create(
+        wl_display_get_event_loop(display_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, backend_ptr);
+    struct wlr_renderer *renderer_ptr = wlr_pixman_renderer_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, renderer_ptr);
+    struct wlr_allocator *allocator_ptr = wlr_allocator_autocreate(
+        backend_ptr, renderer_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, allocator_ptr);
+    struct wlr_output_layout *wol_ptr = wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wol_ptr);
+    struct wlr_scene *scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, scene_ptr);
+
+    const wlmbe_output_config_attributes_t attr = {
+        .transformation = WL_OUTPUT_TRANSFORM_NORMAL,
+        .scale = 1.0,
+        .enabled = true
+    };
+    struct wlr_output *wlr_outputs[2];
+    wlmbe_output_config_t *configs[2];
+    wlmbe_output_t *outputs[2];
+    wlmtk_util_test_listener_t commits[2];
+    for (size_t i = 0; i < 2; ++i) {
+        wlr_outputs[i] = wlr_headless_add_output(backend_ptr, 640, 480);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_outputs[i]);
+        configs[i] = wlmbe_output_config_create_from_wlr(wlr_outputs[i]);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, configs[i]);
+        wlmbe_output_config_apply_attributes(configs[i], &attr);
+        outputs[i] = wlmbe_output_create(
+            wlr_outputs[i], allocator_ptr, renderer_ptr, scene_ptr,
+            configs[i], 0, 0);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, outputs[i]);
+        wlr_output_layout_add_auto(wol_ptr, wlr_outputs[i]);
+        wlmtk_util_connect_test_listener(
+            &wlr_outputs[i]->events.commit, &commits[i]);
+    }
+
+    wlmbe_output_manager_t *om_ptr = wlmbe_output_manager_create(
+        display_ptr, scene_ptr, wol_ptr, backend_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, om_ptr);
+
+    // Scaling applies a configuration: One commit per output.
+    wlmbe_output_manager_scale(om_ptr, 2.0);
+    for (size_t i = 0; i < 2; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, 1, commits[i].calls);
+        BS_TEST_VERIFY_EQ(test_ptr, 2.0, wlr_outputs[i]->scale);
+        wlmtk_util_clear_test_listener(&commits[i]);
+    }
+
+    // Test-only: No commits, and the outputs remain unchanged.
+    struct wlr_output_configuration_v1 *config_ptr =
+        wlr_output_configuration_v1_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, config_ptr);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_util_wl_list_for_each(
+            &wol_ptr->outputs,
+            _wlmbe_output_manager_update_output_configuration,
+            config_ptr));
+    double scale = 2.0;
+    wlmtk_util_wl_list_for_each(
+        &config_ptr->heads,
+        _wlmaker_output_manager_config_head_scale,
+        &scale);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmbe_output_manager_apply(om_ptr, config_ptr, false));
+    for (size_t i = 0; i < 2; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, 0, commits[i].calls);
+        BS_TEST_VERIFY_EQ(test_ptr, 2.0, wlr_outputs[i]->scale);
+    }
+
+    // Applying it: Once again, a single commit per output.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmbe_output_manager_apply(om_ptr, config_ptr, true));
+    for (size_t i = 0; i < 2; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, 1, commits[i].calls);
+        BS_TEST_VERIFY_EQ(test_ptr, 4.0, wlr_outputs[i]->scale);
+    }
+    wlr_output_configuration_v1_destroy(config_ptr);
+
+    wlmbe_output_manager_destroy(om_ptr);
+    for (size_t i = 0; i < 2; ++i) {
+        wlmtk_util_disconnect_test_listener(&commits[i]);
+        wlmbe_output_destroy(outputs[i]);
+        wlmbe_output_config_destroy(configs[i]);
+    }
+    wlr_scene_node_destroy(&scene_ptr->tree.node);
+    wlr_output_layout_destroy(wol_ptr);
+    wlr_allocator_destroy(allocator_ptr);
+    wlr_renderer_destroy(renderer_ptr);
+    wlr_backend_destroy(backend_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* == End of output_manager.c ============================================== */
@@ -21,16 +21,22 @@
 
 #include "background.h"
 
+#include <cairo.h>
 #include <libbase/libbase.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #define WLR_USE_UNSTABLE
+#include <wlr/backend.h>
+#include <wlr/backend/headless.h>
+#include <wlr/render/allocator.h>
+#include <wlr/render/pixman.h>
+#include <wlr/render/wlr_renderer.h>
+#include <wlr/types/wlr_buffer.h>
+#include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
 #include <wlr/util/edges.h>
 #undef WLR_USE_UNSTABLE
 
-struct wlr_output;
-
 /* == Declarations ========================================================= */
 
 /** Background state. */
@@ -43,14 +49,53 @@ struct wlmaker_background {
     uint32_t                  color;
     /** Tracks the outputs available. */
     wlmtk_output_tracker_t    *output_tracker_ptr;
+
+    /** The decoded image, or NULL if the background is just a color. */
+    cairo_surface_t           *image_surface_ptr;
+    /** How to place the image on the output. */
+    wlmaker_background_image_mode_t image_mode;
+    /** Images scaled for an output geometry. See @ref _scaled_image_t. */
+    bs_dllist_t               scaled_images;
 };
 
+/**
+ * The image, scaled and rendered for one output geometry. Outputs of equal
+ * geometry share it. The buffer is immutable once rendered.
+ */
+typedef struct {
+    /** List node, element of @ref wlmaker_background::scaled_images. */
+    bs_dllist_node_t          dlnode;
+    /** Width of the output, in layout coordinates. */
+    int                       width;
+    /** Height of the output, in layout coordinates. */
+    int                       height;
+    /** Scale of the output. */
+    double                    scale;
+    /** The rendered image, at `width` x `height` times `scale` pixels. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Number of panels using this scaled image. */
+    int                       references;
+} _scaled_image_t;
+
 /** Background panel: The workspace's backgrund for the output. */
 typedef struct  {
     /** A layer background for one output is a panel. */
     wlmtk_panel_t             super_panel;
-    /** Initial implementation: The background is a uni-color rectangle. */
+    /** Uni-color rectangle. Shows where the image does not cover. */
     wlmtk_rectangle_t         *rectangle_ptr;
+    /** Shows the scaled image. Only present if there is an image. */
+    wlmtk_buffer_t            *image_buffer_ptr;
+
+    /** Back-link to the background this panel belongs to. */
+    struct wlmaker_background *background_ptr;
+    /** The output this panel is on. */
+    struct wlr_output         *wlr_output_ptr;
+    /** Width of the panel, as last requested. */
+    int                       width;
+    /** Height of the panel, as last requested. */
+    int                       height;
+    /** The scaled image currently shown. Holds a reference. */
+    _scaled_image_t           *scaled_image_ptr;
 } wlmaker_background_panel_t;
 
 static uint32_t _wlmaker_background_panel_request_size(
@@ -61,6 +106,10 @@ static uint32_t _wlmaker_background_panel_request_size(
 static void *_wlmaker_background_panel_create(
     struct wlr_output *wlr_output_ptr,
     void *ud_ptr);
+static void _wlmaker_background_panel_update(
+    struct wlr_output *wlr_output_ptr,
+    void *ud_ptr,
+    void *output_ptr);
 static void _wlmaker_background_panel_destroy(
     struct wlr_output *wlr_output_ptr,
     void *ud_ptr,
@@ -72,9 +121,35 @@ static void _wlmaker_backgrund_panel_set_color(
     void *ud_ptr,
     void *output_ptr,
     void *arg_ptr);
+static void _wlmaker_background_panel_update_image(
+    wlmaker_background_panel_t *background_panel_ptr);
+
+static _scaled_image_t *_wlmaker_background_scaled_image_acquire(
+    struct wlmaker_background *background_ptr,
+    int width,
+    int height,
+    double scale);
+static void _wlmaker_background_scaled_image_release(
+    struct wlmaker_background *background_ptr,
+    _scaled_image_t *scaled_image_ptr);
+static struct wlr_buffer *_wlmaker_background_render_image(
+    cairo_surface_t *image_surface_ptr,
+    wlmaker_background_image_mode_t mode,
+    int width,
+    int height,
+    double scale);
 
 /* == Data ================================================================= */
 
+/** Names of the image modes. */
+const bspl_enum_desc_t wlmaker_background_image_mode_desc[] = {
+    BSPL_ENUM("Fill", WLMAKER_BACKGROUND_IMAGE_FILL),
+    BSPL_ENUM("Fit", WLMAKER_BACKGROUND_IMAGE_FIT),
+    BSPL_ENUM("Center", WLMAKER_BACKGROUND_IMAGE_CENTER),
+    BSPL_ENUM("Tile", WLMAKER_BACKGROUND_IMAGE_TILE),
+    BSPL_ENUM_SENTINEL()
+};
+
 /** The background panels' virtual method table. */
 static const wlmtk_panel_vmt_t _wlmaker_background_panel_vmt = {
     .request_size = _wlmaker_background_panel_request_size
@@ -98,19 +173,45 @@ static const wlmtk_panel_positioning_t _wlmaker_background_panel_position = {
 bs_dllist_node_t *wlmaker_background_create(
     wlmtk_workspace_t *workspace_ptr,
     struct wlr_output_layout *wlr_output_layout_ptr,
-    uint32_t color)
+    uint32_t color,
+    const char *image_path_ptr,
+    wlmaker_background_image_mode_t image_mode)
 {
     struct wlmaker_background *bg_ptr = logged_calloc(1, sizeof(*bg_ptr));
     if (NULL == bg_ptr) return NULL;
     bg_ptr->layer_ptr = wlmtk_workspace_get_layer(
         workspace_ptr, WLMTK_WORKSPACE_LAYER_BACKGROUND),
     bg_ptr->color = color;
+    bg_ptr->image_mode = image_mode;
+
+    // The image is decoded just once. A failure leaves just the color.
+    if (NULL != image_path_ptr) {
+        char *path_ptr = bs_file_resolve_path(image_path_ptr, NULL);
+        if (NULL == path_ptr) {
+            bs_log(BS_WARNING, "Failed bs_file_resolve_path(\"%s\", NULL)",
+                   image_path_ptr);
+        } else {
+            bg_ptr->image_surface_ptr = cairo_image_surface_create_from_png(
+                path_ptr);
+            if (CAIRO_STATUS_SUCCESS != cairo_surface_status(
+                    bg_ptr->image_surface_ptr)) {
+                bs_log(BS_WARNING,
+                       "Failed cairo_image_surface_create_from_png(%s): %s",
+                       path_ptr,
+                       cairo_status_to_string(
+                           cairo_surface_status(bg_ptr->image_surface_ptr)));
+                cairo_surface_destroy(bg_ptr->image_surface_ptr);
+                bg_ptr->image_surface_ptr = NULL;
+            }
+            free(path_ptr);
+        }
+    }
 
     bg_ptr->output_tracker_ptr = wlmtk_output_tracker_create(
         wlr_output_layout_ptr,
         bg_ptr,
         _wlmaker_background_panel_create,
-        NULL,
+        _wlmaker_background_panel_update,
         _wlmaker_background_panel_destroy);
 
     return &bg_ptr->dlnode;
@@ -128,6 +229,13 @@ void wlmaker_background_dlnode_destroy(
         wlmtk_output_tracker_destroy(bg_ptr->output_tracker_ptr);
         bg_ptr->output_tracker_ptr = NULL;
     }
+
+    // All panels are gone, and have released their scaled images.
+    BS_ASSERT(NULL == bg_ptr->scaled_images.head_ptr);
+    if (NULL != bg_ptr->image_surface_ptr) {
+        cairo_surface_destroy(bg_ptr->image_surface_ptr);
+        bg_ptr->image_surface_ptr = NULL;
+    }
     free(bg_ptr);
 }
 
@@ -158,6 +266,9 @@ uint32_t _wlmaker_background_panel_request_size(
         panel_ptr, wlmaker_background_panel_t, super_panel);
 
     wlmtk_rectangle_set_size(background_ptr->rectangle_ptr, width, height);
+    background_ptr->width = width;
+    background_ptr->height = height;
+    _wlmaker_background_panel_update_image(background_ptr);
 
     wlmtk_panel_commit(
         &background_ptr->super_panel, 0,
@@ -176,6 +287,8 @@ void *_wlmaker_background_panel_create(
     wlmaker_background_panel_t *background_panel_ptr = logged_calloc(
         1, sizeof(wlmaker_background_panel_t));
     if (NULL == background_panel_ptr) return NULL;
+    background_panel_ptr->background_ptr = background_ptr;
+    background_panel_ptr->wlr_output_ptr = wlr_output_ptr;
 
     if (!wlmtk_panel_init(&background_panel_ptr->super_panel,
                           &_wlmaker_background_panel_position)) {
@@ -203,6 +316,23 @@ void *_wlmaker_background_panel_create(
         &background_panel_ptr->super_panel.super_container,
         wlmtk_rectangle_element(background_panel_ptr->rectangle_ptr));
 
+    if (NULL != background_ptr->image_surface_ptr) {
+        background_panel_ptr->image_buffer_ptr = logged_calloc(
+            1, sizeof(wlmtk_buffer_t));
+        if (NULL == background_panel_ptr->image_buffer_ptr ||
+            !wlmtk_buffer_init(background_panel_ptr->image_buffer_ptr)) {
+            _wlmaker_background_panel_destroy(
+                NULL, NULL, background_panel_ptr);
+            return NULL;
+        }
+        wlmtk_element_set_visible(
+            wlmtk_buffer_element(background_panel_ptr->image_buffer_ptr),
+            true);
+        wlmtk_container_add_element(
+            &background_panel_ptr->super_panel.super_container,
+            wlmtk_buffer_element(background_panel_ptr->image_buffer_ptr));
+    }
+
     wlmtk_element_set_visible(
         wlmtk_panel_element(&background_panel_ptr->super_panel),
         true);
@@ -215,6 +345,20 @@ void *_wlmaker_background_panel_create(
     return background_panel_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates the panel when the output's layout changed. The layer will request
+ * a new size when the extents change, but a change of the output's scale
+ * alone needs the image to be re-scaled here.
+ */
+void _wlmaker_background_panel_update(
+    __UNUSED__ struct wlr_output *wlr_output_ptr,
+    __UNUSED__ void *ud_ptr,
+    void *output_ptr)
+{
+    _wlmaker_background_panel_update_image(output_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Dtor. */
 void _wlmaker_background_panel_destroy(
@@ -245,6 +389,25 @@ void _wlmaker_background_panel_element_destroy(wlmtk_element_t *element_ptr)
             &background_panel_ptr->super_panel);
     }
 
+    if (NULL != background_panel_ptr->scaled_image_ptr) {
+        _wlmaker_background_scaled_image_release(
+            background_panel_ptr->background_ptr,
+            background_panel_ptr->scaled_image_ptr);
+        background_panel_ptr->scaled_image_ptr = NULL;
+    }
+
+    if (NULL != background_panel_ptr->image_buffer_ptr) {
+        wlmtk_element_t *e = wlmtk_buffer_element(
+            background_panel_ptr->image_buffer_ptr);
+        if (NULL != e->parent_container_ptr) {
+            wlmtk_container_remove_element(
+                &background_panel_ptr->super_panel.super_container, e);
+            wlmtk_buffer_fini(background_panel_ptr->image_buffer_ptr);
+        }
+        free(background_panel_ptr->image_buffer_ptr);
+        background_panel_ptr->image_buffer_ptr = NULL;
+    }
+
     if (NULL != background_panel_ptr->rectangle_ptr) {
         wlmtk_container_remove_element(
             &background_panel_ptr->super_panel.super_container,
@@ -275,4 +438,334 @@ void _wlmaker_backgrund_panel_set_color(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Shows the image scaled for the panel's current size and output scale.
+ * Re-uses the scaled image if neither changed.
+ *
+ * @param background_panel_ptr
+ */
+void _wlmaker_background_panel_update_image(
+    wlmaker_background_panel_t *background_panel_ptr)
+{
+    if (NULL == background_panel_ptr->image_buffer_ptr) return;
+
+    int width = background_panel_ptr->width;
+    int height = background_panel_ptr->height;
+    double scale = background_panel_ptr->wlr_output_ptr->scale;
+    _scaled_image_t *old_ptr = background_panel_ptr->scaled_image_ptr;
+    if (NULL != old_ptr &&
+        old_ptr->width == width &&
+        old_ptr->height == height &&
+        old_ptr->scale == scale) return;
+
+    _scaled_image_t *new_ptr = NULL;
+    if (0 < width && 0 < height) {
+        new_ptr = _wlmaker_background_scaled_image_acquire(
+            background_panel_ptr->background_ptr, width, height, scale);
+    }
+
+    wlmtk_buffer_set(
+        background_panel_ptr->image_buffer_ptr,
+        NULL != new_ptr ? new_ptr->wlr_buffer_ptr : NULL);
+    wlmtk_buffer_set_dimensions(
+        background_panel_ptr->image_buffer_ptr, width, height);
+    background_panel_ptr->scaled_image_ptr = new_ptr;
+
+    if (NULL != old_ptr) {
+        _wlmaker_background_scaled_image_release(
+            background_panel_ptr->background_ptr, old_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Acquires the image scaled for the given output geometry. Renders it, if no
+ * other output of equal geometry holds it already.
+ *
+ * @param background_ptr
+ * @param width
+ * @param height
+ * @param scale
+ *
+ * @return The scaled image, or NULL on error. Must be released by calling
+ *     @ref _wlmaker_background_scaled_image_release.
+ */
+_scaled_image_t *_wlmaker_background_scaled_image_acquire(
+    struct wlmaker_background *background_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    for (bs_dllist_node_t *dlnode_ptr = background_ptr->scaled_images.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        _scaled_image_t *si_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, _scaled_image_t, dlnode);
+        if (si_ptr->width == width &&
+            si_ptr->height == height &&
+            si_ptr->scale == scale) {
+            si_ptr->references++;
+            return si_ptr;
+        }
+    }
+
+    _scaled_image_t *si_ptr = logged_calloc(1, sizeof(_scaled_image_t));
+    if (NULL == si_ptr) return NULL;
+    si_ptr->width = width;
+    si_ptr->height = height;
+    si_ptr->scale = scale;
+    si_ptr->wlr_buffer_ptr = _wlmaker_background_render_image(
+        background_ptr->image_surface_ptr,
+        background_ptr->image_mode,
+        width, height, scale);
+    if (NULL == si_ptr->wlr_buffer_ptr) {
+        free(si_ptr);
+        return NULL;
+    }
+    si_ptr->references = 1;
+    bs_dllist_push_back(&background_ptr->scaled_images, &si_ptr->dlnode);
+    return si_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases a reference. Destroys the scaled image, if it was the last. */
+void _wlmaker_background_scaled_image_release(
+    struct wlmaker_background *background_ptr,
+    _scaled_image_t *scaled_image_ptr)
+{
+    if (0 < --scaled_image_ptr->references) return;
+
+    bs_dllist_remove(&background_ptr->scaled_images, &scaled_image_ptr->dlnode);
+    wlr_buffer_drop(scaled_image_ptr->wlr_buffer_ptr);
+    free(scaled_image_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders the image into a new buffer, for an output of the given geometry.
+ *
+ * @param image_surface_ptr
+ * @param mode
+ * @param width               Width of the output, in layout coordinates.
+ * @param height              Height of the output, in layout coordinates.
+ * @param scale               Scale of the output.
+ *
+ * @return A wlr_buffer of `width` x `height` times `scale` pixels, or NULL on
+ *     error. Must be released by calling `wlr_buffer_drop`.
+ */
+struct wlr_buffer *_wlmaker_background_render_image(
+    cairo_surface_t *image_surface_ptr,
+    wlmaker_background_image_mode_t mode,
+    int width,
+    int height,
+    double scale)
+{
+    int w = BS_MAX(1, (int)(width * scale + 0.5));
+    int h = BS_MAX(1, (int)(height * scale + 0.5));
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(w, h);
+    if (NULL == wlr_buffer_ptr) return NULL;
+    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
+    if (NULL == cairo_ptr) {
+        wlr_buffer_drop(wlr_buffer_ptr);
+        return NULL;
+    }
+
+    double iw = cairo_image_surface_get_width(image_surface_ptr);
+    double ih = cairo_image_surface_get_height(image_surface_ptr);
+    double f = scale;
+    cairo_extend_t extend = CAIRO_EXTEND_NONE;
+    switch (mode) {
+    case WLMAKER_BACKGROUND_IMAGE_FILL:
+        f = BS_MAX(w / iw, h / ih);
+        extend = CAIRO_EXTEND_PAD;
+        break;
+    case WLMAKER_BACKGROUND_IMAGE_FIT:
+        f = BS_MIN(w / iw, h / ih);
+        break;
+    case WLMAKER_BACKGROUND_IMAGE_TILE:
+        extend = CAIRO_EXTEND_REPEAT;
+        break;
+    case WLMAKER_BACKGROUND_IMAGE_CENTER:
+    default:
+        break;
+    }
+
+    // Pattern space: Centered, unless tiled. Tiles start at the top-left.
+    cairo_matrix_t matrix;
+    cairo_matrix_init_scale(&matrix, 1.0 / f, 1.0 / f);
+    if (WLMAKER_BACKGROUND_IMAGE_TILE != mode) {
+        cairo_matrix_translate(
+            &matrix, -(w - iw * f) / 2.0, -(h - ih * f) / 2.0);
+    }
+    cairo_pattern_t *pattern_ptr = cairo_pattern_create_for_surface(
+        image_surface_ptr);
+    cairo_pattern_set_matrix(pattern_ptr, &matrix);
+    cairo_pattern_set_extend(pattern_ptr, extend);
+    cairo_pattern_set_filter(pattern_ptr, CAIRO_FILTER_GOOD);
+
+    cairo_set_operator(cairo_ptr, CAIRO_OPERATOR_SOURCE);
+    cairo_set_source(cairo_ptr, pattern_ptr);
+    cairo_paint(cairo_ptr);
+    cairo_pattern_destroy(pattern_ptr);
+    cairo_destroy(cairo_ptr);
+    return wlr_buffer_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_background_test_shared(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlmaker_background_test_cases[] = {
+    { 1, "shared", _wlmaker_background_test_shared },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmaker_background_test_set = BS_TEST_SET(
+    true, "background", _wlmaker_background_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/** Adds an enabled headless output of `width` x `height` at `scale`. */
+static struct wlr_output *_wlmaker_background_test_output(
+    struct wlr_backend *wlr_backend_ptr,
+    struct wlr_allocator *wlr_allocator_ptr,
+    struct wlr_renderer *wlr_renderer_ptr,
+    int width,
+    int height,
+    double scale)
+{
+    struct wlr_output *wlr_output_ptr = wlr_headless_add_output(
+        wlr_backend_ptr, width, height);
+    if (NULL == wlr_output_ptr) return NULL;
+    if (!wlr_output_init_render(
+            wlr_output_ptr, wlr_allocator_ptr, wlr_renderer_ptr)) return NULL;
+
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_enabled(&state, true);
+    wlr_output_state_set_scale(&state, scale);
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    wlr_output_state_finish(&state);
+    return rv ? wlr_output_ptr : NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Commits a new scale to `wlr_output_ptr`. */
+static bool _wlmaker_background_test_set_scale(
+    struct wlr_output *wlr_output_ptr,
+    double scale)
+{
+    struct wlr_output_state state;
+    wlr_output_state_init(&state);
+    wlr_output_state_set_scale(&state, scale);
+    bool rv = wlr_output_commit_state(wlr_output_ptr, &state);
+    wlr_output_state_finish(&state);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the wlr_buffer shown by the background on `wlr_output_ptr`. */
+static struct wlr_buffer *_wlmaker_background_test_buffer(
+    struct wlmaker_background *background_ptr,
+    struct wlr_output *wlr_output_ptr)
+{
+    wlmaker_background_panel_t *panel_ptr = wlmtk_output_tracker_get_output(
+        background_ptr->output_tracker_ptr, wlr_output_ptr);
+    if (NULL == panel_ptr || NULL == panel_ptr->image_buffer_ptr) return NULL;
+    return panel_ptr->image_buffer_ptr->wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Verifies the scaled image is shared among outputs of equal geometry, and
+ * re-scaled only when the geometry of an output changes.
+ */
+void _wlmaker_background_test_shared(bs_test_t *test_ptr)
+{
+    struct wl_display *display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, display_ptr);
+    struct wlr_backend *backend_ptr = wlr_headless_backend_create(
+        wl_display_get_event_loop(display_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, backend_ptr);
+    struct wlr_renderer *renderer_ptr = wlr_pixman_renderer_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, renderer_ptr);
+    struct wlr_allocator *allocator_ptr = wlr_allocator_autocreate(
+        backend_ptr, renderer_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, allocator_ptr);
+    struct wlr_output_layout *wol_ptr = wlr_output_layout_create(display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wol_ptr);
+    static const struct wlmtk_tile_style ts = { .size = 64 };
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(wol_ptr, "t", &ts);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+
+    struct wlr_output *o1 = _wlmaker_background_test_output(
+        backend_ptr, allocator_ptr, renderer_ptr, 640, 480, 1.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o1);
+    wlr_output_layout_add_auto(wol_ptr, o1);
+    struct wlr_output *o2 = _wlmaker_background_test_output(
+        backend_ptr, allocator_ptr, renderer_ptr, 640, 480, 1.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o2);
+    wlr_output_layout_add_auto(wol_ptr, o2);
+    struct wlr_output *o3 = _wlmaker_background_test_output(
+        backend_ptr, allocator_ptr, renderer_ptr, 800, 600, 1.0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o3);
+    wlr_output_layout_add_auto(wol_ptr, o3);
+
+    bs_dllist_node_t *dlnode_ptr = wlmaker_background_create(
+        ws_ptr, wol_ptr, 0xff204060,
+        bs_test_data_path(test_ptr, "clip_raised.png"),
+        WLMAKER_BACKGROUND_IMAGE_FILL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dlnode_ptr);
+    struct wlmaker_background *bg_ptr = BS_CONTAINER_OF(
+        dlnode_ptr, struct wlmaker_background, dlnode);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, bg_ptr->image_surface_ptr);
+
+    // Outputs 1 and 2 share the same geometry, and the same buffer.
+    struct wlr_buffer *b1 = _wlmaker_background_test_buffer(bg_ptr, o1);
+    struct wlr_buffer *b3 = _wlmaker_background_test_buffer(bg_ptr, o3);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b3);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, b1, _wlmaker_background_test_buffer(bg_ptr, o2));
+    BS_TEST_VERIFY_NEQ(test_ptr, b1, b3);
+    BS_TEST_VERIFY_EQ(test_ptr, 640, b1->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 800, b3->width);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_dllist_size(&bg_ptr->scaled_images));
+
+    // Scale output 1: Re-scaled at full resolution, for half the extents.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_background_test_set_scale(o1, 2));
+    struct wlr_buffer *b1s = _wlmaker_background_test_buffer(bg_ptr, o1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, b1s);
+    BS_TEST_VERIFY_NEQ(test_ptr, b1, b1s);
+    BS_TEST_VERIFY_EQ(test_ptr, 640, b1s->width);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, b1, _wlmaker_background_test_buffer(bg_ptr, o2));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, bs_dllist_size(&bg_ptr->scaled_images));
+    wlmaker_background_panel_t *p1 = wlmtk_output_tracker_get_output(
+        bg_ptr->output_tracker_ptr, o1);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(
+        wlmtk_buffer_element(p1->image_buffer_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 320, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 240, box.height);
+
+    // Same for output 2: Shares the scaled buffer. The unscaled one is gone.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_background_test_set_scale(o2, 2));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, b1s, _wlmaker_background_test_buffer(bg_ptr, o2));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, bs_dllist_size(&bg_ptr->scaled_images));
+
+    // Removing output 3 releases its buffer.
+    wlr_output_layout_remove(wol_ptr, o3);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&bg_ptr->scaled_images));
+
+    wlmaker_background_dlnode_destroy(dlnode_ptr, NULL);
+    wlmtk_workspace_destroy(ws_ptr);
+    wlr_output_layout_destroy(wol_ptr);
+    wlr_allocator_destroy(allocator_ptr);
+    wlr_renderer_destroy(renderer_ptr);
+    wlr_backend_destroy(backend_ptr);
+    wl_display_destroy(display_ptr);
+}
+
 /* == End of background.c ================================================== */
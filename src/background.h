@@ -22,29 +22,53 @@
 #define __BACKGROUND_H__
 
 #include <libbase/libbase.h>
+#include <libbase/plist.h>
 #include <stdint.h>
 
 #include "toolkit/toolkit.h"
 
 struct wlr_output_layout;
 
+/** How the background image is placed on each output. */
+typedef enum {
+    /** Scaled to cover the output, preserving aspect ratio. Cropped. */
+    WLMAKER_BACKGROUND_IMAGE_FILL,
+    /** Scaled to fit into the output, preserving aspect ratio. */
+    WLMAKER_BACKGROUND_IMAGE_FIT,
+    /** At the image's size, centered on the output. */
+    WLMAKER_BACKGROUND_IMAGE_CENTER,
+    /** At the image's size, repeated from the output's top-left corner. */
+    WLMAKER_BACKGROUND_IMAGE_TILE
+} wlmaker_background_image_mode_t;
+
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
+/** Descriptor for decoding @ref wlmaker_background_image_mode_t. */
+extern const bspl_enum_desc_t wlmaker_background_image_mode_desc[];
+
 /**
  * Creates a background, derived from a @ref wlmtk_panel_t.
  *
+ * The image is decoded once. For each distinct output geometry (size and
+ * scale), it is scaled once, and the buffer shared among those outputs.
+ *
  * @param workspace_ptr
  * @param wlr_output_layout_ptr
- * @param color
+ * @param color               Color of the background, where not covered by
+ *                            the image.
+ * @param image_path_ptr      Path to a PNG image, or NULL for no image.
+ * @param image_mode
  *
  * @return A list node acting as handle for the background, or NULL on error.
  */
 bs_dllist_node_t *wlmaker_background_create(
     wlmtk_workspace_t *workspace_ptr,
     struct wlr_output_layout *wlr_output_layout_ptr,
-    uint32_t color);
+    uint32_t color,
+    const char *image_path_ptr,
+    wlmaker_background_image_mode_t image_mode);
 
 /**
  * Destroys the background.
@@ -66,6 +90,9 @@ void wlmaker_background_dlnode_set_color(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
 
+/** Unit test cases. */
+extern const bs_test_set_t wlmaker_background_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
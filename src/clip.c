@@ -44,6 +44,16 @@
 
 /* == Declarations ========================================================= */
 
+/** A tile buffer of the clip, and the job drawing it. */
+typedef struct {
+    /** Back-link to the clip. */
+    wlmaker_clip_t            *clip_ptr;
+    /** The drawn buffer. NULL if not drawn (yet). */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Pending job drawing the buffer, or NULL. */
+    wlmtk_raster_job_t        *job_ptr;
+} wlmaker_clip_tile_slot_t;
+
 /** Clip handle. */
 struct _wlmaker_clip_t {
     /** The clip happens to be derived from a tile. */
@@ -58,14 +68,16 @@ struct _wlmaker_clip_t {
     wlmtk_dock_t              *wlmtk_dock_ptr;
 
     /** The tile's texture buffer without any buttons pressed */
-    struct wlr_buffer         *tile_buffer_ptr;
+    wlmaker_clip_tile_slot_t  tile;
     /** The tile's texture buffer with the 'Next' buttons pressed. */
-    struct wlr_buffer         *next_pressed_tile_buffer_ptr;
+    wlmaker_clip_tile_slot_t  next_pressed_tile;
     /** The tile's texture buffer with the 'Previous' buttons pressed. */
-    struct wlr_buffer         *prev_pressed_tile_buffer_ptr;
+    wlmaker_clip_tile_slot_t  prev_pressed_tile;
 
     /** Overlay buffer element: Contains the workspace's title and number. */
     wlmtk_buffer_t            overlay_buffer;
+    /** Pending job drawing the overlay, or NULL. */
+    wlmtk_raster_job_t        *overlay_job_ptr;
     /** Path to the image file. */
     char                      *image_path_ptr;
     /** Clip image. */
@@ -98,6 +110,28 @@ struct _wlmaker_clip_t {
     wlmaker_config_clip_style_t style;
 };
 
+/** Arguments for @ref _wlmaker_clip_draw_tile. Copied into the job. */
+typedef struct {
+    /** Copy of the tile style. */
+    struct wlmtk_tile_style   tile_style;
+    /** Whether to draw the 'Previous' button as pressed. */
+    bool                      prev_pressed;
+    /** Whether to draw the 'Next' button as pressed. */
+    bool                      next_pressed;
+} wlmaker_clip_tile_args_t;
+
+/** Arguments for @ref _wlmaker_clip_draw_overlay. Copied into the job. */
+typedef struct {
+    /** Copy of the clip's style. */
+    wlmaker_config_clip_style_t clip_style;
+    /** Size of the tile. */
+    uint64_t                  size;
+    /** Copy of the workspace name. Released by the args' fini. */
+    char                      *name_ptr;
+    /** Index of the workspace. */
+    int                       index;
+} wlmaker_clip_overlay_args_t;
+
 static bool _wlmaker_clip_pointer_axis(
     wlmtk_element_t *element_ptr,
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
@@ -116,10 +150,21 @@ static bool _wlmaker_clip_update_overlay(
 static bool _wlmaker_clip_update_image(
     wlmaker_clip_t *clip_ptr,
     const struct wlmtk_tile_style *tile_style_ptr);
-static struct wlr_buffer *_wlmaker_clip_create_tile(
+static bool _wlmaker_clip_submit_tile(
+    wlmaker_clip_tile_slot_t *slot_ptr,
     const struct wlmtk_tile_style *tile_style_ptr,
     bool prev_pressed,
     bool next_pressed);
+static void _wlmaker_clip_cancel_jobs(wlmaker_clip_t *clip_ptr);
+static void _wlmaker_clip_handle_tile_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmaker_clip_draw_tile(cairo_t *cairo_ptr, void *args_ptr);
+static void _wlmaker_clip_handle_overlay_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmaker_clip_draw_overlay(cairo_t *cairo_ptr, void *args_ptr);
+static void _wlmaker_clip_overlay_args_fini(void *args_ptr);
 
 static void _wlmaker_clip_handle_workspace_changed(
     struct wl_listener *listener_ptr,
@@ -183,6 +228,9 @@ wlmaker_clip_t *wlmaker_clip_create(
     if (NULL == clip_ptr) return NULL;
     clip_ptr->server_ptr = server_ptr;
     clip_ptr->style = style_ptr->clip;
+    clip_ptr->tile.clip_ptr = clip_ptr;
+    clip_ptr->next_pressed_tile.clip_ptr = clip_ptr;
+    clip_ptr->prev_pressed_tile.clip_ptr = clip_ptr;
 
     parse_args args = {};
     bspl_dict_t *dict_ptr = bspl_dict_get_dict(state_dict_ptr, "Clip");
@@ -232,8 +280,7 @@ wlmaker_clip_t *wlmaker_clip_create(
 
     wlmtk_element_set_visible(
         wlmtk_tile_element(&clip_ptr->super_tile), true);
-    wlmtk_tile_set_background_buffer(
-        &clip_ptr->super_tile, clip_ptr->tile_buffer_ptr);
+    _wlmaker_clip_apply_button_state(clip_ptr);
     wlmtk_dock_add_tile(clip_ptr->wlmtk_dock_ptr, &clip_ptr->super_tile);
 
     if (!wlmtk_buffer_init(&clip_ptr->overlay_buffer)) {
@@ -262,18 +309,8 @@ wlmaker_clip_t *wlmaker_clip_create(
         return NULL;
     }
 
-    // Resolves to a full path, and verifies the icon file exists.
-    clip_ptr->image_path_ptr = wlm_util_files_xdg_data_find(
-        server_ptr->files_ptr, "icons/clip-56x56.png", S_IFREG);
-    if (NULL == clip_ptr->image_path_ptr) {
-        bs_log(
-            BS_WARNING,
-            "Failed to locate ${XDG_DATA_DIRS}/wlmaker/icons/clip-56x56.png");
-#ifdef WLMAKER_SOURCE_DIR
-        clip_ptr->image_path_ptr = logged_strdup(
-            WLMAKER_SOURCE_DIR "/share/wlmaker/icons/clip-56x56.png");
-#endif
-    }
+    clip_ptr->image_path_ptr = wlmaker_clip_resolve_image(
+        server_ptr->files_ptr);
     if (NULL == clip_ptr->image_path_ptr) {
         wlmaker_clip_destroy(clip_ptr);
         return NULL;
@@ -313,6 +350,24 @@ wlmaker_clip_t *wlmaker_clip_create(
     return clip_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+char *wlmaker_clip_resolve_image(wlm_util_files_t *files_ptr)
+{
+    // Resolves to a full path, and verifies the icon file exists.
+    char *path_ptr = wlm_util_files_xdg_data_find(
+        files_ptr, "icons/clip-56x56.png", S_IFREG);
+    if (NULL == path_ptr) {
+        bs_log(
+            BS_WARNING,
+            "Failed to locate ${XDG_DATA_DIRS}/wlmaker/icons/clip-56x56.png");
+#ifdef WLMAKER_SOURCE_DIR
+        path_ptr = logged_strdup(
+            WLMAKER_SOURCE_DIR "/share/wlmaker/icons/clip-56x56.png");
+#endif
+    }
+    return path_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr)
 {
@@ -323,6 +378,7 @@ void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr)
     wlmtk_util_disconnect_listener(&clip_ptr->output_layout_change_listener);
     wlmtk_util_disconnect_listener(&clip_ptr->workspace_changed_listener);
     wlmtk_util_disconnect_listener(&clip_ptr->theme_changed_listener);
+    _wlmaker_clip_cancel_jobs(clip_ptr);
 
     if (wlmtk_tile_element(&clip_ptr->super_tile)->parent_container_ptr) {
         wlmtk_tile_set_content(&clip_ptr->super_tile, NULL);
@@ -356,18 +412,9 @@ void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr)
         clip_ptr->wlmtk_dock_ptr = NULL;
     }
 
-    if (NULL != clip_ptr->tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->tile_buffer_ptr);
-        clip_ptr->tile_buffer_ptr = NULL;
-    }
-    if (NULL != clip_ptr->prev_pressed_tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->prev_pressed_tile_buffer_ptr);
-        clip_ptr->prev_pressed_tile_buffer_ptr = NULL;
-    }
-    if (NULL != clip_ptr->next_pressed_tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->next_pressed_tile_buffer_ptr);
-        clip_ptr->next_pressed_tile_buffer_ptr = NULL;
-    }
+    wlr_buffer_drop_nullify(&clip_ptr->tile.wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&clip_ptr->prev_pressed_tile.wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&clip_ptr->next_pressed_tile.wlr_buffer_ptr);
 
     wlmbe_output_description_fini(&clip_ptr->output_description);
     free(clip_ptr);
@@ -469,32 +516,41 @@ bool _wlmaker_clip_pointer_button(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates the button textures, based on current state what's pressed. */
+/**
+ * Updates the button textures, based on current state what's pressed. Keeps
+ * the current texture while the one for the state is not drawn yet.
+ */
 static void _wlmaker_clip_apply_button_state(wlmaker_clip_t *clip_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = clip_ptr->tile_buffer_ptr;
+    struct wlr_buffer *wlr_buffer_ptr = clip_ptr->tile.wlr_buffer_ptr;
     if ((clip_ptr->pointer_inside_next_button ||
          clip_ptr->pointer_inside_next_button)&&
         clip_ptr->next_button_pressed) {
-        wlr_buffer_ptr = clip_ptr->next_pressed_tile_buffer_ptr;
+        wlr_buffer_ptr = clip_ptr->next_pressed_tile.wlr_buffer_ptr;
     } else if ((clip_ptr->pointer_inside_prev_button ||
                 clip_ptr->pointer_inside_prev_button) &&
                clip_ptr->prev_button_pressed) {
-        wlr_buffer_ptr = clip_ptr->prev_pressed_tile_buffer_ptr;
+        wlr_buffer_ptr = clip_ptr->prev_pressed_tile.wlr_buffer_ptr;
     }
+    if (NULL == wlr_buffer_ptr) return;
     wlmtk_tile_set_background_buffer(&clip_ptr->super_tile, wlr_buffer_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Updates the overlay buffer's content with workspace name and index. */
+/**
+ * Updates the overlay buffer's content with workspace name and index. The
+ * overlay is drawn on the rasterization pool, and keeps showing the previous
+ * content until then.
+ */
 bool _wlmaker_clip_update_overlay(
     wlmaker_clip_t *clip_ptr,
     const struct wlmtk_tile_style *tile_style_ptr,
     const wlmaker_config_clip_style_t *clip_style_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        tile_style_ptr->size, tile_style_ptr->size);
-    if (NULL == wlr_buffer_ptr) return false;
+    if (NULL != clip_ptr->overlay_job_ptr) {
+        wlmtk_raster_job_cancel(clip_ptr->overlay_job_ptr);
+        clip_ptr->overlay_job_ptr = NULL;
+    }
 
     int index = 0;
     const char *name_ptr = NULL;
@@ -502,11 +558,70 @@ bool _wlmaker_clip_update_overlay(
         wlmtk_desktop_get_current_workspace(clip_ptr->server_ptr->desktop_ptr),
         &name_ptr, &index);
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
+    wlmaker_clip_overlay_args_t args = {
+        .clip_style = *clip_style_ptr,
+        .size = tile_style_ptr->size,
+        .name_ptr = logged_strdup(NULL != name_ptr ? name_ptr : ""),
+        .index = index
+    };
+    if (NULL == args.name_ptr) return false;
+
+    // On failure, the name was not handed to the job: Still ours to free.
+    if (!wlmtk_raster_submit(
+            tile_style_ptr->size, tile_style_ptr->size,
+            _wlmaker_clip_draw_overlay,
+            &args, sizeof(args),
+            _wlmaker_clip_overlay_args_fini,
+            _wlmaker_clip_handle_overlay_drawn,
+            clip_ptr,
+            &clip_ptr->overlay_job_ptr)) {
+        free(args.name_ptr);
         return false;
     }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the overlay drawn by @ref _wlmaker_clip_update_overlay, and sets
+ * it as the tile's overlay.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref wlmaker_clip_t.
+ */
+void _wlmaker_clip_handle_overlay_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmaker_clip_t *clip_ptr = ud_ptr;
+    clip_ptr->overlay_job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw clip overlay %p", clip_ptr);
+        return;
+    }
+
+    wlmtk_buffer_set(&clip_ptr->overlay_buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+
+    wlmtk_tile_set_overlay(
+        &clip_ptr->super_tile,
+        wlmtk_buffer_element(&clip_ptr->overlay_buffer));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws workspace name and index. Runs
+ * on a worker thread, and must only access the arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmaker_clip_overlay_args_t.
+ *
+ * @return true.
+ */
+bool _wlmaker_clip_draw_overlay(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmaker_clip_overlay_args_t *args = args_ptr;
+    const wlmaker_config_clip_style_t *clip_style_ptr = &args->clip_style;
 
     cairo_select_font_face(
         cairo_ptr,
@@ -519,27 +634,29 @@ bool _wlmaker_clip_update_overlay(
         cairo_ptr,
         clip_style_ptr->font.size * 4 / 12,
         clip_style_ptr->font.size * 2 / 12 + clip_style_ptr->font.size);
-    cairo_show_text(cairo_ptr, name_ptr);
+    cairo_show_text(cairo_ptr, args->name_ptr);
 
     cairo_move_to(
         cairo_ptr,
-        tile_style_ptr->size - clip_style_ptr->font.size * 14 / 12,
-        tile_style_ptr->size - clip_style_ptr->font.size * 8 / 12);
+        args->size - clip_style_ptr->font.size * 14 / 12,
+        args->size - clip_style_ptr->font.size * 8 / 12);
     char buf[10];
-    snprintf(buf, sizeof(buf), "%d", index);
+    snprintf(buf, sizeof(buf), "%d", args->index);
     cairo_show_text(cairo_ptr, buf);
-
-    cairo_destroy(cairo_ptr);
-
-    wlmtk_buffer_set(&clip_ptr->overlay_buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
-
-    wlmtk_tile_set_overlay(
-        &clip_ptr->super_tile,
-        wlmtk_buffer_element(&clip_ptr->overlay_buffer));
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_raster_args_fini_t: Frees the copied name. */
+void _wlmaker_clip_overlay_args_fini(void *args_ptr)
+{
+    wlmaker_clip_overlay_args_t *args = args_ptr;
+    if (NULL != args->name_ptr) {
+        free(args->name_ptr);
+        args->name_ptr = NULL;
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /** Updates (reloads) the content image. */
 bool _wlmaker_clip_update_image(
@@ -562,7 +679,8 @@ bool _wlmaker_clip_update_image(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates (or updates) the tile buffers for the button states.
+ * Creates (or updates) the tile buffers for the button states. They are drawn
+ * on the rasterization pool; the previous buffers are kept until then.
  *
  * @param clip_ptr
  * @param tile_style_ptr
@@ -573,64 +691,119 @@ bool _wlmaker_clip_update_tiles(
     wlmaker_clip_t *clip_ptr,
     const struct wlmtk_tile_style *tile_style_ptr)
 {
-    struct wlr_buffer *tile, *tile_prev, *tile_next;
-    tile = _wlmaker_clip_create_tile(tile_style_ptr, false, false);
-    tile_prev = _wlmaker_clip_create_tile(tile_style_ptr, true, false);
-    tile_next = _wlmaker_clip_create_tile(tile_style_ptr, false, true);
-
-    if (NULL == tile || NULL == tile_prev || NULL == tile_next) {
-        if (tile) wlr_buffer_drop(tile);
-        if (tile_prev) wlr_buffer_drop(tile_prev);
-        if (tile_next) wlr_buffer_drop(tile_next);
-        return false;
-    }
-
-    if (NULL != clip_ptr->tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->tile_buffer_ptr);
-    }
-    if (NULL != clip_ptr->prev_pressed_tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->prev_pressed_tile_buffer_ptr);
-    }
-    if (NULL != clip_ptr->next_pressed_tile_buffer_ptr) {
-        wlr_buffer_drop(clip_ptr->next_pressed_tile_buffer_ptr);
-    }
-    clip_ptr->tile_buffer_ptr = tile;
-    clip_ptr->prev_pressed_tile_buffer_ptr = tile_prev;
-    clip_ptr->next_pressed_tile_buffer_ptr = tile_next;
-    _wlmaker_clip_apply_button_state(clip_ptr);
-    return true;
+    return (_wlmaker_clip_submit_tile(
+                &clip_ptr->tile, tile_style_ptr, false, false) &&
+            _wlmaker_clip_submit_tile(
+                &clip_ptr->prev_pressed_tile, tile_style_ptr, true, false) &&
+            _wlmaker_clip_submit_tile(
+                &clip_ptr->next_pressed_tile, tile_style_ptr, false, true));
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a wlr_buffer with texture suitable to show the 'next' and 'prev'
- * buttons in each raised or pressed state.
+ * Submits a job to (re)draw the tile buffer of `slot_ptr`. Cancels a pending
+ * job for that slot.
  *
+ * @param slot_ptr
  * @param tile_style_ptr
  * @param prev_pressed
  * @param next_pressed
  *
- * @return A wlr buffer.
+ * @return true on success.
  */
-struct wlr_buffer *_wlmaker_clip_create_tile(
+bool _wlmaker_clip_submit_tile(
+    wlmaker_clip_tile_slot_t *slot_ptr,
     const struct wlmtk_tile_style *tile_style_ptr,
     bool prev_pressed,
     bool next_pressed)
 {
-    struct wlr_buffer* wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        tile_style_ptr->size, tile_style_ptr->size);
-    if (NULL == wlr_buffer_ptr) return NULL;
+    if (NULL != slot_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(slot_ptr->job_ptr);
+        slot_ptr->job_ptr = NULL;
+    }
+
+    wlmaker_clip_tile_args_t args = {
+        .tile_style = *tile_style_ptr,
+        .prev_pressed = prev_pressed,
+        .next_pressed = next_pressed
+    };
+    return wlmtk_raster_submit(
+        tile_style_ptr->size, tile_style_ptr->size,
+        _wlmaker_clip_draw_tile,
+        &args, sizeof(args),
+        NULL,
+        _wlmaker_clip_handle_tile_drawn,
+        slot_ptr,
+        &slot_ptr->job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Cancels all pending rasterization jobs of the clip. */
+void _wlmaker_clip_cancel_jobs(wlmaker_clip_t *clip_ptr)
+{
+    wlmaker_clip_tile_slot_t *slots[] = {
+        &clip_ptr->tile,
+        &clip_ptr->prev_pressed_tile,
+        &clip_ptr->next_pressed_tile
+    };
+    for (size_t i = 0; i < sizeof(slots) / sizeof(slots[0]); ++i) {
+        if (NULL == slots[i]->job_ptr) continue;
+        wlmtk_raster_job_cancel(slots[i]->job_ptr);
+        slots[i]->job_ptr = NULL;
+    }
+    if (NULL != clip_ptr->overlay_job_ptr) {
+        wlmtk_raster_job_cancel(clip_ptr->overlay_job_ptr);
+        clip_ptr->overlay_job_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives a tile buffer drawn by @ref _wlmaker_clip_submit_tile. Stores it
+ * in the slot, and re-applies the button state.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref wlmaker_clip_tile_slot_t.
+ */
+void _wlmaker_clip_handle_tile_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmaker_clip_tile_slot_t *slot_ptr = ud_ptr;
+    slot_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw clip tile for %p",
+               slot_ptr->clip_ptr);
+        return;
+    }
+
+    wlr_buffer_drop_nullify(&slot_ptr->wlr_buffer_ptr);
+    slot_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    _wlmaker_clip_apply_button_state(slot_ptr->clip_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the texture suitable to show the
+ * 'next' and 'prev' buttons in each raised or pressed state. Runs on a worker
+ * thread, and must only access the arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmaker_clip_tile_args_t.
+ *
+ * @return true.
+ */
+bool _wlmaker_clip_draw_tile(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmaker_clip_tile_args_t *args = args_ptr;
+    const struct wlmtk_tile_style *tile_style_ptr = &args->tile_style;
+    bool prev_pressed = args->prev_pressed;
+    bool next_pressed = args->next_pressed;
 
     double tsize = tile_style_ptr->size;
     double bsize = 22.0 / 64.0 * tile_style_ptr->size;
     double margin = tile_style_ptr->bezel_width;
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
-    }
-
     wlmaker_primitives_cairo_fill(cairo_ptr, &tile_style_ptr->fill);
 
     // Northern + Western sides. Drawn clock-wise.
@@ -783,9 +956,7 @@ struct wlr_buffer *_wlmaker_clip_create_tile(
     cairo_line_to(cairo_ptr, tpad, tsize - tpad - trsize);
     cairo_line_to(cairo_ptr, tpad, tsize - tpad);
     cairo_fill(cairo_ptr);
-
-    cairo_destroy(cairo_ptr);
-    return wlr_buffer_ptr;
+    return true;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -929,10 +1100,12 @@ void _wlmaker_clip_handle_theme_changed(
 /* == Unit tests =========================================================== */
 
 static void test_draw_tile(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 /** Test cases. */
 static const bs_test_case_t wlmaker_clip_test_cases[] = {
     { true, "draw_tile", test_draw_tile },
+    { true, "deferred", test_deferred },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -951,22 +1124,91 @@ void test_draw_tile(bs_test_t *test_ptr)
         .bezel_width = 2,
         .size = 64
     };
-    struct wlr_buffer* wlr_buffer_ptr;
-    bs_gfxbuf_t *gfxbuf_ptr;
-
-    wlr_buffer_ptr = _wlmaker_clip_create_tile(&style, false, false);
-    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlr_buffer_ptr);
-    gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    wlmaker_clip_tile_args_t args = { .tile_style = style };
+    cairo_t *cairo_ptr;
+
+    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(style.size, style.size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, gfxbuf_ptr);
+    cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_clip_draw_tile(cairo_ptr, &args));
+    cairo_destroy(cairo_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr, gfxbuf_ptr, "clip_raised.png");
-    wlr_buffer_drop(wlr_buffer_ptr);
 
-    wlr_buffer_ptr = _wlmaker_clip_create_tile(&style, true, true);
-    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlr_buffer_ptr);
-    gfxbuf_ptr = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr);
+    args.prev_pressed = true;
+    args.next_pressed = true;
+    bs_gfxbuf_clear(gfxbuf_ptr, 0);
+    cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cairo_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_clip_draw_tile(cairo_ptr, &args));
+    cairo_destroy(cairo_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr, gfxbuf_ptr, "clip_pressed.png");
-    wlr_buffer_drop(wlr_buffer_ptr);
+    bs_gfxbuf_destroy(gfxbuf_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests drawing the tiles on the rasterization pool. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wlmtk_tile_style style = {
+        .fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff203040 } }
+        },
+        .bezel_width = 2,
+        .size = 64
+    };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    // Just what the tile slots need.
+    wlmaker_clip_t clip = {};
+    clip.tile.clip_ptr = &clip;
+    clip.next_pressed_tile.clip_ptr = &clip;
+    clip.prev_pressed_tile.clip_ptr = &clip;
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr, wlmtk_tile_init(&clip.super_tile, &style));
+
+    // No buffer until the job is handed back.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_clip_update_tiles(&clip, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, clip.tile.job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, clip.tile.wlr_buffer_ptr);
+
+    // The style changes while the jobs are pending: The new style is shown.
+    style.fill.param.solid.color = 0xff405060;
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_clip_update_tiles(&clip, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, clip.tile.wlr_buffer_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(
+            wl_event_loop_ptr, &clip.tile.wlr_buffer_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, clip.tile.job_ptr);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(clip.tile.wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff405060, g->data_ptr[32 * g->pixels_per_line + 32]);
+
+    // Cancelling, as on destroy: Destroying the pool then hands back all
+    // jobs. The cancelled ones must not be applied.
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlmaker_clip_update_tiles(&clip, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, clip.prev_pressed_tile.job_ptr);
+    _wlmaker_clip_cancel_jobs(&clip);
+    struct wlr_buffer *wlr_buffer_ptr = clip.prev_pressed_tile.wlr_buffer_ptr;
+    wlmtk_raster_pool_destroy(pool_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, wlr_buffer_ptr, clip.prev_pressed_tile.wlr_buffer_ptr);
+
+    wlmtk_tile_fini(&clip.super_tile);
+    wlr_buffer_drop_nullify(&clip.tile.wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&clip.next_pressed_tile.wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&clip.prev_pressed_tile.wlr_buffer_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
 }
 
 /* == End of clip.c ======================================================== */
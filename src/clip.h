@@ -35,6 +35,7 @@ typedef struct _wlmaker_clip_t wlmaker_clip_t;
 
 #include "config.h"
 #include "server.h"
+#include "util/files.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -61,6 +62,15 @@ wlmaker_clip_t *wlmaker_clip_create(
  */
 void wlmaker_clip_destroy(wlmaker_clip_t *clip_ptr);
 
+/**
+ * Resolves the Clip's image to a full path, within `${XDG_DATA_DIRS}/wlmaker`.
+ *
+ * @param files_ptr
+ *
+ * @return The path, or NULL if not found. Must be released by free().
+ */
+char *wlmaker_clip_resolve_image(wlm_util_files_t *files_ptr);
+
 /** Unit test set. */
 extern const bs_test_set_t wlmaker_clip_test_set;
 
@@ -38,6 +38,7 @@
 #include "default_configuration.h"
 #include "default_state.h"
 #include "input/cursor.h"
+#include "util/startup.h"
 
 /* == Declarations ========================================================= */
 
@@ -196,31 +197,34 @@ bool wlmaker_theme_load(
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Loads a plist object from the file or the default data. */
+/**
+ * Loads a plist object from the file or the default data. Traced as startup
+ * phase `name_ptr`.
+ */
 bspl_object_t *_wlmaker_plist_load(
     const char *name_ptr,
     const char *fname_ptr,
     const uint8_t *default_data_ptr,
     size_t default_data_size)
 {
+    bspl_object_t *object_ptr = NULL;
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin(name_ptr);
     if (NULL != fname_ptr) {
         bs_log(BS_INFO, "Loading %s plist from file \"%s\"",
                name_ptr, fname_ptr);
-        bspl_object_t *object_ptr = bspl_create_object_from_plist_file(
-            fname_ptr);
+        object_ptr = bspl_create_object_from_plist_file(fname_ptr);
         if (NULL == object_ptr) {
             bs_log(BS_ERROR,
                    "Failed bspl_create_object_from_plist(\"%s\") for %s",
                    fname_ptr, name_ptr);
         }
-        return object_ptr;
+    } else if (NULL != default_data_ptr) {
+        bs_log(BS_INFO, "Using compiled-in data for %s plist.", name_ptr);
+        object_ptr = bspl_create_object_from_plist_data(
+            default_data_ptr, default_data_size);
     }
-
-    if (NULL == default_data_ptr) return NULL;
-
-    bs_log(BS_INFO, "Using compiled-in data for %s plist.", name_ptr);
-    return bspl_create_object_from_plist_data(
-        default_data_ptr, default_data_size);
+    wlm_util_startup_phase_end(&phase);
+    return object_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -185,6 +185,7 @@ wlmaker_dock_t *wlmaker_dock_create(
         wlmaker_launcher_t *launcher_ptr = wlmaker_launcher_create_from_plist(
             &style_ptr->tile, dict_ptr,
             server_ptr->monitor_ptr,
+            server_ptr->launch_tracker_ptr,
             server_ptr->files_ptr);
         if (NULL == launcher_ptr) {
             wlmaker_dock_destroy(dock_ptr);
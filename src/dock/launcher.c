@@ -31,6 +31,7 @@
 #include <sys/stat.h>
 
 #include "toolkit/toolkit.h"
+#include "util/launch_tracker.h"
 
 struct wlm_util_subprocess;
 
@@ -358,28 +359,21 @@ bool _wlmdock_launcher_pointer_button(
  */
 void _wlmdock_launcher_start(wlmdock_launcher_t *launcher_ptr)
 {
-    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
-        launcher_ptr->cmdline_ptr);
-    if (NULL == subprocess_ptr) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
-               launcher_ptr->cmdline_ptr);
-        return;
-    }
-
-    if (!bs_subprocess_start(subprocess_ptr)) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_start for %s",
-               launcher_ptr->cmdline_ptr);
-        bs_subprocess_destroy(subprocess_ptr);
-        return;
-    }
-
+    // The compositor correlates the first window through the environment.
+    wlm_util_launch_tracker_setenv(launcher_ptr->cmdline_ptr);
     struct wlm_util_subprocess *subprocess_handle_ptr;
-    subprocess_handle_ptr = wlm_util_subprocess_monitor_entrust(
+    subprocess_handle_ptr = wlm_util_subprocess_monitor_spawn(
         launcher_ptr->monitor_ptr,
-        subprocess_ptr,
+        launcher_ptr->cmdline_ptr,
         _wlmdock_launcher_handle_terminated,
         launcher_ptr,
         NULL);
+    wlm_util_launch_tracker_unsetenv();
+    if (NULL == subprocess_handle_ptr) {
+        bs_log(BS_ERROR, "Failed wlm_util_subprocess_monitor_spawn for %s",
+               launcher_ptr->cmdline_ptr);
+        return;
+    }
 
     if (!bs_ptr_set_insert(launcher_ptr->subprocesses_ptr,
                            subprocess_handle_ptr)) {
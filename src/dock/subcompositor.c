@@ -92,6 +92,13 @@ struct _wlmdock_subcompositor_t {
     int                       configured_width;
     /** The configured height of the layou't surface, in pixels. */
     int                       configured_height;
+
+    /** Whether a mode was committed to the output. */
+    bool                      mode_committed;
+    /** Width of the last committed mode, in pixels. */
+    int                       committed_width;
+    /** Height of the last committed mode, in pixels. */
+    int                       committed_height;
 };
 
 static void _wlmdock_subcompositor_request_size(
@@ -117,7 +124,9 @@ static void _wlmdock_subcompositor_handle_layer_surface_configure(
     void *userdata_ptr,
     uint32_t width,
     uint32_t height);
-static void _wlmdock_subcompositor_commit(
+static bool _wlmdock_subcompositor_commit(
+    wlmdock_subcompositor_t *subcompositor_ptr);
+static bool _wlmdock_subcompositor_render(
     wlmdock_subcompositor_t *subcompositor_ptr);
 
 /* == Data ================================================================= */
@@ -439,7 +448,14 @@ static void _wlmdock_subcompositor_handle_wlclient_keyboard_repeat_info(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Commits the frame. */
+/**
+ * Commits a pending mode and the frame, if the scene has damage.
+ *
+ * The wayland backend only requests a frame callback from the parent
+ * compositor when a buffer was committed. Skipping the commit of an undamaged
+ * scene will therefore stop the frame loop, until the scene gets damaged and
+ * schedules a new frame. Frame-done is only sent for a committed frame.
+ */
 void _wlmdock_subcompositor_handle_output_frame(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
@@ -447,10 +463,7 @@ void _wlmdock_subcompositor_handle_output_frame(
     wlmdock_subcompositor_t *subcompositor_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmdock_subcompositor_t, output_frame_listener);
 
-    if (!wlr_scene_output_commit(subcompositor_ptr->wlr_scene_output_ptr, NULL)) {
-        bs_log(BS_WARNING, "wlr_scene_output_commit(%p, NULL) failed.",
-               subcompositor_ptr->wlr_scene_output_ptr);
-    }
+    if (!_wlmdock_subcompositor_commit(subcompositor_ptr)) return;
 
     struct timespec now;
     clock_gettime(CLOCK_MONOTONIC, &now);
@@ -486,18 +499,35 @@ void _wlmdock_subcompositor_handle_layer_surface_configure(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Commits output dimensions and scene graph. */
-void _wlmdock_subcompositor_commit(wlmdock_subcompositor_t *subcompositor_ptr)
+/**
+ * Commits output dimensions, if changed, and the scene graph, if damaged.
+ *
+ * If committing the mode fails, a frame is scheduled to retry on the next
+ * frame.
+ *
+ * @param subcompositor_ptr
+ *
+ * @return true if a frame was committed.
+ */
+bool _wlmdock_subcompositor_commit(wlmdock_subcompositor_t *subcompositor_ptr)
 {
     if (NULL == subcompositor_ptr->wlr_output_ptr ||
-        NULL == subcompositor_ptr->wlr_scene_output_ptr) return;
+        NULL == subcompositor_ptr->wlr_scene_output_ptr) return false;
+
+    bool enabled = (subcompositor_ptr->configured_width != 0 &&
+                    subcompositor_ptr->configured_height != 0);
+    if (subcompositor_ptr->mode_committed &&
+        subcompositor_ptr->wlr_output_ptr->enabled == enabled &&
+        subcompositor_ptr->committed_width ==
+        subcompositor_ptr->configured_width &&
+        subcompositor_ptr->committed_height ==
+        subcompositor_ptr->configured_height) {
+        return _wlmdock_subcompositor_render(subcompositor_ptr);
+    }
 
     struct wlr_output_state state;
     wlr_output_state_init(&state);
-    wlr_output_state_set_enabled(
-        &state,
-        subcompositor_ptr->configured_width != 0 &&
-        subcompositor_ptr->configured_height != 0);
+    wlr_output_state_set_enabled(&state, enabled);
     wlr_output_state_set_custom_mode(
         &state,
         subcompositor_ptr->configured_width,
@@ -509,13 +539,39 @@ void _wlmdock_subcompositor_commit(wlmdock_subcompositor_t *subcompositor_ptr)
                &state,
                subcompositor_ptr->configured_width,
                subcompositor_ptr->configured_height);
+        wlr_output_state_finish(&state);
+        wlr_output_schedule_frame(subcompositor_ptr->wlr_output_ptr);
+        return false;
     }
+    subcompositor_ptr->mode_committed = true;
+    subcompositor_ptr->committed_width = subcompositor_ptr->configured_width;
+    subcompositor_ptr->committed_height = subcompositor_ptr->configured_height;
     wlr_output_state_finish(&state);
 
+    return _wlmdock_subcompositor_render(subcompositor_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Renders and commits the scene to the output, if it needs a frame.
+ *
+ * `wlr_scene_output_commit` already skips disabled outputs and undamaged
+ * scenes, but reports success for these. Whether a frame was committed is
+ * told by the output's commit sequence.
+ *
+ * @param subcompositor_ptr
+ *
+ * @return true if a frame was committed.
+ */
+bool _wlmdock_subcompositor_render(wlmdock_subcompositor_t *subcompositor_ptr)
+{
+    uint32_t commit_seq = subcompositor_ptr->wlr_output_ptr->commit_seq;
     if (!wlr_scene_output_commit(subcompositor_ptr->wlr_scene_output_ptr, NULL)) {
         bs_log(BS_WARNING, "Failed wlr_scene_output_commit(%p, NULL)",
                subcompositor_ptr->wlr_scene_output_ptr);
+        return false;
     }
+    return commit_seq != subcompositor_ptr->wlr_output_ptr->commit_seq;
 }
 
 /* == Unit Tests =========================================================== */
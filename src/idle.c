@@ -49,12 +49,23 @@ struct _wlmaker_idle_monitor_t {
     /** Dictionnary holding the 'ScreenLock' configuration. */
     bspl_dict_t             *lock_config_dict_ptr;
 
+    /** Idle time before locking, in milliseconds. 0 to not lock. */
+    int                       idle_msec;
+    /** Idle time before powering off, in milliseconds. 0 to keep on. */
+    int                       power_off_msec;
+
     /** Reference to the event loop. */
     struct wl_event_loop      *wl_event_loop_ptr;
     /** The timer's event source. */
     struct wl_event_source    *timer_event_source_ptr;
     /** Whether the timer expired. Reset in @ref wlmaker_idle_monitor_reset. */
     bool                      timer_expired;
+    /** The power-off timer's event source. Runs also while locked. */
+    struct wl_event_source    *power_timer_event_source_ptr;
+    /** Whether the power-off timer expired. */
+    bool                      power_timer_expired;
+    /** Whether the outputs were powered off by this monitor. */
+    bool                      powered_off;
 
     /** Listener for `new_inhibitor` of wlr_idle_inhibit_manager_v1`. */
     struct wl_listener        new_inhibitor_listener;
@@ -93,8 +104,13 @@ struct _wlmaker_idle_inhibitor_t {
 static void _wlmaker_idle_monitor_consider_locking(
     wlmaker_idle_monitor_t *idle_monitor_ptr);
 static int _wlmaker_idle_monitor_timer(void *data_ptr);
+static void _wlmaker_idle_monitor_consider_power_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr);
+static int _wlmaker_idle_monitor_power_timer(void *data_ptr);
 
-static int _wlmaker_idle_msec(wlmaker_idle_monitor_t *idle_monitor_ptr);
+static int _wlmaker_idle_msec(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    const char *key_ptr);
 static bool _wlmaker_idle_monitor_add_inhibitor(
     wlmaker_idle_monitor_t *idle_monitor_ptr,
     struct wlr_idle_inhibitor_v1 *wlr_idle_inhibitor_v1_ptr);
@@ -128,6 +144,10 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
+    // Parsed once here: @ref wlmaker_idle_monitor_reset runs on every input.
+    monitor_ptr->idle_msec = _wlmaker_idle_msec(monitor_ptr, "IdleSeconds");
+    monitor_ptr->power_off_msec = _wlmaker_idle_msec(
+        monitor_ptr, "PowerOffSeconds");
 
     monitor_ptr->wlr_idle_inhibit_manager_v1_ptr =
         wlr_idle_inhibit_v1_create(server_ptr->wl_display_ptr);
@@ -157,13 +177,34 @@ wlmaker_idle_monitor_t *wlmaker_idle_monitor_create(
 
     if (0 != wl_event_source_timer_update(
             monitor_ptr->timer_event_source_ptr,
-            _wlmaker_idle_msec(monitor_ptr))) {
+            monitor_ptr->idle_msec)) {
         bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p, 1000)",
                monitor_ptr->timer_event_source_ptr);
         wlmaker_idle_monitor_destroy(monitor_ptr);
         return NULL;
     }
 
+    monitor_ptr->power_timer_event_source_ptr = wl_event_loop_add_timer(
+        monitor_ptr->wl_event_loop_ptr,
+        _wlmaker_idle_monitor_power_timer,
+        monitor_ptr);
+    if (NULL == monitor_ptr->power_timer_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_timer(%p, %p, %p)",
+               monitor_ptr->wl_event_loop_ptr,
+               _wlmaker_idle_monitor_power_timer,
+               monitor_ptr);
+        wlmaker_idle_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+    if (0 != wl_event_source_timer_update(
+            monitor_ptr->power_timer_event_source_ptr,
+            monitor_ptr->power_off_msec)) {
+        bs_log(BS_ERROR, "Failed wl_event_source_timer_update(%p)",
+               monitor_ptr->power_timer_event_source_ptr);
+        wlmaker_idle_monitor_destroy(monitor_ptr);
+        return NULL;
+    }
+
     return monitor_ptr;
 }
 
@@ -178,6 +219,10 @@ void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr)
         wl_event_source_remove(idle_monitor_ptr->timer_event_source_ptr);
         idle_monitor_ptr->timer_event_source_ptr = NULL;
     }
+    if (NULL != idle_monitor_ptr->power_timer_event_source_ptr) {
+        wl_event_source_remove(idle_monitor_ptr->power_timer_event_source_ptr);
+        idle_monitor_ptr->power_timer_event_source_ptr = NULL;
+    }
 
     if (NULL != idle_monitor_ptr->lock_config_dict_ptr) {
         bspl_dict_unref(idle_monitor_ptr->lock_config_dict_ptr);
@@ -192,11 +237,24 @@ void wlmaker_idle_monitor_destroy(wlmaker_idle_monitor_t *idle_monitor_ptr)
 /* ------------------------------------------------------------------------- */
 void wlmaker_idle_monitor_reset(wlmaker_idle_monitor_t *idle_monitor_ptr)
 {
+    // Activity powers the outputs back on, and re-arms the power-off timer.
+    // Both also apply while locked: The lock screen needs to be visible.
+    if (idle_monitor_ptr->powered_off) {
+        wlmbe_backend_set_power(idle_monitor_ptr->server_ptr->backend_ptr,
+                                true);
+        idle_monitor_ptr->powered_off = false;
+    }
+    int rv = wl_event_source_timer_update(
+        idle_monitor_ptr->power_timer_event_source_ptr,
+        idle_monitor_ptr->power_off_msec);
+    BS_ASSERT(0 == rv);
+    idle_monitor_ptr->power_timer_expired = false;
+
     if (idle_monitor_ptr->locked) return;
 
-    int rv = wl_event_source_timer_update(
+    rv = wl_event_source_timer_update(
         idle_monitor_ptr->timer_event_source_ptr,
-        _wlmaker_idle_msec(idle_monitor_ptr));
+        idle_monitor_ptr->idle_msec);
     BS_ASSERT(0 == rv);
     idle_monitor_ptr->timer_expired = false;
 }
@@ -211,31 +269,11 @@ bool wlmaker_idle_monitor_lock(wlmaker_idle_monitor_t *idle_monitor_ptr)
         return false;
     }
 
-    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(cmd_ptr);
-    if (NULL == subprocess_ptr) {
-        bs_log(BS_WARNING, "Failed bs_subprocess_create_cmdline(\"%s\")",
-               cmd_ptr);
+    if (!wlm_util_subprocess_monitor_run_cmdline(
+            idle_monitor_ptr->server_ptr->monitor_ptr, cmd_ptr)) {
+        bs_log(BS_WARNING, "Failed to launch \"%s\".", cmd_ptr);
         return false;
     }
-
-    if (!bs_subprocess_start(subprocess_ptr)) {
-        bs_log(BS_WARNING, "Failed bs_subprocess_start(%p) for \"%s\".",
-               subprocess_ptr, cmd_ptr);
-        bs_subprocess_destroy(subprocess_ptr);
-        return false;
-    }
-
-    struct wlm_util_subprocess *handle_ptr =
-        wlm_util_subprocess_monitor_entrust(
-            idle_monitor_ptr->server_ptr->monitor_ptr,
-            subprocess_ptr,
-            NULL,
-            NULL,
-            NULL);
-    if (NULL != handle_ptr) {
-        wlm_util_subprocess_monitor_cede(
-            idle_monitor_ptr->server_ptr->monitor_ptr, handle_ptr);
-    }
     return true;
 }
 
@@ -251,6 +289,7 @@ void wlmaker_idle_monitor_uninhibit(wlmaker_idle_monitor_t *idle_monitor_ptr)
     BS_ASSERT(0 < idle_monitor_ptr->inhibits);
     --idle_monitor_ptr->inhibits;
     _wlmaker_idle_monitor_consider_locking(idle_monitor_ptr);
+    _wlmaker_idle_monitor_consider_power_off(idle_monitor_ptr);
 }
 
 /* == Local (static) methods =============================================== */
@@ -294,27 +333,63 @@ int _wlmaker_idle_monitor_timer(void *data_ptr)
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Powers off all outputs, if not inhibited & the power timer expired. */
+void _wlmaker_idle_monitor_consider_power_off(
+    wlmaker_idle_monitor_t *idle_monitor_ptr)
+{
+    if (0 < idle_monitor_ptr->inhibits ||
+        !idle_monitor_ptr->power_timer_expired ||
+        idle_monitor_ptr->powered_off) return;
+
+    // Marked as powered off even on partial failure, so that the next
+    // activity attempts to power all outputs back on.
+    wlmbe_backend_set_power(idle_monitor_ptr->server_ptr->backend_ptr, false);
+    idle_monitor_ptr->powered_off = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Timer function for powering off the outputs. See
+ * @ref _wlmaker_idle_monitor_timer.
+ *
+ * @param data_ptr            Untyped pointer to @ref wlmaker_idle_monitor_t.
+ *
+ * @return 0.
+ */
+int _wlmaker_idle_monitor_power_timer(void *data_ptr)
+{
+    wlmaker_idle_monitor_t *idle_monitor_ptr = data_ptr;
+
+    idle_monitor_ptr->power_timer_expired = true;
+    _wlmaker_idle_monitor_consider_power_off(idle_monitor_ptr);
+    return 0;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Returns the idle timeout time in milliseconds.
  *
  * @param idle_monitor_ptr
+ * @param key_ptr             Key in the 'ScreenLock' dict, eg. `IdleSeconds`.
  *
  * @return The idle timeout, read from the config dictionnary. If no or a
  *     negative value was configured, 0 is returned, indicating the timer
  *     to NOT be armed.
  */
-int _wlmaker_idle_msec(wlmaker_idle_monitor_t *idle_monitor_ptr)
+int _wlmaker_idle_msec(
+    wlmaker_idle_monitor_t *idle_monitor_ptr,
+    const char *key_ptr)
 {
     const char *idle_seconds_ptr = bspl_dict_get_string_value(
-        idle_monitor_ptr->lock_config_dict_ptr, "IdleSeconds");
+        idle_monitor_ptr->lock_config_dict_ptr, key_ptr);
     if (NULL == idle_seconds_ptr) return 0;
 
     uint64_t seconds;
     if (!bs_strconvert_uint64(idle_seconds_ptr, &seconds, 10) ||
         seconds >= (INT32_MAX / 1000)) {
-        bs_log(BS_WARNING, "Bad value for 'IdleSeconds': %s",
-               idle_seconds_ptr);
+        bs_log(BS_WARNING, "Bad value for '%s': %s",
+               key_ptr, idle_seconds_ptr);
         return 0;
     }
 
@@ -26,6 +26,7 @@
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <linux/input-event-codes.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 #include <wayland-server-core.h>
@@ -88,6 +89,18 @@ struct _wlmim_cursor_t {
     bool                      left_button_emulates_right;
 };
 
+/** A cursor theme, loaded ahead by @ref wlmim_cursor_prefetch_run. */
+struct _wlmim_cursor_prefetch_t {
+    /** Name of the cursor theme. */
+    char                      *theme_name_ptr;
+    /** Size of the cursor theme. */
+    uint64_t                  size;
+    /** The loaded theme, or NULL if loading failed. */
+    struct wlr_xcursor_manager *wlr_xcursor_manager_ptr;
+    /** Whether @ref wlmim_cursor_prefetch_run has completed. */
+    bool                      done;
+};
+
 static void _wlmim_cursor_handle_cursor_shape_manager_v1_destroy(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -120,6 +133,9 @@ static void _wlmim_cursor_process_motion(
     uint32_t time_msec);
 
 char *_wlmim_cursor_get_theme_name(const struct wlmim_cursor_style *style_ptr);
+static struct wlr_xcursor_manager *_wlmim_cursor_prefetch_take(
+    const char *theme_name_ptr,
+    uint64_t size);
 static int _wlmim_cursor_theme_handler(
     void *ud_ptr,
     const char *section_ptr,
@@ -159,6 +175,14 @@ static const char *_wlmim_cursor_system_config_file =
 static const char *_wlmim_cursor_system_config_alternative_file =
     "/etc/alternatives/x-cursor-theme";
 
+/** Guards @ref _wlmim_cursor_prefetch_ptr. */
+static pthread_mutex_t _wlmim_cursor_prefetch_mutex =
+    PTHREAD_MUTEX_INITIALIZER;
+/** Signals completion of @ref wlmim_cursor_prefetch_run. */
+static pthread_cond_t _wlmim_cursor_prefetch_cond = PTHREAD_COND_INITIALIZER;
+/** The pending prefetch, consumed by @ref wlmim_cursor_set_style. */
+static wlmim_cursor_prefetch_t *_wlmim_cursor_prefetch_ptr = NULL;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -301,8 +325,14 @@ bool wlmim_cursor_set_style(
     char *theme_name_ptr = _wlmim_cursor_get_theme_name(style_ptr);
     if (NULL == theme_name_ptr) return false;
 
-    struct wlr_xcursor_manager *wxm_ptr = wlr_xcursor_manager_create(
+    struct wlr_xcursor_manager *wxm_ptr = _wlmim_cursor_prefetch_take(
         theme_name_ptr, style_ptr->size);
+    if (NULL != wxm_ptr) {
+        free(theme_name_ptr);
+        goto loaded;
+    }
+
+    wxm_ptr = wlr_xcursor_manager_create(theme_name_ptr, style_ptr->size);
     if (NULL == wxm_ptr) {
         bs_log(BS_ERROR,
                "Failed wlr_xcursor_manager_create(\"%s\", %"PRIu64")",
@@ -320,6 +350,7 @@ bool wlmim_cursor_set_style(
     }
     free(theme_name_ptr);
 
+loaded:
     if (NULL != cursor_ptr->pointer_ptr) {
         wlmtk_pointer_set_xcursor_manager(cursor_ptr->pointer_ptr, wxm_ptr);
     }
@@ -330,6 +361,52 @@ bool wlmim_cursor_set_style(
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+wlmim_cursor_prefetch_t *wlmim_cursor_prefetch_create(
+    const struct wlmim_cursor_style *style_ptr)
+{
+    wlmim_cursor_prefetch_t *prefetch_ptr = logged_calloc(
+        1, sizeof(wlmim_cursor_prefetch_t));
+    if (NULL == prefetch_ptr) return NULL;
+    prefetch_ptr->theme_name_ptr = _wlmim_cursor_get_theme_name(style_ptr);
+    if (NULL == prefetch_ptr->theme_name_ptr) {
+        free(prefetch_ptr);
+        return NULL;
+    }
+    prefetch_ptr->size = style_ptr->size;
+
+    pthread_mutex_lock(&_wlmim_cursor_prefetch_mutex);
+    bool pending = NULL != _wlmim_cursor_prefetch_ptr;
+    if (!pending) _wlmim_cursor_prefetch_ptr = prefetch_ptr;
+    pthread_mutex_unlock(&_wlmim_cursor_prefetch_mutex);
+    if (pending) {
+        bs_log(BS_WARNING, "Cursor theme prefetch already pending.");
+        free(prefetch_ptr->theme_name_ptr);
+        free(prefetch_ptr);
+        return NULL;
+    }
+    return prefetch_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmim_cursor_prefetch_run(void *prefetch_ptr)
+{
+    wlmim_cursor_prefetch_t *p_ptr = prefetch_ptr;
+    struct wlr_xcursor_manager *wxm_ptr = wlr_xcursor_manager_create(
+        p_ptr->theme_name_ptr, p_ptr->size);
+    if (NULL != wxm_ptr && !wlr_xcursor_manager_load(wxm_ptr, 1.0)) {
+        wlr_xcursor_manager_destroy(wxm_ptr);
+        wxm_ptr = NULL;
+    }
+
+    // Once done, the prefetch may be taken and destroyed: Don't touch it.
+    pthread_mutex_lock(&_wlmim_cursor_prefetch_mutex);
+    p_ptr->wlr_xcursor_manager_ptr = wxm_ptr;
+    p_ptr->done = true;
+    pthread_cond_broadcast(&_wlmim_cursor_prefetch_cond);
+    pthread_mutex_unlock(&_wlmim_cursor_prefetch_mutex);
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlr_cursor *wlmim_cursor_wlr_cursor(wlmim_cursor_t *cursor_ptr)
 {
@@ -642,6 +719,44 @@ char *_wlmim_cursor_get_theme_name(const struct wlmim_cursor_style *style_ptr)
     return logged_strdup(style_ptr->name_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Takes the pending prefetch, waiting for it to complete.
+ *
+ * @param theme_name_ptr
+ * @param size
+ *
+ * @return The prefetched cursor theme, if it matches `theme_name_ptr` and
+ *     `size`. NULL otherwise, or if there was no prefetch. The prefetch is
+ *     consumed either way.
+ */
+struct wlr_xcursor_manager *_wlmim_cursor_prefetch_take(
+    const char *theme_name_ptr,
+    uint64_t size)
+{
+    pthread_mutex_lock(&_wlmim_cursor_prefetch_mutex);
+    wlmim_cursor_prefetch_t *prefetch_ptr = _wlmim_cursor_prefetch_ptr;
+    while (NULL != prefetch_ptr && !prefetch_ptr->done) {
+        pthread_cond_wait(&_wlmim_cursor_prefetch_cond,
+                          &_wlmim_cursor_prefetch_mutex);
+    }
+    _wlmim_cursor_prefetch_ptr = NULL;
+    pthread_mutex_unlock(&_wlmim_cursor_prefetch_mutex);
+    if (NULL == prefetch_ptr) return NULL;
+
+    struct wlr_xcursor_manager *wxm_ptr =
+        prefetch_ptr->wlr_xcursor_manager_ptr;
+    if (NULL != wxm_ptr && (
+            size != prefetch_ptr->size ||
+            0 != strcmp(theme_name_ptr, prefetch_ptr->theme_name_ptr))) {
+        wlr_xcursor_manager_destroy(wxm_ptr);
+        wxm_ptr = NULL;
+    }
+    free(prefetch_ptr->theme_name_ptr);
+    free(prefetch_ptr);
+    return wxm_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 /** inih library parser callback for the system-wide cursor theme files. */
 int _wlmim_cursor_theme_handler(
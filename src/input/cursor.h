@@ -101,6 +101,29 @@ bool wlmim_cursor_set_style(
     wlmim_cursor_t *cursor_ptr,
     const struct wlmim_cursor_style *style_ptr);
 
+/** Forward declaration: A cursor theme, loaded ahead of the cursor. */
+typedef struct _wlmim_cursor_prefetch_t wlmim_cursor_prefetch_t;
+
+/**
+ * Registers a prefetch of the cursor theme for `style_ptr`. The next call to
+ * @ref wlmim_cursor_set_style waits for it to complete, and uses the theme if
+ * the style matches. At most one prefetch may be pending.
+ *
+ * @param style_ptr
+ *
+ * @return The prefetch, or NULL on error. Must be passed to
+ *     @ref wlmim_cursor_prefetch_run.
+ */
+wlmim_cursor_prefetch_t *wlmim_cursor_prefetch_create(
+    const struct wlmim_cursor_style *style_ptr);
+
+/**
+ * Loads the cursor theme. May run on any thread.
+ *
+ * @param prefetch_ptr        Points to a @ref wlmim_cursor_prefetch_t.
+ */
+void wlmim_cursor_prefetch_run(void *prefetch_ptr);
+
 /** @return @ref wlmim_cursor_t::wlr_cursor_ptr. */
 struct wlr_cursor *wlmim_cursor_wlr_cursor(wlmim_cursor_t *cursor_ptr);
 
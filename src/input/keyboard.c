@@ -22,13 +22,22 @@
 #include "keyboard.h"
 
 #include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <ini.h>
+#include <inttypes.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #define WLR_USE_UNSTABLE
@@ -39,6 +48,14 @@
 
 #include "toolkit/toolkit.h"
 
+#if !defined(WLMIM_XKBCOMMON_VERSION)
+/** Version of xkbcommon. Part of the keymap cache key. */
+#define WLMIM_XKBCOMMON_VERSION "unknown"
+#endif  // WLMIM_XKBCOMMON_VERSION
+
+/** First word of a keymap cache file. Followed by the key, and the keymap. */
+#define _WLMIM_KEYMAP_CACHE_MAGIC "wlmaker-xkb-keymap"
+
 /* == Declarations ========================================================= */
 
 /** Keyboard handle. */
@@ -61,6 +78,23 @@ struct _wlmim_keyboard_t {
     struct xkb_keymap         *xkb_keymap_ptr;
 };
 
+/** Keymap configuration, decoded for @ref wlmim_keyboard_prefetch_run. */
+struct _wlmim_keyboard_prefetch_t {
+    /** The RMLVO names. Point into @ref names. */
+    struct xkb_rule_names     rules;
+    /** Copies of the names: Rules, model, layout, variant and options. */
+    char                      *names[5];
+    /** Directory for the keymap cache, or NULL. */
+    char                      *cache_dir_ptr;
+};
+
+/** Where @ref _wlmim_keyboard_xkb_from_rules got the keymap from. */
+typedef enum {
+    WLMIM_KEYMAP_SHARED,
+    WLMIM_KEYMAP_CACHED,
+    WLMIM_KEYMAP_COMPILED
+} wlmim_keymap_source_t;
+
 static bspl_dict_t *_wlmim_keyboard_populate_rules(
     bspl_dict_t *dict_ptr,
     struct xkb_rule_names *rules_ptr);
@@ -70,6 +104,41 @@ static int _wlmim_keyboard_config_ini_handler(
     const char *name_ptr,
     const char *value_ptr);
 
+static struct xkb_keymap *_wlmim_keyboard_xkb_from_rules(
+    const struct xkb_rule_names *rules_ptr,
+    const char *cache_dir_ptr,
+    wlmim_keymap_source_t *source_ptr);
+static struct xkb_keymap *_wlmim_keyboard_xkb_from_rules_locked(
+    const struct xkb_rule_names *rules_ptr,
+    const char *cache_dir_ptr,
+    wlmim_keymap_source_t *source_ptr);
+static void _wlmim_keyboard_release_shared_locked(void);
+static uint64_t _wlmim_keyboard_keymap_key(
+    const struct xkb_rule_names *rules_ptr,
+    const char *version_ptr,
+    struct xkb_context *xkb_context_ptr);
+static uint64_t _wlmim_keyboard_hash_include_path(
+    uint64_t hash,
+    const char *include_path_ptr);
+static uint64_t _wlmim_keyboard_hash_bytes(
+    uint64_t hash,
+    const void *data_ptr,
+    size_t size);
+static char *_wlmim_keyboard_cache_dir(void);
+static char *_wlmim_keyboard_cache_path(
+    const char *cache_dir_ptr,
+    uint64_t key);
+static struct xkb_keymap *_wlmim_keyboard_keymap_load(
+    struct xkb_context *xkb_context_ptr,
+    const char *path_ptr,
+    uint64_t key);
+static bool _wlmim_keyboard_keymap_store(
+    struct xkb_keymap *xkb_keymap_ptr,
+    const char *cache_dir_ptr,
+    const char *path_ptr,
+    uint64_t key);
+static bool _wlmim_keyboard_mkdirs(const char *path_ptr);
+
 
 static void handle_key(struct wl_listener *listener_ptr, void *data_ptr);
 static void handle_modifiers(struct wl_listener *listener_ptr,
@@ -108,6 +177,17 @@ const bspl_desc_t wlmim_keyboard_options_desc[] = {
  };
 
 
+/**
+ * Guards the shared keymap. Held while loading or compiling a keymap, so that
+ * a keymap prefetched on another thread is waited for, and then shared.
+ */
+static pthread_mutex_t _wlmim_keyboard_shared_mutex =
+    PTHREAD_MUTEX_INITIALIZER;
+/** Key of @ref _wlmim_keyboard_shared_xkb_keymap_ptr. */
+static uint64_t _wlmim_keyboard_shared_key = 0;
+/** The most recently loaded keymap. Re-used for identical configurations. */
+static struct xkb_keymap *_wlmim_keyboard_shared_xkb_keymap_ptr = NULL;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -287,30 +367,82 @@ struct xkb_keymap *wlmim_keyboard_xkb_from_config(bspl_dict_t *dict_ptr)
     }
 
     // Create keyboard layout.
-    struct xkb_keymap *xkb_keymap_ptr = NULL;
-    struct xkb_context *xkb_context_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
-    if (NULL == xkb_context_ptr) {
-        bs_log(BS_ERROR, "Failed xkb_context_new(XKB_CONTEXT_NO_FLAGS)");
-    } else {
-        xkb_keymap_ptr = xkb_keymap_new_from_names(
-            xkb_context_ptr, &xkb_rule, XKB_KEYMAP_COMPILE_NO_FLAGS);
-        if (NULL == xkb_keymap_ptr) {
-            bs_log(BS_ERROR, "Failed xkb_keymap_new_from_names(%p, { .rules = %s, "
-                   ".model = %s, .layout = %s, variant = %s, .options = %s }, "
-                   "XKB_KEYMAP_COMPILE_NO_NO_FLAGS)",
-                   xkb_context_ptr,
-                   xkb_rule.rules,
-                   xkb_rule.model,
-                   xkb_rule.layout,
-                   xkb_rule.variant,
-                   xkb_rule.options);
-        }
-        xkb_context_unref(xkb_context_ptr);
-    }
+    char *cache_dir_ptr = _wlmim_keyboard_cache_dir();
+    struct xkb_keymap *xkb_keymap_ptr = _wlmim_keyboard_xkb_from_rules(
+        &xkb_rule, cache_dir_ptr, NULL);
+    if (NULL != cache_dir_ptr) free(cache_dir_ptr);
     bspl_dict_unref(rmlvo_dict_ptr);
     return xkb_keymap_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmim_keyboard_xkb_release_shared(void)
+{
+    pthread_mutex_lock(&_wlmim_keyboard_shared_mutex);
+    _wlmim_keyboard_release_shared_locked();
+    pthread_mutex_unlock(&_wlmim_keyboard_shared_mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmim_keyboard_prefetch_t *wlmim_keyboard_prefetch_create(
+    bspl_dict_t *dict_ptr)
+{
+    if (NULL == dict_ptr) return NULL;
+    bspl_dict_t *config_dict_ptr = bspl_dict_get_dict(dict_ptr, "Keyboard");
+    if (NULL == config_dict_ptr) return NULL;
+    struct xkb_rule_names xkb_rule;
+    bspl_dict_t *rmlvo_dict_ptr = _wlmim_keyboard_populate_rules(
+        config_dict_ptr, &xkb_rule);
+    if (NULL == rmlvo_dict_ptr) return NULL;
+
+    wlmim_keyboard_prefetch_t *prefetch_ptr = logged_calloc(
+        1, sizeof(wlmim_keyboard_prefetch_t));
+    if (NULL == prefetch_ptr) goto error;
+    const char *names[5] = {
+        xkb_rule.rules, xkb_rule.model, xkb_rule.layout, xkb_rule.variant,
+        xkb_rule.options };
+    for (size_t i = 0; i < 5; ++i) {
+        if (NULL == names[i]) continue;
+        prefetch_ptr->names[i] = logged_strdup(names[i]);
+        if (NULL == prefetch_ptr->names[i]) goto error;
+    }
+    prefetch_ptr->rules = (struct xkb_rule_names){
+        .rules = prefetch_ptr->names[0],
+        .model = prefetch_ptr->names[1],
+        .layout = prefetch_ptr->names[2],
+        .variant = prefetch_ptr->names[3],
+        .options = prefetch_ptr->names[4] };
+    prefetch_ptr->cache_dir_ptr = _wlmim_keyboard_cache_dir();
+    bspl_dict_unref(rmlvo_dict_ptr);
+    return prefetch_ptr;
+
+error:
+    if (NULL != prefetch_ptr) {
+        for (size_t i = 0; i < 5; ++i) free(prefetch_ptr->names[i]);
+        free(prefetch_ptr);
+    }
+    bspl_dict_unref(rmlvo_dict_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmim_keyboard_prefetch_run(void *prefetch_ptr)
+{
+    wlmim_keyboard_prefetch_t *p_ptr = prefetch_ptr;
+
+    // Keymap references are not atomic: Only touch the keymap with the lock
+    // held. An already-shared keymap for these rules is left alone.
+    pthread_mutex_lock(&_wlmim_keyboard_shared_mutex);
+    struct xkb_keymap *xkb_keymap_ptr = _wlmim_keyboard_xkb_from_rules_locked(
+        &p_ptr->rules, p_ptr->cache_dir_ptr, NULL);
+    if (NULL != xkb_keymap_ptr) xkb_keymap_unref(xkb_keymap_ptr);
+    pthread_mutex_unlock(&_wlmim_keyboard_shared_mutex);
+
+    for (size_t i = 0; i < 5; ++i) free(p_ptr->names[i]);
+    if (NULL != p_ptr->cache_dir_ptr) free(p_ptr->cache_dir_ptr);
+    free(p_ptr);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -360,6 +492,424 @@ bspl_dict_t *_wlmim_keyboard_populate_rules(
     return rmlvo;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Releases the shared keymap. Must hold @ref _wlmim_keyboard_shared_mutex. */
+void _wlmim_keyboard_release_shared_locked(void)
+{
+    if (NULL != _wlmim_keyboard_shared_xkb_keymap_ptr) {
+        xkb_keymap_unref(_wlmim_keyboard_shared_xkb_keymap_ptr);
+        _wlmim_keyboard_shared_xkb_keymap_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the keymap for `rules_ptr`. Thread-safe: See
+ * @ref _wlmim_keyboard_xkb_from_rules_locked.
+ *
+ * @param rules_ptr
+ * @param cache_dir_ptr
+ * @param source_ptr
+ *
+ * @return A referenced keymap, or NULL on error.
+ */
+struct xkb_keymap *_wlmim_keyboard_xkb_from_rules(
+    const struct xkb_rule_names *rules_ptr,
+    const char *cache_dir_ptr,
+    wlmim_keymap_source_t *source_ptr)
+{
+    pthread_mutex_lock(&_wlmim_keyboard_shared_mutex);
+    struct xkb_keymap *xkb_keymap_ptr = _wlmim_keyboard_xkb_from_rules_locked(
+        rules_ptr, cache_dir_ptr, source_ptr);
+    pthread_mutex_unlock(&_wlmim_keyboard_shared_mutex);
+    return xkb_keymap_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates the keymap for `rules_ptr`. Must hold
+ * @ref _wlmim_keyboard_shared_mutex.
+ *
+ * Re-uses the keymap of the previous call, if the configuration is identical.
+ * Otherwise, attempts to load the keymap from the cache in `cache_dir_ptr`.
+ * Compiling the keymap from the rules is the (slow) fallback, and stores the
+ * result in the cache.
+ *
+ * @param rules_ptr
+ * @param cache_dir_ptr       Directory for the keymap cache, or NULL.
+ * @param source_ptr          Optional, to return where the keymap came from.
+ *
+ * @return A referenced keymap, or NULL on error.
+ */
+struct xkb_keymap *_wlmim_keyboard_xkb_from_rules_locked(
+    const struct xkb_rule_names *rules_ptr,
+    const char *cache_dir_ptr,
+    wlmim_keymap_source_t *source_ptr)
+{
+    wlmim_keymap_source_t source = WLMIM_KEYMAP_SHARED;
+    struct xkb_context *xkb_context_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    if (NULL == xkb_context_ptr) {
+        bs_log(BS_ERROR, "Failed xkb_context_new(XKB_CONTEXT_NO_FLAGS)");
+        return NULL;
+    }
+
+    uint64_t key = _wlmim_keyboard_keymap_key(
+        rules_ptr, WLMIM_XKBCOMMON_VERSION, xkb_context_ptr);
+    if (NULL != _wlmim_keyboard_shared_xkb_keymap_ptr &&
+        _wlmim_keyboard_shared_key == key) {
+        xkb_context_unref(xkb_context_ptr);
+        if (NULL != source_ptr) *source_ptr = source;
+        return xkb_keymap_ref(_wlmim_keyboard_shared_xkb_keymap_ptr);
+    }
+
+    char *path_ptr = NULL;
+    struct xkb_keymap *xkb_keymap_ptr = NULL;
+    if (NULL != cache_dir_ptr) {
+        path_ptr = _wlmim_keyboard_cache_path(cache_dir_ptr, key);
+        source = WLMIM_KEYMAP_CACHED;
+    }
+    if (NULL != path_ptr) {
+        xkb_keymap_ptr = _wlmim_keyboard_keymap_load(
+            xkb_context_ptr, path_ptr, key);
+    }
+
+    if (NULL == xkb_keymap_ptr) {
+        source = WLMIM_KEYMAP_COMPILED;
+        xkb_keymap_ptr = xkb_keymap_new_from_names(
+            xkb_context_ptr, rules_ptr, XKB_KEYMAP_COMPILE_NO_FLAGS);
+        if (NULL == xkb_keymap_ptr) {
+            bs_log(BS_ERROR, "Failed xkb_keymap_new_from_names(%p, { .rules = %s, "
+                   ".model = %s, .layout = %s, variant = %s, .options = %s }, "
+                   "XKB_KEYMAP_COMPILE_NO_NO_FLAGS)",
+                   xkb_context_ptr,
+                   rules_ptr->rules,
+                   rules_ptr->model,
+                   rules_ptr->layout,
+                   rules_ptr->variant,
+                   rules_ptr->options);
+        } else if (NULL != path_ptr) {
+            // Failing to store is not fatal: We just compile again next time.
+            _wlmim_keyboard_keymap_store(
+                xkb_keymap_ptr, cache_dir_ptr, path_ptr, key);
+        }
+    }
+    xkb_context_unref(xkb_context_ptr);
+    if (NULL != path_ptr) free(path_ptr);
+    if (NULL == xkb_keymap_ptr) return NULL;
+
+    _wlmim_keyboard_release_shared_locked();
+    _wlmim_keyboard_shared_key = key;
+    _wlmim_keyboard_shared_xkb_keymap_ptr = xkb_keymap_ref(xkb_keymap_ptr);
+    if (NULL != source_ptr) *source_ptr = source;
+    return xkb_keymap_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the cache key for the keymap: A FNV-1a hash of the RMLVO names,
+ * of the xkbcommon version, and of the include paths' contents.
+ *
+ * Names not set are taken from the `XKB_DEFAULT_*` environment variables by
+ * xkbcommon, so these are hashed in their place. The XKB config root goes in,
+ * too.
+ *
+ * @param rules_ptr
+ * @param version_ptr
+ * @param xkb_context_ptr     The context the keymap is compiled with. Its
+ *                            include paths are hashed, see
+ *                            @ref _wlmim_keyboard_hash_include_path.
+ *
+ * @return The key.
+ */
+uint64_t _wlmim_keyboard_keymap_key(
+    const struct xkb_rule_names *rules_ptr,
+    const char *version_ptr,
+    struct xkb_context *xkb_context_ptr)
+{
+    const char *values[] = {
+        rules_ptr->rules, "XKB_DEFAULT_RULES",
+        rules_ptr->model, "XKB_DEFAULT_MODEL",
+        rules_ptr->layout, "XKB_DEFAULT_LAYOUT",
+        rules_ptr->variant, "XKB_DEFAULT_VARIANT",
+        rules_ptr->options, "XKB_DEFAULT_OPTIONS",
+        NULL, "XKB_CONFIG_ROOT",
+        version_ptr, NULL
+    };
+
+    uint64_t hash = UINT64_C(0xcbf29ce484222325);
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i += 2) {
+        const char *value_ptr = values[i];
+        if (NULL == value_ptr && NULL != values[i + 1]) {
+            value_ptr = getenv(values[i + 1]);
+        }
+
+        if (NULL == value_ptr) {
+            // Unset: Distinct from the empty string.
+            hash = (hash ^ 0xff) * UINT64_C(0x100000001b3);
+        } else {
+            for (const char *c_ptr = value_ptr; '\0' != *c_ptr; ++c_ptr) {
+                hash = (hash ^ (uint8_t)*c_ptr) * UINT64_C(0x100000001b3);
+            }
+        }
+        // Separator, so that "ab","c" and "a","bc" differ.
+        hash = hash * UINT64_C(0x100000001b3);
+    }
+
+    for (unsigned i = 0;
+         i < xkb_context_num_include_paths(xkb_context_ptr);
+         ++i) {
+        hash = _wlmim_keyboard_hash_include_path(
+            hash, xkb_context_include_path_get(xkb_context_ptr, i));
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Hashes an XKB include path: Its name, and the modification time and size
+ * of each component directory and of the files therein.
+ *
+ * This catches updates of xkeyboard-config, as well as edits of the user's
+ * `~/.config/xkb`. Files are hashed independent of directory order. Nested
+ * directories (eg. `symbols/sun_vndr`) are not descended into, but their
+ * modification time changes when files are added, renamed or removed.
+ *
+ * @param hash
+ * @param include_path_ptr
+ *
+ * @return The updated hash.
+ */
+uint64_t _wlmim_keyboard_hash_include_path(
+    uint64_t hash,
+    const char *include_path_ptr)
+{
+    static const char *components[] = {
+        "rules", "keycodes", "types", "compat", "symbols"
+    };
+
+    hash = _wlmim_keyboard_hash_bytes(
+        hash, include_path_ptr, strlen(include_path_ptr) + 1);
+    for (size_t i = 0; i < sizeof(components) / sizeof(components[0]); ++i) {
+        char path[PATH_MAX];
+        snprintf(path, sizeof(path), "%s/%s", include_path_ptr, components[i]);
+        DIR *dir_ptr = opendir(path);
+        struct stat st;
+        if (NULL == dir_ptr || 0 != fstat(dirfd(dir_ptr), &st)) {
+            // Absent: Distinct from an empty directory.
+            hash = (hash ^ 0xff) * UINT64_C(0x100000001b3);
+            if (NULL != dir_ptr) closedir(dir_ptr);
+            continue;
+        }
+        hash = _wlmim_keyboard_hash_bytes(
+            hash, &st.st_mtim, sizeof(st.st_mtim));
+
+        uint64_t entries_hash = 0;
+        struct dirent *dirent_ptr;
+        while (NULL != (dirent_ptr = readdir(dir_ptr))) {
+            if ('.' == dirent_ptr->d_name[0]) continue;
+            if (0 != fstatat(dirfd(dir_ptr), dirent_ptr->d_name, &st, 0)) {
+                continue;
+            }
+            uint64_t h = _wlmim_keyboard_hash_bytes(
+                UINT64_C(0xcbf29ce484222325),
+                dirent_ptr->d_name, strlen(dirent_ptr->d_name) + 1);
+            h = _wlmim_keyboard_hash_bytes(h, &st.st_mtim, sizeof(st.st_mtim));
+            h = _wlmim_keyboard_hash_bytes(h, &st.st_size, sizeof(st.st_size));
+            entries_hash += h;
+        }
+        closedir(dir_ptr);
+        hash = _wlmim_keyboard_hash_bytes(
+            hash, &entries_hash, sizeof(entries_hash));
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return `hash`, FNV-1a-updated with `size` bytes at `data_ptr`. */
+uint64_t _wlmim_keyboard_hash_bytes(
+    uint64_t hash,
+    const void *data_ptr,
+    size_t size)
+{
+    const uint8_t *bytes_ptr = data_ptr;
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes_ptr[i]) * UINT64_C(0x100000001b3);
+    }
+    return hash;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the directory for the keymap cache: `${XDG_CACHE_HOME}/wlmaker`,
+ * with `${XDG_CACHE_HOME}` defaulting to `${HOME}/.cache`.
+ *
+ * @return The path, or NULL if not available. Must be released by free().
+ */
+char *_wlmim_keyboard_cache_dir(void)
+{
+    const char *cache_home_ptr = getenv("XDG_CACHE_HOME");
+    if (NULL != cache_home_ptr && '/' == *cache_home_ptr) {
+        return bs_strdupf("%s/wlmaker", cache_home_ptr);
+    }
+    const char *home_ptr = getenv("HOME");
+    if (NULL != home_ptr && '/' == *home_ptr) {
+        return bs_strdupf("%s/.cache/wlmaker", home_ptr);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Path of the cache file for `key`. Must be released by free(). */
+char *_wlmim_keyboard_cache_path(const char *cache_dir_ptr, uint64_t key)
+{
+    return bs_strdupf("%s/keymap-%016"PRIx64".xkb", cache_dir_ptr, key);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Loads the keymap from the cache file at `path_ptr`.
+ *
+ * @param xkb_context_ptr
+ * @param path_ptr
+ * @param key                 Must match the key in the file's header.
+ *
+ * @return The keymap, or NULL if absent, stale or corrupt.
+ */
+struct xkb_keymap *_wlmim_keyboard_keymap_load(
+    struct xkb_context *xkb_context_ptr,
+    const char *path_ptr,
+    uint64_t key)
+{
+    FILE *file_ptr = fopen(path_ptr, "r");
+    if (NULL == file_ptr) {
+        if (ENOENT != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(\"%s\", \"r\")",
+                   path_ptr);
+        }
+        return NULL;
+    }
+
+    struct xkb_keymap *xkb_keymap_ptr = NULL;
+    char *data_ptr = NULL;
+    struct stat stat_buf;
+    if (0 != fstat(fileno(file_ptr), &stat_buf) ||
+        0 >= stat_buf.st_size) goto done;
+    size_t size = stat_buf.st_size;
+    data_ptr = logged_malloc(size + 1);
+    if (NULL == data_ptr) goto done;
+    if (size != fread(data_ptr, 1, size, file_ptr)) {
+        bs_log(BS_WARNING, "Failed to read %zu bytes from \"%s\"",
+               size, path_ptr);
+        goto done;
+    }
+    data_ptr[size] = '\0';
+
+    char header[64];
+    size_t header_len = snprintf(
+        header, sizeof(header), "%s %016"PRIx64"\n",
+        _WLMIM_KEYMAP_CACHE_MAGIC, key);
+    if (0 != strncmp(data_ptr, header, header_len)) {
+        bs_log(BS_WARNING, "Ignoring keymap cache \"%s\": Bad header.",
+               path_ptr);
+        goto done;
+    }
+
+    xkb_keymap_ptr = xkb_keymap_new_from_string(
+        xkb_context_ptr,
+        data_ptr + header_len,
+        XKB_KEYMAP_FORMAT_TEXT_V1,
+        XKB_KEYMAP_COMPILE_NO_FLAGS);
+    if (NULL == xkb_keymap_ptr) {
+        bs_log(BS_WARNING, "Ignoring keymap cache \"%s\": Failed "
+               "xkb_keymap_new_from_string().", path_ptr);
+    }
+
+done:
+    if (NULL != data_ptr) free(data_ptr);
+    fclose(file_ptr);
+    return xkb_keymap_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Stores the keymap into the cache file at `path_ptr`. Writes to a temporary
+ * file first, and renames it, so that readers never see a partial file.
+ *
+ * @param xkb_keymap_ptr
+ * @param cache_dir_ptr       Directory of `path_ptr`. Created, if needed.
+ * @param path_ptr
+ * @param key
+ *
+ * @return true on success.
+ */
+bool _wlmim_keyboard_keymap_store(
+    struct xkb_keymap *xkb_keymap_ptr,
+    const char *cache_dir_ptr,
+    const char *path_ptr,
+    uint64_t key)
+{
+    if (!_wlmim_keyboard_mkdirs(cache_dir_ptr)) return false;
+
+    char *keymap_ptr = xkb_keymap_get_as_string(
+        xkb_keymap_ptr, XKB_KEYMAP_FORMAT_TEXT_V1);
+    if (NULL == keymap_ptr) {
+        bs_log(BS_WARNING, "Failed xkb_keymap_get_as_string(%p, "
+               "XKB_KEYMAP_FORMAT_TEXT_V1)", xkb_keymap_ptr);
+        return false;
+    }
+    char *tmp_path_ptr = bs_strdupf(
+        "%s.%"PRIdMAX, path_ptr, (intmax_t)getpid());
+    if (NULL == tmp_path_ptr) {
+        free(keymap_ptr);
+        return false;
+    }
+
+    bool rv = false;
+    FILE *file_ptr = fopen(tmp_path_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fopen(\"%s\", \"w\")",
+               tmp_path_ptr);
+    } else {
+        fprintf(file_ptr, "%s %016"PRIx64"\n", _WLMIM_KEYMAP_CACHE_MAGIC, key);
+        fputs(keymap_ptr, file_ptr);
+        rv = !ferror(file_ptr);
+        rv = (0 == fclose(file_ptr)) && rv;
+        if (rv && 0 != rename(tmp_path_ptr, path_ptr)) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed rename(\"%s\", \"%s\")",
+                   tmp_path_ptr, path_ptr);
+            rv = false;
+        }
+        if (!rv) unlink(tmp_path_ptr);
+    }
+
+    free(tmp_path_ptr);
+    free(keymap_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Creates directory `path_ptr`, and its parents. @return true on success. */
+bool _wlmim_keyboard_mkdirs(const char *path_ptr)
+{
+    char *p = logged_strdup(path_ptr);
+    if (NULL == p) return false;
+
+    bool rv = true;
+    for (char *c_ptr = p + 1; rv; ++c_ptr) {
+        if ('/' != *c_ptr && '\0' != *c_ptr) continue;
+        char c = *c_ptr;
+        *c_ptr = '\0';
+        if (0 != mkdir(p, 0700) && EEXIST != errno) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed mkdir(\"%s\", 0700)", p);
+            rv = false;
+        }
+        *c_ptr = c;
+        if ('\0' == c) break;
+    }
+    free(p);
+    return rv;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles `key` signals, ie. key presses.
@@ -466,12 +1016,18 @@ void handle_modifiers(struct wl_listener *listener_ptr,
 static void _wlmim_keyboard_test_parse(bs_test_t *test_ptr);
 static void _wlmim_keyboard_test_rmlvo(bs_test_t *test_ptr);
 static void _wlmim_keyboard_test_file(bs_test_t *test_ptr);
+static void _wlmim_keyboard_test_cache(bs_test_t *test_ptr);
+static void _wlmim_keyboard_test_include_paths(bs_test_t *test_ptr);
+static void _wlmim_keyboard_test_prefetch(bs_test_t *test_ptr);
 
 /** Test cases for the keyboard. */
 static const bs_test_case_t   _wlmim_keyboard_test_cases[] = {
     { true, "parse", _wlmim_keyboard_test_parse },
     { true, "rmlvo", _wlmim_keyboard_test_rmlvo },
     { true, "file", _wlmim_keyboard_test_file },
+    { true, "cache", _wlmim_keyboard_test_cache },
+    { true, "include_paths", _wlmim_keyboard_test_include_paths },
+    { true, "prefetch", _wlmim_keyboard_test_prefetch },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -545,4 +1101,182 @@ void _wlmim_keyboard_test_file(bs_test_t *test_ptr)
     bspl_dict_unref(d);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests the keymap cache: Hits, invalidation and a corrupt cache file. */
+void _wlmim_keyboard_test_cache(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmim_keyboard_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    // A not-yet existing subdirectory, to verify it gets created.
+    char *cache_dir_ptr = bs_strdupf("%s/wlmaker", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, cache_dir_ptr);
+    struct xkb_rule_names r = {
+        .rules = "evdev", .model = "pc105", .layout = "us" };
+    wlmim_keymap_source_t source;
+    wlmim_keyboard_xkb_release_shared();
+    struct xkb_context *ctx_ptr = xkb_context_new(XKB_CONTEXT_NO_FLAGS);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ctx_ptr);
+
+    // First: Compiled, and stored.
+    struct xkb_keymap *k1 = _wlmim_keyboard_xkb_from_rules(
+        &r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, k1);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_COMPILED, source);
+    char *us_path_ptr = _wlmim_keyboard_cache_path(
+        cache_dir_ptr,
+        _wlmim_keyboard_keymap_key(&r, WLMIM_XKBCOMMON_VERSION, ctx_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_file_realpath_is(us_path_ptr, S_IFREG));
+
+    // Same configuration: The very same keymap is shared.
+    struct xkb_keymap *k2 = _wlmim_keyboard_xkb_from_rules(
+        &r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_SHARED, source);
+    BS_TEST_VERIFY_EQ(test_ptr, k1, k2);
+    xkb_keymap_unref(k2);
+
+    // Not shared anymore, eg. after a restart: Loaded from the cache.
+    wlmim_keyboard_xkb_release_shared();
+    k2 = _wlmim_keyboard_xkb_from_rules(&r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, k2);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_CACHED, source);
+    BS_TEST_VERIFY_NEQ(test_ptr, k1, k2);
+    char *s1 = xkb_keymap_get_as_string(k1, XKB_KEYMAP_FORMAT_TEXT_V1);
+    char *s2 = xkb_keymap_get_as_string(k2, XKB_KEYMAP_FORMAT_TEXT_V1);
+    BS_TEST_VERIFY_STREQ(test_ptr, s1, s2);
+    free(s2);
+    free(s1);
+    xkb_keymap_unref(k2);
+    xkb_keymap_unref(k1);
+
+    // Other names or another xkbcommon version invalidate.
+    uint64_t key = _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr);
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, key, _wlmim_keyboard_keymap_key(&r, "1.0.1", ctx_ptr));
+    r.layout = "ch";
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, key, _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr));
+    k1 = _wlmim_keyboard_xkb_from_rules(&r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, k1);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_COMPILED, source);
+    if (NULL != k1) xkb_keymap_unref(k1);
+    char *ch_path_ptr = _wlmim_keyboard_cache_path(
+        cache_dir_ptr,
+        _wlmim_keyboard_keymap_key(&r, WLMIM_XKBCOMMON_VERSION, ctx_ptr));
+
+    // A corrupt cache file: Falls back to compiling, and re-writes the file.
+    r.layout = "us";
+    FILE *file_ptr = fopen(us_path_ptr, "w");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    fprintf(file_ptr, "%s %016"PRIx64"\nxkb_keymap { garbage",
+            _WLMIM_KEYMAP_CACHE_MAGIC,
+            _wlmim_keyboard_keymap_key(&r, WLMIM_XKBCOMMON_VERSION, ctx_ptr));
+    fclose(file_ptr);
+    wlmim_keyboard_xkb_release_shared();
+    k1 = _wlmim_keyboard_xkb_from_rules(&r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, k1);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_COMPILED, source);
+    if (NULL != k1) xkb_keymap_unref(k1);
+    wlmim_keyboard_xkb_release_shared();
+    k1 = _wlmim_keyboard_xkb_from_rules(&r, cache_dir_ptr, &source);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, k1);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_CACHED, source);
+    if (NULL != k1) xkb_keymap_unref(k1);
+    wlmim_keyboard_xkb_release_shared();
+
+    unlink(ch_path_ptr);
+    free(ch_path_ptr);
+    unlink(us_path_ptr);
+    free(us_path_ptr);
+    rmdir(cache_dir_ptr);
+    free(cache_dir_ptr);
+    rmdir(dir);
+    xkb_context_unref(ctx_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that changes to files in the XKB include paths change the key. */
+void _wlmim_keyboard_test_include_paths(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmim_keyboard_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *symbols_ptr = bs_strdupf("%s/symbols", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, symbols_ptr);
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, mkdir(symbols_ptr, 0700));
+    char *file_ptr = bs_strdupf("%s/custom", symbols_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    FILE *f = fopen(file_ptr, "w");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, f);
+    fclose(f);
+    struct timespec times[2] = { { .tv_sec = 1000 }, { .tv_sec = 1000 } };
+    BS_TEST_VERIFY_EQ(test_ptr, 0, utimensat(AT_FDCWD, file_ptr, times, 0));
+
+    struct xkb_context *ctx_ptr = xkb_context_new(
+        XKB_CONTEXT_NO_DEFAULT_INCLUDES);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ctx_ptr);
+    struct xkb_rule_names r = { .layout = "custom" };
+    uint64_t key_without = _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, xkb_context_include_path_append(
+                          ctx_ptr, dir));
+    uint64_t key = _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, key_without, key);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, key, _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr));
+
+    // Editing the file, in place: Changes the key.
+    times[0].tv_sec = times[1].tv_sec = 2000;
+    BS_TEST_VERIFY_EQ(test_ptr, 0, utimensat(AT_FDCWD, file_ptr, times, 0));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, key, _wlmim_keyboard_keymap_key(&r, "1.0.0", ctx_ptr));
+
+    xkb_context_unref(ctx_ptr);
+    unlink(file_ptr);
+    free(file_ptr);
+    rmdir(symbols_ptr);
+    free(symbols_ptr);
+    rmdir(dir);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Thread function for @ref _wlmim_keyboard_test_prefetch. */
+static void *_wlmim_keyboard_test_prefetch_thread(void *arg_ptr)
+{
+    wlmim_keyboard_prefetch_run(arg_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests that a keymap prefetched on another thread is shared. */
+void _wlmim_keyboard_test_prefetch(bs_test_t *test_ptr)
+{
+    bspl_dict_t *d = bspl_dict_from_object(
+        bspl_create_object_from_plist_string(
+            "{Keyboard={XkbRMLVO={Rules=evdev;Model=pc105;Layout=us;};};}"));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, d);
+    wlmim_keyboard_xkb_release_shared();
+
+    wlmim_keyboard_prefetch_t *p = wlmim_keyboard_prefetch_create(d);
+    bspl_dict_unref(d);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+    BS_TEST_VERIFY_STREQ(test_ptr, "us", p->rules.layout);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, p->rules.variant);
+    // Don't touch the user's cache: Have the keymap compiled.
+    if (NULL != p->cache_dir_ptr) free(p->cache_dir_ptr);
+    p->cache_dir_ptr = NULL;
+
+    pthread_t thread;
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0,
+        pthread_create(&thread, NULL, _wlmim_keyboard_test_prefetch_thread, p));
+    pthread_join(thread, NULL);
+
+    struct xkb_rule_names r = {
+        .rules = "evdev", .model = "pc105", .layout = "us" };
+    wlmim_keymap_source_t source;
+    struct xkb_keymap *k = _wlmim_keyboard_xkb_from_rules(&r, NULL, &source);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, k);
+    BS_TEST_VERIFY_EQ(test_ptr, WLMIM_KEYMAP_SHARED, source);
+    xkb_keymap_unref(k);
+    wlmim_keyboard_xkb_release_shared();
+}
+
 /* == End of keyboard.c ==================================================== */
@@ -90,6 +90,11 @@ void wlmim_keyboard_configure(
 /**
  * Creates a `struct xkb_keymap` from the keyboard configuration dict.
  *
+ * Compiling a keymap is slow. The compiled keymap is therefore stored in
+ * `${XDG_CACHE_HOME}/wlmaker`, keyed by the RMLVO names and the xkbcommon
+ * version, and loaded from there on later calls. The most recent keymap is
+ * also kept, and shared with subsequent calls of identical configuration.
+ *
  * @param dict_ptr            Plist dict of the `Keyboard` configuration. If
  *                            NULL, NULL is returned.
  *
@@ -98,6 +103,36 @@ void wlmim_keyboard_configure(
  */
 struct xkb_keymap *wlmim_keyboard_xkb_from_config(bspl_dict_t *dict_ptr);
 
+/**
+ * Releases the keymap kept for sharing by @ref wlmim_keyboard_xkb_from_config.
+ * Keymaps handed out remain valid.
+ */
+void wlmim_keyboard_xkb_release_shared(void);
+
+/** Forward declaration: Keymap configuration, for prefetching the keymap. */
+typedef struct _wlmim_keyboard_prefetch_t wlmim_keyboard_prefetch_t;
+
+/**
+ * Decodes the keymap configuration, for prefetching the keymap on another
+ * thread. Must be called on the thread owning `dict_ptr`.
+ *
+ * @param dict_ptr            As for @ref wlmim_keyboard_xkb_from_config.
+ *
+ * @return The prefetch, or NULL on error. Must be passed to
+ *     @ref wlmim_keyboard_prefetch_run.
+ */
+wlmim_keyboard_prefetch_t *wlmim_keyboard_prefetch_create(
+    bspl_dict_t *dict_ptr);
+
+/**
+ * Loads or compiles the keymap, and keeps it for sharing: A subsequent
+ * @ref wlmim_keyboard_xkb_from_config of the same configuration re-uses it,
+ * or waits for it to complete. May run on any thread. Destroys the prefetch.
+ *
+ * @param prefetch_ptr        Points to a @ref wlmim_keyboard_prefetch_t.
+ */
+void wlmim_keyboard_prefetch_run(void *prefetch_ptr);
+
 /** Keyboard modifiers, as enum to lookup. */
 extern const bspl_enum_desc_t wlmim_keyboard_modifiers[];
 
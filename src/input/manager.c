@@ -249,6 +249,7 @@ void wlmim_input_manager_destroy(wlmim_t *input_manager_ptr)
         xkb_keymap_unref(input_manager_ptr->xkb_keymap_ptr);
         input_manager_ptr->xkb_keymap_ptr = NULL;
     }
+    wlmim_keyboard_xkb_release_shared();
 
     free(input_manager_ptr);
 }
@@ -50,6 +50,8 @@ struct _wlmaker_launcher_t {
 
     /** Subprocess monitor to register launched processes to. */
     wlm_util_subprocess_monitor_t *monitor_ptr;
+    /** Records launches, for their latency. May be NULL. */
+    wlm_util_launch_tracker_t *launch_tracker_ptr;
 
     /** Commandline to launch the associated application. */
     char                      *cmdline_ptr;
@@ -118,12 +120,14 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
     const struct wlmtk_tile_style *style_ptr,
     bspl_dict_t *dict_ptr,
     wlm_util_subprocess_monitor_t *monitor_ptr,
+    wlm_util_launch_tracker_t *launch_tracker_ptr,
     wlm_util_files_t *files_ptr)
 {
     wlmaker_launcher_t *launcher_ptr = logged_calloc(
         1, sizeof(wlmaker_launcher_t));
     if (NULL == launcher_ptr) return NULL;
     launcher_ptr->monitor_ptr = monitor_ptr;
+    launcher_ptr->launch_tracker_ptr = launch_tracker_ptr;
 
      if (!wlmtk_tile_init(&launcher_ptr->super_tile, style_ptr)) {
          return NULL;
@@ -169,33 +173,11 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
         return NULL;
     }
 
-    // Resolves to a full path, and verifies the icon file exists.
-    char *p = bs_strdupf("icons/%s", launcher_ptr->icon_path_ptr);
-    if (NULL == p) {
-        bs_log(BS_ERROR | BS_ERRNO, "Failed bs_strdupf(\"icons/%s\")",
-               launcher_ptr->icon_path_ptr);
-        wlmaker_launcher_destroy(launcher_ptr);
-        return NULL;
-    }
-    launcher_ptr->resolved_icon_path_ptr = wlm_util_files_xdg_data_find(
-        files_ptr, p, S_IFREG);
-    free(p);
+    launcher_ptr->resolved_icon_path_ptr = wlmaker_launcher_resolve_icon(
+        files_ptr, launcher_ptr->icon_path_ptr);
     if (NULL == launcher_ptr->resolved_icon_path_ptr) {
-        bs_log(BS_ERROR,
-               "Failed to locate \"icons/%s\" in ${XDG_DATA_DIRS}/wlmaker",
-               launcher_ptr->icon_path_ptr);
-#ifndef WLMAKER_SOURCE_DIR
         wlmaker_launcher_destroy(launcher_ptr);
         return NULL;
-#else
-        launcher_ptr->resolved_icon_path_ptr = bs_strdupf(
-            WLMAKER_SOURCE_DIR "/share/wlmaker/icons/%s",
-            launcher_ptr->icon_path_ptr);
-        if (NULL == launcher_ptr->resolved_icon_path_ptr) {
-            wlmaker_launcher_destroy(launcher_ptr);
-            return NULL;
-        }
-#endif
     }
     launcher_ptr->image_ptr = wlmtk_image_create_scaled(
         launcher_ptr->resolved_icon_path_ptr,
@@ -214,6 +196,32 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
     return launcher_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+char *wlmaker_launcher_resolve_icon(
+    wlm_util_files_t *files_ptr,
+    const char *icon_ptr)
+{
+    // Resolves to a full path, and verifies the icon file exists.
+    char *p = bs_strdupf("icons/%s", icon_ptr);
+    if (NULL == p) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed bs_strdupf(\"icons/%s\")",
+               icon_ptr);
+        return NULL;
+    }
+    char *path_ptr = wlm_util_files_xdg_data_find(files_ptr, p, S_IFREG);
+    free(p);
+    if (NULL != path_ptr) return path_ptr;
+
+    bs_log(BS_ERROR,
+           "Failed to locate \"icons/%s\" in ${XDG_DATA_DIRS}/wlmaker",
+           icon_ptr);
+#ifndef WLMAKER_SOURCE_DIR
+    return NULL;
+#else
+    return bs_strdupf(WLMAKER_SOURCE_DIR "/share/wlmaker/icons/%s", icon_ptr);
+#endif
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_launcher_destroy(wlmaker_launcher_t *launcher_ptr)
 {
@@ -380,28 +388,22 @@ bool _wlmaker_launcher_pointer_button(
  */
 void _wlmaker_launcher_start(wlmaker_launcher_t *launcher_ptr)
 {
-    bs_subprocess_t *subprocess_ptr = bs_subprocess_create_cmdline(
-        launcher_ptr->cmdline_ptr);
-    if (NULL == subprocess_ptr) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_create_cmdline(%s)",
-               launcher_ptr->cmdline_ptr);
-        return;
-    }
-
-    if (!bs_subprocess_start(subprocess_ptr)) {
-        bs_log(BS_ERROR, "Failed bs_subprocess_start for %s",
-               launcher_ptr->cmdline_ptr);
-        bs_subprocess_destroy(subprocess_ptr);
-        return;
-    }
-
     struct wlm_util_subprocess *subprocess_handle_ptr;
-    subprocess_handle_ptr = wlm_util_subprocess_monitor_entrust(
+    subprocess_handle_ptr = wlm_util_subprocess_monitor_spawn(
         launcher_ptr->monitor_ptr,
-        subprocess_ptr,
+        launcher_ptr->cmdline_ptr,
         _wlmaker_launcher_handle_terminated,
         launcher_ptr,
         NULL);
+    if (NULL == subprocess_handle_ptr) {
+        bs_log(BS_ERROR, "Failed wlm_util_subprocess_monitor_spawn for %s",
+               launcher_ptr->cmdline_ptr);
+        return;
+    }
+    wlm_util_launch_tracker_launched(
+        launcher_ptr->launch_tracker_ptr,
+        wlm_util_subprocess_pid(subprocess_handle_ptr),
+        launcher_ptr->cmdline_ptr);
 
     if (!bs_ptr_set_insert(launcher_ptr->subprocesses_ptr,
                            subprocess_handle_ptr)) {
@@ -506,7 +508,7 @@ void test_create_from_plist(bs_test_t *test_ptr)
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, files_ptr);
 
     wlmaker_launcher_t *launcher_ptr = wlmaker_launcher_create_from_plist(
-        &style, dict_ptr, NULL, files_ptr);
+        &style, dict_ptr, NULL, NULL, files_ptr);
     bspl_dict_unref(dict_ptr);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, launcher_ptr);
 
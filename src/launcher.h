@@ -26,6 +26,7 @@
 
 #include "toolkit/toolkit.h"
 #include "util/files.h"
+#include "util/launch_tracker.h"
 #include "util/subprocess_monitor.h"
 
 #ifdef __cplusplus
@@ -41,6 +42,7 @@ typedef struct _wlmaker_launcher_t wlmaker_launcher_t;
  * @param style_ptr
  * @param dict_ptr
  * @param monitor_ptr
+ * @param launch_tracker_ptr  Records launches. May be NULL.
  * @param files_ptr
  *
  * @return Pointer to the launcher handle or NULL on error.
@@ -49,8 +51,22 @@ wlmaker_launcher_t *wlmaker_launcher_create_from_plist(
     const struct wlmtk_tile_style *style_ptr,
     bspl_dict_t *dict_ptr,
     wlm_util_subprocess_monitor_t *monitor_ptr,
+    wlm_util_launch_tracker_t *launch_tracker_ptr,
     wlm_util_files_t *files_ptr);
 
+/**
+ * Resolves the launcher's icon to a full path, within `icons/` of
+ * `${XDG_DATA_DIRS}/wlmaker`.
+ *
+ * @param files_ptr
+ * @param icon_ptr            The launcher's `Icon`.
+ *
+ * @return The path, or NULL if not found. Must be released by free().
+ */
+char *wlmaker_launcher_resolve_icon(
+    wlm_util_files_t *files_ptr,
+    const char *icon_ptr);
+
 /**
  * Destroys the application launcher.
  *
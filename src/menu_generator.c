@@ -0,0 +1,808 @@
+/* ========================================================================= */
+/**
+ * @file menu_generator.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "menu_generator.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#include "../tool/menu.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the in-process menu generator. */
+struct _wlmaker_menu_generator_t {
+    /** The generator function, run on @ref wlmaker_menu_generator_t::thread. */
+    wlmaker_menu_generator_fn_t fn;
+    /** Argument to `fn`. */
+    char                      *path_ptr;
+    /** Argument to `fn`. */
+    char                      *locale_ptr;
+
+    /** The worker thread. Detached: It is never joined. */
+    pthread_t                 thread;
+    /** Whether @ref wlmaker_menu_generator_t::thread was started. */
+    bool                      thread_started;
+    /** Guards `done`, `abandoned` and the worker's results. */
+    pthread_mutex_t           mutex;
+    /** Whether the worker has completed `fn`. */
+    bool                      done;
+    /**
+     * Whether the generator was destroyed while the worker was running. The
+     * worker then releases the generator, once `fn` returns.
+     */
+    bool                      abandoned;
+    /** Signalled by the worker thread once `fn` returned. */
+    int                       event_fd;
+    /** Event source for @ref wlmaker_menu_generator_t::event_fd. */
+    struct wl_event_source    *wl_event_source_ptr;
+
+    /** Result of `fn`. Written by the worker thread, before signalling. */
+    bspl_array_t              *array_ptr;
+
+    /** Timestamp of creating the generator, in microseconds. */
+    uint64_t                  create_usec;
+    /** Time spent in `fn`, in microseconds. Written by the worker thread. */
+    uint64_t                  run_usec;
+    /** Time from creation until the result was handed back. */
+    uint64_t                  latency_usec;
+
+    /** Callback for when the result is handed back. */
+    wlmaker_menu_generator_callback_t callback;
+    /** Argument to @ref wlmaker_menu_generator_t::callback. */
+    void                      *callback_ud_ptr;
+};
+
+/** A registered generator, run in-process in lieu of a `wlmtool` command. */
+struct _wlmaker_menu_generator_desc {
+    /** The `wlmtool` command that this generator replaces. */
+    const char                *command_ptr;
+    /** The generator function. */
+    wlmaker_menu_generator_fn_t fn;
+};
+
+static wlmaker_menu_generator_fn_t _wlmaker_menu_generator_from_command(
+    const char *command_ptr,
+    const char *wlmtool_path_ptr,
+    char **path_ptr_ptr,
+    char **locale_ptr_ptr);
+static bspl_array_t *_wlmaker_menu_generator_appearance(
+    const char *path_ptr,
+    const char *locale_ptr);
+static void _wlmaker_menu_generator_free(
+    wlmaker_menu_generator_t *generator_ptr);
+static void *_wlmaker_menu_generator_run(void *arg_ptr);
+static int _wlmaker_menu_generator_handle_done(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static bool _wlmaker_menu_generator_is_wlmtool(const char *token_ptr);
+static char *_wlmaker_menu_generator_resolve(const char *token_ptr);
+static char *_wlmaker_menu_generator_wlmtool_path(void);
+
+/* == Data ================================================================= */
+
+/** Generators that are registered to run in-process. */
+static const struct _wlmaker_menu_generator_desc _wlmaker_menu_generators[] = {
+    { "GenerateApplicationsMenu", wlmtool_menu_generate_applications },
+    { "GenerateThemesMenu", _wlmaker_menu_generator_appearance },
+    { NULL, NULL }
+};
+
+/** Characters that indicate shell syntax. The shell must run these. */
+static const char *_wlmaker_menu_generator_shell_chars =
+    "|&;<>()$`\\\"'*?[]#~{}\n";
+
+/** Separators between arguments. */
+static const char *_wlmaker_menu_generator_separators = " \t";
+
+/** The only `wlmtool` option supported in-process. */
+static const char *_wlmaker_menu_generator_locale_option = "--locale=";
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmaker_menu_generator_fn_t wlmaker_menu_generator_from_command(
+    const char *command_ptr,
+    char **path_ptr_ptr,
+    char **locale_ptr_ptr)
+{
+    char *wlmtool_path_ptr = _wlmaker_menu_generator_wlmtool_path();
+    wlmaker_menu_generator_fn_t fn = _wlmaker_menu_generator_from_command(
+        command_ptr, wlmtool_path_ptr, path_ptr_ptr, locale_ptr_ptr);
+    if (NULL != wlmtool_path_ptr) free(wlmtool_path_ptr);
+    return fn;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmaker_menu_generator_t *wlmaker_menu_generator_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    wlmaker_menu_generator_fn_t fn,
+    const char *path_ptr,
+    const char *locale_ptr,
+    wlmaker_menu_generator_callback_t callback,
+    void *callback_ud_ptr)
+{
+    wlmaker_menu_generator_t *generator_ptr = logged_calloc(
+        1, sizeof(wlmaker_menu_generator_t));
+    if (NULL == generator_ptr) return NULL;
+    generator_ptr->fn = fn;
+    generator_ptr->callback = callback;
+    generator_ptr->callback_ud_ptr = callback_ud_ptr;
+    generator_ptr->create_usec = bs_usec();
+    generator_ptr->event_fd = -1;
+    pthread_mutex_init(&generator_ptr->mutex, NULL);
+
+    if (NULL != path_ptr) {
+        generator_ptr->path_ptr = logged_strdup(path_ptr);
+        if (NULL == generator_ptr->path_ptr) goto error;
+    }
+    if (NULL != locale_ptr) {
+        generator_ptr->locale_ptr = logged_strdup(locale_ptr);
+        if (NULL == generator_ptr->locale_ptr) goto error;
+    }
+
+    generator_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > generator_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO,
+               "Failed eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)");
+        goto error;
+    }
+    generator_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        generator_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlmaker_menu_generator_handle_done,
+        generator_ptr);
+    if (NULL == generator_ptr->wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, "
+               "WL_EVENT_READABLE, %p, %p)",
+               wl_event_loop_ptr, generator_ptr->event_fd,
+               _wlmaker_menu_generator_handle_done, generator_ptr);
+        goto error;
+    }
+
+    // Detached: The event loop never waits for the worker.
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    int rv = pthread_create(
+        &generator_ptr->thread, &attr,
+        _wlmaker_menu_generator_run, generator_ptr);
+    pthread_attr_destroy(&attr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create(%p, %p, %p, %p)",
+               &generator_ptr->thread, &attr, _wlmaker_menu_generator_run,
+               generator_ptr);
+        goto error;
+    }
+    generator_ptr->thread_started = true;
+    return generator_ptr;
+
+error:
+    wlmaker_menu_generator_destroy(generator_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_menu_generator_destroy(wlmaker_menu_generator_t *generator_ptr)
+{
+    if (NULL != generator_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(generator_ptr->wl_event_source_ptr);
+        generator_ptr->wl_event_source_ptr = NULL;
+    }
+
+    // A still-running worker is not waited for: It releases the generator.
+    pthread_mutex_lock(&generator_ptr->mutex);
+    bool running = generator_ptr->thread_started && !generator_ptr->done;
+    generator_ptr->abandoned = running;
+    pthread_mutex_unlock(&generator_ptr->mutex);
+    if (running) return;
+
+    _wlmaker_menu_generator_free(generator_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmaker_menu_generator_run_usec(
+    wlmaker_menu_generator_t *generator_ptr)
+{
+    if (0 == generator_ptr->latency_usec) return 0;
+    return generator_ptr->run_usec;
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmaker_menu_generator_latency_usec(
+    wlmaker_menu_generator_t *generator_ptr)
+{
+    return generator_ptr->latency_usec;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up the in-process generator for `command_ptr`. See
+ * @ref wlmaker_menu_generator_from_command.
+ *
+ * @param command_ptr
+ * @param wlmtool_path_ptr    Real path of the `wlmtool` installed with
+ *                            wlmaker, or NULL if there is none.
+ * @param path_ptr_ptr
+ * @param locale_ptr_ptr
+ *
+ * @return The generator function, or NULL.
+ */
+wlmaker_menu_generator_fn_t _wlmaker_menu_generator_from_command(
+    const char *command_ptr,
+    const char *wlmtool_path_ptr,
+    char **path_ptr_ptr,
+    char **locale_ptr_ptr)
+{
+    if (NULL == command_ptr ||
+        NULL != strpbrk(command_ptr, _wlmaker_menu_generator_shell_chars)) {
+        return NULL;
+    }
+
+    char *tokens_ptr = logged_strdup(command_ptr);
+    if (NULL == tokens_ptr) return NULL;
+
+    char *args[3] = {};
+    size_t args_num = 0;
+    const char *locale_ptr = NULL;
+    const char *reason_ptr = NULL;
+    char *saveptr_ptr = NULL;
+    for (char *t = strtok_r(tokens_ptr, _wlmaker_menu_generator_separators,
+                            &saveptr_ptr);
+         NULL != t && NULL == reason_ptr;
+         t = strtok_r(NULL, _wlmaker_menu_generator_separators,
+                      &saveptr_ptr)) {
+        size_t l = strlen(_wlmaker_menu_generator_locale_option);
+        if (0 < args_num &&
+            0 == strncmp(t, _wlmaker_menu_generator_locale_option, l)) {
+            locale_ptr = t + l;
+        } else if (0 < args_num && 0 == strncmp(t, "-", 1)) {
+            reason_ptr = "Unsupported option";
+        } else if (args_num >= 3) {
+            reason_ptr = "Too many arguments";
+        } else {
+            args[args_num++] = t;
+        }
+    }
+
+    // Not a `wlmtool` command: Nothing to report, it's just a command.
+    wlmaker_menu_generator_fn_t fn = NULL;
+    if (0 == args_num || !_wlmaker_menu_generator_is_wlmtool(args[0])) {
+        free(tokens_ptr);
+        return NULL;
+    }
+
+    if (NULL == reason_ptr && 2 <= args_num) {
+        for (const struct _wlmaker_menu_generator_desc *d =
+                 &_wlmaker_menu_generators[0];
+             NULL != d->command_ptr; ++d) {
+            if (0 == strcmp(d->command_ptr, args[1])) fn = d->fn;
+        }
+        if (NULL == fn) reason_ptr = "No in-process generator for command";
+    } else if (NULL == reason_ptr) {
+        reason_ptr = "Missing command";
+    }
+
+    // Only run in-process if the command would run the very same `wlmtool`.
+    if (NULL == reason_ptr) {
+        char *resolved_ptr = _wlmaker_menu_generator_resolve(args[0]);
+        if (NULL == resolved_ptr || NULL == wlmtool_path_ptr ||
+            0 != strcmp(resolved_ptr, wlmtool_path_ptr)) {
+            reason_ptr = "Not the wlmtool installed with wlmaker";
+        }
+        if (NULL != resolved_ptr) free(resolved_ptr);
+    }
+
+    if (NULL == reason_ptr) {
+        *path_ptr_ptr = NULL;
+        *locale_ptr_ptr = NULL;
+        if (NULL != args[2]) {
+            *path_ptr_ptr = logged_strdup(args[2]);
+            if (NULL == *path_ptr_ptr) reason_ptr = "Failed logged_strdup";
+        }
+        if (NULL != locale_ptr) {
+            *locale_ptr_ptr = logged_strdup(locale_ptr);
+            if (NULL == *locale_ptr_ptr) reason_ptr = "Failed logged_strdup";
+        }
+        if (NULL != reason_ptr) {
+            if (NULL != *path_ptr_ptr) free(*path_ptr_ptr);
+            if (NULL != *locale_ptr_ptr) free(*locale_ptr_ptr);
+            *path_ptr_ptr = NULL;
+            *locale_ptr_ptr = NULL;
+        }
+    }
+
+    if (NULL != reason_ptr) {
+        bs_log(BS_INFO, "Running \"%s\" as subprocess: %s.",
+               command_ptr, reason_ptr);
+        fn = NULL;
+    }
+    free(tokens_ptr);
+    return fn;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases all resources of the generator. */
+void _wlmaker_menu_generator_free(wlmaker_menu_generator_t *generator_ptr)
+{
+    if (0 <= generator_ptr->event_fd) {
+        close(generator_ptr->event_fd);
+        generator_ptr->event_fd = -1;
+    }
+
+    if (NULL != generator_ptr->array_ptr) {
+        bspl_array_unref(generator_ptr->array_ptr);
+        generator_ptr->array_ptr = NULL;
+    }
+    if (NULL != generator_ptr->locale_ptr) {
+        free(generator_ptr->locale_ptr);
+        generator_ptr->locale_ptr = NULL;
+    }
+    if (NULL != generator_ptr->path_ptr) {
+        free(generator_ptr->path_ptr);
+        generator_ptr->path_ptr = NULL;
+    }
+    pthread_mutex_destroy(&generator_ptr->mutex);
+    free(generator_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Adapts @ref wlmtool_menu_generate_appearance. It ignores the locale. */
+bspl_array_t *_wlmaker_menu_generator_appearance(
+    const char *path_ptr,
+    __UNUSED__ const char *locale_ptr)
+{
+    return wlmtool_menu_generate_appearance(path_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Thread function: Runs the generator, and signals the event loop. Releases
+ * the generator instead, if it was destroyed meanwhile.
+ *
+ * @param arg_ptr             Points to @ref wlmaker_menu_generator_t.
+ *
+ * @return NULL.
+ */
+void *_wlmaker_menu_generator_run(void *arg_ptr)
+{
+    wlmaker_menu_generator_t *generator_ptr = arg_ptr;
+
+    uint64_t start_usec = bs_usec();
+    bspl_array_t *array_ptr = generator_ptr->fn(
+        generator_ptr->path_ptr,
+        generator_ptr->locale_ptr);
+
+    pthread_mutex_lock(&generator_ptr->mutex);
+    generator_ptr->array_ptr = array_ptr;
+    generator_ptr->run_usec = bs_usec() - start_usec;
+    generator_ptr->done = true;
+    bool abandoned = generator_ptr->abandoned;
+    if (!abandoned) {
+        uint64_t value = 1;
+        while (0 > write(generator_ptr->event_fd, &value, sizeof(value))) {
+            if (EINTR == errno) continue;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed write(%d, %p, %zu)",
+                   generator_ptr->event_fd, &value, sizeof(value));
+            break;
+        }
+    }
+    pthread_mutex_unlock(&generator_ptr->mutex);
+
+    if (abandoned) _wlmaker_menu_generator_free(generator_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the worker's signal on @ref wlmaker_menu_generator_t::event_fd:
+ * Hands the result to the callback.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr
+ *
+ * @return 0.
+ */
+int _wlmaker_menu_generator_handle_done(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlmaker_menu_generator_t *generator_ptr = data_ptr;
+
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN == errno) return 0;
+
+    wl_event_source_remove(generator_ptr->wl_event_source_ptr);
+    generator_ptr->wl_event_source_ptr = NULL;
+
+    pthread_mutex_lock(&generator_ptr->mutex);
+    bspl_array_t *array_ptr = generator_ptr->array_ptr;
+    generator_ptr->array_ptr = NULL;
+    pthread_mutex_unlock(&generator_ptr->mutex);
+
+    generator_ptr->latency_usec = BS_MAX(
+        1, bs_usec() - generator_ptr->create_usec);
+    bs_log(BS_INFO, "Menu generator %p: %"PRIu64" usec on worker, "
+           "%"PRIu64" usec until handed back.", generator_ptr,
+           generator_ptr->run_usec, generator_ptr->latency_usec);
+
+    // Must be last: The callback may destroy the generator.
+    generator_ptr->callback(array_ptr, generator_ptr->callback_ud_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `token_ptr` is "wlmtool", or a path ending in it. */
+bool _wlmaker_menu_generator_is_wlmtool(const char *token_ptr)
+{
+    const char *name_ptr = strrchr(token_ptr, '/');
+    name_ptr = (NULL == name_ptr) ? token_ptr : name_ptr + 1;
+    return 0 == strcmp(name_ptr, "wlmtool");
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Resolves the executable `token_ptr` as the shell would: A name without a
+ * slash is looked up in ${PATH}.
+ *
+ * @param token_ptr
+ *
+ * @return The real path of the executable, or NULL if not found. Must be
+ *     released by free().
+ */
+char *_wlmaker_menu_generator_resolve(const char *token_ptr)
+{
+    if (NULL != strchr(token_ptr, '/')) return realpath(token_ptr, NULL);
+
+    const char *env_path_ptr = getenv("PATH");
+    if (NULL == env_path_ptr) return NULL;
+    char *dirs_ptr = logged_strdup(env_path_ptr);
+    if (NULL == dirs_ptr) return NULL;
+
+    char *resolved_ptr = NULL;
+    char *saveptr_ptr = NULL;
+    for (char *d = strtok_r(dirs_ptr, ":", &saveptr_ptr);
+         NULL != d && NULL == resolved_ptr;
+         d = strtok_r(NULL, ":", &saveptr_ptr)) {
+        char *p = bs_strdupf("%s/%s", d, token_ptr);
+        if (NULL == p) break;
+        if (0 == access(p, X_OK)) resolved_ptr = realpath(p, NULL);
+        free(p);
+    }
+    free(dirs_ptr);
+    return resolved_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the real path of the `wlmtool` installed alongside the running
+ * executable. Both are built from the same source, so the in-process
+ * generators produce the same output.
+ *
+ * @return The path, or NULL if there is no `wlmtool` next to the running
+ *     executable. Must be released by free().
+ */
+char *_wlmaker_menu_generator_wlmtool_path(void)
+{
+    char *exe_ptr = realpath("/proc/self/exe", NULL);
+    if (NULL == exe_ptr) return NULL;
+    char *p = bs_strdupf("%s/wlmtool", dirname(exe_ptr));
+    free(exe_ptr);
+    if (NULL == p) return NULL;
+    char *wlmtool_path_ptr = realpath(p, NULL);
+    free(p);
+    return wlmtool_path_ptr;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmaker_menu_generator_test_from_command(bs_test_t *test_ptr);
+static void _wlmaker_menu_generator_test_run(bs_test_t *test_ptr);
+static void _wlmaker_menu_generator_test_destroy_running(bs_test_t *test_ptr);
+static void _wlmaker_menu_generator_test_same_output(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlmaker_menu_generator_test_cases[] = {
+    { true, "from_command", _wlmaker_menu_generator_test_from_command },
+    { true, "run", _wlmaker_menu_generator_test_run },
+    { true, "destroy_running", _wlmaker_menu_generator_test_destroy_running },
+    { true, "same_output", _wlmaker_menu_generator_test_same_output },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmaker_menu_generator_test_set = BS_TEST_SET(
+    true, "menu_generator", _wlmaker_menu_generator_test_cases);
+
+/** Test helper: Stores the array passed to the callback. */
+static void _wlmaker_menu_generator_test_callback(
+    bspl_array_t *array_ptr,
+    void *ud_ptr)
+{
+    bspl_array_t **array_ptr_ptr = ud_ptr;
+    *array_ptr_ptr = array_ptr;
+}
+
+/** Test helper: Blocks @ref _wlmaker_menu_generator_test_slow while held. */
+static pthread_mutex_t _wlmaker_menu_generator_test_gate =
+    PTHREAD_MUTEX_INITIALIZER;
+
+/** Test helper: A slow generator, returning an empty array. */
+static bspl_array_t *_wlmaker_menu_generator_test_slow(
+    __UNUSED__ const char *path_ptr,
+    __UNUSED__ const char *locale_ptr)
+{
+    pthread_mutex_lock(&_wlmaker_menu_generator_test_gate);
+    pthread_mutex_unlock(&_wlmaker_menu_generator_test_gate);
+    return bspl_array_create();
+}
+
+/** Test helper: Looks up the generator for a command formatted from `w`. */
+static wlmaker_menu_generator_fn_t _wlmaker_menu_generator_test_lookup(
+    const char *fmt_ptr,
+    const char *w,
+    const char *wlmtool_path_ptr,
+    char **path_ptr_ptr,
+    char **locale_ptr_ptr)
+{
+    char *c = bs_strdupf(fmt_ptr, w);
+    if (NULL == c) return NULL;
+    wlmaker_menu_generator_fn_t fn = _wlmaker_menu_generator_from_command(
+        c, wlmtool_path_ptr, path_ptr_ptr, locale_ptr_ptr);
+    free(c);
+    return fn;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises @ref wlmaker_menu_generator_from_command. */
+void _wlmaker_menu_generator_test_from_command(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmaker_menu_generator_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *w = bs_strdupf("%s/wlmtool", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    int fd = open(w, O_CREAT | O_WRONLY, 0755);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= fd);
+    close(fd);
+    char *wp = realpath(w, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wp);
+    char *p = NULL, *l = NULL;
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        _wlmaker_menu_generator_appearance,
+        _wlmaker_menu_generator_test_lookup(
+            "%s GenerateThemesMenu", w, wp, &p, &l));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, p);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, l);
+
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        wlmtool_menu_generate_applications,
+        _wlmaker_menu_generator_test_lookup(
+            "%s  --locale=de_CH GenerateApplicationsMenu\t/usr/share",
+            w, wp, &p, &l));
+    BS_TEST_VERIFY_STREQ(test_ptr, "/usr/share", p);
+    BS_TEST_VERIFY_STREQ(test_ptr, "de_CH", l);
+    free(p);
+    free(l);
+    p = NULL;
+    l = NULL;
+
+    // Found through ${PATH}.
+    char *env_path_ptr = logged_strdup(getenv("PATH"));
+    setenv("PATH", dir, 1);
+    BS_TEST_VERIFY_EQ(
+        test_ptr,
+        _wlmaker_menu_generator_appearance,
+        _wlmaker_menu_generator_test_lookup(
+            "wlmtool GenerateThemesMenu", NULL, wp, &p, &l));
+    if (NULL != env_path_ptr) {
+        setenv("PATH", env_path_ptr, 1);
+        free(env_path_ptr);
+    }
+
+    // Another wlmtool than the installed one: Not in-process.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_menu_generator_test_lookup(
+            "%s GenerateThemesMenu", w, NULL, &p, &l));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        _wlmaker_menu_generator_test_lookup(
+            "%s/../wlmtool GenerateThemesMenu", dir, wp, &p, &l));
+
+    // Shell syntax, other commands, options or extra arguments: Neither.
+    const char *fmts[] = {
+        "%s GenerateThemesMenu | cat",
+        "%s GenerateThemesMenu ~/Themes",
+        "cat tests/data/menu.plist %s",
+        "my%s GenerateThemesMenu",
+        "%s Version",
+        "%s GenerateThemesMenu a b",
+        "%s",
+        "%s --verbose GenerateThemesMenu",
+        NULL };
+    for (const char **f = fmts; NULL != *f; ++f) {
+        BS_TEST_VERIFY_EQ(
+            test_ptr, NULL,
+            _wlmaker_menu_generator_test_lookup(*f, w, wp, &p, &l));
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, p);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, l);
+
+    unlink(w);
+    rmdir(dir);
+    free(wp);
+    free(w);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Runs the 'Appearance' generator on a worker, and verifies the result. */
+void _wlmaker_menu_generator_test_run(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    bspl_array_t *array_ptr = NULL;
+    wlmaker_menu_generator_t *g = wlmaker_menu_generator_create(
+        wl_event_loop_ptr,
+        _wlmaker_menu_generator_appearance,
+        bs_test_data_path(test_ptr, "Themes"),
+        NULL,
+        _wlmaker_menu_generator_test_callback,
+        &array_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, g);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmaker_menu_generator_latency_usec(g));
+
+    for (int i = 0; i < 100 && 0 == wlmaker_menu_generator_latency_usec(g);
+         ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 100);
+    }
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, wlmaker_menu_generator_latency_usec(g));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_menu_generator_run_usec(g) <=
+        wlmaker_menu_generator_latency_usec(g));
+    wlmaker_menu_generator_destroy(g);
+
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, array_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, bspl_array_size(array_ptr));
+    BS_TEST_VERIFY_STREQ(
+        test_ptr, "Appearance", bspl_array_string_value_at(array_ptr, 0));
+    bspl_array_unref(array_ptr);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroying a running generator does not wait, and does not call back. */
+void _wlmaker_menu_generator_test_destroy_running(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    // Holds the gate: Destroying would deadlock, if it waited for the worker.
+    pthread_mutex_lock(&_wlmaker_menu_generator_test_gate);
+    bspl_array_t *array_ptr = NULL;
+    wlmaker_menu_generator_t *g = wlmaker_menu_generator_create(
+        wl_event_loop_ptr,
+        _wlmaker_menu_generator_test_slow,
+        NULL,
+        NULL,
+        _wlmaker_menu_generator_test_callback,
+        &array_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, g);
+    if (NULL != g) wlmaker_menu_generator_destroy(g);
+    pthread_mutex_unlock(&_wlmaker_menu_generator_test_gate);
+
+    // The worker releases the generator. Give it time, for leak checkers.
+    usleep(20000);
+    wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, array_ptr);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test helper: Verifies `fn` gives the same output as `wlmtool` `args`. */
+static void _wlmaker_menu_generator_test_compare(
+    bs_test_t *test_ptr,
+    const char *args_ptr,
+    wlmaker_menu_generator_fn_t fn,
+    const char *path_ptr,
+    const char *locale_ptr)
+{
+    char *c = bs_strdupf(WLMAKER_BINARY_DIR "/tool/wlmtool %s", args_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, c);
+    FILE *file_ptr = popen(c, "r");
+    free(c);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    size_t capacity = 1 << 20;
+    char *tool_data_ptr = logged_calloc(1, capacity);
+    size_t tool_length = 0;
+    if (NULL != tool_data_ptr) {
+        tool_length = fread(tool_data_ptr, 1, capacity, file_ptr);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 0, pclose(file_ptr));
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tool_data_ptr);
+
+    bs_dynbuf_t buf = {};
+    bool initialized = bs_dynbuf_init(&buf, 1024, SIZE_MAX);
+    BS_TEST_VERIFY_TRUE(test_ptr, initialized);
+    if (!initialized) {
+        free(tool_data_ptr);
+        return;
+    }
+    bspl_array_t *array_ptr = fn(path_ptr, locale_ptr);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, array_ptr);
+    if (NULL != array_ptr) {
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            bspl_object_write(bspl_object_from_array(array_ptr), &buf));
+        bspl_array_unref(array_ptr);
+    }
+
+    BS_TEST_VERIFY_EQ(test_ptr, tool_length, buf.length);
+    if (tool_length == buf.length) {
+        BS_TEST_VERIFY_MEMEQ(
+            test_ptr, tool_data_ptr, buf.data_ptr, buf.length);
+    }
+    bs_dynbuf_fini(&buf);
+    free(tool_data_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** The in-process generators produce the same output as `wlmtool`. */
+void _wlmaker_menu_generator_test_same_output(bs_test_t *test_ptr)
+{
+#ifndef WLMAKER_BINARY_DIR
+#error "Missing definition of WLMAKER_BINARY_DIR!"
+#endif
+    _wlmaker_menu_generator_test_compare(
+        test_ptr,
+        "GenerateThemesMenu " WLMAKER_SOURCE_DIR "/share/Themes",
+        _wlmaker_menu_generator_appearance,
+        WLMAKER_SOURCE_DIR "/share/Themes",
+        NULL);
+    _wlmaker_menu_generator_test_compare(
+        test_ptr,
+        "--locale=de_CH GenerateApplicationsMenu " WLMAKER_BINARY_DIR "/share",
+        wlmtool_menu_generate_applications,
+        WLMAKER_BINARY_DIR "/share",
+        "de_CH");
+}
+
+/* == End of menu_generator.c ============================================== */
@@ -0,0 +1,155 @@
+/* ========================================================================= */
+/**
+ * @file menu_generator.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_MENU_GENERATOR_H__
+#define __WLMAKER_MENU_GENERATOR_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include <libbase/libbase.h>
+#include <libbase/plist.h>
+
+struct wl_event_loop;
+
+/** Forward declaration: An in-process menu generator. */
+typedef struct _wlmaker_menu_generator_t wlmaker_menu_generator_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * A menu generation function that can run in-process, on a worker thread.
+ *
+ * @param path_ptr            Optional: Path to read from, or NULL.
+ * @param locale_ptr          Optional: Locale to use, or NULL.
+ *
+ * @return A Plist array, or NULL on error.
+ */
+typedef bspl_array_t *(*wlmaker_menu_generator_fn_t)(
+    const char *path_ptr,
+    const char *locale_ptr);
+
+/**
+ * Callback for when the generator has completed. Called on the thread
+ * running the event loop.
+ *
+ * @param array_ptr           The generated Plist array, or NULL if generation
+ *                            failed. Ownership passes to the callee.
+ * @param ud_ptr              As given to @ref wlmaker_menu_generator_create.
+ */
+typedef void (*wlmaker_menu_generator_callback_t)(
+    bspl_array_t *array_ptr,
+    void *ud_ptr);
+
+/**
+ * Looks up the in-process generator for a `GeneratePlistMenu` command.
+ *
+ * Recognizes the commands of `wlmtool` that generate menus, eg.
+ * `wlmtool [--locale=LOCALE] GenerateApplicationsMenu [PATH]`. The command
+ * runs in-process only if all of these hold:
+ *
+ * - It does not use any shell syntax, since that would not be evaluated.
+ * - It has no options other than `--locale=LOCALE`.
+ * - `wlmtool` resolves (through ${PATH}, if not given as a path) to the
+ *   `wlmtool` installed next to the running executable. That one is built
+ *   from the same source as the in-process generators, and produces the
+ *   same output.
+ *
+ * Otherwise, the command runs as a subprocess, through `/bin/sh`. For a
+ * `wlmtool` command, the reason is logged.
+ *
+ * @param command_ptr
+ * @param path_ptr_ptr        Set to a copy of the optional PATH argument, or
+ *                            NULL if there is none. Must be free()-ed.
+ * @param locale_ptr_ptr      Set to a copy of the optional LOCALE, or NULL if
+ *                            there is none. Must be free()-ed.
+ *
+ * @return The generator function, or NULL if `command_ptr` does not match
+ *     any registered generator. `path_ptr_ptr` and `locale_ptr_ptr` will not
+ *     be set then.
+ */
+wlmaker_menu_generator_fn_t wlmaker_menu_generator_from_command(
+    const char *command_ptr,
+    char **path_ptr_ptr,
+    char **locale_ptr_ptr);
+
+/**
+ * Creates a generator, and starts running `fn` on a worker thread.
+ *
+ * Once `fn` returns, `callback` is invoked from `wl_event_loop_ptr`. The
+ * generator can be destroyed from within the callback.
+ *
+ * @param wl_event_loop_ptr
+ * @param fn
+ * @param path_ptr            Argument to `fn`. Will be copied.
+ * @param locale_ptr          Argument to `fn`. Will be copied.
+ * @param callback
+ * @param callback_ud_ptr
+ *
+ * @return The generator, or NULL on error. Must be destroyed by calling
+ *     @ref wlmaker_menu_generator_destroy.
+ */
+wlmaker_menu_generator_t *wlmaker_menu_generator_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    wlmaker_menu_generator_fn_t fn,
+    const char *path_ptr,
+    const char *locale_ptr,
+    wlmaker_menu_generator_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Destroys the generator. Does not wait for a still-running worker: The
+ * worker discards the result once complete, without invoking the callback.
+ *
+ * @param generator_ptr
+ */
+void wlmaker_menu_generator_destroy(wlmaker_menu_generator_t *generator_ptr);
+
+/**
+ * Returns the time spent on the worker thread, running the generator.
+ *
+ * @param generator_ptr
+ *
+ * @return Duration in microseconds, or 0 if not completed yet.
+ */
+uint64_t wlmaker_menu_generator_run_usec(
+    wlmaker_menu_generator_t *generator_ptr);
+
+/**
+ * Returns the latency from creating the generator until the result was
+ * handed back to the event loop.
+ *
+ * @param generator_ptr
+ *
+ * @return Duration in microseconds, or 0 if not completed yet.
+ */
+uint64_t wlmaker_menu_generator_latency_usec(
+    wlmaker_menu_generator_t *generator_ptr);
+
+/** Unit test set. */
+extern const bs_test_set_t wlmaker_menu_generator_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // __WLMAKER_MENU_GENERATOR_H__
+/* == End of menu_generator.h ============================================== */
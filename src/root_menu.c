@@ -43,6 +43,7 @@
 #include "action.h"
 #include "action_item.h"
 #include "config.h"
+#include "menu_generator.h"
 #include "util/subprocess_monitor.h"
 #include "server.h"
 
@@ -71,10 +72,17 @@ struct _wlmaker_root_menu_t {
     wlmaker_server_t          *server_ptr;
 };
 
-/** State of a menu generator, while waiting for subprocess to complete. */
+/**
+ * State of a menu generator, while waiting for the subprocess or in-process
+ * generator to complete.
+ */
 typedef struct {
     /** Subprocess handle. */
     struct wlm_util_subprocess *subprocess_handle_ptr;
+    /** In-process generator, if the command has a registered generator. */
+    wlmaker_menu_generator_t  *menu_generator_ptr;
+    /** Timestamp when the generator was started, in microseconds. */
+    uint64_t                  start_usec;
     /** Back-link to the server. */
     wlmaker_server_t          *server_ptr;
     /** The menu this generator is going to populate. */
@@ -132,6 +140,15 @@ static void _wlmaker_root_menu_generator_handle_terminated(
     struct wlm_util_subprocess *subprocess_handle_ptr,
     int state,
     int code);
+static void _wlmaker_root_menu_generator_handle_generated(
+    bspl_array_t *array_ptr,
+    void *ud_ptr);
+static void _wlmaker_root_menu_generator_record(
+    wlmaker_root_menu_generator_stats_t *stats_ptr,
+    uint64_t usec);
+static void _wlmaker_root_menu_generator_complete(
+    wlmaker_root_menu_generator_t *generator_ptr,
+    wlmtk_menu_item_t *menu_item_ptr);
 
 static wlmtk_menu_item_t *_wlmaker_root_menu_create_item_from_array(
     bspl_array_t *item_array_ptr,
@@ -160,6 +177,10 @@ static const char *_wlmaker_root_menu_statement_generate = "GeneratePlistMenu";
 static struct wl_display      *_wlmaker_root_menu_test_wl_display_ptr = NULL;
 /** Number of generators, used to terminate display in unit tests. */
 static size_t                 _wlmaker_root_menu_generators = 0;
+/** Latency statistics of in-process generators. */
+static wlmaker_root_menu_generator_stats_t _wlmaker_root_menu_in_process_stats;
+/** Latency statistics of subprocess generators. */
+static wlmaker_root_menu_generator_stats_t _wlmaker_root_menu_subprocess_stats;
 
 /* == Exported methods ===================================================== */
 
@@ -285,6 +306,14 @@ void wlmaker_root_menu_destroy(wlmaker_root_menu_t *root_menu_ptr)
     free(root_menu_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+const wlmaker_root_menu_generator_stats_t *wlmaker_root_menu_generator_stats(
+    bool in_process)
+{
+    if (in_process) return &_wlmaker_root_menu_in_process_stats;
+    return &_wlmaker_root_menu_subprocess_stats;
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_window_t *wlmaker_root_menu_window(wlmaker_root_menu_t *root_menu_ptr)
 {
@@ -573,6 +602,11 @@ bool _wlmaker_root_menu_populate_menu_items_from_file(
  * Uses a @ref wlmaker_root_menu_generator_t to track state of the subprocess
  * and to tie it with the menu's lifecycle.
  *
+ * If `command_ptr` is a `wlmtool` command with a registered in-process
+ * generator (see @ref wlmaker_menu_generator_from_command), that generator
+ * runs on a worker thread instead. This skips the process launch and the
+ * Plist text round-trip.
+ *
  * @param menu_ptr
  * @param command_ptr
  * @param menu_style_ref_ptr
@@ -586,7 +620,6 @@ bool _wlmaker_root_menu_populate_menu_items_from_generator(
     wlmtk_menu_style_ref_t *menu_style_ref_ptr,
     wlmaker_server_t *server_ptr)
 {
-    bs_subprocess_t *subprocess_ptr = NULL;
     wlmaker_root_menu_generator_t *generator_ptr = logged_calloc(
         1, sizeof(wlmaker_root_menu_generator_t));
     if (NULL == generator_ptr) return false;
@@ -594,40 +627,53 @@ bool _wlmaker_root_menu_populate_menu_items_from_generator(
     generator_ptr->menu_ptr = menu_ptr;
     generator_ptr->style_ref_ptr = menu_style_ref_ptr;
 
-    generator_ptr->stdout_dynbuf_ptr = bs_dynbuf_create(1024, INT32_MAX);
-    if (NULL == generator_ptr->stdout_dynbuf_ptr) goto error;
-
     wlmtk_util_connect_listener_signal(
         &wlmtk_menu_events(menu_ptr)->destroy,
         &generator_ptr->menu_destroy_listener,
         _wlmaker_root_menu_generator_handle_menu_destroy);
+    generator_ptr->start_usec = bs_usec();
+
+    char *path_ptr = NULL, *locale_ptr = NULL;
+    wlmaker_menu_generator_fn_t fn = wlmaker_menu_generator_from_command(
+        command_ptr, &path_ptr, &locale_ptr);
+    if (NULL != fn) {
+        _wlmaker_root_menu_generators++;
+        generator_ptr->menu_generator_ptr = wlmaker_menu_generator_create(
+            wl_display_get_event_loop(server_ptr->wl_display_ptr),
+            fn,
+            path_ptr,
+            locale_ptr,
+            _wlmaker_root_menu_generator_handle_generated,
+            generator_ptr);
+        if (NULL != path_ptr) free(path_ptr);
+        if (NULL != locale_ptr) free(locale_ptr);
+        if (NULL == generator_ptr->menu_generator_ptr) {
+            _wlmaker_root_menu_generators--;
+            goto error;
+        }
+        bs_log(BS_INFO, "Generating menu in-process for \"%s\"", command_ptr);
+        return true;
+    }
 
-    const char *args[] = { "/bin/sh", "-c", command_ptr, NULL };
-    subprocess_ptr =  bs_subprocess_create(args[0], args, NULL);
-    if (NULL == subprocess_ptr) goto error;
-
-    if (!bs_subprocess_start(subprocess_ptr)) goto error;
-    bs_log(BS_INFO,
-           "Created subprocess %p [%"PRIdMAX"] for \"/bin/sh\" \"-c\" \"%s\"",
-           subprocess_ptr,
-           (intmax_t)bs_subprocess_pid(subprocess_ptr),
-           command_ptr);
+    generator_ptr->stdout_dynbuf_ptr = bs_dynbuf_create(1024, INT32_MAX);
+    if (NULL == generator_ptr->stdout_dynbuf_ptr) goto error;
 
-    _wlmaker_root_menu_generators++;
-    generator_ptr->subprocess_handle_ptr = wlm_util_subprocess_monitor_entrust(
+    generator_ptr->subprocess_handle_ptr = wlm_util_subprocess_monitor_spawn(
         server_ptr->monitor_ptr,
-        subprocess_ptr,
+        command_ptr,
         _wlmaker_root_menu_generator_handle_terminated,
         generator_ptr,
         generator_ptr->stdout_dynbuf_ptr);
     if (NULL == generator_ptr->subprocess_handle_ptr) goto error;
-
+    _wlmaker_root_menu_generators++;
+    bs_log(BS_INFO, "Created subprocess %p [%"PRIdMAX"] for \"%s\"",
+           generator_ptr->subprocess_handle_ptr,
+           (intmax_t)wlm_util_subprocess_pid(
+               generator_ptr->subprocess_handle_ptr),
+           command_ptr);
     return true;
 
 error:
-    if (NULL != subprocess_ptr) {
-        bs_subprocess_destroy(subprocess_ptr);
-    }
     _wlmaker_root_menu_generator_destroy(generator_ptr);
     return false;
 }
@@ -643,6 +689,10 @@ void _wlmaker_root_menu_generator_destroy(
             generator_ptr->subprocess_handle_ptr);
         generator_ptr->subprocess_handle_ptr = NULL;
     }
+    if (NULL != generator_ptr->menu_generator_ptr) {
+        wlmaker_menu_generator_destroy(generator_ptr->menu_generator_ptr);
+        generator_ptr->menu_generator_ptr = NULL;
+    }
 
     if (NULL != generator_ptr->stdout_dynbuf_ptr) {
         bs_dynbuf_destroy(generator_ptr->stdout_dynbuf_ptr);
@@ -693,7 +743,9 @@ void _wlmaker_root_menu_generator_handle_terminated(
         }
     } else {
 
-        bs_log(BS_INFO, "Subprocess %p terminated", subprocess_handle_ptr);
+        bs_log(BS_INFO, "Subprocess %p terminated after %"PRIu64" usec",
+               subprocess_handle_ptr,
+               bs_usec() - generator_ptr->start_usec);
 
         bspl_object_t *object_ptr = bspl_create_object_from_dynbuf(
             generator_ptr->stdout_dynbuf_ptr);
@@ -732,11 +784,80 @@ void _wlmaker_root_menu_generator_handle_terminated(
         }
     }
 
+    generator_ptr->subprocess_handle_ptr = NULL;
+    _wlmaker_root_menu_generator_record(
+        &_wlmaker_root_menu_subprocess_stats,
+        bs_usec() - generator_ptr->start_usec);
+    _wlmaker_root_menu_generator_complete(generator_ptr, menu_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Handler for when the in-process generator has handed back the result. */
+void _wlmaker_root_menu_generator_handle_generated(
+    bspl_array_t *array_ptr,
+    void *ud_ptr)
+{
+    wlmaker_root_menu_generator_t *generator_ptr = ud_ptr;
+    wlmtk_menu_item_t *menu_item_ptr = NULL;
+
+    if (NULL == array_ptr) {
+        menu_item_ptr = _wlmaker_root_menu_create_disabled_item(
+            generator_ptr->style_ref_ptr, "Failed to generate menu");
+        bs_log(BS_ERROR, "Menu generator %p failed",
+               generator_ptr->menu_generator_ptr);
+    } else {
+        if (!_wlmaker_root_menu_populate_menu_items_from_array(
+                generator_ptr->menu_ptr,
+                array_ptr,
+                generator_ptr->style_ref_ptr,
+                generator_ptr->server_ptr)) {
+            menu_item_ptr = _wlmaker_root_menu_create_disabled_item(
+                generator_ptr->style_ref_ptr,
+                "Failed to populate menu from generated Plist ARRAY");
+            bs_log(BS_ERROR, "Failed to populate menu from generator %p",
+                   generator_ptr->menu_generator_ptr);
+        }
+        bspl_array_unref(array_ptr);
+    }
+    uint64_t usec = bs_usec() - generator_ptr->start_usec;
+    bs_log(BS_INFO, "Menu generator %p: Menu populated after %"PRIu64" usec",
+           generator_ptr->menu_generator_ptr, usec);
+    _wlmaker_root_menu_generator_record(
+        &_wlmaker_root_menu_in_process_stats, usec);
+
+    wlmaker_menu_generator_destroy(generator_ptr->menu_generator_ptr);
+    generator_ptr->menu_generator_ptr = NULL;
+    _wlmaker_root_menu_generator_complete(generator_ptr, menu_item_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Accounts the latency `usec` of a completed generator into `stats_ptr`. */
+void _wlmaker_root_menu_generator_record(
+    wlmaker_root_menu_generator_stats_t *stats_ptr,
+    uint64_t usec)
+{
+    stats_ptr->count++;
+    stats_ptr->last_usec = usec;
+    stats_ptr->max_usec = BS_MAX(stats_ptr->max_usec, usec);
+    stats_ptr->sum_usec += usec;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds the optional (error) item to the menu, and accounts for the completed
+ * generator.
+ *
+ * @param generator_ptr
+ * @param menu_item_ptr       Optional: Menu item to add.
+ */
+void _wlmaker_root_menu_generator_complete(
+    wlmaker_root_menu_generator_t *generator_ptr,
+    wlmtk_menu_item_t *menu_item_ptr)
+{
     if (NULL!= menu_item_ptr) {
         wlmtk_menu_add_item(generator_ptr->menu_ptr, menu_item_ptr);
     }
 
-    generator_ptr->subprocess_handle_ptr = NULL;
     _wlmaker_root_menu_generators--;
 
     if (NULL != _wlmaker_root_menu_test_wl_display_ptr &&
@@ -924,6 +1045,7 @@ void test_generated_menu(bs_test_t *test_ptr)
     wlmaker_root_menu_destroy(root_menu_ptr);
 
     // Exercise & verify generating a submenu from a shell command.
+    uint64_t count = wlmaker_root_menu_generator_stats(false)->count;
     root_menu_ptr = wlmaker_root_menu_create(
         &server,
         bs_test_data_path(test_ptr, "menu-generate.plist"),
@@ -934,6 +1056,12 @@ void test_generated_menu(bs_test_t *test_ptr)
     _wlmaker_root_menu_test_wl_display_ptr = server.wl_display_ptr;
     wl_display_run(server.wl_display_ptr);
     BS_TEST_VERIFY_NEQ(test_ptr, 0, wlmtk_menu_items_size(menu_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, count + 1, wlmaker_root_menu_generator_stats(false)->count);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmaker_root_menu_generator_stats(false)->last_usec <=
+        wlmaker_root_menu_generator_stats(false)->max_usec);
     wlmaker_root_menu_destroy(root_menu_ptr);
 
     // Exercise & verify that a menu can be generated from output of the
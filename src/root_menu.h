@@ -63,6 +63,32 @@ wlmtk_window_t *wlmaker_root_menu_window(wlmaker_root_menu_t *root_menu_ptr);
 /** @return Pointer to @ref wlmtk_menu_t of the root menu. */
 wlmtk_menu_t *wlmaker_root_menu_menu(wlmaker_root_menu_t *root_menu_ptr);
 
+/** Latency statistics of the root menu's generators. */
+typedef struct {
+    /** Number of generators that completed. */
+    uint64_t                  count;
+    /** Latency of the most recently completed generator, in usec. */
+    uint64_t                  last_usec;
+    /** Highest latency seen, in usec. */
+    uint64_t                  max_usec;
+    /** Sum of all latencies, in usec. Divide by `count` for the mean. */
+    uint64_t                  sum_usec;
+} wlmaker_root_menu_generator_stats_t;
+
+/**
+ * Returns the latency statistics of menu generators.
+ *
+ * Latency is measured from launching the generator until its items are
+ * added to the menu.
+ *
+ * @param in_process          Whether to return the statistics of in-process
+ *                            generators, or of subprocess generators.
+ *
+ * @return Pointer to the statistics. Valid for the program's lifetime.
+ */
+const wlmaker_root_menu_generator_stats_t *wlmaker_root_menu_generator_stats(
+    bool in_process);
+
 /** Unit test set. */
 extern const bs_test_set_t wlmaker_root_menu_test_set;
 
@@ -109,6 +109,16 @@ wlmaker_server_t *wlmaker_server_create(
         return NULL;
     }
 
+    // Decorations and menus are drawn off the event loop's thread.
+    server_ptr->raster_pool_ptr = wlmtk_raster_pool_create(
+        wl_display_get_event_loop(server_ptr->wl_display_ptr), 2);
+    if (NULL == server_ptr->raster_pool_ptr) {
+        bs_log(BS_ERROR, "Failed wlmtk_raster_pool_create()");
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+    wlmtk_raster_set_pool(server_ptr->raster_pool_ptr);
+
     server_ptr->wlr_viewporter_ptr = wlr_viewporter_create(
         server_ptr->wl_display_ptr);
     if (NULL == server_ptr->wlr_viewporter_ptr) {
@@ -325,6 +335,12 @@ wlmaker_server_t *wlmaker_server_create(
         return NULL;
     }
 
+    server_ptr->launch_tracker_ptr = wlm_util_launch_tracker_create();
+    if (NULL == server_ptr->launch_tracker_ptr) {
+        wlmaker_server_destroy(server_ptr);
+        return NULL;
+    }
+
     server_ptr->corner_ptr = wlmaker_corner_create(
         bspl_dict_get_dict(server_ptr->config_dict_ptr, "HotCorner"),
         wl_display_get_event_loop(server_ptr->wl_display_ptr),
@@ -371,6 +387,12 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->corner_ptr = NULL;
     }
 
+    if (NULL != server_ptr->launch_tracker_ptr) {
+        wlm_util_launch_tracker_log(server_ptr->launch_tracker_ptr, BS_INFO);
+        wlm_util_launch_tracker_destroy(server_ptr->launch_tracker_ptr);
+        server_ptr->launch_tracker_ptr = NULL;
+    }
+
     if (NULL != server_ptr->monitor_ptr) {
         wlm_util_subprocess_monitor_destroy(server_ptr->monitor_ptr);
         server_ptr->monitor_ptr =NULL;
@@ -444,6 +466,12 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
         server_ptr->desktop_ptr = NULL;
     }
 
+    if (NULL != server_ptr->raster_pool_ptr) {
+        wlmtk_raster_set_pool(NULL);
+        wlmtk_raster_pool_destroy(server_ptr->raster_pool_ptr);
+        server_ptr->raster_pool_ptr = NULL;
+    }
+
     if (NULL != server_ptr->backend_ptr) {
         wlmbe_backend_destroy(server_ptr->backend_ptr);
         server_ptr->backend_ptr = NULL;
@@ -467,6 +495,44 @@ void wlmaker_server_destroy(wlmaker_server_t *server_ptr)
     free(server_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmaker_server_run(wlmaker_server_t *server_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_display_get_event_loop(
+        server_ptr->wl_display_ptr);
+    uint32_t threshold_msec = server_ptr->options_ptr->stall_threshold_msec;
+    if (0 < threshold_msec) {
+        // Without a watchdog, the loop just runs unobserved.
+        server_ptr->watchdog_ptr = wlm_util_watchdog_create(
+            (uint64_t)threshold_msec * 1000);
+    }
+
+    // As wl_display_run(): Runs pending idle sources and flushes the clients
+    // before waiting. Idle sources added by a dispatch run before the next.
+    server_ptr->running = true;
+    while (server_ptr->running) {
+        wlm_util_watchdog_dispatch_idle(
+            server_ptr->watchdog_ptr, wl_event_loop_ptr);
+        wl_display_flush_clients(server_ptr->wl_display_ptr);
+        if (0 > wlm_util_watchdog_dispatch(
+                server_ptr->watchdog_ptr, wl_event_loop_ptr, -1)) break;
+    }
+
+    if (NULL != server_ptr->watchdog_ptr) {
+        wlm_util_watchdog_log_histogram(server_ptr->watchdog_ptr, BS_INFO);
+        wlm_util_watchdog_destroy(server_ptr->watchdog_ptr);
+        server_ptr->watchdog_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmaker_server_terminate(wlmaker_server_t *server_ptr)
+{
+    server_ptr->running = false;
+    // Also for wl_display_run(), and wakes up a waiting event loop.
+    wl_display_terminate(server_ptr->wl_display_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmaker_server_activate_task_list(wlmaker_server_t *server_ptr)
 {
@@ -51,7 +51,9 @@ typedef struct _wlmaker_server_t wlmaker_server_t;
 #include "root_menu.h"  // IWYU pragma: keep
 #include "toolkit/toolkit.h"
 #include "util/files.h"
+#include "util/launch_tracker.h"
 #include "util/subprocess_monitor.h"  // IWYU pragma: keep
+#include "util/watchdog.h"
 #include "xdg_decoration.h"  // IWYU pragma: keep
 #include "xdg_shell.h"  // IWYU pragma: keep
 #include "xwl.h"  // IWYU pragma: keep
@@ -70,6 +72,8 @@ typedef struct {
     uint32_t                  height;
     /** Whether to include 'Logo' to modifiers. */
     bool                      bind_with_logo;
+    /** Dispatches running longer are logged, with a stack. 0 to disable. */
+    uint32_t                  stall_threshold_msec;
 } wlmaker_server_options_t;
 
 /** State of the Wayland server. */
@@ -85,6 +89,12 @@ struct _wlmaker_server_t {
     struct wl_display         *wl_display_ptr;
     /** Name of the socket for clients to connect. */
     const char                *wl_socket_name_ptr;
+    /** Pool for drawing toolkit buffers off the event loop's thread. */
+    wlmtk_raster_pool_t       *raster_pool_ptr;
+    /** Whether @ref wlmaker_server_run keeps dispatching. */
+    bool                      running;
+    /** Watchdog for the event loop, while running. May be NULL. */
+    wlm_util_watchdog_t       *watchdog_ptr;
 
     /** Session lock manager. */
     wlmaker_lock_mgr_t        *lock_mgr_ptr;
@@ -159,6 +169,8 @@ struct _wlmaker_server_t {
 
     /** Subprocess monitoring. */
     wlm_util_subprocess_monitor_t *monitor_ptr;
+    /** Latency from launching applications to their first window. */
+    wlm_util_launch_tracker_t *launch_tracker_ptr;
 
     /** Montor & handler of 'hot corners'. */
     wlmaker_corner_t          *corner_ptr;
@@ -213,6 +225,24 @@ wlmaker_server_t *wlmaker_server_create(
  */
 void wlmaker_server_destroy(wlmaker_server_t *server_ptr);
 
+/**
+ * Runs the event loop, until @ref wlmaker_server_terminate is called.
+ *
+ * Like wl_display_run(), but each dispatch runs under a watchdog, if
+ * @ref wlmaker_server_options_t::stall_threshold_msec is set. The histogram
+ * of dispatch durations is logged on return.
+ *
+ * @param server_ptr
+ */
+void wlmaker_server_run(wlmaker_server_t *server_ptr);
+
+/**
+ * Stops @ref wlmaker_server_run, once the current dispatch returns.
+ *
+ * @param server_ptr
+ */
+void wlmaker_server_terminate(wlmaker_server_t *server_ptr);
+
 /**
  * Activates the task list.
  *
@@ -38,6 +38,8 @@
 #define WLR_USE_UNSTABLE
 #include <wlr/util/edges.h>
 #include <wlr/interfaces/wlr_buffer.h>
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
 #undef WLR_USE_UNSTABLE
 
 #include "config.h"
@@ -53,6 +55,8 @@ struct _wlmaker_task_list_t {
 
     /** Buffer that shows the tasklist's content. */
     wlmtk_buffer_t            buffer;
+    /** Pending rasterization of the content, or NULL. */
+    wlmtk_raster_job_t        *job_ptr;
 
     /** Backlink to the server. */
     wlmaker_server_t          *server_ptr;
@@ -76,21 +80,50 @@ struct _wlmaker_task_list_t {
     struct wlmaker_task_list_style style;
 };
 
+/** Maximum number of windows (tasks) listed: The active one, and 3 each. */
+#define _WLMAKER_TASK_LIST_MAX_ENTRIES 7
+
+/** A window (task) to draw, as captured for @ref _wlmaker_task_list_draw. */
+typedef struct {
+    /** Name of the window. Copied, owned by the arguments. */
+    char                      *name_ptr;
+    /** Whether this window is currently active. */
+    bool                      active;
+    /** Y position within the buffer. */
+    int                       pos_y;
+} wlmaker_task_list_entry_t;
+
+/** Arguments for drawing the task list on the rasterization pool. */
+typedef struct {
+    /** Visual style, copied. */
+    struct wlmaker_task_list_style style;
+    /** Number of used elements in `entries`. */
+    size_t                    num_entries;
+    /** Windows (tasks) to draw. */
+    wlmaker_task_list_entry_t entries[_WLMAKER_TASK_LIST_MAX_ENTRIES];
+} wlmaker_task_list_draw_args_t;
+
 static bool _wlmaker_task_list_refresh(
     wlmaker_task_list_t *task_list_ptr,
     const struct wlmaker_task_list_style *style_ptr);
-static struct wlr_buffer *create_wlr_buffer(
-    wlmtk_workspace_t *workspace_ptr,
-    const struct wlmaker_task_list_style *style_ptr);
-static void _wlmaker_task_list_draw_into_cairo(
-    cairo_t *cairo_ptr,
-    const struct wlmaker_task_list_style *style_ptr,
+static bool _wlmaker_task_list_capture(
+    wlmaker_task_list_draw_args_t *args,
     wlmtk_workspace_t *workspace_ptr);
+static bool _wlmaker_task_list_capture_window(
+    wlmaker_task_list_draw_args_t *args,
+    wlmtk_window_t *window_ptr,
+    bool active,
+    int pos_y);
+static void _wlmaker_task_list_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmaker_task_list_draw(cairo_t *cairo_ptr, void *args_ptr);
+static void _wlmaker_task_list_args_fini(void *args_ptr);
 static void _wlmaker_task_list_draw_window_into_cairo(
     cairo_t *cairo_ptr,
     const wlmtk_style_font_t *font_style_ptr,
     uint32_t color,
-    wlmtk_window_t *window_ptr,
+    const char *name_ptr,
     bool active,
     int pos_y);
 static const char *_wlmaker_task_list_window_name(
@@ -211,6 +244,11 @@ void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
     wlmtk_util_disconnect_listener(&task_list_ptr->task_list_disabled_listener);
     wlmtk_util_disconnect_listener(&task_list_ptr->task_list_enabled_listener);
 
+    if (NULL != task_list_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(task_list_ptr->job_ptr);
+        task_list_ptr->job_ptr = NULL;
+    }
+
     if (wlmtk_buffer_element(&task_list_ptr->buffer)->parent_container_ptr) {
         wlmtk_container_remove_element(
             &task_list_ptr->super_panel.super_container,
@@ -228,6 +266,9 @@ void wlmaker_task_list_destroy(wlmaker_task_list_t *task_list_ptr)
 /**
  * Refreshes the task list. Should be done whenever a list is mapped/unmapped.
  *
+ * The window names are captured here, and the list is then drawn on the
+ * rasterization pool. The previous content is shown until then.
+ *
  * @param task_list_ptr
  * @param style_ptr
  *
@@ -237,70 +278,53 @@ bool _wlmaker_task_list_refresh(
     wlmaker_task_list_t *task_list_ptr,
     const struct wlmaker_task_list_style *style_ptr)
 {
+    if (NULL != task_list_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(task_list_ptr->job_ptr);
+        task_list_ptr->job_ptr = NULL;
+    }
+
     wlmtk_workspace_t *workspace_ptr =
         wlmtk_desktop_get_current_workspace(task_list_ptr->server_ptr->desktop_ptr);
 
-    struct wlr_buffer *wlr_buffer_ptr = create_wlr_buffer(
-        workspace_ptr, style_ptr);
-    if (NULL == wlr_buffer_ptr) return false;
-
-    wlmtk_buffer_set(&task_list_ptr->buffer, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
+    wlmaker_task_list_draw_args_t args = { .style = *style_ptr };
+    if (!_wlmaker_task_list_capture(&args, workspace_ptr) ||
+        !wlmtk_raster_submit(
+            _wlmaker_task_list_positioning.desired_width,
+            _wlmaker_task_list_positioning.desired_height,
+            _wlmaker_task_list_draw,
+            &args, sizeof(args),
+            _wlmaker_task_list_args_fini,
+            _wlmaker_task_list_handle_drawn,
+            task_list_ptr,
+            &task_list_ptr->job_ptr)) {
+        // Not handed to the job: The names are still ours to free.
+        _wlmaker_task_list_args_fini(&args);
+        return false;
+    }
     return true;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a `struct wlr_buffer` with windows of `workspace_ptr` drawn into.
+ * Captures the windows of `workspace_ptr` to list into `args`: The active
+ * window centered, and up to 3 windows before and after it.
  *
+ * @param args
  * @param workspace_ptr
- * @param style_ptr
  *
- * @return A pointer to the `struct wlr_buffer` with the list of windows
- *     (tasks), or NULL on error.
- */
-struct wlr_buffer *create_wlr_buffer(
-    wlmtk_workspace_t *workspace_ptr,
-    const struct wlmaker_task_list_style *style_ptr)
-{
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        _wlmaker_task_list_positioning.desired_width,
-        _wlmaker_task_list_positioning.desired_height);
-    if (NULL == wlr_buffer_ptr) return NULL;
-
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
-    }
-    _wlmaker_task_list_draw_into_cairo(cairo_ptr, style_ptr, workspace_ptr);
-    cairo_destroy(cairo_ptr);
-
-    return wlr_buffer_ptr;
-}
-
-/* ------------------------------------------------------------------------- */
-/**
- * Draws all tasks of `workspace_ptr` into `cairo_ptr`.
- *
- * @param cairo_ptr
- * @param style_ptr
- * @param workspace_ptr
+ * @return true on success.
  */
-void _wlmaker_task_list_draw_into_cairo(
-    cairo_t *cairo_ptr,
-    const struct wlmaker_task_list_style *style_ptr,
+bool _wlmaker_task_list_capture(
+    wlmaker_task_list_draw_args_t *args,
     wlmtk_workspace_t *workspace_ptr)
 {
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
-
     // Not tied to a workspace? We're done, all set.
-    if (NULL == workspace_ptr) return;
+    if (NULL == workspace_ptr) return true;
 
     const bs_dllist_t *windows_ptr = wlmtk_workspace_get_windows_dllist(
         workspace_ptr);
     // No windows at all? Done here.
-    if (bs_dllist_empty(windows_ptr)) return;
+    if (bs_dllist_empty(windows_ptr)) return true;
 
     // Find node of the active window, for centering the task list.
     bs_dllist_node_t *centered_dlnode_ptr = windows_ptr->head_ptr;
@@ -313,39 +337,124 @@ void _wlmaker_task_list_draw_into_cairo(
     if (NULL != active_dlnode_ptr) centered_dlnode_ptr = active_dlnode_ptr;
 
     int pos_y = _wlmaker_task_list_positioning.desired_height / 2 + 10;
-    _wlmaker_task_list_draw_window_into_cairo(
-        cairo_ptr,
-        &style_ptr->font,
-        style_ptr->text_color,
-        wlmtk_window_from_dlnode(centered_dlnode_ptr),
-        centered_dlnode_ptr == active_dlnode_ptr,
-        pos_y);
+    if (!_wlmaker_task_list_capture_window(
+            args,
+            wlmtk_window_from_dlnode(centered_dlnode_ptr),
+            centered_dlnode_ptr == active_dlnode_ptr,
+            pos_y)) return false;
 
     bs_dllist_node_t *dlnode_ptr = centered_dlnode_ptr->prev_ptr;
     for (int further_windows = 1;
          NULL != dlnode_ptr && further_windows <= 3;
          dlnode_ptr = dlnode_ptr->prev_ptr, ++further_windows) {
-        _wlmaker_task_list_draw_window_into_cairo(
-            cairo_ptr,
-            &style_ptr->font,
-            style_ptr->text_color,
-            wlmtk_window_from_dlnode(dlnode_ptr),
-            false,
-            pos_y - further_windows * 26);
+        if (!_wlmaker_task_list_capture_window(
+                args,
+                wlmtk_window_from_dlnode(dlnode_ptr),
+                false,
+                pos_y - further_windows * 26)) return false;
     }
 
     dlnode_ptr = centered_dlnode_ptr->next_ptr;
     for (int further_windows = 1;
          NULL != dlnode_ptr && further_windows <= 3;
          dlnode_ptr = dlnode_ptr->next_ptr, ++further_windows) {
+        if (!_wlmaker_task_list_capture_window(
+                args,
+                wlmtk_window_from_dlnode(dlnode_ptr),
+                false,
+                pos_y + further_windows * 26)) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Appends an entry for `window_ptr` to `args`, with a copy of its name.
+ *
+ * @param args
+ * @param window_ptr
+ * @param active              Whether this window is currently active.
+ * @param pos_y               Y position within the buffer.
+ *
+ * @return true on success.
+ */
+bool _wlmaker_task_list_capture_window(
+    wlmaker_task_list_draw_args_t *args,
+    wlmtk_window_t *window_ptr,
+    bool active,
+    int pos_y)
+{
+    BS_ASSERT(args->num_entries < _WLMAKER_TASK_LIST_MAX_ENTRIES);
+    wlmaker_task_list_entry_t *entry_ptr = &args->entries[args->num_entries];
+    entry_ptr->name_ptr = logged_strdup(
+        _wlmaker_task_list_window_name(window_ptr));
+    if (NULL == entry_ptr->name_ptr) return false;
+    entry_ptr->active = active;
+    entry_ptr->pos_y = pos_y;
+    ++args->num_entries;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the list drawn by @ref _wlmaker_task_list_refresh, and sets it as
+ * the buffer's content.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref wlmaker_task_list_t.
+ */
+void _wlmaker_task_list_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmaker_task_list_t *task_list_ptr = ud_ptr;
+    task_list_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw task list %p", task_list_ptr);
+        return;
+    }
+
+    wlmtk_buffer_set(&task_list_ptr->buffer, wlr_buffer_ptr);
+    wlr_buffer_drop(wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the captured tasks. Runs on a
+ * worker thread, and must only access the arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmaker_task_list_draw_args_t.
+ *
+ * @return true.
+ */
+bool _wlmaker_task_list_draw(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmaker_task_list_draw_args_t *args = args_ptr;
+
+    wlmaker_primitives_cairo_fill(cairo_ptr, &args->style.fill);
+    for (size_t i = 0; i < args->num_entries; ++i) {
         _wlmaker_task_list_draw_window_into_cairo(
             cairo_ptr,
-            &style_ptr->font,
-            style_ptr->text_color,
-            wlmtk_window_from_dlnode(dlnode_ptr),
-            false,
-            pos_y + further_windows * 26);
+            &args->style.font,
+            args->style.text_color,
+            args->entries[i].name_ptr,
+            args->entries[i].active,
+            args->entries[i].pos_y);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_raster_args_fini_t: Frees the copied names. */
+void _wlmaker_task_list_args_fini(void *args_ptr)
+{
+    wlmaker_task_list_draw_args_t *args = args_ptr;
+    for (size_t i = 0; i < args->num_entries; ++i) {
+        free(args->entries[i].name_ptr);
+        args->entries[i].name_ptr = NULL;
     }
+    args->num_entries = 0;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -355,7 +464,7 @@ void _wlmaker_task_list_draw_into_cairo(
  * @param cairo_ptr
  * @param font_style_ptr
  * @param color
- * @param window_ptr
+ * @param name_ptr
  * @param active              Whether this window is currently active.
  * @param pos_y               Y position within the `cairo_ptr`.
  */
@@ -363,7 +472,7 @@ void _wlmaker_task_list_draw_window_into_cairo(
     cairo_t *cairo_ptr,
     const wlmtk_style_font_t *font_style_ptr,
     uint32_t color,
-    wlmtk_window_t *window_ptr,
+    const char *name_ptr,
     bool active,
     int pos_y)
 {
@@ -375,7 +484,7 @@ void _wlmaker_task_list_draw_window_into_cairo(
         CAIRO_FONT_SLANT_NORMAL,
         active ? CAIRO_FONT_WEIGHT_BOLD : CAIRO_FONT_WEIGHT_NORMAL);
     cairo_move_to(cairo_ptr, 10, pos_y);
-    cairo_show_text(cairo_ptr, _wlmaker_task_list_window_name(window_ptr));
+    cairo_show_text(cairo_ptr, name_ptr);
  }
 
 /* ------------------------------------------------------------------------- */
@@ -552,4 +661,89 @@ void _wlmaker_task_list_handle_window_unmapped(
     }
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_deferred(bs_test_t *test_ptr);
+
+/** Unit test cases. */
+static const bs_test_case_t wlmaker_task_list_test_cases[] = {
+    { true, "deferred", test_deferred },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmaker_task_list_test_set = BS_TEST_SET(
+    true, "task_list", wlmaker_task_list_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/** Tests drawing the list on the rasterization pool. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wlmaker_task_list_style style = {
+        .fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff203040 } }
+        },
+        .font = { .face = "Helvetica", .size = 15 },
+        .text_color = 0xffc0c0c0
+    };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    struct wlr_scene *wlr_scene_ptr = wlr_scene_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_ptr);
+    wlmaker_server_t server = { .wl_display_ptr = wl_display_create() };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wl_display_ptr);
+    wl_signal_init(&server.task_list_enabled_event);
+    wl_signal_init(&server.task_list_disabled_event);
+    wl_signal_init(&server.theme_changed_event);
+    server.wlr_output_layout_ptr = wlr_output_layout_create(
+        server.wl_display_ptr);
+    server.desktop_ptr = wlmtk_desktop_create(
+        wlr_scene_ptr, server.wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.desktop_ptr);
+
+    wlmaker_task_list_t *task_list_ptr = wlmaker_task_list_create(
+        &server, &style);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, task_list_ptr);
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &task_list_ptr->buffer.wlr_buffer_ptr;
+
+    // No buffer until the job is handed back.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_task_list_refresh(task_list_ptr, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, task_list_ptr->job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+
+    // The style changes while the job is pending: The new style is shown.
+    style.fill.param.solid.color = 0xff405060;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_task_list_refresh(task_list_ptr, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(wl_event_loop_ptr, wlr_buffer_ptr_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, task_list_ptr->job_ptr);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(*wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff405060, g->data_ptr[4 * g->pixels_per_line + 4]);
+
+    // Destroying the list cancels the pending job. Destroying the pool then
+    // hands back all jobs: The cancelled one must not be applied.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_task_list_refresh(task_list_ptr, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, task_list_ptr->job_ptr);
+    wlmaker_task_list_destroy(task_list_ptr);
+    wlmtk_raster_pool_destroy(pool_ptr);
+
+    wlmtk_desktop_destroy(server.desktop_ptr);
+    wl_display_destroy(server.wl_display_ptr);
+    wlr_scene_node_destroy(&wlr_scene_ptr->tree.node);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of task_list.c =================================================== */
@@ -98,6 +98,9 @@ void wlmaker_task_list_destroy(
 /** Descriptor for decoding the "TaskList" dictionary. */
 extern const bspl_desc_t wlmaker_task_list_style_desc[];
 
+/** Unit test set. */
+extern const bs_test_set_t wlmaker_task_list_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -25,9 +25,14 @@
 #include <stddef.h>
 #include <stdlib.h>
 #include <wayland-server-core.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
+#undef WLR_USE_UNSTABLE
 
 #include "action.h"
 #include "action_item.h"
+#include "config.h"
 #include "server.h"
 
 /* == Declarations ========================================================= */
@@ -41,6 +46,8 @@ struct _wlmaker_tl_menu_t {
 
     /** Holds @ref wlmaker_tl_menu_ws_item_t::dlnode items. */
     bs_dllist_t               submenu_items;
+    /** The item of the window's current workspace. It is disabled. */
+    struct _wlmaker_tl_menu_ws_item_t *disabled_ws_item_ptr;
 
     /** Back-link to server. */
     wlmaker_server_t          *server_ptr;
@@ -69,9 +76,11 @@ struct _wlmaker_tl_menu_t {
 };
 
 /** Item holder. */
-typedef struct {
+typedef struct _wlmaker_tl_menu_ws_item_t {
     /** Element of @ref wlmaker_tl_menu_t::submenu_items. */
     bs_dllist_node_t          dlnode;
+    /** Back-link to the menu holding the item. NULL once detached. */
+    wlmaker_tl_menu_t         *tl_menu_ptr;
 
     /** Composed from a menu item. */
     wlmtk_menu_item_t         *menu_item_ptr;
@@ -88,12 +97,13 @@ typedef struct {
 
 } wlmaker_tl_menu_ws_item_t;
 
-static void _wlmaker_tl_menu_workspace_iterator_create_item(
-    bs_dllist_node_t *dlnode_ptr,
-    void *ud_ptr);
-static void _wlmaker_tl_menu_ws_items_iterator_enable_workspace(
+static void _wlmaker_tl_menu_workspace_iterator_ensure_item(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static wlmaker_tl_menu_ws_item_t *_wlmaker_tl_menu_find_item(
+    wlmaker_tl_menu_t *tl_menu_ptr,
+    wlmtk_workspace_t *workspace_ptr);
+static void _wlmaker_tl_menu_update_enabled(wlmaker_tl_menu_t *tl_menu_ptr);
 static void _wlmaker_tl_menu_handle_window_state_changed(
     struct wl_listener *listener_ptr,
     void *data_ptr);
@@ -233,6 +243,16 @@ void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr)
     wlmtk_util_disconnect_listener(
         &tl_menu_ptr->window_state_changed_listener);
 
+    // The items remain owned by the window's menu. Just detach them.
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &tl_menu_ptr->submenu_items))) {
+        wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_tl_menu_ws_item_t, dlnode);
+        ws_item_ptr->tl_menu_ptr = NULL;
+    }
+    tl_menu_ptr->disabled_ws_item_ptr = NULL;
+
     free(tl_menu_ptr);
 }
 
@@ -266,45 +286,63 @@ void _wlmaker_tl_menu_handle_window_state_changed(
         wlmaker_action_item_menu_item(tl_menu_ptr->unmaximize_ai_ptr),
         wlmtk_window_is_maximized(window_ptr));
 
-    // Refresh the list of workspaces.
-    bs_dllist_for_each(
-        &tl_menu_ptr->submenu_items,
-        _wlmaker_tl_menu_ws_items_iterator_enable_workspace,
-        NULL);
-
+    _wlmaker_tl_menu_update_enabled(tl_menu_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Handles workspace changes: Refreshes the workspace menu. */
+/**
+ * Handles workspace changes: Updates the workspace menu.
+ *
+ * Switching workspaces leaves the items untouched. Only items of removed
+ * workspaces are destroyed, and items are created only for added workspaces.
+ */
 void _wlmaker_tl_menu_handle_workspace_changed(
     struct wl_listener *listener_ptr,
     __UNUSED__ void *data_ptr)
 {
     wlmaker_tl_menu_t *tl_menu_ptr = BS_CONTAINER_OF(
         listener_ptr, wlmaker_tl_menu_t, workspace_changed_listener);
+    wlmtk_desktop_t *desktop_ptr = tl_menu_ptr->server_ptr->desktop_ptr;
+
+    // Removed workspaces are detached from the desktop before the signal.
+    bs_dllist_node_t *dlnode_ptr = tl_menu_ptr->submenu_items.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_tl_menu_ws_item_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        if (desktop_ptr == wlmtk_workspace_get_desktop(
+                ws_item_ptr->workspace_ptr)) continue;
 
-    // Flush, then rebuild the workspaces submenu.
-    while (0 < wlmtk_menu_items_size(tl_menu_ptr->workspaces_submenu_ptr)) {
         wlmtk_menu_remove_item(
             tl_menu_ptr->workspaces_submenu_ptr,
-            wlmtk_menu_item_at(tl_menu_ptr->workspaces_submenu_ptr, 0));
+            ws_item_ptr->menu_item_ptr);
+        _destroy(ws_item_ptr);
     }
+
+    // Workspaces are added at the end, so appending keeps the order.
     wlmtk_desktop_for_each_workspace(
-        tl_menu_ptr->server_ptr->desktop_ptr,
-        _wlmaker_tl_menu_workspace_iterator_create_item,
+        desktop_ptr,
+        _wlmaker_tl_menu_workspace_iterator_ensure_item,
         tl_menu_ptr);
 
-    // Disable the currently-active workspace.
-    bs_dllist_for_each(
-        &tl_menu_ptr->submenu_items,
-        _wlmaker_tl_menu_ws_items_iterator_enable_workspace,
-        NULL);
+    _wlmaker_tl_menu_update_enabled(tl_menu_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Destroys the item holder. */
+/** Destroys the item holder, and detaches it from the menu. */
 void _destroy(wlmaker_tl_menu_ws_item_t *ws_item_ptr)
 {
+    wlmaker_tl_menu_t *tl_menu_ptr = ws_item_ptr->tl_menu_ptr;
+    if (NULL != tl_menu_ptr) {
+        if (tl_menu_ptr->disabled_ws_item_ptr == ws_item_ptr) {
+            tl_menu_ptr->disabled_ws_item_ptr = NULL;
+        }
+        bs_dllist_remove(&tl_menu_ptr->submenu_items, &ws_item_ptr->dlnode);
+        ws_item_ptr->tl_menu_ptr = NULL;
+    }
+
+    wlmtk_util_disconnect_listener(&ws_item_ptr->destroy_listener);
+    wlmtk_util_disconnect_listener(&ws_item_ptr->triggered_listener);
     if (NULL != ws_item_ptr->menu_item_ptr) {
         wlmtk_menu_item_destroy(ws_item_ptr->menu_item_ptr);
         ws_item_ptr->menu_item_ptr = NULL;
@@ -313,13 +351,14 @@ void _destroy(wlmaker_tl_menu_ws_item_t *ws_item_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Creates a menu item for each workspace. */
-void _wlmaker_tl_menu_workspace_iterator_create_item(
+/** Creates a menu item for the workspace, unless there is one already. */
+void _wlmaker_tl_menu_workspace_iterator_ensure_item(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr)
 {
     wlmtk_workspace_t *workspace_ptr = wlmtk_workspace_from_dlnode(dlnode_ptr);
     wlmaker_tl_menu_t *tl_menu_ptr = ud_ptr;
+    if (NULL != _wlmaker_tl_menu_find_item(tl_menu_ptr, workspace_ptr)) return;
 
     const char *name_ptr;
     int index;
@@ -330,6 +369,8 @@ void _wlmaker_tl_menu_workspace_iterator_create_item(
     if (NULL == ws_item_ptr) return;
     ws_item_ptr->workspace_ptr = workspace_ptr;
     ws_item_ptr->window_ptr = tl_menu_ptr->window_ptr;
+    ws_item_ptr->tl_menu_ptr = tl_menu_ptr;
+    bs_dllist_push_back(&tl_menu_ptr->submenu_items, &ws_item_ptr->dlnode);
 
     ws_item_ptr->menu_item_ptr = wlmtk_menu_item_create(
         wlmtk_menu_style_to_ref(
@@ -339,6 +380,10 @@ void _wlmaker_tl_menu_workspace_iterator_create_item(
         return;
     }
 
+    // Add to the (closed) submenu first: The item is drawn once shown.
+    wlmtk_menu_add_item(
+        tl_menu_ptr->workspaces_submenu_ptr,
+        ws_item_ptr->menu_item_ptr);
     wlmtk_menu_item_set_text(ws_item_ptr->menu_item_ptr, name_ptr);
 
     wlmtk_util_connect_listener_signal(
@@ -349,26 +394,47 @@ void _wlmaker_tl_menu_workspace_iterator_create_item(
         &wlmtk_menu_item_events(ws_item_ptr->menu_item_ptr)->destroy,
         &ws_item_ptr->destroy_listener,
         _item_handle_destroy);
+}
 
-    wlmtk_menu_add_item(
-        tl_menu_ptr->workspaces_submenu_ptr,
-        ws_item_ptr->menu_item_ptr);
-    bs_dllist_push_back(&tl_menu_ptr->submenu_items, &ws_item_ptr->dlnode);
+/* ------------------------------------------------------------------------- */
+/** @return The item for `workspace_ptr`, or NULL if there is none. */
+wlmaker_tl_menu_ws_item_t *_wlmaker_tl_menu_find_item(
+    wlmaker_tl_menu_t *tl_menu_ptr,
+    wlmtk_workspace_t *workspace_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = tl_menu_ptr->submenu_items.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_tl_menu_ws_item_t, dlnode);
+        if (ws_item_ptr->workspace_ptr == workspace_ptr) return ws_item_ptr;
+    }
+    return NULL;
 }
 
 /* ------------------------------------------------------------------------- */
-/** Enables workspace items, except the one the window is currently on. */
-void _wlmaker_tl_menu_ws_items_iterator_enable_workspace(
-    bs_dllist_node_t *dlnode_ptr,
-    __UNUSED__ void *ud_ptr)
+/**
+ * Disables the item of the workspace the window is currently on, and enables
+ * the previously-disabled item. Leaves all other items untouched.
+ */
+void _wlmaker_tl_menu_update_enabled(wlmaker_tl_menu_t *tl_menu_ptr)
 {
-    wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
-        dlnode_ptr, wlmaker_tl_menu_ws_item_t, dlnode);
+    wlmtk_workspace_t *workspace_ptr = wlmtk_window_get_workspace(
+        tl_menu_ptr->window_ptr);
+    wlmaker_tl_menu_ws_item_t *ws_item_ptr =
+        tl_menu_ptr->disabled_ws_item_ptr;
+    if (NULL != ws_item_ptr && ws_item_ptr->workspace_ptr == workspace_ptr) {
+        return;
+    }
 
-    wlmtk_menu_item_set_enabled(
-        ws_item_ptr->menu_item_ptr,
-        (wlmtk_window_get_workspace(ws_item_ptr->window_ptr) !=
-         ws_item_ptr->workspace_ptr));
+    if (NULL != ws_item_ptr) {
+        wlmtk_menu_item_set_enabled(ws_item_ptr->menu_item_ptr, true);
+    }
+    ws_item_ptr = _wlmaker_tl_menu_find_item(tl_menu_ptr, workspace_ptr);
+    if (NULL != ws_item_ptr) {
+        wlmtk_menu_item_set_enabled(ws_item_ptr->menu_item_ptr, false);
+    }
+    tl_menu_ptr->disabled_ws_item_ptr = ws_item_ptr;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -401,4 +467,164 @@ void _item_handle_destroy(
     _destroy(ws_item_ptr);
 }
 
+/* == Unit tests =========================================================== */
+
+static void test_incremental(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlmaker_tl_menu_test_cases[] = {
+    { 1, "incremental", test_incremental },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmaker_tl_menu_test_set = BS_TEST_SET(
+    true, "tl_menu", _wlmaker_tl_menu_test_cases);
+
+/** Number of windows for the test. */
+#define _TEST_WINDOWS 32
+/** Initial number of workspaces for the test. */
+#define _TEST_WORKSPACES 8
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether only the item of the window's workspace is disabled. */
+static bool _wlmaker_tl_menu_test_enabled(wlmaker_tl_menu_t *tl_menu_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = tl_menu_ptr->submenu_items.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmaker_tl_menu_ws_item_t *ws_item_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmaker_tl_menu_ws_item_t, dlnode);
+        bool disabled = (
+            WLMTK_MENU_ITEM_DISABLED ==
+            wlmtk_menu_item_get_state(ws_item_ptr->menu_item_ptr));
+        if (disabled != (wlmtk_window_get_workspace(tl_menu_ptr->window_ptr) ==
+                         ws_item_ptr->workspace_ptr)) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies the workspace submenus are updated without redrawing all items. */
+void test_incremental(bs_test_t *test_ptr)
+{
+    struct wl_display *wl_display_ptr = wl_display_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    wlmaker_config_style_t style = {
+        .menu_style_ptr = wlmtk_menu_style_create()
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, style.menu_style_ptr);
+    wlmaker_server_t server = {
+        .wl_display_ptr = wl_display_ptr,
+        .wlr_scene_ptr = wlr_scene_create(),
+        .style_ptr = &style
+    };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wlr_scene_ptr);
+    server.wlr_output_layout_ptr = wlr_output_layout_create(wl_display_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.wlr_output_layout_ptr);
+    server.desktop_ptr = wlmtk_desktop_create(
+        server.wlr_scene_ptr, server.wlr_output_layout_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, server.desktop_ptr);
+
+    static const struct wlmtk_tile_style ts = { .size = 64 };
+    wlmtk_workspace_t *ws_ptrs[_TEST_WORKSPACES];
+    for (int i = 0; i < _TEST_WORKSPACES; ++i) {
+        ws_ptrs[i] = wlmtk_workspace_create(
+            server.wlr_output_layout_ptr, "ws", &ts);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptrs[i]);
+        wlmtk_desktop_add_workspace(server.desktop_ptr, ws_ptrs[i]);
+    }
+
+    // A synchronous pool, to count the drawn menu items.
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(NULL, 0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    wlmtk_window_t *window_ptrs[_TEST_WINDOWS];
+    wlmaker_tl_menu_t *tl_menu_ptrs[_TEST_WINDOWS];
+    for (int i = 0; i < _TEST_WINDOWS; ++i) {
+        window_ptrs[i] = wlmtk_test_window_create(NULL);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, window_ptrs[i]);
+        wlmtk_workspace_map_window(
+            ws_ptrs[i % _TEST_WORKSPACES], window_ptrs[i]);
+        tl_menu_ptrs[i] = wlmaker_tl_menu_create(window_ptrs[i], &server);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tl_menu_ptrs[i]);
+    }
+    for (int i = 0; i < _TEST_WINDOWS; ++i) {
+        BS_TEST_VERIFY_EQ(
+            test_ptr, _TEST_WORKSPACES,
+            wlmtk_menu_items_size(tl_menu_ptrs[i]->workspaces_submenu_ptr));
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, _wlmaker_tl_menu_test_enabled(tl_menu_ptrs[i]));
+    }
+
+    // Switching workspaces: No item is re-created, nor redrawn.
+    size_t jobs = wlmtk_raster_pool_submitted_jobs(pool_ptr);
+    wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_at(
+        tl_menu_ptrs[0]->workspaces_submenu_ptr, 1);
+    for (int i = 0; i < _TEST_WORKSPACES; ++i) {
+        wlmtk_desktop_switch_to_next_workspace(server.desktop_ptr);
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, jobs, wlmtk_raster_pool_submitted_jobs(pool_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, item_ptr,
+        wlmtk_menu_item_at(tl_menu_ptrs[0]->workspaces_submenu_ptr, 1));
+
+    // Adding a workspace adds one item per window. Not drawn while closed.
+    wlmtk_workspace_t *ws_ptr = wlmtk_workspace_create(
+        server.wlr_output_layout_ptr, "added", &ts);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
+    wlmtk_desktop_add_workspace(server.desktop_ptr, ws_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, jobs, wlmtk_raster_pool_submitted_jobs(pool_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, _TEST_WORKSPACES + 1,
+        wlmtk_menu_items_size(tl_menu_ptrs[0]->workspaces_submenu_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, item_ptr,
+        wlmtk_menu_item_at(tl_menu_ptrs[0]->workspaces_submenu_ptr, 1));
+
+    // Opening the submenu draws its items, on demand.
+    wlmtk_menu_set_open(tl_menu_ptrs[0]->workspaces_submenu_ptr, true);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, jobs + _TEST_WORKSPACES + 1,
+        wlmtk_raster_pool_submitted_jobs(pool_ptr));
+    wlmtk_menu_set_open(tl_menu_ptrs[0]->workspaces_submenu_ptr, false);
+
+    // Moving a window flips just the items of the two workspaces.
+    wlmtk_workspace_unmap_window(ws_ptrs[0], window_ptrs[0]);
+    wlmtk_workspace_map_window(ws_ptr, window_ptrs[0]);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, _wlmaker_tl_menu_test_enabled(tl_menu_ptrs[0]));
+    wlmtk_workspace_unmap_window(ws_ptr, window_ptrs[0]);
+    wlmtk_workspace_map_window(ws_ptrs[0], window_ptrs[0]);
+
+    // Removing the workspace removes just its items.
+    jobs = wlmtk_raster_pool_submitted_jobs(pool_ptr);
+    wlmtk_desktop_destroy_last_workspace(server.desktop_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, jobs, wlmtk_raster_pool_submitted_jobs(pool_ptr));
+    for (int i = 0; i < _TEST_WINDOWS; ++i) {
+        BS_TEST_VERIFY_EQ(
+            test_ptr, _TEST_WORKSPACES,
+            wlmtk_menu_items_size(tl_menu_ptrs[i]->workspaces_submenu_ptr));
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, _wlmaker_tl_menu_test_enabled(tl_menu_ptrs[i]));
+    }
+
+    for (int i = 0; i < _TEST_WINDOWS; ++i) {
+        wlmaker_tl_menu_destroy(tl_menu_ptrs[i]);
+        wlmtk_workspace_unmap_window(
+            wlmtk_window_get_workspace(window_ptrs[i]), window_ptrs[i]);
+        wlmtk_window_destroy(window_ptrs[i]);
+    }
+    wlmtk_raster_set_pool(NULL);
+    wlmtk_raster_pool_destroy(pool_ptr);
+    wlmtk_desktop_destroy(server.desktop_ptr);
+    wlr_output_layout_destroy(server.wlr_output_layout_ptr);
+    wlr_scene_node_destroy(&server.wlr_scene_ptr->tree.node);
+    wl_display_destroy(wl_display_ptr);
+    wlmtk_menu_style_ref_release(wlmtk_menu_style_to_ref(style.menu_style_ptr));
+}
+
 /* == End of tl_menu.c ===================================================== */
@@ -51,6 +51,9 @@ wlmaker_tl_menu_t *wlmaker_tl_menu_create(
  */
 void wlmaker_tl_menu_destroy(wlmaker_tl_menu_t *tl_menu_ptr);
 
+/** Unit test cases. */
+extern const bs_test_set_t wlmaker_tl_menu_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
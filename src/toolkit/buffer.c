@@ -52,6 +52,10 @@ static void _wlmtk_buffer_handle_wlr_scene_buffer_node_destroy(
 static void _wlmtk_buffer_handle_element_pointer_enter(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmtk_buffer_get_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr);
 
 /* == Data ================================================================= */
 
@@ -124,6 +128,23 @@ void wlmtk_buffer_set(
     }
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_buffer_set_dimensions(
+    wlmtk_buffer_t *buffer_ptr,
+    int width,
+    int height)
+{
+    buffer_ptr->width = BS_MAX(0, width);
+    buffer_ptr->height = BS_MAX(0, height);
+
+    if (NULL != buffer_ptr->wlr_scene_buffer_ptr) {
+        wlr_scene_buffer_set_dest_size(
+            buffer_ptr->wlr_scene_buffer_ptr,
+            buffer_ptr->width,
+            buffer_ptr->height);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 wlmtk_element_t *wlmtk_buffer_element(wlmtk_buffer_t *buffer_ptr)
 {
@@ -153,6 +174,10 @@ struct wlr_scene_node *_wlmtk_buffer_element_create_scene_node(
         wlr_scene_tree_ptr,
         buffer_ptr->wlr_buffer_ptr);
     BS_ASSERT(NULL != buffer_ptr->wlr_scene_buffer_ptr);
+    wlr_scene_buffer_set_dest_size(
+        buffer_ptr->wlr_scene_buffer_ptr,
+        buffer_ptr->width,
+        buffer_ptr->height);
 
     wlmtk_util_connect_listener_signal(
         &buffer_ptr->wlr_scene_buffer_ptr->node.events.destroy,
@@ -183,15 +208,7 @@ void _wlmtk_buffer_element_get_dimensions(
 
     if (NULL != left_ptr) *left_ptr = 0;
     if (NULL != top_ptr) *top_ptr = 0;
-
-    if (NULL == buffer_ptr->wlr_buffer_ptr) {
-        if (NULL != right_ptr) *right_ptr = 0;
-        if (NULL != bottom_ptr) *bottom_ptr = 0;
-        return;
-    }
-
-    if (NULL != right_ptr) *right_ptr = buffer_ptr->wlr_buffer_ptr->width;
-    if (NULL != bottom_ptr) *bottom_ptr = buffer_ptr->wlr_buffer_ptr->height;
+    _wlmtk_buffer_get_size(buffer_ptr, right_ptr, bottom_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -211,11 +228,13 @@ bool _wlmtk_buffer_element_pointer_accepts_motion(
     wlmtk_buffer_t *buffer_ptr = BS_CONTAINER_OF(
         element_ptr, wlmtk_buffer_t, super_element);
 
+    int width, height;
+    _wlmtk_buffer_get_size(buffer_ptr, &width, &height);
     return (NULL != buffer_ptr->wlr_buffer_ptr &&
             0 <= motion_event_ptr->x &&
-            motion_event_ptr->x < buffer_ptr->wlr_buffer_ptr->width &&
+            motion_event_ptr->x < width &&
             0 <= motion_event_ptr->y &&
-            motion_event_ptr->y < buffer_ptr->wlr_buffer_ptr->height);
+            motion_event_ptr->y < height);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -250,6 +269,32 @@ void _wlmtk_buffer_handle_element_pointer_enter(
     wlmtk_pointer_set_cursor(data_ptr, buffer_ptr->pointer_cursor);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Retrieves the buffer's size in layout coordinates: The dimensions set by
+ * @ref wlmtk_buffer_set_dimensions, or else the wlr_buffer's size.
+ *
+ * @param buffer_ptr
+ * @param width_ptr           May be NULL.
+ * @param height_ptr          May be NULL.
+ */
+void _wlmtk_buffer_get_size(
+    wlmtk_buffer_t *buffer_ptr,
+    int *width_ptr,
+    int *height_ptr)
+{
+    int w = 0, h = 0;
+    if (NULL != buffer_ptr->wlr_buffer_ptr) {
+        w = buffer_ptr->width;
+        if (0 >= w) w = buffer_ptr->wlr_buffer_ptr->width;
+        h = buffer_ptr->height;
+        if (0 >= h) h = buffer_ptr->wlr_buffer_ptr->height;
+    }
+
+    if (NULL != width_ptr) *width_ptr = w;
+    if (NULL != height_ptr) *height_ptr = h;
+}
+
 /* == Unit Tests =========================================================== */
 
 static void test_pointer_motion(bs_test_t *test_ptr);
@@ -285,6 +330,16 @@ void test_pointer_motion(bs_test_t *test_ptr)
     mev = (wlmtk_pointer_motion_event_t){ .x = 10, .y = 20 };
     BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_element_pointer_motion(e, &mev));
 
+    // Explicit dimensions apply to both the element and the motion.
+    wlmtk_buffer_set_dimensions(&buffer, 5, 10);
+    struct wlr_box box = wlmtk_element_get_dimensions_box(e);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, box.width);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, box.height);
+    mev = (wlmtk_pointer_motion_event_t){ .x = 5, .y = 5 };
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_element_pointer_motion(e, &mev));
+    wlmtk_buffer_set_dimensions(&buffer, 0, 0);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_element_pointer_motion(e, &mev));
+
     wlr_buffer_drop(wlr_buffer_ptr);
     wlmtk_buffer_fini(&buffer);
 }
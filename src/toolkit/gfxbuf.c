@@ -70,6 +70,18 @@ static const struct wlr_buffer_impl wlmaker_gfxbuf_impl = {
 struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     unsigned width,
     unsigned height)
+{
+    bs_gfxbuf_t *bs_gfxbuf_ptr = bs_gfxbuf_create(width, height);
+    if (NULL == bs_gfxbuf_ptr) return NULL;
+
+    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_wrap_wlr_buffer(
+        bs_gfxbuf_ptr);
+    if (NULL == wlr_buffer_ptr) bs_gfxbuf_destroy(bs_gfxbuf_ptr);
+    return wlr_buffer_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+struct wlr_buffer *bs_gfxbuf_wrap_wlr_buffer(bs_gfxbuf_t *bs_gfxbuf_ptr)
 {
     wlmaker_gfxbuf_t *gfxbuf_ptr = logged_calloc(1, sizeof(wlmaker_gfxbuf_t));
     if (NULL == gfxbuf_ptr) return NULL;
@@ -77,15 +89,9 @@ struct wlr_buffer *bs_gfxbuf_create_wlr_buffer(
     wlr_buffer_init(
         &gfxbuf_ptr->wlr_buffer,
         &wlmaker_gfxbuf_impl,
-        width,
-        height);
-
-    gfxbuf_ptr->gfxbuf_ptr = bs_gfxbuf_create(width, height);
-    if (NULL == gfxbuf_ptr->gfxbuf_ptr) {
-        wlmaker_gfxbuf_impl_destroy(&gfxbuf_ptr->wlr_buffer);
-        return NULL;
-    }
-
+        bs_gfxbuf_ptr->width,
+        bs_gfxbuf_ptr->height);
+    gfxbuf_ptr->gfxbuf_ptr = bs_gfxbuf_ptr;
     return &gfxbuf_ptr->wlr_buffer;
 }
 
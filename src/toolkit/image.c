@@ -23,8 +23,10 @@
 
 #include <cairo.h>
 #include <libbase/libbase.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "buffer.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
@@ -39,10 +41,21 @@ struct _wlmtk_image_t {
     wlmtk_element_vmt_t       orig_element_vmt;
 };
 
+/** A PNG image, decoded ahead by @ref wlmtk_image_prefetch. */
+typedef struct {
+    /** Node within @ref _wlmtk_image_prefetched. */
+    bs_dllist_node_t          dlnode;
+    /** Path of the image. */
+    char                      *path_ptr;
+    /** The decoded image. */
+    cairo_surface_t           *surface_ptr;
+} wlmtk_image_prefetched_t;
+
 struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
     const char *path_ptr,
     int width,
     int height);
+static cairo_surface_t *_wlmtk_image_prefetched_take(const char *path_ptr);
 
 static void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr);
 
@@ -53,6 +66,11 @@ static const wlmtk_element_vmt_t _wlmtk_image_element_vmt = {
     .destroy = _wlmtk_image_element_destroy,
 };
 
+/** Guards @ref _wlmtk_image_prefetched. */
+static pthread_mutex_t _wlmtk_image_prefetch_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** Images decoded by @ref wlmtk_image_prefetch, not yet used. */
+static bs_dllist_t _wlmtk_image_prefetched = {};
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -104,6 +122,49 @@ wlmtk_element_t *wlmtk_image_element(wlmtk_image_t *image_ptr)
     return wlmtk_buffer_element(&image_ptr->super_buffer);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_image_prefetch(const char *path_ptr)
+{
+    wlmtk_image_prefetched_t *p_ptr = logged_calloc(
+        1, sizeof(wlmtk_image_prefetched_t));
+    if (NULL == p_ptr) return false;
+    p_ptr->path_ptr = logged_strdup(path_ptr);
+    if (NULL == p_ptr->path_ptr) {
+        free(p_ptr);
+        return false;
+    }
+
+    p_ptr->surface_ptr = cairo_image_surface_create_from_png(path_ptr);
+    if (CAIRO_STATUS_SUCCESS != cairo_surface_status(p_ptr->surface_ptr)) {
+        // Not logged: Creating the image will report the error.
+        cairo_surface_destroy(p_ptr->surface_ptr);
+        free(p_ptr->path_ptr);
+        free(p_ptr);
+        return false;
+    }
+
+    pthread_mutex_lock(&_wlmtk_image_prefetch_mutex);
+    bs_dllist_push_back(&_wlmtk_image_prefetched, &p_ptr->dlnode);
+    pthread_mutex_unlock(&_wlmtk_image_prefetch_mutex);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_image_prefetch_flush(void)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    pthread_mutex_lock(&_wlmtk_image_prefetch_mutex);
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &_wlmtk_image_prefetched))) {
+        wlmtk_image_prefetched_t *p_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_prefetched_t, dlnode);
+        cairo_surface_destroy(p_ptr->surface_ptr);
+        free(p_ptr->path_ptr);
+        free(p_ptr);
+    }
+    pthread_mutex_unlock(&_wlmtk_image_prefetch_mutex);
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -124,8 +185,10 @@ struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
     int width,
     int height)
 {
-    cairo_surface_t *icon_surface_ptr = cairo_image_surface_create_from_png(
-        path_ptr);
+    cairo_surface_t *icon_surface_ptr = _wlmtk_image_prefetched_take(path_ptr);
+    if (NULL == icon_surface_ptr) {
+        icon_surface_ptr = cairo_image_surface_create_from_png(path_ptr);
+    }
     if (NULL == icon_surface_ptr) {
         bs_log(BS_ERROR, "Failed cairo_image_surface_create_from_png(%s).",
                path_ptr);
@@ -176,6 +239,36 @@ struct wlr_buffer *_wlmtk_image_create_wlr_buffer_from_image(
     return wlr_buffer_ptr;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Takes the image prefetched for `path_ptr`, if any.
+ *
+ * @param path_ptr
+ *
+ * @return The decoded image, or NULL. Must be destroyed by
+ *     cairo_surface_destroy().
+ */
+cairo_surface_t *_wlmtk_image_prefetched_take(const char *path_ptr)
+{
+    cairo_surface_t *surface_ptr = NULL;
+    pthread_mutex_lock(&_wlmtk_image_prefetch_mutex);
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_image_prefetched.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_image_prefetched_t *p_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_image_prefetched_t, dlnode);
+        if (0 != strcmp(p_ptr->path_ptr, path_ptr)) continue;
+
+        bs_dllist_remove(&_wlmtk_image_prefetched, dlnode_ptr);
+        surface_ptr = p_ptr->surface_ptr;
+        free(p_ptr->path_ptr);
+        free(p_ptr);
+        break;
+    }
+    pthread_mutex_unlock(&_wlmtk_image_prefetch_mutex);
+    return surface_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Implements @ref wlmtk_element_vmt_t::destroy -- virtual dtor. */
 void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr)
@@ -187,10 +280,12 @@ void _wlmtk_image_element_destroy(wlmtk_element_t *element_ptr)
 
 /* == Unit tests =========================================================== */
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_prefetch(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_image_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "prefetch", test_prefetch },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -218,4 +313,27 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_image_destroy(image_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Prefetches an image, and verifies it is used once, and then released. */
+void test_prefetch(bs_test_t *test_ptr)
+{
+    const char *p = bs_test_data_path(test_ptr, "toolkit/test_icon.png");
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_image_prefetch(p));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_image_prefetch("/does/not/exist"));
+    BS_TEST_VERIFY_FALSE(test_ptr, bs_dllist_empty(&_wlmtk_image_prefetched));
+
+    wlmtk_image_t *image_ptr = wlmtk_image_create(p);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, image_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&_wlmtk_image_prefetched));
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(image_ptr->super_buffer.wlr_buffer_ptr),
+        "toolkit/test_icon.png");
+    wlmtk_image_destroy(image_ptr);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_image_prefetch(p));
+    wlmtk_image_prefetch_flush();
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dllist_empty(&_wlmtk_image_prefetched));
+}
+
 /* == End of image.c ======================================================= */
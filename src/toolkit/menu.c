@@ -31,6 +31,7 @@
 
 #include "base.h"
 #include "input.h"
+#include "menu_item_internal.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
@@ -83,6 +84,9 @@ static bool _wlmtk_menu_set_item_style(
 static void _wlmtk_menu_set_item_mode(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static void _wlmtk_menu_update_item_buffers(
+    bs_dllist_node_t *dlnode_ptr,
+    void *ud_ptr);
 
 static void _wlmtk_menu_box_element_destroy(wlmtk_element_t *element_ptr);
 
@@ -241,6 +245,12 @@ void wlmtk_menu_set_open(wlmtk_menu_t *menu_ptr, bool opened)
         menu_ptr->highlighted_menu_item_ptr = NULL;
     }
 
+    // Items draw their buffers when the menu opens, and release when closed.
+    bs_dllist_for_each(
+        &menu_ptr->items,
+        _wlmtk_menu_update_item_buffers,
+        NULL);
+
     wl_signal_emit(&menu_ptr->events.open_changed, menu_ptr);
 }
 
@@ -346,6 +356,19 @@ wlmtk_menu_item_t *wlmtk_menu_item_at(wlmtk_menu_t *menu_ptr, size_t i)
     return wlmtk_menu_item_from_dlnode(dlnode_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_menu_buffers(wlmtk_menu_t *menu_ptr)
+{
+    size_t buffers = 0;
+    for (bs_dllist_node_t *dlnode_ptr = menu_ptr->items.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        buffers += wlmtk_menu_item_buffers(
+            wlmtk_menu_item_from_dlnode(dlnode_ptr));
+    }
+    return buffers;
+}
+
 /* ------------------------------------------------------------------------- */
 struct wlmtk_menu_style *wlmtk_menu_style_create(void)
 {
@@ -459,6 +482,20 @@ void _wlmtk_menu_set_item_mode(bs_dllist_node_t *dlnode_ptr, void *ud_ptr)
         ((wlmtk_menu_t*)ud_ptr)->mode);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Callback for bs_dllist_for_each: Draws or releases the item's buffers.
+ *
+ * @param dlnode_ptr
+ * @param ud_ptr
+ */
+void _wlmtk_menu_update_item_buffers(
+    bs_dllist_node_t *dlnode_ptr,
+    __UNUSED__ void *ud_ptr)
+{
+    wlmtk_menu_item_update_buffers(wlmtk_menu_item_from_dlnode(dlnode_ptr));
+}
+
 /* ------------------------------------------------------------------------- */
 /** Dtor for @ref wlmtk_menu_t::box. */
 void _wlmtk_menu_box_element_destroy(wlmtk_element_t *element_ptr)
@@ -657,6 +694,7 @@ static void test_pointer_highlight(bs_test_t *test_ptr);
 static void test_set_mode(bs_test_t *test_ptr);
 static void test_keyboard_navigation(bs_test_t *test_ptr);
 static void test_keyboard_navigation_nested(bs_test_t *test_ptr);
+static void test_buffers(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_menu_test_cases[] = {
@@ -664,6 +702,7 @@ static const bs_test_case_t _wlmtk_menu_test_cases[] = {
     { 1, "set_mode", test_set_mode },
     { 1, "keyboard_navigation", test_keyboard_navigation },
     { 1, "keyboard_navigation_nested", test_keyboard_navigation_nested },
+    { 1, "buffers", test_buffers },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -1013,4 +1052,62 @@ void test_keyboard_navigation_nested(bs_test_t *test_ptr)
     wlmtk_menu_destroy(m0);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies items hold buffers only while the menu is open. */
+void test_buffers(bs_test_t *test_ptr)
+{
+    wlmtk_menu_t *menu_ptr = wlmtk_menu_create(&_test_style_holder.msr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, menu_ptr);
+
+    wlmtk_menu_item_t *items[3];
+    for (size_t i = 0; i < 3; ++i) {
+        items[i] = wlmtk_menu_item_create(&_test_style_holder.msr);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, items[i]);
+        wlmtk_menu_add_item(menu_ptr, items[i]);
+    }
+    wlmtk_menu_t *submenu_ptr = wlmtk_menu_create(&_test_style_holder.msr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, submenu_ptr);
+    wlmtk_menu_item_t *sub_item_ptr = wlmtk_menu_item_create(
+        &_test_style_holder.msr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, sub_item_ptr);
+    wlmtk_menu_add_item(submenu_ptr, sub_item_ptr);
+    wlmtk_menu_item_set_submenu(items[2], submenu_ptr);
+
+    // Closed menu: Items hold no buffers, but keep their dimensions.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(menu_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(submenu_ptr));
+    int w, h;
+    wlmtk_element_get_dimensions(
+        wlmtk_menu_item_element(items[0]), NULL, NULL, &w, &h);
+    BS_TEST_VERIFY_EQ(test_ptr, 100, w);
+    BS_TEST_VERIFY_EQ(test_ptr, 10, h);
+
+    // Opening: Each item draws the buffer of it's current state.
+    wlmtk_menu_set_open(menu_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_menu_buffers(menu_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(submenu_ptr));
+
+    // Highlighting draws the highlighted state. Opens submenu, draws it.
+    wlmtk_menu_request_item_highlight(menu_ptr, items[2]);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmtk_menu_item_buffers(items[2]));
+    BS_TEST_VERIFY_EQ(test_ptr, 4, wlmtk_menu_buffers(menu_ptr));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_is_open(submenu_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_menu_buffers(submenu_ptr));
+
+    // Closing releases all buffers, also of the submenu.
+    wlmtk_menu_set_open(menu_ptr, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(menu_ptr));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_menu_is_open(submenu_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(submenu_ptr));
+
+    // Text changes in a closed menu do not draw.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_text(items[0], "x"));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_buffers(menu_ptr));
+
+    wlmtk_menu_set_open(menu_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_menu_buffers(menu_ptr));
+
+    wlmtk_menu_destroy(menu_ptr);
+}
+
 /* == End of menu.c ======================================================== */
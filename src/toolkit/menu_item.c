@@ -32,7 +32,10 @@
 #include "buffer.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
+#include "menu_item_internal.h"
 #include "primitives.h"
+#include "raster.h"
+#include "raster_internal.h"
 #include "util.h"
 
 /* == Declarations ========================================================= */
@@ -70,12 +73,20 @@ struct _wlmtk_menu_item_t {
     /** Mode of the menu (and the item). */
     enum wlmtk_menu_mode      mode;
 
-    /** Texture buffer holding the item in enabled state. */
+    /**
+     * Texture buffers holding the item in enabled, highlighted and disabled
+     * state. Each is drawn on demand, once the item is shown in that state,
+     * and all are released once the item's menu closes.
+     */
     struct wlr_buffer         *enabled_wlr_buffer_ptr;
-    /** Texture buffer holding the item in highlighted state. */
+    /** Texture buffer holding the item in highlighted state. See above. */
     struct wlr_buffer         *highlighted_wlr_buffer_ptr;
-    /** Texture buffer holding the item in disabled state. */
+    /** Texture buffer holding the item in disabled state. See above. */
     struct wlr_buffer         *disabled_wlr_buffer_ptr;
+    /** Pending job drawing a buffer for @ref wlmtk_menu_item_t::job_state. */
+    wlmtk_raster_job_t        *job_ptr;
+    /** The state drawn by @ref wlmtk_menu_item_t::job_ptr. */
+    wlmtk_menu_item_state_t   job_state;
 
     /** Whether the item is enabled. */
     bool                      enabled;
@@ -89,23 +100,52 @@ struct _wlmtk_menu_item_t {
     const struct wlmtk_menu_style *style_ptr;
 };
 
-static bool _wlmtk_menu_item_redraw(
-    wlmtk_menu_item_t *menu_item_ptr,
-    const struct wlmtk_menu_item_style *style_ptr);
+/** Arguments for @ref _wlmtk_menu_item_draw. A copy owned by the job. */
+typedef struct {
+    /** Copy of the item's style. */
+    struct wlmtk_menu_item_style style;
+    /** State to draw. */
+    wlmtk_menu_item_state_t   state;
+    /** Whether to draw the submenu hint. */
+    bool                      has_submenu;
+    /** Copy of the text. Released by @ref _wlmtk_menu_item_draw_args_fini. */
+    char                      *text_ptr;
+} wlmtk_menu_item_draw_args_t;
+
+static bool _wlmtk_menu_item_redraw(wlmtk_menu_item_t *menu_item_ptr);
 static void _wlmtk_menu_item_set_state(
     wlmtk_menu_item_t *menu_item_ptr,
     wlmtk_menu_item_state_t state);
-static void _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr);
-static struct wlr_buffer *_wlmtk_menu_item_create_buffer(
+static bool _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr);
+static bool _wlmtk_menu_item_shown(wlmtk_menu_item_t *menu_item_ptr);
+static void _wlmtk_menu_item_release_buffers(wlmtk_menu_item_t *menu_item_ptr);
+static struct wlr_buffer **_wlmtk_menu_item_state_buffer(
+    wlmtk_menu_item_t *menu_item_ptr,
+    wlmtk_menu_item_state_t state);
+static bool _wlmtk_menu_item_submit(
     wlmtk_menu_item_t *menu_item_ptr,
-    wlmtk_menu_item_state_t state,
-    const struct wlmtk_menu_item_style *style_ptr);
+    wlmtk_menu_item_state_t state);
+static void _wlmtk_menu_item_cancel_job(wlmtk_menu_item_t *menu_item_ptr);
+static void _wlmtk_menu_item_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmtk_menu_item_draw(cairo_t *cairo_ptr, void *args_ptr);
+static void _wlmtk_menu_item_draw_args_fini(void *args_ptr);
 static void _wlmtk_menu_item_draw_submenu_hint(
     cairo_t *cairo_ptr,
     const struct wlmtk_menu_item_style *style_ptr,
     double x,
     double y);
 
+static void _wlmtk_menu_item_element_get_dimensions(
+    wlmtk_element_t *element_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr);
+static bool _wlmtk_menu_item_element_pointer_accepts_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr);
 static bool _wlmtk_menu_item_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr);
@@ -130,6 +170,8 @@ static void _wlmtk_menu_item_handle_open_changed(
 
 /** Virtual method table for the menu item's super class: Element. */
 static const wlmtk_element_vmt_t _wlmtk_menu_item_element_vmt = {
+    .get_dimensions = _wlmtk_menu_item_element_get_dimensions,
+    .pointer_accepts_motion = _wlmtk_menu_item_element_pointer_accepts_motion,
     .pointer_button = _wlmtk_menu_item_element_pointer_button,
     .destroy = _wlmtk_menu_item_element_destroy,
 };
@@ -222,8 +264,8 @@ wlmtk_menu_item_t *wlmtk_menu_item_create(
 
     // TODO(kaeser@gubbe.ch): Should not be required!
     menu_item_ptr->enabled = true;
-    _wlmtk_menu_item_set_state(menu_item_ptr, WLMTK_MENU_ITEM_ENABLED);
-    _wlmtk_menu_item_redraw(menu_item_ptr, &menu_item_ptr->style_ptr->item);
+    // Nothing to draw yet: Buffers are drawn once text is set, or when shown.
+    menu_item_ptr->state = WLMTK_MENU_ITEM_ENABLED;
 
     wlmtk_element_set_visible(wlmtk_menu_item_element(menu_item_ptr), true);
 
@@ -257,9 +299,7 @@ void wlmtk_menu_item_destroy(wlmtk_menu_item_t *menu_item_ptr)
         menu_item_ptr->text_ptr = NULL;
     }
 
-    wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
+    _wlmtk_menu_item_release_buffers(menu_item_ptr);
 
     wlmtk_buffer_fini(&menu_item_ptr->super_buffer);
     if (NULL != menu_item_ptr->style_ref_ptr) {
@@ -286,8 +326,7 @@ bool wlmtk_menu_item_set_style(
     menu_item_ptr->style_ptr = wlmtk_menu_style_ref_retain(style_ref_ptr);
 
     bool rv = true;
-    rv &= _wlmtk_menu_item_redraw(
-        menu_item_ptr, &menu_item_ptr->style_ptr->item);
+    rv &= _wlmtk_menu_item_redraw(menu_item_ptr);
 
     if (NULL != menu_item_ptr->submenu_ptr) {
         rv &= wlmtk_menu_set_style(
@@ -322,6 +361,9 @@ void wlmtk_menu_item_set_parent_menu(
             wlmtk_menu_base(menu_item_ptr->menu_ptr),
             wlmtk_menu_element(menu_item_ptr->submenu_ptr));
     }
+
+    // Draws or releases the buffers, depending on whether the menu is open.
+    _wlmtk_menu_item_draw_state(menu_item_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -360,7 +402,7 @@ void wlmtk_menu_item_set_submenu(
         wlmtk_menu_set_parent_item(submenu_ptr, menu_item_ptr);
     }
 
-    _wlmtk_menu_item_redraw(menu_item_ptr, &menu_item_ptr->style_ptr->item);
+    _wlmtk_menu_item_redraw(menu_item_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -406,9 +448,7 @@ bool wlmtk_menu_item_set_text(
     if (NULL != menu_item_ptr->text_ptr) free(menu_item_ptr->text_ptr);
     menu_item_ptr->text_ptr = new_text_ptr;
 
-    return _wlmtk_menu_item_redraw(
-        menu_item_ptr,
-        &menu_item_ptr->style_ptr->item);
+    return _wlmtk_menu_item_redraw(menu_item_ptr);
 }
 
 /* -------------------------------------------------------------------------*/
@@ -472,6 +512,22 @@ void wlmtk_menu_item_trigger(wlmtk_menu_item_t *menu_item_ptr)
     }
 }
 
+/* -------------------------------------------------------------------------*/
+bool wlmtk_menu_item_update_buffers(wlmtk_menu_item_t *menu_item_ptr)
+{
+    return _wlmtk_menu_item_draw_state(menu_item_ptr);
+}
+
+/* -------------------------------------------------------------------------*/
+size_t wlmtk_menu_item_buffers(wlmtk_menu_item_t *menu_item_ptr)
+{
+    size_t buffers = 0;
+    if (NULL != menu_item_ptr->enabled_wlr_buffer_ptr) ++buffers;
+    if (NULL != menu_item_ptr->highlighted_wlr_buffer_ptr) ++buffers;
+    if (NULL != menu_item_ptr->disabled_wlr_buffer_ptr) ++buffers;
+    return buffers;
+}
+
 /* -------------------------------------------------------------------------*/
 bs_dllist_node_t *wlmtk_dlnode_from_menu_item(
     wlmtk_menu_item_t *menu_item_ptr)
@@ -498,36 +554,20 @@ wlmtk_element_t *wlmtk_menu_item_element(wlmtk_menu_item_t *menu_item_ptr)
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the buffers for the menu item. Also updates the buffer state. */
-bool _wlmtk_menu_item_redraw(
-    wlmtk_menu_item_t *menu_item_ptr,
-    const struct wlmtk_menu_item_style *style_ptr)
+/**
+ * Discards the buffers drawn for the menu item, and draws the buffer for the
+ * current state, if the item is shown. Other states are drawn on demand.
+ */
+bool _wlmtk_menu_item_redraw(wlmtk_menu_item_t *menu_item_ptr)
 {
-    struct wlr_buffer *e, *h, *d;
-
-    e = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_ENABLED, style_ptr);
-    h = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_HIGHLIGHTED, style_ptr);
-    d = _wlmtk_menu_item_create_buffer(
-        menu_item_ptr, WLMTK_MENU_ITEM_DISABLED, style_ptr);
-
-    if (NULL == e || NULL == d || NULL == h) {
-        wlr_buffer_drop_nullify(&e);
-        wlr_buffer_drop_nullify(&h);
-        wlr_buffer_drop_nullify(&d);
-        return false;
-    }
-
+    _wlmtk_menu_item_cancel_job(menu_item_ptr);
+    // The super_buffer holds a lock on the current buffer, and keeps showing
+    // it until it is replaced by the redrawn buffer.
     wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
-    menu_item_ptr->enabled_wlr_buffer_ptr = e;
     wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
-    menu_item_ptr->highlighted_wlr_buffer_ptr = h;
     wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
-    menu_item_ptr->disabled_wlr_buffer_ptr = d;
 
-    _wlmtk_menu_item_draw_state(menu_item_ptr);
-    return true;
+    return _wlmtk_menu_item_draw_state(menu_item_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -558,64 +598,191 @@ void _wlmtk_menu_item_set_state(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Applies the state: Sets the parent buffer's content accordingly. */
-void _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr)
+/**
+ * Applies the state: Sets the parent buffer's content accordingly.
+ *
+ * The buffer for the state is drawn on first use, on the rasterization pool.
+ * Until it is handed back, the item keeps showing the previous buffer. If the
+ * item is not shown, all buffers are released instead.
+ *
+ * @param menu_item_ptr
+ *
+ * @return false if drawing the buffer failed.
+ */
+bool _wlmtk_menu_item_draw_state(wlmtk_menu_item_t *menu_item_ptr)
 {
-    switch (menu_item_ptr->state) {
-    case WLMTK_MENU_ITEM_ENABLED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->enabled_wlr_buffer_ptr);
-        break;
+    if (!_wlmtk_menu_item_shown(menu_item_ptr)) {
+        _wlmtk_menu_item_release_buffers(menu_item_ptr);
+        return true;
+    }
 
-    case WLMTK_MENU_ITEM_HIGHLIGHTED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->highlighted_wlr_buffer_ptr);
-        break;
+    struct wlr_buffer **wlr_buffer_ptr_ptr = _wlmtk_menu_item_state_buffer(
+        menu_item_ptr, menu_item_ptr->state);
+    if (NULL == wlr_buffer_ptr_ptr) return false;
 
-    case WLMTK_MENU_ITEM_DISABLED:
-        wlmtk_buffer_set(&menu_item_ptr->super_buffer,
-                         menu_item_ptr->disabled_wlr_buffer_ptr);
-        break;
+    if (NULL != *wlr_buffer_ptr_ptr) {
+        _wlmtk_menu_item_cancel_job(menu_item_ptr);
+        wlmtk_buffer_set(&menu_item_ptr->super_buffer, *wlr_buffer_ptr_ptr);
+        return true;
+    }
+    return _wlmtk_menu_item_submit(menu_item_ptr, menu_item_ptr->state);
+}
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the slot holding the buffer for `state`.
+ *
+ * @param menu_item_ptr
+ * @param state
+ *
+ * @return Pointer to the slot, or NULL if `state` is invalid.
+ */
+struct wlr_buffer **_wlmtk_menu_item_state_buffer(
+    wlmtk_menu_item_t *menu_item_ptr,
+    wlmtk_menu_item_state_t state)
+{
+    switch (state) {
+    case WLMTK_MENU_ITEM_ENABLED:
+        return &menu_item_ptr->enabled_wlr_buffer_ptr;
+    case WLMTK_MENU_ITEM_HIGHLIGHTED:
+        return &menu_item_ptr->highlighted_wlr_buffer_ptr;
+    case WLMTK_MENU_ITEM_DISABLED:
+        return &menu_item_ptr->disabled_wlr_buffer_ptr;
     default:
-        bs_log(BS_FATAL, "Unhandled state %d", menu_item_ptr->state);
+        break;
     }
+    bs_log(BS_FATAL, "Unhandled state %d", state);
+    return NULL;
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a wlr_buffer with the menu item drawn for the given state.
+ * Submits a job to draw the buffer for `state`. Cancels a pending job for any
+ * other state. Without rasterization pool, the buffer is drawn (and set) right
+ * away.
  *
  * @param menu_item_ptr
  * @param state
- * @param style_ptr
  *
- * @return A wlr_buffer, or NULL on error.
+ * @return false on error.
  */
-struct wlr_buffer *_wlmtk_menu_item_create_buffer(
+bool _wlmtk_menu_item_submit(
     wlmtk_menu_item_t *menu_item_ptr,
-    wlmtk_menu_item_state_t state,
-    const struct wlmtk_menu_item_style *style_ptr)
+    wlmtk_menu_item_state_t state)
+{
+    if (NULL != menu_item_ptr->job_ptr) {
+        if (menu_item_ptr->job_state == state) return true;
+        _wlmtk_menu_item_cancel_job(menu_item_ptr);
+    }
+
+    wlmtk_menu_item_draw_args_t args = {
+        .style = menu_item_ptr->style_ptr->item,
+        .state = state,
+        .has_submenu = NULL != menu_item_ptr->submenu_ptr,
+        .text_ptr = logged_strdup(
+            NULL != menu_item_ptr->text_ptr ? menu_item_ptr->text_ptr : "")
+    };
+    if (NULL == args.text_ptr) return false;
+
+    // On failure, the text was not handed to the job: Still ours to free.
+    menu_item_ptr->job_state = state;
+    if (!wlmtk_raster_submit(
+            args.style.width,
+            args.style.height,
+            _wlmtk_menu_item_draw,
+            &args, sizeof(args),
+            _wlmtk_menu_item_draw_args_fini,
+            _wlmtk_menu_item_handle_drawn,
+            menu_item_ptr,
+            &menu_item_ptr->job_ptr)) {
+        free(args.text_ptr);
+        return false;
+    }
+    // Synchronously drawn: The slot is populated, unless drawing failed.
+    if (NULL == menu_item_ptr->job_ptr) {
+        return NULL != *_wlmtk_menu_item_state_buffer(menu_item_ptr, state);
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Cancels the pending rasterization job, if any. */
+void _wlmtk_menu_item_cancel_job(wlmtk_menu_item_t *menu_item_ptr)
+{
+    if (NULL == menu_item_ptr->job_ptr) return;
+    wlmtk_raster_job_cancel(menu_item_ptr->job_ptr);
+    menu_item_ptr->job_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the buffer drawn by @ref _wlmtk_menu_item_submit. Stores it, and
+ * shows it if the item is (still) in that state.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr
+ */
+void _wlmtk_menu_item_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        style_ptr->width, style_ptr->height);
+    wlmtk_menu_item_t *menu_item_ptr = ud_ptr;
+    menu_item_ptr->job_ptr = NULL;
     if (NULL == wlr_buffer_ptr) {
-        bs_log(BS_ERROR,
-               "Failed bs_gfxbuf_create_wlr_buffer(%"PRIu64",, %"PRIu64")",
-               style_ptr->width, style_ptr->height);
-        return NULL;
+        bs_log(BS_WARNING, "Failed to draw menu item %p", menu_item_ptr);
+        return;
     }
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        bs_log(BS_ERROR, "Failed cairo_create_from_wlr_buffer(%p)",
-               wlr_buffer_ptr);
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
+    struct wlr_buffer **wlr_buffer_ptr_ptr = _wlmtk_menu_item_state_buffer(
+        menu_item_ptr, menu_item_ptr->job_state);
+    wlr_buffer_drop_nullify(wlr_buffer_ptr_ptr);
+    *wlr_buffer_ptr_ptr = wlr_buffer_ptr;
+    if (menu_item_ptr->job_state == menu_item_ptr->state) {
+        wlmtk_buffer_set(&menu_item_ptr->super_buffer, wlr_buffer_ptr);
     }
+}
 
-    const char *text_ptr = "";
-    if (NULL != menu_item_ptr->text_ptr) text_ptr = menu_item_ptr->text_ptr;
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the menu item is shown: True, if it is a standalone item,
+ * or if the menu it belongs to is open.
+ *
+ * @param menu_item_ptr
+ *
+ * @return true if shown.
+ */
+bool _wlmtk_menu_item_shown(wlmtk_menu_item_t *menu_item_ptr)
+{
+    return (NULL == menu_item_ptr->menu_ptr ||
+            wlmtk_menu_is_open(menu_item_ptr->menu_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Releases all buffers of the menu item, including the parent buffer's. */
+void _wlmtk_menu_item_release_buffers(wlmtk_menu_item_t *menu_item_ptr)
+{
+    _wlmtk_menu_item_cancel_job(menu_item_ptr);
+    wlmtk_buffer_set(&menu_item_ptr->super_buffer, NULL);
+    wlr_buffer_drop_nullify(&menu_item_ptr->enabled_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&menu_item_ptr->highlighted_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&menu_item_ptr->disabled_wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the menu item. Runs on a worker
+ * thread, and must only access the arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmtk_menu_item_draw_args_t.
+ *
+ * @return true.
+ */
+bool _wlmtk_menu_item_draw(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmtk_menu_item_draw_args_t *args = args_ptr;
+    const struct wlmtk_menu_item_style *style_ptr = &args->style;
+    wlmtk_menu_item_state_t state = args->state;
 
     const wlmtk_style_fill_t *fill_ptr = &style_ptr->fill;
     uint32_t color = style_ptr->enabled_text_color;
@@ -630,7 +797,7 @@ struct wlr_buffer *_wlmtk_menu_item_create_buffer(
     wlmaker_primitives_draw_bezel(
         cairo_ptr, style_ptr->bezel_width, true);
 
-    if (NULL != menu_item_ptr->submenu_ptr) {
+    if (args->has_submenu) {
         _wlmtk_menu_item_draw_submenu_hint(
             cairo_ptr,
             style_ptr,
@@ -643,10 +810,19 @@ struct wlr_buffer *_wlmtk_menu_item_create_buffer(
         6, 2 + style_ptr->font.size,
         &style_ptr->font,
         color,
-        text_ptr);
+        args->text_ptr);
+    return true;
+}
 
-    cairo_destroy(cairo_ptr);
-    return wlr_buffer_ptr;
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_raster_args_fini_t: Frees the copied text. */
+void _wlmtk_menu_item_draw_args_fini(void *args_ptr)
+{
+    wlmtk_menu_item_draw_args_t *args = args_ptr;
+    if (NULL != args->text_ptr) {
+        free(args->text_ptr);
+        args->text_ptr = NULL;
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -687,6 +863,61 @@ void _wlmtk_menu_item_draw_submenu_hint(
     cairo_restore(cairo_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::get_dimensions. Reports the item's
+ * dimensions from the style, so the layout does not depend on whether the
+ * buffers are currently drawn.
+ *
+ * @param element_ptr
+ * @param left_ptr            Leftmost position. May be NULL.
+ * @param top_ptr             Topmost position. May be NULL.
+ * @param right_ptr           Rightmost position. May be NULL.
+ * @param bottom_ptr          Bottommost position. May be NULL.
+ */
+void _wlmtk_menu_item_element_get_dimensions(
+    wlmtk_element_t *element_ptr,
+    int *left_ptr,
+    int *top_ptr,
+    int *right_ptr,
+    int *bottom_ptr)
+{
+    wlmtk_menu_item_t *menu_item_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_menu_item_t, super_buffer.super_element);
+
+    if (NULL != left_ptr) *left_ptr = 0;
+    if (NULL != top_ptr) *top_ptr = 0;
+    if (NULL != right_ptr) *right_ptr = menu_item_ptr->style_ptr->item.width;
+    if (NULL != bottom_ptr) {
+        *bottom_ptr = menu_item_ptr->style_ptr->item.height;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::pointer_accepts_motion. Accepts the
+ * motion if within the item's dimensions, as given by the style.
+ *
+ * @param element_ptr
+ * @param motion_event_ptr
+ *
+ * @return true if (x, y) is within the item's dimensions.
+ */
+bool _wlmtk_menu_item_element_pointer_accepts_motion(
+    wlmtk_element_t *element_ptr,
+    wlmtk_pointer_motion_event_t *motion_event_ptr)
+{
+    wlmtk_menu_item_t *menu_item_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_menu_item_t, super_buffer.super_element);
+    const struct wlmtk_menu_item_style *style_ptr =
+        &menu_item_ptr->style_ptr->item;
+
+    return (0 <= motion_event_ptr->x &&
+            motion_event_ptr->x < (double)style_ptr->width &&
+            0 <= motion_event_ptr->y &&
+            motion_event_ptr->y < (double)style_ptr->height);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Checks if the button event is a click, and calls the handler. */
 bool _wlmtk_menu_item_element_pointer_button(
@@ -814,6 +1045,7 @@ void _wlmtk_menu_item_handle_open_changed(
 /* == Unit tests =========================================================== */
 
 static void test_create_destroy(bs_test_t *test_ptr);
+static void test_submit_failure(bs_test_t *test_ptr);
 static void test_buffers(bs_test_t *test_ptr);
 static void test_pointer(bs_test_t *test_ptr);
 static void test_triggered(bs_test_t *test_ptr);
@@ -823,6 +1055,7 @@ static void test_submenu_highlight(bs_test_t *test_ptr);
 /** Test cases */
 static const bs_test_case_t _wlmtk_menu_item_test_cases[] = {
     { 1, "create_destroy", test_create_destroy },
+    { 1, "submit_failure", test_submit_failure },
     // TODO(kaeser@gubbe.ch): Re-enable, once figuring out why these fail on
     // Trixie when running as a github action.
     { 0, "buffers", test_buffers },
@@ -845,6 +1078,8 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_create(
         wlmtk_menu_style_to_ref(s));
     BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, item_ptr);
+    // Nothing is drawn before there is text to show.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_item_buffers(item_ptr));
 
     bs_dllist_node_t *dlnode_ptr = wlmtk_dlnode_from_menu_item(item_ptr);
     BS_TEST_VERIFY_EQ(test_ptr, dlnode_ptr, &item_ptr->dlnode);
@@ -867,6 +1102,30 @@ void test_create_destroy(bs_test_t *test_ptr)
     wlmtk_menu_style_ref_release(wlmtk_menu_style_to_ref(s));
 }
 
+/* ------------------------------------------------------------------------- */
+/** A failed submission reports failure, and releases the text just once. */
+void test_submit_failure(bs_test_t *test_ptr)
+{
+    struct wlmtk_menu_style *s = wlmtk_menu_style_create();
+    *s = _test_style;
+    s->item.width = 80;
+    wlmtk_menu_item_t *item_ptr = wlmtk_menu_item_create(
+        wlmtk_menu_style_to_ref(s));
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, item_ptr);
+
+    wlmtk_raster_test_fail_submissions(1);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_menu_item_set_text(item_ptr, "T"));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, item_ptr->job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_item_buffers(item_ptr));
+
+    // Recovers on the next attempt.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_menu_item_set_text(item_ptr, "T"));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_menu_item_buffers(item_ptr));
+
+    wlmtk_menu_item_destroy(item_ptr);
+    wlmtk_menu_style_ref_release(wlmtk_menu_style_to_ref(s));
+}
+
 /* ------------------------------------------------------------------------- */
 /** Exercises drawing. */
 void test_buffers(bs_test_t *test_ptr)
@@ -880,6 +1139,13 @@ void test_buffers(bs_test_t *test_ptr)
 
     wlmtk_menu_item_set_text(item_ptr, "Menu item");
 
+    // Only the buffer of the current state is drawn. Others on demand.
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_menu_item_buffers(item_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, item_ptr->highlighted_wlr_buffer_ptr);
+    wlmtk_menu_item_set_highlighted(item_ptr, true);
+    wlmtk_menu_item_set_enabled(item_ptr, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_menu_item_buffers(item_ptr));
+
     bs_gfxbuf_t *g;
 
     g = bs_gfxbuf_from_wlr_buffer(item_ptr->enabled_wlr_buffer_ptr);
@@ -898,6 +1164,10 @@ void test_buffers(bs_test_t *test_ptr)
         wlmtk_menu_style_to_ref(s));
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, submenu_ptr);
     wlmtk_menu_item_set_submenu(item_ptr, submenu_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmtk_menu_item_buffers(item_ptr));
+    wlmtk_menu_item_set_enabled(item_ptr, true);
+    wlmtk_menu_item_set_highlighted(item_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmtk_menu_item_buffers(item_ptr));
 
     g = bs_gfxbuf_from_wlr_buffer(item_ptr->enabled_wlr_buffer_ptr);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
@@ -929,6 +1199,8 @@ void test_pointer(bs_test_t *test_ptr)
     BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, item_ptr);
     wlmtk_menu_add_item(menu_ptr, item_ptr);
     BS_TEST_VERIFY_EQ(test_ptr, menu_ptr, item_ptr->menu_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmtk_menu_item_buffers(item_ptr));
+    wlmtk_menu_set_open(menu_ptr, true);
 
     wlmtk_element_t *e = wlmtk_menu_item_element(item_ptr);
     wlmtk_button_event_t lbtn_ev = {
@@ -941,6 +1213,7 @@ void test_pointer(bs_test_t *test_ptr)
         test_ptr,
         WLMTK_MENU_ITEM_ENABLED,
         wlmtk_menu_item_get_state(item_ptr));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, item_ptr->enabled_wlr_buffer_ptr);
     BS_TEST_VERIFY_EQ(
         test_ptr,
         item_ptr->super_buffer.wlr_buffer_ptr,
@@ -0,0 +1,53 @@
+/* ========================================================================= */
+/**
+ * @file menu_item_internal.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_MENU_ITEM_INTERNAL_H__
+#define __WLMTK_MENU_ITEM_INTERNAL_H__
+
+/*
+ * Toolkit-internal: For the menu owning the items. Not installed.
+ */
+
+#include <stdbool.h>
+
+#include "menu_item.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Updates the item's buffers for whether it is shown: Draws the buffer for
+ * the current state if the item's menu is open, or releases all buffers if
+ * the menu is closed.
+ *
+ * Should only be called by @ref wlmtk_menu_set_open.
+ *
+ * @param menu_item_ptr
+ *
+ * @return false if drawing the buffer failed.
+ */
+bool wlmtk_menu_item_update_buffers(wlmtk_menu_item_t *menu_item_ptr);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_MENU_ITEM_INTERNAL_H__ */
+/* == End of menu_item_internal.h ========================================== */
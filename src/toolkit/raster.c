@@ -0,0 +1,746 @@
+/* ========================================================================= */
+/**
+ * @file raster.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "raster.h"
+#include "raster_internal.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#define WLR_USE_UNSTABLE
+#include <wlr/types/wlr_buffer.h>
+#undef WLR_USE_UNSTABLE
+
+#include "gfxbuf.h"
+
+/* == Declarations ========================================================= */
+
+/** State of a rasterization job. */
+typedef enum {
+    WLMTK_RASTER_JOB_QUEUED,
+    WLMTK_RASTER_JOB_RUNNING,
+    WLMTK_RASTER_JOB_DONE
+} wlmtk_raster_job_state_t;
+
+/** State of the pool of rasterization workers. */
+struct _wlmtk_raster_pool_t {
+    /** Worker threads. */
+    pthread_t                 *threads_ptr;
+    /** Number of started threads in @ref wlmtk_raster_pool_t::threads_ptr. */
+    unsigned                  threads;
+
+    /** Jobs submitted so far. Accessed only from the event loop's thread. */
+    size_t                    submitted_jobs;
+
+    /** Signalled by the workers when a job is done. */
+    int                       event_fd;
+    /** Event source for @ref wlmtk_raster_pool_t::event_fd. */
+    struct wl_event_source    *wl_event_source_ptr;
+
+    /** Guards all members below. */
+    pthread_mutex_t           mutex;
+    /** Signalled when a job is queued, or on shutdown. */
+    pthread_cond_t            cond;
+    /** Jobs waiting to be drawn, via @ref wlmtk_raster_job_t::dlnode. */
+    bs_dllist_t               queued_jobs;
+    /** Jobs drawn, waiting to be handed back. */
+    bs_dllist_t               done_jobs;
+    /** Whether the workers shall exit, once the queue is drained. */
+    bool                      shutdown;
+};
+
+/** State of a rasterization job. */
+struct _wlmtk_raster_job_t {
+    /** Node within @ref wlmtk_raster_pool_t::queued_jobs or `done_jobs`. */
+    bs_dllist_node_t          dlnode;
+    /** The pool the job was submitted to. NULL when drawn synchronously. */
+    wlmtk_raster_pool_t       *pool_ptr;
+    /** State. Guarded by @ref wlmtk_raster_pool_t::mutex. */
+    wlmtk_raster_job_state_t  state;
+    /** Whether the job was cancelled. Guarded by the pool's mutex. */
+    bool                      cancelled;
+    /** Whether drawing succeeded. Written by the worker. */
+    bool                      success;
+
+    /**
+     * The buffer to draw into. Created on the event loop's thread, and only
+     * wrapped as `struct wlr_buffer` once handed back there: Workers must
+     * not access wlroots buffers.
+     */
+    bs_gfxbuf_t               *gfxbuf_ptr;
+    /** Draws the buffer. */
+    wlmtk_raster_draw_t       draw;
+    /** The job's copy of the arguments to `draw`. */
+    void                      *args_ptr;
+    /** Releases resources referenced from `args_ptr`. May be NULL. */
+    wlmtk_raster_args_fini_t  args_fini;
+    /** Hands back the buffer. */
+    wlmtk_raster_done_t       done;
+    /** Argument to `done`. */
+    void                      *done_ud_ptr;
+};
+
+static wlmtk_raster_job_t *_wlmtk_raster_job_create(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr);
+static void _wlmtk_raster_job_destroy(wlmtk_raster_job_t *job_ptr);
+static bool _wlmtk_raster_job_draw(wlmtk_raster_job_t *job_ptr);
+static void _wlmtk_raster_job_hand_back(wlmtk_raster_job_t *job_ptr);
+
+static void *_wlmtk_raster_pool_worker(void *arg_ptr);
+static void _wlmtk_raster_pool_hand_back(wlmtk_raster_pool_t *pool_ptr);
+static int _wlmtk_raster_pool_handle_event_fd(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+
+/* == Data ================================================================= */
+
+/** The pool used by @ref wlmtk_raster_submit. NULL: Draw synchronously. */
+static wlmtk_raster_pool_t *_wlmtk_raster_pool_ptr = NULL;
+
+/** Unit test injector: Number of submissions yet to fail. */
+static unsigned _wlmtk_raster_test_failures = 0;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmtk_raster_pool_t *wlmtk_raster_pool_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    unsigned threads)
+{
+    wlmtk_raster_pool_t *pool_ptr = logged_calloc(
+        1, sizeof(wlmtk_raster_pool_t));
+    if (NULL == pool_ptr) return NULL;
+    pool_ptr->event_fd = -1;
+    pthread_mutex_init(&pool_ptr->mutex, NULL);
+    pthread_cond_init(&pool_ptr->cond, NULL);
+
+    // Synchronous mode: No workers, and nothing to hand back.
+    if (NULL == wl_event_loop_ptr || 0 == threads) return pool_ptr;
+
+    pool_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > pool_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO,
+               "Failed eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)");
+        goto error;
+    }
+    pool_ptr->wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        pool_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlmtk_raster_pool_handle_event_fd,
+        pool_ptr);
+    if (NULL == pool_ptr->wl_event_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, "
+               "WL_EVENT_READABLE, %p, %p)",
+               wl_event_loop_ptr, pool_ptr->event_fd,
+               _wlmtk_raster_pool_handle_event_fd, pool_ptr);
+        goto error;
+    }
+
+    pool_ptr->threads_ptr = logged_calloc(threads, sizeof(pthread_t));
+    if (NULL == pool_ptr->threads_ptr) goto error;
+    for (; pool_ptr->threads < threads; ++pool_ptr->threads) {
+        int rv = pthread_create(
+            &pool_ptr->threads_ptr[pool_ptr->threads], NULL,
+            _wlmtk_raster_pool_worker, pool_ptr);
+        if (0 != rv) {
+            errno = rv;
+            bs_log(BS_ERROR | BS_ERRNO,
+                   "Failed pthread_create(%p, NULL, %p, %p)",
+                   &pool_ptr->threads_ptr[pool_ptr->threads],
+                   _wlmtk_raster_pool_worker, pool_ptr);
+            goto error;
+        }
+    }
+    return pool_ptr;
+
+error:
+    wlmtk_raster_pool_destroy(pool_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_pool_destroy(wlmtk_raster_pool_t *pool_ptr)
+{
+    if (_wlmtk_raster_pool_ptr == pool_ptr) _wlmtk_raster_pool_ptr = NULL;
+
+    // Workers drain the queue before they exit.
+    pthread_mutex_lock(&pool_ptr->mutex);
+    pool_ptr->shutdown = true;
+    pthread_cond_broadcast(&pool_ptr->cond);
+    pthread_mutex_unlock(&pool_ptr->mutex);
+    for (unsigned i = 0; i < pool_ptr->threads; ++i) {
+        pthread_join(pool_ptr->threads_ptr[i], NULL);
+    }
+    pool_ptr->threads = 0;
+    _wlmtk_raster_pool_hand_back(pool_ptr);
+
+    if (NULL != pool_ptr->threads_ptr) {
+        free(pool_ptr->threads_ptr);
+        pool_ptr->threads_ptr = NULL;
+    }
+    if (NULL != pool_ptr->wl_event_source_ptr) {
+        wl_event_source_remove(pool_ptr->wl_event_source_ptr);
+        pool_ptr->wl_event_source_ptr = NULL;
+    }
+    if (0 <= pool_ptr->event_fd) {
+        close(pool_ptr->event_fd);
+        pool_ptr->event_fd = -1;
+    }
+    pthread_cond_destroy(&pool_ptr->cond);
+    pthread_mutex_destroy(&pool_ptr->mutex);
+    free(pool_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_set_pool(wlmtk_raster_pool_t *pool_ptr)
+{
+    _wlmtk_raster_pool_ptr = pool_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_raster_submit(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr,
+    wlmtk_raster_job_t **job_ptr_ptr)
+{
+    return wlmtk_raster_pool_submit(
+        _wlmtk_raster_pool_ptr,
+        width, height,
+        draw, args_ptr, args_size, args_fini,
+        done, done_ud_ptr,
+        job_ptr_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_raster_pool_submit(
+    wlmtk_raster_pool_t *pool_ptr,
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr,
+    wlmtk_raster_job_t **job_ptr_ptr)
+{
+    *job_ptr_ptr = NULL;
+    wlmtk_raster_job_t *job_ptr = _wlmtk_raster_job_create(
+        width, height,
+        draw, args_ptr, args_size, args_fini,
+        done, done_ud_ptr);
+    if (NULL == job_ptr) return false;
+    if (NULL != pool_ptr) ++pool_ptr->submitted_jobs;
+
+    // Synchronous: Draw and hand back right here.
+    if (NULL == pool_ptr || 0 == pool_ptr->threads) {
+        job_ptr->success = _wlmtk_raster_job_draw(job_ptr);
+        _wlmtk_raster_job_hand_back(job_ptr);
+        return true;
+    }
+
+    *job_ptr_ptr = job_ptr;
+    job_ptr->pool_ptr = pool_ptr;
+    pthread_mutex_lock(&pool_ptr->mutex);
+    bs_dllist_push_back(&pool_ptr->queued_jobs, &job_ptr->dlnode);
+    pthread_cond_signal(&pool_ptr->cond);
+    pthread_mutex_unlock(&pool_ptr->mutex);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmtk_raster_pool_submitted_jobs(wlmtk_raster_pool_t *pool_ptr)
+{
+    return pool_ptr->submitted_jobs;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_test_fail_submissions(unsigned failures)
+{
+    _wlmtk_raster_test_failures = failures;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_raster_job_cancel(wlmtk_raster_job_t *job_ptr)
+{
+    // Only jobs queued on a pool with workers are ever pending.
+    wlmtk_raster_pool_t *pool_ptr = job_ptr->pool_ptr;
+    BS_ASSERT(NULL != pool_ptr);
+
+    pthread_mutex_lock(&pool_ptr->mutex);
+    if (WLMTK_RASTER_JOB_QUEUED == job_ptr->state) {
+        bs_dllist_remove(&pool_ptr->queued_jobs, &job_ptr->dlnode);
+        pthread_mutex_unlock(&pool_ptr->mutex);
+        _wlmtk_raster_job_destroy(job_ptr);
+        return;
+    }
+    // Running, or waiting to be handed back: That will destroy it.
+    job_ptr->cancelled = true;
+    pthread_mutex_unlock(&pool_ptr->mutex);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a job: Copies the arguments, and creates the buffer. On error, the
+ * copy is released without calling `args_fini`: The caller still owns what
+ * the arguments reference.
+ */
+wlmtk_raster_job_t *_wlmtk_raster_job_create(
+    unsigned width,
+    unsigned height,
+    wlmtk_raster_draw_t draw,
+    const void *args_ptr,
+    size_t args_size,
+    wlmtk_raster_args_fini_t args_fini,
+    wlmtk_raster_done_t done,
+    void *done_ud_ptr)
+{
+    wlmtk_raster_job_t *job_ptr = logged_calloc(1, sizeof(wlmtk_raster_job_t));
+    if (NULL == job_ptr) return NULL;
+    job_ptr->draw = draw;
+    job_ptr->done = done;
+    job_ptr->done_ud_ptr = done_ud_ptr;
+
+    job_ptr->args_ptr = logged_calloc(1, BS_MAX(args_size, 1));
+    if (NULL == job_ptr->args_ptr) goto error;
+    if (0 < args_size) memcpy(job_ptr->args_ptr, args_ptr, args_size);
+
+    if (0 < _wlmtk_raster_test_failures) {
+        --_wlmtk_raster_test_failures;
+        goto error;
+    }
+    job_ptr->gfxbuf_ptr = bs_gfxbuf_create(width, height);
+    if (NULL == job_ptr->gfxbuf_ptr) {
+        bs_log(BS_ERROR, "Failed bs_gfxbuf_create(%u, %u)", width, height);
+        goto error;
+    }
+    // Only now the job owns what the arguments reference.
+    job_ptr->args_fini = args_fini;
+    return job_ptr;
+
+error:
+    _wlmtk_raster_job_destroy(job_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys the job. Releases the arguments and the buffer, if still held. */
+void _wlmtk_raster_job_destroy(wlmtk_raster_job_t *job_ptr)
+{
+    if (NULL != job_ptr->gfxbuf_ptr) {
+        bs_gfxbuf_destroy(job_ptr->gfxbuf_ptr);
+        job_ptr->gfxbuf_ptr = NULL;
+    }
+    if (NULL != job_ptr->args_ptr) {
+        if (NULL != job_ptr->args_fini) job_ptr->args_fini(job_ptr->args_ptr);
+        free(job_ptr->args_ptr);
+        job_ptr->args_ptr = NULL;
+    }
+    free(job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Draws the job's buffer. Safe to run on a worker thread: This only accesses
+ * the job's `bs_gfxbuf_t`, and no wlroots buffer.
+ *
+ * @param job_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_raster_job_draw(wlmtk_raster_job_t *job_ptr)
+{
+    cairo_t *cairo_ptr = cairo_create_from_bs_gfxbuf(job_ptr->gfxbuf_ptr);
+    if (NULL == cairo_ptr) return false;
+    bool rv = job_ptr->draw(cairo_ptr, job_ptr->args_ptr);
+    cairo_destroy(cairo_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Hands the buffer back, unless cancelled, and destroys the job. Runs on the
+ * event loop's thread: Wraps the drawn buffer as `struct wlr_buffer`.
+ */
+void _wlmtk_raster_job_hand_back(wlmtk_raster_job_t *job_ptr)
+{
+    if (!job_ptr->cancelled) {
+        struct wlr_buffer *wlr_buffer_ptr = NULL;
+        if (job_ptr->success) {
+            wlr_buffer_ptr = bs_gfxbuf_wrap_wlr_buffer(job_ptr->gfxbuf_ptr);
+            if (NULL != wlr_buffer_ptr) job_ptr->gfxbuf_ptr = NULL;
+        }
+        job_ptr->done(wlr_buffer_ptr, job_ptr->done_ud_ptr);
+    }
+    _wlmtk_raster_job_destroy(job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Thread function: Draws queued jobs, and signals the event loop for each.
+ *
+ * @param arg_ptr             Points to @ref wlmtk_raster_pool_t.
+ *
+ * @return NULL.
+ */
+void *_wlmtk_raster_pool_worker(void *arg_ptr)
+{
+    wlmtk_raster_pool_t *pool_ptr = arg_ptr;
+
+    pthread_mutex_lock(&pool_ptr->mutex);
+    while (true) {
+        while (NULL == pool_ptr->queued_jobs.head_ptr && !pool_ptr->shutdown) {
+            pthread_cond_wait(&pool_ptr->cond, &pool_ptr->mutex);
+        }
+        bs_dllist_node_t *dlnode_ptr = bs_dllist_pop_front(
+            &pool_ptr->queued_jobs);
+        if (NULL == dlnode_ptr) break;
+
+        wlmtk_raster_job_t *job_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_raster_job_t, dlnode);
+        job_ptr->state = WLMTK_RASTER_JOB_RUNNING;
+        bool cancelled = job_ptr->cancelled;
+        pthread_mutex_unlock(&pool_ptr->mutex);
+
+        if (!cancelled) job_ptr->success = _wlmtk_raster_job_draw(job_ptr);
+
+        pthread_mutex_lock(&pool_ptr->mutex);
+        job_ptr->state = WLMTK_RASTER_JOB_DONE;
+        bs_dllist_push_back(&pool_ptr->done_jobs, &job_ptr->dlnode);
+
+        uint64_t value = 1;
+        while (0 > write(pool_ptr->event_fd, &value, sizeof(value))) {
+            if (EINTR == errno) continue;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed write(%d, %p, %zu)",
+                   pool_ptr->event_fd, &value, sizeof(value));
+            break;
+        }
+    }
+    pthread_mutex_unlock(&pool_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Hands back all jobs the workers have completed. */
+void _wlmtk_raster_pool_hand_back(wlmtk_raster_pool_t *pool_ptr)
+{
+    bs_dllist_t done_jobs = {};
+    pthread_mutex_lock(&pool_ptr->mutex);
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&pool_ptr->done_jobs))) {
+        bs_dllist_push_back(&done_jobs, dlnode_ptr);
+    }
+    pthread_mutex_unlock(&pool_ptr->mutex);
+
+    // Callbacks may submit or cancel jobs. Hence: Without holding the mutex.
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&done_jobs))) {
+        _wlmtk_raster_job_hand_back(
+            BS_CONTAINER_OF(dlnode_ptr, wlmtk_raster_job_t, dlnode));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the workers' signal on @ref wlmtk_raster_pool_t::event_fd.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr
+ *
+ * @return 0.
+ */
+int _wlmtk_raster_pool_handle_event_fd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN == errno) return 0;
+    _wlmtk_raster_pool_hand_back(data_ptr);
+    return 0;
+}
+
+/* == Unit tests =========================================================== */
+
+static void test_sync(bs_test_t *test_ptr);
+static void test_async(bs_test_t *test_ptr);
+static void test_cancel(bs_test_t *test_ptr);
+static void test_submit_failure(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlmtk_raster_test_cases[] = {
+    { 1, "sync", test_sync },
+    { 1, "async", test_async },
+    { 1, "cancel", test_cancel },
+    { 1, "submit_failure", test_submit_failure },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmtk_raster_test_set = BS_TEST_SET(
+    true, "raster", _wlmtk_raster_test_cases);
+
+/** Arguments for @ref _wlmtk_raster_test_draw. */
+typedef struct {
+    /** Color to fill the buffer with. */
+    uint32_t                  color;
+    /** Incremented by @ref _wlmtk_raster_test_args_fini. Not owned. */
+    int                       *fini_calls_ptr;
+} _wlmtk_raster_test_args_t;
+
+/** Outcome of a test job. */
+typedef struct {
+    /** Number of calls to @ref _wlmtk_raster_test_done. */
+    int                       calls;
+    /** Color of the first pixel of the handed-back buffer. */
+    uint32_t                  color;
+} _wlmtk_raster_test_result_t;
+
+/* ------------------------------------------------------------------------- */
+/** Test draw function: Fills with the color. */
+static bool _wlmtk_raster_test_draw(cairo_t *cairo_ptr, void *args_ptr)
+{
+    _wlmtk_raster_test_args_t *a = args_ptr;
+    cairo_set_source_argb8888(cairo_ptr, a->color);
+    cairo_paint(cairo_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test args release: Counts calls. */
+static void _wlmtk_raster_test_args_fini(void *args_ptr)
+{
+    _wlmtk_raster_test_args_t *a = args_ptr;
+    ++*a->fini_calls_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test done function: Records the color, and releases the buffer. */
+static void _wlmtk_raster_test_done(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    _wlmtk_raster_test_result_t *r = ud_ptr;
+    ++r->calls;
+    if (NULL == wlr_buffer_ptr) return;
+    r->color = bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr)->data_ptr[0];
+    wlr_buffer_drop(wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises the synchronous mode. */
+void test_sync(bs_test_t *test_ptr)
+{
+    int fini_calls = 0;
+    _wlmtk_raster_test_args_t args = {
+        .color = 0xff204080, .fini_calls_ptr = &fini_calls };
+    _wlmtk_raster_test_result_t r = {};
+    wlmtk_raster_job_t *job_ptr;
+
+    // No pool: Handed back right away.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_raster_pool_submit(
+            NULL, 4, 2, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &r, &job_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, r.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff204080, r.color);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fini_calls);
+
+    // A pool without event loop is synchronous, too.
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(NULL, 4);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    args.color = 0xff102030;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_raster_pool_submit(
+            pool_ptr, 4, 2, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &r, &job_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, r.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff102030, r.color);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, fini_calls);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 1, wlmtk_raster_pool_submitted_jobs(pool_ptr));
+    wlmtk_raster_pool_destroy(pool_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Exercises drawing on workers, and handing back through the event loop. */
+void test_async(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 3);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+
+    int fini_calls = 0;
+    _wlmtk_raster_test_result_t r[16] = {};
+    for (int i = 0; i < 16; ++i) {
+        _wlmtk_raster_test_args_t args = {
+            .color = 0xff000000 | i, .fini_calls_ptr = &fini_calls };
+        wlmtk_raster_job_t *job_ptr;
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlmtk_raster_pool_submit(
+                pool_ptr, 64, 64, _wlmtk_raster_test_draw, &args, sizeof(args),
+                _wlmtk_raster_test_args_fini,
+                _wlmtk_raster_test_done, &r[i], &job_ptr));
+        BS_TEST_VERIFY_NEQ(test_ptr, NULL, job_ptr);
+    }
+    // Nothing is handed back before the event loop dispatches.
+    for (int i = 0; i < 16; ++i) BS_TEST_VERIFY_EQ(test_ptr, 0, r[i].calls);
+
+    for (int attempts = 0; attempts < 100 && 16 > fini_calls; ++attempts) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 16, fini_calls);
+    for (int i = 0; i < 16; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, 1, r[i].calls);
+        BS_TEST_VERIFY_EQ(test_ptr, 0xff000000 | i, r[i].color);
+    }
+
+    // Destroying the pool hands back what is still pending.
+    _wlmtk_raster_test_args_t args = {
+        .color = 0xff405060, .fini_calls_ptr = &fini_calls };
+    _wlmtk_raster_test_result_t pending_r = {};
+    wlmtk_raster_job_t *job_ptr;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_raster_pool_submit(
+            pool_ptr, 64, 64, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &pending_r, &job_ptr));
+    wlmtk_raster_pool_destroy(pool_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, pending_r.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0xff405060, pending_r.color);
+    BS_TEST_VERIFY_EQ(test_ptr, 17, fini_calls);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Verifies cancelled jobs are not handed back, but release resources. */
+void test_cancel(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    int fini_calls = 0;
+    _wlmtk_raster_test_args_t args = {
+        .color = 0xff405060, .fini_calls_ptr = &fini_calls };
+    _wlmtk_raster_test_result_t r[8] = {};
+    wlmtk_raster_job_t *jobs[8];
+    for (int i = 0; i < 8; ++i) {
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlmtk_raster_submit(
+                256, 256, _wlmtk_raster_test_draw, &args, sizeof(args),
+                _wlmtk_raster_test_args_fini,
+                _wlmtk_raster_test_done, &r[i], &jobs[i]));
+    }
+    // Cancel every other job. Some may be queued, running, or done.
+    for (int i = 0; i < 8; i += 2) wlmtk_raster_job_cancel(jobs[i]);
+
+    for (int attempts = 0; attempts < 100 && 8 > fini_calls; ++attempts) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 8, fini_calls);
+    for (int i = 0; i < 8; ++i) {
+        BS_TEST_VERIFY_EQ(test_ptr, i % 2, r[i].calls);
+    }
+
+    // Destroying the pool resets the default.
+    wlmtk_raster_pool_destroy(pool_ptr);
+    wlmtk_raster_job_t *job_ptr;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_raster_submit(
+            4, 4, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &r[0], &job_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, r[0].calls);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A failed submission neither hands back, nor releases the arguments. */
+void test_submit_failure(bs_test_t *test_ptr)
+{
+    int fini_calls = 0;
+    _wlmtk_raster_test_args_t args = {
+        .color = 0xff405060, .fini_calls_ptr = &fini_calls };
+    _wlmtk_raster_test_result_t r = {};
+    wlmtk_raster_job_t *job_ptr;
+
+    wlmtk_raster_test_fail_submissions(1);
+    BS_TEST_VERIFY_FALSE(
+        test_ptr,
+        wlmtk_raster_pool_submit(
+            NULL, 4, 2, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &r, &job_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, r.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, fini_calls);
+
+    // The injected failure is used up.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_raster_pool_submit(
+            NULL, 4, 2, _wlmtk_raster_test_draw, &args, sizeof(args),
+            _wlmtk_raster_test_args_fini,
+            _wlmtk_raster_test_done, &r, &job_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, r.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, fini_calls);
+}
+
+/* == End of raster.c ====================================================== */
@@ -0,0 +1,44 @@
+/* ========================================================================= */
+/**
+ * @file raster_internal.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMTK_RASTER_INTERNAL_H__
+#define __WLMTK_RASTER_INTERNAL_H__
+
+/*
+ * Toolkit-internal: For unit tests of the toolkit. Not installed.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Unit test injector: Makes the next `failures` submissions fail, as if the
+ * job's buffer could not be created.
+ *
+ * @param failures
+ */
+void wlmtk_raster_test_fail_submissions(unsigned failures);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMTK_RASTER_INTERNAL_H__ */
+/* == End of raster_internal.h ============================================= */
@@ -21,12 +21,10 @@
 
 #include "resizebar.h"
 
-#include <cairo.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <stdlib.h>
 #include <toolkit/box.h>
-#include <toolkit/primitives.h>
 #include <toolkit/resizebar_area.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
@@ -47,9 +45,6 @@ struct _wlmtk_resizebar_t {
     /** Style of the resize bar. */
     const struct wlmtk_resizebar_style *style_ptr;
 
-    /** Background. */
-    bs_gfxbuf_t               *gfxbuf_ptr;
-
     /** Left element of the resizebar. */
     wlmtk_resizebar_area_t    *left_area_ptr;
     /** Center element of the resizebar. */
@@ -63,10 +58,6 @@ static bool _wlmtk_resizebar_redraw(
     wlmtk_resizebar_t *resizebar_ptr,
     const struct wlmtk_resizebar_style *style_ptr,
     unsigned width);
-static bool redraw_buffers(
-    wlmtk_resizebar_t *resizebar_ptr,
-    const struct wlmtk_resizebar_style *style_ptr,
-    unsigned width);
 
 /* == Data ================================================================= */
 
@@ -173,11 +164,6 @@ void wlmtk_resizebar_destroy(wlmtk_resizebar_t *resizebar_ptr)
         resizebar_ptr->left_area_ptr = NULL;
     }
 
-    if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
-        resizebar_ptr->gfxbuf_ptr = NULL;
-    }
-
     wlmtk_box_fini(&resizebar_ptr->super_box);
     free(resizebar_ptr);
 }
@@ -222,15 +208,16 @@ void _wlmtk_resizebar_element_destroy(wlmtk_element_t *element_ptr)
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the resizebar. */
+/**
+ * Redraws the resizebar. Each area draws its slice of the resizebar's
+ * background, on the rasterization pool.
+ */
 bool _wlmtk_resizebar_redraw(
     wlmtk_resizebar_t *resizebar_ptr,
     const struct wlmtk_resizebar_style *style_ptr,
     unsigned width)
 {
-    if (!redraw_buffers(resizebar_ptr, style_ptr, width)) return false;
-    BS_ASSERT(width == resizebar_ptr->width);
-    BS_ASSERT(width == resizebar_ptr->gfxbuf_ptr->width);
+    resizebar_ptr->width = width;
 
     int right_corner_width = BS_MIN((int)width, (int)style_ptr->corner_width);
     int left_corner_width = BS_MAX(0, BS_MIN((int)width - right_corner_width,
@@ -240,21 +227,21 @@ bool _wlmtk_resizebar_redraw(
 
     if (!wlmtk_resizebar_area_redraw(
             resizebar_ptr->left_area_ptr,
-            resizebar_ptr->gfxbuf_ptr,
+            width,
             0, left_corner_width,
             style_ptr)) {
         return false;
     }
     if (!wlmtk_resizebar_area_redraw(
             resizebar_ptr->center_area_ptr,
-            resizebar_ptr->gfxbuf_ptr,
+            width,
             left_corner_width, center_width,
             style_ptr)) {
         return false;
     }
     if (!wlmtk_resizebar_area_redraw(
             resizebar_ptr->right_area_ptr,
-            resizebar_ptr->gfxbuf_ptr,
+            width,
             left_corner_width + center_width, right_corner_width,
             style_ptr)) {
         return false;
@@ -276,32 +263,6 @@ bool _wlmtk_resizebar_redraw(
     return true;
 }
 
-/* ------------------------------------------------------------------------- */
-/** Redraws the resizebar's background in appropriate size. */
-bool redraw_buffers(wlmtk_resizebar_t *resizebar_ptr,
-                    const struct wlmtk_resizebar_style *style_ptr,
-                    unsigned width)
-{
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(width, style_ptr->height);
-    if (NULL == gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
-    cairo_destroy(cairo_ptr);
-
-    if (NULL != resizebar_ptr->gfxbuf_ptr) {
-        bs_gfxbuf_destroy(resizebar_ptr->gfxbuf_ptr);
-    }
-    resizebar_ptr->gfxbuf_ptr = gfxbuf_ptr;
-    resizebar_ptr->width = width;
-    return true;
-}
-
 /* == Unit tests =========================================================== */
 
 static void test_variable_width(bs_test_t *test_ptr);
@@ -339,7 +300,8 @@ void test_variable_width(bs_test_t *test_ptr)
     // Not enough space for the center element with all margins.
     BS_TEST_VERIFY_TRUE(
         test_ptr, wlmtk_resizebar_set_width(resizebar_ptr, 33));
-    BS_TEST_VERIFY_EQ(test_ptr, 10, resizebar_ptr->gfxbuf_ptr->height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 10, wlmtk_element_get_dimensions_box(left_elem_ptr).height);
     BS_TEST_VERIFY_TRUE(test_ptr, left_elem_ptr->visible);
     BS_TEST_VERIFY_FALSE(test_ptr, center_elem_ptr->visible);
     BS_TEST_VERIFY_TRUE(test_ptr, right_elem_ptr->visible);
@@ -349,7 +311,8 @@ void test_variable_width(bs_test_t *test_ptr)
     style = (struct wlmtk_resizebar_style){ .height = 7, .corner_width = 16 };
     BS_TEST_VERIFY_TRUE(
         test_ptr, wlmtk_resizebar_set_style(resizebar_ptr, &style));
-    BS_TEST_VERIFY_EQ(test_ptr, 7, resizebar_ptr->gfxbuf_ptr->height);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 7, wlmtk_element_get_dimensions_box(left_elem_ptr).height);
     BS_TEST_VERIFY_TRUE(
         test_ptr, wlmtk_resizebar_set_width(resizebar_ptr, 33));
     BS_TEST_VERIFY_TRUE(test_ptr, left_elem_ptr->visible);
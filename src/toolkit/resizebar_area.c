@@ -39,6 +39,7 @@
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
 #include "primitives.h"
+#include "raster.h"
 #include "resizebar.h"
 #include "test.h"  // IWYU pragma: keep
 #include "tile.h"
@@ -47,6 +48,16 @@
 
 /* == Declarations ========================================================= */
 
+/** A buffer of the resizebar area, and the job drawing it. */
+typedef struct {
+    /** Back-link to the resizebar area. */
+    wlmtk_resizebar_area_t    *resizebar_area_ptr;
+    /** The drawn buffer. NULL if not drawn (yet). */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Pending job drawing the buffer, or NULL. */
+    wlmtk_raster_job_t        *job_ptr;
+} wlmtk_resizebar_area_slot_t;
+
 /** State of an element of the resize bar. */
 struct _wlmtk_resizebar_area_t {
     /** Superclass: Buffer. */
@@ -54,10 +65,10 @@ struct _wlmtk_resizebar_area_t {
     /** Original virtual method table of the superclass element. */
     wlmtk_element_vmt_t       orig_super_element_vmt;
 
-    /** WLR buffer holding the buffer in released state. */
-    struct wlr_buffer         *released_wlr_buffer_ptr;
-    /** WLR buffer holding the buffer in pressed state. */
-    struct wlr_buffer         *pressed_wlr_buffer_ptr;
+    /** Buffer in released state. */
+    wlmtk_resizebar_area_slot_t released_slot;
+    /** Buffer in pressed state. */
+    wlmtk_resizebar_area_slot_t pressed_slot;
 
     /** Whether the area is currently pressed or not. */
     bool                      pressed;
@@ -74,13 +85,27 @@ static bool _wlmtk_resizebar_area_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr);
 
+/** Arguments for @ref draw_buffer. Copied into the job. */
+typedef struct {
+    /** Copy of the resizebar's style. */
+    struct wlmtk_resizebar_style style;
+    /** Width of the resizebar. */
+    unsigned                  resizebar_width;
+    /** Position of the area, relative to the resizebar. */
+    unsigned                  position;
+    /** Width of the area. */
+    unsigned                  width;
+    /** Whether to draw the area as pressed. */
+    bool                      pressed;
+} wlmtk_resizebar_area_draw_args_t;
+
 static void draw_state(wlmtk_resizebar_area_t *resizebar_area_ptr);
-static struct wlr_buffer *create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
-    unsigned width,
-    const struct wlmtk_resizebar_style *style_ptr,
-    bool pressed);
+static bool submit(
+    wlmtk_resizebar_area_slot_t *slot_ptr,
+    const wlmtk_resizebar_area_draw_args_t *args_ptr);
+static void slot_fini(wlmtk_resizebar_area_slot_t *slot_ptr);
+static void handle_drawn(struct wlr_buffer *wlr_buffer_ptr, void *ud_ptr);
+static bool draw_buffer(cairo_t *cairo_ptr, void *args_ptr);
 
 /* ========================================================================= */
 
@@ -103,6 +128,8 @@ wlmtk_resizebar_area_t *wlmtk_resizebar_area_create(
     BS_ASSERT(NULL != window_ptr);
     resizebar_area_ptr->window_ptr = window_ptr;
     resizebar_area_ptr->edges = edges;
+    resizebar_area_ptr->released_slot.resizebar_area_ptr = resizebar_area_ptr;
+    resizebar_area_ptr->pressed_slot.resizebar_area_ptr = resizebar_area_ptr;
 
     wlmtk_pointer_cursor_t cursor = WLMTK_POINTER_CURSOR_DEFAULT;
     switch (resizebar_area_ptr->edges) {
@@ -136,10 +163,8 @@ wlmtk_resizebar_area_t *wlmtk_resizebar_area_create(
 void wlmtk_resizebar_area_destroy(
     wlmtk_resizebar_area_t *resizebar_area_ptr)
 {
-    wlr_buffer_drop_nullify(
-        &resizebar_area_ptr->released_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(
-        &resizebar_area_ptr->pressed_wlr_buffer_ptr);
+    slot_fini(&resizebar_area_ptr->released_slot);
+    slot_fini(&resizebar_area_ptr->pressed_slot);
 
     wlmtk_buffer_fini(&resizebar_area_ptr->super_buffer);
     free(resizebar_area_ptr);
@@ -148,32 +173,25 @@ void wlmtk_resizebar_area_destroy(
 /* ------------------------------------------------------------------------- */
 bool wlmtk_resizebar_area_redraw(
     wlmtk_resizebar_area_t *resizebar_area_ptr,
-    bs_gfxbuf_t *gfxbuf_ptr,
+    unsigned resizebar_width,
     unsigned position,
     unsigned width,
     const struct wlmtk_resizebar_style *style_ptr)
 {
-    struct wlr_buffer *released_wlr_buffer_ptr = create_buffer(
-        gfxbuf_ptr, position, width, style_ptr, false);
-    struct wlr_buffer *pressed_wlr_buffer_ptr = create_buffer(
-        gfxbuf_ptr, position, width, style_ptr, true);
-
-    if (NULL == released_wlr_buffer_ptr ||
-        NULL == pressed_wlr_buffer_ptr) {
-        wlr_buffer_drop_nullify(&released_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(&pressed_wlr_buffer_ptr);
-        return false;
-    }
-
-    wlr_buffer_drop_nullify(
-        &resizebar_area_ptr->released_wlr_buffer_ptr);
-    resizebar_area_ptr->released_wlr_buffer_ptr = released_wlr_buffer_ptr;
-    wlr_buffer_drop_nullify(
-        &resizebar_area_ptr->pressed_wlr_buffer_ptr);
-    resizebar_area_ptr->pressed_wlr_buffer_ptr = pressed_wlr_buffer_ptr;
+    BS_ASSERT(position + width <= resizebar_width);
+    wlmtk_resizebar_area_draw_args_t args = {
+        .style = *style_ptr,
+        .resizebar_width = resizebar_width,
+        .position = position,
+        .width = width,
+    };
 
-    draw_state(resizebar_area_ptr);
-    return true;
+    // The previous buffers are shown, and scaled, until replaced.
+    wlmtk_buffer_set_dimensions(
+        &resizebar_area_ptr->super_buffer, width, style_ptr->height);
+    if (!submit(&resizebar_area_ptr->released_slot, &args)) return false;
+    args.pressed = true;
+    return submit(&resizebar_area_ptr->pressed_slot, &args);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -230,7 +248,7 @@ bool _wlmtk_resizebar_area_element_pointer_button(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Draws the buffer in current state (released or pressed).
+ * Sets the buffer in current state (released or pressed).
  *
  * @param resizebar_area_ptr
  */
@@ -239,61 +257,115 @@ void draw_state(wlmtk_resizebar_area_t *resizebar_area_ptr)
     if (!resizebar_area_ptr->pressed) {
         wlmtk_buffer_set(
             &resizebar_area_ptr->super_buffer,
-            resizebar_area_ptr->released_wlr_buffer_ptr);
+            resizebar_area_ptr->released_slot.wlr_buffer_ptr);
     } else {
         wlmtk_buffer_set(
             &resizebar_area_ptr->super_buffer,
-            resizebar_area_ptr->pressed_wlr_buffer_ptr);
+            resizebar_area_ptr->pressed_slot.wlr_buffer_ptr);
     }
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a resizebar area texture.
+ * Submits a job to (re)draw the buffer of `slot_ptr`. Cancels a pending job
+ * for that slot. The slot keeps its previous buffer until the job is done.
  *
- * @param gfxbuf_ptr
- * @param position
- * @param width
- * @param style_ptr
- * @param pressed
+ * @param slot_ptr
+ * @param args_ptr
  *
- * @return A pointer to a newly allocated `struct wlr_buffer`.
+ * @return true on success.
  */
-struct wlr_buffer *create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
-    unsigned width,
-    const struct wlmtk_resizebar_style *style_ptr,
-    bool pressed)
+bool submit(
+    wlmtk_resizebar_area_slot_t *slot_ptr,
+    const wlmtk_resizebar_area_draw_args_t *args_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        width, style_ptr->height);
-    if (NULL == wlr_buffer_ptr) return NULL;
-
-    bs_gfxbuf_copy_area(
-        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
-        gfxbuf_ptr, position, 0, width, style_ptr->height);
-
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return false;
+    if (NULL != slot_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(slot_ptr->job_ptr);
+        slot_ptr->job_ptr = NULL;
+    }
+    return wlmtk_raster_submit(
+        args_ptr->width,
+        args_ptr->style.height,
+        draw_buffer,
+        args_ptr, sizeof(*args_ptr),
+        NULL,
+        handle_drawn,
+        slot_ptr,
+        &slot_ptr->job_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Cancels the slot's pending job, and releases its buffer. */
+void slot_fini(wlmtk_resizebar_area_slot_t *slot_ptr)
+{
+    if (NULL != slot_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(slot_ptr->job_ptr);
+        slot_ptr->job_ptr = NULL;
+    }
+    wlr_buffer_drop_nullify(&slot_ptr->wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the buffer drawn by @ref submit, stores it in the slot and updates
+ * the area's buffer.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref wlmtk_resizebar_area_slot_t.
+ */
+void handle_drawn(struct wlr_buffer *wlr_buffer_ptr, void *ud_ptr)
+{
+    wlmtk_resizebar_area_slot_t *slot_ptr = ud_ptr;
+    slot_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw resizebar area %p",
+               slot_ptr->resizebar_area_ptr);
+        return;
     }
-    wlmaker_primitives_draw_bezel_at(
-        cairo_ptr, 0, 0, width,
-        style_ptr->height, style_ptr->bezel_width, !pressed);
-    cairo_destroy(cairo_ptr);
 
-    return wlr_buffer_ptr;
+    wlr_buffer_drop_nullify(&slot_ptr->wlr_buffer_ptr);
+    slot_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    draw_state(slot_ptr->resizebar_area_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the area, on its slice of the
+ * resizebar's background. Runs on a worker thread, and must only access the
+ * arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmtk_resizebar_area_draw_args_t.
+ *
+ * @return true.
+ */
+bool draw_buffer(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmtk_resizebar_area_draw_args_t *args = args_ptr;
+    const struct wlmtk_resizebar_style *style_ptr = &args->style;
+
+    cairo_save(cairo_ptr);
+    cairo_translate(cairo_ptr, -(double)args->position, 0);
+    wlmaker_primitives_cairo_fill_at(
+        cairo_ptr, 0, 0, args->resizebar_width, style_ptr->height,
+        &style_ptr->fill);
+    cairo_restore(cairo_ptr);
+
+    wlmaker_primitives_draw_bezel_at(
+        cairo_ptr, 0, 0, args->width,
+        style_ptr->height, style_ptr->bezel_width, !args->pressed);
+    return true;
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_area(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_resizebar_area_test_cases[] = {
     { 1, "area", test_area },
+    { 1, "deferred", test_deferred },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -333,13 +405,17 @@ void test_area(bs_test_t *test_ptr)
     wlmtk_element_set_visible(element_ptr, true);
 
     // Draw and verify release state.
-    struct wlmtk_resizebar_style style = { .height = 7, .bezel_width = 1.0 };
-    bs_gfxbuf_t *gfxbuf_ptr = bs_gfxbuf_create(30, 7);
-    bs_gfxbuf_clear(gfxbuf_ptr, 0xff604020);
+    struct wlmtk_resizebar_style style = {
+        .fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff604020 } }
+        },
+        .height = 7,
+        .bezel_width = 1.0
+    };
     BS_TEST_VERIFY_TRUE(
         test_ptr,
-        wlmtk_resizebar_area_redraw(area_ptr, gfxbuf_ptr, 10, 12, &style));
-    bs_gfxbuf_destroy(gfxbuf_ptr);
+        wlmtk_resizebar_area_redraw(area_ptr, 30, 10, 12, &style));
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(area_ptr->super_buffer.wlr_buffer_ptr),
@@ -376,4 +452,65 @@ void test_area(bs_test_t *test_ptr)
     wl_display_destroy(display_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests drawing on the rasterization pool: Buffers show once handed back. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wlmtk_resizebar_style style = {
+        .fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff604020 } }
+        },
+        .height = 7,
+    };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    wlmtk_window_t *w = wlmtk_test_window_create(NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    wlmtk_resizebar_area_t *area_ptr = wlmtk_resizebar_area_create(
+        w, WLR_EDGE_BOTTOM);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, area_ptr);
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &area_ptr->super_buffer.wlr_buffer_ptr;
+
+    // No buffer until the jobs are handed back.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_resizebar_area_redraw(area_ptr, 30, 10, 12, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, area_ptr->released_slot.job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+
+    // The style changes while the jobs are pending: The new style is shown.
+    style.fill.param.solid.color = 0xff206040;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_resizebar_area_redraw(area_ptr, 30, 10, 12, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(wl_event_loop_ptr, wlr_buffer_ptr_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, area_ptr->released_slot.job_ptr);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(*wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff206040, g->data_ptr[3 * g->pixels_per_line + 5]);
+
+    // Destroying the area cancels its pending jobs. Destroying the pool
+    // then hands back all jobs: The cancelled ones must not be applied.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_resizebar_area_redraw(area_ptr, 30, 10, 12, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, area_ptr->pressed_slot.job_ptr);
+    wlmtk_resizebar_area_destroy(area_ptr);
+    wlmtk_raster_pool_destroy(pool_ptr);
+
+    wlmtk_window_destroy(w);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of resizebar_area.c ============================================== */
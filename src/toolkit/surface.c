@@ -22,6 +22,7 @@
 #include "surface.h"
 
 #include <libbase/libbase.h>
+#include <pixman.h>
 #include <stdlib.h>
 #include <wayland-server-protocol.h>
 #include <wayland-util.h>
@@ -249,6 +250,24 @@ bool wlmtk_surface_is_activated(wlmtk_surface_t *surface_ptr)
     return surface_ptr->activated;
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_surface_is_opaque(wlmtk_surface_t *surface_ptr)
+{
+    struct wlr_surface *wlr_surface_ptr = surface_ptr->wlr_surface_ptr;
+    if (NULL == wlr_surface_ptr ||
+        0 >= wlr_surface_ptr->current.width ||
+        0 >= wlr_surface_ptr->current.height) return false;
+
+    pixman_box32_t box = {
+        .x1 = 0,
+        .y1 = 0,
+        .x2 = wlr_surface_ptr->current.width,
+        .y2 = wlr_surface_ptr->current.height
+    };
+    return PIXMAN_REGION_IN == pixman_region32_contains_rectangle(
+        &wlr_surface_ptr->opaque_region, &box);
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_surface_connect_map_listener_signal(
     wlmtk_surface_t *surface_ptr,
@@ -47,4 +47,15 @@ void wlmtk_test_wlr_output_init(struct wlr_output *wlr_output_ptr)
     wl_signal_init(&wlr_output_ptr->events.request_state);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmtk_test_wait_for_buffer(
+    struct wl_event_loop *wl_event_loop_ptr,
+    struct wlr_buffer **wlr_buffer_ptr_ptr)
+{
+    for (int i = 0; i < 100 && NULL == *wlr_buffer_ptr_ptr; ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 10);
+    }
+    return NULL != *wlr_buffer_ptr_ptr;
+}
+
 /* == End of test.c ======================================================== */
@@ -25,16 +25,62 @@
 #include <inttypes.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
+#include <stdlib.h>
 #include <string.h>
+#include <wayland-server-core.h>
 
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "primitives.h"
+#include "raster.h"
 #include "style.h"
+#include "test.h"  // IWYU pragma: keep
+#include "util.h"
 
 /* == Declarations ========================================================= */
 
-static struct wlr_buffer *_wlmtk_tile_create_buffer(
+/**
+ * A tile background, shared between all tiles of equal fill, size and bezel.
+ *
+ * Tiles of the dock, clip and icons all use the same style, so there's
+ * typically just one or two of these.
+ */
+struct _wlmtk_tile_background_t {
+    /** Element of @ref _wlmtk_tile_backgrounds. */
+    bs_dllist_node_t          dlnode;
+    /** Fill of the background. */
+    wlmtk_style_fill_t        fill;
+    /** Width and height of the background, in pixels. */
+    uint64_t                  size;
+    /** Width of the bezel. */
+    uint64_t                  bezel_width;
+    /** The drawn background. NULL while the job is pending. */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Pending job drawing the background, or NULL. */
+    wlmtk_raster_job_t        *job_ptr;
+    /** Signals when the job handed back the buffer. */
+    struct wl_signal          drawn_event;
+    /** Number of tiles referencing this background. */
+    unsigned                  references;
+};
+
+static wlmtk_tile_background_t *_wlmtk_tile_background_acquire(
+    const struct wlmtk_tile_style *style_ptr);
+static void _wlmtk_tile_background_release(
+    wlmtk_tile_background_t *background_ptr);
+static bool _wlmtk_tile_background_matches(
+    const wlmtk_tile_background_t *background_ptr,
     const struct wlmtk_tile_style *style_ptr);
+static bool _wlmtk_tile_fill_equals(
+    const wlmtk_style_fill_t *f1_ptr,
+    const wlmtk_style_fill_t *f2_ptr);
+static void _wlmtk_tile_background_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmtk_tile_draw_background(cairo_t *cairo_ptr, void *args_ptr);
+static bool _wlmtk_tile_apply_background(wlmtk_tile_t *tile_ptr);
+static void _wlmtk_tile_handle_background_drawn(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 static void _wlmtk_tile_align_content(wlmtk_tile_t *tile_ptr);
 
 /* == Data ================================================================= */
@@ -54,6 +100,9 @@ const bspl_desc_t wlmtk_tile_style_desc[] = {
     BSPL_DESC_SENTINEL()
 };
 
+/** Backgrounds currently in use, see @ref _wlmtk_tile_background_t. */
+static bs_dllist_t _wlmtk_tile_backgrounds;
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -77,14 +126,13 @@ bool wlmtk_tile_init(
         &tile_ptr->super_container,
         wlmtk_buffer_element(&tile_ptr->buffer));
 
-    struct wlr_buffer *wlr_buffer_ptr = _wlmtk_tile_create_buffer(
+    tile_ptr->background_ptr = _wlmtk_tile_background_acquire(
         &tile_ptr->style);
-    if (NULL == wlr_buffer_ptr) {
+    if (NULL == tile_ptr->background_ptr) {
         wlmtk_tile_fini(tile_ptr);
         return false;
     }
-    wlmtk_tile_set_background_buffer(tile_ptr, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
+    _wlmtk_tile_apply_background(tile_ptr);
 
     return true;
 }
@@ -105,10 +153,15 @@ wlmtk_tile_vmt_t wlmtk_tile_extend(
 /* ------------------------------------------------------------------------- */
 void wlmtk_tile_fini(wlmtk_tile_t *tile_ptr)
 {
+    wlmtk_util_disconnect_listener(&tile_ptr->background_drawn_listener);
     if (NULL != tile_ptr->background_wlr_buffer_ptr) {
         wlr_buffer_unlock(tile_ptr->background_wlr_buffer_ptr);
         tile_ptr->background_wlr_buffer_ptr = NULL;
     }
+    if (NULL != tile_ptr->background_ptr) {
+        _wlmtk_tile_background_release(tile_ptr->background_ptr);
+        tile_ptr->background_ptr = NULL;
+    }
 
     if (wlmtk_buffer_element(&tile_ptr->buffer)->parent_container_ptr) {
         wlmtk_container_remove_element(
@@ -124,14 +177,18 @@ void wlmtk_tile_fini(wlmtk_tile_t *tile_ptr)
 bool wlmtk_tile_set_style(wlmtk_tile_t *tile_ptr,
                           const struct wlmtk_tile_style *style_ptr)
 {
-    // Update buffer.
-    struct wlr_buffer *wlr_buffer_ptr = _wlmtk_tile_create_buffer(style_ptr);
-    if (NULL == wlr_buffer_ptr) return false;
+    // Update buffer. Acquire first, so an unchanged style is not re-drawn.
+    wlmtk_tile_background_t *background_ptr = _wlmtk_tile_background_acquire(
+        style_ptr);
+    if (NULL == background_ptr) return false;
+    wlmtk_util_disconnect_listener(&tile_ptr->background_drawn_listener);
+    if (NULL != tile_ptr->background_ptr) {
+        _wlmtk_tile_background_release(tile_ptr->background_ptr);
+    }
+    tile_ptr->background_ptr = background_ptr;
 
     tile_ptr->style = *style_ptr;
-    bool rv = wlmtk_tile_set_background_buffer(tile_ptr, wlr_buffer_ptr);
-    wlr_buffer_drop(wlr_buffer_ptr);
-    if (!rv) return false;
+    if (!_wlmtk_tile_apply_background(tile_ptr)) return false;
 
     if (NULL != tile_ptr->vmt.set_content_size) {
         tile_ptr->vmt.set_content_size(tile_ptr, style_ptr->content_size);
@@ -150,6 +207,8 @@ bool wlmtk_tile_set_background_buffer(
     if (tile_ptr->style.size != (uint64_t)wlr_buffer_ptr->width ||
         tile_ptr->style.size != (uint64_t)wlr_buffer_ptr->height) return false;
 
+    // An explicitly set background supersedes a still pending one.
+    wlmtk_util_disconnect_listener(&tile_ptr->background_drawn_listener);
     if (NULL != tile_ptr->background_wlr_buffer_ptr) {
         wlr_buffer_unlock(tile_ptr->background_wlr_buffer_ptr);
     }
@@ -237,25 +296,205 @@ bs_dllist_node_t *wlmtk_dlnode_from_tile(wlmtk_tile_t *tile_ptr)
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
-/** Crates a wlr_buffer with background, as described in `style_ptr`. */
-struct wlr_buffer *_wlmtk_tile_create_buffer(
+/**
+ * Looks up the background matching `style_ptr`, or creates it.
+ *
+ * @param style_ptr
+ *
+ * @return A reference to the background, or NULL on error. Must be released
+ *     by @ref _wlmtk_tile_background_release.
+ */
+wlmtk_tile_background_t *_wlmtk_tile_background_acquire(
     const struct wlmtk_tile_style *style_ptr)
 {
-    struct wlr_buffer* wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        style_ptr->size, style_ptr->size);
-    if (NULL == wlr_buffer_ptr) return NULL;
+    for (bs_dllist_node_t *dlnode_ptr = _wlmtk_tile_backgrounds.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmtk_tile_background_t *background_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmtk_tile_background_t, dlnode);
+        if (_wlmtk_tile_background_matches(background_ptr, style_ptr)) {
+            ++background_ptr->references;
+            return background_ptr;
+        }
+    }
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
+    wlmtk_tile_background_t *background_ptr = logged_calloc(
+        1, sizeof(wlmtk_tile_background_t));
+    if (NULL == background_ptr) return NULL;
+    background_ptr->fill = style_ptr->fill;
+    background_ptr->size = style_ptr->size;
+    background_ptr->bezel_width = style_ptr->bezel_width;
+    wl_signal_init(&background_ptr->drawn_event);
+    if (!wlmtk_raster_submit(
+            style_ptr->size, style_ptr->size,
+            _wlmtk_tile_draw_background,
+            style_ptr, sizeof(*style_ptr),
+            NULL,
+            _wlmtk_tile_background_handle_drawn,
+            background_ptr,
+            &background_ptr->job_ptr) ||
+        (NULL == background_ptr->job_ptr &&
+         NULL == background_ptr->wlr_buffer_ptr)) {
+        free(background_ptr);
         return NULL;
     }
+    background_ptr->references = 1;
+    bs_dllist_push_back(&_wlmtk_tile_backgrounds, &background_ptr->dlnode);
+    return background_ptr;
+}
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Releases a reference to the background. Destroys it, once unreferenced.
+ *
+ * Tiles still showing the buffer hold their own lock on it, so it remains
+ * valid until replaced there.
+ *
+ * @param background_ptr
+ */
+void _wlmtk_tile_background_release(wlmtk_tile_background_t *background_ptr)
+{
+    if (0 < --background_ptr->references) return;
+
+    bs_dllist_remove(&_wlmtk_tile_backgrounds, &background_ptr->dlnode);
+    if (NULL != background_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(background_ptr->job_ptr);
+        background_ptr->job_ptr = NULL;
+    }
+    wlr_buffer_drop_nullify(&background_ptr->wlr_buffer_ptr);
+    free(background_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Whether `background_ptr` is what `style_ptr` would draw. */
+bool _wlmtk_tile_background_matches(
+    const wlmtk_tile_background_t *background_ptr,
+    const struct wlmtk_tile_style *style_ptr)
+{
+    return (background_ptr->size == style_ptr->size &&
+            background_ptr->bezel_width == style_ptr->bezel_width &&
+            _wlmtk_tile_fill_equals(&background_ptr->fill, &style_ptr->fill));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Compares the fills. Considers only the union member used by the type, so
+ * that stale values in the remainder of the union don't matter.
+ *
+ * @return Whether `f1_ptr` and `f2_ptr` draw the same.
+ */
+bool _wlmtk_tile_fill_equals(
+    const wlmtk_style_fill_t *f1_ptr,
+    const wlmtk_style_fill_t *f2_ptr)
+{
+    if (f1_ptr->type != f2_ptr->type) return false;
+
+    switch (f1_ptr->type) {
+    case WLMTK_STYLE_COLOR_SOLID:
+        return f1_ptr->param.solid.color == f2_ptr->param.solid.color;
+    case WLMTK_STYLE_COLOR_HGRADIENT:
+        return (f1_ptr->param.hgradient.from == f2_ptr->param.hgradient.from &&
+                f1_ptr->param.hgradient.to == f2_ptr->param.hgradient.to);
+    case WLMTK_STYLE_COLOR_VGRADIENT:
+        return (f1_ptr->param.vgradient.from == f2_ptr->param.vgradient.from &&
+                f1_ptr->param.vgradient.to == f2_ptr->param.vgradient.to);
+    case WLMTK_STYLE_COLOR_DGRADIENT:
+        return (f1_ptr->param.dgradient.from == f2_ptr->param.dgradient.from &&
+                f1_ptr->param.dgradient.to == f2_ptr->param.dgradient.to);
+    case WLMTK_STYLE_COLOR_ADGRADIENT:
+        return (f1_ptr->param.adgradient.from ==
+                f2_ptr->param.adgradient.from &&
+                f1_ptr->param.adgradient.to == f2_ptr->param.adgradient.to);
+    default:
+        break;
+    }
+    return 0 == memcmp(&f1_ptr->param, &f2_ptr->param, sizeof(f1_ptr->param));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the background drawn by @ref _wlmtk_tile_background_acquire, and
+ * signals the tiles waiting for it.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref _wlmtk_tile_background_t.
+ */
+void _wlmtk_tile_background_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmtk_tile_background_t *background_ptr = ud_ptr;
+    background_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw tile background %p",
+               background_ptr);
+    }
+    background_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    wl_signal_emit(&background_ptr->drawn_event, background_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the background, as described by
+ * the tile style in `args_ptr`. Runs on a worker thread.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a `struct wlmtk_tile_style`.
+ *
+ * @return true.
+ */
+bool _wlmtk_tile_draw_background(cairo_t *cairo_ptr, void *args_ptr)
+{
+    const struct wlmtk_tile_style *style_ptr = args_ptr;
     wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->fill);
     wlmaker_primitives_draw_bezel(cairo_ptr, style_ptr->bezel_width, true);
+    return true;
+}
 
-    cairo_destroy(cairo_ptr);
-    return wlr_buffer_ptr;
+/* ------------------------------------------------------------------------- */
+/**
+ * Applies the tile's shared background. If it is still being drawn, keeps the
+ * current one (scaled to the tile's size) and applies it once handed back.
+ *
+ * @param tile_ptr
+ *
+ * @return false if the background did not match the tile size.
+ */
+bool _wlmtk_tile_apply_background(wlmtk_tile_t *tile_ptr)
+{
+    wlmtk_tile_background_t *background_ptr = tile_ptr->background_ptr;
+    wlmtk_buffer_set_dimensions(
+        &tile_ptr->buffer, tile_ptr->style.size, tile_ptr->style.size);
+    if (NULL != background_ptr->wlr_buffer_ptr) {
+        return wlmtk_tile_set_background_buffer(
+            tile_ptr, background_ptr->wlr_buffer_ptr);
+    }
+
+    wlmtk_util_connect_listener_signal(
+        &background_ptr->drawn_event,
+        &tile_ptr->background_drawn_listener,
+        _wlmtk_tile_handle_background_drawn);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles @ref _wlmtk_tile_background_t::drawn_event: Applies the background.
+ *
+ * @param listener_ptr
+ * @param data_ptr            Points to the @ref _wlmtk_tile_background_t.
+ */
+void _wlmtk_tile_handle_background_drawn(
+    struct wl_listener *listener_ptr,
+    void *data_ptr)
+{
+    wlmtk_tile_t *tile_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_tile_t, background_drawn_listener);
+    wlmtk_tile_background_t *background_ptr = data_ptr;
+
+    wlmtk_util_disconnect_listener(&tile_ptr->background_drawn_listener);
+    if (NULL == background_ptr->wlr_buffer_ptr) return;
+    wlmtk_tile_set_background_buffer(tile_ptr, background_ptr->wlr_buffer_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -280,10 +519,14 @@ void _wlmtk_tile_align_content(wlmtk_tile_t *tile_ptr)
 /* == Unit tests =========================================================== */
 
 static void test_init_fini(bs_test_t *test_ptr);
+static void test_shared(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_tile_test_cases[] = {
     { 1, "init_fini", test_init_fini },
+    { 1, "shared", test_shared },
+    { 1, "deferred", test_deferred },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -316,4 +559,113 @@ static void test_init_fini(bs_test_t *test_ptr)
     wlmtk_tile_fini(&tile);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Verifies tiles of equal style share one background, drawn just once. */
+static void test_shared(bs_test_t *test_ptr)
+{
+    wlmtk_tile_t tiles[16];
+    struct wlmtk_tile_style style = {
+        .fill = { .type = WLMTK_STYLE_COLOR_SOLID,
+                  .param = { .solid = { .color = 0xff102030 } } },
+        .size = 64, .bezel_width = 2 };
+    size_t initial = bs_dllist_size(&_wlmtk_tile_backgrounds);
+
+    for (size_t i = 0; i < 16; ++i) {
+        BS_TEST_VERIFY_TRUE_OR_RETURN(
+            test_ptr, wlmtk_tile_init(&tiles[i], &style));
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, initial + 1, bs_dllist_size(&_wlmtk_tile_backgrounds));
+    struct wlr_buffer *wlr_buffer_ptr = tiles[0].background_wlr_buffer_ptr;
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, wlr_buffer_ptr);
+    for (size_t i = 1; i < 16; ++i) {
+        BS_TEST_VERIFY_EQ(
+            test_ptr, wlr_buffer_ptr, tiles[i].background_wlr_buffer_ptr);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 16, tiles[0].background_ptr->references);
+
+    // A theme change: All tiles move to one new background. The stale union
+    // member of the solid fill must not matter.
+    struct wlmtk_tile_style new_style = style;
+    new_style.fill.param.solid.color = 0xff405060;
+    for (size_t i = 0; i < 16; ++i) {
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, wlmtk_tile_set_style(&tiles[i], &new_style));
+        new_style.fill.param.hgradient.to = i;
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, initial + 1, bs_dllist_size(&_wlmtk_tile_backgrounds));
+    struct wlr_buffer *new_wlr_buffer_ptr = tiles[0].background_wlr_buffer_ptr;
+    BS_TEST_VERIFY_NEQ(test_ptr, wlr_buffer_ptr, new_wlr_buffer_ptr);
+    for (size_t i = 1; i < 16; ++i) {
+        BS_TEST_VERIFY_EQ(
+            test_ptr, new_wlr_buffer_ptr, tiles[i].background_wlr_buffer_ptr);
+    }
+
+    // Re-applying the same style keeps the same buffer.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_set_style(&tiles[0], &new_style));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, new_wlr_buffer_ptr, tiles[0].background_wlr_buffer_ptr);
+
+    // A different size gets its own background.
+    new_style.size = 48;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_set_style(&tiles[0], &new_style));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, initial + 2, bs_dllist_size(&_wlmtk_tile_backgrounds));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, new_wlr_buffer_ptr, tiles[0].background_wlr_buffer_ptr);
+
+    for (size_t i = 0; i < 16; ++i) wlmtk_tile_fini(&tiles[i]);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, initial, bs_dllist_size(&_wlmtk_tile_backgrounds));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests drawing on the rasterization pool: Backgrounds show once drawn. */
+static void test_deferred(bs_test_t *test_ptr)
+{
+    wlmtk_tile_t tile;
+    struct wlmtk_tile_style style = {
+        .fill = { .type = WLMTK_STYLE_COLOR_SOLID,
+                  .param = { .solid = { .color = 0xff203040 } } },
+        .size = 64, .bezel_width = 2 };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    // No background until the job is handed back.
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, wlmtk_tile_init(&tile, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, tile.background_ptr->job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, tile.background_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, tile.buffer.wlr_buffer_ptr);
+
+    // The style changes while the job is pending: The new style is shown.
+    style.fill.param.solid.color = 0xff405060;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_set_style(&tile, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, tile.background_wlr_buffer_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(
+            wl_event_loop_ptr, &tile.background_wlr_buffer_ptr));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, tile.background_wlr_buffer_ptr, tile.buffer.wlr_buffer_ptr);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(tile.background_wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff405060, g->data_ptr[32 * g->pixels_per_line + 32]);
+
+    // Releasing the tile cancels the pending job. Destroying the pool then
+    // hands back all jobs: The cancelled one must not be applied.
+    style.fill.param.solid.color = 0xff607080;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_tile_set_style(&tile, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, tile.background_ptr->job_ptr);
+    wlmtk_tile_fini(&tile);
+    wlmtk_raster_pool_destroy(pool_ptr);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of tile.c ======================================================== */
@@ -21,7 +21,6 @@
 
 #include "titlebar.h"
 
-#include <cairo.h>
 #include <libbase/libbase.h>
 #include <libbase/plist.h>
 #include <stdlib.h>
@@ -52,11 +51,6 @@ struct _wlmtk_titlebar_t {
     /** Close button. */
     wlmtk_titlebar_button_t  *close_button_ptr;
 
-    /** Titlebar background, when focussed. */
-    bs_gfxbuf_t               *focussed_gfxbuf_ptr;
-    /** Titlebar background, when blurred. */
-    bs_gfxbuf_t               *blurred_gfxbuf_ptr;
-
     /** Current width of the title bar. */
     unsigned                  width;
     /** Position of the close button. */
@@ -79,10 +73,6 @@ static void _wlmtk_titlebar_element_destroy(wlmtk_element_t *element_ptr);
 static void _wlmtk_titlebar_compute_positions(
     wlmtk_titlebar_t *titlebar_ptr,
     const struct wlmtk_titlebar_style *style_ptr);
-static bool _wlmtk_titlebar_redraw_buffers(
-    wlmtk_titlebar_t *titlebar_ptr,
-    const struct wlmtk_titlebar_style *style_ptr,
-    unsigned width);
 static bool _wlmtk_titlebar_redraw(
     wlmtk_titlebar_t *titlebar_ptr,
     const struct wlmtk_titlebar_style *style_ptr);
@@ -215,15 +205,6 @@ void wlmtk_titlebar_destroy(wlmtk_titlebar_t *titlebar_ptr)
         titlebar_ptr->titlebar_title_ptr = NULL;
     }
 
-    if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
-        titlebar_ptr->blurred_gfxbuf_ptr = NULL;
-    }
-    if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
-        titlebar_ptr->focussed_gfxbuf_ptr = NULL;
-    }
-
     wlmtk_box_fini(&titlebar_ptr->super_box);
 
     free(titlebar_ptr);
@@ -235,8 +216,7 @@ bool wlmtk_titlebar_set_width(
     unsigned width)
 {
     if (tb->width == width) return true;
-    if (!_wlmtk_titlebar_redraw_buffers(tb, tb->style_ptr, width)) return false;
-    BS_ASSERT(width == tb->width);
+    tb->width = width;
     return _wlmtk_titlebar_redraw(tb, tb->style_ptr);
 }
 
@@ -247,10 +227,7 @@ bool wlmtk_titlebar_set_style(
 {
     wlmtk_box_set_style(&tb->super_box, &style_ptr->margin);
 
-    if (!_wlmtk_titlebar_redraw_buffers(tb, style_ptr, tb->width) ||
-        !_wlmtk_titlebar_redraw(tb, style_ptr)) {
-        return false;
-    }
+    if (!_wlmtk_titlebar_redraw(tb, style_ptr)) return false;
 
     tb->style_ptr = style_ptr;
     return true;
@@ -296,7 +273,9 @@ void wlmtk_titlebar_set_title(
     if (titlebar_ptr->title_ptr == title_ptr) return;
 
     titlebar_ptr->title_ptr = title_ptr;
-    _wlmtk_titlebar_redraw(titlebar_ptr, titlebar_ptr->style_ptr);
+    // Only the title element needs an update. It is redrawn when next shown.
+    wlmtk_titlebar_title_set_title(
+        titlebar_ptr->titlebar_title_ptr, titlebar_ptr->title_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -355,51 +334,10 @@ void _wlmtk_titlebar_compute_positions(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Redraws the titlebar's background in appropriate size. */
-bool _wlmtk_titlebar_redraw_buffers(
-    wlmtk_titlebar_t *titlebar_ptr,
-    const struct wlmtk_titlebar_style *style_ptr,
-    unsigned width)
-{
-    cairo_t *cairo_ptr;
-
-    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(
-        width, style_ptr->height);
-    if (NULL == focussed_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(focussed_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->focussed_fill);
-    cairo_destroy(cairo_ptr);
-
-    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(
-        width, style_ptr->height);
-    if (NULL == blurred_gfxbuf_ptr) return false;
-    cairo_ptr = cairo_create_from_bs_gfxbuf(blurred_gfxbuf_ptr);
-    if (NULL == cairo_ptr) {
-        bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
-        bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-        return false;
-    }
-    wlmaker_primitives_cairo_fill(cairo_ptr, &style_ptr->blurred_fill);
-    cairo_destroy(cairo_ptr);
-
-    if (NULL != titlebar_ptr->focussed_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->focussed_gfxbuf_ptr);
-    }
-    titlebar_ptr->focussed_gfxbuf_ptr = focussed_gfxbuf_ptr;
-    if (NULL != titlebar_ptr->blurred_gfxbuf_ptr) {
-        bs_gfxbuf_destroy(titlebar_ptr->blurred_gfxbuf_ptr);
-    }
-    titlebar_ptr->blurred_gfxbuf_ptr = blurred_gfxbuf_ptr;
-    titlebar_ptr->width = width;
-    return true;
-}
-
-/* ------------------------------------------------------------------------- */
-/** Redraws the titlebar elements. */
+/**
+ * Redraws the titlebar elements. Each element draws its slice of the
+ * titlebar's background, on the rasterization pool.
+ */
 bool _wlmtk_titlebar_redraw(
     wlmtk_titlebar_t *titlebar_ptr,
     const struct wlmtk_titlebar_style *style_ptr)
@@ -411,8 +349,7 @@ bool _wlmtk_titlebar_redraw(
 
     if (!wlmtk_titlebar_title_redraw(
             titlebar_ptr->titlebar_title_ptr,
-            titlebar_ptr->focussed_gfxbuf_ptr,
-            titlebar_ptr->blurred_gfxbuf_ptr,
+            titlebar_ptr->width,
             titlebar_ptr->title_position,
             titlebar_ptr->title_width,
             titlebar_ptr->activated,
@@ -426,8 +363,7 @@ bool _wlmtk_titlebar_redraw(
     if (0 < titlebar_ptr->title_position) {
         if (!wlmtk_titlebar_button_redraw(
                 titlebar_ptr->minimize_button_ptr,
-                titlebar_ptr->focussed_gfxbuf_ptr,
-                titlebar_ptr->blurred_gfxbuf_ptr,
+                titlebar_ptr->width,
                 0,
                 style_ptr)) {
             return false;
@@ -444,8 +380,7 @@ bool _wlmtk_titlebar_redraw(
     if (titlebar_ptr->close_position < (int)titlebar_ptr->width) {
         if (!wlmtk_titlebar_button_redraw(
                 titlebar_ptr->close_button_ptr,
-                titlebar_ptr->focussed_gfxbuf_ptr,
-                titlebar_ptr->blurred_gfxbuf_ptr,
+                titlebar_ptr->width,
                 titlebar_ptr->close_position,
                 style_ptr)) {
             return false;
@@ -24,6 +24,7 @@
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
 #include <stdlib.h>
+#include <wayland-server-core.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
 #undef WLR_USE_UNSTABLE
@@ -33,11 +34,23 @@
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
 #include "primitives.h"
+#include "raster.h"
 #include "style.h"
+#include "test.h"  // IWYU pragma: keep
 #include "util.h"
 
 /* == Declarations ========================================================= */
 
+/** A buffer of the titlebar button, and the job drawing it. */
+typedef struct {
+    /** Back-link to the titlebar button. */
+    wlmtk_titlebar_button_t   *titlebar_button_ptr;
+    /** The drawn buffer. NULL if not drawn (yet). */
+    struct wlr_buffer         *wlr_buffer_ptr;
+    /** Pending job drawing the buffer, or NULL. */
+    wlmtk_raster_job_t        *job_ptr;
+} wlmtk_titlebar_button_slot_t;
+
 /** State of a titlebar button. */
 struct _wlmtk_titlebar_button_t {
     /** Superclass: Button. */
@@ -52,24 +65,46 @@ struct _wlmtk_titlebar_button_t {
     /** For drawing the button contents. */
     wlmtk_titlebar_button_draw_t draw;
 
-    /** WLR buffer of the button when focussed & released. */
-    struct wlr_buffer         *focussed_released_wlr_buffer_ptr;
-    /** WLR buffer of the button when focussed & pressed. */
-    struct wlr_buffer         *focussed_pressed_wlr_buffer_ptr;
-    /** WLR buffer of the button when blurred. */
-    struct wlr_buffer         *blurred_wlr_buffer_ptr;
+    /** Buffer of the button when focussed & released. */
+    wlmtk_titlebar_button_slot_t focussed_released;
+    /** Buffer of the button when focussed & pressed. */
+    wlmtk_titlebar_button_slot_t focussed_pressed;
+    /** Buffer of the button when blurred. */
+    wlmtk_titlebar_button_slot_t blurred;
 };
 
+/** Arguments for @ref _wlmtk_titlebar_button_draw. Copied into the job. */
+typedef struct {
+    /** Copy of the titlebar's style. */
+    struct wlmtk_titlebar_style style;
+    /** Width of the titlebar. */
+    unsigned                  titlebar_width;
+    /** Position of the button, relative to the titlebar. */
+    int                       position;
+    /** Whether to draw the button as pressed. */
+    bool                      pressed;
+    /** Whether to draw the button as focussed. */
+    bool                      focussed;
+    /** For drawing the button contents. */
+    wlmtk_titlebar_button_draw_t draw;
+} wlmtk_titlebar_button_draw_args_t;
+
 static void titlebar_button_element_destroy(wlmtk_element_t *element_ptr);
 static void titlebar_button_clicked(wlmtk_button_t *button_ptr);
 static void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr);
-static struct wlr_buffer *create_buf(
-    bs_gfxbuf_t *gfxbuf_ptr,
+static bool _wlmtk_titlebar_button_submit(
+    wlmtk_titlebar_button_slot_t *slot_ptr,
+    unsigned titlebar_width,
     int position,
     bool pressed,
     bool focussed,
-    const struct wlmtk_titlebar_style *style_ptr,
-    wlmtk_titlebar_button_draw_t draw);
+    const struct wlmtk_titlebar_style *style_ptr);
+static void _wlmtk_titlebar_button_slot_fini(
+    wlmtk_titlebar_button_slot_t *slot_ptr);
+static void _wlmtk_titlebar_button_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool _wlmtk_titlebar_button_draw(cairo_t *cairo_ptr, void *args_ptr);
 
 /* == Data ================================================================= */
 
@@ -100,6 +135,11 @@ wlmtk_titlebar_button_t *wlmtk_titlebar_button_create(
     titlebar_button_ptr->click_handler2 = click_handler;
     titlebar_button_ptr->window_ptr = window_ptr;
     titlebar_button_ptr->draw = draw;
+    titlebar_button_ptr->focussed_released.titlebar_button_ptr =
+        titlebar_button_ptr;
+    titlebar_button_ptr->focussed_pressed.titlebar_button_ptr =
+        titlebar_button_ptr;
+    titlebar_button_ptr->blurred.titlebar_button_ptr = titlebar_button_ptr;
 
     if (!wlmtk_button_init(&titlebar_button_ptr->super_button)) {
         wlmtk_titlebar_button_destroy(titlebar_button_ptr);
@@ -119,12 +159,9 @@ wlmtk_titlebar_button_t *wlmtk_titlebar_button_create(
 void wlmtk_titlebar_button_destroy(
     wlmtk_titlebar_button_t *titlebar_button_ptr)
 {
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-    wlr_buffer_drop_nullify(
-        &titlebar_button_ptr->blurred_wlr_buffer_ptr);
+    _wlmtk_titlebar_button_slot_fini(&titlebar_button_ptr->focussed_released);
+    _wlmtk_titlebar_button_slot_fini(&titlebar_button_ptr->focussed_pressed);
+    _wlmtk_titlebar_button_slot_fini(&titlebar_button_ptr->blurred);
 
     wlmtk_button_fini(&titlebar_button_ptr->super_button);
     free(titlebar_button_ptr);
@@ -143,50 +180,26 @@ void wlmtk_titlebar_button_set_activated(
 /* ------------------------------------------------------------------------- */
 bool wlmtk_titlebar_button_redraw(
     wlmtk_titlebar_button_t *titlebar_button_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    unsigned titlebar_width,
     int position,
     const struct wlmtk_titlebar_style *style_ptr)
 {
-    BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(focussed_gfxbuf_ptr->height == blurred_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(position + style_ptr->height <= focussed_gfxbuf_ptr->width);
-
-    struct wlr_buffer *focussed_released_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, false, true, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *focussed_pressed_ptr = create_buf(
-        focussed_gfxbuf_ptr, position, true, true, style_ptr,
-        titlebar_button_ptr->draw);
-    struct wlr_buffer *blurred_ptr = create_buf(
-        blurred_gfxbuf_ptr, position, false, false, style_ptr,
-        titlebar_button_ptr->draw);
-
-    if (NULL != focussed_released_ptr &&
-        NULL != focussed_pressed_ptr &&
-        NULL != blurred_ptr) {
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->focussed_released_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(
-            &titlebar_button_ptr->blurred_wlr_buffer_ptr);
-
-        titlebar_button_ptr->focussed_released_wlr_buffer_ptr =
-            focussed_released_ptr;
-        titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr =
-            focussed_pressed_ptr;
-        titlebar_button_ptr->blurred_wlr_buffer_ptr = blurred_ptr;
-
-        update_buffers(titlebar_button_ptr);
-        return true;
-    }
+    BS_ASSERT(0 <= position);
+    BS_ASSERT(position + style_ptr->height <= titlebar_width);
 
-    wlr_buffer_drop_nullify(&focussed_released_ptr);
-    wlr_buffer_drop_nullify(&focussed_pressed_ptr);
-    wlr_buffer_drop_nullify(&blurred_ptr);
-    return false;
+    // The previous buffers are shown, and scaled, until replaced.
+    wlmtk_buffer_set_dimensions(
+        &titlebar_button_ptr->super_button.super_buffer,
+        style_ptr->height, style_ptr->height);
+    return (_wlmtk_titlebar_button_submit(
+                &titlebar_button_ptr->focussed_released,
+                titlebar_width, position, false, true, style_ptr) &&
+            _wlmtk_titlebar_button_submit(
+                &titlebar_button_ptr->focussed_pressed,
+                titlebar_width, position, true, true, style_ptr) &&
+            _wlmtk_titlebar_button_submit(
+                &titlebar_button_ptr->blurred,
+                titlebar_width, position, false, false, style_ptr));
 }
 
 /* ------------------------------------------------------------------------- */
@@ -221,64 +234,146 @@ void titlebar_button_clicked(wlmtk_button_t *button_ptr)
 /** Updates the button's buffer depending on activation status. */
 void update_buffers(wlmtk_titlebar_button_t *titlebar_button_ptr)
 {
-    // No buffer: Nothing to update.
-    if (NULL == titlebar_button_ptr->focussed_released_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr ||
-        NULL == titlebar_button_ptr->blurred_wlr_buffer_ptr) return;
-
+    struct wlr_buffer *released_ptr =
+        titlebar_button_ptr->blurred.wlr_buffer_ptr;
+    struct wlr_buffer *pressed_ptr = released_ptr;
     if (titlebar_button_ptr->activated) {
-        wlmtk_button_set(
-            &titlebar_button_ptr->super_button,
-            titlebar_button_ptr->focussed_released_wlr_buffer_ptr,
-            titlebar_button_ptr->focussed_pressed_wlr_buffer_ptr);
-    } else {
-        wlmtk_button_set(
-            &titlebar_button_ptr->super_button,
-            titlebar_button_ptr->blurred_wlr_buffer_ptr,
-            titlebar_button_ptr->blurred_wlr_buffer_ptr);
+        released_ptr = titlebar_button_ptr->focussed_released.wlr_buffer_ptr;
+        pressed_ptr = titlebar_button_ptr->focussed_pressed.wlr_buffer_ptr;
     }
+
+    // No buffer: Nothing to update.
+    if (NULL == released_ptr || NULL == pressed_ptr) return;
+    // Sizes differ while a redraw is in flight: Wait for the other buffer.
+    if (released_ptr->width != pressed_ptr->width ||
+        released_ptr->height != pressed_ptr->height) return;
+    wlmtk_button_set(
+        &titlebar_button_ptr->super_button, released_ptr, pressed_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
-/** Helper: Creates a WLR buffer for the button. */
-struct wlr_buffer *create_buf(
-    bs_gfxbuf_t *gfxbuf_ptr,
+/**
+ * Submits a job to (re)draw the buffer of `slot_ptr`. Cancels a pending job
+ * for that slot. The slot keeps its previous buffer until the job is done.
+ *
+ * @param slot_ptr
+ * @param titlebar_width
+ * @param position
+ * @param pressed
+ * @param focussed
+ * @param style_ptr
+ *
+ * @return true on success.
+ */
+bool _wlmtk_titlebar_button_submit(
+    wlmtk_titlebar_button_slot_t *slot_ptr,
+    unsigned titlebar_width,
     int position,
     bool pressed,
     bool focussed,
-    const struct wlmtk_titlebar_style *style_ptr,
-    wlmtk_titlebar_button_draw_t draw)
+    const struct wlmtk_titlebar_style *style_ptr)
 {
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        style_ptr->height, style_ptr->height);
-    if (NULL == wlr_buffer_ptr) return NULL;
+    if (NULL != slot_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(slot_ptr->job_ptr);
+        slot_ptr->job_ptr = NULL;
+    }
 
-    bs_gfxbuf_copy_area(
-        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr), 0, 0,
-        gfxbuf_ptr, position, 0, style_ptr->height, style_ptr->height);
+    wlmtk_titlebar_button_draw_args_t args = {
+        .style = *style_ptr,
+        .titlebar_width = titlebar_width,
+        .position = position,
+        .pressed = pressed,
+        .focussed = focussed,
+        .draw = slot_ptr->titlebar_button_ptr->draw
+    };
+    return wlmtk_raster_submit(
+        style_ptr->height,
+        style_ptr->height,
+        _wlmtk_titlebar_button_draw,
+        &args, sizeof(args),
+        NULL,
+        _wlmtk_titlebar_button_handle_drawn,
+        slot_ptr,
+        &slot_ptr->job_ptr);
+}
 
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
+/* ------------------------------------------------------------------------- */
+/** Cancels the slot's pending job, and releases its buffer. */
+void _wlmtk_titlebar_button_slot_fini(wlmtk_titlebar_button_slot_t *slot_ptr)
+{
+    if (NULL != slot_ptr->job_ptr) {
+        wlmtk_raster_job_cancel(slot_ptr->job_ptr);
+        slot_ptr->job_ptr = NULL;
     }
+    wlr_buffer_drop_nullify(&slot_ptr->wlr_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the buffer drawn by @ref _wlmtk_titlebar_button_submit, stores it
+ * in the slot and updates the button.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr              Points to the @ref wlmtk_titlebar_button_slot_t.
+ */
+void _wlmtk_titlebar_button_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmtk_titlebar_button_slot_t *slot_ptr = ud_ptr;
+    slot_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw titlebar button %p",
+               slot_ptr->titlebar_button_ptr);
+        return;
+    }
+
+    wlr_buffer_drop_nullify(&slot_ptr->wlr_buffer_ptr);
+    slot_ptr->wlr_buffer_ptr = wlr_buffer_ptr;
+    update_buffers(slot_ptr->titlebar_button_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the button, on its slice of the
+ * titlebar's background. Runs on a worker thread, and must only access the
+ * arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr
+ *     Points to a @ref wlmtk_titlebar_button_draw_args_t.
+ *
+ * @return true.
+ */
+bool _wlmtk_titlebar_button_draw(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmtk_titlebar_button_draw_args_t *args = args_ptr;
+    const struct wlmtk_titlebar_style *style_ptr = &args->style;
+
+    cairo_save(cairo_ptr);
+    cairo_translate(cairo_ptr, -args->position, 0);
+    wlmaker_primitives_cairo_fill_at(
+        cairo_ptr, 0, 0, args->titlebar_width, style_ptr->height,
+        args->focussed ? &style_ptr->focussed_fill : &style_ptr->blurred_fill);
+    cairo_restore(cairo_ptr);
+
     wlmaker_primitives_draw_bezel(
-        cairo_ptr, style_ptr->bezel_width, !pressed);
+        cairo_ptr, style_ptr->bezel_width, !args->pressed);
     uint32_t color = style_ptr->focussed_text_color;
-    if (!focussed) color = style_ptr->blurred_text_color;
-    draw(cairo_ptr, style_ptr->height, color);
-    cairo_destroy(cairo_ptr);
-
-    return wlr_buffer_ptr;
+    if (!args->focussed) color = style_ptr->blurred_text_color;
+    args->draw(cairo_ptr, style_ptr->height, color);
+    return true;
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_button(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_titlebar_button_test_cases[] = {
     { 1, "button", test_button },
+    { 1, "deferred", test_deferred },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -308,20 +403,22 @@ void test_button(bs_test_t *test_ptr)
 
     // Draw contents.
     struct wlmtk_titlebar_style style = {
+        .focussed_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff4040c0 } }
+        },
+        .blurred_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff303030 } }
+        },
         .height = 22,
         .focussed_text_color = 0xffffffff,
         .blurred_text_color = 0xffe0c0a0,
         .bezel_width = 1
     };
-    bs_gfxbuf_t *f_ptr = bs_gfxbuf_create(100, 22);
-    bs_gfxbuf_clear(f_ptr, 0xff4040c0);
-    bs_gfxbuf_t *b_ptr = bs_gfxbuf_create(100, 22);
-    bs_gfxbuf_clear(b_ptr, 0xff303030);
     BS_TEST_VERIFY_TRUE(
         test_ptr,
-        wlmtk_titlebar_button_redraw(button_ptr, f_ptr, b_ptr, 30, &style));
-    bs_gfxbuf_destroy(b_ptr);
-    bs_gfxbuf_destroy(f_ptr);
+        wlmtk_titlebar_button_redraw(button_ptr, 100, 30, &style));
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
@@ -377,4 +474,68 @@ void test_button(bs_test_t *test_ptr)
     wlmtk_window_destroy(w);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests drawing on the rasterization pool: Buffers show once handed back. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wlmtk_titlebar_style style = {
+        .focussed_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff4040c0 } }
+        },
+        .height = 22,
+    };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    wlmtk_window_t *w = wlmtk_test_window_create(NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    wlmtk_titlebar_button_t *button_ptr = wlmtk_titlebar_button_create(
+        wlmtk_window_request_close, w, wlmaker_primitives_draw_close_icon);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, button_ptr);
+    wlmtk_titlebar_button_set_activated(button_ptr, true);
+    wlmtk_buffer_t *super_buffer_ptr = &button_ptr->super_button.super_buffer;
+
+    // No buffer until the jobs are handed back.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_button_redraw(button_ptr, 100, 30, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, button_ptr->focussed_released.job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, super_buffer_ptr->wlr_buffer_ptr);
+
+    // The style changes while the jobs are pending: The new style is shown.
+    style.focussed_fill.param.solid.color = 0xff40c020;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_button_redraw(button_ptr, 100, 30, &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, super_buffer_ptr->wlr_buffer_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(
+            wl_event_loop_ptr, &super_buffer_ptr->wlr_buffer_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, button_ptr->focussed_released.job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, button_ptr->focussed_pressed.job_ptr);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(
+        super_buffer_ptr->wlr_buffer_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff40c020, g->data_ptr[11 * g->pixels_per_line + 2]);
+
+    // Destroying the button cancels its pending jobs. Destroying the pool
+    // then hands back all jobs: The cancelled ones must not be applied.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_button_redraw(button_ptr, 100, 30, &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, button_ptr->blurred.job_ptr);
+    wlmtk_element_destroy(wlmtk_titlebar_button_element(button_ptr));
+    wlmtk_raster_pool_destroy(pool_ptr);
+
+    wlmtk_window_destroy(w);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of titlebar_button.c ============================================= */
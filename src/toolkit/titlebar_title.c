@@ -24,21 +24,26 @@
 #include <cairo.h>
 #include <libbase/libbase.h>
 #include <linux/input-event-codes.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <time.h>
 #include <wayland-server-core.h>
 #include <wayland-server-protocol.h>
 #define WLR_USE_UNSTABLE
 #include <wlr/interfaces/wlr_buffer.h>
 #include <wlr/types/wlr_output.h>
 #include <wlr/types/wlr_output_layout.h>
+#include <wlr/types/wlr_scene.h>
 #undef WLR_USE_UNSTABLE
 
 #include "buffer.h"
+#include "container.h"
 #include "gfxbuf.h"  // IWYU pragma: keep
 #include "input.h"
 #include "menu.h"
 #include "primitives.h"
+#include "raster.h"
 #include "style.h"
 #include "test.h"  // IWYU pragma: keep
 #include "tile.h"
@@ -50,17 +55,54 @@
 struct _wlmtk_titlebar_title_t {
     /** Superclass: Buffer. */
     wlmtk_buffer_t            super_buffer;
+    /** The superclass' @ref wlmtk_element_t virtual method table. */
+    wlmtk_element_vmt_t       orig_super_element_vmt;
     /** Pointer to the window the title element belongs to. */
     wlmtk_window_t           *window_ptr;
 
-    /** The drawn title, when focussed. */
+    /** The drawn title, when focussed. NULL if not drawn (yet). */
     struct wlr_buffer         *focussed_wlr_buffer_ptr;
-    /** The drawn title, when blurred. */
+    /** The drawn title, when blurred. NULL if not drawn (yet). */
     struct wlr_buffer         *blurred_wlr_buffer_ptr;
+
+    /** Pending job drawing the buffer for `job_activated`. */
+    wlmtk_raster_job_t        *job_ptr;
+    /** The activation state drawn by @ref wlmtk_titlebar_title_t::job_ptr. */
+    bool                      job_activated;
+
+    /** Width of the titlebar. The title draws its slice of the background. */
+    unsigned                  titlebar_width;
+    /** Position of the title, relative to the titlebar. */
+    int                       position;
+    /** Width of the title. */
+    int                       width;
+    /** Link to the title. Owned by the window. */
+    const char                *title_ptr;
+    /** Style of the titlebar. NULL until the first redraw. */
+    const struct wlmtk_titlebar_style *style_ptr;
+    /** Whether the title is shown as activated (focussed). */
+    bool                      activated;
+
+    /**
+     * Whether the title changed since the buffers were drawn. The redraw is
+     * deferred to the next frame of an output that shows the title, or to
+     * when the title is added to the scene graph.
+     */
+    bool                      pending;
+    /** Number of title buffers submitted for drawing. For tests. */
+    size_t                    draws;
+
+    /** Listener for the `frame_done` signal of the `wlr_scene_buffer`. */
+    struct wl_listener        frame_done_listener;
+    /** Listener for the `destroy` signal of the `wlr_scene_buffer` node. */
+    struct wl_listener        node_destroy_listener;
 };
 
 static void _wlmtk_titlebar_title_element_destroy(
     wlmtk_element_t *element_ptr);
+static struct wlr_scene_node *_wlmtk_titlebar_title_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr);
 static bool _wlmtk_titlebar_title_element_pointer_button(
     wlmtk_element_t *element_ptr,
     const wlmtk_button_event_t *button_event_ptr);
@@ -68,22 +110,43 @@ static bool _wlmtk_titlebar_title_element_pointer_axis(
     wlmtk_element_t *element_ptr,
     struct wlr_pointer_axis_event *wlr_pointer_axis_event_ptr);
 
-static void title_set_activated(
-    wlmtk_titlebar_title_t *titlebar_title_ptr,
-    bool activated);
-struct wlr_buffer *title_create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
-    unsigned width,
-    uint32_t text_color,
-    const char *title_ptr,
-    const struct wlmtk_titlebar_style *style_ptr);
-
+/** Arguments for @ref title_raster_draw. A copy owned by the job. */
+typedef struct {
+    /** Copy of the titlebar's style. */
+    struct wlmtk_titlebar_style style;
+    /** Width of the titlebar. */
+    unsigned                  titlebar_width;
+    /** Position of the title, relative to the titlebar. */
+    unsigned                  position;
+    /** Width of the title. */
+    unsigned                  width;
+    /** Whether to draw the focussed (activated) title. */
+    bool                      activated;
+    /** Copy of the title. Released by @ref title_raster_args_fini. */
+    char                      *title_ptr;
+} wlmtk_titlebar_title_draw_args_t;
+
+static bool title_draw(wlmtk_titlebar_title_t *titlebar_title_ptr);
+static bool title_submit(wlmtk_titlebar_title_t *titlebar_title_ptr);
+static void title_cancel_job(wlmtk_titlebar_title_t *titlebar_title_ptr);
+static void title_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr);
+static bool title_raster_draw(cairo_t *cairo_ptr, void *args_ptr);
+static void title_raster_args_fini(void *args_ptr);
+static void title_flush(wlmtk_titlebar_title_t *titlebar_title_ptr);
+static void _wlmtk_titlebar_title_handle_frame_done(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
+static void _wlmtk_titlebar_title_handle_node_destroy(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 /* == Data ================================================================= */
 
 /** Extension to the superclass elment's virtual method table. */
 static const wlmtk_element_vmt_t titlebar_title_element_vmt = {
     .destroy = _wlmtk_titlebar_title_element_destroy,
+    .create_scene_node = _wlmtk_titlebar_title_element_create_scene_node,
     .pointer_button = _wlmtk_titlebar_title_element_pointer_button,
     .pointer_axis = _wlmtk_titlebar_title_element_pointer_axis,
 };
@@ -102,7 +165,7 @@ wlmtk_titlebar_title_t *wlmtk_titlebar_title_create(wlmtk_window_t *window_ptr)
         wlmtk_titlebar_title_destroy(titlebar_title_ptr);
         return NULL;
     }
-    wlmtk_element_extend(
+    titlebar_title_ptr->orig_super_element_vmt = wlmtk_element_extend(
         &titlebar_title_ptr->super_buffer.super_element,
         &titlebar_title_element_vmt);
 
@@ -112,6 +175,9 @@ wlmtk_titlebar_title_t *wlmtk_titlebar_title_create(wlmtk_window_t *window_ptr)
 /* ------------------------------------------------------------------------- */
 void wlmtk_titlebar_title_destroy(wlmtk_titlebar_title_t *titlebar_title_ptr)
 {
+    wlmtk_util_disconnect_listener(&titlebar_title_ptr->node_destroy_listener);
+    wlmtk_util_disconnect_listener(&titlebar_title_ptr->frame_done_listener);
+    title_cancel_job(titlebar_title_ptr);
     wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
     wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
     wlmtk_buffer_fini(&titlebar_title_ptr->super_buffer);
@@ -121,43 +187,67 @@ void wlmtk_titlebar_title_destroy(wlmtk_titlebar_title_t *titlebar_title_ptr)
 /* ------------------------------------------------------------------------- */
 bool wlmtk_titlebar_title_redraw(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
-    bs_gfxbuf_t *focussed_gfxbuf_ptr,
-    bs_gfxbuf_t *blurred_gfxbuf_ptr,
+    unsigned titlebar_width,
     int position,
     int width,
     bool activated,
     const char *title_ptr,
     const struct wlmtk_titlebar_style *style_ptr)
 {
-    BS_ASSERT(focussed_gfxbuf_ptr->width == blurred_gfxbuf_ptr->width);
-    BS_ASSERT(style_ptr->height == focussed_gfxbuf_ptr->height);
-    BS_ASSERT(style_ptr->height == blurred_gfxbuf_ptr->height);
-    BS_ASSERT(position <= (int)focussed_gfxbuf_ptr->width);
-    BS_ASSERT(position + width <= (int)focussed_gfxbuf_ptr->width);
-
-    if (NULL == title_ptr) title_ptr = "";
-
-    struct wlr_buffer *focussed_wlr_buffer_ptr = title_create_buffer(
-        focussed_gfxbuf_ptr, position, width,
-        style_ptr->focussed_text_color, title_ptr, style_ptr);
-    struct wlr_buffer *blurred_wlr_buffer_ptr = title_create_buffer(
-        blurred_gfxbuf_ptr, position, width,
-        style_ptr->blurred_text_color, title_ptr, style_ptr);
-
-    if (NULL == focussed_wlr_buffer_ptr ||
-        NULL == blurred_wlr_buffer_ptr) {
-        wlr_buffer_drop_nullify(&focussed_wlr_buffer_ptr);
-        wlr_buffer_drop_nullify(&blurred_wlr_buffer_ptr);
-        return false;
-    }
-
+    BS_ASSERT(0 <= position && position <= (int)titlebar_width);
+    BS_ASSERT(position + width <= (int)titlebar_width);
+
+    titlebar_title_ptr->titlebar_width = titlebar_width;
+    titlebar_title_ptr->position = position;
+    titlebar_title_ptr->width = width;
+    titlebar_title_ptr->activated = activated;
+    titlebar_title_ptr->title_ptr = title_ptr;
+    titlebar_title_ptr->style_ptr = style_ptr;
+
+    // Geometry or style changed: The dimensions must be updated right away.
+    // Only the buffer for the current activation state is drawn, though. The
+    // previous buffer is scaled to the new dimensions until it is handed back.
+    titlebar_title_ptr->pending = false;
+    title_cancel_job(titlebar_title_ptr);
     wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
-    titlebar_title_ptr->focussed_wlr_buffer_ptr = focussed_wlr_buffer_ptr;
     wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
-    titlebar_title_ptr->blurred_wlr_buffer_ptr = blurred_wlr_buffer_ptr;
+    wlmtk_buffer_set_dimensions(
+        &titlebar_title_ptr->super_buffer, width, style_ptr->height);
+    return title_draw(titlebar_title_ptr);
+}
 
-    title_set_activated(titlebar_title_ptr, activated);
-    return true;
+/* ------------------------------------------------------------------------- */
+void wlmtk_titlebar_title_set_title(
+    wlmtk_titlebar_title_t *titlebar_title_ptr,
+    const char *title_ptr)
+{
+    titlebar_title_ptr->title_ptr = title_ptr;
+    // Guard clause: Not drawn yet. The first redraw will pick up the title.
+    if (NULL == titlebar_title_ptr->style_ptr) return;
+
+    // Keep showing the current buffer until the deferred redraw. The buffer
+    // for the other activation state is stale, and will be drawn on demand.
+    if (NULL != titlebar_title_ptr->job_ptr &&
+        titlebar_title_ptr->job_activated != titlebar_title_ptr->activated) {
+        title_cancel_job(titlebar_title_ptr);
+    }
+    if (titlebar_title_ptr->activated) {
+        wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    } else {
+        wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
+    }
+    if (titlebar_title_ptr->pending) return;
+    titlebar_title_ptr->pending = true;
+
+    // If an output currently shows the title: Have it render a frame. If no
+    // output shows it, the redraw waits until one does.
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr =
+        titlebar_title_ptr->super_buffer.wlr_scene_buffer_ptr;
+    if (NULL != wlr_scene_buffer_ptr &&
+        NULL != wlr_scene_buffer_ptr->primary_output) {
+        wlr_output_schedule_frame(
+            wlr_scene_buffer_ptr->primary_output->output);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -165,7 +255,16 @@ void wlmtk_titlebar_title_set_activated(
     wlmtk_titlebar_title_t *titlebar_title_ptr,
     bool activated)
 {
-    title_set_activated(titlebar_title_ptr, activated);
+    if (titlebar_title_ptr->activated == activated) return;
+    titlebar_title_ptr->activated = activated;
+    // Guard clause: Not drawn yet.
+    if (NULL == titlebar_title_ptr->style_ptr) return;
+
+    if (titlebar_title_ptr->pending) {
+        title_flush(titlebar_title_ptr);
+    } else {
+        title_draw(titlebar_title_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -251,74 +350,267 @@ bool _wlmtk_titlebar_title_element_pointer_axis(
 
 /* ------------------------------------------------------------------------- */
 /**
- * Sets whether the title is drawn focussed (activated) or blurred.
+ * Sets the buffer for the current activation state. If it is not drawn yet,
+ * submits a job to draw it. The title keeps showing the previous buffer until
+ * the job hands the new one back.
  *
  * @param titlebar_title_ptr
- * @param activated
+ *
+ * @return true on success.
  */
-void title_set_activated(
-    wlmtk_titlebar_title_t *titlebar_title_ptr,
-    bool activated)
+bool title_draw(wlmtk_titlebar_title_t *titlebar_title_ptr)
 {
-    wlmtk_buffer_set(
-        &titlebar_title_ptr->super_buffer,
-        activated ?
+    struct wlr_buffer *wlr_buffer_ptr = titlebar_title_ptr->activated ?
         titlebar_title_ptr->focussed_wlr_buffer_ptr :
-        titlebar_title_ptr->blurred_wlr_buffer_ptr);
+        titlebar_title_ptr->blurred_wlr_buffer_ptr;
+    if (NULL != wlr_buffer_ptr) {
+        title_cancel_job(titlebar_title_ptr);
+        wlmtk_buffer_set(&titlebar_title_ptr->super_buffer, wlr_buffer_ptr);
+        return true;
+    }
+    return title_submit(titlebar_title_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a WLR buffer with the title's texture, as specified.
+ * Submits a job to draw the buffer for the current activation state. Cancels
+ * a pending job for the other state. Without rasterization pool, the buffer
+ * is drawn (and set) right away.
  *
- * @param gfxbuf_ptr
- * @param position
- * @param width
- * @param text_color
- * @param title_ptr
- * @param style_ptr
+ * @param titlebar_title_ptr
  *
- * @return A pointer to a `struct wlr_buffer` with the texture.
+ * @return false on error.
  */
-struct wlr_buffer *title_create_buffer(
-    bs_gfxbuf_t *gfxbuf_ptr,
-    unsigned position,
-    unsigned width,
-    uint32_t text_color,
-    const char *title_ptr,
-    const struct wlmtk_titlebar_style *style_ptr)
+bool title_submit(wlmtk_titlebar_title_t *titlebar_title_ptr)
 {
-    BS_ASSERT(NULL != title_ptr);
-    struct wlr_buffer *wlr_buffer_ptr = bs_gfxbuf_create_wlr_buffer(
-        width, style_ptr->height);
-    if (NULL == wlr_buffer_ptr) return NULL;
-
-    bs_gfxbuf_copy_area(
-        bs_gfxbuf_from_wlr_buffer(wlr_buffer_ptr),
-        0, 0,
-        gfxbuf_ptr,
-        position, 0,
-        width, style_ptr->height);
-
-    cairo_t *cairo_ptr = cairo_create_from_wlr_buffer(wlr_buffer_ptr);
-    if (NULL == cairo_ptr) {
-        wlr_buffer_drop(wlr_buffer_ptr);
-        return NULL;
+    bool activated = titlebar_title_ptr->activated;
+    if (NULL != titlebar_title_ptr->job_ptr) {
+        if (titlebar_title_ptr->job_activated == activated) return true;
+        title_cancel_job(titlebar_title_ptr);
+    }
+
+    wlmtk_titlebar_title_draw_args_t args = {
+        .style = *titlebar_title_ptr->style_ptr,
+        .titlebar_width = titlebar_title_ptr->titlebar_width,
+        .position = titlebar_title_ptr->position,
+        .width = titlebar_title_ptr->width,
+        .activated = activated,
+        .title_ptr = logged_strdup(
+            NULL != titlebar_title_ptr->title_ptr ?
+            titlebar_title_ptr->title_ptr : "")
+    };
+    if (NULL == args.title_ptr) return false;
+
+    // On failure, the title was not handed to the job: Still ours to free.
+    titlebar_title_ptr->job_activated = activated;
+    if (!wlmtk_raster_submit(
+            args.width,
+            args.style.height,
+            title_raster_draw,
+            &args, sizeof(args),
+            title_raster_args_fini,
+            title_handle_drawn,
+            titlebar_title_ptr,
+            &titlebar_title_ptr->job_ptr)) {
+        free(args.title_ptr);
+        return false;
+    }
+    ++titlebar_title_ptr->draws;
+
+    // Synchronously drawn: The slot is populated, unless drawing failed.
+    if (NULL == titlebar_title_ptr->job_ptr) {
+        return NULL != (activated ?
+                        titlebar_title_ptr->focussed_wlr_buffer_ptr :
+                        titlebar_title_ptr->blurred_wlr_buffer_ptr);
     }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Cancels the pending rasterization job, if any. */
+void title_cancel_job(wlmtk_titlebar_title_t *titlebar_title_ptr)
+{
+    if (NULL == titlebar_title_ptr->job_ptr) return;
+    wlmtk_raster_job_cancel(titlebar_title_ptr->job_ptr);
+    titlebar_title_ptr->job_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Receives the buffer drawn by @ref title_submit. Stores it, and shows it if
+ * the title is (still) in that activation state.
+ *
+ * @param wlr_buffer_ptr
+ * @param ud_ptr
+ */
+void title_handle_drawn(
+    struct wlr_buffer *wlr_buffer_ptr,
+    void *ud_ptr)
+{
+    wlmtk_titlebar_title_t *titlebar_title_ptr = ud_ptr;
+    titlebar_title_ptr->job_ptr = NULL;
+    if (NULL == wlr_buffer_ptr) {
+        bs_log(BS_WARNING, "Failed to draw title %p", titlebar_title_ptr);
+        return;
+    }
+
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &titlebar_title_ptr->blurred_wlr_buffer_ptr;
+    if (titlebar_title_ptr->job_activated) {
+        wlr_buffer_ptr_ptr = &titlebar_title_ptr->focussed_wlr_buffer_ptr;
+    }
+    wlr_buffer_drop_nullify(wlr_buffer_ptr_ptr);
+    *wlr_buffer_ptr_ptr = wlr_buffer_ptr;
+    if (titlebar_title_ptr->job_activated == titlebar_title_ptr->activated) {
+        wlmtk_buffer_set(&titlebar_title_ptr->super_buffer, wlr_buffer_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Performs a pending redraw: Discards the stale buffers, and draws the one
+ * for the current activation state.
+ *
+ * @param titlebar_title_ptr
+ */
+void title_flush(wlmtk_titlebar_title_t *titlebar_title_ptr)
+{
+    if (!titlebar_title_ptr->pending) return;
+    titlebar_title_ptr->pending = false;
+
+    // The super_buffer holds a lock on the shown buffer, until replaced.
+    title_cancel_job(titlebar_title_ptr);
+    wlr_buffer_drop_nullify(&titlebar_title_ptr->focussed_wlr_buffer_ptr);
+    wlr_buffer_drop_nullify(&titlebar_title_ptr->blurred_wlr_buffer_ptr);
+    if (!title_draw(titlebar_title_ptr)) {
+        bs_log(BS_WARNING, "Failed title_draw(%p)", titlebar_title_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_element_vmt_t::create_scene_node. Performs a pending
+ * redraw before the superclass creates the `wlr_scene_buffer`, and listens to
+ * it's `frame_done` signal.
+ *
+ * @param element_ptr
+ * @param wlr_scene_tree_ptr
+ *
+ * @return Pointer to the scene graph API node.
+ */
+struct wlr_scene_node *_wlmtk_titlebar_title_element_create_scene_node(
+    wlmtk_element_t *element_ptr,
+    struct wlr_scene_tree *wlr_scene_tree_ptr)
+{
+    wlmtk_titlebar_title_t *titlebar_title_ptr = BS_CONTAINER_OF(
+        element_ptr, wlmtk_titlebar_title_t, super_buffer.super_element);
+
+    title_flush(titlebar_title_ptr);
+
+    struct wlr_scene_node *wlr_scene_node_ptr =
+        titlebar_title_ptr->orig_super_element_vmt.create_scene_node(
+            element_ptr, wlr_scene_tree_ptr);
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr =
+        titlebar_title_ptr->super_buffer.wlr_scene_buffer_ptr;
+
+    wlmtk_util_connect_listener_signal(
+        &wlr_scene_buffer_ptr->events.frame_done,
+        &titlebar_title_ptr->frame_done_listener,
+        _wlmtk_titlebar_title_handle_frame_done);
+    wlmtk_util_connect_listener_signal(
+        &wlr_scene_buffer_ptr->node.events.destroy,
+        &titlebar_title_ptr->node_destroy_listener,
+        _wlmtk_titlebar_title_handle_node_destroy);
+    return wlr_scene_node_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `frame_done` of the `wlr_scene_buffer`: An output showing the title
+ * has rendered a frame. Performs a pending redraw, which then shows up on the
+ * next frame. Multiple title changes between frames are thus coalesced.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmtk_titlebar_title_handle_frame_done(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_titlebar_title_t *titlebar_title_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_titlebar_title_t, frame_done_listener);
+    title_flush(titlebar_title_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles `destroy` of the `wlr_scene_buffer` node: Disconnects listeners.
+ *
+ * @param listener_ptr
+ * @param data_ptr
+ */
+void _wlmtk_titlebar_title_handle_node_destroy(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    wlmtk_titlebar_title_t *titlebar_title_ptr = BS_CONTAINER_OF(
+        listener_ptr, wlmtk_titlebar_title_t, node_destroy_listener);
+    wlmtk_util_disconnect_listener(&titlebar_title_ptr->frame_done_listener);
+    wlmtk_util_disconnect_listener(&titlebar_title_ptr->node_destroy_listener);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Implements @ref wlmtk_raster_draw_t: Draws the title, on its slice of the
+ * titlebar's background. Runs on a worker thread, and must only access the
+ * arguments.
+ *
+ * @param cairo_ptr
+ * @param args_ptr            Points to a @ref wlmtk_titlebar_title_draw_args_t.
+ *
+ * @return true.
+ */
+bool title_raster_draw(cairo_t *cairo_ptr, void *args_ptr)
+{
+    wlmtk_titlebar_title_draw_args_t *args = args_ptr;
+    const struct wlmtk_titlebar_style *style_ptr = &args->style;
+
+    // The fill spans the titlebar. Drawn in titlebar coordinates, and
+    // clipped to the title's buffer.
+    cairo_save(cairo_ptr);
+    cairo_translate(cairo_ptr, -(double)args->position, 0);
+    wlmaker_primitives_cairo_fill_at(
+        cairo_ptr, 0, 0, args->titlebar_width, style_ptr->height,
+        args->activated ? &style_ptr->focussed_fill : &style_ptr->blurred_fill);
+    cairo_restore(cairo_ptr);
+
     wlmaker_primitives_draw_bezel_at(
-        cairo_ptr, 0, 0, width,
+        cairo_ptr, 0, 0, args->width,
         style_ptr->height, style_ptr->bezel_width, true);
     wlmaker_primitives_draw_window_title(
-        cairo_ptr, &style_ptr->font, title_ptr, text_color);
-    cairo_destroy(cairo_ptr);
+        cairo_ptr, &style_ptr->font, args->title_ptr,
+        (args->activated ?
+         style_ptr->focussed_text_color : style_ptr->blurred_text_color));
+    return true;
+}
 
-    return wlr_buffer_ptr;
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmtk_raster_args_fini_t: Frees the copied title. */
+void title_raster_args_fini(void *args_ptr)
+{
+    wlmtk_titlebar_title_draw_args_t *args = args_ptr;
+    if (NULL != args->title_ptr) {
+        free(args->title_ptr);
+        args->title_ptr = NULL;
+    }
 }
 
 /* == Unit tests =========================================================== */
 
 static void test_title(bs_test_t *test_ptr);
 static void test_shade(bs_test_t *test_ptr);
+static void test_coalesce(bs_test_t *test_ptr);
+static void test_deferred(bs_test_t *test_ptr);
 
 /** Test cases */
 static const bs_test_case_t _wlmtk_titlebar_title_test_cases[] = {
@@ -326,6 +618,8 @@ static const bs_test_case_t _wlmtk_titlebar_title_test_cases[] = {
     // Trixie when running as a github action.
     { 0, "title", test_title },
     { 1, "shade", test_shade },
+    { 1, "coalesce", test_coalesce },
+    { 1, "deferred", test_deferred },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -337,6 +631,14 @@ const bs_test_set_t wlmtk_titlebar_title_test_set = BS_TEST_SET(
 void test_title(bs_test_t *test_ptr)
 {
     const struct wlmtk_titlebar_style style = {
+        .focussed_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff2020c0 } }
+        },
+        .blurred_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff404040 } }
+        },
         .focussed_text_color = 0xffc0c0c0,
         .blurred_text_color = 0xff808080,
         .height = 22,
@@ -363,11 +665,6 @@ void test_title(bs_test_t *test_ptr)
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ws_ptr);
     wlmtk_workspace_enable(ws_ptr, true);
 
-    bs_gfxbuf_t *focussed_gfxbuf_ptr = bs_gfxbuf_create(120, 22);
-    bs_gfxbuf_t *blurred_gfxbuf_ptr = bs_gfxbuf_create(120, 22);
-    bs_gfxbuf_clear(focussed_gfxbuf_ptr, 0xff2020c0);
-    bs_gfxbuf_clear(blurred_gfxbuf_ptr, 0xff404040);
-
     wlmtk_window_t *w = wlmtk_test_window_create(NULL);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
     wlmtk_workspace_map_window(ws_ptr, w);
@@ -379,18 +676,14 @@ void test_title(bs_test_t *test_ptr)
     BS_TEST_VERIFY_TRUE(
         test_ptr,
         wlmtk_titlebar_title_redraw(
-            title_ptr,
-            focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
-            10, 90, true, "Title", &style));
+            title_ptr, 120, 10, 90, true, "Title", &style));
 
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(title_ptr->focussed_wlr_buffer_ptr),
         "toolkit/title_focussed.png");
-    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
-        test_ptr,
-        bs_gfxbuf_from_wlr_buffer(title_ptr->blurred_wlr_buffer_ptr),
-        "toolkit/title_blurred.png");
+    // The blurred title is drawn on demand only.
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, title_ptr->blurred_wlr_buffer_ptr);
 
     // We had started as "activated", verify that's correct.
     wlmtk_buffer_t *super_buffer_ptr = &title_ptr->super_buffer;
@@ -400,7 +693,11 @@ void test_title(bs_test_t *test_ptr)
         "toolkit/title_focussed.png");
 
     // De-activated the title. Verify that was propagated.
-    title_set_activated(title_ptr, false);
+    wlmtk_titlebar_title_set_activated(title_ptr, false);
+    BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
+        test_ptr,
+        bs_gfxbuf_from_wlr_buffer(title_ptr->blurred_wlr_buffer_ptr),
+        "toolkit/title_blurred.png");
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
@@ -408,8 +705,7 @@ void test_title(bs_test_t *test_ptr)
 
     // Redraw with shorter width. Verify that's still correct.
     wlmtk_titlebar_title_redraw(
-        title_ptr, focussed_gfxbuf_ptr, blurred_gfxbuf_ptr,
-        10, 70, false, "Title", &style);
+        title_ptr, 120, 10, 70, false, "Title", &style);
     BS_TEST_VERIFY_GFXBUF_EQUALS_PNG(
         test_ptr,
         bs_gfxbuf_from_wlr_buffer(super_buffer_ptr->wlr_buffer_ptr),
@@ -441,8 +737,6 @@ void test_title(bs_test_t *test_ptr)
     wlmtk_element_destroy(element_ptr);
     wlmtk_workspace_unmap_window(ws_ptr, w);
     wlmtk_window_destroy(w);
-    bs_gfxbuf_destroy(focussed_gfxbuf_ptr);
-    bs_gfxbuf_destroy(blurred_gfxbuf_ptr);
     wlmtk_workspace_destroy(ws_ptr);
     wl_display_destroy(display_ptr);
 }
@@ -502,4 +796,149 @@ void test_shade(bs_test_t *test_ptr)
     wlmtk_element_destroy(&fe_ptr->element);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that rapid title changes are coalesced into one redraw per frame. */
+void test_coalesce(bs_test_t *test_ptr)
+{
+    const struct wlmtk_titlebar_style style = {
+        .height = 22, .font = { .face = "Helvetica", .size = 15 } };
+    const char *titles[] = { "One", "Two", "Three" };
+    struct timespec now = {};
+
+    wlmtk_container_t *fake_parent_ptr = wlmtk_container_create_fake_parent();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fake_parent_ptr);
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    wlmtk_window_t *w = wlmtk_test_window_create(&fe_ptr->element);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    wlmtk_titlebar_title_t *title_ptr = wlmtk_titlebar_title_create(w);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, title_ptr);
+    wlmtk_element_t *element_ptr = wlmtk_titlebar_title_element(title_ptr);
+
+    // Title changes before the first redraw do not draw.
+    wlmtk_titlebar_title_set_title(title_ptr, titles[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, title_ptr->draws);
+
+    // The redraw draws the buffer for the current (blurred) state only.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            title_ptr, 120, 10, 90, false, titles[0], &style));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, title_ptr->draws);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, title_ptr->focussed_wlr_buffer_ptr);
+
+    // Not in the scene graph: Any number of changes, no redraw.
+    for (int i = 0; i < 1000; ++i) {
+        wlmtk_titlebar_title_set_title(title_ptr, titles[i % 3]);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, title_ptr->draws);
+
+    // Adding to the scene graph performs the pending redraw.
+    wlmtk_container_add_element(fake_parent_ptr, element_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, title_ptr->draws);
+    struct wlr_scene_buffer *wlr_scene_buffer_ptr =
+        title_ptr->super_buffer.wlr_scene_buffer_ptr;
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wlr_scene_buffer_ptr);
+
+    // A stream of changes across 10 frames: One redraw per frame, at most.
+    // Emitting `frame_done` emulates a frame of an output showing the title.
+    for (int frame = 0; frame < 10; ++frame) {
+        for (int i = 0; i < 100; ++i) {
+            wlmtk_titlebar_title_set_title(title_ptr, titles[i % 3]);
+        }
+        wl_signal_emit(&wlr_scene_buffer_ptr->events.frame_done, &now);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 12, title_ptr->draws);
+
+    // Frames without title changes do not redraw.
+    wl_signal_emit(&wlr_scene_buffer_ptr->events.frame_done, &now);
+    BS_TEST_VERIFY_EQ(test_ptr, 12, title_ptr->draws);
+
+    // Activating draws the focussed buffer on demand, once.
+    wlmtk_titlebar_title_set_activated(title_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 13, title_ptr->draws);
+    wlmtk_titlebar_title_set_activated(title_ptr, false);
+    wlmtk_titlebar_title_set_activated(title_ptr, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 13, title_ptr->draws);
+
+    // A change pending while activation changes: Drawn right away.
+    wlmtk_titlebar_title_set_title(title_ptr, titles[1]);
+    wlmtk_titlebar_title_set_activated(title_ptr, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 14, title_ptr->draws);
+    wl_signal_emit(&wlr_scene_buffer_ptr->events.frame_done, &now);
+    BS_TEST_VERIFY_EQ(test_ptr, 14, title_ptr->draws);
+
+    wlmtk_container_remove_element(fake_parent_ptr, element_ptr);
+    wlmtk_titlebar_title_destroy(title_ptr);
+    wlmtk_window_destroy(w);
+    wlmtk_element_destroy(&fe_ptr->element);
+    wlmtk_container_destroy_fake_parent(fake_parent_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests drawing on the rasterization pool: Buffers show once handed back. */
+void test_deferred(bs_test_t *test_ptr)
+{
+    struct wlmtk_titlebar_style style = {
+        .focussed_fill = {
+            .type = WLMTK_STYLE_COLOR_SOLID,
+            .param = { .solid = { .color = 0xff2020c0 } }
+        },
+        .height = 22, .font = { .face = "Helvetica", .size = 15 } };
+
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlmtk_raster_pool_t *pool_ptr = wlmtk_raster_pool_create(
+        wl_event_loop_ptr, 1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, pool_ptr);
+    wlmtk_raster_set_pool(pool_ptr);
+
+    wlmtk_fake_element_t *fe_ptr = wlmtk_fake_element_create();
+    wlmtk_window_t *w = wlmtk_test_window_create(&fe_ptr->element);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    wlmtk_titlebar_title_t *title_ptr = wlmtk_titlebar_title_create(w);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, title_ptr);
+    struct wlr_buffer **wlr_buffer_ptr_ptr =
+        &title_ptr->super_buffer.wlr_buffer_ptr;
+
+    // No buffer until the job is handed back.
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            title_ptr, 120, 10, 90, true, "Title", &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, title_ptr->job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, title_ptr->focussed_wlr_buffer_ptr);
+
+    // The style changes while the job is pending: The new style is shown.
+    style.focussed_fill.param.solid.color = 0xff40c020;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            title_ptr, 120, 10, 90, true, "Title", &style));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, *wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(
+        test_ptr,
+        wlmtk_test_wait_for_buffer(wl_event_loop_ptr, wlr_buffer_ptr_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, title_ptr->job_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, title_ptr->draws);
+    bs_gfxbuf_t *g = bs_gfxbuf_from_wlr_buffer(*wlr_buffer_ptr_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0xff40c020, g->data_ptr[11 * g->pixels_per_line + 2]);
+
+    // Destroying the title cancels its pending job. Destroying the pool
+    // then hands back all jobs: The cancelled one must not be applied.
+    style.focussed_fill.param.solid.color = 0xffc04020;
+    BS_TEST_VERIFY_TRUE(
+        test_ptr,
+        wlmtk_titlebar_title_redraw(
+            title_ptr, 120, 10, 90, true, "Title", &style));
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, title_ptr->job_ptr);
+    wlmtk_titlebar_title_destroy(title_ptr);
+    wlmtk_raster_pool_destroy(pool_ptr);
+
+    wlmtk_window_destroy(w);
+    wlmtk_element_destroy(&fe_ptr->element);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
 /* == End of titlebar_title.c ============================================== */
@@ -138,6 +138,12 @@ struct _wlmtk_window_t {
     bool                      shaded;
     /** Whether this window is currently activated (has keyboard focus). */
     bool                      activated;
+    /** Whether the content is fully opaque. */
+    bool                      opaque;
+    /** Effective visibility. See @ref wlmtk_window_is_visible. */
+    bool                      visible;
+    /** Whether @ref wlmtk_window_t::visible was reported since mapped. */
+    bool                      visibility_reported;
 };
 
 /** Type-safe holder for the window style's reference counter. */
@@ -235,6 +241,7 @@ wlmtk_window_t *wlmtk_window_create(
     wl_signal_init(&window_ptr->events.request_size);
     wl_signal_init(&window_ptr->events.request_fullscreen);
     wl_signal_init(&window_ptr->events.request_maximized);
+    wl_signal_init(&window_ptr->events.visibility_changed);
     window_ptr->move_modifier = WLR_MODIFIER_ALT;
 
     if (!wlmtk_window_set_title(window_ptr, NULL)) goto error;
@@ -708,6 +715,40 @@ bool wlmtk_window_is_shaded(wlmtk_window_t *window_ptr)
     return window_ptr->shaded;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_set_opaque(wlmtk_window_t *window_ptr, bool opaque)
+{
+    if (window_ptr->opaque == opaque) return;
+    window_ptr->opaque = opaque;
+    if (NULL != window_ptr->workspace_ptr) {
+        wlmtk_workspace_update_visibility(window_ptr->workspace_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_is_opaque(wlmtk_window_t *window_ptr)
+{
+    return window_ptr->opaque;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_window_set_visibility(wlmtk_window_t *window_ptr, bool visible)
+{
+    // The first visibility after mapping is always reported: The window may
+    // be covered right away, and `visible` just holds the unmapped default.
+    if (window_ptr->visibility_reported &&
+        window_ptr->visible == visible) return;
+    window_ptr->visible = visible;
+    window_ptr->visibility_reported = true;
+    wl_signal_emit(&window_ptr->events.visibility_changed, window_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmtk_window_is_visible(wlmtk_window_t *window_ptr)
+{
+    return window_ptr->visible;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmtk_window_menu_set_enabled(wlmtk_window_t *window_ptr, bool enabled)
 {
@@ -779,6 +820,12 @@ void wlmtk_window_set_workspace(
 {
     if (window_ptr->workspace_ptr == workspace_ptr) return;
     window_ptr->workspace_ptr = workspace_ptr;
+    // Unmapped: Quietly reset. The workspace reports visibility once mapped,
+    // and the client may have gone already.
+    if (NULL == workspace_ptr) {
+        window_ptr->visible = false;
+        window_ptr->visibility_reported = false;
+    }
 
     wl_signal_emit(&window_ptr->events.state_changed, window_ptr);
 }
@@ -1031,6 +1078,11 @@ void _wlmtk_window_element_layout(
     wlmtk_element_set_position(
         wlmtk_bordered_element(&window_ptr->bordered), x, y);
     window_ptr->old_box = new_box;
+
+    // Size or shading may have changed what this window covers.
+    if (NULL != window_ptr->workspace_ptr) {
+        wlmtk_workspace_update_visibility(window_ptr->workspace_ptr);
+    }
 }
 
 /* ------------------------------------------------------------------------- */
@@ -128,6 +128,9 @@ struct _wlmtk_workspace_t {
     /** Listener for @ref wlmtk_element_events_t::pointer_motion. */
     struct wl_listener        element_pointer_motion_listener;
 
+    /** Idle source for a pending update of windows' visibility, or NULL. */
+    struct wl_event_source    *visibility_idle_ptr;
+
     // Elements below not owned by wlmtk_workspace_t.
     /** Output layout. */
     struct wlr_output_layout *wlr_output_layout_ptr;
@@ -156,6 +159,10 @@ static void _wlmtk_workspace_handle_element_pointer_motion(
 static void _wlmtk_window_reposition_window(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
+static void _wlmtk_workspace_handle_visibility_idle(void *data_ptr);
+static bool _wlmtk_workspace_window_covered(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr);
 static bool _wlmtk_workspace_window_overlaps(
     bs_dllist_node_t *dlnode_ptr,
     void *ud_ptr);
@@ -345,6 +352,10 @@ wlmtk_workspace_t *wlmtk_workspace_create(
 /* ------------------------------------------------------------------------- */
 void wlmtk_workspace_destroy(wlmtk_workspace_t *workspace_ptr)
 {
+    if (NULL != workspace_ptr->visibility_idle_ptr) {
+        wl_event_source_remove(workspace_ptr->visibility_idle_ptr);
+        workspace_ptr->visibility_idle_ptr = NULL;
+    }
     wlmtk_util_disconnect_listener(
         &workspace_ptr->output_layout_change_listener);
 
@@ -538,6 +549,7 @@ void wlmtk_workspace_enable(wlmtk_workspace_t *workspace_ptr, bool enabled)
             workspace_ptr,
             workspace_ptr->formerly_activated_window_ptr);
     }
+    wlmtk_workspace_update_visibility(workspace_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -562,6 +574,7 @@ void wlmtk_workspace_map_window(wlmtk_workspace_t *workspace_ptr,
                          wlmtk_dlnode_from_window(window_ptr));
     wlmtk_window_set_workspace(window_ptr, workspace_ptr);
     wlmtk_workspace_activate_window(workspace_ptr, window_ptr);
+    wlmtk_workspace_update_visibility(workspace_ptr);
 
     if (NULL != workspace_ptr->desktop_ptr) {
         wl_signal_emit(
@@ -606,6 +619,7 @@ void wlmtk_workspace_unmap_window(wlmtk_workspace_t *workspace_ptr,
     bs_dllist_remove(&workspace_ptr->windows,
                      wlmtk_dlnode_from_window(window_ptr));
     wlmtk_window_set_workspace(window_ptr, NULL);
+    wlmtk_workspace_update_visibility(workspace_ptr);
     if (NULL != workspace_ptr->desktop_ptr) {
         wl_signal_emit(
             &wlmtk_desktop_events(workspace_ptr->desktop_ptr)->window_unmapped,
@@ -634,6 +648,7 @@ void wlmtk_workspace_set_window_position(
     if (workspace_ptr != wlmtk_window_get_workspace(window_ptr)) return;
     wlmtk_element_set_position(wlmtk_window_element(window_ptr), x, y);
     wlmtk_window_position_changed(window_ptr);
+    wlmtk_workspace_update_visibility(workspace_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -720,6 +735,7 @@ void wlmtk_workspace_window_to_fullscreen(
         bs_dllist_push_front(&workspace_ptr->windows,
                              wlmtk_dlnode_from_window(window_ptr));
     }
+    wlmtk_workspace_update_visibility(workspace_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -829,6 +845,25 @@ void wlmtk_workspace_raise_window(
                          wlmtk_dlnode_from_window(window_ptr));
     wlmtk_container_raise_element_to_top(&workspace_ptr->window_container,
                                          wlmtk_window_element(window_ptr));
+    wlmtk_workspace_update_visibility(workspace_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmtk_workspace_update_visibility(wlmtk_workspace_t *workspace_ptr)
+{
+    if (NULL != workspace_ptr->visibility_idle_ptr) return;
+
+    if (NULL != workspace_ptr->wlr_output_layout_ptr &&
+        NULL != workspace_ptr->wlr_output_layout_ptr->display) {
+        workspace_ptr->visibility_idle_ptr = wl_event_loop_add_idle(
+            wl_display_get_event_loop(
+                workspace_ptr->wlr_output_layout_ptr->display),
+            _wlmtk_workspace_handle_visibility_idle,
+            workspace_ptr);
+        if (NULL != workspace_ptr->visibility_idle_ptr) return;
+        bs_log(BS_WARNING, "Failed wl_event_loop_add_idle(): Updating now.");
+    }
+    _wlmtk_workspace_handle_visibility_idle(workspace_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1039,6 +1074,77 @@ void _wlmtk_window_reposition_window(
     wlmtk_window_request_size(window_ptr, &wbox);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Updates the effective visibility of all mapped windows. Scheduled by
+ * @ref wlmtk_workspace_update_visibility as idle callback, so that a burst of
+ * changes, eg. when re-positioning all windows, is computed just once.
+ *
+ * @param data_ptr            Points to the @ref wlmtk_workspace_t.
+ */
+void _wlmtk_workspace_handle_visibility_idle(void *data_ptr)
+{
+    wlmtk_workspace_t *workspace_ptr = data_ptr;
+    workspace_ptr->visibility_idle_ptr = NULL;
+
+    wlmtk_container_t *containers[] = {
+        &workspace_ptr->fullscreen_container,
+        &workspace_ptr->window_container,
+    };
+    for (size_t i = 0; i < sizeof(containers) / sizeof(containers[0]); ++i) {
+        for (bs_dllist_node_t *dlnode_ptr = containers[i]->elements.head_ptr;
+             NULL != dlnode_ptr;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlmtk_window_t *window_ptr = wlmtk_window_from_element(
+                wlmtk_element_from_dlnode(dlnode_ptr));
+            wlmtk_window_set_visibility(
+                window_ptr,
+                workspace_ptr->enabled &&
+                !wlmtk_window_is_shaded(window_ptr) &&
+                !_wlmtk_workspace_window_covered(workspace_ptr, window_ptr));
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether `window_ptr` is fully covered by an opaque window stacked
+ * above it. Fullscreen windows stack above all others.
+ *
+ * @param workspace_ptr
+ * @param window_ptr
+ *
+ * @return true if covered.
+ */
+bool _wlmtk_workspace_window_covered(
+    wlmtk_workspace_t *workspace_ptr,
+    wlmtk_window_t *window_ptr)
+{
+    struct wlr_box box = wlmtk_window_get_bounding_box(window_ptr);
+    wlmtk_container_t *containers[] = {
+        &workspace_ptr->fullscreen_container,
+        &workspace_ptr->window_container,
+    };
+    for (size_t i = 0; i < sizeof(containers) / sizeof(containers[0]); ++i) {
+        for (bs_dllist_node_t *dlnode_ptr = containers[i]->elements.head_ptr;
+             NULL != dlnode_ptr;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlmtk_window_t *above_ptr = wlmtk_window_from_element(
+                wlmtk_element_from_dlnode(dlnode_ptr));
+            // Reached the window itself: Nothing else is above.
+            if (above_ptr == window_ptr) return false;
+            if (!wlmtk_window_is_opaque(above_ptr) ||
+                wlmtk_window_is_shaded(above_ptr)) continue;
+
+            struct wlr_box a = wlmtk_window_get_bounding_box(above_ptr);
+            if (a.x <= box.x && a.y <= box.y &&
+                a.x + a.width >= box.x + box.width &&
+                a.y + a.height >= box.y + box.height) return true;
+        }
+    }
+    return false;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Iterator for `bs_dllist_any`: Does window at `dlnode_ptr` overlap? */
 bool _wlmtk_workspace_window_overlaps(
@@ -1244,6 +1350,7 @@ static void test_activate_cycling(bs_test_t *test_ptr);
 static void test_multi_output_extents(bs_test_t *test_ptr);
 static void test_multi_output_reposition(bs_test_t *test_ptr);
 static void test_window_position(bs_test_t *test_ptr);
+static void test_visibility(bs_test_t *test_ptr);
 
 static void *_wlmtk_workspace_test_setup(void);
 static void _wlmtk_workspace_test_teardown(void *setup_context_ptr);
@@ -1263,6 +1370,7 @@ static const bs_test_case_t _wlmtk_workspace_test_cases[] = {
     { 1, "multi_output_extents", test_multi_output_extents },
     { 1, "multi_output_reposition", test_multi_output_reposition },
     { 1, "window_position", test_window_position },
+    { 1, "visibility", test_visibility },
     BS_TEST_CASE_SENTINEL()
 };
 
@@ -2142,4 +2250,153 @@ void test_window_position(bs_test_t *test_ptr)
     wlr_output_layout_remove(c_ptr->wlr_output_layout_ptr, &o1);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests tracking of windows' effective visibility. */
+void test_visibility(bs_test_t *test_ptr)
+{
+    struct _wlmtk_workspace_test_context *c_ptr = bs_test_context(test_ptr);
+    wlmtk_workspace_t *ws_ptr = c_ptr->workspace_ptr;
+    struct wl_event_loop *loop_ptr = wl_display_get_event_loop(
+        c_ptr->wl_display_ptr);
+
+    struct wlr_output o1 = { .width = 800, .height = 600, .scale = 1 };
+    wlmtk_test_wlr_output_init(&o1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(
+        test_ptr,
+        NULL,
+        wlr_output_layout_add(c_ptr->wlr_output_layout_ptr, &o1, 0, 0));
+
+    wlmtk_fake_element_t *fe1_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe1_ptr);
+    wlmtk_fake_element_set_dimensions(fe1_ptr, 100, 50);
+    wlmtk_window_t *w1 = wlmtk_test_window_create(&fe1_ptr->element);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w1);
+    wlmtk_util_test_listener_t l1;
+    wlmtk_util_connect_test_listener(
+        &wlmtk_window_events(w1)->visibility_changed, &l1);
+
+    // Not visible before mapped. Becomes visible when mapped.
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+    wlmtk_workspace_map_window(ws_ptr, w1);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l1.calls);
+    wlmtk_workspace_set_window_position(ws_ptr, w1, 20, 10);
+    wl_event_loop_dispatch_idle(loop_ptr);
+
+    // A larger window on top, not opaque: Both visible.
+    wlmtk_fake_element_t *fe2_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe2_ptr);
+    wlmtk_fake_element_set_dimensions(fe2_ptr, 200, 100);
+    wlmtk_window_t *w2 = wlmtk_test_window_create(&fe2_ptr->element);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w2);
+    wlmtk_workspace_map_window(ws_ptr, w2);
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 0, 0);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w2));
+
+    // Opaque: Covers w1.
+    wlmtk_window_set_opaque(w2, true);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w2));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, l1.calls);
+
+    // Moving w2 to only partially cover w1: Visible again.
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 50, 0);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 0, 0);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+
+    // A burst of changes is only computed once, when idle.
+    l1.calls = 0;
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 50, 0);
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 60, 0);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l1.calls);
+    wlmtk_workspace_set_window_position(ws_ptr, w2, 0, 0);
+    wl_event_loop_dispatch_idle(loop_ptr);
+
+    // Raising w1 puts it above w2.
+    wlmtk_workspace_raise_window(ws_ptr, w1);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    wlmtk_workspace_raise_window(ws_ptr, w2);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+
+    // Shrinking w2 uncovers w1.
+    wlmtk_fake_element_set_dimensions(fe2_ptr, 50, 50);
+    wlmtk_window_commit_size(w2, 50, 50);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    wlmtk_fake_element_set_dimensions(fe2_ptr, 200, 100);
+    wlmtk_window_commit_size(w2, 200, 100);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+
+    // Disabling the workspace hides all. Enabling recovers the state.
+    wlmtk_workspace_enable(ws_ptr, false);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w2));
+    wlmtk_workspace_enable(ws_ptr, true);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w2));
+
+    // A window covered before its visibility is first computed: Reported.
+    wlmtk_fake_element_t *fe3_ptr = wlmtk_fake_element_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fe3_ptr);
+    wlmtk_fake_element_set_dimensions(fe3_ptr, 50, 20);
+    wlmtk_window_t *w3 = wlmtk_test_window_create(&fe3_ptr->element);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w3);
+    wlmtk_util_test_listener_t l3;
+    wlmtk_util_connect_test_listener(
+        &wlmtk_window_events(w3)->visibility_changed, &l3);
+    wlmtk_workspace_map_window(ws_ptr, w3);
+    wlmtk_workspace_set_window_position(ws_ptr, w3, 10, 10);
+    wlmtk_workspace_raise_window(ws_ptr, w2);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w3));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l3.calls);
+
+    // Re-mapped, and covered again: Reported again.
+    wlmtk_workspace_unmap_window(ws_ptr, w3);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l3.calls);
+    wlmtk_workspace_map_window(ws_ptr, w3);
+    wlmtk_workspace_set_window_position(ws_ptr, w3, 10, 10);
+    wlmtk_workspace_raise_window(ws_ptr, w2);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w3));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, l3.calls);
+    wlmtk_util_disconnect_test_listener(&l3);
+    wlmtk_workspace_unmap_window(ws_ptr, w3);
+    wlmtk_window_destroy(w3);
+    wlmtk_element_destroy(&fe3_ptr->element);
+    wl_event_loop_dispatch_idle(loop_ptr);
+
+    // Unmapping w2 uncovers w1. w2 quietly reports not visible.
+    l1.calls = 0;
+    wlmtk_workspace_unmap_window(ws_ptr, w2);
+    wl_event_loop_dispatch_idle(loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmtk_window_is_visible(w1));
+    BS_TEST_VERIFY_FALSE(test_ptr, wlmtk_window_is_visible(w2));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, l1.calls);
+
+    wlmtk_util_disconnect_test_listener(&l1);
+    wlmtk_workspace_unmap_window(ws_ptr, w1);
+    wlmtk_window_destroy(w2);
+    wlmtk_window_destroy(w1);
+    wlmtk_element_destroy(&fe2_ptr->element);
+    wlmtk_element_destroy(&fe1_ptr->element);
+    wlr_output_layout_remove(c_ptr->wlr_output_layout_ptr, &o1);
+}
+
 /* == End of workspace.c =================================================== */
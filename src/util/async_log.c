@@ -0,0 +1,1066 @@
+/* ========================================================================= */
+/**
+ * @file async_log.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** For `pipe2`, `memrchr` and `F_SETPIPE_SZ`. */
+#define _GNU_SOURCE
+
+#include "async_log.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** State of the asynchronous log. */
+struct _wlm_util_async_log_t {
+    /** Copy of the options. `fname_ptr` points to an owned copy. */
+    wlm_util_async_log_options_t options;
+
+    /** Duplicate of the original stderr. Restored on destroy. */
+    int                       stderr_fd;
+    /** Whether stderr currently points to the pipe. */
+    bool                      redirected;
+    /** Read end of the pipe that replaced stderr. Non-blocking. */
+    int                       pipe_fd;
+    /** Where entries go: The log file, or @ref stderr_fd. */
+    int                       output_fd;
+    /** Size of the log file. Belongs to the writer thread. */
+    size_t                    file_size;
+    /** Whether the output ends within a line. Belongs to the writer thread. */
+    bool                      output_in_line;
+
+    /** The ring buffer. */
+    uint8_t                   *ring_ptr;
+    /** Size of the ring buffer. A power of 2. */
+    size_t                    ring_size;
+    /** Bytes ever pushed. Written by the capture thread only. */
+    atomic_size_t             head;
+    /** Bytes ever written. Written by the writer thread only. */
+    atomic_size_t             tail;
+    /** Lines dropped or cut for a full buffer. */
+    atomic_uint_fast64_t      dropped;
+    /** Dropped lines already reported. Belongs to the writer thread. */
+    uint64_t                  dropped_reported;
+    /** Whether the ring ends within a line. Belongs to the capture thread. */
+    bool                      in_line;
+    /** Whether the rest of the current line is dropped. As @ref in_line. */
+    bool                      dropping;
+
+    /** eventfd: Wakes the writer thread. */
+    int                       wake_fd;
+    /** eventfd: Tells the capture thread to drain the pipe, and stop. */
+    int                       stop_fd;
+    /** Set by the capture thread when stopped. The writer then drains. */
+    atomic_bool               capture_done;
+    /** Set on the crash path: Threads leave the ring and pipe alone. */
+    atomic_bool               crashed;
+
+    /** The capture thread: Moves the pipe's contents into the ring. */
+    pthread_t                 capture_thread;
+    /** Whether @ref capture_thread was started. */
+    bool                      capture_started;
+    /** The writer thread: Writes the ring's contents to the output. */
+    pthread_t                 writer_thread;
+    /** Whether @ref writer_thread was started. */
+    bool                      writer_started;
+};
+
+static int _wlm_util_async_log_open(const char *fname_ptr);
+static void _wlm_util_async_log_atexit(void);
+static void _wlm_util_async_log_register_atexit(void);
+static void *_wlm_util_async_log_capture(void *arg_ptr);
+static void _wlm_util_async_log_push(
+    wlm_util_async_log_t *async_log_ptr,
+    const uint8_t *data_ptr,
+    size_t len);
+static size_t _wlm_util_async_log_copy(
+    wlm_util_async_log_t *async_log_ptr,
+    size_t head,
+    const uint8_t *data_ptr,
+    size_t len);
+static void *_wlm_util_async_log_writer(void *arg_ptr);
+static void _wlm_util_async_log_drain(wlm_util_async_log_t *async_log_ptr);
+static void _wlm_util_async_log_output(
+    wlm_util_async_log_t *async_log_ptr,
+    const uint8_t *data_ptr,
+    size_t len);
+static void _wlm_util_async_log_rotate(wlm_util_async_log_t *async_log_ptr);
+static void _wlm_util_async_log_forward_start(
+    wlm_util_async_log_t *async_log_ptr);
+static void *_wlm_util_async_log_forward(void *arg_ptr);
+static bool _wlm_util_async_log_write_fd(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr);
+static void _wlm_util_async_log_wake(int fd);
+
+/* == Data ================================================================= */
+
+/** Size of the pipe replacing stderr, in bytes. Set if permitted. */
+static const int              _wlm_util_async_log_pipe_size = 256 * 1024;
+
+/** Size of chunks read from the pipe, in bytes. */
+#define _WLM_UTIL_ASYNC_LOG_CHUNK_SIZE 4096
+
+/** The instance. Global, since it owns stderr; and for the crash path. */
+static _Atomic(wlm_util_async_log_t *) _wlm_util_async_log_ptr;
+
+/** Guards registering @ref _wlm_util_async_log_atexit. */
+static pthread_once_t         _wlm_util_async_log_atexit_once =
+    PTHREAD_ONCE_INIT;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_util_async_log_t *wlm_util_async_log_create(
+    const wlm_util_async_log_options_t *options_ptr)
+{
+    if (NULL != atomic_load(&_wlm_util_async_log_ptr)) {
+        bs_log(BS_ERROR, "An asynchronous log exists already.");
+        return NULL;
+    }
+
+    wlm_util_async_log_t *async_log_ptr = logged_calloc(
+        1, sizeof(wlm_util_async_log_t));
+    if (NULL == async_log_ptr) return NULL;
+    async_log_ptr->options = *options_ptr;
+    async_log_ptr->options.fname_ptr = NULL;
+    async_log_ptr->stderr_fd = -1;
+    async_log_ptr->pipe_fd = -1;
+    async_log_ptr->output_fd = -1;
+    async_log_ptr->wake_fd = -1;
+    async_log_ptr->stop_fd = -1;
+    if (NULL == async_log_ptr->options.write_fn) {
+        async_log_ptr->options.write_fn = _wlm_util_async_log_write_fd;
+    }
+
+    async_log_ptr->ring_size = _WLM_UTIL_ASYNC_LOG_CHUNK_SIZE;
+    while (async_log_ptr->ring_size < options_ptr->buffer_size &&
+           async_log_ptr->ring_size < SIZE_MAX / 2) {
+        async_log_ptr->ring_size *= 2;
+    }
+    async_log_ptr->ring_ptr = logged_malloc(async_log_ptr->ring_size);
+    if (NULL == async_log_ptr->ring_ptr) goto error;
+
+    async_log_ptr->stderr_fd = fcntl(STDERR_FILENO, F_DUPFD_CLOEXEC, 3);
+    if (0 > async_log_ptr->stderr_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed fcntl(%d, F_DUPFD_CLOEXEC, 3)",
+               STDERR_FILENO);
+        goto error;
+    }
+
+    if (NULL != options_ptr->fname_ptr) {
+        async_log_ptr->options.fname_ptr = logged_strdup(
+            options_ptr->fname_ptr);
+        if (NULL == async_log_ptr->options.fname_ptr) goto error;
+        async_log_ptr->output_fd = _wlm_util_async_log_open(
+            async_log_ptr->options.fname_ptr);
+        struct stat stat_buf;
+        if (0 > async_log_ptr->output_fd ||
+            0 != fstat(async_log_ptr->output_fd, &stat_buf)) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed to open log file \"%s\"",
+                   async_log_ptr->options.fname_ptr);
+            goto error;
+        }
+        async_log_ptr->file_size = stat_buf.st_size;
+    } else {
+        async_log_ptr->output_fd = async_log_ptr->stderr_fd;
+    }
+
+    async_log_ptr->wake_fd = eventfd(0, EFD_CLOEXEC);
+    async_log_ptr->stop_fd = eventfd(0, EFD_CLOEXEC);
+    if (0 > async_log_ptr->wake_fd || 0 > async_log_ptr->stop_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed eventfd(0, EFD_CLOEXEC)");
+        goto error;
+    }
+
+    int pipe_fds[2];
+    if (0 != pipe2(pipe_fds, O_CLOEXEC)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pipe2(%p, O_CLOEXEC)", pipe_fds);
+        goto error;
+    }
+    async_log_ptr->pipe_fd = pipe_fds[0];
+    // Best effort: A larger pipe buffers bursts while threads are scheduled.
+    // The write end stays blocking: Children inherit it, as their stderr.
+    fcntl(pipe_fds[1], F_SETPIPE_SZ, _wlm_util_async_log_pipe_size);
+    if (0 != fcntl(pipe_fds[0], F_SETFL, O_NONBLOCK)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed fcntl(%d, F_SETFL, O_NONBLOCK)",
+               pipe_fds[0]);
+        close(pipe_fds[1]);
+        goto error;
+    }
+
+    int rv = pthread_create(
+        &async_log_ptr->writer_thread, NULL,
+        _wlm_util_async_log_writer, async_log_ptr);
+    if (0 == rv) {
+        async_log_ptr->writer_started = true;
+        rv = pthread_create(
+            &async_log_ptr->capture_thread, NULL,
+            _wlm_util_async_log_capture, async_log_ptr);
+        async_log_ptr->capture_started = (0 == rv);
+    }
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create()");
+        close(pipe_fds[1]);
+        goto error;
+    }
+
+    // Redirect. dup2() clears FD_CLOEXEC: Children inherit the pipe.
+    fflush(stderr);
+    if (0 > dup2(pipe_fds[1], STDERR_FILENO)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed dup2(%d, %d)",
+               pipe_fds[1], STDERR_FILENO);
+        close(pipe_fds[1]);
+        goto error;
+    }
+    close(pipe_fds[1]);
+    async_log_ptr->redirected = true;
+
+    atomic_store(&_wlm_util_async_log_ptr, async_log_ptr);
+    pthread_once(&_wlm_util_async_log_atexit_once,
+                 _wlm_util_async_log_register_atexit);
+    return async_log_ptr;
+
+error:
+    wlm_util_async_log_destroy(async_log_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_async_log_destroy(wlm_util_async_log_t *async_log_ptr)
+{
+    wlm_util_async_log_t *expected_ptr = async_log_ptr;
+    atomic_compare_exchange_strong(
+        &_wlm_util_async_log_ptr, &expected_ptr, NULL);
+
+    if (async_log_ptr->redirected) {
+        fflush(stderr);
+        dup2(async_log_ptr->stderr_fd, STDERR_FILENO);
+        async_log_ptr->redirected = false;
+    }
+
+    // Stops the capture thread, which drains the pipe. The writer thread then
+    // writes everything that is left in the ring.
+    if (async_log_ptr->capture_started) {
+        _wlm_util_async_log_wake(async_log_ptr->stop_fd);
+        pthread_join(async_log_ptr->capture_thread, NULL);
+        async_log_ptr->capture_started = false;
+    } else {
+        atomic_store(&async_log_ptr->capture_done, true);
+        if (0 <= async_log_ptr->wake_fd) {
+            _wlm_util_async_log_wake(async_log_ptr->wake_fd);
+        }
+    }
+    if (async_log_ptr->writer_started) {
+        pthread_join(async_log_ptr->writer_thread, NULL);
+        async_log_ptr->writer_started = false;
+    }
+
+    // Children may still hold the pipe as their stderr. Keep reading it, so
+    // they neither block on it nor get SIGPIPE.
+    if (0 <= async_log_ptr->pipe_fd) {
+        _wlm_util_async_log_forward_start(async_log_ptr);
+    }
+    if (0 <= async_log_ptr->stop_fd) close(async_log_ptr->stop_fd);
+    if (0 <= async_log_ptr->wake_fd) close(async_log_ptr->wake_fd);
+    if (0 <= async_log_ptr->output_fd &&
+        async_log_ptr->output_fd != async_log_ptr->stderr_fd) {
+        close(async_log_ptr->output_fd);
+    }
+    if (0 <= async_log_ptr->stderr_fd) close(async_log_ptr->stderr_fd);
+
+    if (NULL != async_log_ptr->options.fname_ptr) {
+        free((char*)async_log_ptr->options.fname_ptr);
+        async_log_ptr->options.fname_ptr = NULL;
+    }
+    if (NULL != async_log_ptr->ring_ptr) {
+        free(async_log_ptr->ring_ptr);
+        async_log_ptr->ring_ptr = NULL;
+    }
+    free(async_log_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlm_util_async_log_dropped(wlm_util_async_log_t *async_log_ptr)
+{
+    return atomic_load(&async_log_ptr->dropped);
+}
+
+/* ------------------------------------------------------------------------- */
+int wlm_util_async_log_child_stderr_fd(void)
+{
+    wlm_util_async_log_t *async_log_ptr = atomic_load(
+        &_wlm_util_async_log_ptr);
+    if (NULL == async_log_ptr || !async_log_ptr->redirected) return -1;
+    return async_log_ptr->stderr_fd;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_async_log_crash_flush(void)
+{
+    wlm_util_async_log_t *async_log_ptr = atomic_exchange(
+        &_wlm_util_async_log_ptr, NULL);
+    if (NULL == async_log_ptr) return;
+    atomic_store(&async_log_ptr->crashed, true);
+    int fd = async_log_ptr->output_fd;
+    if (0 > fd) fd = async_log_ptr->stderr_fd;
+
+    // Older entries are in the ring, newer ones still in the pipe.
+    size_t tail = atomic_load(&async_log_ptr->tail);
+    size_t head = atomic_load(&async_log_ptr->head);
+    while (tail != head) {
+        size_t pos = tail & (async_log_ptr->ring_size - 1);
+        size_t len = BS_MIN(head - tail, async_log_ptr->ring_size - pos);
+        _wlm_util_async_log_write_fd(
+            fd, async_log_ptr->ring_ptr + pos, len, NULL);
+        tail += len;
+    }
+    uint8_t buf[_WLM_UTIL_ASYNC_LOG_CHUNK_SIZE];
+    ssize_t n;
+    while (0 < (n = read(async_log_ptr->pipe_fd, buf, sizeof(buf)))) {
+        _wlm_util_async_log_write_fd(fd, buf, n, NULL);
+    }
+
+    dup2(fd, STDERR_FILENO);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Opens `fname_ptr` for appending. Returns the file descriptor, or -1. */
+int _wlm_util_async_log_open(const char *fname_ptr)
+{
+    return open(fname_ptr, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC,
+                S_IRUSR | S_IWUSR);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroys a log still existing at exit(), so no entry gets lost. */
+void _wlm_util_async_log_atexit(void)
+{
+    wlm_util_async_log_t *async_log_ptr = atomic_load(
+        &_wlm_util_async_log_ptr);
+    if (NULL != async_log_ptr) wlm_util_async_log_destroy(async_log_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Registers @ref _wlm_util_async_log_atexit. Called once. */
+void _wlm_util_async_log_register_atexit(void)
+{
+    atexit(_wlm_util_async_log_atexit);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Capture thread: Moves data from the pipe into the ring, until told to stop.
+ * Then drains the pipe, and flags @ref wlm_util_async_log_t::capture_done.
+ *
+ * Must not log: Messages would end up in its own pipe.
+ *
+ * @param arg_ptr             Points to @ref wlm_util_async_log_t.
+ *
+ * @return NULL.
+ */
+void *_wlm_util_async_log_capture(void *arg_ptr)
+{
+    wlm_util_async_log_t *async_log_ptr = arg_ptr;
+    uint8_t buf[_WLM_UTIL_ASYNC_LOG_CHUNK_SIZE];
+    struct pollfd pollfds[2] = {
+        { .fd = async_log_ptr->pipe_fd, .events = POLLIN },
+        { .fd = async_log_ptr->stop_fd, .events = POLLIN }
+    };
+    bool stopping = false;
+
+    while (!atomic_load(&async_log_ptr->crashed)) {
+        if (!stopping) {
+            if (0 > poll(pollfds, 2, -1)) {
+                if (EINTR == errno) continue;
+                break;
+            }
+            stopping = 0 != pollfds[1].revents;
+        }
+
+        ssize_t n = read(async_log_ptr->pipe_fd, buf, sizeof(buf));
+        if (0 < n) {
+            _wlm_util_async_log_push(async_log_ptr, buf, n);
+        } else if (0 > n && EINTR == errno) {
+            continue;
+        } else if (stopping || 0 == n) {
+            // Drained while stopping; or no writer is left.
+            break;
+        }
+    }
+
+    atomic_store(&async_log_ptr->capture_done, true);
+    _wlm_util_async_log_wake(async_log_ptr->wake_fd);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Pushes `data_ptr` into the ring. If the ring is full, drops at line
+ * boundaries: Complete lines that fit are kept, the rest is dropped up to
+ * the end of the line continuing in the next push.
+ *
+ * One byte is kept free while the ring ends within a line, so that a line
+ * cut for a full ring can always be terminated.
+ *
+ * @param async_log_ptr
+ * @param data_ptr
+ * @param len
+ */
+void _wlm_util_async_log_push(
+    wlm_util_async_log_t *async_log_ptr,
+    const uint8_t *data_ptr,
+    size_t len)
+{
+    if (async_log_ptr->dropping) {
+        const uint8_t *nl_ptr = memchr(data_ptr, '\n', len);
+        if (NULL == nl_ptr) return;
+        len -= (size_t)(nl_ptr - data_ptr) + 1;
+        data_ptr = nl_ptr + 1;
+        async_log_ptr->dropping = false;
+    }
+    if (0 == len) return;
+
+    size_t head = atomic_load_explicit(
+        &async_log_ptr->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(
+        &async_log_ptr->tail, memory_order_acquire);
+    size_t room = async_log_ptr->ring_size - (head - tail);
+    bool ends_in_line = '\n' != data_ptr[len - 1];
+
+    if (len + ends_in_line <= room) {
+        head = _wlm_util_async_log_copy(async_log_ptr, head, data_ptr, len);
+    } else {
+        // Keeps the complete lines that fit. The rest counts as dropped.
+        const uint8_t *nl_ptr = NULL;
+        if (1 < room) nl_ptr = memrchr(data_ptr, '\n', room - 1);
+        size_t n = NULL != nl_ptr ? (size_t)(nl_ptr - data_ptr) + 1 : 0;
+        uint64_t lines = ends_in_line;
+        for (size_t i = n; i < len; ++i) lines += '\n' == data_ptr[i];
+        atomic_fetch_add(&async_log_ptr->dropped, lines);
+        async_log_ptr->dropping = ends_in_line;
+
+        if (0 < n) {
+            head = _wlm_util_async_log_copy(async_log_ptr, head, data_ptr, n);
+        } else if (async_log_ptr->in_line) {
+            // Terminates the line the ring ends with, in the spare byte.
+            head = _wlm_util_async_log_copy(
+                async_log_ptr, head, (const uint8_t*)"\n", 1);
+        }
+    }
+    atomic_store_explicit(
+        &async_log_ptr->head, head, memory_order_release);
+    _wlm_util_async_log_wake(async_log_ptr->wake_fd);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Copies `len` bytes into the ring at `head`. Does not publish them.
+ *
+ * @param async_log_ptr
+ * @param head
+ * @param data_ptr
+ * @param len                 Must be > 0, and fit into the ring.
+ *
+ * @return The new head.
+ */
+size_t _wlm_util_async_log_copy(
+    wlm_util_async_log_t *async_log_ptr,
+    size_t head,
+    const uint8_t *data_ptr,
+    size_t len)
+{
+    size_t pos = head & (async_log_ptr->ring_size - 1);
+    size_t first = BS_MIN(len, async_log_ptr->ring_size - pos);
+    memcpy(async_log_ptr->ring_ptr + pos, data_ptr, first);
+    memcpy(async_log_ptr->ring_ptr, data_ptr + first, len - first);
+    async_log_ptr->in_line = '\n' != data_ptr[len - 1];
+    return head + len;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writer thread: Writes the ring's contents whenever woken up. Exits after
+ * the final drain, once the capture thread is done.
+ *
+ * Must not log: Messages would end up in its own pipe.
+ *
+ * @param arg_ptr             Points to @ref wlm_util_async_log_t.
+ *
+ * @return NULL.
+ */
+void *_wlm_util_async_log_writer(void *arg_ptr)
+{
+    wlm_util_async_log_t *async_log_ptr = arg_ptr;
+
+    while (!atomic_load(&async_log_ptr->crashed)) {
+        // Read before draining: All data pushed before `done` gets written.
+        bool done = atomic_load(&async_log_ptr->capture_done);
+        _wlm_util_async_log_drain(async_log_ptr);
+        if (done) break;
+
+        uint64_t value;
+        while (0 > read(async_log_ptr->wake_fd, &value, sizeof(value)) &&
+               EINTR == errno) continue;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes all of the ring's contents, and reports any losses. */
+void _wlm_util_async_log_drain(wlm_util_async_log_t *async_log_ptr)
+{
+    size_t tail = atomic_load_explicit(
+        &async_log_ptr->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(
+        &async_log_ptr->head, memory_order_acquire);
+    while (tail != head && !atomic_load(&async_log_ptr->crashed)) {
+        size_t pos = tail & (async_log_ptr->ring_size - 1);
+        size_t len = BS_MIN(head - tail, async_log_ptr->ring_size - pos);
+        _wlm_util_async_log_output(
+            async_log_ptr, async_log_ptr->ring_ptr + pos, len);
+        async_log_ptr->output_in_line =
+            '\n' != async_log_ptr->ring_ptr[pos + len - 1];
+        tail += len;
+        atomic_store_explicit(
+            &async_log_ptr->tail, tail, memory_order_release);
+    }
+
+    // Reports go between lines. Reported later, if the output is within one.
+    if (async_log_ptr->output_in_line) return;
+
+    uint64_t dropped = atomic_load(&async_log_ptr->dropped);
+    if (dropped > async_log_ptr->dropped_reported) {
+        char buf[128];
+        int len = snprintf(
+            buf, sizeof(buf), "(async_log: Dropped %"PRIu64" lines.)\n",
+            dropped - async_log_ptr->dropped_reported);
+        _wlm_util_async_log_output(async_log_ptr, (uint8_t*)buf, len);
+        async_log_ptr->dropped_reported = dropped;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes to the output. Rotates the log file when it would grow beyond the
+ * size limit, splitting data after the last line that fits.
+ *
+ * @param async_log_ptr
+ * @param data_ptr
+ * @param len
+ */
+void _wlm_util_async_log_output(
+    wlm_util_async_log_t *async_log_ptr,
+    const uint8_t *data_ptr,
+    size_t len)
+{
+    size_t max_size = async_log_ptr->options.max_file_size;
+    if (NULL == async_log_ptr->options.fname_ptr) max_size = 0;
+
+    while (0 < len) {
+        size_t n = len;
+        if (0 < max_size && async_log_ptr->file_size + len > max_size) {
+            size_t room = 0;
+            if (max_size > async_log_ptr->file_size) {
+                room = max_size - async_log_ptr->file_size;
+            }
+            const uint8_t *nl_ptr = memrchr(data_ptr, '\n', room);
+            n = NULL != nl_ptr ? (size_t)(nl_ptr - data_ptr) + 1 : 0;
+            // A line longer than the limit: Written as a whole.
+            if (0 == n && 0 == async_log_ptr->file_size) n = len;
+        }
+
+        if (0 < n) {
+            if (0 <= async_log_ptr->output_fd) {
+                async_log_ptr->options.write_fn(
+                    async_log_ptr->output_fd, data_ptr, n,
+                    async_log_ptr->options.write_ud_ptr);
+            }
+            async_log_ptr->file_size += n;
+            data_ptr += n;
+            len -= n;
+        }
+        if (0 < len) _wlm_util_async_log_rotate(async_log_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Rotates the log file: `<fname>` becomes `<fname>.1`, `<fname>.1` becomes
+ * `<fname>.2`, and so on. The oldest beyond `keep_files` is overwritten.
+ *
+ * @param async_log_ptr
+ */
+void _wlm_util_async_log_rotate(wlm_util_async_log_t *async_log_ptr)
+{
+    const char *fname_ptr = async_log_ptr->options.fname_ptr;
+    if (0 <= async_log_ptr->output_fd) close(async_log_ptr->output_fd);
+
+    char from[PATH_MAX], to[PATH_MAX];
+    for (unsigned i = async_log_ptr->options.keep_files; i > 1; --i) {
+        snprintf(from, sizeof(from), "%s.%u", fname_ptr, i - 1);
+        snprintf(to, sizeof(to), "%s.%u", fname_ptr, i);
+        rename(from, to);
+    }
+    if (0 < async_log_ptr->options.keep_files) {
+        snprintf(to, sizeof(to), "%s.1", fname_ptr);
+        rename(fname_ptr, to);
+    } else {
+        unlink(fname_ptr);
+    }
+
+    // If that fails, entries are discarded until the next rotation.
+    async_log_ptr->output_fd = _wlm_util_async_log_open(fname_ptr);
+    async_log_ptr->file_size = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Hands the pipe over to a detached thread, which forwards its contents to
+ * the original stderr until no writer is left. Without other writers, that
+ * is right away. If the thread cannot be started, the pipe is closed.
+ *
+ * @param async_log_ptr
+ */
+void _wlm_util_async_log_forward_start(wlm_util_async_log_t *async_log_ptr)
+{
+    int *fds_ptr = logged_calloc(2, sizeof(int));
+    if (NULL != fds_ptr) {
+        fds_ptr[0] = async_log_ptr->pipe_fd;
+        fds_ptr[1] = fcntl(async_log_ptr->stderr_fd, F_DUPFD_CLOEXEC, 3);
+        pthread_attr_t attr;
+        pthread_t thread;
+        if (0 <= fds_ptr[1] &&
+            0 == pthread_attr_init(&attr)) {
+            pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+            int rv = pthread_create(
+                &thread, &attr, _wlm_util_async_log_forward, fds_ptr);
+            pthread_attr_destroy(&attr);
+            if (0 == rv) {
+                async_log_ptr->pipe_fd = -1;
+                return;
+            }
+        }
+        if (0 <= fds_ptr[1]) close(fds_ptr[1]);
+        free(fds_ptr);
+    }
+    close(async_log_ptr->pipe_fd);
+    async_log_ptr->pipe_fd = -1;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Forwarding thread: Copies the pipe to the output, until no writer is left.
+ *
+ * @param arg_ptr             Points to two file descriptors: The pipe's read
+ *                            end, and the output. Both are closed, and the
+ *                            array is freed.
+ *
+ * @return NULL.
+ */
+void *_wlm_util_async_log_forward(void *arg_ptr)
+{
+    int *fds_ptr = arg_ptr;
+    uint8_t buf[_WLM_UTIL_ASYNC_LOG_CHUNK_SIZE];
+
+    fcntl(fds_ptr[0], F_SETFL, 0);
+    for (;;) {
+        ssize_t n = read(fds_ptr[0], buf, sizeof(buf));
+        if (0 < n) {
+            _wlm_util_async_log_write_fd(fds_ptr[1], buf, n, NULL);
+        } else if (0 > n && EINTR == errno) {
+            continue;
+        } else {
+            break;
+        }
+    }
+
+    close(fds_ptr[0]);
+    close(fds_ptr[1]);
+    free(fds_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Default writer: write(2) until all is written, or an error occurs. */
+bool _wlm_util_async_log_write_fd(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    __UNUSED__ void *ud_ptr)
+{
+    const uint8_t *d_ptr = data_ptr;
+    while (0 < len) {
+        ssize_t written = write(fd, d_ptr, len);
+        if (0 > written) {
+            if (EINTR == errno) continue;
+            return false;
+        }
+        d_ptr += written;
+        len -= written;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Increments the eventfd `fd`. */
+void _wlm_util_async_log_wake(int fd)
+{
+    uint64_t value = 1;
+    while (0 > write(fd, &value, sizeof(value)) && EINTR == errno) continue;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_async_log_test_stalled(bs_test_t *test_ptr);
+static void _wlm_util_async_log_test_push_lines(bs_test_t *test_ptr);
+static void _wlm_util_async_log_test_rotate(bs_test_t *test_ptr);
+static void _wlm_util_async_log_test_crash_flush(bs_test_t *test_ptr);
+static void _wlm_util_async_log_test_forward(bs_test_t *test_ptr);
+static void _wlm_util_async_log_test_throughput(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlm_util_async_log_test_cases[] = {
+    { 1, "stalled", _wlm_util_async_log_test_stalled },
+    { 1, "push_lines", _wlm_util_async_log_test_push_lines },
+    { 1, "rotate", _wlm_util_async_log_test_rotate },
+    { 1, "crash_flush", _wlm_util_async_log_test_crash_flush },
+    { 1, "forward", _wlm_util_async_log_test_forward },
+    { 1, "throughput", _wlm_util_async_log_test_throughput },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_async_log_test_set = BS_TEST_SET(
+    true, "async_log", _wlm_util_async_log_test_cases);
+
+/** Test context for the output. */
+typedef struct {
+    /** Each write blocks until this is readable. Closed to release. */
+    int                       release_fd;
+    /** Whether to discard data, rather than to write it. */
+    bool                      discard;
+    /** Bytes passed to the writer. */
+    size_t                    bytes;
+    /** Contents written, unless discarded. */
+    bs_dynbuf_t               *dynbuf_ptr;
+} _wlm_util_async_log_test_t;
+
+/* ------------------------------------------------------------------------- */
+/** Test writer: Blocks until released, then records the data. */
+static bool _wlm_util_async_log_test_write(
+    __UNUSED__ int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr)
+{
+    _wlm_util_async_log_test_t *t = ud_ptr;
+    char c;
+    if (0 <= t->release_fd) {
+        while (0 > read(t->release_fd, &c, 1) && EINTR == errno) continue;
+    }
+    t->bytes += len;
+    if (t->discard || NULL == t->dynbuf_ptr) return true;
+    return bs_dynbuf_append(t->dynbuf_ptr, data_ptr, len);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the size of `fname_ptr`, or -1 if it does not exist. */
+static off_t _wlm_util_async_log_test_size(const char *fname_ptr)
+{
+    struct stat stat_buf;
+    if (0 != stat(fname_ptr, &stat_buf)) return -1;
+    return stat_buf.st_size;
+}
+
+/* ------------------------------------------------------------------------- */
+/** A stalled output never blocks the caller: Lines are dropped, counted. */
+void _wlm_util_async_log_test_stalled(bs_test_t *test_ptr)
+{
+    int pipe_fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe(pipe_fds));
+    _wlm_util_async_log_test_t t = {
+        .release_fd = pipe_fds[0],
+        .dynbuf_ptr = bs_dynbuf_create(4096, INT32_MAX) };
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t.dynbuf_ptr);
+    struct stat stderr_stat, stat_buf;
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0, fstat(STDERR_FILENO, &stderr_stat));
+
+    wlm_util_async_log_options_t options = {
+        .buffer_size = 4096,
+        .write_fn = _wlm_util_async_log_test_write,
+        .write_ud_ptr = &t };
+    BS_TEST_VERIFY_EQ(test_ptr, -1, wlm_util_async_log_child_stderr_fd());
+    wlm_util_async_log_t *l = wlm_util_async_log_create(&options);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, l);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlm_util_async_log_create(&options));
+
+    // Children get the original stderr.
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0, fstat(wlm_util_async_log_child_stderr_fd(), &stat_buf));
+    BS_TEST_VERIFY_EQ(test_ptr, stderr_stat.st_ino, stat_buf.st_ino);
+
+    // Far more than the ring and pipe hold. Each write returns right away.
+    uint64_t max_usec = 0;
+    for (int i = 0; i < 20000; ++i) {
+        uint64_t start_usec = bs_usec();
+        fprintf(stderr, "Stalled output, line %d\n", i);
+        max_usec = BS_MAX(max_usec, bs_usec() - start_usec);
+    }
+    BS_TEST_VERIFY_TRUE(test_ptr, 100000 > max_usec);
+    for (int i = 0; i < 100 && 0 == wlm_util_async_log_dropped(l); ++i) {
+        usleep(10000);
+    }
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, wlm_util_async_log_dropped(l));
+
+    // Release the output: Destroying writes the rest, and restores stderr.
+    close(pipe_fds[1]);
+    wlm_util_async_log_destroy(l);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, fstat(STDERR_FILENO, &stat_buf));
+    BS_TEST_VERIFY_EQ(test_ptr, stderr_stat.st_ino, stat_buf.st_ino);
+    BS_TEST_VERIFY_TRUE(test_ptr, bs_dynbuf_append(t.dynbuf_ptr, "", 1));
+    const char *data_ptr = (const char*)t.dynbuf_ptr->data_ptr;
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(data_ptr, "Stalled output, line 0\n"));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL, strstr(data_ptr, "(async_log: Dropped"));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, wlm_util_async_log_child_stderr_fd());
+
+    // Dropped at line boundaries: No line continues with another's rest.
+    // Other lines are from bs_log, as the failed second create.
+    for (const char *line_ptr = data_ptr; '\0' != *line_ptr;) {
+        const char *nl_ptr = strchr(line_ptr, '\n');
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, nl_ptr);
+        if (0 == strncmp(line_ptr, "Stalled output, line ", 21)) {
+            size_t digits = strspn(line_ptr + 21, "0123456789");
+            BS_TEST_VERIFY_EQ(test_ptr, nl_ptr, line_ptr + 21 + digits);
+        } else {
+            const char *s_ptr = strstr(line_ptr, ", line ");
+            BS_TEST_VERIFY_TRUE(test_ptr, NULL == s_ptr || s_ptr > nl_ptr);
+        }
+        line_ptr = nl_ptr + 1;
+    }
+
+    bs_dynbuf_destroy(t.dynbuf_ptr);
+    close(pipe_fds[0]);
+}
+
+/* ------------------------------------------------------------------------- */
+/** A full ring drops at line boundaries, and terminates a cut line. */
+void _wlm_util_async_log_test_push_lines(bs_test_t *test_ptr)
+{
+    uint8_t ring[16];
+    wlm_util_async_log_t l = {
+        .ring_ptr = ring,
+        .ring_size = sizeof(ring),
+        .wake_fd = eventfd(0, EFD_CLOEXEC) };
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= l.wake_fd);
+#define _PUSH(_s) \
+    _wlm_util_async_log_push(&l, (const uint8_t*)(_s), sizeof(_s) - 1)
+
+    // Fits, including a partial line.
+    _PUSH("abc\n");
+    _PUSH("defgh");
+    BS_TEST_VERIFY_EQ(test_ptr, 9, atomic_load(&l.head));
+    // Completes the line and keeps it. Drops the next line.
+    _PUSH("ij\nklmnopq\n");
+    BS_TEST_VERIFY_EQ(test_ptr, 12, atomic_load(&l.head));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlm_util_async_log_dropped(&l));
+    // A line that does not fit is dropped, including its continuation.
+    _PUSH("rstuvwx");
+    _PUSH("yz\n12\n");
+    BS_TEST_VERIFY_EQ(test_ptr, 15, atomic_load(&l.head));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlm_util_async_log_dropped(&l));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, memcmp(ring, "abc\ndefghij\n12\n", 15));
+
+    // All written. A line in the ring is cut: Gets terminated.
+    atomic_store(&l.tail, 15);
+    _PUSH("0123456789abcd");
+    BS_TEST_VERIFY_EQ(test_ptr, 29, atomic_load(&l.head));
+    _PUSH("ef\n");
+    BS_TEST_VERIFY_EQ(test_ptr, 30, atomic_load(&l.head));
+    BS_TEST_VERIFY_EQ(test_ptr, '\n', ring[29 & 15]);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlm_util_async_log_dropped(&l));
+#undef _PUSH
+
+    close(l.wake_fd);
+}
+
+/* ------------------------------------------------------------------------- */
+/** The log file is rotated at line boundaries, keeping `keep_files`. */
+void _wlm_util_async_log_test_rotate(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlm_util_async_log_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/wlmaker.log", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+
+    wlm_util_async_log_options_t options = {
+        .fname_ptr = fname_ptr,
+        .max_file_size = 1000,
+        .keep_files = 2,
+        .buffer_size = 65536 };
+    wlm_util_async_log_t *l = wlm_util_async_log_create(&options);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, l);
+    // 100 lines of 64 bytes: Rotates 6 times.
+    for (int i = 0; i < 100; ++i) {
+        fprintf(stderr, "%-62d|\n", i);
+    }
+    wlm_util_async_log_destroy(l);
+
+    char name[PATH_MAX];
+    for (int i = 0; i <= 3; ++i) {
+        if (0 == i) {
+            snprintf(name, sizeof(name), "%s", fname_ptr);
+        } else {
+            snprintf(name, sizeof(name), "%s.%d", fname_ptr, i);
+        }
+        off_t size = _wlm_util_async_log_test_size(name);
+        if (3 == i) {
+            BS_TEST_VERIFY_EQ(test_ptr, -1, size);
+            continue;
+        }
+        // 15 lines per file; the current file has the last 10.
+        BS_TEST_VERIFY_EQ(test_ptr, 0 == i ? 640 : 960, size);
+        unlink(name);
+    }
+
+    free(fname_ptr);
+    rmdir(dir);
+}
+
+/* ------------------------------------------------------------------------- */
+/** The crash path writes pending entries, and points stderr to the output. */
+void _wlm_util_async_log_test_crash_flush(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlm_util_async_log_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/wlmaker.log", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+    int pipe_fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe(pipe_fds));
+
+    // The writer stalls, and does not write: Entries stay pending.
+    _wlm_util_async_log_test_t t = {
+        .release_fd = pipe_fds[0], .discard = true };
+    wlm_util_async_log_options_t options = {
+        .fname_ptr = fname_ptr,
+        .buffer_size = 65536,
+        .write_fn = _wlm_util_async_log_test_write,
+        .write_ud_ptr = &t };
+    wlm_util_async_log_t *l = wlm_util_async_log_create(&options);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, l);
+    fprintf(stderr, "first\n");
+    for (int i = 0; i < 100 && 6 > atomic_load(&l->head); ++i) usleep(10000);
+    fprintf(stderr, "second\n");
+    for (int i = 0; i < 100 && 13 > atomic_load(&l->head); ++i) usleep(10000);
+
+    wlm_util_async_log_crash_flush();
+    fprintf(stderr, "third\n");
+    BS_TEST_VERIFY_EQ(test_ptr, 19, _wlm_util_async_log_test_size(fname_ptr));
+
+    close(pipe_fds[1]);
+    wlm_util_async_log_destroy(l);
+    close(pipe_fds[0]);
+    unlink(fname_ptr);
+    free(fname_ptr);
+    rmdir(dir);
+}
+
+/* ------------------------------------------------------------------------- */
+/** After destroy, the pipe is forwarded to stderr while a child holds it. */
+void _wlm_util_async_log_test_forward(bs_test_t *test_ptr)
+{
+    // The original stderr is a pipe we can read from.
+    int stderr_fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe(stderr_fds));
+    int saved_fd = dup(STDERR_FILENO);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= saved_fd);
+    dup2(stderr_fds[1], STDERR_FILENO);
+    close(stderr_fds[1]);
+
+    wlm_util_async_log_options_t options = { .buffer_size = 4096 };
+    wlm_util_async_log_t *l = wlm_util_async_log_create(&options);
+    // As a child would: Holds on to the pipe, beyond destroy.
+    int child_fd = NULL != l ? dup(STDERR_FILENO) : -1;
+    if (NULL != l) wlm_util_async_log_destroy(l);
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, l);
+    BS_TEST_VERIFY_TRUE(test_ptr, 0 <= child_fd);
+
+    char buf[16] = {};
+    if (0 <= child_fd) {
+        BS_TEST_VERIFY_EQ(test_ptr, 5, write(child_fd, "late\n", 5));
+        close(child_fd);
+        BS_TEST_VERIFY_EQ(test_ptr, 5, read(stderr_fds[0], buf, 5));
+    }
+    BS_TEST_VERIFY_STREQ(test_ptr, "late\n", buf);
+
+    dup2(saved_fd, STDERR_FILENO);
+    close(saved_fd);
+    close(stderr_fds[0]);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Benchmark: Throughput of the caller, and of the output. */
+void _wlm_util_async_log_test_throughput(bs_test_t *test_ptr)
+{
+    _wlm_util_async_log_test_t t = { .release_fd = -1, .discard = true };
+    wlm_util_async_log_options_t options = {
+        .buffer_size = 1 << 20,
+        .write_fn = _wlm_util_async_log_test_write,
+        .write_ud_ptr = &t };
+    wlm_util_async_log_t *l = wlm_util_async_log_create(&options);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, l);
+
+    const int lines = 100000;
+    uint64_t start_usec = bs_usec();
+    for (int i = 0; i < lines; ++i) {
+        fprintf(stderr, "I1018 12:34:56.789012 src/toolkit/window.c:1234] "
+                "Benchmark line %d\n", i);
+    }
+    uint64_t caller_usec = BS_MAX(bs_usec() - start_usec, 1u);
+    uint64_t dropped = wlm_util_async_log_dropped(l);
+    wlm_util_async_log_destroy(l);
+    uint64_t total_usec = BS_MAX(bs_usec() - start_usec, 1u);
+
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, t.bytes);
+    bs_log(BS_INFO, "async_log: %d lines, caller %.0f lines/s, "
+           "output %.1f MB/s, %"PRIu64" dropped.",
+           lines, lines * 1e6 / caller_usec,
+           (double)t.bytes / total_usec, dropped);
+}
+
+/* == End of async_log.c =================================================== */
@@ -0,0 +1,134 @@
+/* ========================================================================= */
+/**
+ * @file async_log.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_ASYNC_LOG_H__
+#define __WLMAKER_UTIL_ASYNC_LOG_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+/**
+ * Asynchronous log sink.
+ *
+ * Replaces the process' stderr by a pipe, so that `bs_log` and anything else
+ * writing to stderr never blocks on a slow terminal or disk. A capture thread
+ * moves the pipe's contents into a bounded lock-free ring buffer, and a
+ * writer thread writes the ring to the original stderr or to a size-rotated
+ * log file. The capture thread never waits for the output: When the ring is
+ * full, it drops lines and counts them.
+ *
+ * The pipe is blocking, since children inheriting it may not expect
+ * otherwise. Children started by @ref wlm_util_spawn get the original
+ * stderr, see @ref wlm_util_async_log_child_stderr_fd. Once the log is
+ * destroyed, the pipe is forwarded to the original stderr until all children
+ * have closed it.
+ *
+ * At most one instance exists at a time.
+ */
+typedef struct _wlm_util_async_log_t wlm_util_async_log_t;
+
+/**
+ * Writes all of `data_ptr` to `fd`. Called on the writer thread.
+ *
+ * @param fd
+ * @param data_ptr
+ * @param len
+ * @param ud_ptr
+ *
+ * @return true on success.
+ */
+typedef bool (*wlm_util_async_log_write_t)(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr);
+
+/** Options for @ref wlm_util_async_log_create. */
+typedef struct {
+    /** Path of the log file to append to. NULL to write to stderr. */
+    const char                *fname_ptr;
+    /** Rotates the log file before it exceeds this size. 0: Never. */
+    size_t                    max_file_size;
+    /** Number of rotated files to keep, as `<fname>.1`, `<fname>.2`, ... */
+    unsigned                  keep_files;
+    /** Size of the ring buffer, in bytes. Rounded up to a power of 2. */
+    size_t                    buffer_size;
+    /** Writes to the output. NULL to use write(2). For tests. */
+    wlm_util_async_log_write_t write_fn;
+    /** Argument to `write_fn`. */
+    void                      *write_ud_ptr;
+} wlm_util_async_log_options_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the asynchronous log, and redirects stderr into it.
+ *
+ * @param options_ptr
+ *
+ * @return Pointer to the log, or NULL on error. Must be destroyed by calling
+ *     @ref wlm_util_async_log_destroy. If not, it is destroyed at exit().
+ */
+wlm_util_async_log_t *wlm_util_async_log_create(
+    const wlm_util_async_log_options_t *options_ptr);
+
+/**
+ * Restores stderr, writes all pending entries and destroys the log.
+ *
+ * @param async_log_ptr
+ */
+void wlm_util_async_log_destroy(wlm_util_async_log_t *async_log_ptr);
+
+/**
+ * @param async_log_ptr
+ *
+ * @return Number of lines dropped or cut for a full buffer, since creation.
+ */
+uint64_t wlm_util_async_log_dropped(wlm_util_async_log_t *async_log_ptr);
+
+/**
+ * Returns the file descriptor to use as stderr of child processes.
+ *
+ * @return The original stderr, while stderr is redirected into the log. -1
+ *     if there is no log: Then, children inherit stderr as usual. The
+ *     descriptor is close-on-exec, and owned by the log.
+ */
+int wlm_util_async_log_child_stderr_fd(void);
+
+/**
+ * Crash path: Stops the threads, writes all pending entries directly and
+ * points stderr to the output, so further messages are written right away.
+ *
+ * Uses only async-signal-safe calls. A no-op if there is no log.
+ */
+void wlm_util_async_log_crash_flush(void);
+
+/** Unit test set for @ref wlm_util_async_log_t. */
+extern const bs_test_set_t wlm_util_async_log_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_ASYNC_LOG_H__ */
+/* == End of async_log.h =================================================== */
@@ -28,6 +28,8 @@
 #include <stdbool.h>
 #include <stdlib.h>
 
+#include "async_log.h"
+
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
 #include <backtrace.h>
 #endif // defined(WLMAKER_HAVE_LIBBACKTRACE)
@@ -44,15 +46,16 @@ static void _backtrace_error_callback(
     const char *msg_ptr,
     int errnum);
 static int _backtrace_full_callback(
-    __UNUSED__ void *data,
+    void *data_ptr,
     uintptr_t pc,
     const char *filename_ptr,
     int line_num,
     const char *function_ptr);
-static void _signal_backtrace(int signum);
 
 #endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
 
+static void _signal_backtrace(int signum);
+
 /* == Exported methods ===================================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -60,27 +63,49 @@ bool wlm_util_backtrace_setup(const char *filename_ptr)
 {
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
 
+    // Threaded: The watchdog symbolizes on its own thread.
     _wlmaker_bt_state_ptr = backtrace_create_state(
-        filename_ptr, 0, _backtrace_error_callback, NULL);
+        filename_ptr, 1, _backtrace_error_callback, NULL);
     if (NULL == _wlmaker_bt_state_ptr) {
         bs_log(BS_ERROR, "Failed backtrace_create_state()");
         return false;
     }
-    signal(SIGABRT, _signal_backtrace);
-    signal(SIGBUS, _signal_backtrace);
-    signal(SIGFPE, _signal_backtrace);
-    signal(SIGILL, _signal_backtrace);
-    signal(SIGSEGV, _signal_backtrace);
 
 #else
 
-    bs_log(BS_DEBUG, "No libbacktrace, ignoring setup for %s", filename_ptr);
+    bs_log(BS_DEBUG, "No libbacktrace, no backtrace for %s", filename_ptr);
 
 #endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
 
+    // Without libbacktrace, the handler still flushes the log.
+    signal(SIGABRT, _signal_backtrace);
+    signal(SIGBUS, _signal_backtrace);
+    signal(SIGFPE, _signal_backtrace);
+    signal(SIGILL, _signal_backtrace);
+    signal(SIGSEGV, _signal_backtrace);
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+void wlm_util_backtrace_log(
+    bs_log_severity_t severity,
+    const uintptr_t *pcs_ptr,
+    size_t num_pcs)
+{
+    for (size_t i = 0; i < num_pcs; ++i) {
+#if defined(WLMAKER_HAVE_LIBBACKTRACE)
+        if (NULL != _wlmaker_bt_state_ptr) {
+            backtrace_pcinfo(_wlmaker_bt_state_ptr, pcs_ptr[i],
+                             _backtrace_full_callback,
+                             _backtrace_error_callback, &severity);
+            continue;
+        }
+#endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
+        // Not set up: Addresses only.
+        bs_log(severity, "%"PRIxPTR, pcs_ptr[i]);
+    }
+}
+
 /* == Local (static) methods =============================================== */
 
 #if defined(WLMAKER_HAVE_LIBBACKTRACE)
@@ -98,15 +123,26 @@ void _backtrace_error_callback(
 }
 
 /* ------------------------------------------------------------------------- */
-/** Full callback for printing a libbacktrace frame. */
+/**
+ * Full callback for printing a libbacktrace frame.
+ *
+ * @param data_ptr            Points to a @ref bs_log_severity_t, or NULL to
+ *                            log at BS_ERROR.
+ * @param program_counter
+ * @param filename_ptr
+ * @param line_num
+ * @param function_ptr
+ */
 int _backtrace_full_callback(
-    __UNUSED__ void *data,
+    void *data_ptr,
     uintptr_t program_counter,
     const char *filename_ptr,
     int line_num,
     const char *function_ptr)
 {
-    bs_log(BS_ERROR, "%"PRIxPTR" in %s () at %s:%d",
+    bs_log_severity_t severity = BS_ERROR;
+    if (NULL != data_ptr) severity = *(bs_log_severity_t*)data_ptr;
+    bs_log(severity, "%"PRIxPTR" in %s () at %s:%d",
            program_counter,
            function_ptr ? function_ptr : "(unknown)",
            filename_ptr ? filename_ptr : "(unknown)",
@@ -114,19 +150,27 @@ int _backtrace_full_callback(
     return 0;
 }
 
+#endif // defined(WLMAKER_HAVE_LIBBACKTRACE)
+
 /* ------------------------------------------------------------------------- */
-/** Signal handler: Prints a backtrace. */
+/**
+ * Signal handler: Writes pending log entries, then prints a backtrace.
+ *
+ * Flushing first points stderr back to the log's output, so the backtrace
+ * does not depend on the log's threads.
+ */
 void _signal_backtrace(int signum)
 {
+    wlm_util_async_log_crash_flush();
     bs_log(BS_ERROR, "Caught signal %d", signum);
+#if defined(WLMAKER_HAVE_LIBBACKTRACE)
     backtrace_full(
         _wlmaker_bt_state_ptr, 0,
         _backtrace_full_callback, _backtrace_error_callback, NULL);
+#endif  // defined(WLMAKER_HAVE_LIBBACKTRACE)
 
     signal(SIGABRT, SIG_DFL);
     abort();
 }
 
-#endif // defined(WLMAKER_HAVE_LIBBACKTRACE)
-
 /* == End of backtrace.c =================================================== */
@@ -22,6 +22,9 @@
 #define __WLMBACKTRACE_H__
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <libbase/libbase.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -39,6 +42,19 @@ extern "C" {
  */
 bool wlm_util_backtrace_setup(const char *filename_ptr);
 
+/**
+ * Symbolizes and logs program counters. Logs just the addresses if there is
+ * no libbacktrace, or @ref wlm_util_backtrace_setup was not called.
+ *
+ * @param severity
+ * @param pcs_ptr
+ * @param num_pcs
+ */
+void wlm_util_backtrace_log(
+    bs_log_severity_t severity,
+    const uintptr_t *pcs_ptr,
+    size_t num_pcs);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
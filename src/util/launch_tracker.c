@@ -0,0 +1,587 @@
+/* ========================================================================= */
+/**
+ * @file launch_tracker.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** For `getdelim`. */
+#define _GNU_SOURCE
+
+#include "launch_tracker.h"
+
+#include <inttypes.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "spawn.h"
+
+/* == Declarations ========================================================= */
+
+/** Launches without a window after this long are dropped, as expired. */
+#define _WLM_UTIL_LAUNCH_TRACKER_MAX_USEC (60 * (uint64_t)1000000)
+/** How many ancestors of a client's process are looked up. */
+#define _WLM_UTIL_LAUNCH_TRACKER_ANCESTORS 4
+/** How many launches from the environment are remembered as counted. */
+#define _WLM_UTIL_LAUNCH_TRACKER_COUNTED 16
+/** How many processes are remembered as having mapped a window. */
+#define _WLM_UTIL_LAUNCH_TRACKER_MAPPED 16
+
+/** An application, with its statistics. */
+typedef struct {
+    /** Element of @ref wlm_util_launch_tracker_t::apps. */
+    bs_dllist_node_t          dlnode;
+    /** Name of the application. */
+    char                      *name_ptr;
+    /** Statistics. */
+    wlm_util_launch_stats_t   stats;
+} wlm_util_launch_app_t;
+
+/** A launch that has not had a window yet. */
+typedef struct {
+    /** Element of @ref wlm_util_launch_tracker_t::launches. */
+    bs_dllist_node_t          dlnode;
+    /** Process ID of the launched process. */
+    pid_t                     pid;
+    /** Time of the launch, CLOCK_MONOTONIC in microseconds. */
+    uint64_t                  usec;
+    /** The launched application. */
+    wlm_util_launch_app_t     *app_ptr;
+} wlm_util_launch_t;
+
+/** State of the launch tracker. */
+struct _wlm_util_launch_tracker_t {
+    /** Applications, as @ref wlm_util_launch_app_t, in order of launch. */
+    bs_dllist_t               apps;
+    /** Pending launches, as @ref wlm_util_launch_t, oldest first. */
+    bs_dllist_t               launches;
+    /** Times of the launches from the environment that were counted. */
+    uint64_t                  counted_usec[_WLM_UTIL_LAUNCH_TRACKER_COUNTED];
+    /** Next position to write in @ref counted_usec. */
+    size_t                    next_counted;
+    /** Processes that mapped a window: Their environment was looked up. */
+    pid_t                     mapped_pids[_WLM_UTIL_LAUNCH_TRACKER_MAPPED];
+    /** Next position to write in @ref mapped_pids. */
+    size_t                    next_mapped;
+    /** Number of lookups in /proc/<pid>/environ. For tests. */
+    uint64_t                  env_lookups;
+};
+
+static wlm_util_launch_app_t *_wlm_util_launch_tracker_find(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr);
+static wlm_util_launch_app_t *_wlm_util_launch_tracker_app(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr);
+static void _wlm_util_launch_tracker_expire(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    uint64_t now_usec);
+static void _wlm_util_launch_tracker_record(
+    wlm_util_launch_app_t *app_ptr,
+    uint64_t latency_usec);
+static bool _wlm_util_launch_tracker_mapped_before(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid);
+static bool _wlm_util_launch_tracker_mapped_from_env(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid,
+    uint64_t now_usec);
+static pid_t _wlm_util_launch_tracker_parent(pid_t pid);
+static char *_wlm_util_launch_tracker_getenv(pid_t pid);
+static uint64_t _wlm_util_launch_tracker_now_usec(void);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_util_launch_tracker_t *wlm_util_launch_tracker_create(void)
+{
+    return logged_calloc(1, sizeof(wlm_util_launch_tracker_t));
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_launch_tracker_destroy(wlm_util_launch_tracker_t *tracker_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(
+                        &tracker_ptr->launches))) {
+        free(BS_CONTAINER_OF(dlnode_ptr, wlm_util_launch_t, dlnode));
+    }
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&tracker_ptr->apps))) {
+        wlm_util_launch_app_t *app_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlm_util_launch_app_t, dlnode);
+        free(app_ptr->name_ptr);
+        free(app_ptr);
+    }
+    free(tracker_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_launch_tracker_launched(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid,
+    const char *app_ptr)
+{
+    if (NULL == tracker_ptr || 0 >= pid) return;
+    uint64_t now_usec = _wlm_util_launch_tracker_now_usec();
+    _wlm_util_launch_tracker_expire(tracker_ptr, now_usec);
+
+    wlm_util_launch_t *launch_ptr = logged_calloc(
+        1, sizeof(wlm_util_launch_t));
+    if (NULL == launch_ptr) return;
+    launch_ptr->app_ptr = _wlm_util_launch_tracker_app(tracker_ptr, app_ptr);
+    if (NULL == launch_ptr->app_ptr) {
+        free(launch_ptr);
+        return;
+    }
+    launch_ptr->pid = pid;
+    launch_ptr->usec = now_usec;
+    bs_dllist_push_back(&tracker_ptr->launches, &launch_ptr->dlnode);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_launch_tracker_mapped(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid)
+{
+    if (NULL == tracker_ptr || 0 >= pid) return false;
+    uint64_t now_usec = _wlm_util_launch_tracker_now_usec();
+    _wlm_util_launch_tracker_expire(tracker_ptr, now_usec);
+
+    // Nothing pending: No launch of ours, and the environment of `pid` was
+    // looked up at its first window already. Saves reading /proc.
+    bool mapped_before = _wlm_util_launch_tracker_mapped_before(
+        tracker_ptr, pid);
+    if (mapped_before && bs_dllist_empty(&tracker_ptr->launches)) {
+        return false;
+    }
+
+    // Looks up the client's process, then its ancestors. Stops at init, or
+    // at this process: Our parent did not launch anything through us.
+    pid_t p = pid;
+    for (int i = 0;
+         i <= _WLM_UTIL_LAUNCH_TRACKER_ANCESTORS &&
+             !bs_dllist_empty(&tracker_ptr->launches) &&
+             1 < p && getpid() != p;
+         ++i, p = _wlm_util_launch_tracker_parent(p)) {
+        for (bs_dllist_node_t *dlnode_ptr = tracker_ptr->launches.head_ptr;
+             dlnode_ptr != NULL;
+             dlnode_ptr = dlnode_ptr->next_ptr) {
+            wlm_util_launch_t *launch_ptr = BS_CONTAINER_OF(
+                dlnode_ptr, wlm_util_launch_t, dlnode);
+            if (launch_ptr->pid != p) continue;
+
+            _wlm_util_launch_tracker_record(
+                launch_ptr->app_ptr, now_usec - launch_ptr->usec);
+            bs_dllist_remove(&tracker_ptr->launches, dlnode_ptr);
+            free(launch_ptr);
+            return true;
+        }
+    }
+
+    if (mapped_before) return false;
+    return _wlm_util_launch_tracker_mapped_from_env(
+        tracker_ptr, pid, now_usec);
+}
+
+/* ------------------------------------------------------------------------- */
+const wlm_util_launch_stats_t *wlm_util_launch_tracker_stats(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr)
+{
+    wlm_util_launch_app_t *a_ptr = _wlm_util_launch_tracker_find(
+        tracker_ptr, app_ptr);
+    return NULL != a_ptr ? &a_ptr->stats : NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_launch_tracker_log(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    bs_log_severity_t severity)
+{
+    _wlm_util_launch_tracker_expire(
+        tracker_ptr, _wlm_util_launch_tracker_now_usec());
+
+    for (bs_dllist_node_t *dlnode_ptr = tracker_ptr->apps.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlm_util_launch_app_t *app_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlm_util_launch_app_t, dlnode);
+        const wlm_util_launch_stats_t *s_ptr = &app_ptr->stats;
+        if (0 == s_ptr->count) {
+            bs_log(severity, "Launch latency of '%s': No window, %"PRIu64
+                   " expired.", app_ptr->name_ptr, s_ptr->expired);
+            continue;
+        }
+        bs_log(severity, "Launch latency of '%s', over %"PRIu64" launches: "
+               "min %.1f ms, mean %.1f ms, max %.1f ms, last %.1f ms. "
+               "%"PRIu64" expired.",
+               app_ptr->name_ptr, s_ptr->count,
+               s_ptr->min_usec / 1e3,
+               s_ptr->sum_usec / 1e3 / s_ptr->count,
+               s_ptr->max_usec / 1e3,
+               s_ptr->last_usec / 1e3,
+               s_ptr->expired);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_launch_tracker_setenv(const char *app_ptr)
+{
+    char *value_ptr = bs_strdupf(
+        "%"PRIu64":%s", _wlm_util_launch_tracker_now_usec(), app_ptr);
+    if (NULL == value_ptr) return false;
+    int rv = setenv(WLM_UTIL_LAUNCH_TRACKER_ENV, value_ptr, 1);
+    if (0 != rv) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed setenv(%s, %s, 1)",
+               WLM_UTIL_LAUNCH_TRACKER_ENV, value_ptr);
+    }
+    free(value_ptr);
+    return 0 == rv;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_launch_tracker_unsetenv(void)
+{
+    unsetenv(WLM_UTIL_LAUNCH_TRACKER_ENV);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Returns the application named `app_ptr`, or NULL if not found. */
+wlm_util_launch_app_t *_wlm_util_launch_tracker_find(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr)
+{
+    for (bs_dllist_node_t *dlnode_ptr = tracker_ptr->apps.head_ptr;
+         dlnode_ptr != NULL;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlm_util_launch_app_t *a_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlm_util_launch_app_t, dlnode);
+        if (0 == strcmp(a_ptr->name_ptr, app_ptr)) return a_ptr;
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the application named `app_ptr`. Creates it, if not found. */
+wlm_util_launch_app_t *_wlm_util_launch_tracker_app(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr)
+{
+    wlm_util_launch_app_t *a_ptr = _wlm_util_launch_tracker_find(
+        tracker_ptr, app_ptr);
+    if (NULL != a_ptr) return a_ptr;
+
+    a_ptr = logged_calloc(
+        1, sizeof(wlm_util_launch_app_t));
+    if (NULL == a_ptr) return NULL;
+    a_ptr->name_ptr = logged_strdup(app_ptr);
+    if (NULL == a_ptr->name_ptr) {
+        free(a_ptr);
+        return NULL;
+    }
+    bs_dllist_push_back(&tracker_ptr->apps, &a_ptr->dlnode);
+    return a_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Drops launches that had no window within the time limit. */
+void _wlm_util_launch_tracker_expire(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    uint64_t now_usec)
+{
+    while (NULL != tracker_ptr->launches.head_ptr) {
+        wlm_util_launch_t *launch_ptr = BS_CONTAINER_OF(
+            tracker_ptr->launches.head_ptr, wlm_util_launch_t, dlnode);
+        if (now_usec - launch_ptr->usec <= _WLM_UTIL_LAUNCH_TRACKER_MAX_USEC) {
+            return;
+        }
+        launch_ptr->app_ptr->stats.expired++;
+        bs_dllist_remove(&tracker_ptr->launches, &launch_ptr->dlnode);
+        free(launch_ptr);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records a latency into the application's statistics. */
+void _wlm_util_launch_tracker_record(
+    wlm_util_launch_app_t *app_ptr,
+    uint64_t latency_usec)
+{
+    wlm_util_launch_stats_t *s_ptr = &app_ptr->stats;
+    if (0 == s_ptr->count || latency_usec < s_ptr->min_usec) {
+        s_ptr->min_usec = latency_usec;
+    }
+    s_ptr->max_usec = BS_MAX(s_ptr->max_usec, latency_usec);
+    s_ptr->sum_usec += latency_usec;
+    s_ptr->last_usec = latency_usec;
+    s_ptr->count++;
+    bs_log(BS_INFO, "Launch of '%s': First window after %.1f ms.",
+           app_ptr->name_ptr, latency_usec / 1e3);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether `pid` mapped a window before. Else, remembers it as such.
+ *
+ * Only a process' first window can count for a launch from the environment.
+ * Remembers the most recent processes only: Older ones are looked up again,
+ * but their launch was counted or has expired then.
+ */
+bool _wlm_util_launch_tracker_mapped_before(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid)
+{
+    for (size_t i = 0; i < _WLM_UTIL_LAUNCH_TRACKER_MAPPED; ++i) {
+        if (tracker_ptr->mapped_pids[i] == pid) return true;
+    }
+    tracker_ptr->mapped_pids[tracker_ptr->next_mapped] = pid;
+    tracker_ptr->next_mapped = (
+        (tracker_ptr->next_mapped + 1) % _WLM_UTIL_LAUNCH_TRACKER_MAPPED);
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Looks up @ref WLM_UTIL_LAUNCH_TRACKER_ENV in the environment of `pid`, and
+ * records the latency if that launch was not counted before.
+ */
+bool _wlm_util_launch_tracker_mapped_from_env(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid,
+    uint64_t now_usec)
+{
+    ++tracker_ptr->env_lookups;
+    char *value_ptr = _wlm_util_launch_tracker_getenv(pid);
+    if (NULL == value_ptr) return false;
+
+    char *app_ptr;
+    uint64_t usec = strtoull(value_ptr, &app_ptr, 10);
+    bool recorded = false;
+    if (':' != *app_ptr || usec > now_usec ||
+        now_usec - usec > _WLM_UTIL_LAUNCH_TRACKER_MAX_USEC) goto done;
+
+    // The environment is inherited: Only the first window counts.
+    for (size_t i = 0; i < _WLM_UTIL_LAUNCH_TRACKER_COUNTED; ++i) {
+        if (tracker_ptr->counted_usec[i] == usec) goto done;
+    }
+    wlm_util_launch_app_t *a_ptr = _wlm_util_launch_tracker_app(
+        tracker_ptr, app_ptr + 1);
+    if (NULL == a_ptr) goto done;
+    _wlm_util_launch_tracker_record(a_ptr, now_usec - usec);
+    tracker_ptr->counted_usec[tracker_ptr->next_counted] = usec;
+    tracker_ptr->next_counted = (
+        (tracker_ptr->next_counted + 1) % _WLM_UTIL_LAUNCH_TRACKER_COUNTED);
+    recorded = true;
+
+done:
+    free(value_ptr);
+    return recorded;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the parent of process `pid`, from /proc, or 0 on error. */
+pid_t _wlm_util_launch_tracker_parent(pid_t pid)
+{
+    char path[64], buf[512];
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *file_ptr = fopen(path, "r");
+    if (NULL == file_ptr) return 0;
+    char *line_ptr = fgets(buf, sizeof(buf), file_ptr);
+    fclose(file_ptr);
+    if (NULL == line_ptr) return 0;
+
+    // "<pid> (<comm>) <state> <ppid> ...". The command may contain ')'.
+    char *ptr = strrchr(buf, ')');
+    int ppid;
+    if (NULL == ptr || 1 != sscanf(ptr + 1, " %*c %d", &ppid)) return 0;
+    return ppid;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns the value of @ref WLM_UTIL_LAUNCH_TRACKER_ENV in the environment
+ * of process `pid`, from /proc. As the process was started. Must be free-d.
+ */
+char *_wlm_util_launch_tracker_getenv(pid_t pid)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/environ", pid);
+    FILE *file_ptr = fopen(path, "r");
+    if (NULL == file_ptr) return NULL;
+
+    const size_t len = strlen(WLM_UTIL_LAUNCH_TRACKER_ENV);
+    char *value_ptr = NULL;
+    char *entry_ptr = NULL;
+    size_t size = 0;
+    while (0 < getdelim(&entry_ptr, &size, '\0', file_ptr)) {
+        if (0 == strncmp(entry_ptr, WLM_UTIL_LAUNCH_TRACKER_ENV, len) &&
+            '=' == entry_ptr[len]) {
+            value_ptr = logged_strdup(entry_ptr + len + 1);
+            break;
+        }
+    }
+    free(entry_ptr);
+    fclose(file_ptr);
+    return value_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns CLOCK_MONOTONIC, in microseconds. Comparable across processes. */
+uint64_t _wlm_util_launch_tracker_now_usec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_launch_tracker_test_latency(bs_test_t *test_ptr);
+static void _wlm_util_launch_tracker_test_env(bs_test_t *test_ptr);
+
+static const bs_test_case_t _wlm_util_launch_tracker_test_cases[] = {
+    { 1, "latency", _wlm_util_launch_tracker_test_latency },
+    { 1, "env", _wlm_util_launch_tracker_test_env },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_launch_tracker_test_set = BS_TEST_SET(
+    true, "launch_tracker", _wlm_util_launch_tracker_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Stub client: After 50ms, a child of the launched shell "maps" by printing
+ * its process ID, then stays around until killed.
+ */
+static const char *_wlm_util_launch_tracker_test_client =
+    "sleep 0.05; sh -c 'echo $$; exec sleep 10'; :";
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Waits up to 5s for the stub client to print its process ID.
+ *
+ * @return The process ID, or -1 on error.
+ */
+static pid_t _wlm_util_launch_tracker_test_wait(int fd)
+{
+    char buf[32];
+    size_t len = 0;
+    uint64_t start_usec = bs_usec();
+    while (bs_usec() < start_usec + 5000000 && len < sizeof(buf) - 1) {
+        ssize_t rv = read(fd, buf + len, sizeof(buf) - 1 - len);
+        if (0 == rv) break;
+        if (0 < rv) len += rv;
+        buf[len] = '\0';
+        if (NULL != strchr(buf, '\n')) return atoi(buf);
+        usleep(1000);
+    }
+    return -1;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests the latency of a stub client's window, mapped from a child. */
+void _wlm_util_launch_tracker_test_latency(bs_test_t *test_ptr)
+{
+    const char *app_ptr = _wlm_util_launch_tracker_test_client;
+    wlm_util_launch_tracker_t *tracker_ptr = wlm_util_launch_tracker_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tracker_ptr);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL, wlm_util_launch_tracker_stats(tracker_ptr, app_ptr));
+
+    int stdout_fd;
+    pid_t pid = wlm_util_spawn(app_ptr, &stdout_fd, NULL);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, -1, pid);
+    wlm_util_launch_tracker_launched(tracker_ptr, pid, app_ptr);
+
+    pid_t client_pid = _wlm_util_launch_tracker_test_wait(stdout_fd);
+    BS_TEST_VERIFY_NEQ(test_ptr, -1, client_pid);
+    BS_TEST_VERIFY_NEQ(test_ptr, pid, client_pid);
+    // Unrelated processes do not count. The client's does, once.
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, getpid()));
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, client_pid));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, client_pid));
+    // Nothing pending: Further windows return early, without lookups.
+    uint64_t env_lookups = tracker_ptr->env_lookups;
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, getpid()));
+    BS_TEST_VERIFY_EQ(test_ptr, env_lookups, tracker_ptr->env_lookups);
+
+    const wlm_util_launch_stats_t *s_ptr = wlm_util_launch_tracker_stats(
+        tracker_ptr, app_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, s_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, s_ptr->count);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, s_ptr->expired);
+    BS_TEST_VERIFY_TRUE(test_ptr, 50000 <= s_ptr->min_usec);
+    BS_TEST_VERIFY_TRUE(test_ptr, 5000000 > s_ptr->max_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, s_ptr->min_usec, s_ptr->last_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, s_ptr->min_usec, s_ptr->sum_usec);
+    wlm_util_launch_tracker_log(tracker_ptr, BS_INFO);
+
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    if (0 < client_pid) kill(client_pid, SIGKILL);
+    close(stdout_fd);
+    wlm_util_launch_tracker_destroy(tracker_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests a launch marked in the environment, as from another process. */
+void _wlm_util_launch_tracker_test_env(bs_test_t *test_ptr)
+{
+    wlm_util_launch_tracker_t *tracker_ptr = wlm_util_launch_tracker_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, tracker_ptr);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_launch_tracker_setenv("app"));
+    pid_t pid = wlm_util_spawn("sleep 10", NULL, NULL);
+    wlm_util_launch_tracker_unsetenv();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, -1, pid);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, getenv(WLM_UTIL_LAUNCH_TRACKER_ENV));
+
+    // posix_spawn returns before the exec: Wait for the new environment.
+    char *value_ptr = NULL;
+    for (int i = 0; i < 5000 && NULL == value_ptr; ++i) {
+        value_ptr = _wlm_util_launch_tracker_getenv(pid);
+        if (NULL == value_ptr) usleep(1000);
+    }
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, value_ptr);
+    free(value_ptr);
+
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, pid));
+    BS_TEST_VERIFY_FALSE(
+        test_ptr, wlm_util_launch_tracker_mapped(tracker_ptr, pid));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, tracker_ptr->env_lookups);
+    const wlm_util_launch_stats_t *s_ptr = wlm_util_launch_tracker_stats(
+        tracker_ptr, "app");
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, s_ptr);
+    if (NULL != s_ptr) BS_TEST_VERIFY_EQ(test_ptr, 1, s_ptr->count);
+
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+    wlm_util_launch_tracker_destroy(tracker_ptr);
+}
+
+/* == End of launch_tracker.c ============================================== */
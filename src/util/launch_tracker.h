@@ -0,0 +1,156 @@
+/* ========================================================================= */
+/**
+ * @file launch_tracker.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_LAUNCH_TRACKER_H__
+#define __WLMAKER_UTIL_LAUNCH_TRACKER_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include <libbase/libbase.h>
+
+/**
+ * Tracks the latency from launching an application to its first window.
+ *
+ * Launches are recorded with the process ID of the launched process. When a
+ * window is mapped, its client's process ID is looked up among the recorded
+ * launches, and among up to a few of its ancestors, as for clients launched
+ * through a shell or a wrapper. The first window of each launch counts.
+ *
+ * Launches from another process, such as `wlmdock`, are recorded by setting
+ * @ref WLM_UTIL_LAUNCH_TRACKER_ENV in the launched process' environment,
+ * through @ref wlm_util_launch_tracker_setenv.
+ */
+typedef struct _wlm_util_launch_tracker_t wlm_util_launch_tracker_t;
+
+/**
+ * Environment variable marking a launch: `<usec>:<app>`, with `usec` the
+ * launch time as CLOCK_MONOTONIC, in microseconds.
+ */
+#define WLM_UTIL_LAUNCH_TRACKER_ENV "WLMAKER_LAUNCH"
+
+/** Latency statistics of an application. */
+typedef struct {
+    /** Number of launches with a measured latency. */
+    uint64_t                  count;
+    /** Number of launches that had no window within the time limit. */
+    uint64_t                  expired;
+    /** Shortest latency, in microseconds. */
+    uint64_t                  min_usec;
+    /** Longest latency, in microseconds. */
+    uint64_t                  max_usec;
+    /** Sum of all latencies, in microseconds. */
+    uint64_t                  sum_usec;
+    /** Latest latency, in microseconds. */
+    uint64_t                  last_usec;
+} wlm_util_launch_stats_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the launch tracker.
+ *
+ * @return Pointer to the tracker, or NULL on error. Must be destroyed by
+ *     calling @ref wlm_util_launch_tracker_destroy.
+ */
+wlm_util_launch_tracker_t *wlm_util_launch_tracker_create(void);
+
+/**
+ * Destroys the launch tracker.
+ *
+ * @param tracker_ptr
+ */
+void wlm_util_launch_tracker_destroy(wlm_util_launch_tracker_t *tracker_ptr);
+
+/**
+ * Records a launch, at the current time.
+ *
+ * @param tracker_ptr         May be NULL, to not record anything.
+ * @param pid                 Process ID of the launched process.
+ * @param app_ptr             Name of the application, eg. the command line.
+ */
+void wlm_util_launch_tracker_launched(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid,
+    const char *app_ptr);
+
+/**
+ * Reports a window of process `pid` as mapped. Records the latency, if this
+ * is the first window of a recorded launch.
+ *
+ * Reads from /proc only while launches are pending, or for the first window
+ * of a process. Returns early otherwise.
+ *
+ * @param tracker_ptr         May be NULL, to not record anything.
+ * @param pid
+ *
+ * @return true if a latency was recorded.
+ */
+bool wlm_util_launch_tracker_mapped(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    pid_t pid);
+
+/**
+ * Returns the statistics of the application.
+ *
+ * @param tracker_ptr
+ * @param app_ptr
+ *
+ * @return Pointer to the statistics, or NULL if there was no launch of
+ *     `app_ptr`. Valid until the tracker is destroyed.
+ */
+const wlm_util_launch_stats_t *wlm_util_launch_tracker_stats(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    const char *app_ptr);
+
+/**
+ * Logs the statistics, one line per application.
+ *
+ * @param tracker_ptr
+ * @param severity
+ */
+void wlm_util_launch_tracker_log(
+    wlm_util_launch_tracker_t *tracker_ptr,
+    bs_log_severity_t severity);
+
+/**
+ * Sets @ref WLM_UTIL_LAUNCH_TRACKER_ENV in the environment of this process,
+ * for marking processes launched next. To be reverted by calling
+ * @ref wlm_util_launch_tracker_unsetenv, once launched.
+ *
+ * @param app_ptr
+ *
+ * @return true on success.
+ */
+bool wlm_util_launch_tracker_setenv(const char *app_ptr);
+
+/** Removes @ref WLM_UTIL_LAUNCH_TRACKER_ENV from the environment. */
+void wlm_util_launch_tracker_unsetenv(void);
+
+/** Unit test set for @ref wlm_util_launch_tracker_t. */
+extern const bs_test_set_t wlm_util_launch_tracker_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_LAUNCH_TRACKER_H__ */
+/* == End of launch_tracker.h ============================================== */
@@ -0,0 +1,667 @@
+/* ========================================================================= */
+/**
+ * @file persist.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "persist.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+/* == Declarations ========================================================= */
+
+/** State of the persistence service. */
+struct _wlm_util_persist_t {
+    /** Name of the file to persist into. */
+    char                      *fname_ptr;
+    /** Temporary file, renamed to @ref wlm_util_persist_t::fname_ptr. */
+    char                      *tmp_fname_ptr;
+    /** Directory of the file. Synced after the rename. */
+    char                      *dirname_ptr;
+    /** Mode of the file. */
+    mode_t                    mode;
+    /** Serializes the state. */
+    wlm_util_persist_serialize_t serialize;
+    /** Reports completion of a write. May be NULL. */
+    wlm_util_persist_done_t   done;
+    /** Argument to `serialize` and `done`. */
+    void                      *ud_ptr;
+
+    /** The event loop. Members below up to the mutex belong to its thread. */
+    struct wl_event_loop      *wl_event_loop_ptr;
+    /** Idle source for serializing the state, while scheduled. */
+    struct wl_event_source    *idle_source_ptr;
+    /** Whether a save was requested since the last serialization. */
+    bool                      dirty;
+    /** Whether a snapshot was handed to the writer, and not reported back. */
+    bool                      in_flight;
+    /** Signalled by the writer when a write is done. */
+    int                       event_fd;
+    /** Event source for @ref wlm_util_persist_t::event_fd. */
+    struct wl_event_source    *fd_source_ptr;
+    /** The writer thread. */
+    pthread_t                 thread;
+    /** Whether @ref wlm_util_persist_t::thread was started. */
+    bool                      thread_started;
+
+    /** Guards all members below. */
+    pthread_mutex_t           mutex;
+    /** Signalled when a snapshot is handed over, or on shutdown. */
+    pthread_cond_t            cond;
+    /** Snapshot to write, or being written. NULL if none. */
+    bs_dynbuf_t               *snapshot_dynbuf_ptr;
+    /** Result of the last write. */
+    bool                      success;
+    /** Whether the writer shall exit, once the snapshot is written. */
+    bool                      shutdown;
+    /** Writes the data. */
+    wlm_util_persist_write_t  write_fn;
+    /** Argument to `write_fn`. */
+    void                      *write_ud_ptr;
+};
+
+static bool _wlm_util_persist_schedule(wlm_util_persist_t *persist_ptr);
+static void _wlm_util_persist_handle_idle(void *data_ptr);
+static int _wlm_util_persist_handle_event_fd(
+    int fd,
+    uint32_t mask,
+    void *data_ptr);
+static bs_dynbuf_t *_wlm_util_persist_snapshot(
+    wlm_util_persist_t *persist_ptr);
+static void *_wlm_util_persist_worker(void *arg_ptr);
+static bool _wlm_util_persist_write_file(
+    wlm_util_persist_t *persist_ptr,
+    bs_dynbuf_t *dynbuf_ptr,
+    wlm_util_persist_write_t write_fn,
+    void *write_ud_ptr);
+static bool _wlm_util_persist_write_fd(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_util_persist_t *wlm_util_persist_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *fname_ptr,
+    mode_t mode,
+    wlm_util_persist_serialize_t serialize,
+    wlm_util_persist_done_t done,
+    void *ud_ptr)
+{
+    wlm_util_persist_t *persist_ptr = logged_calloc(
+        1, sizeof(wlm_util_persist_t));
+    if (NULL == persist_ptr) return NULL;
+    persist_ptr->wl_event_loop_ptr = wl_event_loop_ptr;
+    persist_ptr->mode = mode;
+    persist_ptr->serialize = serialize;
+    persist_ptr->done = done;
+    persist_ptr->ud_ptr = ud_ptr;
+    persist_ptr->write_fn = _wlm_util_persist_write_fd;
+    persist_ptr->event_fd = -1;
+    pthread_mutex_init(&persist_ptr->mutex, NULL);
+    pthread_cond_init(&persist_ptr->cond, NULL);
+
+    persist_ptr->fname_ptr = logged_strdup(fname_ptr);
+    if (NULL == persist_ptr->fname_ptr) goto error;
+    persist_ptr->tmp_fname_ptr = bs_strdupf(
+        "%s.%"PRIdMAX, fname_ptr, (intmax_t)getpid());
+    if (NULL == persist_ptr->tmp_fname_ptr) goto error;
+    persist_ptr->dirname_ptr = logged_strdup(fname_ptr);
+    if (NULL == persist_ptr->dirname_ptr) goto error;
+    char *slash_ptr = strrchr(persist_ptr->dirname_ptr, '/');
+    if (NULL == slash_ptr) {
+        strcpy(persist_ptr->dirname_ptr, ".");
+    } else {
+        slash_ptr[slash_ptr == persist_ptr->dirname_ptr ? 1 : 0] = '\0';
+    }
+
+    persist_ptr->event_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (0 > persist_ptr->event_fd) {
+        bs_log(BS_ERROR | BS_ERRNO,
+               "Failed eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)");
+        goto error;
+    }
+    persist_ptr->fd_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr,
+        persist_ptr->event_fd,
+        WL_EVENT_READABLE,
+        _wlm_util_persist_handle_event_fd,
+        persist_ptr);
+    if (NULL == persist_ptr->fd_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_fd(%p, %d, "
+               "WL_EVENT_READABLE, %p, %p)",
+               wl_event_loop_ptr, persist_ptr->event_fd,
+               _wlm_util_persist_handle_event_fd, persist_ptr);
+        goto error;
+    }
+
+    int rv = pthread_create(
+        &persist_ptr->thread, NULL, _wlm_util_persist_worker, persist_ptr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create(%p, NULL, %p, %p)",
+               &persist_ptr->thread, _wlm_util_persist_worker, persist_ptr);
+        goto error;
+    }
+    persist_ptr->thread_started = true;
+    return persist_ptr;
+
+error:
+    wlm_util_persist_destroy(persist_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_persist_destroy(wlm_util_persist_t *persist_ptr)
+{
+    if (NULL != persist_ptr->idle_source_ptr) {
+        wl_event_source_remove(persist_ptr->idle_source_ptr);
+        persist_ptr->idle_source_ptr = NULL;
+    }
+
+    // The writer completes a write in flight before it exits.
+    if (persist_ptr->thread_started) {
+        pthread_mutex_lock(&persist_ptr->mutex);
+        persist_ptr->shutdown = true;
+        pthread_cond_signal(&persist_ptr->cond);
+        pthread_mutex_unlock(&persist_ptr->mutex);
+        pthread_join(persist_ptr->thread, NULL);
+        persist_ptr->thread_started = false;
+    }
+
+    // A save requested after that snapshot is written right here.
+    if (persist_ptr->dirty) {
+        persist_ptr->dirty = false;
+        bs_dynbuf_t *dynbuf_ptr = _wlm_util_persist_snapshot(persist_ptr);
+        if (NULL != dynbuf_ptr) {
+            _wlm_util_persist_write_file(
+                persist_ptr, dynbuf_ptr,
+                persist_ptr->write_fn, persist_ptr->write_ud_ptr);
+            bs_dynbuf_destroy(dynbuf_ptr);
+        }
+    }
+
+    if (NULL != persist_ptr->fd_source_ptr) {
+        wl_event_source_remove(persist_ptr->fd_source_ptr);
+        persist_ptr->fd_source_ptr = NULL;
+    }
+    if (0 <= persist_ptr->event_fd) {
+        close(persist_ptr->event_fd);
+        persist_ptr->event_fd = -1;
+    }
+    if (NULL != persist_ptr->dirname_ptr) {
+        free(persist_ptr->dirname_ptr);
+        persist_ptr->dirname_ptr = NULL;
+    }
+    if (NULL != persist_ptr->tmp_fname_ptr) {
+        free(persist_ptr->tmp_fname_ptr);
+        persist_ptr->tmp_fname_ptr = NULL;
+    }
+    if (NULL != persist_ptr->fname_ptr) {
+        free(persist_ptr->fname_ptr);
+        persist_ptr->fname_ptr = NULL;
+    }
+    pthread_cond_destroy(&persist_ptr->cond);
+    pthread_mutex_destroy(&persist_ptr->mutex);
+    free(persist_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_persist_save(wlm_util_persist_t *persist_ptr)
+{
+    persist_ptr->dirty = true;
+    return _wlm_util_persist_schedule(persist_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_persist_set_write(
+    wlm_util_persist_t *persist_ptr,
+    wlm_util_persist_write_t write_fn,
+    void *write_ud_ptr)
+{
+    pthread_mutex_lock(&persist_ptr->mutex);
+    if (NULL == write_fn) write_fn = _wlm_util_persist_write_fd;
+    persist_ptr->write_fn = write_fn;
+    persist_ptr->write_ud_ptr = write_ud_ptr;
+    pthread_mutex_unlock(&persist_ptr->mutex);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Schedules serializing the state when the event loop is idle. Does nothing
+ * if already scheduled, or while a write is in flight: Completion of that
+ * write will schedule it.
+ *
+ * @param persist_ptr
+ *
+ * @return false on error.
+ */
+bool _wlm_util_persist_schedule(wlm_util_persist_t *persist_ptr)
+{
+    if (persist_ptr->in_flight || NULL != persist_ptr->idle_source_ptr) {
+        return true;
+    }
+
+    persist_ptr->idle_source_ptr = wl_event_loop_add_idle(
+        persist_ptr->wl_event_loop_ptr,
+        _wlm_util_persist_handle_idle,
+        persist_ptr);
+    if (NULL == persist_ptr->idle_source_ptr) {
+        bs_log(BS_ERROR, "Failed wl_event_loop_add_idle(%p, %p, %p)",
+               persist_ptr->wl_event_loop_ptr,
+               _wlm_util_persist_handle_idle, persist_ptr);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Serializes the state, and hands the snapshot to the writer. */
+void _wlm_util_persist_handle_idle(void *data_ptr)
+{
+    wlm_util_persist_t *persist_ptr = data_ptr;
+    // Idle sources are removed once dispatched.
+    persist_ptr->idle_source_ptr = NULL;
+    if (!persist_ptr->dirty) return;
+
+    persist_ptr->dirty = false;
+    bs_dynbuf_t *dynbuf_ptr = _wlm_util_persist_snapshot(persist_ptr);
+    if (NULL == dynbuf_ptr) {
+        if (NULL != persist_ptr->done) {
+            persist_ptr->done(false, persist_ptr->ud_ptr);
+        }
+        return;
+    }
+
+    pthread_mutex_lock(&persist_ptr->mutex);
+    BS_ASSERT(NULL == persist_ptr->snapshot_dynbuf_ptr);
+    persist_ptr->snapshot_dynbuf_ptr = dynbuf_ptr;
+    pthread_cond_signal(&persist_ptr->cond);
+    pthread_mutex_unlock(&persist_ptr->mutex);
+    persist_ptr->in_flight = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the writer's signal on @ref wlm_util_persist_t::event_fd: Reports
+ * the completed write, and schedules a save requested meanwhile.
+ *
+ * @param fd
+ * @param mask
+ * @param data_ptr
+ *
+ * @return 0.
+ */
+int _wlm_util_persist_handle_event_fd(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *data_ptr)
+{
+    wlm_util_persist_t *persist_ptr = data_ptr;
+    uint64_t value;
+    if (0 > read(fd, &value, sizeof(value)) && EAGAIN != errno) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed read(%d, %p, %zu)",
+               fd, &value, sizeof(value));
+    }
+
+    pthread_mutex_lock(&persist_ptr->mutex);
+    bool completed = NULL == persist_ptr->snapshot_dynbuf_ptr;
+    bool success = persist_ptr->success;
+    pthread_mutex_unlock(&persist_ptr->mutex);
+    if (!persist_ptr->in_flight || !completed) return 0;
+
+    persist_ptr->in_flight = false;
+    if (NULL != persist_ptr->done) {
+        persist_ptr->done(success, persist_ptr->ud_ptr);
+    }
+    if (persist_ptr->dirty) _wlm_util_persist_schedule(persist_ptr);
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return A dynbuf with the serialized state, or NULL on error. */
+bs_dynbuf_t *_wlm_util_persist_snapshot(wlm_util_persist_t *persist_ptr)
+{
+    bs_dynbuf_t *dynbuf_ptr = bs_dynbuf_create(getpagesize(), SIZE_MAX);
+    if (NULL == dynbuf_ptr) return NULL;
+    if (!persist_ptr->serialize(dynbuf_ptr, persist_ptr->ud_ptr)) {
+        bs_log(BS_WARNING, "Failed to serialize state for \"%s\"",
+               persist_ptr->fname_ptr);
+        bs_dynbuf_destroy(dynbuf_ptr);
+        return NULL;
+    }
+    return dynbuf_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Thread function: Writes the snapshots, and signals the event loop for each.
+ *
+ * @param arg_ptr             Points to @ref wlm_util_persist_t.
+ *
+ * @return NULL.
+ */
+void *_wlm_util_persist_worker(void *arg_ptr)
+{
+    wlm_util_persist_t *persist_ptr = arg_ptr;
+
+    pthread_mutex_lock(&persist_ptr->mutex);
+    while (true) {
+        while (NULL == persist_ptr->snapshot_dynbuf_ptr &&
+               !persist_ptr->shutdown) {
+            pthread_cond_wait(&persist_ptr->cond, &persist_ptr->mutex);
+        }
+        bs_dynbuf_t *dynbuf_ptr = persist_ptr->snapshot_dynbuf_ptr;
+        if (NULL == dynbuf_ptr) break;
+        wlm_util_persist_write_t write_fn = persist_ptr->write_fn;
+        void *write_ud_ptr = persist_ptr->write_ud_ptr;
+        pthread_mutex_unlock(&persist_ptr->mutex);
+
+        bool success = _wlm_util_persist_write_file(
+            persist_ptr, dynbuf_ptr, write_fn, write_ud_ptr);
+        bs_dynbuf_destroy(dynbuf_ptr);
+
+        pthread_mutex_lock(&persist_ptr->mutex);
+        persist_ptr->snapshot_dynbuf_ptr = NULL;
+        persist_ptr->success = success;
+
+        uint64_t value = 1;
+        while (0 > write(persist_ptr->event_fd, &value, sizeof(value))) {
+            if (EINTR == errno) continue;
+            bs_log(BS_ERROR | BS_ERRNO, "Failed write(%d, %p, %zu)",
+                   persist_ptr->event_fd, &value, sizeof(value));
+            break;
+        }
+    }
+    pthread_mutex_unlock(&persist_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Writes the snapshot atomically: Into the temporary file, which is synced
+ * and then renamed over the target. Finally syncs the directory, to persist
+ * the rename.
+ *
+ * Only accesses members of `persist_ptr` that are constant after creation.
+ *
+ * @param persist_ptr
+ * @param dynbuf_ptr
+ * @param write_fn
+ * @param write_ud_ptr
+ *
+ * @return true on success.
+ */
+bool _wlm_util_persist_write_file(
+    wlm_util_persist_t *persist_ptr,
+    bs_dynbuf_t *dynbuf_ptr,
+    wlm_util_persist_write_t write_fn,
+    void *write_ud_ptr)
+{
+    const char *tmp_ptr = persist_ptr->tmp_fname_ptr;
+    int fd = open(tmp_ptr, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                  persist_ptr->mode);
+    if (0 > fd) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed open(\"%s\", O_WRONLY | "
+               "O_CREAT | O_TRUNC | O_CLOEXEC, 0%o)",
+               tmp_ptr, (unsigned)persist_ptr->mode);
+        return false;
+    }
+
+    bool rv = write_fn(fd, dynbuf_ptr->data_ptr, dynbuf_ptr->length,
+                       write_ud_ptr);
+    if (!rv) {
+        bs_log(BS_WARNING, "Failed to write %zu bytes to \"%s\"",
+               dynbuf_ptr->length, tmp_ptr);
+    }
+    if (rv && 0 != fsync(fd)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed fsync(%d) for \"%s\"",
+               fd, tmp_ptr);
+        rv = false;
+    }
+    if (0 != close(fd) && rv) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed close(%d) for \"%s\"",
+               fd, tmp_ptr);
+        rv = false;
+    }
+    if (rv && 0 != rename(tmp_ptr, persist_ptr->fname_ptr)) {
+        bs_log(BS_WARNING | BS_ERRNO, "Failed rename(\"%s\", \"%s\")",
+               tmp_ptr, persist_ptr->fname_ptr);
+        rv = false;
+    }
+    if (!rv) {
+        unlink(tmp_ptr);
+        return false;
+    }
+
+    int dir_fd = open(persist_ptr->dirname_ptr,
+                      O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (0 > dir_fd || 0 != fsync(dir_fd)) {
+        // The file is complete either way. Only the rename may be lost.
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed to sync directory \"%s\"",
+               persist_ptr->dirname_ptr);
+    }
+    if (0 <= dir_fd) close(dir_fd);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Default for @ref wlm_util_persist_t::write_fn. Loops over write(2). */
+bool _wlm_util_persist_write_fd(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    __UNUSED__ void *ud_ptr)
+{
+    const uint8_t *ptr = data_ptr;
+    while (0 < len) {
+        ssize_t written = write(fd, ptr, len);
+        if (0 > written) {
+            if (EINTR == errno) continue;
+            bs_log(BS_WARNING | BS_ERRNO, "Failed write(%d, %p, %zu)",
+                   fd, ptr, len);
+            return false;
+        }
+        ptr += written;
+        len -= written;
+    }
+    return true;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_persist_test_write_behind(bs_test_t *test_ptr);
+static void _wlm_util_persist_test_destroy(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlm_util_persist_test_cases[] = {
+    { 1, "write_behind", _wlm_util_persist_test_write_behind },
+    { 1, "destroy", _wlm_util_persist_test_destroy },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_persist_test_set = BS_TEST_SET(
+    true, "persist", _wlm_util_persist_test_cases);
+
+/** Test state: What to serialize, and what happened. */
+typedef struct {
+    /** The state to serialize. */
+    const char                *state_ptr;
+    /** Number of calls to serialize. */
+    int                       serialized;
+    /** Number of calls to done. */
+    int                       done;
+    /** Argument to the last call to done. */
+    bool                      success;
+    /** A slow disk: Each write blocks until a byte is read from here. */
+    int                       release_fd;
+} _wlm_util_persist_test_t;
+
+/* ------------------------------------------------------------------------- */
+/** Test serializer: Appends @ref _wlm_util_persist_test_t::state_ptr. */
+static bool _wlm_util_persist_test_serialize(bs_dynbuf_t *d, void *ud_ptr)
+{
+    _wlm_util_persist_test_t *t = ud_ptr;
+    ++t->serialized;
+    return bs_dynbuf_append(d, t->state_ptr, strlen(t->state_ptr));
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test completion: Counts calls. */
+static void _wlm_util_persist_test_done(bool success, void *ud_ptr)
+{
+    _wlm_util_persist_test_t *t = ud_ptr;
+    ++t->done;
+    t->success = success;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test writer: Blocks on the pipe, then writes. */
+static bool _wlm_util_persist_test_slow_write(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr)
+{
+    _wlm_util_persist_test_t *t = ud_ptr;
+    char c;
+    while (0 > read(t->release_fd, &c, 1) && EINTR == errno) continue;
+    return _wlm_util_persist_write_fd(fd, data_ptr, len, NULL);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Reads up to `size - 1` bytes of `fname_ptr` into `buf`, and terminates. */
+static void _wlm_util_persist_test_read(
+    const char *fname_ptr,
+    char *buf,
+    size_t size)
+{
+    buf[0] = '\0';
+    FILE *file_ptr = fopen(fname_ptr, "r");
+    if (NULL == file_ptr) return;
+    buf[fread(buf, 1, size - 1, file_ptr)] = '\0';
+    fclose(file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Saves are written behind a slow writer, and coalesced meanwhile. */
+void _wlm_util_persist_test_write_behind(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlm_util_persist_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/state.plist", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+    int pipe_fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe(pipe_fds));
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    _wlm_util_persist_test_t t = { .state_ptr = "1",
+                                   .release_fd = pipe_fds[0] };
+    wlm_util_persist_t *p = wlm_util_persist_create(
+        wl_event_loop_ptr, fname_ptr, S_IRUSR | S_IWUSR,
+        _wlm_util_persist_test_serialize, _wlm_util_persist_test_done, &t);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+    wlm_util_persist_set_write(p, _wlm_util_persist_test_slow_write, &t);
+
+    // Two saves: Serialized once, when idle.
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_persist_save(p));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_persist_save(p));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t.serialized);
+    wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.serialized);
+
+    // The writer blocks. The loop keeps running, and saves are coalesced.
+    t.state_ptr = "2";
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_persist_save(p));
+    t.state_ptr = "3";
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_persist_save(p));
+    wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.serialized);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t.done);
+    BS_TEST_VERIFY_FALSE(test_ptr, bs_file_realpath_is(fname_ptr, S_IFREG));
+
+    // Unblock both writes: The second writes the latest state.
+    BS_TEST_VERIFY_EQ(test_ptr, 2, write(pipe_fds[1], "xx", 2));
+    for (int i = 0; i < 100 && 2 > t.done; ++i) {
+        wl_event_loop_dispatch(wl_event_loop_ptr, 100);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 2, t.serialized);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, t.done);
+    BS_TEST_VERIFY_TRUE(test_ptr, t.success);
+    char buf[16];
+    _wlm_util_persist_test_read(fname_ptr, buf, sizeof(buf));
+    BS_TEST_VERIFY_STREQ(test_ptr, "3", buf);
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, access(p->tmp_fname_ptr, F_OK));
+
+    wlm_util_persist_destroy(p);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    close(pipe_fds[1]);
+    close(pipe_fds[0]);
+    unlink(fname_ptr);
+    free(fname_ptr);
+    rmdir(dir);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Destroying writes a pending save. */
+void _wlm_util_persist_test_destroy(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlm_util_persist_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/state.plist", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+
+    _wlm_util_persist_test_t t = { .state_ptr = "4" };
+    wlm_util_persist_t *p = wlm_util_persist_create(
+        wl_event_loop_ptr, fname_ptr, S_IRUSR | S_IWUSR,
+        _wlm_util_persist_test_serialize, _wlm_util_persist_test_done, &t);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, p);
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_persist_save(p));
+    wlm_util_persist_destroy(p);
+
+    BS_TEST_VERIFY_EQ(test_ptr, 1, t.serialized);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, t.done);
+    char buf[16];
+    _wlm_util_persist_test_read(fname_ptr, buf, sizeof(buf));
+    BS_TEST_VERIFY_STREQ(test_ptr, "4", buf);
+
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    unlink(fname_ptr);
+    free(fname_ptr);
+    rmdir(dir);
+}
+
+/* == End of persist.c ===================================================== */
@@ -0,0 +1,140 @@
+/* ========================================================================= */
+/**
+ * @file persist.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_PERSIST_H__
+#define __WLMAKER_UTIL_PERSIST_H__
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+#include <libbase/libbase.h>
+
+struct wl_event_loop;
+
+/**
+ * Write-behind persistence of one file.
+ *
+ * Saves are requested on the event loop's thread, and coalesced: The state is
+ * serialized once per idle iteration of the event loop, and at most one write
+ * is in flight. A writer thread writes the snapshot to a temporary file,
+ * syncs it and renames it over the target; so the file is never truncated,
+ * and a slow disk does not stall the event loop.
+ */
+typedef struct _wlm_util_persist_t wlm_util_persist_t;
+
+/**
+ * Serializes the state to persist. Called on the event loop's thread.
+ *
+ * @param dynbuf_ptr          Initialized and empty. To append the state to.
+ * @param ud_ptr
+ *
+ * @return true on success.
+ */
+typedef bool (*wlm_util_persist_serialize_t)(
+    bs_dynbuf_t *dynbuf_ptr,
+    void *ud_ptr);
+
+/**
+ * Reports completion of a write. Called on the event loop's thread.
+ *
+ * @param success             Whether the file was written and renamed.
+ * @param ud_ptr
+ */
+typedef void (*wlm_util_persist_done_t)(bool success, void *ud_ptr);
+
+/**
+ * Writes all of `data_ptr` to `fd`. Called on the writer thread.
+ *
+ * @param fd
+ * @param data_ptr
+ * @param len
+ * @param ud_ptr
+ *
+ * @return true on success.
+ */
+typedef bool (*wlm_util_persist_write_t)(
+    int fd,
+    const void *data_ptr,
+    size_t len,
+    void *ud_ptr);
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the persistence service for `fname_ptr`, and starts its writer.
+ *
+ * @param wl_event_loop_ptr
+ * @param fname_ptr
+ * @param mode                File mode, eg. `S_IRUSR | S_IWUSR`.
+ * @param serialize
+ * @param done                May be NULL.
+ * @param ud_ptr              Argument to `serialize` and `done`.
+ *
+ * @return Pointer to the service, or NULL on error. Must be destroyed by
+ *     calling @ref wlm_util_persist_destroy.
+ */
+wlm_util_persist_t *wlm_util_persist_create(
+    struct wl_event_loop *wl_event_loop_ptr,
+    const char *fname_ptr,
+    mode_t mode,
+    wlm_util_persist_serialize_t serialize,
+    wlm_util_persist_done_t done,
+    void *ud_ptr);
+
+/**
+ * Destroys the service. Waits for a write in flight, and writes a pending
+ * save synchronously, so no requested save is lost. Does not call `done`.
+ *
+ * @param persist_ptr
+ */
+void wlm_util_persist_destroy(wlm_util_persist_t *persist_ptr);
+
+/**
+ * Requests saving the state. Returns right away: The state is serialized
+ * when the event loop is idle, and written on the writer thread.
+ *
+ * @param persist_ptr
+ *
+ * @return false if the save could not be scheduled.
+ */
+bool wlm_util_persist_save(wlm_util_persist_t *persist_ptr);
+
+/**
+ * Overrides how the writer thread writes data. For tests.
+ *
+ * @param persist_ptr
+ * @param write_fn            NULL to restore the default, using write(2).
+ * @param write_ud_ptr
+ */
+void wlm_util_persist_set_write(
+    wlm_util_persist_t *persist_ptr,
+    wlm_util_persist_write_t write_fn,
+    void *write_ud_ptr);
+
+/** Unit test set for @ref wlm_util_persist_t. */
+extern const bs_test_set_t wlm_util_persist_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_PERSIST_H__ */
+/* == End of persist.h ===================================================== */
@@ -0,0 +1,450 @@
+/* ========================================================================= */
+/**
+ * @file spawn.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** For `pipe2`. */
+#define _GNU_SOURCE
+
+#include "spawn.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "async_log.h"
+
+/* == Declarations ========================================================= */
+
+/** The process' environment, passed on to the child. */
+extern char **environ;
+
+static bool _wlm_util_spawn_pipe(
+    posix_spawn_file_actions_t *file_actions_ptr,
+    int fds[2],
+    int target_fd);
+static void _wlm_util_spawn_close(int *fd_ptr);
+
+/** Characters the shell interprets anywhere in an unquoted word. */
+static const char _wlm_util_spawn_shell_chars[] = "|&;<>()$`*?[]{}!\n\r";
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+char **wlm_util_spawn_argv_create(const char *cmdline_ptr)
+{
+    // Words are written back-to-back, each NUL-terminated. Quotes and
+    // separators are dropped, so the words never exceed the command line.
+    char *words_ptr = logged_malloc(strlen(cmdline_ptr) + 1);
+    if (NULL == words_ptr) return NULL;
+
+    char *out_ptr = words_ptr;
+    size_t words = 0;
+    bool in_word = false;
+    for (const char *c_ptr = cmdline_ptr; ; ++c_ptr) {
+        char c = *c_ptr;
+        if ('\0' == c || ' ' == c || '\t' == c) {
+            if (in_word) {
+                *out_ptr++ = '\0';
+                ++words;
+                in_word = false;
+            }
+            if ('\0' == c) break;
+            continue;
+        }
+
+        // At the start of a word: Comments, tilde expansion.
+        if (!in_word && ('#' == c || '~' == c)) goto shell;
+        // Assignments in the first word, eg. `FOO=bar cmd`.
+        if (0 == words && '=' == c) goto shell;
+        if (NULL != strchr(_wlm_util_spawn_shell_chars, c)) goto shell;
+        in_word = true;
+
+        if ('\\' == c) {
+            c = *++c_ptr;
+            if ('\0' == c || '\n' == c) goto shell;
+            *out_ptr++ = c;
+        } else if ('\'' == c) {
+            while ('\'' != *++c_ptr) {
+                if ('\0' == *c_ptr) goto shell;
+                *out_ptr++ = *c_ptr;
+            }
+        } else if ('"' == c) {
+            while ('"' != *++c_ptr) {
+                if ('\0' == *c_ptr || NULL != strchr("$`\\", *c_ptr)) {
+                    goto shell;
+                }
+                *out_ptr++ = *c_ptr;
+            }
+        } else {
+            *out_ptr++ = c;
+        }
+    }
+    if (0 == words) goto shell;
+
+    char **argv_ptr = logged_calloc(words + 1, sizeof(char*));
+    if (NULL == argv_ptr) goto shell;
+    char *word_ptr = words_ptr;
+    for (size_t i = 0; i < words; ++i) {
+        argv_ptr[i] = word_ptr;
+        word_ptr += strlen(word_ptr) + 1;
+    }
+    return argv_ptr;
+
+shell:
+    free(words_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_spawn_argv_destroy(char **argv_ptr)
+{
+    // All words share the buffer starting at argv_ptr[0].
+    free(argv_ptr[0]);
+    free(argv_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+pid_t wlm_util_spawn(
+    const char *cmdline_ptr,
+    int *stdout_fd_ptr,
+    int *stderr_fd_ptr)
+{
+    int stdout_fds[2] = { -1, -1 }, stderr_fds[2] = { -1, -1 };
+    posix_spawn_file_actions_t file_actions;
+    posix_spawnattr_t attr;
+    pid_t pid = -1;
+    int rv;
+
+    if (0 != (rv = posix_spawn_file_actions_init(&file_actions))) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed posix_spawn_file_actions_init()");
+        return -1;
+    }
+    if (0 != (rv = posix_spawnattr_init(&attr))) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed posix_spawnattr_init()");
+        posix_spawn_file_actions_destroy(&file_actions);
+        return -1;
+    }
+
+    if (NULL != stdout_fd_ptr &&
+        !_wlm_util_spawn_pipe(&file_actions, stdout_fds, STDOUT_FILENO)) {
+        goto cleanup;
+    }
+    if (NULL != stderr_fd_ptr) {
+        if (!_wlm_util_spawn_pipe(&file_actions, stderr_fds, STDERR_FILENO)) {
+            goto cleanup;
+        }
+    } else if (0 <= wlm_util_async_log_child_stderr_fd()) {
+        // Our stderr may be the asynchronous log's pipe. Bypass it.
+        posix_spawn_file_actions_adddup2(
+            &file_actions, wlm_util_async_log_child_stderr_fd(),
+            STDERR_FILENO);
+    }
+    posix_spawn_file_actions_addopen(
+        &file_actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+
+    // The event loop blocks signals it handles through signalfd. Don't let
+    // the child inherit that, nor any of our handlers.
+    sigset_t sigset;
+    sigemptyset(&sigset);
+    posix_spawnattr_setsigmask(&attr, &sigset);
+    sigfillset(&sigset);
+    posix_spawnattr_setsigdefault(&attr, &sigset);
+    posix_spawnattr_setflags(
+        &attr, POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF);
+
+    rv = ENOENT;
+    char **argv_ptr = wlm_util_spawn_argv_create(cmdline_ptr);
+    if (NULL != argv_ptr) {
+        rv = posix_spawnp(
+            &pid, argv_ptr[0], &file_actions, &attr, argv_ptr, environ);
+        wlm_util_spawn_argv_destroy(argv_ptr);
+    }
+    // Needs the shell, or not an executable: Could be a builtin. The shell
+    // also reports a missing command, on the child's stderr.
+    if (ENOENT == rv) {
+        char *sh_argv[] = { "/bin/sh", "-c", (char*)cmdline_ptr, NULL };
+        rv = posix_spawn(
+            &pid, sh_argv[0], &file_actions, &attr, sh_argv, environ);
+    }
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed posix_spawn for \"%s\"",
+               cmdline_ptr);
+        pid = -1;
+        goto cleanup;
+    }
+
+    if (NULL != stdout_fd_ptr) {
+        *stdout_fd_ptr = stdout_fds[0];
+        stdout_fds[0] = -1;
+    }
+    if (NULL != stderr_fd_ptr) {
+        *stderr_fd_ptr = stderr_fds[0];
+        stderr_fds[0] = -1;
+    }
+
+cleanup:
+    _wlm_util_spawn_close(&stdout_fds[0]);
+    _wlm_util_spawn_close(&stdout_fds[1]);
+    _wlm_util_spawn_close(&stderr_fds[0]);
+    _wlm_util_spawn_close(&stderr_fds[1]);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&file_actions);
+    return pid;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Creates a pipe, with a non-blocking reading end for the parent. The writing
+ * end becomes `target_fd` of the child.
+ *
+ * @param file_actions_ptr
+ * @param fds                 Receives the pipe's file descriptors.
+ * @param target_fd
+ *
+ * @return true on success.
+ */
+bool _wlm_util_spawn_pipe(
+    posix_spawn_file_actions_t *file_actions_ptr,
+    int fds[2],
+    int target_fd)
+{
+    if (0 != pipe2(fds, O_CLOEXEC)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pipe2(%p, O_CLOEXEC)", fds);
+        return false;
+    }
+    if (0 != fcntl(fds[0], F_SETFL, O_NONBLOCK)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed fcntl(%d, F_SETFL, O_NONBLOCK)",
+               fds[0]);
+        return false;
+    }
+    // dup2 clears O_CLOEXEC on `target_fd`. The pipe's ends stay CLOEXEC.
+    int rv = posix_spawn_file_actions_adddup2(
+        file_actions_ptr, fds[1], target_fd);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO,
+               "Failed posix_spawn_file_actions_adddup2(%p, %d, %d)",
+               file_actions_ptr, fds[1], target_fd);
+        return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Closes `*fd_ptr`, if open, and marks it closed. */
+void _wlm_util_spawn_close(int *fd_ptr)
+{
+    if (0 <= *fd_ptr) close(*fd_ptr);
+    *fd_ptr = -1;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_spawn_test_argv(bs_test_t *test_ptr);
+static void _wlm_util_spawn_test_spawn(bs_test_t *test_ptr);
+static void _wlm_util_spawn_test_benchmark(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlm_util_spawn_test_cases[] = {
+    { 1, "argv", _wlm_util_spawn_test_argv },
+    { 1, "spawn", _wlm_util_spawn_test_spawn },
+    { 1, "benchmark", _wlm_util_spawn_test_benchmark },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_spawn_test_set = BS_TEST_SET(
+    true, "spawn", _wlm_util_spawn_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether `cmdline_ptr` splits into the NULL-terminated `expected`,
+ * or needs the shell if `expected` is NULL.
+ */
+static bool _wlm_util_spawn_test_argv_equals(
+    const char *cmdline_ptr,
+    const char **expected)
+{
+    char **argv_ptr = wlm_util_spawn_argv_create(cmdline_ptr);
+    bool equal = (NULL == argv_ptr) == (NULL == expected);
+    for (size_t i = 0; equal && NULL != expected; ++i) {
+        if (NULL == expected[i] || NULL == argv_ptr[i]) {
+            equal = expected[i] == argv_ptr[i];
+            break;
+        }
+        equal = 0 == strcmp(expected[i], argv_ptr[i]);
+    }
+    if (!equal) bs_log(BS_ERROR, "Unexpected split of \"%s\"", cmdline_ptr);
+    if (NULL != argv_ptr) wlm_util_spawn_argv_destroy(argv_ptr);
+    return equal;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests splitting command lines, and detecting shell syntax. */
+void _wlm_util_spawn_test_argv(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_spawn_test_argv_equals(
+        "/usr/bin/foot", (const char*[]){ "/usr/bin/foot", NULL }));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_spawn_test_argv_equals(
+        "  foot\t--server  -e 'a b' ",
+        (const char*[]){ "foot", "--server", "-e", "a b", NULL }));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_spawn_test_argv_equals(
+        "a\"b c\"'d' e\\ f ''",
+        (const char*[]){ "ab cd", "e f", "", NULL }));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_spawn_test_argv_equals(
+        "cmd a=b c#d e~f \"'\" '\"'",
+        (const char*[]){ "cmd", "a=b", "c#d", "e~f", "'", "\"", NULL }));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_spawn_test_argv_equals(
+        "echo \\$HOME", (const char*[]){ "echo", "$HOME", NULL }));
+
+    const char *shell_cmdlines[] = {
+        "", "   ", "a | b", "a > f", "a < f", "a; b", "a && b", "a &",
+        "echo $HOME", "echo `date`", "echo \"$HOME\"", "ls *.c", "ls ?",
+        "ls [ab]", "echo {a,b}", "(a)", "FOO=1 cmd", "~/bin/cmd",
+        "cmd # comment", "'unterminated", "\"unterminated", "a\\",
+        "a\nb", "! a", NULL };
+    for (const char **c_ptr = shell_cmdlines; NULL != *c_ptr; ++c_ptr) {
+        BS_TEST_VERIFY_TRUE(
+            test_ptr, _wlm_util_spawn_test_argv_equals(*c_ptr, NULL));
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Spawns `cmdline_ptr`, waits for it and reads its stdout into `buf`.
+ *
+ * @return The wait status, or -1 on error.
+ */
+static int _wlm_util_spawn_test_run(
+    const char *cmdline_ptr,
+    char *buf,
+    size_t size)
+{
+    int stdout_fd, stderr_fd;
+    pid_t pid = wlm_util_spawn(cmdline_ptr, &stdout_fd, &stderr_fd);
+    if (0 > pid) return -1;
+    int status;
+    if (pid != waitpid(pid, &status, 0)) status = -1;
+
+    ssize_t len = read(stdout_fd, buf, size - 1);
+    buf[BS_MAX(len, 0)] = '\0';
+    close(stdout_fd);
+    close(stderr_fd);
+    return status;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Tests spawning directly, and through the shell. */
+void _wlm_util_spawn_test_spawn(bs_test_t *test_ptr)
+{
+    char buf[256];
+    int status;
+
+    // Direct.
+    status = _wlm_util_spawn_test_run("echo 'hello  world'", buf, sizeof(buf));
+    BS_TEST_VERIFY_TRUE(test_ptr, WIFEXITED(status));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, WEXITSTATUS(status));
+    BS_TEST_VERIFY_STREQ(test_ptr, "hello  world\n", buf);
+
+    // Shell syntax.
+    status = _wlm_util_spawn_test_run("echo abc | tr b x", buf, sizeof(buf));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, WEXITSTATUS(status));
+    BS_TEST_VERIFY_STREQ(test_ptr, "axc\n", buf);
+
+    // A builtin, that is not an executable.
+    status = _wlm_util_spawn_test_run("exit 3", buf, sizeof(buf));
+    BS_TEST_VERIFY_TRUE(test_ptr, WIFEXITED(status));
+    BS_TEST_VERIFY_EQ(test_ptr, 3, WEXITSTATUS(status));
+
+    // Not found, as reported by the shell.
+    status = _wlm_util_spawn_test_run(
+        "/nonexistent/wlmaker-test", buf, sizeof(buf));
+    BS_TEST_VERIFY_EQ(test_ptr, 127, WEXITSTATUS(status));
+
+    // Signals are unblocked in the child.
+    sigset_t sigset, old_sigset;
+    sigemptyset(&sigset);
+    sigaddset(&sigset, SIGTERM);
+    sigprocmask(SIG_BLOCK, &sigset, &old_sigset);
+    status = _wlm_util_spawn_test_run("kill -TERM $$", buf, sizeof(buf));
+    sigprocmask(SIG_SETMASK, &old_sigset, NULL);
+    BS_TEST_VERIFY_TRUE(test_ptr, WIFSIGNALED(status));
+    BS_TEST_VERIFY_EQ(test_ptr, SIGTERM, WTERMSIG(status));
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Benchmark: Launch-to-exit latency of `/bin/true`, through `/bin/sh -c` in
+ * a forked libbase subprocess versus @ref wlm_util_spawn. Exit includes exec.
+ * Touches 64 MiB first, since forking gets slower with the parent's RSS.
+ */
+void _wlm_util_spawn_test_benchmark(bs_test_t *test_ptr)
+{
+    const size_t ballast_size = 64 << 20;
+    const int launches = 100;
+    char *ballast_ptr = logged_malloc(ballast_size);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, ballast_ptr);
+    memset(ballast_ptr, 0x5a, ballast_size);
+
+    uint64_t start_usec = bs_usec();
+    for (int i = 0; i < launches; ++i) {
+        const char *argv[] = { "/bin/sh", "-c", "/bin/true", NULL };
+        bs_subprocess_t *sp_ptr = bs_subprocess_create(argv[0], argv, NULL);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, sp_ptr);
+        BS_TEST_VERIFY_TRUE(test_ptr, bs_subprocess_start(sp_ptr));
+        // Waits without reaping, then lets libbase reap.
+        siginfo_t info;
+        waitid(P_PID, bs_subprocess_pid(sp_ptr), &info, WEXITED | WNOWAIT);
+        int exit_status, signal_number;
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            bs_subprocess_terminated(sp_ptr, &exit_status, &signal_number));
+        bs_subprocess_destroy(sp_ptr);
+    }
+    uint64_t shell_usec = bs_usec() - start_usec;
+
+    start_usec = bs_usec();
+    for (int i = 0; i < launches; ++i) {
+        pid_t pid = wlm_util_spawn("/bin/true", NULL, NULL);
+        BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, -1, pid);
+        int status;
+        BS_TEST_VERIFY_EQ(test_ptr, pid, waitpid(pid, &status, 0));
+        BS_TEST_VERIFY_EQ(test_ptr, 0, status);
+    }
+    uint64_t spawn_usec = bs_usec() - start_usec;
+
+    bs_log(BS_INFO, "spawn: fork & /bin/sh %.1f us, posix_spawn %.1f us "
+           "per launch, with %zu MiB RSS.",
+           (double)shell_usec / launches, (double)spawn_usec / launches,
+           ballast_size >> 20);
+    free(ballast_ptr);
+}
+
+/* == End of spawn.c ======================================================= */
@@ -0,0 +1,87 @@
+/* ========================================================================= */
+/**
+ * @file spawn.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_SPAWN_H__
+#define __WLMAKER_UTIL_SPAWN_H__
+
+#include <sys/types.h>
+#include <libbase/libbase.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Splits a plain command line into arguments, as /bin/sh would.
+ *
+ * Handles blanks, single and double quotes and backslash escapes. Anything
+ * else the shell would interpret -- pipes, redirections, lists, expansions,
+ * globs, comments, assignments -- makes the command line need the shell.
+ *
+ * @param cmdline_ptr
+ *
+ * @return A NULL-terminated argument vector, or NULL if `cmdline_ptr` needs
+ *     the shell, is empty, or on error. Must be destroyed by calling
+ *     @ref wlm_util_spawn_argv_destroy.
+ */
+char **wlm_util_spawn_argv_create(const char *cmdline_ptr);
+
+/**
+ * Destroys the argument vector from @ref wlm_util_spawn_argv_create.
+ *
+ * @param argv_ptr
+ */
+void wlm_util_spawn_argv_destroy(char **argv_ptr);
+
+/**
+ * Launches `cmdline_ptr` through posix_spawn(3), without forking the caller's
+ * address space.
+ *
+ * Plain command lines are executed directly, with the arguments from
+ * @ref wlm_util_spawn_argv_create. Command lines that need the shell, or
+ * that do not name an executable (eg. a shell builtin), are executed as
+ * `/bin/sh -c <cmdline>`.
+ *
+ * The child gets stdin from /dev/null, an empty signal mask and default
+ * signal handlers.
+ *
+ * @param cmdline_ptr
+ * @param stdout_fd_ptr       If not NULL, receives the non-blocking reading
+ *                            end of a pipe connected to the child's stdout.
+ *                            Otherwise, stdout is inherited.
+ * @param stderr_fd_ptr       As `stdout_fd_ptr`, for stderr. If inherited
+ *                            while an asynchronous log redirects stderr, the
+ *                            child gets the original stderr instead.
+ *
+ * @return The child's process ID, or -1 on error.
+ */
+pid_t wlm_util_spawn(
+    const char *cmdline_ptr,
+    int *stdout_fd_ptr,
+    int *stderr_fd_ptr);
+
+/** Unit test set for the spawn functions. */
+extern const bs_test_set_t wlm_util_spawn_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_SPAWN_H__ */
+/* == End of spawn.h ======================================================= */
@@ -0,0 +1,579 @@
+/* ========================================================================= */
+/**
+ * @file startup.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** For `gettid`. */
+#define _GNU_SOURCE
+
+#include "startup.h"
+
+#include <ctype.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** A recorded event: A phase, or the name of a thread. */
+typedef struct {
+    /** Name of the phase, or of the thread. */
+    char                      *name_ptr;
+    /** Thread the phase ran on, or the named thread. */
+    pid_t                     tid;
+    /** Whether this names the thread, rather than a phase. */
+    bool                      thread_name;
+    /** Start of the phase, relative to enabling the trace. */
+    uint64_t                  ts_usec;
+    /** Duration of the phase. */
+    uint64_t                  dur_usec;
+} wlm_util_startup_event_t;
+
+/** State of a startup task. */
+struct _wlm_util_startup_task_t {
+    /** Name of the task. */
+    const char                *name_ptr;
+    /** Function to run. */
+    wlm_util_startup_task_fn_t fn;
+    /** Argument to @ref fn. */
+    void                      *arg_ptr;
+    /** The worker thread. */
+    pthread_t                 thread;
+};
+
+static void _wlm_util_startup_run(
+    const char *name_ptr,
+    wlm_util_startup_task_fn_t fn,
+    void *arg_ptr);
+static void *_wlm_util_startup_thread(void *arg_ptr);
+static void _wlm_util_startup_record(
+    const char *name_ptr,
+    bool thread_name,
+    uint64_t ts_usec,
+    uint64_t dur_usec);
+static int _wlm_util_startup_event_compare(
+    const void *a_ptr,
+    const void *b_ptr);
+static void _wlm_util_startup_write_string(FILE *file_ptr, const char *s_ptr);
+static uint64_t _wlm_util_startup_now_usec(void);
+
+/* == Data ================================================================= */
+
+/** Whether recording is enabled. Checked without holding the lock. */
+static atomic_bool _wlm_util_startup_enabled = false;
+/** Guards the recorded events. */
+static pthread_mutex_t _wlm_util_startup_mutex = PTHREAD_MUTEX_INITIALIZER;
+/** When recording was enabled. Events are relative to that. */
+static uint64_t _wlm_util_startup_origin_usec = 0;
+/** Recorded events. */
+static wlm_util_startup_event_t *_wlm_util_startup_events_ptr = NULL;
+/** Number of events in @ref _wlm_util_startup_events_ptr. */
+static size_t _wlm_util_startup_num_events = 0;
+/** Capacity of @ref _wlm_util_startup_events_ptr. */
+static size_t _wlm_util_startup_max_events = 0;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_startup_trace_enable(void)
+{
+    pthread_mutex_lock(&_wlm_util_startup_mutex);
+    _wlm_util_startup_origin_usec = _wlm_util_startup_now_usec();
+    atomic_store(&_wlm_util_startup_enabled, true);
+    pthread_mutex_unlock(&_wlm_util_startup_mutex);
+
+    _wlm_util_startup_record("main", true, 0, 0);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_startup_trace_disable(void)
+{
+    pthread_mutex_lock(&_wlm_util_startup_mutex);
+    atomic_store(&_wlm_util_startup_enabled, false);
+    for (size_t i = 0; i < _wlm_util_startup_num_events; ++i) {
+        free(_wlm_util_startup_events_ptr[i].name_ptr);
+    }
+    free(_wlm_util_startup_events_ptr);
+    _wlm_util_startup_events_ptr = NULL;
+    _wlm_util_startup_num_events = 0;
+    _wlm_util_startup_max_events = 0;
+    pthread_mutex_unlock(&_wlm_util_startup_mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_startup_trace_write(const char *fname_ptr)
+{
+    if (!atomic_load(&_wlm_util_startup_enabled)) return false;
+
+    FILE *file_ptr = fopen(fname_ptr, "w");
+    if (NULL == file_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed fopen(%s, \"w\")", fname_ptr);
+        return false;
+    }
+
+    pthread_mutex_lock(&_wlm_util_startup_mutex);
+    // Parents before children: By start, then longest first.
+    qsort(_wlm_util_startup_events_ptr,
+          _wlm_util_startup_num_events,
+          sizeof(wlm_util_startup_event_t),
+          _wlm_util_startup_event_compare);
+    pid_t pid = getpid();
+    fprintf(file_ptr, "{\"traceEvents\":[\n");
+    for (size_t i = 0; i < _wlm_util_startup_num_events; ++i) {
+        wlm_util_startup_event_t *e_ptr = &_wlm_util_startup_events_ptr[i];
+        if (e_ptr->thread_name) {
+            fprintf(file_ptr, "{\"name\":\"thread_name\",\"ph\":\"M\","
+                    "\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                    pid, e_ptr->tid);
+            _wlm_util_startup_write_string(file_ptr, e_ptr->name_ptr);
+            fprintf(file_ptr, "}}");
+        } else {
+            fprintf(file_ptr, "{\"name\":");
+            _wlm_util_startup_write_string(file_ptr, e_ptr->name_ptr);
+            fprintf(file_ptr, ",\"cat\":\"startup\",\"ph\":\"X\","
+                    "\"ts\":%"PRIu64",\"dur\":%"PRIu64","
+                    "\"pid\":%d,\"tid\":%d}",
+                    e_ptr->ts_usec, e_ptr->dur_usec, pid, e_ptr->tid);
+        }
+        fprintf(file_ptr, "%s\n",
+                i + 1 < _wlm_util_startup_num_events ? "," : "");
+    }
+    fprintf(file_ptr, "],\n\"displayTimeUnit\":\"ms\"}\n");
+    pthread_mutex_unlock(&_wlm_util_startup_mutex);
+
+    bool rv = !ferror(file_ptr);
+    if (0 != fclose(file_ptr)) rv = false;
+    if (!rv) bs_log(BS_ERROR | BS_ERRNO, "Failed to write %s", fname_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+wlm_util_startup_phase_t wlm_util_startup_phase_begin(const char *name_ptr)
+{
+    wlm_util_startup_phase_t phase = { .name_ptr = name_ptr };
+    if (atomic_load(&_wlm_util_startup_enabled)) {
+        phase.start_usec = _wlm_util_startup_now_usec();
+    }
+    return phase;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_startup_phase_end(wlm_util_startup_phase_t *phase_ptr)
+{
+    if (0 == phase_ptr->start_usec) return;
+    uint64_t end_usec = _wlm_util_startup_now_usec();
+    _wlm_util_startup_record(
+        phase_ptr->name_ptr, false,
+        phase_ptr->start_usec, end_usec - phase_ptr->start_usec);
+    phase_ptr->start_usec = 0;
+}
+
+/* ------------------------------------------------------------------------- */
+wlm_util_startup_task_t *wlm_util_startup_task_start(
+    const char *name_ptr,
+    wlm_util_startup_task_fn_t fn,
+    void *arg_ptr)
+{
+    wlm_util_startup_task_t *task_ptr = logged_calloc(
+        1, sizeof(wlm_util_startup_task_t));
+    if (NULL == task_ptr) {
+        _wlm_util_startup_run(name_ptr, fn, arg_ptr);
+        return NULL;
+    }
+    task_ptr->name_ptr = name_ptr;
+    task_ptr->fn = fn;
+    task_ptr->arg_ptr = arg_ptr;
+
+    // Signals are for the event loop's thread. The worker inherits the mask.
+    sigset_t sigset, old_sigset;
+    sigfillset(&sigset);
+    pthread_sigmask(SIG_SETMASK, &sigset, &old_sigset);
+    int rv = pthread_create(
+        &task_ptr->thread, NULL, _wlm_util_startup_thread, task_ptr);
+    pthread_sigmask(SIG_SETMASK, &old_sigset, NULL);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_WARNING | BS_ERRNO, "Failed pthread_create() for %s. "
+               "Running it right away.", name_ptr);
+        free(task_ptr);
+        _wlm_util_startup_run(name_ptr, fn, arg_ptr);
+        return NULL;
+    }
+    return task_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_startup_task_join(wlm_util_startup_task_t *task_ptr)
+{
+    if (NULL == task_ptr) return;
+    pthread_join(task_ptr->thread, NULL);
+    free(task_ptr);
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Runs `fn` as phase `name_ptr`. */
+void _wlm_util_startup_run(
+    const char *name_ptr,
+    wlm_util_startup_task_fn_t fn,
+    void *arg_ptr)
+{
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin(name_ptr);
+    fn(arg_ptr);
+    wlm_util_startup_phase_end(&phase);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Thread of a @ref wlm_util_startup_task_t. Names the thread, and runs. */
+void *_wlm_util_startup_thread(void *arg_ptr)
+{
+    wlm_util_startup_task_t *task_ptr = arg_ptr;
+    if (atomic_load(&_wlm_util_startup_enabled)) {
+        _wlm_util_startup_record(task_ptr->name_ptr, true, 0, 0);
+    }
+    _wlm_util_startup_run(task_ptr->name_ptr, task_ptr->fn, task_ptr->arg_ptr);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Records an event of the calling thread, if enabled. */
+void _wlm_util_startup_record(
+    const char *name_ptr,
+    bool thread_name,
+    uint64_t start_usec,
+    uint64_t dur_usec)
+{
+    char *n_ptr = logged_strdup(name_ptr);
+    if (NULL == n_ptr) return;
+
+    pthread_mutex_lock(&_wlm_util_startup_mutex);
+    if (!atomic_load(&_wlm_util_startup_enabled) ||
+        (!thread_name && start_usec < _wlm_util_startup_origin_usec)) {
+        goto drop;
+    }
+    if (_wlm_util_startup_num_events >= _wlm_util_startup_max_events) {
+        size_t max_events = BS_MAX(64, 2 * _wlm_util_startup_max_events);
+        wlm_util_startup_event_t *events_ptr = realloc(
+            _wlm_util_startup_events_ptr,
+            max_events * sizeof(wlm_util_startup_event_t));
+        if (NULL == events_ptr) {
+            bs_log(BS_ERROR | BS_ERRNO, "Failed realloc(%p, %zu)",
+                   _wlm_util_startup_events_ptr,
+                   max_events * sizeof(wlm_util_startup_event_t));
+            goto drop;
+        }
+        _wlm_util_startup_events_ptr = events_ptr;
+        _wlm_util_startup_max_events = max_events;
+    }
+    _wlm_util_startup_events_ptr[_wlm_util_startup_num_events++] =
+        (wlm_util_startup_event_t){
+        .name_ptr = n_ptr,
+        .tid = gettid(),
+        .thread_name = thread_name,
+        .ts_usec = thread_name ? 0 : start_usec - _wlm_util_startup_origin_usec,
+        .dur_usec = dur_usec,
+    };
+    pthread_mutex_unlock(&_wlm_util_startup_mutex);
+    return;
+
+drop:
+    pthread_mutex_unlock(&_wlm_util_startup_mutex);
+    free(n_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Orders events by start, then longest first. Thread names go first. */
+int _wlm_util_startup_event_compare(
+    const void *a_ptr,
+    const void *b_ptr)
+{
+    const wlm_util_startup_event_t *a = a_ptr, *b = b_ptr;
+    if (a->thread_name != b->thread_name) return a->thread_name ? -1 : 1;
+    if (a->ts_usec != b->ts_usec) return a->ts_usec < b->ts_usec ? -1 : 1;
+    if (a->dur_usec != b->dur_usec) return a->dur_usec > b->dur_usec ? -1 : 1;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Writes `s_ptr` as a JSON string, with quotes and escapes. */
+void _wlm_util_startup_write_string(FILE *file_ptr, const char *s_ptr)
+{
+    fputc('"', file_ptr);
+    for (; *s_ptr; ++s_ptr) {
+        unsigned char c = *s_ptr;
+        if ('"' == c || '\\' == c) {
+            fprintf(file_ptr, "\\%c", c);
+        } else if (0x20 > c) {
+            fprintf(file_ptr, "\\u%04x", c);
+        } else {
+            fputc(c, file_ptr);
+        }
+    }
+    fputc('"', file_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns CLOCK_MONOTONIC, in microseconds. */
+uint64_t _wlm_util_startup_now_usec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_startup_test_disabled(bs_test_t *test_ptr);
+static void _wlm_util_startup_test_trace(bs_test_t *test_ptr);
+
+static const bs_test_case_t _wlm_util_startup_test_cases[] = {
+    { 1, "disabled", _wlm_util_startup_test_disabled },
+    { 1, "trace", _wlm_util_startup_test_trace },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_startup_test_set = BS_TEST_SET(
+    true, "startup", _wlm_util_startup_test_cases);
+
+/** A phase, as parsed from the trace. */
+typedef struct {
+    /** Name. */
+    char                      name[32];
+    /** Start. */
+    uint64_t                  ts;
+    /** Duration. */
+    uint64_t                  dur;
+    /** Thread. */
+    int                       tid;
+} _wlm_util_startup_test_event_t;
+
+/* ------------------------------------------------------------------------- */
+/** Test task: Runs a nested phase that takes 50ms. */
+static void _wlm_util_startup_test_task(void *arg_ptr)
+{
+    atomic_int *runs_ptr = arg_ptr;
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin("inner");
+    usleep(50000);
+    wlm_util_startup_phase_end(&phase);
+    atomic_fetch_add(runs_ptr, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Skips whitespace. */
+static const char *_wlm_util_startup_test_ws(const char *p)
+{
+    while (isspace((unsigned char)*p)) ++p;
+    return p;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Parses one JSON value, as per RFC 8259.
+ *
+ * @return Pointer to after the value, or NULL if not well-formed.
+ */
+static const char *_wlm_util_startup_test_json(const char *p)
+{
+    p = _wlm_util_startup_test_ws(p);
+    if ('{' == *p || '[' == *p) {
+        char close = '{' == *p ? '}' : ']';
+        p = _wlm_util_startup_test_ws(p + 1);
+        if (close == *p) return p + 1;
+        for (;;) {
+            if ('}' == close) {
+                p = _wlm_util_startup_test_ws(p);
+                if ('"' != *p) return NULL;
+                p = _wlm_util_startup_test_json(p);
+                if (NULL == p) return NULL;
+                p = _wlm_util_startup_test_ws(p);
+                if (':' != *p++) return NULL;
+            }
+            p = _wlm_util_startup_test_json(p);
+            if (NULL == p) return NULL;
+            p = _wlm_util_startup_test_ws(p);
+            if (close == *p) return p + 1;
+            if (',' != *p++) return NULL;
+        }
+    }
+    if ('"' == *p) {
+        for (++p; '"' != *p; ++p) {
+            if ((unsigned char)*p < 0x20) return NULL;
+            if ('\\' != *p) continue;
+            ++p;
+            if ('u' == *p) {
+                for (int i = 0; i < 4; ++i) {
+                    if (!isxdigit((unsigned char)*++p)) return NULL;
+                }
+            } else if (NULL == strchr("\"\\/bfnrt", *p) || '\0' == *p) {
+                return NULL;
+            }
+        }
+        return p + 1;
+    }
+    if ('-' == *p || isdigit((unsigned char)*p)) {
+        char *end_ptr;
+        strtod(p, &end_ptr);
+        return end_ptr;
+    }
+    for (const char **l = (const char *[]){ "true", "false", "null", NULL };
+         *l; ++l) {
+        if (0 == strncmp(p, *l, strlen(*l))) return p + strlen(*l);
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Finds the event `name` on thread `tid`, or on any thread if `tid` is 0. */
+static const _wlm_util_startup_test_event_t *_wlm_util_startup_test_find(
+    const _wlm_util_startup_test_event_t *events,
+    size_t n,
+    const char *name,
+    int tid)
+{
+    for (size_t i = 0; i < n; ++i) {
+        if (0 != strcmp(events[i].name, name)) continue;
+        if (0 != tid && events[i].tid != tid) continue;
+        return &events[i];
+    }
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Whether `inner` runs within `outer`. */
+static bool _wlm_util_startup_test_contains(
+    const _wlm_util_startup_test_event_t *outer,
+    const _wlm_util_startup_test_event_t *inner)
+{
+    return (outer->ts <= inner->ts &&
+            inner->ts + inner->dur <= outer->ts + outer->dur);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Phases are not recorded, and no trace written, unless enabled. */
+void _wlm_util_startup_test_disabled(bs_test_t *test_ptr)
+{
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin("a");
+    BS_TEST_VERIFY_EQ(test_ptr, 0, phase.start_usec);
+    wlm_util_startup_phase_end(&phase);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlm_util_startup_num_events);
+    BS_TEST_VERIFY_FALSE(test_ptr, wlm_util_startup_trace_write("/dev/null"));
+
+    // Tasks still run.
+    atomic_int runs = 0;
+    wlm_util_startup_task_join(wlm_util_startup_task_start(
+        "task", _wlm_util_startup_test_task, &runs));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, atomic_load(&runs));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, _wlm_util_startup_num_events);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Traces two concurrent tasks within a phase, and verifies the trace is
+ * well-formed JSON, with the phases properly nested on their threads.
+ */
+void _wlm_util_startup_test_trace(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlm_util_startup_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/trace.json", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_startup_trace_enable());
+    atomic_int runs = 0;
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin("outer");
+    wlm_util_startup_task_t *t1_ptr = wlm_util_startup_task_start(
+        "task1", _wlm_util_startup_test_task, &runs);
+    wlm_util_startup_task_t *t2_ptr = wlm_util_startup_task_start(
+        "task2", _wlm_util_startup_test_task, &runs);
+    wlm_util_startup_phase_t quoted = wlm_util_startup_phase_begin("a\"b\\");
+    wlm_util_startup_phase_end(&quoted);
+    wlm_util_startup_task_join(t1_ptr);
+    wlm_util_startup_task_join(t2_ptr);
+    wlm_util_startup_phase_end(&phase);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, atomic_load(&runs));
+    BS_TEST_VERIFY_TRUE(test_ptr, wlm_util_startup_trace_write(fname_ptr));
+    wlm_util_startup_trace_disable();
+
+    char buf[4096];
+    FILE *file_ptr = fopen(fname_ptr, "r");
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, file_ptr);
+    size_t len = fread(buf, 1, sizeof(buf) - 1, file_ptr);
+    fclose(file_ptr);
+    unlink(fname_ptr);
+    rmdir(dir);
+    free(fname_ptr);
+    buf[len] = '\0';
+
+    const char *end_ptr = _wlm_util_startup_test_json(buf);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, end_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, '\0', *_wlm_util_startup_test_ws(end_ptr));
+
+    // The quoted phase is escaped; the JSON check above verified that.
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, strstr(buf, "\"a\\\"b\\\\\""));
+
+    // One event per line. Collects the phases, and the named threads.
+    _wlm_util_startup_test_event_t events[16];
+    size_t n = 0, names = 0;
+    for (char *l = strtok(buf, "\n"); NULL != l; l = strtok(NULL, "\n")) {
+        _wlm_util_startup_test_event_t *e = &events[n];
+        if (n < 16 && 4 == sscanf(
+                l, "{\"name\":\"%31[^\"]\",\"cat\":\"startup\",\"ph\":\"X\","
+                "\"ts\":%"SCNu64",\"dur\":%"SCNu64",\"pid\":%*d,\"tid\":%d}",
+                e->name, &e->ts, &e->dur, &e->tid)) ++n;
+        if (NULL != strstr(l, "\"ph\":\"M\"")) ++names;
+    }
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 5, n);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, names);
+
+    const _wlm_util_startup_test_event_t *o, *t1, *t2, *i1, *i2;
+    o = _wlm_util_startup_test_find(events, n, "outer", 0);
+    t1 = _wlm_util_startup_test_find(events, n, "task1", 0);
+    t2 = _wlm_util_startup_test_find(events, n, "task2", 0);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, o);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t2);
+    i1 = _wlm_util_startup_test_find(events, n, "inner", t1->tid);
+    i2 = _wlm_util_startup_test_find(events, n, "inner", t2->tid);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, i2);
+
+    // Tasks run on their own threads, nested within the outer phase, and
+    // concurrently.
+    BS_TEST_VERIFY_NEQ(test_ptr, o->tid, t1->tid);
+    BS_TEST_VERIFY_NEQ(test_ptr, o->tid, t2->tid);
+    BS_TEST_VERIFY_NEQ(test_ptr, t1->tid, t2->tid);
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_startup_test_contains(o, t1));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_startup_test_contains(o, t2));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_startup_test_contains(t1, i1));
+    BS_TEST_VERIFY_TRUE(test_ptr, _wlm_util_startup_test_contains(t2, i2));
+    BS_TEST_VERIFY_TRUE(test_ptr, 50000 <= i1->dur);
+    BS_TEST_VERIFY_TRUE(test_ptr, t1->ts < t2->ts + t2->dur);
+    BS_TEST_VERIFY_TRUE(test_ptr, t2->ts < t1->ts + t1->dur);
+}
+
+/* == End of startup.c ===================================================== */
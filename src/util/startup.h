@@ -0,0 +1,117 @@
+/* ========================================================================= */
+/**
+ * @file startup.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_STARTUP_H__
+#define __WLMAKER_UTIL_STARTUP_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+/**
+ * A timed phase of the startup. Phases nest, per thread, and are recorded
+ * into the trace once they end.
+ */
+typedef struct {
+    /** Name of the phase. Must remain valid until the phase ends. */
+    const char                *name_ptr;
+    /** Start of the phase, CLOCK_MONOTONIC in microseconds. 0 if unused. */
+    uint64_t                  start_usec;
+} wlm_util_startup_phase_t;
+
+/** A startup task: Runs a phase of the startup on a worker thread. */
+typedef struct _wlm_util_startup_task_t wlm_util_startup_task_t;
+
+/** Function run by a @ref wlm_util_startup_task_t. */
+typedef void (*wlm_util_startup_task_fn_t)(void *arg_ptr);
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Enables recording of startup phases, from all threads.
+ *
+ * @return true on success.
+ */
+bool wlm_util_startup_trace_enable(void);
+
+/** Disables recording, and drops all recorded phases. */
+void wlm_util_startup_trace_disable(void);
+
+/**
+ * Writes the recorded phases as Chrome trace JSON, viewable in Perfetto or
+ * chrome://tracing. Each phase is a complete ("X") event, on the thread it
+ * ran on. Worker threads are named after their task.
+ *
+ * @param fname_ptr
+ *
+ * @return true on success. false if recording is not enabled, or on error.
+ */
+bool wlm_util_startup_trace_write(const char *fname_ptr);
+
+/**
+ * Begins a phase. Cheap when recording is not enabled.
+ *
+ * @param name_ptr            Must remain valid until the phase ends.
+ *
+ * @return The phase, to pass to @ref wlm_util_startup_phase_end.
+ */
+wlm_util_startup_phase_t wlm_util_startup_phase_begin(const char *name_ptr);
+
+/**
+ * Ends the phase, and records it, if recording is enabled.
+ *
+ * @param phase_ptr
+ */
+void wlm_util_startup_phase_end(wlm_util_startup_phase_t *phase_ptr);
+
+/**
+ * Starts a task: Runs `fn` on a new thread, as phase `name_ptr`. The thread
+ * has all signals blocked. If the thread cannot be created, `fn` runs right
+ * away, on the calling thread.
+ *
+ * @param name_ptr            Must remain valid until the task is joined.
+ * @param fn
+ * @param arg_ptr
+ *
+ * @return The task, to be joined by @ref wlm_util_startup_task_join. NULL,
+ *     if `fn` had to run right away.
+ */
+wlm_util_startup_task_t *wlm_util_startup_task_start(
+    const char *name_ptr,
+    wlm_util_startup_task_fn_t fn,
+    void *arg_ptr);
+
+/**
+ * Waits for the task to complete, and destroys it.
+ *
+ * @param task_ptr            May be NULL.
+ */
+void wlm_util_startup_task_join(wlm_util_startup_task_t *task_ptr);
+
+/** Unit test set for the startup phases and tasks. */
+extern const bs_test_set_t wlm_util_startup_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_STARTUP_H__ */
+/* == End of startup.h ===================================================== */
@@ -22,12 +22,17 @@
 #include "subprocess_monitor.h"
 
 #include <inttypes.h>
+#include <limits.h>
 #include <libbase/libbase.h>
 #include <signal.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
 #include <wayland-server-core.h>
 
+#include "spawn.h"
+
 struct wl_event_source;
 
 /* == Declarations ========================================================= */
@@ -47,8 +52,16 @@ struct _wlm_util_subprocess_monitor_t {
 struct wlm_util_subprocess {
     /** Element of @ref wlm_util_subprocess_monitor_t `subprocesses`. */
     bs_dllist_node_t          dlnode;
-    /** Points to the libbase subprocess. */
+    /** Points to the libbase subprocess. NULL, if spawned. */
     bs_subprocess_t           *subprocess_ptr;
+    /** Process ID of the subprocess. */
+    pid_t                     pid;
+    /** Whether a spawned subprocess was reaped. */
+    bool                      reaped;
+    /** Exit status of a reaped subprocess, or INT_MIN if signalled. */
+    int                       exit_status;
+    /** Signal that terminated a reaped subprocess, or 0. */
+    int                       signal_number;
 
     /** File descriptor of the subprocess' stdout. */
     int                       stdout_read_fd;
@@ -71,7 +84,14 @@ struct wlm_util_subprocess {
 
 static struct wlm_util_subprocess *wlm_util_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
     struct wl_event_loop *wl_event_loop_ptr);
+static bool _wlm_util_subprocess_terminated(
+    struct wlm_util_subprocess *subprocess_handle_ptr,
+    int *exit_status_ptr,
+    int *signal_number_ptr);
 static void wlm_util_subprocess_handle_destroy(
     struct wlm_util_subprocess *sp_handle_ptr);
 static int _wlm_util_subprocess_monitor_handle_read_stdout(
@@ -134,9 +154,19 @@ struct wlm_util_subprocess *wlm_util_subprocess_monitor_entrust(
     void *userdata_ptr,
     bs_dynbuf_t *stdout_dynbuf_ptr)
 {
+    int stdout_read_fd, stderr_read_fd;
+    bs_subprocess_get_fds(
+        subprocess_ptr,
+        NULL,  // no interest in stdin.
+        &stdout_read_fd,
+        &stderr_read_fd);
     struct wlm_util_subprocess *subprocess_handle_ptr =
         wlm_util_subprocess_handle_create(
-            subprocess_ptr, monitor_ptr->wl_event_loop_ptr);
+            subprocess_ptr,
+            bs_subprocess_pid(subprocess_ptr),
+            stdout_read_fd,
+            stderr_read_fd,
+            monitor_ptr->wl_event_loop_ptr);
     if (NULL == subprocess_handle_ptr) return NULL;
     bs_dllist_push_back(&monitor_ptr->subprocesses,
                         &subprocess_handle_ptr->dlnode);
@@ -181,19 +211,81 @@ error:
     return NULL;
 }
 
+/* ------------------------------------------------------------------------- */
+struct wlm_util_subprocess *wlm_util_subprocess_monitor_spawn(
+    wlm_util_subprocess_monitor_t *monitor_ptr,
+    const char *cmdline_ptr,
+    wlm_util_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    bs_dynbuf_t *stdout_dynbuf_ptr)
+{
+    int stdout_read_fd, stderr_read_fd;
+    pid_t pid = wlm_util_spawn(cmdline_ptr, &stdout_read_fd, &stderr_read_fd);
+    if (0 > pid) return NULL;
+    bs_log(BS_DEBUG, "Spawned subprocess %"PRIdMAX" for \"%s\"",
+           (intmax_t)pid, cmdline_ptr);
+
+    struct wlm_util_subprocess *subprocess_handle_ptr =
+        wlm_util_subprocess_handle_create(
+            NULL,
+            pid,
+            stdout_read_fd,
+            stderr_read_fd,
+            monitor_ptr->wl_event_loop_ptr);
+    if (NULL == subprocess_handle_ptr) {
+        // Cannot monitor it: Leave it running, and let init reap it.
+        close(stdout_read_fd);
+        close(stderr_read_fd);
+        return NULL;
+    }
+    bs_dllist_push_back(&monitor_ptr->subprocesses,
+                        &subprocess_handle_ptr->dlnode);
+
+    subprocess_handle_ptr->terminated_callback = terminated_callback;
+    subprocess_handle_ptr->userdata_ptr = userdata_ptr;
+    subprocess_handle_ptr->stdout_dynbuf_ptr = stdout_dynbuf_ptr;
+    return subprocess_handle_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlm_util_subprocess_monitor_run_cmdline(
+    wlm_util_subprocess_monitor_t *monitor_ptr,
+    const char *cmdline_ptr)
+{
+    struct wlm_util_subprocess *subprocess_handle_ptr =
+        wlm_util_subprocess_monitor_spawn(
+            monitor_ptr, cmdline_ptr, NULL, NULL, NULL);
+    if (NULL == subprocess_handle_ptr) return false;
+    wlm_util_subprocess_monitor_cede(monitor_ptr, subprocess_handle_ptr);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+pid_t wlm_util_subprocess_pid(
+    struct wlm_util_subprocess *subprocess_handle_ptr)
+{
+    return subprocess_handle_ptr->pid;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
 /**
- * Creates a @ref wlm_util_subprocess and connects to subprocess_ptr.
+ * Creates a @ref wlm_util_subprocess and connects to the subprocess' output.
  *
- * @param subprocess_ptr
+ * @param subprocess_ptr      The libbase subprocess, or NULL if spawned.
+ * @param pid
+ * @param stdout_read_fd
+ * @param stderr_read_fd
  * @param wl_event_loop_ptr
  *
  * @return The subprocess handle or NULL on error.
  */
 struct wlm_util_subprocess *wlm_util_subprocess_handle_create(
     bs_subprocess_t *subprocess_ptr,
+    pid_t pid,
+    int stdout_read_fd,
+    int stderr_read_fd,
     struct wl_event_loop *wl_event_loop_ptr)
 {
     struct wlm_util_subprocess *subprocess_handle_ptr = logged_calloc(
@@ -201,12 +293,9 @@ struct wlm_util_subprocess *wlm_util_subprocess_handle_create(
     if (NULL == subprocess_handle_ptr) return NULL;
 
     subprocess_handle_ptr->subprocess_ptr = subprocess_ptr;
-
-    bs_subprocess_get_fds(
-        subprocess_ptr,
-        NULL,  // no interest in stdin.
-        &subprocess_handle_ptr->stdout_read_fd,
-        &subprocess_handle_ptr->stderr_read_fd);
+    subprocess_handle_ptr->pid = pid;
+    subprocess_handle_ptr->stdout_read_fd = stdout_read_fd;
+    subprocess_handle_ptr->stderr_read_fd = stderr_read_fd;
 
     subprocess_handle_ptr->stdout_wl_event_source_ptr = wl_event_loop_add_fd(
         wl_event_loop_ptr,
@@ -235,15 +324,14 @@ void wlm_util_subprocess_handle_destroy(
 {
     BS_ASSERT(NULL == sp_handle_ptr->dlnode.prev_ptr);
     int exit_status, signal_number;
-    if (!bs_subprocess_terminated(
-            sp_handle_ptr->subprocess_ptr, &exit_status, &signal_number)) {
+    if (!_wlm_util_subprocess_terminated(
+            sp_handle_ptr, &exit_status, &signal_number)) {
         bs_log(BS_FATAL, "Destroying subprocess handle, but still running: "
                "subprocess %p (pid: %"PRIdMAX")",
-               sp_handle_ptr->subprocess_ptr,
-               (intmax_t)bs_subprocess_pid(sp_handle_ptr->subprocess_ptr));
+               sp_handle_ptr, (intmax_t)sp_handle_ptr->pid);
     }
     bs_log(BS_DEBUG, "Terminated subprocess %p. Status %d, signal %d.",
-           sp_handle_ptr->subprocess_ptr, exit_status, signal_number);
+           sp_handle_ptr, exit_status, signal_number);
 
     if (NULL != sp_handle_ptr->terminated_callback) {
         // Attempt to drain stdout & stderr before closing the pipes.
@@ -264,11 +352,6 @@ void wlm_util_subprocess_handle_destroy(
         sp_handle_ptr->terminated_callback = NULL;
     }
 
-    if (NULL != sp_handle_ptr->subprocess_ptr) {
-        bs_subprocess_destroy(sp_handle_ptr->subprocess_ptr);
-        sp_handle_ptr->subprocess_ptr = NULL;
-    }
-
     if (NULL != sp_handle_ptr->stdout_wl_event_source_ptr) {
         wl_event_source_remove(sp_handle_ptr->stdout_wl_event_source_ptr);
         sp_handle_ptr->stdout_wl_event_source_ptr = NULL;
@@ -278,6 +361,21 @@ void wlm_util_subprocess_handle_destroy(
         sp_handle_ptr->stderr_wl_event_source_ptr = NULL;
     }
 
+    if (NULL != sp_handle_ptr->subprocess_ptr) {
+        bs_subprocess_destroy(sp_handle_ptr->subprocess_ptr);
+        sp_handle_ptr->subprocess_ptr = NULL;
+    } else {
+        // Spawned: The pipes are ours.
+        if (0 <= sp_handle_ptr->stdout_read_fd) {
+            close(sp_handle_ptr->stdout_read_fd);
+        }
+        if (0 <= sp_handle_ptr->stderr_read_fd) {
+            close(sp_handle_ptr->stderr_read_fd);
+        }
+    }
+    sp_handle_ptr->stdout_read_fd = -1;
+    sp_handle_ptr->stderr_read_fd = -1;
+
     free(sp_handle_ptr);
 }
 
@@ -327,8 +425,7 @@ int _wlm_util_subprocess_monitor_handle_read_stdout(
         if (0 < len) {
             bs_log_write(
                 BS_DEBUG, "subprocess.stdout",
-                (intmax_t)bs_subprocess_pid(
-                    subprocess_handle_ptr->subprocess_ptr),
+                (intmax_t)subprocess_handle_ptr->pid,
                 "%s", buf);
         }
     }
@@ -374,8 +471,7 @@ int _wlm_util_subprocess_monitor_handle_read_stderr(
         if (0 < len) {
             bs_log_write(
                 BS_INFO, "subprocess.stderr",
-                (intmax_t)bs_subprocess_pid(
-                    subprocess_handle_ptr->subprocess_ptr),
+                (intmax_t)subprocess_handle_ptr->pid,
                 "%s", buf);
         }
     }
@@ -404,7 +500,7 @@ int _wlm_util_subprocess_monitor_process_fd(
     bs_dynbuf_t *dynbuf_ptr)
 {
     // Convenience copy.
-    intmax_t pid = bs_subprocess_pid(subprocess_handle_ptr->subprocess_ptr);
+    intmax_t pid = subprocess_handle_ptr->pid;
 
     if (mask & WL_EVENT_READABLE) {
         bs_dynbuf_read(dynbuf_ptr, fd);
@@ -445,8 +541,8 @@ int _wlm_util_subprocess_monitor_handle_sigchld(
         dlnode_ptr = dlnode_ptr->next_ptr;
 
         int exit_status, signal_number;
-        if (bs_subprocess_terminated(subprocess_handle_ptr->subprocess_ptr,
-                                     &exit_status, &signal_number)) {
+        if (_wlm_util_subprocess_terminated(subprocess_handle_ptr,
+                                            &exit_status, &signal_number)) {
             bs_dllist_remove(
                 &monitor_ptr->subprocesses,
                 &subprocess_handle_ptr->dlnode);
@@ -457,4 +553,47 @@ int _wlm_util_subprocess_monitor_handle_sigchld(
     return 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Returns whether the subprocess terminated, and how. Spawned subprocesses
+ * are reaped here, and the result is kept for subsequent calls.
+ *
+ * @param subprocess_handle_ptr
+ * @param exit_status_ptr     Exit status, or INT_MIN if signalled.
+ * @param signal_number_ptr   Signal number, or 0 if exited.
+ *
+ * @return true if terminated.
+ */
+bool _wlm_util_subprocess_terminated(
+    struct wlm_util_subprocess *subprocess_handle_ptr,
+    int *exit_status_ptr,
+    int *signal_number_ptr)
+{
+    if (NULL != subprocess_handle_ptr->subprocess_ptr) {
+        return bs_subprocess_terminated(
+            subprocess_handle_ptr->subprocess_ptr,
+            exit_status_ptr,
+            signal_number_ptr);
+    }
+
+    if (!subprocess_handle_ptr->reaped) {
+        int status;
+        pid_t pid = waitpid(subprocess_handle_ptr->pid, &status, WNOHANG);
+        if (0 == pid) return false;
+        if (0 > pid) {
+            bs_log(BS_WARNING | BS_ERRNO, "Failed waitpid(%"PRIdMAX", %p, "
+                   "WNOHANG)", (intmax_t)subprocess_handle_ptr->pid, &status);
+            status = 0;
+        }
+        subprocess_handle_ptr->reaped = true;
+        subprocess_handle_ptr->exit_status =
+            WIFSIGNALED(status) ? INT_MIN : WEXITSTATUS(status);
+        subprocess_handle_ptr->signal_number =
+            WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+    }
+    *exit_status_ptr = subprocess_handle_ptr->exit_status;
+    *signal_number_ptr = subprocess_handle_ptr->signal_number;
+    return true;
+}
+
 /* == End of subprocess_monitor.c ========================================== */
@@ -23,6 +23,7 @@
 
 #include <libbase/libbase.h>
 #include <stdbool.h>
+#include <sys/types.h>
 
 /** Forward definition for the subprocess monitor. */
 typedef struct _wlm_util_subprocess_monitor_t wlm_util_subprocess_monitor_t;
@@ -119,6 +120,51 @@ bool wlm_util_subprocess_monitor_run(
     wlm_util_subprocess_monitor_t *monitor_ptr,
     bs_subprocess_t *subprocess_ptr);
 
+/**
+ * Spawns `cmdline_ptr` and passes it to `monitor_ptr`.
+ *
+ * Like @ref wlm_util_subprocess_monitor_entrust, but launches through
+ * `wlm_util_spawn`: Without forking the compositor, and without a shell
+ * unless `cmdline_ptr` needs one.
+ *
+ * @param monitor_ptr
+ * @param cmdline_ptr
+ * @param terminated_callback
+ * @param userdata_ptr
+ * @param stdout_dynbuf_ptr
+ *
+ * @return A pointer to the created subprocess handle or NULL on error.
+ */
+struct wlm_util_subprocess *wlm_util_subprocess_monitor_spawn(
+    wlm_util_subprocess_monitor_t *monitor_ptr,
+    const char *cmdline_ptr,
+    wlm_util_subprocess_terminated_callback_t terminated_callback,
+    void *userdata_ptr,
+    bs_dynbuf_t *stdout_dynbuf_ptr);
+
+/**
+ * Spawns and cedes a subprocess to the monitor.
+ *
+ * A convenience wrapper for @ref wlm_util_subprocess_monitor_spawn and
+ * @ref wlm_util_subprocess_monitor_cede.
+ *
+ * @param monitor_ptr
+ * @param cmdline_ptr
+ *
+ * @return true on success.
+ */
+bool wlm_util_subprocess_monitor_run_cmdline(
+    wlm_util_subprocess_monitor_t *monitor_ptr,
+    const char *cmdline_ptr);
+
+/**
+ * @param subprocess_handle_ptr
+ *
+ * @return Process ID of the subprocess.
+ */
+pid_t wlm_util_subprocess_pid(
+    struct wlm_util_subprocess *subprocess_handle_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,697 @@
+/* ========================================================================= */
+/**
+ * @file watchdog.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/** For `REG_RIP` and `REG_RBP` from ucontext.h, and pthread_sigqueue(3). */
+#define _GNU_SOURCE
+
+#include "watchdog.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <wayland-server-core.h>
+
+#include "backtrace.h"
+
+/* == Declarations ========================================================= */
+
+/** Maximum number of frames captured for a stalled dispatch. */
+#define _WLM_UTIL_WATCHDOG_MAX_PCS 64
+
+/** State of the watchdog. */
+struct _wlm_util_watchdog_t {
+    /** Dispatches running longer count as stalled. */
+    uint64_t                  threshold_usec;
+    /** The event loop's thread. Its stack gets captured. */
+    pthread_t                 loop_thread;
+    /** Histogram. Belongs to the event loop's thread. */
+    wlm_util_watchdog_histogram_t histogram;
+
+    /** Start of the current dispatch, or 0 if not dispatching. */
+    atomic_uint_fast64_t      start_usec;
+    /**
+     * Start of the dispatch whose stall is not logged yet. Whoever clears it
+     * logs: @ref wlm_util_watchdog_leave, or the watchdog thread's report.
+     */
+    atomic_uint_fast64_t      unlogged_start_usec;
+    /** Whether the watchdog thread waits for a dispatch to begin. */
+    atomic_bool               waiting;
+
+    /** The watchdog thread. */
+    pthread_t                 thread;
+    /** Whether @ref thread was started. */
+    bool                      thread_started;
+    /** Guards @ref stop, and the condition. */
+    pthread_mutex_t           mutex;
+    /** Signals the watchdog thread. Uses CLOCK_MONOTONIC. */
+    pthread_cond_t            cond;
+    /** Tells the watchdog thread to exit. */
+    bool                      stop;
+    /** Start of the dispatch reported last. Belongs to the watchdog thread. */
+    uint64_t                  reported_start_usec;
+
+    /** Frames are walked below this address of the event loop's stack. */
+    uintptr_t                 stack_top;
+    /** Posted by the signal handler, once the stack is captured. */
+    sem_t                     captured_sem;
+    /** Generation of the last capture. Belongs to the watchdog thread. */
+    unsigned                  capture_generation;
+    /**
+     * Generation of the requested capture, or 0. The signal handler claims it
+     * before writing @ref pcs. The watchdog thread revokes it on timeout, so
+     * that a late signal does not overwrite @ref pcs while they are logged.
+     */
+    atomic_uint               pending_generation;
+    /** Frames captured by the signal handler. */
+    uintptr_t                 pcs[_WLM_UTIL_WATCHDOG_MAX_PCS];
+    /** Number of frames in @ref pcs. */
+    size_t                    num_pcs;
+    /** Number of stalls reported by the watchdog thread. */
+    atomic_uint_fast64_t      reports;
+    /** Number of frames in the last report. For tests. */
+    atomic_size_t             reported_pcs;
+};
+
+static void *_wlm_util_watchdog_thread(void *arg_ptr);
+static void _wlm_util_watchdog_report(
+    wlm_util_watchdog_t *watchdog_ptr,
+    uint64_t start_usec);
+static void _wlm_util_watchdog_handle_signal(
+    int signum,
+    siginfo_t *siginfo_ptr,
+    void *context_ptr);
+static size_t _wlm_util_watchdog_walk(
+    const ucontext_t *ucontext_ptr,
+    uintptr_t stack_top,
+    uintptr_t *pcs_ptr,
+    size_t max_pcs);
+static uint64_t _wlm_util_watchdog_now_usec(void);
+static struct timespec _wlm_util_watchdog_timespec(uint64_t usec);
+
+/* == Data ================================================================= */
+
+/** The instance, for the signal handler. */
+static _Atomic(wlm_util_watchdog_t *) _wlm_util_watchdog_ptr;
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlm_util_watchdog_t *wlm_util_watchdog_create(uint64_t threshold_usec)
+{
+    if (NULL != atomic_load(&_wlm_util_watchdog_ptr)) {
+        bs_log(BS_ERROR, "A watchdog exists already.");
+        return NULL;
+    }
+
+    wlm_util_watchdog_t *watchdog_ptr = logged_calloc(
+        1, sizeof(wlm_util_watchdog_t));
+    if (NULL == watchdog_ptr) return NULL;
+    watchdog_ptr->threshold_usec = BS_MAX(threshold_usec, 1u);
+    watchdog_ptr->loop_thread = pthread_self();
+    watchdog_ptr->stack_top = (uintptr_t)__builtin_frame_address(0);
+    pthread_mutex_init(&watchdog_ptr->mutex, NULL);
+    pthread_condattr_t condattr;
+    pthread_condattr_init(&condattr);
+    pthread_condattr_setclock(&condattr, CLOCK_MONOTONIC);
+    pthread_cond_init(&watchdog_ptr->cond, &condattr);
+    pthread_condattr_destroy(&condattr);
+    sem_init(&watchdog_ptr->captured_sem, 0, 0);
+
+    struct sigaction sigact = {
+        .sa_sigaction = _wlm_util_watchdog_handle_signal,
+        .sa_flags = SA_RESTART | SA_SIGINFO };
+    sigemptyset(&sigact.sa_mask);
+    if (0 != sigaction(SIGRTMIN, &sigact, NULL)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed sigaction(SIGRTMIN, %p, NULL)",
+               &sigact);
+        wlm_util_watchdog_destroy(watchdog_ptr);
+        return NULL;
+    }
+    atomic_store(&_wlm_util_watchdog_ptr, watchdog_ptr);
+
+    int rv = pthread_create(
+        &watchdog_ptr->thread, NULL, _wlm_util_watchdog_thread, watchdog_ptr);
+    if (0 != rv) {
+        errno = rv;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed pthread_create(%p, NULL, %p, %p)",
+               &watchdog_ptr->thread, _wlm_util_watchdog_thread,
+               watchdog_ptr);
+        wlm_util_watchdog_destroy(watchdog_ptr);
+        return NULL;
+    }
+    watchdog_ptr->thread_started = true;
+
+    return watchdog_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_watchdog_destroy(wlm_util_watchdog_t *watchdog_ptr)
+{
+    if (watchdog_ptr->thread_started) {
+        pthread_mutex_lock(&watchdog_ptr->mutex);
+        watchdog_ptr->stop = true;
+        pthread_cond_signal(&watchdog_ptr->cond);
+        pthread_mutex_unlock(&watchdog_ptr->mutex);
+        pthread_join(watchdog_ptr->thread, NULL);
+        watchdog_ptr->thread_started = false;
+    }
+
+    wlm_util_watchdog_t *expected_ptr = watchdog_ptr;
+    if (atomic_compare_exchange_strong(
+            &_wlm_util_watchdog_ptr, &expected_ptr, NULL)) {
+        signal(SIGRTMIN, SIG_DFL);
+    }
+
+    sem_destroy(&watchdog_ptr->captured_sem);
+    pthread_cond_destroy(&watchdog_ptr->cond);
+    pthread_mutex_destroy(&watchdog_ptr->mutex);
+    free(watchdog_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+int wlm_util_watchdog_dispatch(
+    wlm_util_watchdog_t *watchdog_ptr,
+    struct wl_event_loop *wl_event_loop_ptr,
+    int timeout_msec)
+{
+    struct pollfd pollfd = {
+        .fd = wl_event_loop_get_fd(wl_event_loop_ptr),
+        .events = POLLIN };
+    int rv = poll(&pollfd, 1, timeout_msec);
+    if (0 > rv) {
+        if (EINTR == errno) return 0;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, 1, %d)",
+               &pollfd, timeout_msec);
+        return -1;
+    }
+    if (0 == rv) return 0;
+
+    if (NULL != watchdog_ptr) wlm_util_watchdog_enter(watchdog_ptr);
+    rv = wl_event_loop_dispatch(wl_event_loop_ptr, 0);
+    if (NULL != watchdog_ptr) wlm_util_watchdog_leave(watchdog_ptr);
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_watchdog_dispatch_idle(
+    wlm_util_watchdog_t *watchdog_ptr,
+    struct wl_event_loop *wl_event_loop_ptr)
+{
+    if (NULL != watchdog_ptr) wlm_util_watchdog_enter(watchdog_ptr);
+    wl_event_loop_dispatch_idle(wl_event_loop_ptr);
+    if (NULL != watchdog_ptr) wlm_util_watchdog_leave(watchdog_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_watchdog_enter(wlm_util_watchdog_t *watchdog_ptr)
+{
+    uint64_t start_usec = BS_MAX(_wlm_util_watchdog_now_usec(), 1u);
+    atomic_store(&watchdog_ptr->unlogged_start_usec, start_usec);
+    atomic_store(&watchdog_ptr->start_usec, start_usec);
+    if (atomic_load(&watchdog_ptr->waiting)) {
+        pthread_mutex_lock(&watchdog_ptr->mutex);
+        pthread_cond_signal(&watchdog_ptr->cond);
+        pthread_mutex_unlock(&watchdog_ptr->mutex);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_watchdog_leave(wlm_util_watchdog_t *watchdog_ptr)
+{
+    uint64_t start_usec = atomic_exchange(&watchdog_ptr->start_usec, 0);
+    if (0 == start_usec) return;
+    uint64_t usec = _wlm_util_watchdog_now_usec() - start_usec;
+
+    wlm_util_watchdog_histogram_t *h_ptr = &watchdog_ptr->histogram;
+    size_t bucket = 0;
+    while (usec >= wlm_util_watchdog_bucket_usec(bucket)) ++bucket;
+    ++h_ptr->buckets[bucket];
+    ++h_ptr->dispatches;
+    h_ptr->max_usec = BS_MAX(h_ptr->max_usec, usec);
+
+    if (usec >= watchdog_ptr->threshold_usec) {
+        ++h_ptr->stalls;
+        // Unless the watchdog thread reported it, with the stack.
+        uint_fast64_t expected_usec = start_usec;
+        if (!atomic_compare_exchange_strong(
+                &watchdog_ptr->unlogged_start_usec, &expected_usec, 0)) return;
+        bs_log(BS_WARNING, "Event loop dispatch took %"PRIu64".%03"PRIu64
+               " ms, threshold is %"PRIu64" ms.",
+               usec / 1000, usec % 1000, watchdog_ptr->threshold_usec / 1000);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+const wlm_util_watchdog_histogram_t *wlm_util_watchdog_histogram(
+    wlm_util_watchdog_t *watchdog_ptr)
+{
+    return &watchdog_ptr->histogram;
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlm_util_watchdog_bucket_usec(size_t bucket)
+{
+    if (bucket >= WLM_UTIL_WATCHDOG_BUCKETS - 1) return UINT64_MAX;
+    return UINT64_C(128) << bucket;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlm_util_watchdog_log_histogram(
+    wlm_util_watchdog_t *watchdog_ptr,
+    bs_log_severity_t severity)
+{
+    const wlm_util_watchdog_histogram_t *h_ptr = &watchdog_ptr->histogram;
+    bs_log(severity, "Event loop: %"PRIu64" dispatches, %"PRIu64" stalled, "
+           "longest %"PRIu64" us.",
+           h_ptr->dispatches, h_ptr->stalls, h_ptr->max_usec);
+    for (size_t i = 0; i < WLM_UTIL_WATCHDOG_BUCKETS; ++i) {
+        if (0 == h_ptr->buckets[i]) continue;
+        uint64_t limit_usec = wlm_util_watchdog_bucket_usec(i);
+        if (UINT64_MAX == limit_usec) {
+            bs_log(severity, "  >= %8"PRIu64" us: %"PRIu64,
+                   wlm_util_watchdog_bucket_usec(i - 1), h_ptr->buckets[i]);
+        } else {
+            bs_log(severity, "  <  %8"PRIu64" us: %"PRIu64,
+                   limit_usec, h_ptr->buckets[i]);
+        }
+    }
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/**
+ * The watchdog thread. Sleeps while the event loop is waiting. During a
+ * dispatch, it wakes up when the threshold passes, and reports a stall once
+ * per dispatch -- unless @ref wlm_util_watchdog_leave logged it already.
+ *
+ * @param arg_ptr             Points to @ref wlm_util_watchdog_t.
+ *
+ * @return NULL.
+ */
+void *_wlm_util_watchdog_thread(void *arg_ptr)
+{
+    wlm_util_watchdog_t *watchdog_ptr = arg_ptr;
+
+    pthread_mutex_lock(&watchdog_ptr->mutex);
+    while (!watchdog_ptr->stop) {
+        uint64_t start_usec = atomic_load(&watchdog_ptr->start_usec);
+        if (0 == start_usec) {
+            // Announce waiting, then re-check: The dispatch may have begun.
+            atomic_store(&watchdog_ptr->waiting, true);
+            if (0 == atomic_load(&watchdog_ptr->start_usec)) {
+                pthread_cond_wait(&watchdog_ptr->cond, &watchdog_ptr->mutex);
+            }
+            atomic_store(&watchdog_ptr->waiting, false);
+            continue;
+        }
+
+        uint64_t deadline_usec = start_usec + watchdog_ptr->threshold_usec;
+        if (_wlm_util_watchdog_now_usec() >= deadline_usec) {
+            if (start_usec != watchdog_ptr->reported_start_usec) {
+                watchdog_ptr->reported_start_usec = start_usec;
+                uint_fast64_t expected_usec = start_usec;
+                if (atomic_compare_exchange_strong(
+                        &watchdog_ptr->unlogged_start_usec,
+                        &expected_usec, 0)) {
+                    pthread_mutex_unlock(&watchdog_ptr->mutex);
+                    _wlm_util_watchdog_report(watchdog_ptr, start_usec);
+                    pthread_mutex_lock(&watchdog_ptr->mutex);
+                }
+                continue;
+            }
+            // Reported already. Check back for the next dispatch.
+            deadline_usec = (_wlm_util_watchdog_now_usec() +
+                             watchdog_ptr->threshold_usec);
+        }
+        struct timespec ts = _wlm_util_watchdog_timespec(deadline_usec);
+        pthread_cond_timedwait(&watchdog_ptr->cond, &watchdog_ptr->mutex, &ts);
+    }
+    pthread_mutex_unlock(&watchdog_ptr->mutex);
+    return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Reports a stalled dispatch: Captures the event loop thread's stack through
+ * the signal handler, and logs it. Symbolizing happens here, on the watchdog
+ * thread.
+ *
+ * @param watchdog_ptr
+ * @param start_usec          Start of the stalled dispatch.
+ */
+void _wlm_util_watchdog_report(
+    wlm_util_watchdog_t *watchdog_ptr,
+    uint64_t start_usec)
+{
+    size_t num_pcs = 0;
+    unsigned generation = ++watchdog_ptr->capture_generation;
+    if (0 == generation) generation = ++watchdog_ptr->capture_generation;
+    atomic_store(&watchdog_ptr->pending_generation, generation);
+    union sigval sigval = { .sival_int = (int)generation };
+    if (0 == pthread_sigqueue(watchdog_ptr->loop_thread, SIGRTMIN, sigval)) {
+        struct timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_nsec += 100 * 1000 * 1000;
+        if (ts.tv_nsec >= 1000 * 1000 * 1000) {
+            ts.tv_nsec -= 1000 * 1000 * 1000;
+            ++ts.tv_sec;
+        }
+        int rv;
+        while (0 != (rv = sem_timedwait(&watchdog_ptr->captured_sem, &ts)) &&
+               EINTR == errno) continue;
+        unsigned expected = generation;
+        if (0 != rv && !atomic_compare_exchange_strong(
+                &watchdog_ptr->pending_generation, &expected, 0)) {
+            // The handler claimed the capture already: Wait for it to finish.
+            while (0 != (rv = sem_wait(&watchdog_ptr->captured_sem)) &&
+                   EINTR == errno) continue;
+        }
+        if (0 == rv) num_pcs = watchdog_ptr->num_pcs;
+    } else {
+        atomic_store(&watchdog_ptr->pending_generation, 0);
+    }
+
+    uint64_t usec = _wlm_util_watchdog_now_usec() - start_usec;
+    bs_log(BS_WARNING, "Event loop stalled: Dispatch running for %"PRIu64
+           " ms. Stack of the event loop's thread:", usec / 1000);
+    if (0 < num_pcs) {
+        wlm_util_backtrace_log(BS_WARNING, watchdog_ptr->pcs, num_pcs);
+    } else {
+        bs_log(BS_WARNING, "  (No stack captured.)");
+    }
+    atomic_store(&watchdog_ptr->reported_pcs, num_pcs);
+    atomic_fetch_add(&watchdog_ptr->reports, 1);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Signal handler, on the event loop's thread: Captures the raw program
+ * counters of the stack. Async-signal-safe: Reads only registers and the
+ * stack, and calls only sem_post(3).
+ *
+ * Captures only if the signal's generation is still pending, and claims it.
+ * A stale signal, from a capture that timed out, is ignored.
+ *
+ * @param signum
+ * @param siginfo_ptr
+ * @param context_ptr         Points to the interrupted `ucontext_t`.
+ */
+void _wlm_util_watchdog_handle_signal(
+    __UNUSED__ int signum,
+    siginfo_t *siginfo_ptr,
+    void *context_ptr)
+{
+    wlm_util_watchdog_t *watchdog_ptr = atomic_load(&_wlm_util_watchdog_ptr);
+    if (NULL == watchdog_ptr || SI_QUEUE != siginfo_ptr->si_code) return;
+    unsigned expected = (unsigned)siginfo_ptr->si_value.sival_int;
+    if (0 == expected || !atomic_compare_exchange_strong(
+            &watchdog_ptr->pending_generation, &expected, 0)) return;
+
+    int saved_errno = errno;
+    watchdog_ptr->num_pcs = _wlm_util_watchdog_walk(
+        context_ptr, watchdog_ptr->stack_top,
+        watchdog_ptr->pcs, _WLM_UTIL_WATCHDOG_MAX_PCS);
+    sem_post(&watchdog_ptr->captured_sem);
+    errno = saved_errno;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Walks the frame pointer chain of an interrupted context.
+ *
+ * Each frame holds the caller's frame pointer, followed by the return
+ * address. The chain is followed only upwards, between the stack pointer and
+ * `stack_top`: A function without frame pointer ends the walk, rather than
+ * making it fault.
+ *
+ * @param ucontext_ptr
+ * @param stack_top           Upper limit for frame addresses.
+ * @param pcs_ptr
+ * @param max_pcs
+ *
+ * @return Number of program counters stored. 0 on unsupported platforms.
+ */
+size_t _wlm_util_watchdog_walk(
+    const ucontext_t *ucontext_ptr,
+    uintptr_t stack_top,
+    uintptr_t *pcs_ptr,
+    size_t max_pcs)
+{
+    uintptr_t pc, sp, fp;
+#if defined(__linux__) && defined(__x86_64__)
+    pc = ucontext_ptr->uc_mcontext.gregs[REG_RIP];
+    sp = ucontext_ptr->uc_mcontext.gregs[REG_RSP];
+    fp = ucontext_ptr->uc_mcontext.gregs[REG_RBP];
+#elif defined(__linux__) && defined(__aarch64__)
+    pc = ucontext_ptr->uc_mcontext.pc;
+    sp = ucontext_ptr->uc_mcontext.sp;
+    fp = ucontext_ptr->uc_mcontext.regs[29];
+#elif defined(__FreeBSD__) && defined(__x86_64__)
+    pc = ucontext_ptr->uc_mcontext.mc_rip;
+    sp = ucontext_ptr->uc_mcontext.mc_rsp;
+    fp = ucontext_ptr->uc_mcontext.mc_rbp;
+#elif defined(__FreeBSD__) && defined(__aarch64__)
+    pc = ucontext_ptr->uc_mcontext.mc_gpregs.gp_elr;
+    sp = ucontext_ptr->uc_mcontext.mc_gpregs.gp_sp;
+    fp = ucontext_ptr->uc_mcontext.mc_gpregs.gp_x[29];
+#else
+    return 0;
+#endif
+
+    size_t num_pcs = 0;
+    if (num_pcs < max_pcs) pcs_ptr[num_pcs++] = pc;
+    while (num_pcs < max_pcs &&
+           0 == fp % sizeof(uintptr_t) &&
+           fp >= sp &&
+           fp < stack_top - 2 * sizeof(uintptr_t)) {
+        const uintptr_t *frame_ptr = (const uintptr_t*)fp;
+        if (0 == frame_ptr[1]) break;
+        // A return address: The call is the instruction before.
+        pcs_ptr[num_pcs++] = frame_ptr[1] - 1;
+        if (frame_ptr[0] <= fp) break;
+        fp = frame_ptr[0];
+    }
+    return num_pcs;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns CLOCK_MONOTONIC, in microseconds. */
+uint64_t _wlm_util_watchdog_now_usec(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Converts microseconds into a `struct timespec`. */
+struct timespec _wlm_util_watchdog_timespec(uint64_t usec)
+{
+    struct timespec ts = {
+        .tv_sec = usec / 1000000,
+        .tv_nsec = (usec % 1000000) * 1000 };
+    return ts;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlm_util_watchdog_test_buckets(bs_test_t *test_ptr);
+static void _wlm_util_watchdog_test_stall(bs_test_t *test_ptr);
+static void _wlm_util_watchdog_test_idle(bs_test_t *test_ptr);
+static void _wlm_util_watchdog_test_stale(bs_test_t *test_ptr);
+
+/** Test cases */
+static const bs_test_case_t _wlm_util_watchdog_test_cases[] = {
+    { 1, "buckets", _wlm_util_watchdog_test_buckets },
+    { 1, "stall", _wlm_util_watchdog_test_stall },
+    { 1, "idle", _wlm_util_watchdog_test_idle },
+    { 1, "stale", _wlm_util_watchdog_test_stale },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlm_util_watchdog_test_set = BS_TEST_SET(
+    true, "watchdog", _wlm_util_watchdog_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/** Test handler: Reads a byte, then keeps busy for `*ud_ptr` microseconds. */
+static int _wlm_util_watchdog_test_busy(
+    int fd,
+    __UNUSED__ uint32_t mask,
+    void *ud_ptr)
+{
+    char c;
+    if (1 != read(fd, &c, 1)) return 0;
+    uint64_t end_usec = _wlm_util_watchdog_now_usec() + *(uint64_t*)ud_ptr;
+    while (_wlm_util_watchdog_now_usec() < end_usec) continue;
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Test idle source: Sets the bool at `data_ptr`. */
+static void _wlm_util_watchdog_test_idle_callback(void *data_ptr)
+{
+    *(bool*)data_ptr = true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Bucket limits are increasing, and the last one catches all. */
+void _wlm_util_watchdog_test_buckets(bs_test_t *test_ptr)
+{
+    BS_TEST_VERIFY_EQ(test_ptr, 128, wlm_util_watchdog_bucket_usec(0));
+    BS_TEST_VERIFY_EQ(test_ptr, 256, wlm_util_watchdog_bucket_usec(1));
+    for (size_t i = 1; i < WLM_UTIL_WATCHDOG_BUCKETS; ++i) {
+        BS_TEST_VERIFY_TRUE(
+            test_ptr,
+            wlm_util_watchdog_bucket_usec(i - 1) <
+            wlm_util_watchdog_bucket_usec(i));
+    }
+    BS_TEST_VERIFY_EQ(
+        test_ptr, UINT64_MAX,
+        wlm_util_watchdog_bucket_usec(WLM_UTIL_WATCHDOG_BUCKETS - 1));
+}
+
+/* ------------------------------------------------------------------------- */
+/** An artificially stalled dispatch is detected, and a stack captured. */
+void _wlm_util_watchdog_test_stall(bs_test_t *test_ptr)
+{
+    int pipe_fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 0, pipe(pipe_fds));
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    uint64_t busy_usec = 0;
+    struct wl_event_source *wl_event_source_ptr = wl_event_loop_add_fd(
+        wl_event_loop_ptr, pipe_fds[0], WL_EVENT_READABLE,
+        _wlm_util_watchdog_test_busy, &busy_usec);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_source_ptr);
+
+    wlm_util_watchdog_t *w = wlm_util_watchdog_create(20000);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    BS_TEST_VERIFY_EQ(test_ptr, NULL, wlm_util_watchdog_create(20000));
+    const wlm_util_watchdog_histogram_t *h_ptr =
+        wlm_util_watchdog_histogram(w);
+
+    // Waiting for events is not a dispatch.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, wlm_util_watchdog_dispatch(w, wl_event_loop_ptr, 50));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, h_ptr->dispatches);
+
+    // A quick dispatch: Counted in the first bucket, not stalled.
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, write(pipe_fds[1], "x", 1));
+    wlm_util_watchdog_dispatch(w, wl_event_loop_ptr, 1000);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, h_ptr->dispatches);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, h_ptr->buckets[0]);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, h_ptr->stalls);
+
+    // Stalls for 150ms: Reported once while stalled, with a stack.
+    busy_usec = 150000;
+    BS_TEST_VERIFY_EQ_OR_RETURN(test_ptr, 1, write(pipe_fds[1], "x", 1));
+    wlm_util_watchdog_dispatch(w, wl_event_loop_ptr, 1000);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, h_ptr->dispatches);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, h_ptr->stalls);
+    // Symbolizing may outlast the dispatch. Give it up to 5 seconds.
+    for (int i = 0; i < 500 && 0 == atomic_load(&w->reports); ++i) {
+        usleep(10000);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, atomic_load(&w->reports));
+    BS_TEST_VERIFY_TRUE(test_ptr, 150000 <= h_ptr->max_usec);
+    // 150ms is within [131072, 262144) microseconds.
+    BS_TEST_VERIFY_EQ(test_ptr, 1, h_ptr->buckets[11]);
+#if defined(__x86_64__) || defined(__aarch64__)
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, atomic_load(&w->reported_pcs));
+#endif  // defined(__x86_64__) || defined(__aarch64__)
+
+    wlm_util_watchdog_destroy(w);
+    wl_event_source_remove(wl_event_source_ptr);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+    close(pipe_fds[1]);
+    close(pipe_fds[0]);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Idle sources run without waiting for events, under the watchdog. */
+void _wlm_util_watchdog_test_idle(bs_test_t *test_ptr)
+{
+    struct wl_event_loop *wl_event_loop_ptr = wl_event_loop_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_event_loop_ptr);
+    wlm_util_watchdog_t *w = wlm_util_watchdog_create(20000);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+
+    bool called = false;
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        wl_event_loop_add_idle(
+            wl_event_loop_ptr, _wlm_util_watchdog_test_idle_callback,
+            &called));
+    wlm_util_watchdog_dispatch_idle(w, wl_event_loop_ptr);
+    BS_TEST_VERIFY_TRUE(test_ptr, called);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlm_util_watchdog_histogram(w)->dispatches);
+
+    wlm_util_watchdog_destroy(w);
+    wl_event_loop_destroy(wl_event_loop_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Signals not carrying the pending generation do not capture a stack. */
+void _wlm_util_watchdog_test_stale(bs_test_t *test_ptr)
+{
+    wlm_util_watchdog_t *w = wlm_util_watchdog_create(1000000);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    atomic_store(&w->pending_generation, 2);
+
+    // A signal not sent via pthread_sigqueue(3): Ignored.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, pthread_kill(pthread_self(), SIGRTMIN));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, sem_trywait(&w->captured_sem));
+
+    // A stale generation: Ignored, the capture stays pending.
+    union sigval sigval = { .sival_int = 1 };
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, pthread_sigqueue(pthread_self(), SIGRTMIN, sigval));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, sem_trywait(&w->captured_sem));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, atomic_load(&w->pending_generation));
+
+    // The pending generation: Claimed and captured.
+    sigval.sival_int = 2;
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, pthread_sigqueue(pthread_self(), SIGRTMIN, sigval));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, sem_trywait(&w->captured_sem));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, atomic_load(&w->pending_generation));
+#if defined(__x86_64__) || defined(__aarch64__)
+    BS_TEST_VERIFY_NEQ(test_ptr, 0, w->num_pcs);
+#endif  // defined(__x86_64__) || defined(__aarch64__)
+
+    // Sent again: The generation is no longer pending.
+    BS_TEST_VERIFY_EQ(
+        test_ptr, 0, pthread_sigqueue(pthread_self(), SIGRTMIN, sigval));
+    BS_TEST_VERIFY_EQ(test_ptr, -1, sem_trywait(&w->captured_sem));
+
+    wlm_util_watchdog_destroy(w);
+}
+
+/* == End of watchdog.c ==================================================== */
@@ -0,0 +1,166 @@
+/* ========================================================================= */
+/**
+ * @file watchdog.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_UTIL_WATCHDOG_H__
+#define __WLMAKER_UTIL_WATCHDOG_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include <libbase/libbase.h>
+
+struct wl_event_loop;
+
+/**
+ * Watchdog for the event loop.
+ *
+ * The event loop's thread marks the beginning and end of each dispatch. A
+ * watchdog thread notices when a dispatch runs beyond the threshold, captures
+ * a stack of the event loop's thread and logs it. The duration of every
+ * dispatch is recorded in a histogram.
+ *
+ * At most one watchdog exists at a time. It uses `SIGRTMIN` for capturing
+ * the stack: The handler only walks frame pointers, and the watchdog thread
+ * symbolizes the result. Frames are captured from the dispatch up to where
+ * the watchdog was created.
+ */
+typedef struct _wlm_util_watchdog_t wlm_util_watchdog_t;
+
+/** Number of buckets in @ref wlm_util_watchdog_histogram_t. */
+#define WLM_UTIL_WATCHDOG_BUCKETS 16
+
+/** Histogram of dispatch durations. */
+typedef struct {
+    /**
+     * Number of dispatches by duration: Bucket `i` counts those shorter than
+     * @ref wlm_util_watchdog_bucket_usec for `i`, and not counted before.
+     */
+    uint64_t                  buckets[WLM_UTIL_WATCHDOG_BUCKETS];
+    /** Total number of dispatches. */
+    uint64_t                  dispatches;
+    /** Number of dispatches that ran beyond the threshold. */
+    uint64_t                  stalls;
+    /** Longest dispatch, in microseconds. */
+    uint64_t                  max_usec;
+} wlm_util_watchdog_histogram_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Creates the watchdog, and starts its thread. Must be called from the event
+ * loop's thread: That is the thread whose stack gets captured.
+ *
+ * @param threshold_usec      Dispatches running longer count as stalled.
+ *
+ * @return Pointer to the watchdog, or NULL on error. Must be destroyed by
+ *     calling @ref wlm_util_watchdog_destroy.
+ */
+wlm_util_watchdog_t *wlm_util_watchdog_create(uint64_t threshold_usec);
+
+/**
+ * Destroys the watchdog.
+ *
+ * @param watchdog_ptr
+ */
+void wlm_util_watchdog_destroy(wlm_util_watchdog_t *watchdog_ptr);
+
+/**
+ * Waits up to `timeout_msec` for events on `wl_event_loop_ptr`, and then
+ * dispatches them, between @ref wlm_util_watchdog_enter and
+ * @ref wlm_util_watchdog_leave. Waiting does not count towards the duration.
+ *
+ * @param watchdog_ptr        May be NULL, to dispatch without a watchdog.
+ * @param wl_event_loop_ptr
+ * @param timeout_msec        As for poll(2): -1 to wait without timeout.
+ *
+ * @return The return value of wl_event_loop_dispatch(), or -1 on error.
+ */
+int wlm_util_watchdog_dispatch(
+    wlm_util_watchdog_t *watchdog_ptr,
+    struct wl_event_loop *wl_event_loop_ptr,
+    int timeout_msec);
+
+/**
+ * Dispatches the idle sources of `wl_event_loop_ptr`, between
+ * @ref wlm_util_watchdog_enter and @ref wlm_util_watchdog_leave.
+ *
+ * To be called before waiting in @ref wlm_util_watchdog_dispatch: Idle
+ * sources added while dispatching would otherwise wait for the next event.
+ *
+ * @param watchdog_ptr        May be NULL, to dispatch without a watchdog.
+ * @param wl_event_loop_ptr
+ */
+void wlm_util_watchdog_dispatch_idle(
+    wlm_util_watchdog_t *watchdog_ptr,
+    struct wl_event_loop *wl_event_loop_ptr);
+
+/**
+ * Marks the beginning of a dispatch. Lock-free, unless the watchdog thread
+ * waits for a dispatch to begin.
+ *
+ * @param watchdog_ptr
+ */
+void wlm_util_watchdog_enter(wlm_util_watchdog_t *watchdog_ptr);
+
+/**
+ * Marks the end of a dispatch, and records its duration. Logs a stall,
+ * unless the watchdog thread reported it already.
+ *
+ * @param watchdog_ptr
+ */
+void wlm_util_watchdog_leave(wlm_util_watchdog_t *watchdog_ptr);
+
+/**
+ * Returns the histogram. Must be called from the event loop's thread.
+ *
+ * @param watchdog_ptr
+ *
+ * @return Pointer to the histogram, valid until the watchdog is destroyed.
+ */
+const wlm_util_watchdog_histogram_t *wlm_util_watchdog_histogram(
+    wlm_util_watchdog_t *watchdog_ptr);
+
+/**
+ * @param bucket              Index into @ref wlm_util_watchdog_histogram_t.
+ *
+ * @return Upper limit of durations counted by the bucket, in microseconds.
+ *     UINT64_MAX for the last bucket.
+ */
+uint64_t wlm_util_watchdog_bucket_usec(size_t bucket);
+
+/**
+ * Logs the histogram, one line per non-empty bucket.
+ *
+ * @param watchdog_ptr
+ * @param severity
+ */
+void wlm_util_watchdog_log_histogram(
+    wlm_util_watchdog_t *watchdog_ptr,
+    bs_log_severity_t severity);
+
+/** Unit test set for @ref wlm_util_watchdog_t. */
+extern const bs_test_set_t wlm_util_watchdog_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_UTIL_WATCHDOG_H__ */
+/* == End of watchdog.h ==================================================== */
@@ -0,0 +1,228 @@
+/* ========================================================================= */
+/**
+ * @file applet.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "applet.h"
+
+#include <stdlib.h>
+
+#include <libbase/libbase.h>
+
+#include "icon.h"
+
+/* == Declarations ========================================================= */
+
+/** State of the host. */
+struct _wlmcl_applet_host_t {
+    /** The client, shared by all applets. */
+    wlmcl_client_t            *wlclient_ptr;
+    /** The ticker, shared by all applets. */
+    wlmcl_ticker_t            *ticker_ptr;
+    /** Loaded applets. Elements are @ref wlmcl_applet_instance_t::dlnode. */
+    bs_dllist_t               instances;
+    /**
+     * Target of the earliest client timer registered for the ticker, or
+     * UINT64_MAX. Client timers cannot be cancelled, so a timer is only
+     * registered if none is pending for an earlier or equal time.
+     */
+    uint64_t                  armed_usec;
+};
+
+/** A loaded applet. */
+typedef struct {
+    /** Element of @ref wlmcl_applet_host_t::instances. */
+    bs_dllist_node_t          dlnode;
+    /** The applet's description. */
+    const wlmcl_applet_t      *applet_ptr;
+    /** As returned from @ref wlmcl_applet_t::create. */
+    void                      *state_ptr;
+} wlmcl_applet_instance_t;
+
+static void _wlmcl_applet_host_arm(wlmcl_applet_host_t *host_ptr);
+static void _wlmcl_applet_host_handle_timer(
+    wlmcl_client_t *wlclient_ptr,
+    void *ud_ptr);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmcl_applet_host_t *wlmcl_applet_host_create(const char *app_id_ptr)
+{
+    wlmcl_applet_host_t *host_ptr = logged_calloc(
+        1, sizeof(wlmcl_applet_host_t));
+    if (NULL == host_ptr) return NULL;
+    host_ptr->armed_usec = UINT64_MAX;
+
+    host_ptr->wlclient_ptr = wlmcl_client_create(app_id_ptr);
+    if (NULL == host_ptr->wlclient_ptr) {
+        wlmcl_applet_host_destroy(host_ptr);
+        return NULL;
+    }
+    if (!wlmcl_icon_supported(host_ptr->wlclient_ptr)) {
+        bs_log(BS_ERROR, "Icon protocol is not supported.");
+        wlmcl_applet_host_destroy(host_ptr);
+        return NULL;
+    }
+
+    host_ptr->ticker_ptr = wlmcl_ticker_create();
+    if (NULL == host_ptr->ticker_ptr) {
+        wlmcl_applet_host_destroy(host_ptr);
+        return NULL;
+    }
+    return host_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_applet_host_destroy(wlmcl_applet_host_t *host_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = host_ptr->instances.tail_ptr)) {
+        bs_dllist_remove(&host_ptr->instances, dlnode_ptr);
+        wlmcl_applet_instance_t *instance_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_applet_instance_t, dlnode);
+        instance_ptr->applet_ptr->destroy(instance_ptr->state_ptr);
+        free(instance_ptr);
+    }
+
+    if (NULL != host_ptr->ticker_ptr) {
+        wlmcl_ticker_destroy(host_ptr->ticker_ptr);
+        host_ptr->ticker_ptr = NULL;
+    }
+    // Also drops a pending timer of the ticker, without calling it.
+    if (NULL != host_ptr->wlclient_ptr) {
+        wlmcl_client_destroy(host_ptr->wlclient_ptr);
+        host_ptr->wlclient_ptr = NULL;
+    }
+    free(host_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+bool wlmcl_applet_host_load(
+    wlmcl_applet_host_t *host_ptr,
+    const wlmcl_applet_t *applet_ptr,
+    int argc,
+    const char **argv)
+{
+    wlmcl_applet_instance_t *instance_ptr = logged_calloc(
+        1, sizeof(wlmcl_applet_instance_t));
+    if (NULL == instance_ptr) return false;
+    instance_ptr->applet_ptr = applet_ptr;
+
+    instance_ptr->state_ptr = applet_ptr->create(host_ptr, argc, argv);
+    if (NULL == instance_ptr->state_ptr) {
+        bs_log(BS_ERROR, "Failed to create applet \"%s\"",
+               applet_ptr->name_ptr);
+        free(instance_ptr);
+        return false;
+    }
+    bs_dllist_push_back(&host_ptr->instances, &instance_ptr->dlnode);
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_applet_host_run(wlmcl_applet_host_t *host_ptr)
+{
+    wlmcl_client_run(host_ptr->wlclient_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmcl_client_t *wlmcl_applet_host_client(wlmcl_applet_host_t *host_ptr)
+{
+    return host_ptr->wlclient_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+wlmcl_tick_t *wlmcl_applet_host_add_tick(
+    wlmcl_applet_host_t *host_ptr,
+    uint64_t interval_usec,
+    wlmcl_tick_callback_t callback,
+    void *callback_ud_ptr)
+{
+    wlmcl_tick_t *tick_ptr = wlmcl_ticker_add(
+        host_ptr->ticker_ptr, interval_usec, bs_usec(),
+        callback, callback_ud_ptr);
+    if (NULL != tick_ptr) _wlmcl_applet_host_arm(host_ptr);
+    return tick_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_applet_host_remove_tick(
+    wlmcl_applet_host_t *host_ptr,
+    wlmcl_tick_t *tick_ptr)
+{
+    // A pending client timer may now be early. It will just re-arm.
+    wlmcl_ticker_remove(host_ptr->ticker_ptr, tick_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+int wlmcl_applet_main(
+    const char *app_id_ptr,
+    const wlmcl_applet_t *applet_ptr,
+    int argc,
+    const char **argv)
+{
+    wlmcl_applet_host_t *host_ptr = wlmcl_applet_host_create(app_id_ptr);
+    if (NULL == host_ptr) return EXIT_FAILURE;
+
+    bool rv = wlmcl_applet_host_load(host_ptr, applet_ptr, argc, argv);
+    if (rv) wlmcl_applet_host_run(host_ptr);
+
+    wlmcl_applet_host_destroy(host_ptr);
+    return rv ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Registers a client timer for the ticker's next due time, if needed. */
+void _wlmcl_applet_host_arm(wlmcl_applet_host_t *host_ptr)
+{
+    uint64_t next_usec = wlmcl_ticker_next_usec(host_ptr->ticker_ptr);
+    if (UINT64_MAX == next_usec || next_usec >= host_ptr->armed_usec) return;
+
+    if (wlmcl_client_register_timer(
+            host_ptr->wlclient_ptr, next_usec,
+            _wlmcl_applet_host_handle_timer, host_ptr)) {
+        host_ptr->armed_usec = next_usec;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles the client timer: Dispatches all due ticks in one go, and arms the
+ * timer for the next due time.
+ *
+ * @param wlclient_ptr
+ * @param ud_ptr              The @ref wlmcl_applet_host_t.
+ */
+void _wlmcl_applet_host_handle_timer(
+    __UNUSED__ wlmcl_client_t *wlclient_ptr,
+    void *ud_ptr)
+{
+    wlmcl_applet_host_t *host_ptr = ud_ptr;
+    uint64_t now_usec = bs_usec();
+
+    // A superseded timer fires before the armed one is due: Leave it armed.
+    if (now_usec >= host_ptr->armed_usec) host_ptr->armed_usec = UINT64_MAX;
+
+    wlmcl_ticker_dispatch(host_ptr->ticker_ptr, now_usec);
+    _wlmcl_applet_host_arm(host_ptr);
+}
+
+/* == End of applet.c ====================================================== */
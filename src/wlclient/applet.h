@@ -0,0 +1,160 @@
+/* ========================================================================= */
+/**
+ * @file applet.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_WLCLIENT_APPLET_H__
+#define __WLMAKER_WLCLIENT_APPLET_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "ticker.h"
+#include "wlclient.h"
+
+/** Forward declaration: A process hosting applets. */
+typedef struct _wlmcl_applet_host_t wlmcl_applet_host_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Describes an applet: A dock-app that shows an icon surface.
+ *
+ * Applets must keep all their state in what `create` returns, so that several
+ * applets -- including several instances of the same -- can share a host.
+ */
+typedef struct {
+    /** Name of the applet, eg. "clock". */
+    const char                *name_ptr;
+    /**
+     * Creates an instance of the applet.
+     *
+     * @param host_ptr
+     * @param argc
+     * @param argv            Arguments. `argv[0]` is the applet's name.
+     *
+     * @return The applet's state, or NULL on error.
+     */
+    void *(*create)(wlmcl_applet_host_t *host_ptr,
+                    int argc,
+                    const char **argv);
+    /**
+     * Destroys the instance. Must release all ticks, icons & buffers.
+     *
+     * @param state_ptr       As returned from `create`.
+     */
+    void (*destroy)(void *state_ptr);
+} wlmcl_applet_t;
+
+/**
+ * Creates a host: Connects to the compositor, and sets up the ticker.
+ *
+ * @param app_id_ptr
+ *
+ * @return The host, or NULL on error, or if the compositor does not support
+ *     icons. Must be destroyed by calling @ref wlmcl_applet_host_destroy.
+ */
+wlmcl_applet_host_t *wlmcl_applet_host_create(const char *app_id_ptr);
+
+/**
+ * Destroys the host: All applets, in reverse order of loading, then the
+ * ticker and the client.
+ *
+ * @param host_ptr
+ */
+void wlmcl_applet_host_destroy(wlmcl_applet_host_t *host_ptr);
+
+/**
+ * Loads an instance of the applet into the host.
+ *
+ * @param host_ptr
+ * @param applet_ptr          Must outlive the host.
+ * @param argc
+ * @param argv
+ *
+ * @return true on success.
+ */
+bool wlmcl_applet_host_load(
+    wlmcl_applet_host_t *host_ptr,
+    const wlmcl_applet_t *applet_ptr,
+    int argc,
+    const char **argv);
+
+/**
+ * Runs the client's mainloop, until termination is requested.
+ *
+ * @param host_ptr
+ */
+void wlmcl_applet_host_run(wlmcl_applet_host_t *host_ptr);
+
+/** @return The client, shared by all applets of the host. */
+wlmcl_client_t *wlmcl_applet_host_client(wlmcl_applet_host_t *host_ptr);
+
+/**
+ * Adds a periodic tick to the host's ticker. See @ref wlmcl_ticker_add.
+ *
+ * All applets with the same interval are woken up together, at multiples of
+ * the interval.
+ *
+ * @param host_ptr
+ * @param interval_usec
+ * @param callback
+ * @param callback_ud_ptr
+ *
+ * @return The tick, or NULL on error. Must be removed by calling
+ *     @ref wlmcl_applet_host_remove_tick.
+ */
+wlmcl_tick_t *wlmcl_applet_host_add_tick(
+    wlmcl_applet_host_t *host_ptr,
+    uint64_t interval_usec,
+    wlmcl_tick_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Removes a tick added by @ref wlmcl_applet_host_add_tick.
+ *
+ * @param host_ptr
+ * @param tick_ptr
+ */
+void wlmcl_applet_host_remove_tick(
+    wlmcl_applet_host_t *host_ptr,
+    wlmcl_tick_t *tick_ptr);
+
+/**
+ * Runs a single applet in a host of its own. For standalone binaries.
+ *
+ * @param app_id_ptr
+ * @param applet_ptr
+ * @param argc
+ * @param argv
+ *
+ * @return EXIT_SUCCESS or EXIT_FAILURE.
+ */
+int wlmcl_applet_main(
+    const char *app_id_ptr,
+    const wlmcl_applet_t *applet_ptr,
+    int argc,
+    const char **argv);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_WLCLIENT_APPLET_H__ */
+/* == End of applet.h ====================================================== */
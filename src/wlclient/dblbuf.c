@@ -19,6 +19,9 @@
  * limitations under the License.
  */
 
+/** For `mremap`. */
+#define _GNU_SOURCE
+
 #include "dblbuf.h"
 
 #include <errno.h>
@@ -29,7 +32,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/mman.h>
+#include <sys/socket.h>
 #include <unistd.h>
+#include <wayland-client-core.h>
 #include <wayland-client-protocol.h>
 
 struct wl_buffer;
@@ -38,10 +43,12 @@ struct wl_shm_pool;
 
 /* == Declarations ========================================================= */
 
-/** How many buffers to hold for the double buffer: Two. */
-#define _WLCL_DBLBUF_NUM 2
+/** How many buffers the pool starts with: Two, for double-buffering. */
+#define _WLCL_DBLBUF_MIN 2
+/** How many buffers the pool may grow to: Three, for triple-buffering. */
+#define _WLCL_DBLBUF_MAX 3
 
-/** A single buffer. Two of these are backing the double-buffer. */
+/** A single buffer. Two or three of these are backing the double-buffer. */
 struct wlmcl_buffer {
     /** The wayland buffer structure. */
     struct wl_buffer          *wl_buffer_ptr;
@@ -49,6 +56,22 @@ struct wlmcl_buffer {
     bs_gfxbuf_t               *gfxbuf_ptr;
     /** Back-link to the double-buffer. */
     wlmcl_dblbuf_t             *dblbuf_ptr;
+    /** Offset of the buffer's page within the shared memory pool. */
+    size_t                    offset;
+    /** Size of the buffer's page, in bytes. */
+    size_t                    size;
+    /** Whether the compositor released the buffer, ie. we can draw to it. */
+    bool                      released;
+    /**
+     * Whether the buffer was retired by @ref wlmcl_dblbuf_resize while the
+     * compositor held it. It is then an element of
+     * @ref wlmcl_dblbuf_t::retired, and destroyed once released.
+     */
+    bool                      retired;
+    /** Element of @ref wlmcl_dblbuf_t::retired. */
+    bs_dllist_node_t          dlnode;
+    /** Value of @ref wlmcl_dblbuf_t::sequence when last drawn. 0 if never. */
+    uint64_t                  sequence;
 };
 
 /** State of double-buffered shared memory. */
@@ -58,16 +81,28 @@ struct _wlmcl_dblbuf_t {
     /** Height of the buffer, in pixels. */
     unsigned                  height;
 
-    /** Holds the two @ref wlmcl_buffer backing this double buffer. */
-    struct wlmcl_buffer       buffers[_WLCL_DBLBUF_NUM];
-
-    /** Holds @ref wlmcl_dblbuf_t::buffers items that are released. */
-    struct wlmcl_buffer       *released_buffer_ptrs[_WLCL_DBLBUF_NUM];
-    /** Number of items in @ref wlmcl_dblbuf_t::released_buffer_ptrs. */
-    int                       released;
+    /** Holds the @ref wlmcl_buffer backing this double buffer. */
+    struct wlmcl_buffer       buffers[_WLCL_DBLBUF_MAX];
+    /** Number of buffers in use in @ref wlmcl_dblbuf_t::buffers. */
+    unsigned                  buffers_num;
+    /**
+     * Offset of the first page of @ref wlmcl_dblbuf_t::buffers in the pool.
+     * Past the pages of the buffers in @ref wlmcl_dblbuf_t::retired.
+     */
+    size_t                    base_offset;
+    /** Buffers of previous dimensions, still held by the compositor. */
+    bs_dllist_t               retired;
+    /** Sequence number of the last drawn frame. */
+    uint64_t                  sequence;
     /** Indicates that a frame is due to be drawn. */
     bool                      frame_is_due;
+    /** Whether the currently-due frame was already counted as dropped. */
+    bool                      frame_dropped;
 
+    /** File descriptor of the shared memory object. */
+    int                       fd;
+    /** The shared memory pool, created from @ref wlmcl_dblbuf_t::fd. */
+    struct wl_shm_pool        *wl_shm_pool_ptr;
     /** Blob of memory-mapped buffer data. */
     void                      *data_ptr;
     /** Size of @ref wlmcl_dblbuf_t::data_ptr. */
@@ -77,9 +112,18 @@ struct _wlmcl_dblbuf_t {
     wlmcl_dblbuf_ready_callback_t callback;
     /** Argument to @ref wlmcl_dblbuf_t::callback. */
     void                      *callback_ud_ptr;
+    /** The buffer being drawn into, while the callback runs. */
+    struct wlmcl_buffer       *drawing_ptr;
+    /** Whether the callback reported damage via @ref wlmcl_dblbuf_damage. */
+    bool                      damaged;
 
     /** Surface that this double buffer is operating on. */
     struct wl_surface         *wl_surface_ptr;
+    /** Pending frame callback of the last commit, or NULL. */
+    struct wl_callback        *wl_callback_ptr;
+
+    /** Counters. */
+    wlmcl_dblbuf_stats_t      stats;
 };
 
 static void _wlcl_dblbuf_callback_if_ready(wlmcl_dblbuf_t *dblbuf_ptr);
@@ -88,13 +132,18 @@ static void _wlcl_dblbuf_handle_frame_done(
     struct wl_callback *callback,
     __UNUSED__ uint32_t time);
 
+static struct wlmcl_buffer *_wlcl_dblbuf_acquire(wlmcl_dblbuf_t *dblbuf_ptr);
+static bool _wlcl_dblbuf_grow(wlmcl_dblbuf_t *dblbuf_ptr);
+static bool _wlcl_dblbuf_reserve(wlmcl_dblbuf_t *dblbuf_ptr, size_t size);
+static size_t _wlcl_dblbuf_page_size(unsigned width, unsigned height);
+
 static bool _wlcl_dblbuf_create_buffer(
     struct wlmcl_buffer *buffer_ptr,
     wlmcl_dblbuf_t *dblbuf_ptr,
-    struct wl_shm_pool *wl_shm_pool_ptr,
-    unsigned page,
-    unsigned width,
-    unsigned height);
+    size_t offset);
+static void _wlcl_dblbuf_destroy_buffer(struct wlmcl_buffer *buffer_ptr);
+static void _wlcl_dblbuf_retire_buffer(struct wlmcl_buffer *buffer_ptr);
+static bool _wlcl_dblbuf_create_gfxbuf(struct wlmcl_buffer *buffer_ptr);
 
 static void _wlcl_dblbuf_handle_wl_buffer_release(
     void *data_ptr,
@@ -132,39 +181,37 @@ wlmcl_dblbuf_t *wlmcl_dblbuf_create(
     dblbuf_ptr->height = height;
     dblbuf_ptr->wl_surface_ptr = BS_ASSERT_NOTNULL(wl_surface_ptr);
 
-    dblbuf_ptr->data_size = 2 * width * height * sizeof(uint32_t);
-    int fd = _wlcl_dblbuf_shm_create(app_id_ptr, dblbuf_ptr->data_size);
-    if (0 >= fd) goto error;
+    dblbuf_ptr->data_size =
+        _WLCL_DBLBUF_MIN * _wlcl_dblbuf_page_size(width, height);
+    dblbuf_ptr->fd = _wlcl_dblbuf_shm_create(
+        app_id_ptr, dblbuf_ptr->data_size);
+    if (0 >= dblbuf_ptr->fd) goto error;
 
     dblbuf_ptr->data_ptr = mmap(
-        NULL, dblbuf_ptr->data_size, PROT_READ|PROT_WRITE, MAP_SHARED, fd, 0);
+        NULL, dblbuf_ptr->data_size, PROT_READ|PROT_WRITE, MAP_SHARED,
+        dblbuf_ptr->fd, 0);
     if (MAP_FAILED == dblbuf_ptr->data_ptr) {
         bs_log(BS_ERROR | BS_ERRNO, "Failed mmap(NULL, %zu, "
                "PROT_READ|PROT_WRITE, MAP_SHARED, %d, 0)",
-               dblbuf_ptr->data_size, fd);
-        close(fd);
+               dblbuf_ptr->data_size, dblbuf_ptr->fd);
+        dblbuf_ptr->data_ptr = NULL;
         goto error;
     }
 
-    struct wl_shm_pool *wl_shm_pool_ptr = wl_shm_create_pool(
-        wl_shm_ptr, fd, dblbuf_ptr->data_size);
-    close(fd);
-    if (NULL == wl_shm_pool_ptr) {
+    dblbuf_ptr->wl_shm_pool_ptr = wl_shm_create_pool(
+        wl_shm_ptr, dblbuf_ptr->fd, dblbuf_ptr->data_size);
+    if (NULL == dblbuf_ptr->wl_shm_pool_ptr) {
         bs_log(BS_ERROR, "Failed wl_shm_create_pool(%p, %d, %zu)",
-               wl_shm_ptr, fd, dblbuf_ptr->data_size);
+               wl_shm_ptr, dblbuf_ptr->fd, dblbuf_ptr->data_size);
         goto error;
     }
 
-    for (int i = 0; i < _WLCL_DBLBUF_NUM; ++i) {
-        if (_wlcl_dblbuf_create_buffer(
+    for (unsigned i = 0; i < _WLCL_DBLBUF_MIN; ++i) {
+        if (!_wlcl_dblbuf_create_buffer(
                 &dblbuf_ptr->buffers[i], dblbuf_ptr,
-                wl_shm_pool_ptr, i, width, height)) {
-            _wlcl_dblbuf_handle_wl_buffer_release(
-                &dblbuf_ptr->buffers[i],
-                dblbuf_ptr->buffers[i].wl_buffer_ptr);
-        }
+                i * _wlcl_dblbuf_page_size(width, height))) goto error;
+        dblbuf_ptr->buffers_num++;
     }
-    if (dblbuf_ptr->released != _WLCL_DBLBUF_NUM) goto error;
 
     dblbuf_ptr->frame_is_due = true;
     return dblbuf_ptr;
@@ -177,25 +224,88 @@ error:
 /* ------------------------------------------------------------------------- */
 void wlmcl_dblbuf_destroy(wlmcl_dblbuf_t *dblbuf_ptr)
 {
-    for (int i = 0; i < _WLCL_DBLBUF_NUM; ++i) {
-        struct wlmcl_buffer *buffer_ptr = &dblbuf_ptr->buffers[i];
-        if (NULL != buffer_ptr->wl_buffer_ptr) {
-            wl_buffer_destroy(buffer_ptr->wl_buffer_ptr);
-            buffer_ptr->wl_buffer_ptr = NULL;
-        }
-        if (NULL != buffer_ptr->gfxbuf_ptr) {
-            bs_gfxbuf_destroy(buffer_ptr->gfxbuf_ptr);
-            buffer_ptr->gfxbuf_ptr = NULL;
-        }
+    if (NULL != dblbuf_ptr->wl_callback_ptr) {
+        wl_callback_destroy(dblbuf_ptr->wl_callback_ptr);
+        dblbuf_ptr->wl_callback_ptr = NULL;
+    }
+    for (int i = 0; i < _WLCL_DBLBUF_MAX; ++i) {
+        _wlcl_dblbuf_destroy_buffer(&dblbuf_ptr->buffers[i]);
+    }
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&dblbuf_ptr->retired))) {
+        struct wlmcl_buffer *buffer_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, struct wlmcl_buffer, dlnode);
+        _wlcl_dblbuf_destroy_buffer(buffer_ptr);
+        free(buffer_ptr);
     }
 
+    if (NULL != dblbuf_ptr->wl_shm_pool_ptr) {
+        wl_shm_pool_destroy(dblbuf_ptr->wl_shm_pool_ptr);
+        dblbuf_ptr->wl_shm_pool_ptr = NULL;
+    }
     if (NULL != dblbuf_ptr->data_ptr) {
         munmap(dblbuf_ptr->data_ptr, dblbuf_ptr->data_size);
         dblbuf_ptr->data_ptr = NULL;
     }
+    if (0 < dblbuf_ptr->fd) {
+        close(dblbuf_ptr->fd);
+        dblbuf_ptr->fd = 0;
+    }
     free(dblbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+bool wlmcl_dblbuf_resize(
+    wlmcl_dblbuf_t *dblbuf_ptr,
+    unsigned width,
+    unsigned height)
+{
+    if (width == dblbuf_ptr->width && height == dblbuf_ptr->height) {
+        dblbuf_ptr->frame_is_due = true;
+        _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
+        return true;
+    }
+
+    // The wl_buffer dimensions are immutable, so all buffers get re-created.
+    // Buffers still held by the compositor are retired: Kept, along with
+    // their pages, until released. The new pages are placed past these.
+    dblbuf_ptr->base_offset = 0;
+    for (unsigned i = 0; i < dblbuf_ptr->buffers_num; ++i) {
+        struct wlmcl_buffer *buffer_ptr = &dblbuf_ptr->buffers[i];
+        if (!buffer_ptr->released && NULL != buffer_ptr->wl_buffer_ptr) {
+            _wlcl_dblbuf_retire_buffer(buffer_ptr);
+        }
+        _wlcl_dblbuf_destroy_buffer(buffer_ptr);
+    }
+    for (bs_dllist_node_t *dlnode_ptr = dblbuf_ptr->retired.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        struct wlmcl_buffer *buffer_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, struct wlmcl_buffer, dlnode);
+        dblbuf_ptr->base_offset = BS_MAX(
+            dblbuf_ptr->base_offset, buffer_ptr->offset + buffer_ptr->size);
+    }
+    dblbuf_ptr->width = width;
+    dblbuf_ptr->height = height;
+
+    size_t page_size = _wlcl_dblbuf_page_size(width, height);
+    if (!_wlcl_dblbuf_reserve(
+            dblbuf_ptr,
+            dblbuf_ptr->base_offset + dblbuf_ptr->buffers_num * page_size)) {
+        return false;
+    }
+    for (unsigned i = 0; i < dblbuf_ptr->buffers_num; ++i) {
+        if (!_wlcl_dblbuf_create_buffer(
+                &dblbuf_ptr->buffers[i], dblbuf_ptr,
+                dblbuf_ptr->base_offset + i * page_size)) return false;
+        dblbuf_ptr->stats.reallocations++;
+    }
+
+    dblbuf_ptr->frame_is_due = true;
+    _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 void wlmcl_dblbuf_register_ready_callback(
     wlmcl_dblbuf_t *dblbuf_ptr,
@@ -208,6 +318,36 @@ void wlmcl_dblbuf_register_ready_callback(
     _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+unsigned wlmcl_dblbuf_age(wlmcl_dblbuf_t *dblbuf_ptr)
+{
+    struct wlmcl_buffer *buffer_ptr = dblbuf_ptr->drawing_ptr;
+    if (NULL == buffer_ptr || 0 == buffer_ptr->sequence) return 0;
+    uint64_t age = dblbuf_ptr->sequence - buffer_ptr->sequence + 1;
+    return age > UINT_MAX ? 0 : (unsigned)age;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_dblbuf_damage(
+    wlmcl_dblbuf_t *dblbuf_ptr,
+    int x,
+    int y,
+    int width,
+    int height)
+{
+    if (NULL == dblbuf_ptr->drawing_ptr) return;
+    wl_surface_damage_buffer(dblbuf_ptr->wl_surface_ptr, x, y, width, height);
+    dblbuf_ptr->damaged = true;
+}
+
+/* ------------------------------------------------------------------------- */
+const wlmcl_dblbuf_stats_t *wlmcl_dblbuf_stats(wlmcl_dblbuf_t *dblbuf_ptr)
+{
+    dblbuf_ptr->stats.buffers = dblbuf_ptr->buffers_num;
+    dblbuf_ptr->stats.retired_buffers = bs_dllist_size(&dblbuf_ptr->retired);
+    return &dblbuf_ptr->stats;
+}
+
 /* == Local (static) methods =============================================== */
 
 /* ------------------------------------------------------------------------- */
@@ -222,30 +362,47 @@ void wlmcl_dblbuf_register_ready_callback(
 void _wlcl_dblbuf_callback_if_ready(wlmcl_dblbuf_t *dblbuf_ptr)
 {
     // Only proceed a frame is due, the client asked, and we have a buffer.
-    if (!dblbuf_ptr->callback ||
-        !dblbuf_ptr->frame_is_due ||
-        0 >= dblbuf_ptr->released) return;
+    if (!dblbuf_ptr->callback || !dblbuf_ptr->frame_is_due) return;
+
+    struct wlmcl_buffer *buffer_ptr = _wlcl_dblbuf_acquire(dblbuf_ptr);
+    if (NULL == buffer_ptr) {
+        if (!dblbuf_ptr->frame_dropped) dblbuf_ptr->stats.dropped_frames++;
+        dblbuf_ptr->frame_dropped = true;
+        return;
+    }
 
-    struct wlmcl_buffer *buffer_ptr =
-        dblbuf_ptr->released_buffer_ptrs[--dblbuf_ptr->released];
+    buffer_ptr->released = false;
     dblbuf_ptr->frame_is_due = false;
     wlmcl_dblbuf_ready_callback_t callback = dblbuf_ptr->callback;
     dblbuf_ptr->callback = NULL;
-    if (!callback(
-            buffer_ptr->gfxbuf_ptr,
-            dblbuf_ptr->callback_ud_ptr)) {
-        dblbuf_ptr->released_buffer_ptrs[dblbuf_ptr->released++] = buffer_ptr;
+    dblbuf_ptr->drawing_ptr = buffer_ptr;
+    dblbuf_ptr->damaged = false;
+    bool drawn = callback(
+        buffer_ptr->gfxbuf_ptr,
+        dblbuf_ptr->callback_ud_ptr);
+    dblbuf_ptr->drawing_ptr = NULL;
+    if (!drawn) {
+        buffer_ptr->released = true;
         dblbuf_ptr->frame_is_due = true;
         return;
     }
+    buffer_ptr->sequence = ++dblbuf_ptr->sequence;
+    dblbuf_ptr->frame_dropped = false;
+    dblbuf_ptr->stats.frames++;
 
-    wl_surface_damage_buffer(
-        dblbuf_ptr->wl_surface_ptr, 0, 0, INT32_MAX, INT32_MAX);
+    if (!dblbuf_ptr->damaged) {
+        wl_surface_damage_buffer(
+            dblbuf_ptr->wl_surface_ptr, 0, 0, INT32_MAX, INT32_MAX);
+    }
 
-    struct wl_callback *wl_callback = wl_surface_frame(
+    // A frame committed ahead of the previous `done` supersedes that one.
+    if (NULL != dblbuf_ptr->wl_callback_ptr) {
+        wl_callback_destroy(dblbuf_ptr->wl_callback_ptr);
+    }
+    dblbuf_ptr->wl_callback_ptr = wl_surface_frame(
         dblbuf_ptr->wl_surface_ptr);
     wl_callback_add_listener(
-        wl_callback,
+        dblbuf_ptr->wl_callback_ptr,
         &_wlcl_dblbuf_frame_listener,
         dblbuf_ptr);
     dblbuf_ptr->frame_is_due = false;
@@ -264,39 +421,156 @@ void _wlcl_dblbuf_handle_frame_done(
     struct wl_callback *callback,
     __UNUSED__ uint32_t time)
 {
+    wlmcl_dblbuf_t *dblbuf_ptr = data_ptr;
+    BS_ASSERT(dblbuf_ptr->wl_callback_ptr == callback);
     wl_callback_destroy(callback);
+    dblbuf_ptr->wl_callback_ptr = NULL;
 
-    wlmcl_dblbuf_t *dblbuf_ptr = data_ptr;
     dblbuf_ptr->frame_is_due = true;
     _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
 /**
- * Helper: Creates a `struct wl_buffer` from the `wl_shm_pool_ptr` at given
- * dimensions and page number, and stores all into `buffer_ptr`.
+ * Picks a released buffer to draw into, and grows the pool if there is none.
+ *
+ * Prefers the most recently drawn buffer: It is the most likely to still be
+ * in cache, and it lets a third buffer go idle once the compositor keeps up.
+ *
+ * @param dblbuf_ptr
+ *
+ * @return The buffer, or NULL if none is available.
+ */
+struct wlmcl_buffer *_wlcl_dblbuf_acquire(wlmcl_dblbuf_t *dblbuf_ptr)
+{
+    struct wlmcl_buffer *buffer_ptr = NULL;
+    for (unsigned i = 0; i < dblbuf_ptr->buffers_num; ++i) {
+        struct wlmcl_buffer *b_ptr = &dblbuf_ptr->buffers[i];
+        if (!b_ptr->released) continue;
+        if (NULL == buffer_ptr || b_ptr->sequence > buffer_ptr->sequence) {
+            buffer_ptr = b_ptr;
+        }
+    }
+    if (NULL != buffer_ptr) return buffer_ptr;
+
+    if (dblbuf_ptr->buffers_num >= _WLCL_DBLBUF_MAX ||
+        !_wlcl_dblbuf_grow(dblbuf_ptr)) return NULL;
+    return &dblbuf_ptr->buffers[dblbuf_ptr->buffers_num - 1];
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Adds one more buffer to the pool, growing the shared memory as needed.
+ *
+ * @param dblbuf_ptr
+ *
+ * @return true on success.
+ */
+bool _wlcl_dblbuf_grow(wlmcl_dblbuf_t *dblbuf_ptr)
+{
+    unsigned page = dblbuf_ptr->buffers_num;
+    size_t page_size = _wlcl_dblbuf_page_size(
+        dblbuf_ptr->width, dblbuf_ptr->height);
+    size_t offset = dblbuf_ptr->base_offset + page * page_size;
+    if (!_wlcl_dblbuf_reserve(dblbuf_ptr, offset + page_size)) return false;
+
+    if (!_wlcl_dblbuf_create_buffer(
+            &dblbuf_ptr->buffers[page], dblbuf_ptr, offset)) {
+        _wlcl_dblbuf_destroy_buffer(&dblbuf_ptr->buffers[page]);
+        return false;
+    }
+    dblbuf_ptr->buffers_num++;
+    dblbuf_ptr->stats.reallocations++;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Ensures the shared memory pool holds at least `size` bytes.
+ *
+ * Grows the shared memory object, the mapping and the `wl_shm_pool` in
+ * place. The pool cannot shrink, so it is left as-is if already large enough.
+ * If the mapping moves, the pixel buffers of all buffers are re-created.
+ *
+ * @param dblbuf_ptr
+ * @param size
+ *
+ * @return true on success.
+ */
+bool _wlcl_dblbuf_reserve(wlmcl_dblbuf_t *dblbuf_ptr, size_t size)
+{
+    if (size <= dblbuf_ptr->data_size) return true;
+    if (size > INT32_MAX) {
+        bs_log(BS_ERROR, "Pool size %zu exceeds INT32_MAX", size);
+        return false;
+    }
+
+    while (0 != ftruncate(dblbuf_ptr->fd, size)) {
+        if (EINTR == errno) continue;  // try again...
+        bs_log(BS_ERROR | BS_ERRNO, "Failed ftruncate(%d, %zu)",
+               dblbuf_ptr->fd, size);
+        return false;
+    }
+
+    void *data_ptr = mremap(
+        dblbuf_ptr->data_ptr, dblbuf_ptr->data_size, size, MREMAP_MAYMOVE);
+    if (MAP_FAILED == data_ptr) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed mremap(%p, %zu, %zu, "
+               "MREMAP_MAYMOVE)", dblbuf_ptr->data_ptr,
+               dblbuf_ptr->data_size, size);
+        return false;
+    }
+    bool moved = data_ptr != dblbuf_ptr->data_ptr;
+    dblbuf_ptr->data_ptr = data_ptr;
+    dblbuf_ptr->data_size = size;
+
+    wl_shm_pool_resize(dblbuf_ptr->wl_shm_pool_ptr, size);
+    dblbuf_ptr->stats.pool_resizes++;
+
+    if (!moved) return true;
+    for (unsigned i = 0; i < dblbuf_ptr->buffers_num; ++i) {
+        struct wlmcl_buffer *buffer_ptr = &dblbuf_ptr->buffers[i];
+        if (NULL == buffer_ptr->gfxbuf_ptr) continue;
+        bs_gfxbuf_destroy(buffer_ptr->gfxbuf_ptr);
+        if (!_wlcl_dblbuf_create_gfxbuf(buffer_ptr)) return false;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** @return Size of one page, ie. one ARGB32 buffer, in bytes. */
+size_t _wlcl_dblbuf_page_size(unsigned width, unsigned height)
+{
+    return (size_t)width * height * sizeof(uint32_t);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Helper: Creates a `struct wl_buffer` from @ref wlmcl_dblbuf_t::wl_shm_pool_ptr
+ * at the current dimensions and given offset, and stores all into
+ * `buffer_ptr`. The buffer starts out as released.
  *
  * @param buffer_ptr
  * @param dblbuf_ptr
- * @param wl_shm_pool_ptr
- * @param page
- * @param width
- * @param height
+ * @param offset              Offset of the page in the pool, in bytes.
  *
  * @return true on success.
  */
 bool _wlcl_dblbuf_create_buffer(
     struct wlmcl_buffer *buffer_ptr,
     wlmcl_dblbuf_t *dblbuf_ptr,
-    struct wl_shm_pool *wl_shm_pool_ptr,
-    unsigned page,
-    unsigned width,
-    unsigned height)
+    size_t offset)
 {
+    unsigned width = dblbuf_ptr->width;
+    unsigned height = dblbuf_ptr->height;
+
     buffer_ptr->dblbuf_ptr = dblbuf_ptr;
+    buffer_ptr->offset = offset;
+    buffer_ptr->size = _wlcl_dblbuf_page_size(width, height);
+    buffer_ptr->sequence = 0;
     buffer_ptr->wl_buffer_ptr = wl_shm_pool_create_buffer(
-        wl_shm_pool_ptr,
-        page * width * height * sizeof(uint32_t),
+        dblbuf_ptr->wl_shm_pool_ptr,
+        offset,
         width,
         height,
         width * sizeof(uint32_t),
@@ -304,26 +578,83 @@ bool _wlcl_dblbuf_create_buffer(
     if (NULL == buffer_ptr->wl_buffer_ptr) {
         bs_log(BS_ERROR, "Failed wl_shm_pool_create_buffer(%p, %zu, %u, %u, "
                "%zu, WL_SHM_FORMAT_ARGB8888)",
-               wl_shm_pool_ptr,
-               page * width * height * sizeof(uint32_t),
+               dblbuf_ptr->wl_shm_pool_ptr,
+               offset,
                width,
                height,
                width * sizeof(uint32_t));
         return false;
     }
 
-    buffer_ptr->gfxbuf_ptr = bs_gfxbuf_create_unmanaged(
-        width, height, width,
-        (uint32_t*)dblbuf_ptr->data_ptr + page * width * height);
-    if (NULL == buffer_ptr->gfxbuf_ptr) return false;
+    if (!_wlcl_dblbuf_create_gfxbuf(buffer_ptr)) return false;
 
     wl_buffer_add_listener(
         buffer_ptr->wl_buffer_ptr,
         &_wlcl_dblbuf_wl_buffer_listener,
         buffer_ptr);
+    buffer_ptr->released = true;
     return true;
 }
 
+/* ------------------------------------------------------------------------- */
+/** Helper: Destroys the `wl_buffer` and pixel buffer of `buffer_ptr`. */
+void _wlcl_dblbuf_destroy_buffer(struct wlmcl_buffer *buffer_ptr)
+{
+    if (NULL != buffer_ptr->wl_buffer_ptr) {
+        wl_buffer_destroy(buffer_ptr->wl_buffer_ptr);
+        buffer_ptr->wl_buffer_ptr = NULL;
+    }
+    if (NULL != buffer_ptr->gfxbuf_ptr) {
+        bs_gfxbuf_destroy(buffer_ptr->gfxbuf_ptr);
+        buffer_ptr->gfxbuf_ptr = NULL;
+    }
+    buffer_ptr->released = false;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Helper: Moves the `wl_buffer` of `buffer_ptr`, still held by the compositor,
+ * to @ref wlmcl_dblbuf_t::retired. It is destroyed once released. If that
+ * fails, `buffer_ptr` is left as-is.
+ *
+ * @param buffer_ptr
+ */
+void _wlcl_dblbuf_retire_buffer(struct wlmcl_buffer *buffer_ptr)
+{
+    struct wlmcl_buffer *retired_ptr = logged_calloc(
+        1, sizeof(struct wlmcl_buffer));
+    if (NULL == retired_ptr) return;
+    retired_ptr->wl_buffer_ptr = buffer_ptr->wl_buffer_ptr;
+    retired_ptr->dblbuf_ptr = buffer_ptr->dblbuf_ptr;
+    retired_ptr->offset = buffer_ptr->offset;
+    retired_ptr->size = buffer_ptr->size;
+    retired_ptr->retired = true;
+    wl_buffer_set_user_data(retired_ptr->wl_buffer_ptr, retired_ptr);
+    bs_dllist_push_back(&retired_ptr->dblbuf_ptr->retired,
+                        &retired_ptr->dlnode);
+    buffer_ptr->wl_buffer_ptr = NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Helper: Creates the unmanaged pixel buffer for `buffer_ptr`, pointing to
+ * its page within @ref wlmcl_dblbuf_t::data_ptr.
+ *
+ * @param buffer_ptr
+ *
+ * @return true on success.
+ */
+bool _wlcl_dblbuf_create_gfxbuf(struct wlmcl_buffer *buffer_ptr)
+{
+    wlmcl_dblbuf_t *dblbuf_ptr = buffer_ptr->dblbuf_ptr;
+    unsigned width = dblbuf_ptr->width;
+    unsigned height = dblbuf_ptr->height;
+    buffer_ptr->gfxbuf_ptr = bs_gfxbuf_create_unmanaged(
+        width, height, width,
+        (uint32_t*)((uint8_t*)dblbuf_ptr->data_ptr + buffer_ptr->offset));
+    return NULL != buffer_ptr->gfxbuf_ptr;
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Handles the `release` notification of the wl_buffer interface.
@@ -337,10 +668,18 @@ static void _wlcl_dblbuf_handle_wl_buffer_release(
 {
     struct wlmcl_buffer *buffer_ptr = data_ptr;
     BS_ASSERT(buffer_ptr->wl_buffer_ptr == wl_buffer_ptr);
-    wlmcl_dblbuf_t *dblbuf_ptr = buffer_ptr->dblbuf_ptr;
-    dblbuf_ptr->released_buffer_ptrs[dblbuf_ptr->released++] = buffer_ptr;
 
-    _wlcl_dblbuf_callback_if_ready(dblbuf_ptr);
+    // Retired on resize: No longer needed, once released.
+    if (buffer_ptr->retired) {
+        bs_dllist_remove(&buffer_ptr->dblbuf_ptr->retired, &buffer_ptr->dlnode);
+        _wlcl_dblbuf_destroy_buffer(buffer_ptr);
+        free(buffer_ptr);
+        return;
+    }
+
+    buffer_ptr->released = true;
+
+    _wlcl_dblbuf_callback_if_ready(buffer_ptr->dblbuf_ptr);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -388,4 +727,139 @@ int _wlcl_dblbuf_shm_create(const char *app_id_ptr, size_t size)
     return fd;
 }
 
+/* == Unit tests =========================================================== */
+
+static void _wlmcl_dblbuf_test_pool(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlmcl_dblbuf_test_cases[] = {
+    { true, "pool", _wlmcl_dblbuf_test_pool },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmcl_dblbuf_test_set = BS_TEST_SET(
+    true, "dblbuf", _wlmcl_dblbuf_test_cases);
+
+/* ------------------------------------------------------------------------- */
+/** Implements @ref wlmcl_dblbuf_ready_callback_t: Counts the calls. */
+static bool _wlmcl_dblbuf_test_draw(
+    __UNUSED__ bs_gfxbuf_t *gfxbuf_ptr,
+    void *ud_ptr)
+{
+    int *calls_ptr = ud_ptr;
+    ++*calls_ptr;
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Emulates the compositor sending `done` for the pending frame callback. */
+static void _wlmcl_dblbuf_test_frame_done(wlmcl_dblbuf_t *dblbuf_ptr)
+{
+    _wlcl_dblbuf_handle_frame_done(
+        dblbuf_ptr, dblbuf_ptr->wl_callback_ptr, 0);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Emulates the compositor sending `release` for `wl_buffer_ptr`. */
+static void _wlmcl_dblbuf_test_release(struct wl_buffer *wl_buffer_ptr)
+{
+    _wlcl_dblbuf_handle_wl_buffer_release(
+        wl_buffer_get_user_data(wl_buffer_ptr), wl_buffer_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Exercises the pool: Growth when the compositor holds all buffers, dropped
+ * frames, and a resize while buffers are held.
+ *
+ * Uses a client connection without a compositor: Requests are queued but not
+ * read, and the compositor's events are emulated by calling the handlers.
+ */
+void _wlmcl_dblbuf_test_pool(bs_test_t *test_ptr)
+{
+    int fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0, socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds));
+    struct wl_display *wl_display_ptr = wl_display_connect_to_fd(fds[0]);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wl_display_ptr);
+    struct wl_registry *wl_registry_ptr = wl_display_get_registry(
+        wl_display_ptr);
+    struct wl_shm *wl_shm_ptr = wl_registry_bind(
+        wl_registry_ptr, 1, &wl_shm_interface, 1);
+    struct wl_surface *wl_surface_ptr = wl_registry_bind(
+        wl_registry_ptr, 2, &wl_surface_interface, 4);
+
+    wlmcl_dblbuf_t *dblbuf_ptr = wlmcl_dblbuf_create(
+        "test", wl_surface_ptr, wl_shm_ptr, 16, 8);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, dblbuf_ptr);
+    const wlmcl_dblbuf_stats_t *stats_ptr = wlmcl_dblbuf_stats(dblbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, stats_ptr->buffers);
+    int calls = 0;
+
+    // Two frames: The compositor holds on to both buffers.
+    wlmcl_dblbuf_register_ready_callback(
+        dblbuf_ptr, _wlmcl_dblbuf_test_draw, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, calls);
+    _wlmcl_dblbuf_test_frame_done(dblbuf_ptr);
+    wlmcl_dblbuf_register_ready_callback(
+        dblbuf_ptr, _wlmcl_dblbuf_test_draw, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, calls);
+    struct wl_buffer *first_ptr = dblbuf_ptr->buffers[0].wl_buffer_ptr;
+
+    // The third frame adds a third buffer.
+    _wlmcl_dblbuf_test_frame_done(dblbuf_ptr);
+    wlmcl_dblbuf_register_ready_callback(
+        dblbuf_ptr, _wlmcl_dblbuf_test_draw, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, calls);
+    stats_ptr = wlmcl_dblbuf_stats(dblbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats_ptr->buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->reallocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->pool_resizes);
+
+    // All three held: The next frame is dropped, and drawn once released.
+    _wlmcl_dblbuf_test_frame_done(dblbuf_ptr);
+    wlmcl_dblbuf_register_ready_callback(
+        dblbuf_ptr, _wlmcl_dblbuf_test_draw, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->dropped_frames);
+    _wlmcl_dblbuf_test_release(first_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, stats_ptr->frames);
+
+    // Resizing while the compositor holds all three: These are retired, and
+    // the new buffers are placed after them.
+    struct wl_buffer *held[3];
+    for (int i = 0; i < 3; ++i) held[i] = dblbuf_ptr->buffers[i].wl_buffer_ptr;
+    BS_TEST_VERIFY_TRUE(test_ptr, wlmcl_dblbuf_resize(dblbuf_ptr, 32, 16));
+    stats_ptr = wlmcl_dblbuf_stats(dblbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats_ptr->retired_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, stats_ptr->buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 4, stats_ptr->reallocations);
+    BS_TEST_VERIFY_EQ(test_ptr, 3 * 16 * 8 * 4, dblbuf_ptr->base_offset);
+    BS_TEST_VERIFY_EQ(
+        test_ptr, (3 * 16 * 8 + 3 * 32 * 16) * 4, dblbuf_ptr->data_size);
+    for (int i = 0; i < 3; ++i) {
+        BS_TEST_VERIFY_NEQ(
+            test_ptr, held[i], dblbuf_ptr->buffers[i].wl_buffer_ptr);
+    }
+
+    // The new buffers are drawn into right away. Retired ones are destroyed
+    // once released.
+    wlmcl_dblbuf_register_ready_callback(
+        dblbuf_ptr, _wlmcl_dblbuf_test_draw, &calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, calls);
+    for (int i = 0; i < 3; ++i) _wlmcl_dblbuf_test_release(held[i]);
+    stats_ptr = wlmcl_dblbuf_stats(dblbuf_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, stats_ptr->retired_buffers);
+    BS_TEST_VERIFY_EQ(test_ptr, 5, stats_ptr->frames);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, stats_ptr->dropped_frames);
+
+    wlmcl_dblbuf_destroy(dblbuf_ptr);
+    wl_surface_destroy(wl_surface_ptr);
+    wl_shm_destroy(wl_shm_ptr);
+    wl_registry_destroy(wl_registry_ptr);
+    wl_display_disconnect(wl_display_ptr);
+    close(fds[1]);
+}
+
 /* == End of dblbuf.c ====================================================== */
@@ -23,6 +23,7 @@
 #ifndef __WLMAKER_WLCLIENT_DBLBUF_H__
 #define __WLMAKER_WLCLIENT_DBLBUF_H__
 
+#include <inttypes.h>
 #include <libbase/libbase.h>
 #include <stdbool.h>
 
@@ -36,6 +37,26 @@ struct wl_surface;
 /** Forward declaration: Double buffer state. */
 typedef struct _wlmcl_dblbuf_t wlmcl_dblbuf_t;
 
+/** Counters of a @ref wlmcl_dblbuf_t, see @ref wlmcl_dblbuf_stats. */
+typedef struct {
+    /** Frames that were drawn and committed. */
+    uint64_t                  frames;
+    /**
+     * Frames that were due, with a callback pending, but could not be drawn
+     * because the compositor held all buffers, and no further buffer could
+     * be added.
+     */
+    uint64_t                  dropped_frames;
+    /** Buffers (re)created after the initial ones, on growth or resize. */
+    uint64_t                  reallocations;
+    /** Times the shared memory pool had to be grown. */
+    uint64_t                  pool_resizes;
+    /** Number of buffers currently in the pool. */
+    unsigned                  buffers;
+    /** Buffers of previous dimensions, still held by the compositor. */
+    unsigned                  retired_buffers;
+} wlmcl_dblbuf_stats_t;
+
 /** Callback that indicates the buffer is ready to draw into. */
 typedef bool (*wlmcl_dblbuf_ready_callback_t)(
     bs_gfxbuf_t *gfxbuf_ptr,
@@ -44,6 +65,10 @@ typedef bool (*wlmcl_dblbuf_ready_callback_t)(
 /**
  * Creates a double buffer for the surface with provided dimensions.
  *
+ * Starts out with two buffers in a single shared memory pool. If a frame is
+ * due while the compositor holds both, a third buffer is added to the pool
+ * instead of delaying the frame.
+ *
  * @param app_id_ptr          Application ID, used to prefix the name of the
  *                            shared memory object. Can be NULL.
  * @param wl_surface_ptr
@@ -64,6 +89,26 @@ wlmcl_dblbuf_t *wlmcl_dblbuf_create(
 /** Destroys the double buffer. */
 void wlmcl_dblbuf_destroy(wlmcl_dblbuf_t *dblbuf_ptr);
 
+/**
+ * Resizes the buffers to the new dimensions, eg. on `configure`.
+ *
+ * Keeps the shared memory object and pool. These are grown in place if
+ * needed (and never shrunk), and only the `wl_buffer`s are re-created. Those
+ * still held by the compositor are kept, until released. The next frame is
+ * due right away.
+ *
+ * @param dblbuf_ptr
+ * @param width
+ * @param height
+ *
+ * @return true on success. On failure, the double buffer cannot be used any
+ *     further and should be destroyed.
+ */
+bool wlmcl_dblbuf_resize(
+    wlmcl_dblbuf_t *dblbuf_ptr,
+    unsigned width,
+    unsigned height);
+
 /**
  * Registers a callback for when a frame can be drawn into the buffer.
  *
@@ -89,6 +134,50 @@ void wlmcl_dblbuf_register_ready_callback(
     wlmcl_dblbuf_ready_callback_t callback,
     void *callback_ud_ptr);
 
+/**
+ * Returns the age of the buffer being drawn into. Must only be called from
+ * within the @ref wlmcl_dblbuf_ready_callback_t.
+ *
+ * @param dblbuf_ptr
+ *
+ * @return 0 if the buffer's contents are undefined. Otherwise, the number of
+ *     frames since the buffer was drawn: 1 if it holds the previous frame,
+ *     2 for the one before, and so on.
+ */
+unsigned wlmcl_dblbuf_age(wlmcl_dblbuf_t *dblbuf_ptr);
+
+/**
+ * Marks an area of the buffer being drawn into as damaged, relative to the
+ * previous frame. Must only be called from within the
+ * @ref wlmcl_dblbuf_ready_callback_t.
+ *
+ * If not called during the callback, the whole buffer is damaged.
+ *
+ * @param dblbuf_ptr
+ * @param x
+ * @param y
+ * @param width
+ * @param height
+ */
+void wlmcl_dblbuf_damage(
+    wlmcl_dblbuf_t *dblbuf_ptr,
+    int x,
+    int y,
+    int width,
+    int height);
+
+/**
+ * Returns counters for the double buffer.
+ *
+ * @param dblbuf_ptr
+ *
+ * @return Pointer to the counters. Valid until the double buffer is destroyed.
+ */
+const wlmcl_dblbuf_stats_t *wlmcl_dblbuf_stats(wlmcl_dblbuf_t *dblbuf_ptr);
+
+/** Unit test set. */
+extern const bs_test_set_t wlmcl_dblbuf_test_set;
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,390 @@
+/* ========================================================================= */
+/**
+ * @file fd_watch.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "fd_watch.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/inotify.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/* == Declarations ========================================================= */
+
+/** Maximum number of events to retrieve per call to epoll_wait(). */
+#define WLMCL_FD_WATCHER_MAX_EVENTS 16
+
+/** State of the watcher. */
+struct _wlmcl_fd_watcher_t {
+    /** The epoll file descriptor. */
+    int                       epoll_fd;
+    /** Registered watches. Elements are @ref wlmcl_fd_watch_t::dlnode. */
+    bs_dllist_t               watches;
+    /** Whether @ref wlmcl_fd_watcher_dispatch is currently running. */
+    bool                      dispatching;
+    /** Whether any watch was removed while dispatching. */
+    bool                      has_removed;
+};
+
+/** State of a watch. */
+struct _wlmcl_fd_watch_t {
+    /** Element of @ref wlmcl_fd_watcher_t::watches. */
+    bs_dllist_node_t          dlnode;
+    /** The watched file descriptor. */
+    int                       fd;
+    /** Callback. May be NULL. */
+    wlmcl_fd_watch_callback_t callback;
+    /** Argument to @ref wlmcl_fd_watch_t::callback. */
+    void                      *callback_ud_ptr;
+    /** Events reported from the last wait, and not yet dispatched. */
+    uint32_t                  revents;
+    /** Whether the watch was removed while dispatching. Freed thereafter. */
+    bool                      removed;
+};
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmcl_fd_watcher_t *wlmcl_fd_watcher_create(void)
+{
+    wlmcl_fd_watcher_t *watcher_ptr = logged_calloc(
+        1, sizeof(wlmcl_fd_watcher_t));
+    if (NULL == watcher_ptr) return NULL;
+
+    watcher_ptr->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (0 > watcher_ptr->epoll_fd) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed epoll_create1(EPOLL_CLOEXEC)");
+        wlmcl_fd_watcher_destroy(watcher_ptr);
+        return NULL;
+    }
+    return watcher_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_fd_watcher_destroy(wlmcl_fd_watcher_t *watcher_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&watcher_ptr->watches))) {
+        free(BS_CONTAINER_OF(dlnode_ptr, wlmcl_fd_watch_t, dlnode));
+    }
+
+    if (0 <= watcher_ptr->epoll_fd) {
+        close(watcher_ptr->epoll_fd);
+        watcher_ptr->epoll_fd = -1;
+    }
+    free(watcher_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmcl_fd_watch_t *wlmcl_fd_watcher_add(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    int fd,
+    uint32_t events,
+    wlmcl_fd_watch_callback_t callback,
+    void *callback_ud_ptr)
+{
+    wlmcl_fd_watch_t *watch_ptr = logged_calloc(1, sizeof(wlmcl_fd_watch_t));
+    if (NULL == watch_ptr) return NULL;
+    watch_ptr->fd = fd;
+    watch_ptr->callback = callback;
+    watch_ptr->callback_ud_ptr = callback_ud_ptr;
+
+    struct epoll_event event = { .events = events, .data.ptr = watch_ptr };
+    if (0 != epoll_ctl(watcher_ptr->epoll_fd, EPOLL_CTL_ADD, fd, &event)) {
+        bs_log(BS_ERROR | BS_ERRNO, "Failed epoll_ctl(%d, EPOLL_CTL_ADD, %d, "
+               "{ 0x%"PRIx32", %p })",
+               watcher_ptr->epoll_fd, fd, events, watch_ptr);
+        free(watch_ptr);
+        return NULL;
+    }
+
+    bs_dllist_push_back(&watcher_ptr->watches, &watch_ptr->dlnode);
+    return watch_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_fd_watcher_remove(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    wlmcl_fd_watch_t *watch_ptr)
+{
+    if (0 != epoll_ctl(watcher_ptr->epoll_fd, EPOLL_CTL_DEL,
+                       watch_ptr->fd, NULL)) {
+        // The fd may have been closed already. That also removes it.
+        bs_log(BS_DEBUG | BS_ERRNO, "Failed epoll_ctl(%d, EPOLL_CTL_DEL, %d, "
+               "NULL)", watcher_ptr->epoll_fd, watch_ptr->fd);
+    }
+
+    // While dispatching, the watch may be referenced by the iteration.
+    if (watcher_ptr->dispatching) {
+        watch_ptr->removed = true;
+        watch_ptr->revents = 0;
+        watcher_ptr->has_removed = true;
+        return;
+    }
+    bs_dllist_remove(&watcher_ptr->watches, &watch_ptr->dlnode);
+    free(watch_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+int wlmcl_fd_watcher_wait(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    int timeout_msec)
+{
+    struct epoll_event events[WLMCL_FD_WATCHER_MAX_EVENTS];
+    int rv = epoll_wait(watcher_ptr->epoll_fd, &events[0],
+                        WLMCL_FD_WATCHER_MAX_EVENTS, timeout_msec);
+    if (0 > rv) {
+        if (EINTR == errno) return 0;
+        bs_log(BS_ERROR | BS_ERRNO, "Failed epoll_wait(%d, %p, %d, %d)",
+               watcher_ptr->epoll_fd, &events[0],
+               WLMCL_FD_WATCHER_MAX_EVENTS, timeout_msec);
+        return -1;
+    }
+
+    for (int i = 0; i < rv; ++i) {
+        wlmcl_fd_watch_t *watch_ptr = events[i].data.ptr;
+        watch_ptr->revents |= events[i].events;
+    }
+    return rv;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_fd_watcher_dispatch(wlmcl_fd_watcher_t *watcher_ptr)
+{
+    watcher_ptr->dispatching = true;
+    for (bs_dllist_node_t *dlnode_ptr = watcher_ptr->watches.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmcl_fd_watch_t *watch_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_fd_watch_t, dlnode);
+        if (watch_ptr->removed || 0 == watch_ptr->revents) continue;
+
+        uint32_t revents = watch_ptr->revents;
+        watch_ptr->revents = 0;
+        if (NULL != watch_ptr->callback) {
+            watch_ptr->callback(
+                watch_ptr->fd, revents, watch_ptr->callback_ud_ptr);
+        }
+    }
+    watcher_ptr->dispatching = false;
+
+    if (!watcher_ptr->has_removed) return;
+    bs_dllist_node_t *dlnode_ptr = watcher_ptr->watches.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmcl_fd_watch_t *watch_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_fd_watch_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+        if (!watch_ptr->removed) continue;
+        bs_dllist_remove(&watcher_ptr->watches, &watch_ptr->dlnode);
+        free(watch_ptr);
+    }
+    watcher_ptr->has_removed = false;
+}
+
+/* ------------------------------------------------------------------------- */
+uint32_t wlmcl_fd_watch_revents(wlmcl_fd_watch_t *watch_ptr)
+{
+    return watch_ptr->revents;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmcl_fd_watch_test_socket(bs_test_t *test_ptr);
+static void _wlmcl_fd_watch_test_remove(bs_test_t *test_ptr);
+static void _wlmcl_fd_watch_test_inotify(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlmcl_fd_watch_test_cases[] = {
+    { true, "socket", _wlmcl_fd_watch_test_socket },
+    { true, "remove", _wlmcl_fd_watch_test_remove },
+    { true, "inotify", _wlmcl_fd_watch_test_inotify },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmcl_fd_watch_test_set = BS_TEST_SET(
+    true, "fd_watch", _wlmcl_fd_watch_test_cases);
+
+/** Test helper: Counts calls, and stores the most recent events. */
+typedef struct {
+    /** Number of calls. */
+    int                       calls;
+    /** Events of the most recent call. */
+    uint32_t                  events;
+    /** If set: Removes this watch when called. */
+    wlmcl_fd_watch_t          *remove_watch_ptr;
+    /** Watcher, for removing @ref _wlmcl_fd_watch_test_arg_t::remove_watch_ptr. */
+    wlmcl_fd_watcher_t        *watcher_ptr;
+} _wlmcl_fd_watch_test_arg_t;
+
+/** Test callback: Records the call into @ref _wlmcl_fd_watch_test_arg_t. */
+static void _wlmcl_fd_watch_test_callback(
+    int fd,
+    uint32_t events,
+    void *ud_ptr)
+{
+    _wlmcl_fd_watch_test_arg_t *arg_ptr = ud_ptr;
+    arg_ptr->calls++;
+    arg_ptr->events = events;
+
+    // Drains the descriptor, for level-triggered watches to calm down.
+    char buf[64];
+    while (0 < read(fd, buf, sizeof(buf))) {}
+
+    if (NULL != arg_ptr->remove_watch_ptr) {
+        wlmcl_fd_watcher_remove(arg_ptr->watcher_ptr, arg_ptr->remove_watch_ptr);
+        arg_ptr->remove_watch_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Watches a local socket, and verifies events are dispatched. */
+void _wlmcl_fd_watch_test_socket(bs_test_t *test_ptr)
+{
+    int fds[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0,
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds));
+    wlmcl_fd_watcher_t *w = wlmcl_fd_watcher_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+
+    _wlmcl_fd_watch_test_arg_t arg = {};
+    wlmcl_fd_watch_t *watch_ptr = wlmcl_fd_watcher_add(
+        w, fds[0], EPOLLIN, _wlmcl_fd_watch_test_callback, &arg);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, watch_ptr);
+
+    // Nothing to read: Times out.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmcl_fd_watcher_wait(w, 0));
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, arg.calls);
+
+    // Data: Events are stored, but only dispatched on request.
+    BS_TEST_VERIFY_EQ(test_ptr, 1, write(fds[1], "x", 1));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_fd_watcher_wait(w, 100));
+    BS_TEST_VERIFY_EQ(test_ptr, EPOLLIN, wlmcl_fd_watch_revents(watch_ptr));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, arg.calls);
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, arg.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, EPOLLIN, arg.events);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmcl_fd_watch_revents(watch_ptr));
+
+    // Peer hangs up.
+    close(fds[1]);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_fd_watcher_wait(w, 100));
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, arg.calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, arg.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP));
+
+    wlmcl_fd_watcher_remove(w, watch_ptr);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmcl_fd_watcher_wait(w, 0));
+    wlmcl_fd_watcher_destroy(w);
+    close(fds[0]);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Removes watches from within a callback. */
+void _wlmcl_fd_watch_test_remove(bs_test_t *test_ptr)
+{
+    int fds1[2], fds2[2];
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0,
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds1));
+    BS_TEST_VERIFY_EQ_OR_RETURN(
+        test_ptr, 0,
+        socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, fds2));
+    wlmcl_fd_watcher_t *w = wlmcl_fd_watcher_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+
+    _wlmcl_fd_watch_test_arg_t arg1 = { .watcher_ptr = w };
+    _wlmcl_fd_watch_test_arg_t arg2 = {};
+    wlmcl_fd_watch_t *watch1_ptr = wlmcl_fd_watcher_add(
+        w, fds1[0], EPOLLIN, _wlmcl_fd_watch_test_callback, &arg1);
+    wlmcl_fd_watch_t *watch2_ptr = wlmcl_fd_watcher_add(
+        w, fds2[0], EPOLLIN, _wlmcl_fd_watch_test_callback, &arg2);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, watch1_ptr);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, watch2_ptr);
+
+    // The first callback removes the second watch, with events pending.
+    arg1.remove_watch_ptr = watch2_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, 1, write(fds1[1], "x", 1));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, write(fds2[1], "x", 1));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmcl_fd_watcher_wait(w, 100));
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, arg1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, arg2.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, bs_dllist_size(&w->watches));
+
+    // Removes itself.
+    arg1.remove_watch_ptr = watch1_ptr;
+    BS_TEST_VERIFY_EQ(test_ptr, 1, write(fds1[1], "x", 1));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_fd_watcher_wait(w, 100));
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, arg1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, bs_dllist_size(&w->watches));
+
+    wlmcl_fd_watcher_destroy(w);
+    close(fds1[0]);
+    close(fds1[1]);
+    close(fds2[0]);
+    close(fds2[1]);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Watches a fake sysfs tree through inotify. */
+void _wlmcl_fd_watch_test_inotify(bs_test_t *test_ptr)
+{
+    char dir[] = "/tmp/wlmcl_fd_watch_test_XXXXXX";
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, mkdtemp(dir));
+    char *fname_ptr = bs_strdupf("%s/capacity", dir);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, fname_ptr);
+
+    int ifd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    BS_TEST_VERIFY_TRUE_OR_RETURN(test_ptr, 0 <= ifd);
+    BS_TEST_VERIFY_TRUE(
+        test_ptr, 0 <= inotify_add_watch(ifd, dir, IN_CLOSE_WRITE));
+
+    wlmcl_fd_watcher_t *w = wlmcl_fd_watcher_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, w);
+    _wlmcl_fd_watch_test_arg_t arg = {};
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        wlmcl_fd_watcher_add(w, ifd, EPOLLIN, _wlmcl_fd_watch_test_callback,
+                             &arg));
+
+    FILE *f = fopen(fname_ptr, "w");
+    BS_TEST_VERIFY_NEQ(test_ptr, NULL, f);
+    if (NULL != f) {
+        fputs("42\n", f);
+        fclose(f);
+    }
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_fd_watcher_wait(w, 1000));
+    wlmcl_fd_watcher_dispatch(w);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, arg.calls);
+
+    wlmcl_fd_watcher_destroy(w);
+    close(ifd);
+    unlink(fname_ptr);
+    free(fname_ptr);
+    rmdir(dir);
+}
+
+/* == End of fd_watch.c ==================================================== */
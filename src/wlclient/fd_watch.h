@@ -0,0 +1,147 @@
+/* ========================================================================= */
+/**
+ * @file fd_watch.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_WLCLIENT_FD_WATCH_H__
+#define __WLMAKER_WLCLIENT_FD_WATCH_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include <libbase/libbase.h>
+
+/** Forward declaration: A set of watched file descriptors. */
+typedef struct _wlmcl_fd_watcher_t wlmcl_fd_watcher_t;
+/** Forward declaration: A watch on one file descriptor. */
+typedef struct _wlmcl_fd_watch_t wlmcl_fd_watch_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Callback for when a watched file descriptor has events.
+ *
+ * @param fd                  The file descriptor.
+ * @param events              Events reported for `fd`, as `EPOLLIN` etc.
+ * @param ud_ptr              As given to @ref wlmcl_fd_watcher_add.
+ */
+typedef void (*wlmcl_fd_watch_callback_t)(
+    int fd,
+    uint32_t events,
+    void *ud_ptr);
+
+/**
+ * Creates a watcher, backed by epoll.
+ *
+ * @return The watcher, or NULL on error. Must be destroyed by calling
+ *     @ref wlmcl_fd_watcher_destroy.
+ */
+wlmcl_fd_watcher_t *wlmcl_fd_watcher_create(void);
+
+/**
+ * Destroys the watcher, and all watches still registered with it.
+ *
+ * The watched file descriptors are not closed.
+ *
+ * @param watcher_ptr
+ */
+void wlmcl_fd_watcher_destroy(wlmcl_fd_watcher_t *watcher_ptr);
+
+/**
+ * Adds a watch for `fd`.
+ *
+ * The file descriptor must be pollable, eg. a socket, pipe, inotify or
+ * netlink file descriptor. Regular files are not supported by epoll.
+ *
+ * @param watcher_ptr
+ * @param fd
+ * @param events              Events to watch for, eg. `EPOLLIN`.
+ * @param callback            Callback for when `fd` has events. May be NULL,
+ *                            in which case @ref wlmcl_fd_watch_revents must be
+ *                            used to query events after @ref
+ *                            wlmcl_fd_watcher_wait.
+ * @param callback_ud_ptr
+ *
+ * @return The watch, or NULL on error. It is owned by the watcher, and may be
+ *     removed through @ref wlmcl_fd_watcher_remove.
+ */
+wlmcl_fd_watch_t *wlmcl_fd_watcher_add(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    int fd,
+    uint32_t events,
+    wlmcl_fd_watch_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Removes and destroys the watch.
+ *
+ * It is safe to call this from within any watch's callback.
+ *
+ * @param watcher_ptr
+ * @param watch_ptr
+ */
+void wlmcl_fd_watcher_remove(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    wlmcl_fd_watch_t *watch_ptr);
+
+/**
+ * Waits for events on any of the watched file descriptors.
+ *
+ * Events are stored with each watch, but callbacks are not invoked yet: This
+ * permits the caller to handle some descriptors (eg. the Wayland display)
+ * before any callback is dispatched. See @ref wlmcl_fd_watcher_dispatch.
+ *
+ * @param watcher_ptr
+ * @param timeout_msec        Timeout, in milliseconds. -1 to block.
+ *
+ * @return Number of file descriptors with events, or -1 on error. EINTR is
+ *     not considered an error, and reported as 0.
+ */
+int wlmcl_fd_watcher_wait(
+    wlmcl_fd_watcher_t *watcher_ptr,
+    int timeout_msec);
+
+/**
+ * Invokes the callbacks for all watches that reported events at the last
+ * @ref wlmcl_fd_watcher_wait, and clears the events.
+ *
+ * @param watcher_ptr
+ */
+void wlmcl_fd_watcher_dispatch(wlmcl_fd_watcher_t *watcher_ptr);
+
+/**
+ * Returns the events reported for the watch at the last call to
+ * @ref wlmcl_fd_watcher_wait, and not yet cleared by
+ * @ref wlmcl_fd_watcher_dispatch.
+ *
+ * @param watch_ptr
+ *
+ * @return The events, eg. `EPOLLIN`.
+ */
+uint32_t wlmcl_fd_watch_revents(wlmcl_fd_watch_t *watch_ptr);
+
+/** Unit test set. */
+extern const bs_test_set_t wlmcl_fd_watch_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_WLCLIENT_FD_WATCH_H__ */
+/* == End of fd_watch.h ==================================================== */
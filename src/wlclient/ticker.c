@@ -0,0 +1,362 @@
+/* ========================================================================= */
+/**
+ * @file ticker.c
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ticker.h"
+
+#include <stdlib.h>
+
+/* == Declarations ========================================================= */
+
+/** State of the ticker. */
+struct _wlmcl_ticker_t {
+    /** Slots of the wheel. Elements are @ref wlmcl_ticker_slot_t::dlnode. */
+    bs_dllist_t               slots;
+    /** Whether @ref wlmcl_ticker_dispatch is currently running. */
+    bool                      dispatching;
+    /** Whether any tick was removed while dispatching. */
+    bool                      has_removed;
+};
+
+/** A slot of the wheel: All ticks of one interval. */
+typedef struct {
+    /** Element of @ref wlmcl_ticker_t::slots. */
+    bs_dllist_node_t          dlnode;
+    /** Interval of all ticks in this slot, in microseconds. */
+    uint64_t                  interval_usec;
+    /** When the slot is due next. A multiple of `interval_usec`. */
+    uint64_t                  next_usec;
+    /** Ticks of this slot. Elements are @ref wlmcl_tick_t::dlnode. */
+    bs_dllist_t               ticks;
+} wlmcl_ticker_slot_t;
+
+/** State of a tick. */
+struct _wlmcl_tick_t {
+    /** Element of @ref wlmcl_ticker_slot_t::ticks. */
+    bs_dllist_node_t          dlnode;
+    /** The slot this tick belongs to. */
+    wlmcl_ticker_slot_t       *slot_ptr;
+    /** When the tick is first due. Guards against ticks added in dispatch. */
+    uint64_t                  first_usec;
+    /** Callback. */
+    wlmcl_tick_callback_t     callback;
+    /** Argument to @ref wlmcl_tick_t::callback. */
+    void                      *callback_ud_ptr;
+    /** Whether the tick was removed while dispatching. Freed thereafter. */
+    bool                      removed;
+};
+
+static void _wlmcl_ticker_release(
+    wlmcl_ticker_t *ticker_ptr,
+    wlmcl_tick_t *tick_ptr);
+static uint64_t _wlmcl_ticker_next_multiple(
+    uint64_t interval_usec,
+    uint64_t now_usec);
+
+/* == Exported methods ===================================================== */
+
+/* ------------------------------------------------------------------------- */
+wlmcl_ticker_t *wlmcl_ticker_create(void)
+{
+    return logged_calloc(1, sizeof(wlmcl_ticker_t));
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_ticker_destroy(wlmcl_ticker_t *ticker_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr;
+    while (NULL != (dlnode_ptr = bs_dllist_pop_front(&ticker_ptr->slots))) {
+        wlmcl_ticker_slot_t *slot_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_ticker_slot_t, dlnode);
+        while (NULL != (dlnode_ptr = bs_dllist_pop_front(&slot_ptr->ticks))) {
+            free(BS_CONTAINER_OF(dlnode_ptr, wlmcl_tick_t, dlnode));
+        }
+        free(slot_ptr);
+    }
+    free(ticker_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+wlmcl_tick_t *wlmcl_ticker_add(
+    wlmcl_ticker_t *ticker_ptr,
+    uint64_t interval_usec,
+    uint64_t now_usec,
+    wlmcl_tick_callback_t callback,
+    void *callback_ud_ptr)
+{
+    if (0 == interval_usec) {
+        bs_log(BS_ERROR, "Invalid interval 0 for ticker %p", ticker_ptr);
+        return NULL;
+    }
+
+    wlmcl_ticker_slot_t *slot_ptr = NULL;
+    for (bs_dllist_node_t *dlnode_ptr = ticker_ptr->slots.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmcl_ticker_slot_t *s_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_ticker_slot_t, dlnode);
+        if (s_ptr->interval_usec == interval_usec) {
+            slot_ptr = s_ptr;
+            break;
+        }
+    }
+    if (NULL == slot_ptr) {
+        slot_ptr = logged_calloc(1, sizeof(wlmcl_ticker_slot_t));
+        if (NULL == slot_ptr) return NULL;
+        slot_ptr->interval_usec = interval_usec;
+        slot_ptr->next_usec = _wlmcl_ticker_next_multiple(
+            interval_usec, now_usec);
+        bs_dllist_push_back(&ticker_ptr->slots, &slot_ptr->dlnode);
+    }
+
+    wlmcl_tick_t *tick_ptr = logged_calloc(1, sizeof(wlmcl_tick_t));
+    if (NULL == tick_ptr) {
+        if (bs_dllist_empty(&slot_ptr->ticks)) {
+            bs_dllist_remove(&ticker_ptr->slots, &slot_ptr->dlnode);
+            free(slot_ptr);
+        }
+        return NULL;
+    }
+    tick_ptr->slot_ptr = slot_ptr;
+    tick_ptr->first_usec = _wlmcl_ticker_next_multiple(
+        interval_usec, now_usec);
+    tick_ptr->callback = callback;
+    tick_ptr->callback_ud_ptr = callback_ud_ptr;
+    bs_dllist_push_back(&slot_ptr->ticks, &tick_ptr->dlnode);
+    return tick_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_ticker_remove(wlmcl_ticker_t *ticker_ptr, wlmcl_tick_t *tick_ptr)
+{
+    // While dispatching, the tick may be referenced by the iteration.
+    if (ticker_ptr->dispatching) {
+        tick_ptr->removed = true;
+        ticker_ptr->has_removed = true;
+        return;
+    }
+    _wlmcl_ticker_release(ticker_ptr, tick_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+uint64_t wlmcl_ticker_next_usec(wlmcl_ticker_t *ticker_ptr)
+{
+    uint64_t next_usec = UINT64_MAX;
+    for (bs_dllist_node_t *dlnode_ptr = ticker_ptr->slots.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmcl_ticker_slot_t *slot_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_ticker_slot_t, dlnode);
+        next_usec = BS_MIN(next_usec, slot_ptr->next_usec);
+    }
+    return next_usec;
+}
+
+/* ------------------------------------------------------------------------- */
+size_t wlmcl_ticker_dispatch(wlmcl_ticker_t *ticker_ptr, uint64_t now_usec)
+{
+    size_t calls = 0;
+
+    ticker_ptr->dispatching = true;
+    for (bs_dllist_node_t *dlnode_ptr = ticker_ptr->slots.head_ptr;
+         NULL != dlnode_ptr;
+         dlnode_ptr = dlnode_ptr->next_ptr) {
+        wlmcl_ticker_slot_t *slot_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_ticker_slot_t, dlnode);
+        if (slot_ptr->next_usec > now_usec) continue;
+
+        for (bs_dllist_node_t *tnode_ptr = slot_ptr->ticks.head_ptr;
+             NULL != tnode_ptr;
+             tnode_ptr = tnode_ptr->next_ptr) {
+            wlmcl_tick_t *tick_ptr = BS_CONTAINER_OF(
+                tnode_ptr, wlmcl_tick_t, dlnode);
+            if (tick_ptr->removed || tick_ptr->first_usec > now_usec) continue;
+            tick_ptr->callback(now_usec, tick_ptr->callback_ud_ptr);
+            ++calls;
+        }
+        slot_ptr->next_usec = _wlmcl_ticker_next_multiple(
+            slot_ptr->interval_usec, now_usec);
+    }
+    ticker_ptr->dispatching = false;
+
+    if (!ticker_ptr->has_removed) return calls;
+    bs_dllist_node_t *dlnode_ptr = ticker_ptr->slots.head_ptr;
+    while (NULL != dlnode_ptr) {
+        wlmcl_ticker_slot_t *slot_ptr = BS_CONTAINER_OF(
+            dlnode_ptr, wlmcl_ticker_slot_t, dlnode);
+        dlnode_ptr = dlnode_ptr->next_ptr;
+
+        // Releasing the last tick releases the slot, so iterate carefully.
+        bs_dllist_node_t *tnode_ptr = slot_ptr->ticks.head_ptr;
+        while (NULL != tnode_ptr) {
+            wlmcl_tick_t *tick_ptr = BS_CONTAINER_OF(
+                tnode_ptr, wlmcl_tick_t, dlnode);
+            tnode_ptr = tnode_ptr->next_ptr;
+            if (tick_ptr->removed) _wlmcl_ticker_release(ticker_ptr, tick_ptr);
+        }
+    }
+    ticker_ptr->has_removed = false;
+    return calls;
+}
+
+/* == Local (static) methods =============================================== */
+
+/* ------------------------------------------------------------------------- */
+/** Frees the tick, and its slot if that became empty. */
+void _wlmcl_ticker_release(
+    wlmcl_ticker_t *ticker_ptr,
+    wlmcl_tick_t *tick_ptr)
+{
+    wlmcl_ticker_slot_t *slot_ptr = tick_ptr->slot_ptr;
+    bs_dllist_remove(&slot_ptr->ticks, &tick_ptr->dlnode);
+    free(tick_ptr);
+
+    if (!bs_dllist_empty(&slot_ptr->ticks)) return;
+    bs_dllist_remove(&ticker_ptr->slots, &slot_ptr->dlnode);
+    free(slot_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Returns the first multiple of `interval_usec` after `now_usec`. */
+uint64_t _wlmcl_ticker_next_multiple(uint64_t interval_usec, uint64_t now_usec)
+{
+    return (now_usec / interval_usec + 1) * interval_usec;
+}
+
+/* == Unit tests =========================================================== */
+
+static void _wlmcl_ticker_test_align(bs_test_t *test_ptr);
+static void _wlmcl_ticker_test_remove(bs_test_t *test_ptr);
+
+/** Test cases. */
+static const bs_test_case_t _wlmcl_ticker_test_cases[] = {
+    { true, "align", _wlmcl_ticker_test_align },
+    { true, "remove", _wlmcl_ticker_test_remove },
+    BS_TEST_CASE_SENTINEL()
+};
+
+const bs_test_set_t wlmcl_ticker_test_set = BS_TEST_SET(
+    true, "ticker", _wlmcl_ticker_test_cases);
+
+/** Argument to @ref _wlmcl_ticker_test_callback. */
+typedef struct {
+    /** Number of calls. */
+    int                       calls;
+    /** `now_usec` of the most recent call. */
+    uint64_t                  now_usec;
+    /** If set: Removes this tick, from within the callback. */
+    wlmcl_tick_t              *remove_tick_ptr;
+    /** Ticker, for removing @ref _wlmcl_ticker_test_arg_t::remove_tick_ptr. */
+    wlmcl_ticker_t            *ticker_ptr;
+} _wlmcl_ticker_test_arg_t;
+
+/** Test callback: Records the call into @ref _wlmcl_ticker_test_arg_t. */
+static void _wlmcl_ticker_test_callback(uint64_t now_usec, void *ud_ptr)
+{
+    _wlmcl_ticker_test_arg_t *arg_ptr = ud_ptr;
+    arg_ptr->calls++;
+    arg_ptr->now_usec = now_usec;
+    if (NULL != arg_ptr->remove_tick_ptr) {
+        wlmcl_ticker_remove(arg_ptr->ticker_ptr, arg_ptr->remove_tick_ptr);
+        arg_ptr->remove_tick_ptr = NULL;
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/** Ticks of equal interval share their wakeups, at multiples of it. */
+void _wlmcl_ticker_test_align(bs_test_t *test_ptr)
+{
+    wlmcl_ticker_t *t = wlmcl_ticker_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t);
+    BS_TEST_VERIFY_EQ(test_ptr, UINT64_MAX, wlmcl_ticker_next_usec(t));
+
+    _wlmcl_ticker_test_arg_t a1 = {}, a2 = {}, a3 = {};
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        wlmcl_ticker_add(t, 1000, 1250, _wlmcl_ticker_test_callback, &a1));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        wlmcl_ticker_add(t, 1000, 1700, _wlmcl_ticker_test_callback, &a2));
+    BS_TEST_VERIFY_NEQ(
+        test_ptr, NULL,
+        wlmcl_ticker_add(t, 5000, 1700, _wlmcl_ticker_test_callback, &a3));
+    BS_TEST_VERIFY_EQ(
+        test_ptr, NULL,
+        wlmcl_ticker_add(t, 0, 1700, _wlmcl_ticker_test_callback, &a3));
+    BS_TEST_VERIFY_EQ(test_ptr, 2000, wlmcl_ticker_next_usec(t));
+
+    // Not due yet.
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmcl_ticker_dispatch(t, 1999));
+
+    // Both 1ms ticks fire together.
+    BS_TEST_VERIFY_EQ(test_ptr, 2, wlmcl_ticker_dispatch(t, 2010));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, a1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, a2.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 2010, a2.now_usec);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, a3.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 3000, wlmcl_ticker_next_usec(t));
+
+    // Missed multiples are skipped. The 5ms tick coincides at 5000.
+    BS_TEST_VERIFY_EQ(test_ptr, 3, wlmcl_ticker_dispatch(t, 5300));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, a1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, a3.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 6000, wlmcl_ticker_next_usec(t));
+
+    wlmcl_ticker_destroy(t);
+}
+
+/* ------------------------------------------------------------------------- */
+/** Ticks can be removed, also from within callbacks. */
+void _wlmcl_ticker_test_remove(bs_test_t *test_ptr)
+{
+    wlmcl_ticker_t *t = wlmcl_ticker_create();
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t);
+
+    _wlmcl_ticker_test_arg_t a1 = { .ticker_ptr = t }, a2 = {}, a3 = {};
+    wlmcl_tick_t *t1 = wlmcl_ticker_add(
+        t, 1000, 0, _wlmcl_ticker_test_callback, &a1);
+    wlmcl_tick_t *t2 = wlmcl_ticker_add(
+        t, 1000, 0, _wlmcl_ticker_test_callback, &a2);
+    wlmcl_tick_t *t3 = wlmcl_ticker_add(
+        t, 3000, 0, _wlmcl_ticker_test_callback, &a3);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t1);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t2);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, t3);
+
+    // Removing the only tick of a slot drops the slot.
+    wlmcl_ticker_remove(t, t3);
+    BS_TEST_VERIFY_EQ(test_ptr, 1000, wlmcl_ticker_next_usec(t));
+
+    // t1 removes t2 from within the dispatch: t2 is not called.
+    a1.remove_tick_ptr = t2;
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_ticker_dispatch(t, 1000));
+    BS_TEST_VERIFY_EQ(test_ptr, 1, a1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, a2.calls);
+
+    // t1 removes itself.
+    a1.remove_tick_ptr = t1;
+    BS_TEST_VERIFY_EQ(test_ptr, 1, wlmcl_ticker_dispatch(t, 2000));
+    BS_TEST_VERIFY_EQ(test_ptr, 2, a1.calls);
+    BS_TEST_VERIFY_EQ(test_ptr, UINT64_MAX, wlmcl_ticker_next_usec(t));
+    BS_TEST_VERIFY_EQ(test_ptr, 0, wlmcl_ticker_dispatch(t, 3000));
+
+    wlmcl_ticker_destroy(t);
+}
+
+/* == End of ticker.c ====================================================== */
@@ -0,0 +1,125 @@
+/* ========================================================================= */
+/**
+ * @file ticker.h
+ *
+ * @copyright
+ * Copyright (c) 2026 Philipp Kaeser (kaeser@gubbe.ch)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * https://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef __WLMAKER_WLCLIENT_TICKER_H__
+#define __WLMAKER_WLCLIENT_TICKER_H__
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <libbase/libbase.h>
+
+/** Forward declaration: A wheel of periodic ticks. */
+typedef struct _wlmcl_ticker_t wlmcl_ticker_t;
+/** Forward declaration: A periodic tick. */
+typedef struct _wlmcl_tick_t wlmcl_tick_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+/**
+ * Callback for when a tick is due.
+ *
+ * @param now_usec            Time of the dispatch, in microseconds.
+ * @param ud_ptr              As given to @ref wlmcl_ticker_add.
+ */
+typedef void (*wlmcl_tick_callback_t)(uint64_t now_usec, void *ud_ptr);
+
+/**
+ * Creates a ticker.
+ *
+ * Ticks of the same interval share one slot of the wheel, and are due at the
+ * same multiples of their interval. All ticks due at a time are dispatched
+ * together, so that N periodic callbacks cost one wakeup, rather than N.
+ *
+ * @return The ticker, or NULL on error. Must be destroyed by calling
+ *     @ref wlmcl_ticker_destroy.
+ */
+wlmcl_ticker_t *wlmcl_ticker_create(void);
+
+/**
+ * Destroys the ticker, and all ticks still registered with it.
+ *
+ * @param ticker_ptr
+ */
+void wlmcl_ticker_destroy(wlmcl_ticker_t *ticker_ptr);
+
+/**
+ * Adds a periodic tick.
+ *
+ * The tick is first due at the next multiple of `interval_usec` after
+ * `now_usec`, and then at each multiple thereafter. Missed multiples are
+ * skipped, not caught up.
+ *
+ * @param ticker_ptr
+ * @param interval_usec       Interval, in microseconds. Must be positive.
+ * @param now_usec            Current time, in microseconds.
+ * @param callback
+ * @param callback_ud_ptr
+ *
+ * @return The tick, or NULL on error. It is owned by the ticker, and may be
+ *     removed through @ref wlmcl_ticker_remove.
+ */
+wlmcl_tick_t *wlmcl_ticker_add(
+    wlmcl_ticker_t *ticker_ptr,
+    uint64_t interval_usec,
+    uint64_t now_usec,
+    wlmcl_tick_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Removes and destroys the tick.
+ *
+ * It is safe to call this from within any tick's callback.
+ *
+ * @param ticker_ptr
+ * @param tick_ptr
+ */
+void wlmcl_ticker_remove(wlmcl_ticker_t *ticker_ptr, wlmcl_tick_t *tick_ptr);
+
+/**
+ * Returns when the next tick is due.
+ *
+ * @param ticker_ptr
+ *
+ * @return Time, in microseconds. UINT64_MAX if there are no ticks.
+ */
+uint64_t wlmcl_ticker_next_usec(wlmcl_ticker_t *ticker_ptr);
+
+/**
+ * Invokes the callbacks of all ticks due at `now_usec`.
+ *
+ * @param ticker_ptr
+ * @param now_usec
+ *
+ * @return Number of callbacks invoked.
+ */
+size_t wlmcl_ticker_dispatch(wlmcl_ticker_t *ticker_ptr, uint64_t now_usec);
+
+/** Unit test set. */
+extern const bs_test_set_t wlmcl_ticker_test_set;
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif /* __WLMAKER_WLCLIENT_TICKER_H__ */
+/* == End of ticker.h ====================================================== */
@@ -24,13 +24,14 @@
 #include <errno.h>
 #include <inttypes.h>
 #include <libbase/libbase.h>
-#include <poll.h>
+#include <limits.h>
 #include <signal.h>
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/epoll.h>
 #include <sys/mman.h>
 #include <sys/signalfd.h>
 #include <sys/types.h>
@@ -41,6 +42,7 @@
 #include <wayland-util.h>
 #include <xkbcommon/xkbcommon.h>
 
+#include "fd_watch.h"
 #include "wlmaker-icon-unstable-v1-client-protocol.h"
 #include "ext-input-observation-v1-client-protocol.h"
 #include "xdg-shell-client-protocol.h"
@@ -91,6 +93,13 @@ struct _wlmcl_client_t {
     /** File descriptor to monitor SIGINT. */
     int                       signal_fd;
 
+    /** Watches the display, the signal and all registered file descriptors. */
+    wlmcl_fd_watcher_t        *fd_watcher_ptr;
+    /** Watch for the display's file descriptor. */
+    wlmcl_fd_watch_t          *display_watch_ptr;
+    /** Watch for @ref wlmcl_client_t::signal_fd. */
+    wlmcl_fd_watch_t          *signal_watch_ptr;
+
     /** Whether to keep the client running. */
     volatile bool             keep_running;
 };
@@ -141,6 +150,8 @@ static wlmcl_client_timer_t *wlmcl_client_timer_create(
     void *callback_ud_ptr);
 static void wlmcl_client_timer_destroy(
     wlmcl_client_timer_t *timer_ptr);
+static int _wlmcl_client_timeout_msec(wlmcl_client_t *client_ptr);
+static bool _wlmcl_client_handle_signal(wlmcl_client_t *client_ptr);
 
 static void wlmcl_client_seat_setup(wlmcl_client_t *client_ptr);
 static void wlmcl_client_seat_handle_capabilities(
@@ -398,6 +409,25 @@ wlmcl_client_t *wlmcl_client_create(const char *app_id_ptr)
         return NULL;
     }
 
+    wlclient_ptr->fd_watcher_ptr = wlmcl_fd_watcher_create();
+    if (NULL == wlclient_ptr->fd_watcher_ptr) {
+        wlmcl_client_destroy(wlclient_ptr);
+        return NULL;
+    }
+    wlclient_ptr->display_watch_ptr = wlmcl_fd_watcher_add(
+        wlclient_ptr->fd_watcher_ptr,
+        wl_display_get_fd(wlclient_ptr->attributes.wl_display_ptr),
+        EPOLLIN, NULL, NULL);
+    wlclient_ptr->signal_watch_ptr = wlmcl_fd_watcher_add(
+        wlclient_ptr->fd_watcher_ptr,
+        wlclient_ptr->signal_fd,
+        EPOLLIN, NULL, NULL);
+    if (NULL == wlclient_ptr->display_watch_ptr ||
+        NULL == wlclient_ptr->signal_watch_ptr) {
+        wlmcl_client_destroy(wlclient_ptr);
+        return NULL;
+    }
+
     // Hack: Somehow this propagates the protool far enough for getting
     // the pointer registered.
     wl_display_roundtrip(wlclient_ptr->attributes.wl_display_ptr);
@@ -415,6 +445,14 @@ void wlmcl_client_destroy(wlmcl_client_t *wlclient_ptr)
         wlmcl_client_timer_destroy((wlmcl_client_timer_t*)dlnode_ptr);
     }
 
+    if (NULL != wlclient_ptr->fd_watcher_ptr) {
+        // Also destroys all watches, including those registered by the app.
+        wlmcl_fd_watcher_destroy(wlclient_ptr->fd_watcher_ptr);
+        wlclient_ptr->fd_watcher_ptr = NULL;
+        wlclient_ptr->display_watch_ptr = NULL;
+        wlclient_ptr->signal_watch_ptr = NULL;
+    }
+
     if (NULL != wlclient_ptr->wl_registry_ptr) {
         wl_registry_destroy(wlclient_ptr->wl_registry_ptr);
         wlclient_ptr->wl_registry_ptr = NULL;
@@ -514,23 +552,17 @@ void wlmcl_client_run(wlmcl_client_t *wlclient_ptr)
             }
         }
 
-        struct pollfd pollfds[2];
-        pollfds[0].fd = wl_display_get_fd(wlclient_ptr->attributes.wl_display_ptr);
-        pollfds[0].events = POLLIN;
-        pollfds[0].revents = 0;
-
-        pollfds[1].fd = wlclient_ptr->signal_fd;
-        pollfds[1].events = POLLIN;
-        pollfds[1].revents = 0;
-
-        int rv = poll(&pollfds[0], 2, 100);
-        if (0 > rv && EINTR != errno) {
-            bs_log(BS_ERROR | BS_ERRNO, "Failed poll(%p, 1, 100)", &pollfds);
+        int rv = wlmcl_fd_watcher_wait(
+            wlclient_ptr->fd_watcher_ptr,
+            _wlmcl_client_timeout_msec(wlclient_ptr));
+        if (0 > rv) {
             wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
             break;  // Error!
         }
 
-        if (pollfds[0].revents & POLLIN) {
+        // Also attempts to read on errors, for these to get reported.
+        if (wlmcl_fd_watch_revents(wlclient_ptr->display_watch_ptr) &
+            (EPOLLIN | EPOLLERR | EPOLLHUP)) {
             if (0 > wl_display_read_events(wlclient_ptr->attributes.wl_display_ptr)) {
                 bs_log(BS_ERROR | BS_ERRNO, "Failed wl_display_read_events(%p)",
                        wlclient_ptr->attributes.wl_display_ptr);
@@ -540,22 +572,13 @@ void wlmcl_client_run(wlmcl_client_t *wlclient_ptr)
             wl_display_cancel_read(wlclient_ptr->attributes.wl_display_ptr);
         }
 
-        if (pollfds[1].revents & POLLIN) {
-            struct signalfd_siginfo siginfo;
-            ssize_t rd = read(wlclient_ptr->signal_fd, &siginfo, sizeof(siginfo));
-            if (0 > rd) {
-                bs_log(BS_ERROR, "Failed read(%d, %p, %zu)",
-                       wlclient_ptr->signal_fd, &siginfo, sizeof(siginfo));
-                break;
-            } else if ((size_t)rd != sizeof(siginfo)) {
-                bs_log(BS_ERROR, "Bytes read from signal_fd %zu != %zd",
-                       sizeof(siginfo), rd);
-                break;
-            }
-            bs_log(BS_ERROR, "Signal caught: %d", siginfo.ssi_signo);
-            wlclient_ptr->keep_running = false;
+        if (wlmcl_fd_watch_revents(wlclient_ptr->signal_watch_ptr) & EPOLLIN) {
+            if (!_wlmcl_client_handle_signal(wlclient_ptr)) break;
         }
 
+        // The display read is completed: Dispatch to registered watches.
+        wlmcl_fd_watcher_dispatch(wlclient_ptr->fd_watcher_ptr);
+
         if (0 > wl_display_dispatch_pending(wlclient_ptr->attributes.wl_display_ptr)) {
             bs_log(BS_ERROR | BS_ERRNO,
                    "Failed wl_display_dispatch_queue_pending(%p)",
@@ -598,6 +621,26 @@ void wlmcl_client_request_terminate(wlmcl_client_t *wlclient_ptr)
     wlclient_ptr->keep_running = false;
 }
 
+/* ------------------------------------------------------------------------- */
+wlmcl_fd_watch_t *wlmcl_client_register_fd(
+    wlmcl_client_t *wlclient_ptr,
+    int fd,
+    uint32_t events,
+    wlmcl_fd_watch_callback_t callback,
+    void *callback_ud_ptr)
+{
+    return wlmcl_fd_watcher_add(
+        wlclient_ptr->fd_watcher_ptr, fd, events, callback, callback_ud_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+void wlmcl_client_unregister_fd(
+    wlmcl_client_t *wlclient_ptr,
+    wlmcl_fd_watch_t *watch_ptr)
+{
+    wlmcl_fd_watcher_remove(wlclient_ptr->fd_watcher_ptr, watch_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 bool wlmcl_client_register_timer(
     wlmcl_client_t *wlclient_ptr,
@@ -732,6 +775,7 @@ wlmcl_client_timer_t *wlmcl_client_timer_create(
         if (timer_ptr->target_usec > ref_timer_ptr->target_usec) continue;
         bs_dllist_insert_node_before(
             &client_ptr->timers, dlnode_ptr, &timer_ptr->dlnode);
+        break;
     }
     if (NULL == dlnode_ptr) {
         bs_dllist_push_back(&client_ptr->timers, &timer_ptr->dlnode);
@@ -751,6 +795,53 @@ void wlmcl_client_timer_destroy(wlmcl_client_timer_t *timer_ptr)
     free(timer_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Computes the timeout for waiting on file descriptors.
+ *
+ * @param client_ptr
+ *
+ * @return Milliseconds until the earliest timer expires, rounded up. 0 if a
+ *     timer is due already, or -1 if there is no timer.
+ */
+int _wlmcl_client_timeout_msec(wlmcl_client_t *client_ptr)
+{
+    bs_dllist_node_t *dlnode_ptr = client_ptr->timers.head_ptr;
+    if (NULL == dlnode_ptr) return -1;
+
+    uint64_t target_usec = ((wlmcl_client_timer_t*)dlnode_ptr)->target_usec;
+    uint64_t current_usec = bs_usec();
+    if (target_usec <= current_usec) return 0;
+    return BS_MIN((target_usec - current_usec + 999) / 1000, (uint64_t)INT_MAX);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Reads the pending signal from @ref wlmcl_client_t::signal_fd, and requests
+ * the mainloop to terminate.
+ *
+ * @param client_ptr
+ *
+ * @return false on error.
+ */
+bool _wlmcl_client_handle_signal(wlmcl_client_t *client_ptr)
+{
+    struct signalfd_siginfo siginfo;
+    ssize_t rd = read(client_ptr->signal_fd, &siginfo, sizeof(siginfo));
+    if (0 > rd) {
+        bs_log(BS_ERROR, "Failed read(%d, %p, %zu)",
+               client_ptr->signal_fd, &siginfo, sizeof(siginfo));
+        return false;
+    } else if ((size_t)rd != sizeof(siginfo)) {
+        bs_log(BS_ERROR, "Bytes read from signal_fd %zu != %zd",
+               sizeof(siginfo), rd);
+        return false;
+    }
+    bs_log(BS_ERROR, "Signal caught: %d", siginfo.ssi_signo);
+    client_ptr->keep_running = false;
+    return true;
+}
+
 /* ------------------------------------------------------------------------- */
 /** Set up the seat: Registers the client's seat listeners. */
 void wlmcl_client_seat_setup(wlmcl_client_t *client_ptr)
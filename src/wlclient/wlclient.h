@@ -26,6 +26,8 @@
 #include <wayland-server-core.h>
 #include <xkbcommon/xkbcommon.h>
 
+#include "fd_watch.h"  // IWYU pragma: export
+
 /** Forward declaration: Wayland client handle. */
 typedef struct _wlmcl_client_t wlmcl_client_t;
 
@@ -181,6 +183,42 @@ bool wlmcl_client_register_timer(
     wlmcl_client_callback_t callback,
     void *callback_ud_ptr);
 
+/**
+ * Registers a file descriptor to be watched by the client's mainloop.
+ *
+ * Permits apps to get notified of changes, eg. through inotify, netlink or
+ * uevent sockets, rather than polling on timers. `callback` is invoked from
+ * within @ref wlmcl_client_run, after Wayland events were read and before
+ * they are dispatched.
+ *
+ * @param wlmcl_client_ptr
+ * @param fd                  The file descriptor. Must remain open for as
+ *                            long as it is registered.
+ * @param events              Events to watch for, eg. `EPOLLIN`.
+ * @param callback
+ * @param callback_ud_ptr
+ *
+ * @return A handle to the watch, or NULL on error. It will be destroyed with
+ *     the client, or by calling @ref wlmcl_client_unregister_fd.
+ */
+wlmcl_fd_watch_t *wlmcl_client_register_fd(
+    wlmcl_client_t *wlmcl_client_ptr,
+    int fd,
+    uint32_t events,
+    wlmcl_fd_watch_callback_t callback,
+    void *callback_ud_ptr);
+
+/**
+ * Unregisters a file descriptor, registered by
+ * @ref wlmcl_client_register_fd. Does not close the file descriptor.
+ *
+ * @param wlmcl_client_ptr
+ * @param watch_ptr
+ */
+void wlmcl_client_unregister_fd(
+    wlmcl_client_t *wlmcl_client_ptr,
+    wlmcl_fd_watch_t *watch_ptr);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
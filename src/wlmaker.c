@@ -42,12 +42,17 @@
 #include "clip.h"
 #include "config.h"
 #include "dock.h"
+#include "input/cursor.h"
+#include "input/keyboard.h"
+#include "launcher.h"
 #include "root_menu.h"
 #include "server.h"
 #include "task_list.h"
 #include "toolkit/toolkit.h"
+#include "util/async_log.h"
 #include "util/backtrace.h"
 #include "util/files.h"
+#include "util/startup.h"
 #include "util/version.h"
 #include "util/wlr_log.h"
 
@@ -59,6 +64,12 @@ static char *wlmaker_arg_state_file_ptr = NULL;
 static char *wlmaker_arg_theme_file_ptr = NULL;
 /** Will hold the value of --root_menu_file. */
 static char *wlmaker_arg_root_menu_file_ptr = NULL;
+/** Will hold the value of --log_file. */
+static char *wlmaker_arg_log_file_ptr = NULL;
+/** Will hold the value of --log_file_max_kb. */
+static uint32_t wlmaker_arg_log_file_max_kb = 10240;
+/** Will hold the value of --startup_trace. */
+static char *wlmaker_arg_startup_trace_ptr = NULL;
 
 /** Startup options for the server. */
 static wlmaker_server_options_t wlmaker_server_options = {
@@ -66,6 +77,7 @@ static wlmaker_server_options_t wlmaker_server_options = {
     .width = 0,
     .height = 0,
     .bind_with_logo = false,
+    .stall_threshold_msec = 200,
 };
 
 /** Definition of commandline arguments. */
@@ -104,6 +116,18 @@ static const bs_arg_t wlmaker_args[] = {
         NULL,
         &wlmaker_arg_root_menu_file_ptr),
     bs_arg_log_level,
+    BS_ARG_STRING(
+        "log_file",
+        "Optional: Path to a file to append the log to, instead of writing "
+        "it to stderr. The file is rotated when exceeding --log_file_max_kb.",
+        NULL,
+        &wlmaker_arg_log_file_ptr),
+    BS_ARG_UINT32(
+        "log_file_max_kb",
+        "Size of the log file, in kB, at which it is rotated. Keeps three "
+        "rotated files. Set to 0 for never rotating the file.",
+        10240, 0, UINT32_MAX,
+        &wlmaker_arg_log_file_max_kb),
     BS_ARG_BOOL(
         "bind_with_logo",
         "Optional: Whether to add 'Logo' as modifier to each key binding. "
@@ -111,6 +135,18 @@ static const bs_arg_t wlmaker_args[] = {
         "or X11 client. Disabled by default.",
         false,
         &wlmaker_server_options.bind_with_logo),
+    BS_ARG_UINT32(
+        "stall_threshold_msec",
+        "Event loop dispatches running longer than this are logged, with a "
+        "stack trace. Set to 0 for disabling the watchdog.",
+        200, 0, UINT32_MAX,
+        &wlmaker_server_options.stall_threshold_msec),
+    BS_ARG_STRING(
+        "startup_trace",
+        "Optional: Path to a file to write a trace of the startup phases to, "
+        "as Chrome trace JSON. Can be viewed in Perfetto or chrome://tracing.",
+        NULL,
+        &wlmaker_arg_startup_trace_ptr),
     BS_ARG_UINT32(
         "height",
         "Desired output height. Applies when running in windowed mode, and "
@@ -137,6 +173,12 @@ typedef struct {
     char            name[32];
     /** Background color. */
     uint32_t        color;
+    /** Path to the background image, or NULL. */
+    char            *image_path_ptr;
+    /** Whether "Image" was present. */
+    bool            has_image;
+    /** How to place the background image. */
+    wlmaker_background_image_mode_t image_mode;
 } wlmaker_workspace_style_t;
 
 /** Style descriptor for the "Workspace" dict of wlmaker-state.plist. */
@@ -145,9 +187,85 @@ static const bspl_desc_t wlmaker_workspace_style_desc[] = {
         "Name", true, wlmaker_workspace_style_t, name, name, 32, NULL),
     BSPL_DESC_ARGB32(
         "Color", false, wlmaker_workspace_style_t, color, color, 0),
+    BSPL_DESC_STRING(
+        "Image", false, wlmaker_workspace_style_t,
+        image_path_ptr, has_image, NULL),
+    BSPL_DESC_ENUM(
+        "ImageMode", false, wlmaker_workspace_style_t,
+        image_mode, image_mode,
+        WLMAKER_BACKGROUND_IMAGE_FILL, wlmaker_background_image_mode_desc),
     BSPL_DESC_SENTINEL()
 };
 
+/** Argument to @ref state_load_task. */
+typedef struct {
+    /** File resolver. */
+    wlm_util_files_t          *files_ptr;
+    /** Value of --state_file, or NULL. */
+    const char                *fname_ptr;
+    /** The loaded state. */
+    bspl_dict_t               *state_dict_ptr;
+} wlmaker_state_load_arg_t;
+
+/* ------------------------------------------------------------------------- */
+/** Loads the state, as a startup task. */
+void state_load_task(void *arg_ptr)
+{
+    wlmaker_state_load_arg_t *a_ptr = arg_ptr;
+    a_ptr->state_dict_ptr = wlmaker_state_load(
+        a_ptr->files_ptr, a_ptr->fname_ptr);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Resolves the paths of the images shown by the dock's launchers and the
+ * clip, for prefetching them by @ref images_prefetch_task.
+ *
+ * @param files_ptr
+ * @param state_dict_ptr
+ *
+ * @return A NULL-terminated array of paths, or NULL on error.
+ */
+char **images_to_prefetch(
+    wlm_util_files_t *files_ptr,
+    bspl_dict_t *state_dict_ptr)
+{
+    bspl_dict_t *dock_dict_ptr = bspl_dict_get_dict(state_dict_ptr, "Dock");
+    bspl_array_t *launchers_ptr = NULL;
+    if (NULL != dock_dict_ptr) {
+        launchers_ptr = bspl_dict_get_array(dock_dict_ptr, "Launchers");
+    }
+    size_t launchers = 0;
+    if (NULL != launchers_ptr) launchers = bspl_array_size(launchers_ptr);
+
+    char **paths_ptr = logged_calloc(launchers + 2, sizeof(char*));
+    if (NULL == paths_ptr) return NULL;
+    size_t n = 0;
+    for (size_t i = 0; i < launchers; ++i) {
+        bspl_dict_t *dict_ptr = bspl_dict_from_object(
+            bspl_array_at(launchers_ptr, i));
+        if (NULL == dict_ptr) continue;
+        const char *icon_ptr = bspl_dict_get_string_value(dict_ptr, "Icon");
+        if (NULL == icon_ptr) continue;
+        paths_ptr[n] = wlmaker_launcher_resolve_icon(files_ptr, icon_ptr);
+        if (NULL != paths_ptr[n]) ++n;
+    }
+    paths_ptr[n] = wlmaker_clip_resolve_image(files_ptr);
+    return paths_ptr;
+}
+
+/* ------------------------------------------------------------------------- */
+/** Decodes the images from @ref images_to_prefetch, as a startup task. */
+void images_prefetch_task(void *arg_ptr)
+{
+    char **paths_ptr = arg_ptr;
+    for (char **p = paths_ptr; NULL != *p; ++p) {
+        wlmtk_image_prefetch(*p);
+        free(*p);
+    }
+    free(paths_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Launches a sub-process, and keeps it on the subprocess stack. */
 bool start_subprocess(const char *cmdline_ptr)
@@ -203,6 +321,7 @@ bool create_workspaces(
             &server_ptr->style_ptr->tile);
         if (NULL == workspace_ptr) {
             bs_log(BS_ERROR, "Failed wlmtk_workspace_create(\"%s\")", s.name);
+            bspl_decoded_destroy(wlmaker_workspace_style_desc, &s);
             rv = false;
             break;
         }
@@ -213,7 +332,10 @@ bool create_workspaces(
         bs_dllist_node_t *bg_dlnode_ptr = wlmaker_background_create(
             workspace_ptr,
             server_ptr->wlr_output_layout_ptr,
-            s.color);
+            s.color,
+            s.has_image ? s.image_path_ptr : NULL,
+            s.image_mode);
+        bspl_decoded_destroy(wlmaker_workspace_style_desc, &s);
         if (NULL == bg_dlnode_ptr) {
             bs_log(BS_ERROR, "Failed wlmaker_background()");
             rv = false;
@@ -233,7 +355,19 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
     wlmaker_dock_t            *dock_ptr = NULL;
     wlmaker_clip_t            *clip_ptr = NULL;
     wlmaker_task_list_t       *task_list_ptr = NULL;
-    int                       rv = EXIT_SUCCESS;
+    wlm_util_async_log_t      *async_log_ptr = NULL;
+    bspl_dict_t               *config_dict_ptr = NULL;
+    bspl_dict_t               *state_dict_ptr = NULL;
+    wlmaker_config_style_t    style = {};
+    wlmaker_server_t          *server_ptr = NULL;
+    wlmaker_action_handle_t   *action_handle_ptr = NULL;
+    // Workers. All started tasks are joined before cleaning up.
+    wlmaker_state_load_arg_t  state_load_arg = {};
+    wlm_util_startup_task_t   *state_task_ptr = NULL;
+    wlm_util_startup_task_t   *keymap_task_ptr = NULL;
+    wlm_util_startup_task_t   *cursor_task_ptr = NULL;
+    wlm_util_startup_task_t   *images_task_ptr = NULL;
+    int                       rv = EXIT_FAILURE;
 
     if (!wlm_util_backtrace_setup(argv[0])) return EXIT_FAILURE;
     if (!wlm_util_wlr_log_init(WLR_DEBUG)) return EXIT_FAILURE;
@@ -260,6 +394,22 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
             return EXIT_FAILURE;
         }
     }
+
+    // From here on, logs are written by a separate thread. If that cannot be
+    // set up, they keep going to stderr directly.
+    const wlm_util_async_log_options_t log_options = {
+        .fname_ptr = wlmaker_arg_log_file_ptr,
+        .max_file_size = (size_t)wlmaker_arg_log_file_max_kb * 1024,
+        .keep_files = 3,
+        .buffer_size = 1 << 20,
+    };
+    async_log_ptr = wlm_util_async_log_create(&log_options);
+    if (NULL != wlmaker_arg_log_file_ptr) free(wlmaker_arg_log_file_ptr);
+    if (NULL == async_log_ptr) {
+        bs_log(BS_WARNING, "Failed to set up asynchronous logging. Logging "
+               "to stderr, synchronously.");
+    }
+
     bs_log(BS_INFO, "Starting wlmaker %s (%s)",
            wlm_util_version,
            wlm_util_version_full);
@@ -267,23 +417,34 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
     wlm_util_files_t *files_ptr = wlm_util_files_create("wlmaker");
     if (NULL == files_ptr) {
         bs_log(BS_ERROR, "Failed wlm_util_files_create(\"wlmaker\")");
-        return EXIT_FAILURE;
+        goto cleanup;
     }
 
-    bspl_dict_t *config_dict_ptr = wlmaker_config_load(
+    if (NULL != wlmaker_arg_startup_trace_ptr &&
+        !wlm_util_startup_trace_enable()) goto cleanup;
+    wlm_util_startup_phase_t startup = wlm_util_startup_phase_begin(
+        "startup");
+
+    config_dict_ptr = wlmaker_config_load(
         files_ptr, wlmaker_arg_config_file_ptr);
     if (NULL != wlmaker_arg_config_file_ptr) free(wlmaker_arg_config_file_ptr);
     if (NULL == config_dict_ptr) {
         fprintf(stderr, "Failed to load & initialize configuration.\n");
-        return EXIT_FAILURE;
+        goto cleanup;
     }
 
-    bspl_dict_t *state_dict_ptr = wlmaker_state_load(
-        files_ptr, wlmaker_arg_state_file_ptr);
-    if (NULL != wlmaker_arg_state_file_ptr) free(wlmaker_arg_state_file_ptr);
-    if (NULL == state_dict_ptr) {
-        fprintf(stderr, "Failed to load & initialize state.\n");
-        return EXIT_FAILURE;
+    // Loading the state, compiling the keymap, loading the cursor theme and
+    // decoding the images are independent: Run them on worker threads, while
+    // the main thread loads the theme and creates the server.
+    state_load_arg.files_ptr = files_ptr;
+    state_load_arg.fname_ptr = wlmaker_arg_state_file_ptr;
+    state_task_ptr = wlm_util_startup_task_start(
+        "state", state_load_task, &state_load_arg);
+    wlmim_keyboard_prefetch_t *keyboard_prefetch_ptr =
+        wlmim_keyboard_prefetch_create(config_dict_ptr);
+    if (NULL != keyboard_prefetch_ptr) {
+        keymap_task_ptr = wlm_util_startup_task_start(
+            "keymap", wlmim_keyboard_prefetch_run, keyboard_prefetch_ptr);
     }
 
     const char *theme_file_ptr = wlmaker_arg_theme_file_ptr;
@@ -291,48 +452,81 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
         theme_file_ptr = bspl_dict_get_string_value(
             config_dict_ptr, "ThemeFile");
     }
-    wlmaker_config_style_t style = {};
     if (!wlmaker_theme_load(files_ptr, theme_file_ptr, &style)) {
         fprintf(stderr, "Failed to load & initialize theme.\n");
-        return EXIT_FAILURE;
+        goto cleanup;
+    }
+
+    wlmim_cursor_prefetch_t *cursor_prefetch_ptr =
+        wlmim_cursor_prefetch_create(&style.cursor);
+    if (NULL != cursor_prefetch_ptr) {
+        cursor_task_ptr = wlm_util_startup_task_start(
+            "cursor theme", wlmim_cursor_prefetch_run, cursor_prefetch_ptr);
+    }
+
+    wlm_util_startup_task_join(state_task_ptr);
+    state_task_ptr = NULL;
+    state_dict_ptr = state_load_arg.state_dict_ptr;
+    if (NULL == state_dict_ptr) {
+        fprintf(stderr, "Failed to load & initialize state.\n");
+        goto cleanup;
+    }
+
+    char **image_paths_ptr = images_to_prefetch(files_ptr, state_dict_ptr);
+    if (NULL != image_paths_ptr) {
+        images_task_ptr = wlm_util_startup_task_start(
+            "images", images_prefetch_task, image_paths_ptr);
     }
 
-    wlmaker_server_t *server_ptr = wlmaker_server_create(
+    wlm_util_startup_phase_t phase = wlm_util_startup_phase_begin("server");
+    server_ptr = wlmaker_server_create(
         config_dict_ptr, files_ptr, &style, &wlmaker_server_options);
-    if (NULL == server_ptr) return EXIT_FAILURE;
+    if (NULL == server_ptr) goto cleanup;
+    wlm_util_startup_phase_end(&phase);
 
+    phase = wlm_util_startup_phase_begin("root menu");
     // TODO(kaeser@gubbe.ch): Uh, that's ugly...
     server_ptr->root_menu_ptr = wlmaker_root_menu_create(
         server_ptr,
         wlmaker_arg_root_menu_file_ptr,
         wlmtk_window_style_to_ref(server_ptr->style_ptr->window_style_ptr),
         wlmtk_menu_style_to_ref(server_ptr->style_ptr->menu_style_ptr));
-    if (NULL == server_ptr->root_menu_ptr) {
-        return EXIT_FAILURE;
-    }
+    if (NULL == server_ptr->root_menu_ptr) goto cleanup;
     wlmtk_menu_set_open(
         wlmaker_root_menu_menu(server_ptr->root_menu_ptr),
         false);
+    wlm_util_startup_phase_end(&phase);
 
-    wlmaker_action_handle_t *action_handle_ptr = wlmaker_action_bind_keys(
+    action_handle_ptr = wlmaker_action_bind_keys(
         server_ptr,
         bspl_dict_get_dict(config_dict_ptr, wlmaker_action_config_dict_key),
         wlmaker_server_options.bind_with_logo);
     if (NULL == action_handle_ptr) {
         bs_log(BS_ERROR, "Failed to bind keys.");
-        return EXIT_FAILURE;
+        goto cleanup;
     }
 
-    if (!create_workspaces(state_dict_ptr, server_ptr)) {
-        return EXIT_FAILURE;
-    }
+    if (!create_workspaces(state_dict_ptr, server_ptr)) goto cleanup;
+
+    // All workers must be done before the event loop starts.
+    wlm_util_startup_task_join(keymap_task_ptr);
+    keymap_task_ptr = NULL;
+    wlm_util_startup_task_join(cursor_task_ptr);
+    cursor_task_ptr = NULL;
+    wlm_util_startup_task_join(images_task_ptr);
+    images_task_ptr = NULL;
 
     rv = EXIT_SUCCESS;
-    if (wlr_backend_start(wlmbe_backend_wlr(server_ptr->backend_ptr))) {
+    phase = wlm_util_startup_phase_begin("backend start");
+    bool started = wlr_backend_start(
+        wlmbe_backend_wlr(server_ptr->backend_ptr));
+    wlm_util_startup_phase_end(&phase);
+    if (started) {
 
         if (0 >= wlmbe_num_outputs(server_ptr->wlr_output_layout_ptr)) {
             bs_log(BS_ERROR, "No outputs available!");
-            return EXIT_FAILURE;
+            rv = EXIT_FAILURE;
+            goto cleanup;
         }
 
         bs_log(BS_INFO, "Starting Wayland compositor for server %p at %s ...",
@@ -346,20 +540,38 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
             for (size_t i = 0; i < bspl_array_size(autostarted_ptr); ++i) {
                 const char *cmd_ptr = bspl_array_string_value_at(
                     autostarted_ptr, i);
-                if (!start_subprocess(cmd_ptr)) return EXIT_FAILURE;
+                if (!start_subprocess(cmd_ptr)) {
+                    rv = EXIT_FAILURE;
+                    goto cleanup;
+                }
             }
         }
 
+        phase = wlm_util_startup_phase_begin("dock & clip");
         clip_ptr = wlmaker_clip_create(
             server_ptr, state_dict_ptr, &style);
         dock_ptr = wlmaker_dock_create(
             server_ptr, state_dict_ptr, &style);
         task_list_ptr = wlmaker_task_list_create(
             server_ptr, &style.task_list);
+        wlm_util_startup_phase_end(&phase);
+        wlmtk_image_prefetch_flush();
+
+        wlm_util_startup_phase_end(&startup);
+        if (NULL != wlmaker_arg_startup_trace_ptr) {
+            if (wlm_util_startup_trace_write(wlmaker_arg_startup_trace_ptr)) {
+                bs_log(BS_INFO, "Wrote startup trace to \"%s\"",
+                       wlmaker_arg_startup_trace_ptr);
+            }
+            free(wlmaker_arg_startup_trace_ptr);
+            wlmaker_arg_startup_trace_ptr = NULL;
+        }
+        wlm_util_startup_trace_disable();
+
         if (NULL == dock_ptr || NULL == clip_ptr || NULL == task_list_ptr) {
             bs_log(BS_ERROR, "Failed to create dock, clip or task list.");
         } else {
-            wl_display_run(server_ptr->wl_display_ptr);
+            wlmaker_server_run(server_ptr);
         }
 
     } else {
@@ -367,12 +579,29 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
         rv = EXIT_FAILURE;
     }
 
+cleanup:
+    // Workers use the state arguments, configuration and style: Join them
+    // first. A task is NULL once joined, or if it was never started.
+    wlm_util_startup_task_join(state_task_ptr);
+    state_dict_ptr = state_load_arg.state_dict_ptr;
+    wlm_util_startup_task_join(keymap_task_ptr);
+    wlm_util_startup_task_join(cursor_task_ptr);
+    wlm_util_startup_task_join(images_task_ptr);
+    if (NULL != wlmaker_arg_state_file_ptr) {
+        free(wlmaker_arg_state_file_ptr);
+        wlmaker_arg_state_file_ptr = NULL;
+    }
+
     if (NULL != task_list_ptr) wlmaker_task_list_destroy(task_list_ptr);
     if (NULL != clip_ptr) wlmaker_clip_destroy(clip_ptr);
     if (NULL != dock_ptr) wlmaker_dock_destroy(dock_ptr);
-    wlmaker_action_unbind_keys(action_handle_ptr);
-    bspl_array_unref(server_ptr->root_menu_array_ptr);
-    wlmaker_server_destroy(server_ptr);
+    if (NULL != action_handle_ptr) {
+        wlmaker_action_unbind_keys(action_handle_ptr);
+    }
+    if (NULL != server_ptr) {
+        bspl_array_unref(server_ptr->root_menu_array_ptr);
+        wlmaker_server_destroy(server_ptr);
+    }
 
     bs_subprocess_t *sp_ptr;
     while (NULL != (sp_ptr = bs_ptr_stack_pop(&wlmaker_subprocess_stack))) {
@@ -381,8 +610,9 @@ int main(__UNUSED__ int argc, __UNUSED__ const char **argv)
     bs_ptr_stack_fini(&wlmaker_subprocess_stack);
 
     bspl_decoded_destroy(wlmaker_config_style_desc, &style);
-    bspl_dict_unref(config_dict_ptr);
-    bspl_dict_unref(state_dict_ptr);
+    if (NULL != config_dict_ptr) bspl_dict_unref(config_dict_ptr);
+    if (NULL != state_dict_ptr) bspl_dict_unref(state_dict_ptr);
+    if (NULL != async_log_ptr) wlm_util_async_log_destroy(async_log_ptr);
     return rv;
 }
 
@@ -53,8 +53,11 @@ wlmaker_xdg_shell_t *wlmaker_xdg_shell_create(wlmaker_server_t *server_ptr)
     if (NULL == xdg_shell_ptr) return NULL;
     xdg_shell_ptr->server_ptr = server_ptr;
 
+    // Version 3: Popups are repositioned, see xdg_popup.c. Version 4 and 5:
+    // Toplevels are configured with bounds and capabilities, see
+    // xdg_toplevel.c. Version 6: Toplevels are suspended when not visible.
     xdg_shell_ptr->wlr_xdg_shell_ptr = wlr_xdg_shell_create(
-        server_ptr->wl_display_ptr, 2);
+        server_ptr->wl_display_ptr, 6);
     if (NULL == xdg_shell_ptr->wlr_xdg_shell_ptr) {
         wlmaker_xdg_shell_destroy(xdg_shell_ptr);
         return NULL;
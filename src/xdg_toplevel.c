@@ -42,6 +42,7 @@
 #include "server.h"
 #include "tl_menu.h"
 #include "toolkit/toolkit.h"
+#include "util/launch_tracker.h"
 #include "xdg_popup.h"
 
 /* == Declarations ========================================================= */
@@ -103,6 +104,8 @@ struct wlmaker_xdg_toplevel {
     struct wl_listener        window_request_fullscreen_listener;
     /** Listener for @ref wlmtk_window_events_t::request_maximized. */
     struct wl_listener        window_request_maximized_listener;
+    /** Listener for @ref wlmtk_window_events_t::visibility_changed. */
+    struct wl_listener        window_visibility_changed_listener;
 
     /** Injected method for wlr_xdg_toplevel_set_maximized(). */
     uint32_t (*_set_maximized)(struct wlr_xdg_toplevel *, bool);
@@ -112,6 +115,8 @@ struct wlmaker_xdg_toplevel {
     uint32_t (*_set_size)(struct wlr_xdg_toplevel *, int32_t, int32_t);
     /** Injected method for wlr_xdg_toplevel_set_activated(). */
     uint32_t (*_set_activated)(struct wlr_xdg_toplevel *, bool);
+    /** Injected method for wlr_xdg_toplevel_set_suspended(). */
+    uint32_t (*_set_suspended)(struct wlr_xdg_toplevel *, bool);
     /** Injected method for wlr_surface_get_extents(). */
     void (*_get_extents)(struct wlr_surface *, struct wlr_box *);
 
@@ -133,7 +138,9 @@ struct wlmaker_xdg_toplevel {
             /** Size. */
             WXT_PROP_SIZE = 1 << 2,
             /** Activation. */
-            WXT_PROP_ACTIVATED =  1 << 3
+            WXT_PROP_ACTIVATED =  1 << 3,
+            /** Suspension. */
+            WXT_PROP_SUSPENDED = 1 << 4
         }  properties;
         /** Maximization status. */
         bool                  maximized;
@@ -143,7 +150,11 @@ struct wlmaker_xdg_toplevel {
         int32_t               width, height;
         /** Activated. */
         bool                  activated;
+        /** Suspended. */
+        bool                  suspended;
     } pending;
+    /** Whether the toplevel was last configured as suspended. */
+    bool                      suspended;
 
     /**
      * Whether the surface had been mapped. Actual map to the workspace may be
@@ -159,7 +170,13 @@ struct wlmaker_xdg_toplevel *_wlmaker_xdg_toplevel_create_injected(
     uint32_t (*_set_fullscreen)(struct wlr_xdg_toplevel *, bool),
     uint32_t (*_set_size)(struct wlr_xdg_toplevel *, int32_t, int32_t),
     uint32_t (*_set_activated)(struct wlr_xdg_toplevel *, bool),
+    uint32_t (*_set_suspended)(struct wlr_xdg_toplevel *, bool),
     void (*_get_extents)(struct wlr_surface *, struct wlr_box *));
+static uint32_t _wlmaker_xdg_toplevel_set_suspended(
+    struct wlr_xdg_toplevel *wlr_xdg_toplevel_ptr,
+    bool suspended);
+static void _wlmaker_xdg_toplevel_configure_initial(
+    struct wlmaker_xdg_toplevel *wxt_ptr);
 static void _wlmaker_xdg_toplevel_flush_properties(
     struct wlmaker_xdg_toplevel *wxt_ptr);
 static void _wlmaker_xdg_toplevel_try_map(
@@ -225,6 +242,9 @@ static void _wlmaker_xdg_toplevel_handle_window_request_fullscreen(
 static void _wlmaker_xdg_toplevel_handle_window_request_maximized(
     struct wl_listener *listener_ptr,
     void *data_ptr);
+static void _wlmaker_xdg_toplevel_handle_window_visibility_changed(
+    struct wl_listener *listener_ptr,
+    void *data_ptr);
 
 /* == Exported methods ===================================================== */
 
@@ -240,6 +260,7 @@ struct wlmaker_xdg_toplevel *wlmaker_xdg_toplevel_create(
         wlr_xdg_toplevel_set_fullscreen,
         wlr_xdg_toplevel_set_size,
         wlr_xdg_toplevel_set_activated,
+        _wlmaker_xdg_toplevel_set_suspended,
         wlr_surface_get_extents
         );
 }
@@ -250,6 +271,8 @@ void wlmaker_xdg_toplevel_destroy(struct wlmaker_xdg_toplevel *wxt_ptr)
     bs_log(BS_INFO, "Destroying XDG toplevel %p", wxt_ptr);
     wxt_ptr->wlr_xdg_toplevel_ptr->base->data = NULL;
 
+    wlmtk_util_disconnect_listener(
+        &wxt_ptr->window_visibility_changed_listener);
     wlmtk_util_disconnect_listener(&wxt_ptr->window_request_fullscreen_listener);
     wlmtk_util_disconnect_listener(&wxt_ptr->window_request_size_listener);
     wlmtk_util_disconnect_listener(&wxt_ptr->window_set_activated_listener);
@@ -312,6 +335,7 @@ struct wlmaker_xdg_toplevel *_wlmaker_xdg_toplevel_create_injected(
     uint32_t (*_set_fullscreen)(struct wlr_xdg_toplevel *, bool),
     uint32_t (*_set_size)(struct wlr_xdg_toplevel *, int32_t, int32_t),
     uint32_t (*_set_activated)(struct wlr_xdg_toplevel *, bool),
+    uint32_t (*_set_suspended)(struct wlr_xdg_toplevel *, bool),
     void (*_get_extents)(struct wlr_surface *, struct wlr_box *))
 {
     // Guard clause: Must have a base. */
@@ -330,6 +354,7 @@ struct wlmaker_xdg_toplevel *_wlmaker_xdg_toplevel_create_injected(
     wlmaker_xdg_toplevel_ptr->_set_fullscreen = _set_fullscreen;
     wlmaker_xdg_toplevel_ptr->_set_size = _set_size;
     wlmaker_xdg_toplevel_ptr->_set_activated = _set_activated;
+    wlmaker_xdg_toplevel_ptr->_set_suspended = _set_suspended;
     wlmaker_xdg_toplevel_ptr->_get_extents = _get_extents;
 
     if (!wlmtk_base_init(&wlmaker_xdg_toplevel_ptr->base, NULL)) goto error;
@@ -452,6 +477,10 @@ struct wlmaker_xdg_toplevel *_wlmaker_xdg_toplevel_create_injected(
         &wlmtk_window_events(wlmaker_xdg_toplevel_ptr->window_ptr)->request_maximized,
         &wlmaker_xdg_toplevel_ptr->window_request_maximized_listener,
         _wlmaker_xdg_toplevel_handle_window_request_maximized);
+    wlmtk_util_connect_listener_signal(
+        &wlmtk_window_events(wlmaker_xdg_toplevel_ptr->window_ptr)->visibility_changed,
+        &wlmaker_xdg_toplevel_ptr->window_visibility_changed_listener,
+        _wlmaker_xdg_toplevel_handle_window_visibility_changed);
 
     wlmaker_xdg_toplevel_ptr->wlr_xdg_toplevel_ptr->base->data =
         wlmaker_xdg_toplevel_ptr;
@@ -507,9 +536,70 @@ void _wlmaker_xdg_toplevel_flush_properties(
             wxt_ptr->wlr_xdg_toplevel_ptr,
             wxt_ptr->pending.activated);
     }
+
+    if (wxt_ptr->pending.properties & WXT_PROP_SUSPENDED &&
+        wxt_ptr->pending.suspended != wxt_ptr->suspended) {
+        wxt_ptr->_set_suspended(
+            wxt_ptr->wlr_xdg_toplevel_ptr,
+            wxt_ptr->pending.suspended);
+        wxt_ptr->suspended = wxt_ptr->pending.suspended;
+    }
     wxt_ptr->pending.properties = 0;
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Wraps wlr_xdg_toplevel_set_suspended(): The `suspended` state is only
+ * available from version 6 of xdg_toplevel. Older clients are not told.
+ *
+ * @param wlr_xdg_toplevel_ptr
+ * @param suspended
+ *
+ * @return The configure serial, or 0 if not sent.
+ */
+uint32_t _wlmaker_xdg_toplevel_set_suspended(
+    struct wlr_xdg_toplevel *wlr_xdg_toplevel_ptr,
+    bool suspended)
+{
+    if (XDG_TOPLEVEL_STATE_SUSPENDED_SINCE_VERSION >
+        wl_resource_get_version(wlr_xdg_toplevel_ptr->resource)) return 0;
+    return wlr_xdg_toplevel_set_suspended(wlr_xdg_toplevel_ptr, suspended);
+}
+
+/* ------------------------------------------------------------------------- */
+/**
+ * Sets the toplevel's version-dependent initial state, upon the initial
+ * commit: The bounds (from version 4 of xdg_toplevel), and the window
+ * management capabilities (from version 5).
+ *
+ * Minimizing is not advertised, since it is not implemented.
+ *
+ * @param wxt_ptr
+ */
+void _wlmaker_xdg_toplevel_configure_initial(
+    struct wlmaker_xdg_toplevel *wxt_ptr)
+{
+    int version = wl_resource_get_version(
+        wxt_ptr->wlr_xdg_toplevel_ptr->resource);
+
+    if (XDG_TOPLEVEL_CONFIGURE_BOUNDS_SINCE_VERSION <= version) {
+        struct wlr_box box = wlmtk_workspace_get_maximize_extents(
+            wlmtk_desktop_get_current_workspace(
+                wxt_ptr->server_ptr->desktop_ptr),
+            NULL);
+        wlr_xdg_toplevel_set_bounds(
+            wxt_ptr->wlr_xdg_toplevel_ptr, box.width, box.height);
+    }
+
+    if (XDG_TOPLEVEL_WM_CAPABILITIES_SINCE_VERSION <= version) {
+        wlr_xdg_toplevel_set_wm_capabilities(
+            wxt_ptr->wlr_xdg_toplevel_ptr,
+            WLR_XDG_TOPLEVEL_WM_CAPABILITIES_WINDOW_MENU |
+            WLR_XDG_TOPLEVEL_WM_CAPABILITIES_MAXIMIZE |
+            WLR_XDG_TOPLEVEL_WM_CAPABILITIES_FULLSCREEN);
+    }
+}
+
 /* ------------------------------------------------------------------------- */
 /**
  * Maps the window to the workspace, if the surface is ready.
@@ -530,6 +620,10 @@ void _wlmaker_xdg_toplevel_try_map(struct wlmaker_xdg_toplevel *wxt_ptr)
     wlmtk_workspace_t *workspace_ptr = wlmtk_desktop_get_current_workspace(
         wxt_ptr->server_ptr->desktop_ptr);
     wlmtk_workspace_map_window(workspace_ptr, wxt_ptr->window_ptr);
+
+    wlm_util_launch_tracker_mapped(
+        wxt_ptr->server_ptr->launch_tracker_ptr,
+        wlmtk_window_get_client_ptr(wxt_ptr->window_ptr)->pid);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -760,7 +854,15 @@ void _wlmaker_xdg_toplevel_handle_surface_commit(
     }
     wlmtk_window_commit_size(
         wxt_ptr->window_ptr, geo.width - geo.x, geo.height - geo.y);
+    if (NULL != wxt_ptr->surface_ptr) {
+        wlmtk_window_set_opaque(
+            wxt_ptr->window_ptr,
+            wlmtk_surface_is_opaque(wxt_ptr->surface_ptr));
+    }
 
+    if (wlr_xdg_surface_ptr->initial_commit) {
+        _wlmaker_xdg_toplevel_configure_initial(wxt_ptr);
+    }
     if (0 != wxt_ptr->pending.properties) {
         _wlmaker_xdg_toplevel_flush_properties(wxt_ptr);
     } else if (wlr_xdg_surface_ptr->initial_commit) {
@@ -877,6 +979,25 @@ void _wlmaker_xdg_toplevel_handle_window_request_maximized(
     _wlmaker_xdg_toplevel_flush_properties(wxt_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/**
+ * Handles a change of the window's visibility: Suspends the toplevel while it
+ * cannot be seen, so the client may stop rendering.
+ */
+void _wlmaker_xdg_toplevel_handle_window_visibility_changed(
+    struct wl_listener *listener_ptr,
+    __UNUSED__ void *data_ptr)
+{
+    struct wlmaker_xdg_toplevel *wxt_ptr = BS_CONTAINER_OF(
+        listener_ptr,
+        struct wlmaker_xdg_toplevel,
+        window_visibility_changed_listener);
+
+    wxt_ptr->pending.properties |= WXT_PROP_SUSPENDED;
+    wxt_ptr->pending.suspended = !wlmtk_window_is_visible(wxt_ptr->window_ptr);
+    _wlmaker_xdg_toplevel_flush_properties(wxt_ptr);
+}
+
 /** == Unit test helpers =================================================== */
 
 /** Data needed for using an output layout for tests. */
@@ -941,6 +1062,8 @@ struct _xdg_toplevel_test_data {
     int                       set_fullscreen_calls;
     int                       set_size_calls;
     int                       set_activated_calls;
+    int                       set_suspended_calls;
+    bool                      suspended;
 
     wlmtk_workspace_t         *workspace_ptr;
 #endif
@@ -997,6 +1120,19 @@ uint32_t _wlmaker_xdg_toplevel_fake_set_activated(
     return 0;
 }
 
+/** A fake for wlr_xdg_toplevel_set_suspended(). Records the call. */
+uint32_t _wlmaker_xdg_toplevel_fake_set_suspended(
+    struct wlr_xdg_toplevel *wlr_xdg_toplevel_ptr,
+    bool suspended)
+{
+    struct _xdg_toplevel_test_data *td_ptr = BS_CONTAINER_OF(
+        wlr_xdg_toplevel_ptr, struct _xdg_toplevel_test_data, wlr_xdg_toplevel);
+
+    td_ptr->set_suspended_calls++;
+    td_ptr->suspended = suspended;
+    return 0;
+}
+
 /** A fake for wlr_surface_get_extents(). Sets box to empty. */
 void _wlmaker_xdg_toplevel_fake_get_extents_empty(
     __UNUSED__ struct wlr_surface *wlr_surface_ptr,
@@ -1022,6 +1158,7 @@ static void _wlmaker_xdg_toplevel_test_maximize(bs_test_t *test_ptr);
 static void _wlmaker_xdg_toplevel_test_fullscreen(bs_test_t *test_ptr);
 static void _wlmaker_xdg_toplevel_test_size(bs_test_t *test_ptr);
 static void _wlmaker_xdg_toplevel_test_activated(bs_test_t *test_ptr);
+static void _wlmaker_xdg_toplevel_test_suspended(bs_test_t *test_ptr);
 static void _wlmaker_xdg_toplevel_test_map(bs_test_t *test_ptr);
 static void _wlmaker_xdg_toplevel_test_map_nogeo(bs_test_t *test_ptr);
 
@@ -1031,6 +1168,7 @@ const bs_test_case_t _test_cases[] = {
     { true, "fullscreen", _wlmaker_xdg_toplevel_test_fullscreen },
     { true, "size", _wlmaker_xdg_toplevel_test_size },
     { true, "activated", _wlmaker_xdg_toplevel_test_activated },
+    { true, "suspended", _wlmaker_xdg_toplevel_test_suspended },
     { true, "map", _wlmaker_xdg_toplevel_test_map },
     { true, "map_nogeo", _wlmaker_xdg_toplevel_test_map_nogeo },
     BS_TEST_CASE_SENTINEL()
@@ -1161,6 +1299,7 @@ void _wlmaker_xdg_toplevel_test_maximize(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_empty);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
     BS_TEST_VERIFY_EQ(test_ptr, 1, created.calls);
@@ -1218,6 +1357,7 @@ void _wlmaker_xdg_toplevel_test_fullscreen(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_empty);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
 
@@ -1263,6 +1403,7 @@ void _wlmaker_xdg_toplevel_test_size(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_empty);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
 
@@ -1299,6 +1440,7 @@ void _wlmaker_xdg_toplevel_test_activated(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_empty);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
 
@@ -1318,6 +1460,57 @@ void _wlmaker_xdg_toplevel_test_activated(bs_test_t *test_ptr)
     wlmaker_xdg_toplevel_destroy(wxt_ptr);
 }
 
+/* ------------------------------------------------------------------------- */
+/** Tests that the toplevel is suspended while the window is not visible. */
+void _wlmaker_xdg_toplevel_test_suspended(bs_test_t *test_ptr)
+{
+    struct _xdg_toplevel_test_data *td_ptr =
+        BS_ASSERT_NOTNULL(bs_test_context(test_ptr));
+
+    struct wlmaker_xdg_toplevel *wxt_ptr =
+        _wlmaker_xdg_toplevel_create_injected(
+            &td_ptr->wlr_xdg_toplevel,
+            &td_ptr->server,
+            _wlmaker_xdg_toplevel_fake_set_maximized,
+            _wlmaker_xdg_toplevel_fake_set_fullscreen,
+            _wlmaker_xdg_toplevel_fake_set_size,
+            _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
+            _wlmaker_xdg_toplevel_fake_get_extents_empty);
+    BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
+    wlmtk_window_t *w = wxt_ptr->window_ptr;  // for convenience.
+
+    td_ptr->wlr_xdg_surface.initialized = true;  // Ready for configure().
+    td_ptr->wlr_xdg_surface.current.geometry.width = 200;
+    td_ptr->wlr_xdg_surface.current.geometry.height = 100;
+    wl_signal_emit(&td_ptr->wlr_surface.events.commit, NULL);
+
+    // Not visible initially, and not yet suspended: Nothing to send.
+    wlmtk_window_set_visibility(w, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 0, td_ptr->set_suspended_calls);
+
+    // Becomes invisible: Suspend right away.
+    wlmtk_window_set_visibility(w, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 1, td_ptr->set_suspended_calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, td_ptr->suspended);
+
+    // Visible again: Resume.
+    wlmtk_window_set_visibility(w, true);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, td_ptr->set_suspended_calls);
+    BS_TEST_VERIFY_FALSE(test_ptr, td_ptr->suspended);
+
+    // Not yet initialized: Pending, until next commit.
+    td_ptr->wlr_xdg_surface.initialized = false;
+    wlmtk_window_set_visibility(w, false);
+    BS_TEST_VERIFY_EQ(test_ptr, 2, td_ptr->set_suspended_calls);
+    td_ptr->wlr_xdg_surface.initialized = true;
+    wl_signal_emit(&td_ptr->wlr_surface.events.commit, NULL);
+    BS_TEST_VERIFY_EQ(test_ptr, 3, td_ptr->set_suspended_calls);
+    BS_TEST_VERIFY_TRUE(test_ptr, td_ptr->suspended);
+
+    wlmaker_xdg_toplevel_destroy(wxt_ptr);
+}
+
 /* ------------------------------------------------------------------------- */
 /** Tests surface map calls. */
 void _wlmaker_xdg_toplevel_test_map(bs_test_t *test_ptr)
@@ -1333,6 +1526,7 @@ void _wlmaker_xdg_toplevel_test_map(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_empty);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
     wlmtk_window_t *w = wxt_ptr->window_ptr;  // for convenience.
@@ -1387,6 +1581,7 @@ void _wlmaker_xdg_toplevel_test_map_nogeo(bs_test_t *test_ptr)
             _wlmaker_xdg_toplevel_fake_set_fullscreen,
             _wlmaker_xdg_toplevel_fake_set_size,
             _wlmaker_xdg_toplevel_fake_set_activated,
+            _wlmaker_xdg_toplevel_fake_set_suspended,
             _wlmaker_xdg_toplevel_fake_get_extents_64x32);
     BS_TEST_VERIFY_NEQ_OR_RETURN(test_ptr, NULL, wxt_ptr);
     wlmtk_window_t *w = wxt_ptr->window_ptr;  // for convenience.
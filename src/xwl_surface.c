@@ -37,6 +37,7 @@
 #include "input/manager.h"
 #include "server.h"
 #include "toolkit/toolkit.h"
+#include "util/launch_tracker.h"
 
 /* == Declarations ========================================================= */
 
@@ -655,6 +656,10 @@ void _xwl_surface_handle_surface_map(
         wlmtk_desktop_get_current_workspace(
             xwl_surface_ptr->server_ptr->desktop_ptr);
     wlmtk_workspace_map_window(workspace_ptr, xwl_surface_ptr->window_ptr);
+
+    wlm_util_launch_tracker_mapped(
+        xwl_surface_ptr->server_ptr->launch_tracker_ptr,
+        xwl_surface_ptr->wlr_xwayland_surface_ptr->pid);
 }
 
 /* ------------------------------------------------------------------------- */
@@ -688,6 +693,9 @@ void _xwl_surface_handle_surface_commit(
         xwl_surface_ptr->window_ptr,
         xwl_surface_ptr->wlr_xwayland_surface_ptr->surface->current.width,
         xwl_surface_ptr->wlr_xwayland_surface_ptr->surface->current.height);
+    wlmtk_window_set_opaque(
+        xwl_surface_ptr->window_ptr,
+        wlmtk_surface_is_opaque(xwl_surface_ptr->surface_ptr));
 }
 
 /* ------------------------------------------------------------------------- */
@@ -23,12 +23,16 @@
 #include <stddef.h>
 
 #include "backend/backend.h"
+#include "backend/output.h"
 #include "backend/output_config.h"
+#include "backend/output_manager.h"
 
 /** Backend unit tests. */
 const bs_test_set_t *backend_test_sets[] = {
     &wlmbe_backend_test_set,
+    &wlmbe_output_test_set,
     &wlmbe_output_config_test_set,
+    &wlmbe_output_manager_test_set,
     NULL,
 };
 
@@ -43,6 +43,7 @@ const bs_test_set_t *toolkit_test_sets[] = {
     &wlmtk_output_tracker_test_set,
     &wlmtk_panel_test_set,
     &wlmaker_primitives_test_set,
+    &wlmtk_raster_test_set,
     &wlmtk_rectangle_test_set,
     &wlmtk_resizebar_test_set,
     &wlmtk_resizebar_area_test_set,
@@ -21,8 +21,14 @@
 #include <libbase/libbase.h>
 #include <stdlib.h>
 
+#include "util/async_log.h"
 #include "util/files.h"
 #include "util/backtrace.h"
+#include "util/launch_tracker.h"
+#include "util/persist.h"
+#include "util/spawn.h"
+#include "util/startup.h"
+#include "util/watchdog.h"
 
 #if !defined(TEST_DATA_DIR)
 /** Directory root for looking up test data. See `bs_test_resolve_path`. */
@@ -36,7 +42,13 @@ int main(int argc, const char **argv)
 
     const bs_test_param_t params = { .test_data_dir_ptr = TEST_DATA_DIR };
     const bs_test_set_t* sets[] = {
+        &wlm_util_async_log_test_set,
         &wlm_util_files_test_set,
+        &wlm_util_launch_tracker_test_set,
+        &wlm_util_persist_test_set,
+        &wlm_util_spawn_test_set,
+        &wlm_util_startup_test_set,
+        &wlm_util_watchdog_test_set,
         NULL
     };
     return bs_test_sets(sets, argc, argv, &params);
@@ -24,13 +24,17 @@
 
 #include "action.h"
 #include "action_item.h"
+#include "background.h"
 #include "clip.h"
 #include "config.h"
 #include "corner.h"
 #include "dock.h"
 #include "layer_panel.h"
 #include "lock_mgr.h"
+#include "menu_generator.h"
 #include "root_menu.h"
+#include "task_list.h"
+#include "tl_menu.h"
 #include "util/backtrace.h"
 #include "xdg_decoration.h"
 #include "xdg_toplevel.h"
@@ -52,13 +56,17 @@ int main(int argc, const char **argv)
     const bs_test_set_t* sets[] = {
         &wlmaker_action_item_test_set,
         &wlmaker_action_test_set,
+        &wlmaker_background_test_set,
         &wlmaker_clip_test_set,
         &wlmaker_config_test_set,
         &wlmaker_corner_test_set,
         &wlmaker_dock_test_set,
         &wlmaker_layer_panel_test_set,
         &wlmaker_lock_mgr_test_set,
+        &wlmaker_menu_generator_test_set,
         &wlmaker_root_menu_test_set,
+        &wlmaker_task_list_test_set,
+        &wlmaker_tl_menu_test_set,
         &wlmaker_xdg_decoration_test_set,
         &wlmaker_xdg_toplevel_test_set,
 #if defined(WLMAKER_HAVE_XWAYLAND)